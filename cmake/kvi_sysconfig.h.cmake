@@ -69,6 +69,9 @@
 #cmakedefine COMPILE_GET_INTERFACE_ADDRESS 1
 #cmakedefine HAVE_INET_ATON 1
 #cmakedefine HAVE_INET_NTOA 1
+#cmakedefine HAVE_SENDFILE 1
+#cmakedefine HAVE_SENDFILE64 1
+#cmakedefine HAVE_FALLOCATE 1
 
 #define COMPILE_USE_STANDALONE_MOC_SOURCES 1
 
@@ -0,0 +1,52 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+//=============================================================================
+//
+//   File : Benchmark.h
+//   Creation date : Sun 18 Oct 2026 17:05:31 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The benchmarks of kvibench.
+//
+// Each benchmark compares the current implementation of something with the
+// one it replaced (or with the plain alternative), prints the timings and
+// checks that both produce the same results. It returns false if they don't
+// or if it can't run.
+//
+
+#include <functional>
+
+// Monotonic clock, in nsecs
+long long benchmark_nsecs_now();
+// CPU time used by the calling thread, in nsecs (0 where the platform can't tell it)
+long long benchmark_thread_cpu_nsecs();
+// Calls f for about iMinMSecs in a few rounds, returns the average duration of a call in nsecs
+// in the fastest round
+double benchmark_nsecs_per_call(const std::function<void()> & f, int iMinMSecs = 1000);
+
+bool benchmark_adpcm();
+bool benchmark_language_detector();
+bool benchmark_mask_index();
+bool benchmark_sendfile();
+bool benchmark_video_conversion();
+
+#endif //_BENCHMARK_H_
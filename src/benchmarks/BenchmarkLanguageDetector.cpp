@@ -0,0 +1,219 @@
+//=============================================================================
+//
+//   File : BenchmarkLanguageDetector.cpp
+//   Creation date : Sun 18 Oct 2026 23:12:44 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The language detector: the merged tables of all the descriptors against
+// the descriptor by descriptor scoring that they replaced, on a few texts
+// in different languages and encodings and on random bytes.
+//
+// The descriptors and the merged tables are static in detector.cpp, so it
+// is compiled as a part of this file (and it is not in kvibench_SRCS).
+//
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "detector.cpp"
+
+// the table defines that detector.cpp leaves behind
+#undef a
+#undef e
+#undef h
+#undef l
+#undef m
+#undef n
+#undef o
+#undef q
+#undef s
+#undef t
+#undef u
+#undef v
+#undef w
+#undef y
+#undef D
+#undef H
+#undef N
+#undef S
+#undef V
+#undef W
+#undef Y
+#undef Z
+
+// The old scoring: the data is scanned twice for each descriptor
+static double benchmark_detector_old_score_for_ngram(DetectorDescriptor * pDescriptor, const unsigned char * ngram)
+{
+	DetectorNGram * pNGram = pDescriptor->ngram_hash[descriptor_ngram_hash(ngram)];
+	while(pNGram->szNGram)
+	{
+		if(strcmp((const char *)ngram, (const char *)pNGram->szNGram) == 0)
+			return pNGram->dScore;
+		pNGram++;
+	}
+	return 0.0;
+}
+
+static double benchmark_detector_old_descriptor_score(const unsigned char * data, DetectorDescriptor * pDescriptor)
+{
+	double dRet = 0.0;
+
+	const unsigned char * ptr = data;
+	while(*ptr)
+	{
+		unsigned char uChar = (unsigned char)tolower((char)*ptr);
+		if(valid_char_jump_table[uChar])
+			dRet += pDescriptor->single_char_data[uChar];
+		ptr++;
+	}
+
+	ptr = data;
+	unsigned char buffer[1024];
+	buffer[0] = ' ';
+	while(*ptr)
+	{
+		while(*ptr && !valid_char_jump_table[*ptr])
+			ptr++;
+		int idx = 1;
+		while(valid_char_jump_table[*ptr] && (idx < 1022))
+		{
+			buffer[idx] = (unsigned char)tolower((char)*ptr);
+			ptr++;
+			idx++;
+		}
+		buffer[idx] = ' ';
+		idx++;
+		buffer[idx] = 0;
+		unsigned char * pEnd = buffer + 2;
+		while(*pEnd)
+		{
+			unsigned char uSave = *pEnd;
+			*pEnd = 0;
+			unsigned char * pBegin = pEnd - 4;
+			if(pBegin >= buffer)
+				dRet += benchmark_detector_old_score_for_ngram(pDescriptor, pBegin);
+			pBegin++;
+			if(pBegin >= buffer)
+				dRet += benchmark_detector_old_score_for_ngram(pDescriptor, pBegin);
+			pBegin++;
+			dRet += benchmark_detector_old_score_for_ngram(pDescriptor, pBegin);
+			*pEnd = uSave;
+			pEnd++;
+		}
+	}
+	return dRet;
+}
+
+static void benchmark_detector_old_scores(const unsigned char * data, double * pScores)
+{
+	for(int iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
+		pScores[iDesc] = benchmark_detector_old_descriptor_score(data, all_descriptors[iDesc]);
+}
+
+struct BenchmarkDetectorSample
+{
+	const char * szName;
+	const char * szText;
+};
+
+static const BenchmarkDetectorSample g_detectorSamples[] = {
+	{ "english", "The quick brown fox jumps over the lazy dog. Please tell me where the nearest train station is, "
+	             "I have been walking around this town for an hour and I still can't find it. " },
+	{ "italian", "Il mio nome \xc3\xa8 Mario e abito a Roma da quando ero bambino. Questa sera andiamo a mangiare "
+	             "una pizza insieme agli amici, poi forse faremo una passeggiata in centro. " },
+	{ "german", "Ich habe heute keine Zeit, weil ich noch arbeiten muss. Kannst du mir sagen, wann der n\xc3\xa4" "chste "
+	            "Zug nach M\xc3\xbc" "nchen f\xc3\xa4hrt? Wir treffen uns morgen fr\xc3\xbch am Bahnhof. " },
+	{ "french", "Je ne sais pas o\xc3\xb9 se trouve la gare, pouvez-vous m'aider s'il vous pla\xc3\xaet? Nous avons "
+	            "pass\xc3\xa9 une tr\xc3\xa8s belle journ\xc3\xa9" "e au bord de la mer avec nos enfants. " },
+	{ "russian", "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82, \xd0\xba\xd0\xb0\xd0\xba \xd0\xb4\xd0\xb5\xd0\xbb\xd0\xb0? "
+	             "\xd0\xaf \xd0\xbd\xd0\xb5 \xd0\xb7\xd0\xbd\xd0\xb0\xd1\x8e, \xd0\xb3\xd0\xb4\xd0\xb5 \xd0\xbd\xd0\xb0\xd1\x85\xd0\xbe\xd0\xb4\xd0\xb8\xd1\x82\xd1\x81\xd1\x8f "
+	             "\xd0\xb2\xd0\xbe\xd0\xba\xd0\xb7\xd0\xb0\xd0\xbb. " },
+	{ "latin-1", "Je ne sais pas o\xf9 se trouve la gare. Il mio nome \xe8 Mario. Der n\xe4" "chste Zug nach M\xfc" "nchen. " }
+};
+
+#define BENCHMARK_DETECTOR_SAMPLE_COUNT ((int)(sizeof(g_detectorSamples) / sizeof(g_detectorSamples[0])))
+#define BENCHMARK_DETECTOR_TEXT_LENGTH 2048
+
+static bool benchmark_detector_run(const char * szName, const std::string & szText)
+{
+	const unsigned char * data = (const unsigned char *)szText.c_str();
+
+	double dOldScores[NUM_DESCRIPTORS], dNewScores[NUM_DESCRIPTORS];
+	benchmark_detector_old_scores(data, dOldScores);
+	compute_descriptor_scores(data, dNewScores);
+
+	bool bOk = true;
+	for(int iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
+	{
+		// the sums are done in the same order: they must be exactly the same
+		if(dOldScores[iDesc] != dNewScores[iDesc])
+		{
+			printf("    %s: the score of %s/%s differs: old %.17g, new %.17g\n", szName,
+			    all_descriptors[iDesc]->szLanguage, all_descriptors[iDesc]->szEncoding, dOldScores[iDesc], dNewScores[iDesc]);
+			bOk = false;
+		}
+	}
+
+	double dOld = benchmark_nsecs_per_call([&]() { benchmark_detector_old_scores(data, dOldScores); }, 500);
+	double dNew = benchmark_nsecs_per_call([&]() { compute_descriptor_scores(data, dNewScores); }, 500);
+
+	LanguageAndEncodingResult r;
+	detect_language_and_encoding(szText.c_str(), &r, 0);
+	printf("  %-8s %5d bytes (%s/%s): old %9.1f usecs, new %7.1f usecs (%.1fx)\n", szName, (int)szText.length(),
+	    r.match[0].szLanguage, r.match[0].szEncoding, dOld / 1000.0, dNew / 1000.0, dOld / dNew);
+	return bOk;
+}
+
+bool benchmark_language_detector()
+{
+	// the merged tables are built at the first detection
+	long long iStart = benchmark_nsecs_now();
+	build_merged_tables();
+	printf("  merged tables built in %.2f msecs: %u ngram slots, %u scores\n", (benchmark_nsecs_now() - iStart) / 1000000.0,
+	    (unsigned int)merged_ngram_hash.size(), (unsigned int)merged_ngram_scores.size());
+
+	bool bOk = true;
+	for(int i = 0; i < BENCHMARK_DETECTOR_SAMPLE_COUNT; i++)
+	{
+		std::string szText;
+		while(szText.length() < BENCHMARK_DETECTOR_TEXT_LENGTH)
+			szText += g_detectorSamples[i].szText;
+		if(!benchmark_detector_run(g_detectorSamples[i].szName, szText))
+			bOk = false;
+	}
+
+	// random bytes, without the terminator
+	std::string szRandom;
+	srand(1);
+	while(szRandom.length() < BENCHMARK_DETECTOR_TEXT_LENGTH)
+		szRandom += (char)(1 + rand() % 255);
+	if(!benchmark_detector_run("random", szRandom))
+		bOk = false;
+
+	return bOk;
+}
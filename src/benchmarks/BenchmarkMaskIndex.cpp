@@ -0,0 +1,209 @@
+//=============================================================================
+//
+//   File : BenchmarkMaskIndex.cpp
+//   Creation date : Sun 18 Oct 2026 22:41:07 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The registered user mask lookup: KviIrcMaskIndex against the linear scan
+// of the wild mask list that it replaced in KviRegisteredUserDataBase.
+// The masks are a mix of literal hosts, domains and address ranges with a
+// few masks that can't be indexed, like the ones of a real database.
+//
+
+#include "Benchmark.h"
+
+#include "KviIrcMask.h"
+#include "KviIrcMaskIndex.h"
+
+#include <QString>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#define BENCHMARK_MASKINDEX_LOOKUPS 256
+
+// The old lookup: the list sorted by the number of non wild characters, the older masks first
+class BenchmarkMaskList
+{
+public:
+	~BenchmarkMaskList()
+	{
+		for(auto m : m_lMasks)
+			delete m;
+	}
+
+public:
+	std::vector<KviIrcMask *> m_lMasks;
+
+public:
+	void add(KviIrcMask * pMask)
+	{
+		std::vector<KviIrcMask *>::iterator it = m_lMasks.begin();
+		while((it != m_lMasks.end()) && ((*it)->nonWildChars() >= pMask->nonWildChars()))
+			++it;
+		m_lMasks.insert(it, pMask);
+	}
+
+	KviIrcMask * findFirst(const QString & szNick, const QString & szUser, const QString & szHost)
+	{
+		for(auto m : m_lMasks)
+		{
+			if(m->matchesFixed(szNick, szUser, szHost))
+				return m;
+		}
+		return nullptr;
+	}
+
+	void findAll(const QString & szNick, const QString & szUser, const QString & szHost, std::vector<KviIrcMask *> & lMatches)
+	{
+		for(auto m : m_lMasks)
+		{
+			if(m->matchesFixed(szNick, szUser, szHost))
+				lMatches.push_back(m);
+		}
+	}
+};
+
+struct BenchmarkMaskIndexUser
+{
+	QString szNick;
+	QString szUser;
+	QString szHost;
+};
+
+static KviIrcMask * benchmark_maskindex_make_mask(int i)
+{
+	// one mask out of a hundred has a nickname and a host that can't be indexed
+	if((i % 100) == 99)
+		return new KviIrcMask(QString("nick%1*!*@*").arg(i));
+
+	switch(i % 4)
+	{
+		case 0:
+			return new KviIrcMask(QString("*!*@user%1.isp%2.com").arg(i).arg(i % 50));
+		case 1:
+			return new KviIrcMask(QString("*!*@*.dom%1.net").arg(i));
+		case 2:
+			return new KviIrcMask(QString("*!*@10.%1.%2.*").arg((i / 256) % 256).arg(i % 256));
+		default:
+			// many users behind the same domain: they share a bucket
+			return new KviIrcMask(QString("*!ident%1@*.shared.org").arg(i));
+	}
+}
+
+static BenchmarkMaskIndexUser benchmark_maskindex_make_user(int i, int iMasks)
+{
+	// about half of the users are matched by a mask
+	int k = (i * 7919) % (iMasks * 2);
+	BenchmarkMaskIndexUser u;
+	u.szNick = QString("nick%1").arg(k);
+	u.szUser = QString("ident%1").arg(k);
+	switch(i % 4)
+	{
+		case 0:
+			u.szHost = QString("user%1.isp%2.com").arg(k).arg(k % 50);
+			break;
+		case 1:
+			u.szHost = QString("dyn-%1.pool.dom%2.net").arg(i).arg(k);
+			break;
+		case 2:
+			u.szHost = QString("10.%1.%2.%3").arg((k / 256) % 256).arg(k % 256).arg(i % 256);
+			break;
+		default:
+			u.szHost = QString("host%1.shared.org").arg(i);
+			break;
+	}
+	return u;
+}
+
+static bool benchmark_maskindex_run(int iMasks)
+{
+	BenchmarkMaskList list;
+	KviIrcMaskIndex<KviIrcMask> index;
+	for(int i = 0; i < iMasks; i++)
+	{
+		KviIrcMask * m = benchmark_maskindex_make_mask(i);
+		list.add(m);
+		index.insert(m, m, m->nonWildChars());
+	}
+
+	std::vector<BenchmarkMaskIndexUser> lUsers;
+	for(int i = 0; i < BENCHMARK_MASKINDEX_LOOKUPS; i++)
+		lUsers.push_back(benchmark_maskindex_make_user(i, iMasks));
+
+	bool bOk = true;
+	int iMatched = 0;
+	for(auto & u : lUsers)
+	{
+		KviIrcMask * pOld = list.findFirst(u.szNick, u.szUser, u.szHost);
+		KviIrcMask * pNew = index.findFirst(u.szNick, u.szUser, u.szHost);
+		if(pOld)
+			iMatched++;
+		if(pOld != pNew)
+		{
+			printf("    findFirst() differs for %s!%s@%s\n", u.szNick.toUtf8().data(), u.szUser.toUtf8().data(), u.szHost.toUtf8().data());
+			bOk = false;
+		}
+
+		std::vector<KviIrcMask *> lOld, lNew;
+		list.findAll(u.szNick, u.szUser, u.szHost, lOld);
+		index.findAll(u.szNick, u.szUser, u.szHost, lNew);
+		std::sort(lOld.begin(), lOld.end());
+		std::sort(lNew.begin(), lNew.end());
+		if(lOld != lNew)
+		{
+			printf("    findAll() differs for %s!%s@%s\n", u.szNick.toUtf8().data(), u.szUser.toUtf8().data(), u.szHost.toUtf8().data());
+			bOk = false;
+		}
+	}
+
+	KviIrcMask * pSink = nullptr;
+	double dOld = benchmark_nsecs_per_call([&]() {
+		for(auto & u : lUsers)
+			pSink = list.findFirst(u.szNick, u.szUser, u.szHost);
+	});
+	double dNew = benchmark_nsecs_per_call([&]() {
+		for(auto & u : lUsers)
+			pSink = index.findFirst(u.szNick, u.szUser, u.szHost);
+	});
+	(void)pSink;
+
+	dOld /= BENCHMARK_MASKINDEX_LOOKUPS;
+	dNew /= BENCHMARK_MASKINDEX_LOOKUPS;
+	printf("  %6d masks, %d of %d users matched: linear scan %10.0f nsecs, index %8.0f nsecs per lookup (%.1fx)\n",
+	    iMasks, iMatched, BENCHMARK_MASKINDEX_LOOKUPS, dOld, dNew, dOld / dNew);
+	return bOk;
+}
+
+bool benchmark_mask_index()
+{
+	bool bOk = true;
+	static const int iSizes[] = { 100, 1000, 10000 };
+	for(auto iMasks : iSizes)
+	{
+		if(!benchmark_maskindex_run(iMasks))
+			bOk = false;
+	}
+	return bOk;
+}
@@ -0,0 +1,212 @@
+//=============================================================================
+//
+//   File : BenchmarkSendFile.cpp
+//   Creation date : Sun 18 Oct 2026 17:05:31 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The data path of DccSendThread on a plain connection: the file is pushed
+// through a loopback socket with read() + send() and with sendfile(), using
+// the chunk sizes of the send loop. The socket calls are the same ones that
+// the thread makes, without its poll() and bandwidth bookkeeping.
+// The CPU time is the one of the sending thread, where the copies happen.
+//
+
+#include "Benchmark.h"
+
+#include "kvi_settings.h"
+
+#include <stdio.h>
+
+#ifdef HAVE_SENDFILE
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <thread>
+
+#define BENCHMARK_SENDFILE_FILE_SIZE 67108864
+#define BENCHMARK_SENDFILE_ROUNDS 5
+// the default DccSendPacketSize and ZERO_COPY_MAX_CHUNK_SIZE of DccFileTransferThread.cpp
+#define BENCHMARK_SENDFILE_PACKET_SIZE 16384
+#define BENCHMARK_SENDFILE_MAX_CHUNK_SIZE 262144
+
+struct BenchmarkSendFileResult
+{
+	long long iNSecs;
+	long long iCpuNSecs;
+	long long iCalls;
+};
+
+static bool benchmark_sendfile_connect(int * pSendFd, int * pRecvFd)
+{
+	int listenFd = ::socket(PF_INET, SOCK_STREAM, 0);
+	if(listenFd < 0)
+		return false;
+
+	struct sockaddr_in sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t len = sizeof(sa);
+
+	bool bOk = (::bind(listenFd, (struct sockaddr *)&sa, sizeof(sa)) == 0) && (::listen(listenFd, 1) == 0)
+	    && (getsockname(listenFd, (struct sockaddr *)&sa, &len) == 0);
+
+	*pRecvFd = bOk ? ::socket(PF_INET, SOCK_STREAM, 0) : -1;
+	bOk = bOk && (*pRecvFd >= 0) && (::connect(*pRecvFd, (struct sockaddr *)&sa, sizeof(sa)) == 0);
+	*pSendFd = bOk ? ::accept(listenFd, nullptr, nullptr) : -1;
+	bOk = bOk && (*pSendFd >= 0);
+
+	::close(listenFd);
+	if(!bOk && (*pRecvFd >= 0))
+		::close(*pRecvFd);
+	return bOk;
+}
+
+// Sends the whole file on a new connection: the time includes the drain of the receiving side
+static bool benchmark_sendfile_round(int iFile, long long iSize, bool bSendFile, int iChunk, BenchmarkSendFileResult * r)
+{
+	int iSendFd, iRecvFd;
+	if(!benchmark_sendfile_connect(&iSendFd, &iRecvFd))
+		return false;
+
+	long long iReceived = 0;
+	std::thread drain([iRecvFd, &iReceived]() {
+		char * pBuffer = (char *)malloc(BENCHMARK_SENDFILE_MAX_CHUNK_SIZE);
+		ssize_t iLen;
+		while((iLen = ::recv(iRecvFd, pBuffer, BENCHMARK_SENDFILE_MAX_CHUNK_SIZE, 0)) > 0)
+			iReceived += iLen;
+		free(pBuffer);
+		::close(iRecvFd);
+	});
+
+	char * pBuffer = (char *)malloc(iChunk);
+	bool bOk = (lseek(iFile, 0, SEEK_SET) == 0);
+	off_t offset = 0;
+	r->iCalls = 0;
+
+	long long iStart = benchmark_nsecs_now();
+	long long iCpuStart = benchmark_thread_cpu_nsecs();
+
+	while(bOk && (offset < iSize))
+	{
+		size_t uLen = (iSize - offset) < iChunk ? (size_t)(iSize - offset) : (size_t)iChunk;
+		if(bSendFile)
+		{
+			// moves offset forward, may send less than asked
+			r->iCalls++;
+			bOk = ::sendfile(iSendFd, iFile, &offset, uLen) > 0;
+		}
+		else
+		{
+			r->iCalls++;
+			ssize_t iRead = ::read(iFile, pBuffer, uLen);
+			bOk = iRead > 0;
+			ssize_t iSent = 0;
+			while(bOk && (iSent < iRead))
+			{
+				r->iCalls++;
+				ssize_t iLen = ::send(iSendFd, pBuffer + iSent, iRead - iSent, 0);
+				bOk = iLen > 0;
+				iSent += iLen;
+			}
+			offset += iRead;
+		}
+	}
+
+	r->iCpuNSecs = benchmark_thread_cpu_nsecs() - iCpuStart;
+	::close(iSendFd);
+	drain.join();
+	r->iNSecs = benchmark_nsecs_now() - iStart;
+
+	free(pBuffer);
+	return bOk && (iReceived == iSize);
+}
+
+bool benchmark_sendfile()
+{
+	char szFileName[] = "/tmp/kvibench_sendfile_XXXXXX";
+	int iFile = mkstemp(szFileName);
+	if(iFile < 0)
+	{
+		printf("  can't create a temporary file\n");
+		return false;
+	}
+	unlink(szFileName);
+
+	// write the file: it stays in the page cache, as a file that was just sent
+	char * pBuffer = (char *)malloc(BENCHMARK_SENDFILE_MAX_CHUNK_SIZE);
+	for(int i = 0; i < BENCHMARK_SENDFILE_MAX_CHUNK_SIZE; i++)
+		pBuffer[i] = (char)(i * 31 + (i >> 8));
+	bool bOk = true;
+	for(long long iDone = 0; bOk && (iDone < BENCHMARK_SENDFILE_FILE_SIZE); iDone += BENCHMARK_SENDFILE_MAX_CHUNK_SIZE)
+		bOk = ::write(iFile, pBuffer, BENCHMARK_SENDFILE_MAX_CHUNK_SIZE) == BENCHMARK_SENDFILE_MAX_CHUNK_SIZE;
+	free(pBuffer);
+
+	struct
+	{
+		const char * szLabel;
+		bool bSendFile;
+		int iChunk;
+	} methods[] = {
+		{ "read() + send(), 16 KiB packets", false, BENCHMARK_SENDFILE_PACKET_SIZE },
+		{ "sendfile(), 16 KiB packets", true, BENCHMARK_SENDFILE_PACKET_SIZE },
+		{ "sendfile(), 256 KiB chunks (fast send)", true, BENCHMARK_SENDFILE_MAX_CHUNK_SIZE }
+	};
+
+	printf("  %d MiB over loopback, best of %d rounds\n", BENCHMARK_SENDFILE_FILE_SIZE / 1048576, BENCHMARK_SENDFILE_ROUNDS);
+
+	for(unsigned int m = 0; bOk && (m < sizeof(methods) / sizeof(methods[0])); m++)
+	{
+		BenchmarkSendFileResult best = { 0, 0, 0 };
+		for(int i = 0; bOk && (i < BENCHMARK_SENDFILE_ROUNDS); i++)
+		{
+			BenchmarkSendFileResult r;
+			bOk = benchmark_sendfile_round(iFile, BENCHMARK_SENDFILE_FILE_SIZE, methods[m].bSendFile, methods[m].iChunk, &r);
+			if(bOk && ((best.iNSecs == 0) || (r.iNSecs < best.iNSecs)))
+				best = r;
+		}
+		if(bOk)
+			printf("  %-40s: %8.1f MB/s, %5lld msecs of CPU time, %6lld calls\n", methods[m].szLabel,
+			    ((double)BENCHMARK_SENDFILE_FILE_SIZE / 1048576.0) / ((double)best.iNSecs / 1000000000.0),
+			    best.iCpuNSecs / 1000000, best.iCalls);
+	}
+
+	::close(iFile);
+
+	if(!bOk)
+		printf("  the transfer failed\n");
+	return bOk;
+}
+
+#else //!HAVE_SENDFILE
+
+bool benchmark_sendfile()
+{
+	printf("  sendfile() is not available on this platform\n");
+	return true;
+}
+
+#endif //!HAVE_SENDFILE
@@ -0,0 +1,141 @@
+//=============================================================================
+//
+//   File : BenchmarkVideoConversion.cpp
+//   Creation date : Sun 18 Oct 2026 18:10:54 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The argb32 to Y'CbCr conversion of the DCC VIDEO encoder: the per pixel loop
+// that KviOggTheoraEncoder used before KviYuvConversion, the scalar row
+// functions and the SSE2 ones. The frames have random pixels.
+//
+
+#include "Benchmark.h"
+
+#include "KviYuvConversion.h"
+
+#include <QRgb>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+// The old conversion, into a planar 4:4:4 buffer
+static void benchmark_rgb32toyuv444_old(const QRgb * rgbPt, unsigned char * yuvPt, int w, int h)
+{
+	for(int i = 0; i < h; i++)
+	{
+		for(int j = 0; j < w; j++)
+		{
+			yuvPt[i * w + j] = (unsigned char)((66 * qRed(*rgbPt) + 129 * qGreen(*rgbPt) + 25 * qBlue(*rgbPt) + 128) >> 8) + 16;            // y
+			yuvPt[(i + h) * w + j] = (unsigned char)((-38 * qRed(*rgbPt) - 74 * qGreen(*rgbPt) + 112 * qBlue(*rgbPt) + 128) >> 8) + 128;    // u
+			yuvPt[(i + 2 * h) * w + j] = (unsigned char)((112 * qRed(*rgbPt) - 94 * qGreen(*rgbPt) - 18 * qBlue(*rgbPt) + 128) >> 8) + 128; // v
+			rgbPt++;
+		}
+	}
+}
+
+// The same layout as the old conversion
+static void benchmark_yuv444(const QRgb * rgb, quint8 * yuv, int w, int h, bool bScalar)
+{
+	quint8 * u = yuv + w * h;
+	quint8 * v = u + w * h;
+	for(int i = 0; i < h; i++)
+	{
+		if(bScalar)
+			KviYuvConversion::rgb32ToYuv444RowScalar(rgb + i * w, yuv + i * w, u + i * w, v + i * w, w);
+		else
+			KviYuvConversion::rgb32ToYuv444Row(rgb + i * w, yuv + i * w, u + i * w, v + i * w, w);
+	}
+}
+
+// The loop of KviOggTheoraEncoder::addVideoFrame(), with packed planes
+static void benchmark_yuv420(const QRgb * rgb, quint8 * yuv, int w, int h, bool bScalar)
+{
+	int cw = (w + 1) / 2;
+	quint8 * u = yuv + w * h;
+	quint8 * v = u + cw * ((h + 1) / 2);
+	for(int i = 0; i < h; i += 2)
+	{
+		bool bLast = (i + 1) >= h;
+		const QRgb * rgb1 = rgb + (bLast ? i : i + 1) * w;
+		quint8 * y1 = bLast ? nullptr : yuv + (i + 1) * w;
+		if(bScalar)
+			KviYuvConversion::rgb32ToYuv420RowsScalar(rgb + i * w, rgb1, yuv + i * w, y1, u + (i >> 1) * cw, v + (i >> 1) * cw, w);
+		else
+			KviYuvConversion::rgb32ToYuv420Rows(rgb + i * w, rgb1, yuv + i * w, y1, u + (i >> 1) * cw, v + (i >> 1) * cw, w);
+	}
+}
+
+bool benchmark_video_conversion()
+{
+#ifdef __SSE2__
+	const char * szSimd = "SSE2";
+#else
+	const char * szSimd = "no SIMD compiled in";
+#endif
+
+	static const int sizes[][2] = { { 320, 240 }, { 640, 480 }, { 1280, 720 }, { 333, 251 } };
+	bool bOk = true;
+
+	srand(1);
+
+	for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		int w = sizes[s][0];
+		int h = sizes[s][1];
+
+		std::vector<QRgb> frame(w * h);
+		for(auto & p : frame)
+			p = qRgb(rand() & 0xff, rand() & 0xff, rand() & 0xff);
+
+		std::vector<quint8> old444(w * h * 3), scalar444(w * h * 3), simd444(w * h * 3);
+		std::vector<quint8> scalar420(w * h * 2), simd420(w * h * 2);
+
+		double dOld = benchmark_nsecs_per_call([&]() { benchmark_rgb32toyuv444_old(frame.data(), old444.data(), w, h); });
+		double dScalar = benchmark_nsecs_per_call([&]() { benchmark_yuv444(frame.data(), scalar444.data(), w, h, true); });
+		double dSimd = benchmark_nsecs_per_call([&]() { benchmark_yuv444(frame.data(), simd444.data(), w, h, false); });
+		double dScalar420 = benchmark_nsecs_per_call([&]() { benchmark_yuv420(frame.data(), scalar420.data(), w, h, true); });
+		double dSimd420 = benchmark_nsecs_per_call([&]() { benchmark_yuv420(frame.data(), simd420.data(), w, h, false); });
+
+		printf("  %dx%d frames per second\n", w, h);
+		printf("    4:4:4 old per pixel loop     : %8.0f\n", 1000000000.0 / dOld);
+		printf("    4:4:4 scalar rows            : %8.0f\n", 1000000000.0 / dScalar);
+		printf("    4:4:4 rows (%s)%*s: %8.0f\n", szSimd, (int)(16 - strlen(szSimd)), "", 1000000000.0 / dSimd);
+		printf("    4:2:0 scalar rows            : %8.0f\n", 1000000000.0 / dScalar420);
+		printf("    4:2:0 rows (%s)%*s: %8.0f\n", szSimd, (int)(16 - strlen(szSimd)), "", 1000000000.0 / dSimd420);
+
+		if((scalar444 != old444) || (simd444 != old444))
+		{
+			printf("    the 4:4:4 output differs from the old one\n");
+			bOk = false;
+		}
+		if(simd420 != scalar420)
+		{
+			printf("    the 4:2:0 outputs differ\n");
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
@@ -0,0 +1,140 @@
+//=============================================================================
+//
+//   File : kvibench.cpp
+//   Creation date : Sun 18 Oct 2026 17:05:31 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// Usage: kvibench [benchmark name ...]
+//
+// Runs the named benchmarks, or all of them. kvibench --list lists them.
+// The timings depend on the machine: compare the lines of the same run.
+//
+
+#include "Benchmark.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+struct BenchmarkEntry
+{
+	const char * szName;
+	const char * szDescription;
+	bool (*pFunction)();
+};
+
+static const BenchmarkEntry g_benchmarks[] = {
+	{ "adpcm", "DCC VOICE ADPCM codec: the table driven coder against the old one", benchmark_adpcm },
+	{ "language", "Language detector: the merged tables against the descriptor by descriptor scoring", benchmark_language_detector },
+	{ "maskindex", "Registered user masks: the host indexed lookup against the linear scan", benchmark_mask_index },
+	{ "sendfile", "DCC SEND data path: sendfile() against read() + send()", benchmark_sendfile },
+	{ "yuv", "DCC VIDEO frame conversion: the SSE2 and scalar rows against the old loop", benchmark_video_conversion },
+	{ nullptr, nullptr, nullptr }
+};
+
+// benchmark_nsecs_per_call() keeps the fastest of these
+#define BENCHMARK_ROUNDS 10
+
+long long benchmark_nsecs_now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long benchmark_thread_cpu_nsecs()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+	struct timespec ts;
+	if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+		return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+	return 0;
+}
+
+double benchmark_nsecs_per_call(const std::function<void()> & f, int iMinMSecs)
+{
+	// one call to warm up the caches
+	f();
+
+	// the rounds that were slowed down by the rest of the system are discarded
+	long long iRoundNSecs = (long long)iMinMSecs * 1000000LL / BENCHMARK_ROUNDS;
+	double dBest = 0.0;
+	for(int i = 0; i < BENCHMARK_ROUNDS; i++)
+	{
+		long long iCalls = 0;
+		long long iStart = benchmark_nsecs_now();
+		long long iElapsed;
+		do
+		{
+			f();
+			iCalls++;
+			iElapsed = benchmark_nsecs_now() - iStart;
+		} while(iElapsed < iRoundNSecs);
+
+		double dNSecs = (double)iElapsed / (double)iCalls;
+		if((i == 0) || (dNSecs < dBest))
+			dBest = dNSecs;
+	}
+	return dBest;
+}
+
+int main(int argc, char ** argv)
+{
+	if((argc > 1) && ((strcmp(argv[1], "--list") == 0) || (strcmp(argv[1], "--help") == 0)))
+	{
+		printf("Usage: %s [benchmark name ...]\n", argv[0]);
+		for(int i = 0; g_benchmarks[i].szName; i++)
+			printf("  %-12s %s\n", g_benchmarks[i].szName, g_benchmarks[i].szDescription);
+		return 0;
+	}
+
+	int iFailures = 0;
+	int iRun = 0;
+
+	for(int i = 0; g_benchmarks[i].szName; i++)
+	{
+		bool bSelected = argc < 2;
+		for(int j = 1; j < argc; j++)
+		{
+			if(strcmp(argv[j], g_benchmarks[i].szName) == 0)
+				bSelected = true;
+		}
+		if(!bSelected)
+			continue;
+
+		printf("%s: %s\n", g_benchmarks[i].szName, g_benchmarks[i].szDescription);
+		if(!g_benchmarks[i].pFunction())
+		{
+			printf("  FAILED\n");
+			iFailures++;
+		}
+		iRun++;
+	}
+
+	if(iRun == 0)
+	{
+		printf("No such benchmark: try %s --list\n", argv[0]);
+		return 2;
+	}
+
+	return iFailures ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+//=============================================================================
+//
+//   File : KviCompiledFormat.cpp
+//   Creation date : Sun 18 Oct 2026 22:10:47 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviCompiledFormat.h"
+#include "KviQString.h"
+
+#include <string.h>
+
+KviCompiledFormat::KviCompiledFormat(const QString & szFormat)
+{
+	const QChar * pFmt = szFormat.constData();
+	if(!pFmt)
+		return;
+
+	auto literal = [this](const QChar * pBegin, int iLen) {
+		// merge the consecutive literal runs
+		if(!m_Ops.empty() && (m_Ops.back().eType == Literal))
+			m_Ops.back().iLen += iLen;
+		else
+			m_Ops.push_back({ Literal, m_szLiterals.length(), iLen });
+		m_szLiterals.append(pBegin, iLen);
+	};
+
+	// the same rules of KviQString::vsprintf()
+	while(pFmt->unicode())
+	{
+		if(pFmt->unicode() != '%')
+		{
+			const QChar * pBegin = pFmt;
+			while(pFmt->unicode() && (pFmt->unicode() != '%'))
+				pFmt++;
+			literal(pBegin, pFmt - pBegin);
+			continue;
+		}
+
+		pFmt++; // skip the '%'
+		OpType eType;
+		switch(pFmt->unicode())
+		{
+			case 's':
+				eType = String;
+				break;
+			case 'S':
+				eType = CString;
+				break;
+			case 'Q':
+				eType = QtString;
+				break;
+			case 'c':
+				eType = Char;
+				break;
+			case 'q':
+				eType = QtChar;
+				break;
+			case 'd':
+				eType = Int;
+				break;
+			case 'u':
+				eType = UInt;
+				break;
+			case 'h':
+			case 'x':
+				eType = HexLower;
+				break;
+			case 'H':
+			case 'X':
+				eType = HexUpper;
+				break;
+			default:
+				// a normal percent followed by some char
+				literal(pFmt - 1, pFmt->unicode() ? 2 : 1);
+				if(!pFmt->unicode())
+					return; // the format ends with a '%'
+				pFmt++;
+				continue;
+		}
+		m_Ops.push_back({ eType, 0, 0 });
+		pFmt++;
+	}
+}
+
+KviCompiledFormat::~KviCompiledFormat()
+    = default;
+
+static void append_number(QString & szBuffer, unsigned long ulValue, unsigned int uBase, const char * pcDigits)
+{
+	char cNumberBuffer[32];
+	char * pcNumBuf = cNumberBuffer;
+	unsigned int iTmp;
+	do
+	{
+		iTmp = ulValue / uBase;
+		*pcNumBuf++ = pcDigits[ulValue - (iTmp * uBase)];
+	} while((ulValue = iTmp));
+	do
+	{
+		szBuffer.append(QChar::fromLatin1(*--pcNumBuf));
+	} while(pcNumBuf != cNumberBuffer);
+}
+
+void KviCompiledFormat::format(QString & szBuffer, kvi_va_list list) const
+{
+	static const char cDecDigits[] = "0123456789";
+	static const char cHexSmallDigits[] = "0123456789abcdef";
+	static const char cHexBigDigits[] = "0123456789ABCDEF";
+
+	szBuffer.clear();
+	szBuffer.reserve(m_szLiterals.length() + 64);
+
+	const QChar * pLiterals = m_szLiterals.constData();
+
+	for(auto & op : m_Ops)
+	{
+		switch(op.eType)
+		{
+			case Literal:
+				szBuffer.append(pLiterals + op.iBegin, op.iLen);
+				break;
+			case String:
+			{
+				const char * pcArgString = kvi_va_arg(list, char *);
+				if(!pcArgString)
+					pcArgString = "[!NULL!]";
+				szBuffer.append(QString(pcArgString));
+			}
+			break;
+			case CString:
+			{
+				KviCString * szStr = kvi_va_arg(list, KviCString *);
+				if(!szStr)
+					break;
+				const char * pcArgString = szStr->ptr();
+				while(*pcArgString)
+					szBuffer.append(QChar::fromLatin1(*pcArgString++));
+			}
+			break;
+			case QtString:
+			{
+				QString * szStr = kvi_va_arg(list, QString *);
+				if(szStr)
+					szBuffer.append(*szStr);
+			}
+			break;
+			case Char:
+				szBuffer.append(QChar::fromLatin1((char)kvi_va_arg(list, int)));
+				break;
+			case QtChar:
+				szBuffer.append(*((QChar *)kvi_va_arg(list, QChar *)));
+				break;
+			case Int:
+			{
+				long lArgValue = kvi_va_arg(list, int);
+				if(lArgValue < 0)
+				{
+					szBuffer.append(QChar('-'));
+					// most negative integer exception (avoid completely senseless (non digit) responses)
+					lArgValue = -lArgValue;
+					if(lArgValue < 0)
+						lArgValue = 0;
+				}
+				append_number(szBuffer, lArgValue, 10, cDecDigits);
+			}
+			break;
+			case UInt:
+				append_number(szBuffer, kvi_va_arg(list, unsigned int), 10, cDecDigits);
+				break;
+			case HexLower:
+				append_number(szBuffer, kvi_va_arg(list, unsigned int), 16, cHexSmallDigits);
+				break;
+			case HexUpper:
+				append_number(szBuffer, kvi_va_arg(list, unsigned int), 16, cHexBigDigits);
+				break;
+		}
+	}
+}
+
+KviCompiledFormatCache::KviCompiledFormatCache(unsigned int uMaxEntries)
+    : m_uMaxEntries(uMaxEntries)
+{
+}
+
+KviCompiledFormatCache::~KviCompiledFormatCache()
+{
+	clear();
+}
+
+void KviCompiledFormatCache::clear()
+{
+	for(auto & e : m_QStringEntries)
+		delete e.second.pFormat;
+	for(auto & e : m_CharEntries)
+		delete e.second.pFormat;
+	for(auto & e : m_WCharEntries)
+		delete e.second.pFormat;
+	m_QStringEntries.clear();
+	m_CharEntries.clear();
+	m_WCharEntries.clear();
+}
+
+KviCompiledFormat * KviCompiledFormatCache::compile(const QString & szFormat)
+{
+	if((m_QStringEntries.size() + m_CharEntries.size() + m_WCharEntries.size()) >= m_uMaxEntries)
+		clear(); // the formats seen again will be compiled again
+	return new KviCompiledFormat(szFormat);
+}
+
+void KviCompiledFormatCache::vsprintf(QString & szBuffer, const QString & szFormat, kvi_va_list list)
+{
+	// a format that isn't shared has been probably built on the fly and won't be seen again
+	if(szFormat.isDetached())
+	{
+		KviQString::vsprintf(szBuffer, szFormat, list);
+		return;
+	}
+
+	const void * pKey = szFormat.constData();
+	auto it = m_QStringEntries.find(pKey);
+	// the data of the cached format can't change: comparing a string with itself is cheap
+	if((it != m_QStringEntries.end()) && (it->second.szFormat == szFormat))
+	{
+		it->second.pFormat->format(szBuffer, list);
+		return;
+	}
+
+	KviCompiledFormat * pFormat = compile(szFormat);
+	Entry & e = m_QStringEntries[pKey];
+	delete e.pFormat; // a raw data string over the same buffer, with another length
+	e.pFormat = pFormat;
+	e.szFormat = szFormat;
+	pFormat->format(szBuffer, list);
+}
+
+void KviCompiledFormatCache::vsprintf(QString & szBuffer, const char * pcFormat, kvi_va_list list)
+{
+	if(!pcFormat)
+	{
+		KviQString::vsprintf(szBuffer, QString(), list);
+		return;
+	}
+
+	auto it = m_CharEntries.find(pcFormat);
+	if((it != m_CharEntries.end()) && (strcmp(it->second.szKey.constData(), pcFormat) == 0))
+	{
+		it->second.pFormat->format(szBuffer, list);
+		return;
+	}
+
+	KviCompiledFormat * pFormat = compile(QString(pcFormat));
+	Entry & e = m_CharEntries[pcFormat];
+	delete e.pFormat; // the buffer has been reused for another format
+	e.pFormat = pFormat;
+	e.szKey = QByteArray(pcFormat);
+	pFormat->format(szBuffer, list);
+}
+
+void KviCompiledFormatCache::vsprintf(QString & szBuffer, const kvi_wchar_t * pwFormat, kvi_va_list list)
+{
+	if(!pwFormat)
+	{
+		KviQString::vsprintf(szBuffer, QString::fromUtf8(KviCString(pwFormat).ptr()), list);
+		return;
+	}
+
+	int iBytes = (kvi_wstrlen(pwFormat) + 1) * sizeof(kvi_wchar_t);
+	auto it = m_WCharEntries.find(pwFormat);
+	if((it != m_WCharEntries.end()) && (it->second.szKey.size() == iBytes) && (memcmp(it->second.szKey.constData(), pwFormat, iBytes) == 0))
+	{
+		it->second.pFormat->format(szBuffer, list);
+		return;
+	}
+
+	KviCompiledFormat * pFormat = compile(QString::fromUtf8(KviCString(pwFormat).ptr()));
+	Entry & e = m_WCharEntries[pwFormat];
+	delete e.pFormat; // the buffer has been reused for another format
+	e.pFormat = pFormat;
+	e.szKey = QByteArray((const char *)pwFormat, iBytes);
+	pFormat->format(szBuffer, list);
+}
@@ -0,0 +1,183 @@
+#ifndef _KVI_COMPILEDFORMAT_H_
+#define _KVI_COMPILEDFORMAT_H_
+//=============================================================================
+//
+//   File : KviCompiledFormat.h
+//   Creation date : Sun 18 Oct 2026 22:10:47 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviCompiledFormat.h
+* \author the KVIrc development team
+* \brief KviQString::vsprintf() formats parsed once
+*
+* The output functions are called with a handful of formats (mostly
+* translated strings) over and over. A compiled format is the list of the
+* literal runs and of the conversions of its format string: filling it
+* skips the parsing and writes the result with a single allocation.
+*/
+
+#include "kvi_settings.h"
+#include "kvi_stdarg.h"
+#include "KviCString.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <unordered_map>
+#include <vector>
+
+/**
+* \class KviCompiledFormat
+* \brief A format string split in literal runs and conversions
+*
+* The result of format() is the same of KviQString::vsprintf() with the
+* same format and arguments.
+*/
+class KVILIB_API KviCompiledFormat
+{
+public:
+	/**
+	* \brief Parses the format
+	* \param szFormat The format, as accepted by KviQString::vsprintf()
+	* \return KviCompiledFormat
+	*/
+	KviCompiledFormat(const QString & szFormat);
+	~KviCompiledFormat();
+
+protected:
+	enum OpType
+	{
+		Literal,  // a run of m_szLiterals
+		String,   // %s: char *
+		CString,  // %S: KviCString *
+		QtString, // %Q: QString *
+		Char,     // %c
+		QtChar,   // %q: QChar *
+		Int,      // %d
+		UInt,     // %u
+		HexLower, // %x and %h
+		HexUpper  // %X and %H
+	};
+
+	struct Op
+	{
+		OpType eType;
+		int iBegin; // for Literal only
+		int iLen;   // for Literal only
+	};
+
+	QString m_szLiterals;
+	std::vector<Op> m_Ops;
+
+public:
+	/**
+	* \brief Fills the format with the arguments
+	* \param szBuffer The buffer that receives the result (replacing its contents)
+	* \param list The arguments
+	* \return void
+	*/
+	void format(QString & szBuffer, kvi_va_list list) const;
+};
+
+/**
+* \class KviCompiledFormatCache
+* \brief Keeps the compiled formats keyed by the address of the format
+*
+* A cached entry keeps a copy of its format, so a format found at a known
+* address is checked without parsing it again. The QString formats are
+* cached only when their data is shared (for example with a message
+* catalogue): the reference held by the cache keeps the data from being
+* modified or freed and thus the address from being reused by another string.
+* The cache is not thread safe.
+*/
+class KVILIB_API KviCompiledFormatCache
+{
+public:
+	/**
+	* \brief Creates the cache
+	* \param uMaxEntries The cache is emptied when it reaches this size
+	* \return KviCompiledFormatCache
+	*/
+	KviCompiledFormatCache(unsigned int uMaxEntries = 256);
+	~KviCompiledFormatCache();
+
+protected:
+	struct Entry
+	{
+		KviCompiledFormat * pFormat = nullptr;
+		QString szFormat; // for the QString formats
+		QByteArray szKey; // for the char * and kvi_wchar_t * formats
+	};
+
+	// a kvi_wchar_t * format may point to the data of a QString format: keep them apart
+	std::unordered_map<const void *, Entry> m_QStringEntries;
+	std::unordered_map<const void *, Entry> m_CharEntries;
+	std::unordered_map<const void *, Entry> m_WCharEntries;
+	unsigned int m_uMaxEntries;
+
+public:
+	/**
+	* \brief Fills the format with the arguments
+	*
+	* Works like KviQString::vsprintf() but reuses the compiled format
+	* when the format has been seen before.
+	* \param szBuffer The buffer that receives the result
+	* \param szFormat The format
+	* \param list The arguments
+	* \return void
+	*/
+	void vsprintf(QString & szBuffer, const QString & szFormat, kvi_va_list list);
+
+	/**
+	* \brief Fills a format with the arguments
+	*
+	* The format is decoded as utf8, like QString(pcFormat).
+	* \param szBuffer The buffer that receives the result
+	* \param pcFormat The format
+	* \param list The arguments
+	* \return void
+	*/
+	void vsprintf(QString & szBuffer, const char * pcFormat, kvi_va_list list);
+
+	/**
+	* \brief Fills a format with the arguments
+	*
+	* The format characters are truncated to 8 bits and decoded as utf8,
+	* like QString::fromUtf8(KviCString(pwFormat).ptr()).
+	* \param szBuffer The buffer that receives the result
+	* \param pwFormat The format
+	* \param list The arguments
+	* \return void
+	*/
+	void vsprintf(QString & szBuffer, const kvi_wchar_t * pwFormat, kvi_va_list list);
+
+	/**
+	* \brief Removes all the cached formats
+	* \return void
+	*/
+	void clear();
+
+protected:
+	KviCompiledFormat * compile(const QString & szFormat);
+};
+
+#endif //_KVI_COMPILEDFORMAT_H_
@@ -0,0 +1,230 @@
+//=============================================================================
+//
+//   File : KviMultiStringMatcher.cpp
+//   Creation date : Sun 18 Oct 2026 18:40:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviMultiStringMatcher.h"
+
+#include <algorithm>
+
+static bool edge_less(const std::pair<ushort, int> & e, ushort c)
+{
+	return e.first < c;
+}
+
+KviMultiStringMatcher::KviMultiStringMatcher()
+    : m_eCaseSensitivity(Qt::CaseSensitive), m_bWholeWords(false)
+{
+	clear();
+}
+
+KviMultiStringMatcher::~KviMultiStringMatcher()
+    = default;
+
+void KviMultiStringMatcher::clear()
+{
+	m_Patterns.clear();
+	m_Nodes.clear();
+	m_Nodes.resize(1);
+	m_Nodes[0].iFail = 0;
+	m_Nodes[0].iPattern = -1;
+	m_Nodes[0].iOutput = -1;
+	m_Nodes[0].iDepth = 0;
+	for(int & i : m_aRootTable)
+		i = 0;
+}
+
+void KviMultiStringMatcher::setCaseSensitivity(Qt::CaseSensitivity eCaseSensitivity)
+{
+	m_eCaseSensitivity = eCaseSensitivity;
+}
+
+void KviMultiStringMatcher::setWholeWords(bool bWholeWords, const QString & szWordSplitters)
+{
+	m_bWholeWords = bWholeWords;
+	m_szWordSplitters = szWordSplitters;
+}
+
+int KviMultiStringMatcher::addPattern(const QString & szPattern)
+{
+	if(szPattern.isEmpty())
+		return -1;
+	m_Patterns.push_back(szPattern);
+	return (int)m_Patterns.size() - 1;
+}
+
+inline ushort KviMultiStringMatcher::fold(QChar c) const
+{
+	return (m_eCaseSensitivity == Qt::CaseInsensitive) ? c.toCaseFolded().unicode() : c.unicode();
+}
+
+inline bool KviMultiStringMatcher::isWordSplitter(QChar c) const
+{
+	return c.isSpace() || m_szWordSplitters.contains(c);
+}
+
+inline int KviMultiStringMatcher::child(int iNode, ushort c) const
+{
+	if((iNode == 0) && (c < 256))
+		return m_aRootTable[c] ? m_aRootTable[c] : -1;
+	const std::vector<std::pair<ushort, int>> & e = m_Nodes[iNode].edges;
+	auto it = std::lower_bound(e.begin(), e.end(), c, edge_less);
+	if((it == e.end()) || (it->first != c))
+		return -1;
+	return it->second;
+}
+
+inline int KviMultiStringMatcher::step(int iNode, ushort c) const
+{
+	for(;;)
+	{
+		int iNext = child(iNode, c);
+		if(iNext >= 0)
+			return iNext;
+		if(iNode == 0)
+			return 0;
+		iNode = m_Nodes[iNode].iFail;
+	}
+}
+
+void KviMultiStringMatcher::compile()
+{
+	std::vector<QString> lPatterns;
+	lPatterns.swap(m_Patterns);
+	clear();
+	m_Patterns.swap(lPatterns);
+
+	// build the trie
+	for(int p = 0; p < (int)m_Patterns.size(); p++)
+	{
+		const QString & szPattern = m_Patterns[p];
+		int iNode = 0;
+		for(int i = 0; i < szPattern.length(); i++)
+		{
+			ushort c = fold(szPattern[i]);
+			int iNext = child(iNode, c);
+			if(iNext < 0)
+			{
+				iNext = (int)m_Nodes.size();
+				m_Nodes.emplace_back();
+				Node & n = m_Nodes.back();
+				n.iFail = 0;
+				n.iPattern = -1;
+				n.iOutput = -1;
+				n.iDepth = i + 1;
+
+				std::vector<std::pair<ushort, int>> & e = m_Nodes[iNode].edges;
+				e.insert(std::lower_bound(e.begin(), e.end(), c, edge_less), std::make_pair(c, iNext));
+				if((iNode == 0) && (c < 256))
+					m_aRootTable[c] = iNext;
+			}
+			iNode = iNext;
+		}
+		// the patterns are added in order: keep the first one of the duplicates
+		if(m_Nodes[iNode].iPattern < 0)
+			m_Nodes[iNode].iPattern = p;
+	}
+
+	// compute the failure links breadth first: the fail target of a node is never deeper than the node
+	std::vector<int> lQueue;
+	lQueue.reserve(m_Nodes.size());
+	for(auto & e : m_Nodes[0].edges)
+		lQueue.push_back(e.second);
+
+	for(size_t q = 0; q < lQueue.size(); q++)
+	{
+		int iNode = lQueue[q];
+		for(auto & e : m_Nodes[iNode].edges)
+		{
+			int iFail = m_Nodes[iNode].iFail;
+			int iTarget;
+			for(;;)
+			{
+				iTarget = child(iFail, e.first);
+				if(iTarget >= 0)
+					break;
+				if(iFail == 0)
+				{
+					iTarget = 0;
+					break;
+				}
+				iFail = m_Nodes[iFail].iFail;
+			}
+			Node & n = m_Nodes[e.second];
+			n.iFail = iTarget;
+			n.iOutput = (m_Nodes[iTarget].iPattern >= 0) ? iTarget : m_Nodes[iTarget].iOutput;
+			lQueue.push_back(e.second);
+		}
+	}
+}
+
+template <typename Fetch>
+int KviMultiStringMatcher::scan(int iLen, Fetch fetch) const
+{
+	int iBest = -1;
+	int iNode = 0;
+
+	for(int i = 0; i < iLen; i++)
+	{
+		iNode = step(iNode, fold(fetch(i)));
+
+		int iOut = (m_Nodes[iNode].iPattern >= 0) ? iNode : m_Nodes[iNode].iOutput;
+		while(iOut >= 0)
+		{
+			const Node & n = m_Nodes[iOut];
+			iOut = n.iOutput;
+
+			if((iBest >= 0) && (n.iPattern >= iBest))
+				continue;
+
+			if(m_bWholeWords)
+			{
+				int iStart = i - n.iDepth + 1;
+				if((iStart > 0) && !isWordSplitter(fetch(iStart - 1)))
+					continue;
+				if((i + 1 < iLen) && !isWordSplitter(fetch(i + 1)))
+					continue;
+			}
+
+			iBest = n.iPattern;
+			if(iBest == 0)
+				return 0; // can't do better
+		}
+	}
+
+	return iBest;
+}
+
+int KviMultiStringMatcher::match(const QString & szText) const
+{
+	if(m_Patterns.empty())
+		return -1;
+	const QChar * pText = szText.unicode();
+	return scan(szText.length(), [pText](int i) { return pText[i]; });
+}
+
+int KviMultiStringMatcher::match(const char * pcText, int iLen) const
+{
+	if(m_Patterns.empty() || !pcText)
+		return -1;
+	return scan(iLen, [pcText](int i) { return QChar::fromLatin1(pcText[i]); });
+}
@@ -0,0 +1,150 @@
+#ifndef _KVI_MULTISTRINGMATCHER_H_
+#define _KVI_MULTISTRINGMATCHER_H_
+//=============================================================================
+//
+//   File : KviMultiStringMatcher.h
+//   Creation date : Sun 18 Oct 2026 18:40:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviMultiStringMatcher.h
+* \author the KVIrc development team
+* \brief Looks for a set of strings in a text in a single pass
+*
+* This is an Aho-Corasick automaton: the cost of a scan depends only on
+* the length of the text and on the number of matches found, not on the
+* number of strings in the set.
+*/
+
+#include "kvi_settings.h"
+
+#include <QString>
+
+#include <vector>
+
+/**
+* \class KviMultiStringMatcher
+* \brief Finds which ones of a set of strings appear in a text
+*
+* Add the strings with addPattern(), call compile() and then match()
+* as many times as needed. Changing the set or the options requires a new
+* compile(). The patterns are identified by the order in which they
+* have been added: match() returns the lowest index of the patterns found.
+*/
+class KVILIB_API KviMultiStringMatcher
+{
+public:
+	KviMultiStringMatcher();
+	~KviMultiStringMatcher();
+
+protected:
+	struct Node
+	{
+		std::vector<std::pair<ushort, int>> edges; // sorted by character
+		int iFail;                                  // longest proper suffix that is in the trie
+		int iPattern;                               // lowest pattern ending here, -1 if none
+		int iOutput;                                // next node on the fail chain with a pattern, -1 if none
+		int iDepth;
+	};
+
+	std::vector<Node> m_Nodes;
+	int m_aRootTable[256]; // the root transitions for the latin1 range
+	std::vector<QString> m_Patterns;
+	Qt::CaseSensitivity m_eCaseSensitivity;
+	bool m_bWholeWords;
+	QString m_szWordSplitters;
+
+public:
+	/**
+	* \brief Removes all the patterns
+	* \return void
+	*/
+	void clear();
+
+	/**
+	* \brief Sets the case sensitivity of the matches
+	* \param eCaseSensitivity The case sensitivity
+	* \return void
+	*/
+	void setCaseSensitivity(Qt::CaseSensitivity eCaseSensitivity);
+
+	/**
+	* \brief Makes the patterns match only as whole words
+	*
+	* A whole word is delimited by the beginning or the end of the text,
+	* by whitespace or by one of the characters in szWordSplitters.
+	* \param bWholeWords Whether to match only whole words
+	* \param szWordSplitters The characters that split words, besides whitespace
+	* \return void
+	*/
+	void setWholeWords(bool bWholeWords, const QString & szWordSplitters = QString());
+
+	/**
+	* \brief Adds a pattern to the set
+	* \param szPattern The string to look for
+	* \return The index of the pattern, -1 if it is empty (and thus ignored)
+	*/
+	int addPattern(const QString & szPattern);
+
+	/**
+	* \brief Builds the automaton: must be called before match()
+	* \return void
+	*/
+	void compile();
+
+	/**
+	* \brief Returns true if there are no patterns to look for
+	* \return bool
+	*/
+	bool isEmpty() const { return m_Patterns.empty(); };
+
+	/**
+	* \brief Returns the pattern with the specified index
+	* \param iIdx The index returned by addPattern() or match()
+	* \return const QString &
+	*/
+	const QString & pattern(int iIdx) const { return m_Patterns[iIdx]; };
+
+	/**
+	* \brief Looks for the patterns in szText
+	* \param szText The text to scan
+	* \return The lowest index of the patterns found, -1 if none
+	*/
+	int match(const QString & szText) const;
+
+	/**
+	* \brief Looks for the patterns in a latin1 buffer
+	* \param pcText The text to scan
+	* \param iLen The length of the text
+	* \return The lowest index of the patterns found, -1 if none
+	*/
+	int match(const char * pcText, int iLen) const;
+
+protected:
+	ushort fold(QChar c) const;
+	bool isWordSplitter(QChar c) const;
+	int child(int iNode, ushort c) const;
+	int step(int iNode, ushort c) const;
+	template <typename Fetch>
+	int scan(int iLen, Fetch fetch) const;
+};
+
+#endif //_KVI_MULTISTRINGMATCHER_H_
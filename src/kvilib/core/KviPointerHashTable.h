@@ -387,6 +387,72 @@ inline const QString & kvi_hash_key_default(QString *)
 	return KviQString::Empty;
 }
 
+/**
+* \brief Hash function for the QStringRef lookup keys of the QString keyed tables
+*
+* It gives the same value as kvi_hash_hash(QString) for the referenced characters,
+* so a part of a longer string can be looked up with findRef() without copying it.
+*/
+inline unsigned int kvi_hash_hash(const QStringRef & szKey, bool bCaseSensitive)
+{
+	unsigned int uResult = 0;
+	const QChar * p = szKey.unicode();
+	if(!p)
+		return 0;
+	const QChar * e = p + szKey.length();
+	// kvi_hash_hash(QString) stops at the first null character too
+	if(bCaseSensitive)
+	{
+		while((p < e) && p->unicode())
+		{
+			uResult += p->unicode();
+			p++;
+		}
+	}
+	else
+	{
+		while((p < e) && p->unicode())
+		{
+			uResult += p->toLower().unicode();
+			p++;
+		}
+	}
+	return uResult;
+}
+
+/**
+* \brief Compares a QString key with a QStringRef lookup key
+*/
+inline bool kvi_hash_key_equal(const QString & szKey1, const QStringRef & szKey2, bool bCaseSensitive)
+{
+	if(szKey1.length() != szKey2.length())
+		return false;
+	const QChar * pC1 = szKey1.unicode();
+	const QChar * pC1e = pC1 + szKey1.length();
+	const QChar * pC2 = szKey2.unicode();
+	if(bCaseSensitive)
+	{
+		while(pC1 < pC1e)
+		{
+			if(pC1->unicode() != pC2->unicode())
+				return false;
+			pC1++;
+			pC2++;
+		}
+	}
+	else
+	{
+		while(pC1 < pC1e)
+		{
+			if(pC1->toLower().unicode() != pC2->toLower().unicode())
+				return false;
+			pC1++;
+			pC2++;
+		}
+	}
+	return true;
+}
+
 template <typename Key, typename T>
 class KviPointerHashTable;
 template <typename Key, typename T>
@@ -481,6 +547,57 @@ public:
 		return 0;
 	}
 
+	/**
+	* \brief Returns the item associated to the key
+	*
+	* This is the same as find(hKey) but skips the computation of the hash
+	* of the key: uHash must be the value of kvi_hash_hash(hKey,isCaseSensitive()).
+	* Returns NULL if no such item exists in the hash table.
+	* Places the hash table iterator at the position of the item found.
+	* \param hKey The key to find
+	* \param uHash The precomputed hash of the key
+	* \return T *
+	*/
+	T * find(const Key & hKey, unsigned int uHash)
+	{
+		m_uIteratorIdx = uHash % m_uSize;
+		if(!m_pDataArray[m_uIteratorIdx])
+			return 0;
+		for(KviPointerHashTableEntry<Key, T> * e = m_pDataArray[m_uIteratorIdx]->first(); e; e = m_pDataArray[m_uIteratorIdx]->next())
+		{
+			if(kvi_hash_key_equal(e->hKey, hKey, m_bCaseSensitive))
+				return (T *)e->pData;
+		}
+		return 0;
+	}
+
+	/**
+	* \brief Returns the item associated to a key given in another form
+	*
+	* This is the same as find() but the lookup key doesn't need to be a Key:
+	* it needs a kvi_hash_hash() that gives the same value as the one of the
+	* equal Key and a kvi_hash_key_equal(const Key &, const LookupKey &, bool).
+	* For example a QString keyed table can be searched for a QStringRef
+	* without building a QString from it.
+	* Returns NULL if no such item exists in the hash table.
+	* Places the hash table iterator at the position of the item found.
+	* \param hKey The key to find
+	* \return T *
+	*/
+	template <typename LookupKey>
+	T * findRef(const LookupKey & hKey)
+	{
+		m_uIteratorIdx = kvi_hash_hash(hKey, m_bCaseSensitive) % m_uSize;
+		if(!m_pDataArray[m_uIteratorIdx])
+			return 0;
+		for(KviPointerHashTableEntry<Key, T> * e = m_pDataArray[m_uIteratorIdx]->first(); e; e = m_pDataArray[m_uIteratorIdx]->next())
+		{
+			if(kvi_hash_key_equal(e->hKey, hKey, m_bCaseSensitive))
+				return (T *)e->pData;
+		}
+		return 0;
+	}
+
 	/**
 	* \brief Returns the item associated to the key hKey
 	*
@@ -513,6 +630,15 @@ public:
 		return m_uCount == 0;
 	}
 
+	/**
+	* \brief Returns true if the keys of this hash table are case sensitive
+	* \return bool
+	*/
+	bool isCaseSensitive() const
+	{
+		return m_bCaseSensitive;
+	}
+
 	/**
 	* \brief Inserts the item pData at the position specified by the key hKey.
 	*
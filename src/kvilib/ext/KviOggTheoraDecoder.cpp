@@ -220,6 +220,12 @@ void KviOggTheoraDecoder::addData(KviDataBuffer * stream)
 			case TH_PF_444:
 				qDebug(" 4:4:4 video");
 				break;
+			case TH_PF_422:
+				qDebug(" 4:2:2 video");
+				break;
+			case TH_PF_420:
+				qDebug(" 4:2:0 video");
+				break;
 			default:
 				qDebug(" video  (UNSUPPORTED Chroma sampling!)");
 				return;
@@ -315,26 +321,33 @@ int KviOggTheoraDecoder::queue_page(ogg_page * page)
 void KviOggTheoraDecoder::video_write(void)
 {
 	th_ycbcr_buffer yuv;
-	int y_offset;
+	int y_offset, c_offset;
 	th_decode_ycbcr_out(td, yuv);
 
+	// the chroma planes may be decimated horizontally (4:2:2) or in both directions (4:2:0)
+	int x_shift = !(px_fmt & 1);
+	int y_shift = !(px_fmt & 2);
+
 	y_offset = (geometry.pic_x & ~1) + yuv[0].stride * (geometry.pic_y & ~1);
+	c_offset = ((geometry.pic_x & ~1) >> x_shift) + yuv[1].stride * ((geometry.pic_y & ~1) >> y_shift);
 
 	for(int i = 0; i < geometry.pic_h; i++)
 	{
 		unsigned char * in_y = (unsigned char *)yuv[0].data + y_offset + yuv[0].stride * i;
-		unsigned char * in_u = (unsigned char *)yuv[1].data + y_offset + yuv[1].stride * i;
-		unsigned char * in_v = (unsigned char *)yuv[2].data + y_offset + yuv[2].stride * i;
+		unsigned char * in_u = (unsigned char *)yuv[1].data + c_offset + yuv[1].stride * (i >> y_shift);
+		unsigned char * in_v = (unsigned char *)yuv[2].data + c_offset + yuv[2].stride * (i >> y_shift);
 		unsigned char * out = RGBbuffer + (geometry.pic_w * i * ARGB32_BPP);
 		for(int j = 0; j < geometry.pic_w; j++)
 		{
 			int r, g, b;
 			int y = lu_Y[in_y[j]];
-			b = (y + lu_B[in_u[j]]) >> 21;
+			int u = in_u[j >> x_shift];
+			int v = in_v[j >> x_shift];
+			b = (y + lu_B[u]) >> 21;
 			out[j * 4] = OC_CLAMP255(b);
-			g = (y + lu_GV[in_v[j]] + lu_GU[in_u[j]]) >> 21;
+			g = (y + lu_GV[v] + lu_GU[u]) >> 21;
 			out[j * 4 + 1] = OC_CLAMP255(g);
-			r = (y + lu_R[in_v[j]]) >> 21;
+			r = (y + lu_R[v]) >> 21;
 			out[j * 4 + 2] = OC_CLAMP255(r);
 			out[j * 4 + 3] = 255; //alpha
 		}
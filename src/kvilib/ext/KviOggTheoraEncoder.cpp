@@ -28,37 +28,23 @@
 #include "KviOggTheoraEncoder.h"
 #include "KviOggIrcText.h"
 #include "KviDataBuffer.h"
+#include "KviYuvConversion.h"
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <QColor>
 
 using namespace KviOggIrcText;
 
-static void rgb32toyuv444(QRgb * rgbPt, unsigned char * yuvPt, int w, int h)
-{
-	for(int i = 0; i < h; i++)
-	{
-		for(int j = 0; j < w; j++)
-		{
-			yuvPt[i * w + j] = (unsigned char)((66 * qRed(*rgbPt) + 129 * qGreen(*rgbPt) + 25 * qBlue(*rgbPt) + 128) >> 8) + 16;            // y
-			yuvPt[(i + h) * w + j] = (unsigned char)((-38 * qRed(*rgbPt) - 74 * qGreen(*rgbPt) + 112 * qBlue(*rgbPt) + 128) >> 8) + 128;    // u
-			yuvPt[(i + 2 * h) * w + j] = (unsigned char)((112 * qRed(*rgbPt) - 94 * qGreen(*rgbPt) - 18 * qBlue(*rgbPt) + 128) >> 8) + 128; // v
-			//this moves the pointer forward 4 bytes (ARGB)
-			rgbPt++;
-		}
-	}
-	return;
-}
-
-KviOggTheoraEncoder::KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth, int iHeight, int iFpsN, int iFpsD, int iParN, int iParD)
+KviOggTheoraEncoder::KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth, int iHeight, int iFpsN, int iFpsD, int iParN, int iParD, bool bChroma420)
 {
 	//used to check functions results
 	int ret;
-	videoflag = 0;
-	videoYuv = 0;
-	frame_state = -1;
+	td = 0;
+	m_bChroma420 = bChroma420;
+	m_pPlanes[0] = m_pPlanes[1] = m_pPlanes[2] = 0;
 
 	//text
 	text_sofar = 0;
@@ -78,15 +64,6 @@ KviOggTheoraEncoder::KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth, int
 	int video_q = 48;
 	ogg_uint32_t keyframe_frequency = 64;
 
-	y4m_dst_buf_read_sz = geometry.pic_w * geometry.pic_h * 3;
-	y4m_aux_buf_sz = y4m_aux_buf_read_sz = 0;
-
-	// buffer allocations
-	y4m_dst_buf_read_sz = geometry.pic_w * geometry.pic_h * 3;
-	y4m_aux_buf_sz = y4m_aux_buf_read_sz = 0;
-	// The size of the final frame buffers is always computed from the destination chroma decimation type.
-	y4m_dst_buf_sz = geometry.pic_w * geometry.pic_h * 3;
-
 	// Set up Ogg output stream
 	srand(time(NULL));
 	ogg_stream_init(&to, rand());
@@ -108,6 +85,21 @@ KviOggTheoraEncoder::KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth, int
 	geometry.pic_x = (geometry.frame_w - geometry.pic_w) >> 1 & ~1;
 	geometry.pic_y = (geometry.frame_h - geometry.pic_h) >> 1 & ~1;
 
+	// The planes are allocated once with the full frame size: the frames
+	// are converted straight into the picture region and handed to the encoder.
+	int iChromaShift = m_bChroma420 ? 1 : 0;
+	for(int i = 0; i < 3; i++)
+	{
+		int iShift = i ? iChromaShift : 0;
+		m_ycbcr[i].width = geometry.frame_w >> iShift;
+		m_ycbcr[i].height = geometry.frame_h >> iShift;
+		m_ycbcr[i].stride = m_ycbcr[i].width;
+		m_pPlanes[i] = (quint8 *)KviMemory::allocate(m_ycbcr[i].width * m_ycbcr[i].height);
+		// the padding is black
+		memset(m_pPlanes[i], i ? 128 : 16, m_ycbcr[i].width * m_ycbcr[i].height);
+		m_ycbcr[i].data = m_pPlanes[i];
+	}
+
 	// Fill in a th_info structure with details on the format of the video you wish to encode.
 	th_info_init(&ti);
 	ti.frame_width = geometry.frame_w;
@@ -125,7 +117,7 @@ KviOggTheoraEncoder::KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth, int
 	ti.target_bitrate = 0;
 	ti.quality = video_q;
 	ti.keyframe_granule_shift = ilog(keyframe_frequency - 1);
-	ti.pixel_fmt = TH_PF_444;
+	ti.pixel_fmt = m_bChroma420 ? TH_PF_420 : TH_PF_444;
 	// Allocate a th_enc_ctx handle with th_encode_alloc().
 	td = th_encode_alloc(&ti);
 	if(td == 0)
@@ -217,37 +209,74 @@ KviOggTheoraEncoder::~KviOggTheoraEncoder()
 	th_comment_clear(&tc);
 
 	irct_encode_clear();
+
+	for(int i = 0; i < 3; i++)
+	{
+		if(m_pPlanes[i])
+			KviMemory::free(m_pPlanes[i]);
+	}
 }
 
-void KviOggTheoraEncoder::addVideoFrame(QRgb * rgb32, int)
+void KviOggTheoraEncoder::addVideoFrame(QRgb * rgb32, int videoSize)
 {
 	/*
 	 * For each uncompressed frame:
 	 *	o Submit the uncompressed frame via th_encode_ycbcr_in()
 	 *	o Repeatedly call th_encode_packetout() to retrieve any video data packets that are ready.
 	 */
+	if(!td)
+		return;
 
-	if(!videoYuv)
-		videoYuv = new quint8[geometry.pic_w * geometry.pic_h * YUV444_BPP];
-
-	rgb32toyuv444(rgb32, videoYuv, geometry.pic_w, geometry.pic_h);
-	//qDebug("addFrame p%p size%d yuv%p",rgb32,videoSize,videoYuv);
+	int w = geometry.pic_w;
+	int h = geometry.pic_h;
+	if(videoSize < (int)(w * h * sizeof(QRgb)))
+	{
+		qDebug("Short video frame (%d bytes)", videoSize);
+		return;
+	}
 
-	ogg_page videopage;
+	int iYStride = m_ycbcr[0].stride;
+	quint8 * y = m_pPlanes[0] + geometry.pic_y * iYStride + geometry.pic_x;
 
-	// is there a video page flushed?  If not, fetch one if possible
-	videoflag = fetch_and_process_video(videoYuv, &videopage, &to, td, videoflag);
+	if(m_bChroma420)
+	{
+		int iCStride = m_ycbcr[1].stride;
+		int iCOffset = (geometry.pic_y >> 1) * iCStride + (geometry.pic_x >> 1);
+		quint8 * u = m_pPlanes[1] + iCOffset;
+		quint8 * v = m_pPlanes[2] + iCOffset;
+		for(int i = 0; i < h; i += 2)
+		{
+			bool bLast = (i + 1) >= h;
+			KviYuvConversion::rgb32ToYuv420Rows(rgb32 + i * w, rgb32 + (bLast ? i : i + 1) * w,
+			    y + i * iYStride, bLast ? 0 : y + (i + 1) * iYStride,
+			    u + (i >> 1) * iCStride, v + (i >> 1) * iCStride, w);
+		}
+	}
+	else
+	{
+		quint8 * u = m_pPlanes[1] + geometry.pic_y * iYStride + geometry.pic_x;
+		quint8 * v = m_pPlanes[2] + geometry.pic_y * iYStride + geometry.pic_x;
+		for(int i = 0; i < h; i++)
+			KviYuvConversion::rgb32ToYuv444Row(rgb32 + i * w, y + i * iYStride, u + i * iYStride, v + i * iYStride, w);
+	}
 
-	// no pages?
-	if(!videoflag)
+	if(th_encode_ycbcr_in(td, m_ycbcr) < 0)
+	{
+		qDebug("Internal Theora library error.");
 		return;
+	}
 
-	th_granule_time(td, ogg_page_granulepos(&videopage));
+	ogg_packet videopacket;
+	while(th_encode_packetout(td, 0, &videopacket) > 0)
+		ogg_stream_packetin(&to, &videopacket);
 
-	// flush a video page
-	m_pStream->append(videopage.header, videopage.header_len);
-	m_pStream->append(videopage.body, videopage.body_len);
-	videoflag = 0;
+	// this is a live stream: flush a page for each frame instead of waiting for it to fill
+	ogg_page videopage;
+	while(ogg_stream_flush(&to, &videopage) > 0)
+	{
+		m_pStream->append(videopage.header, videopage.header_len);
+		m_pStream->append(videopage.body, videopage.body_len);
+	}
 }
 
 void KviOggTheoraEncoder::addTextFrame(unsigned char * textPkt, int textSize)
@@ -269,94 +298,6 @@ void KviOggTheoraEncoder::addTextFrame(unsigned char * textPkt, int textSize)
 	textflag = 0;
 }
 
-int KviOggTheoraEncoder::fetch_and_process_video_packet(quint8 * videoYuv, th_enc_ctx * td, ogg_packet * op)
-{
-	th_ycbcr_buffer ycbcr;
-
-	if(frame_state == -1)
-	{
-		/* initialize the double frame buffer */
-		yuvframe[0] = (unsigned char *)malloc(y4m_dst_buf_sz);
-		yuvframe[1] = (unsigned char *)malloc(y4m_dst_buf_sz);
-		yuvframe[2] = (unsigned char *)malloc(y4m_aux_buf_sz);
-		frame_state = 0;
-	}
-	/* read and process more video */
-
-	/* have two frame buffers full (if possible) before
-	proceeding.  after first pass and until eos, one will
-	always be full when we get here */
-	for(; frame_state < 2;)
-	{
-		/*Read the frame data that needs no conversion.*/
-		memcpy(yuvframe[frame_state], videoYuv, y4m_dst_buf_read_sz);
-		/*Read the frame data that does need conversion.*/
-		memcpy(yuvframe[2], videoYuv, y4m_aux_buf_read_sz);
-		frame_state++;
-	}
-	/* check to see if there are dupes to flush */
-	if(th_encode_packetout(td, frame_state < 1, op) > 0)
-		return 1;
-	if(frame_state < 1)
-	{
-		/* can't get here unless YUV4MPEG stream has no video */
-		qDebug("Video input contains no frames.");
-		return 0;
-	}
-	/* Theora is a one-frame-in,one-frame-out system; submit a frame
-	for compression and pull out the packet */
-
-	/*We submit the buffer to the library as if it were padded, but we do not
-	actually allocate space for the padding.
-	This is okay, because with the 1.0 API the library will never read data from the padded
-	region.*/
-	ycbcr[0].width = geometry.frame_w;
-	ycbcr[0].height = geometry.frame_h;
-	ycbcr[0].stride = geometry.pic_w;
-	ycbcr[0].data = yuvframe[0] - geometry.pic_x - geometry.pic_y * geometry.pic_w;
-
-	ycbcr[1].width = geometry.frame_w;
-	ycbcr[1].height = geometry.frame_h;
-	ycbcr[1].stride = geometry.pic_w;
-	ycbcr[1].data = yuvframe[0] + (geometry.pic_w * geometry.pic_h) - geometry.pic_x - geometry.pic_y * geometry.frame_w;
-
-	ycbcr[2].width = geometry.frame_w;
-	ycbcr[2].height = geometry.frame_h;
-	ycbcr[2].stride = geometry.pic_w;
-	ycbcr[2].data = ycbcr[1].data + (geometry.frame_w * geometry.frame_h);
-
-	th_encode_ycbcr_in(td, ycbcr);
-	{
-		unsigned char * temp = yuvframe[0];
-		yuvframe[0] = yuvframe[1];
-		yuvframe[1] = temp;
-		frame_state--;
-	}
-	/* if there was only one frame, it's the last in the stream */
-	return th_encode_packetout(td, frame_state < 1, op);
-}
-
-int KviOggTheoraEncoder::fetch_and_process_video(quint8 * videoYuv, ogg_page * videopage,
-    ogg_stream_state * to, th_enc_ctx * td, int videoflag)
-{
-	ogg_packet op;
-	int ret;
-	/* is there a video page flushed?  If not, work until there is. */
-	while(!videoflag)
-	{
-		//qDebug("fetch_and_process_video loop");
-		if(ogg_stream_pageout(to, videopage) > 0)
-			return 1;
-		if(ogg_stream_eos(to))
-			return 0;
-		ret = fetch_and_process_video_packet(videoYuv, td, &op);
-		if(ret <= 0)
-			return 0;
-		ogg_stream_packetin(to, &op);
-	}
-	return videoflag;
-}
-
 int KviOggTheoraEncoder::ilog(unsigned _v)
 {
 	int ret;
@@ -64,9 +64,11 @@ public:
 	* \param iFpsD frames per second: denominator
 	* \param iParN aspect ratio: numerator
 	* \param iParD aspect ratio: denominator
+	* \param bChroma420 encode the chroma planes at half resolution (4:2:0) instead of 4:4:4.
+	* The decoders of the older KVIrc versions can't play such a stream.
 	* \return KviOggTheoraEncoder
 	*/
-	KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth = 320, int iHeight = 240, int iFpsN = 5, int iFpsD = 1, int iParN = 4, int iParD = 3);
+	KviOggTheoraEncoder(KviDataBuffer * stream, int iWidth = 320, int iHeight = 240, int iFpsN = 5, int iFpsD = 1, int iParN = 4, int iParD = 3, bool bChroma420 = false);
 
 	/**
 	* \brief Destroys the KviOggTheoraEncoder object
@@ -76,18 +78,12 @@ public:
 private:
 	KviOggTheoraGeometry geometry; /**< Stream geometry definition */
 	KviDataBuffer * m_pStream;     /**< Stream pointer */
-	quint8 * videoYuv;             /**< Yuv encoded surface pointer */
+	bool m_bChroma420;             /**< Chroma planes at half resolution */
+	quint8 * m_pPlanes[3];         /**< Frame sized Y, Cb and Cr planes, reused for every frame */
+	th_ycbcr_buffer m_ycbcr;       /**< The planes as seen by the encoder */
 
 	ogg_int64_t text_sofar; /**< Number of transmitted text frames */
 
-	int frame_state;             /**< Internal flag used in video frame processing */
-	unsigned char * yuvframe[3]; /**< Internal struct used in video frame processing */
-
-	size_t y4m_dst_buf_sz;      /**< The size of each converted frame buffer */
-	size_t y4m_dst_buf_read_sz; /**< The amount to read directly into the converted frame buffer */
-	size_t y4m_aux_buf_sz;      /**< The size of the auxiliary buffer */
-	size_t y4m_aux_buf_read_sz; /**< The amount to read into the auxiliary buffer */
-
 	ogg_stream_state zo; /**< Take physical pages, weld into a logical stream of irct packets */
 	ogg_stream_state to; /**< Take physical pages, weld into a logical stream of theora packets */
 	ogg_page og;         /**< One Ogg bitstream page. Vorbis packets are inside */
@@ -97,13 +93,12 @@ private:
 	th_info ti;      /**< Theora stream info struct */
 	th_comment tc;   /**< Theora stream comments struct */
 
-	int textflag;  /**< Internal flag used in text frame processing */
-	int videoflag; /**< Internal flag used in video frame processing */
+	int textflag; /**< Internal flag used in text frame processing */
 public:
 	/**
 	* \brief Appends a video frame to the stream
 	* \param rgb32 video frame as a matrix of rgb32 pixels
-	* \param videoSize size of the video frame
+	* \param videoSize size of the video frame in bytes
 	* \return void
 	*/
 	void addVideoFrame(QRgb * rgb32, int videoSize);
@@ -117,18 +112,6 @@ public:
 	void addTextFrame(unsigned char * textPkt, int textSize);
 
 private:
-	/**
-	* \brief Internal function that processes a video frame to create an ogg page
-	* \return int
-	*/
-	int fetch_and_process_video(quint8 * videoYuv, ogg_page * videopage, ogg_stream_state * to, th_enc_ctx * td, int videoflag);
-
-	/**
-	* \brief Internal function that processes a video frame to create an ogg packet
-	* \return int
-	*/
-	int fetch_and_process_video_packet(quint8 * videoYuv, th_enc_ctx * td, ogg_packet * op);
-
 	/**
 	* \brief Internal function used to calculate our granule shift
 	* \return int
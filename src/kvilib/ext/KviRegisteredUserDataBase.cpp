@@ -28,6 +28,7 @@
 #include "KviRegisteredUserDataBase.h"
 #include "KviConfigurationFile.h"
 #include "KviIrcMask.h"
+#include "KviIrcMaskIndex.h"
 #include "KviLocale.h"
 
 #include <QString>
@@ -130,6 +131,8 @@ KviRegisteredUserDataBase::KviRegisteredUserDataBase()
 	m_pWildMaskList = new KviRegisteredUserMaskList;
 	m_pWildMaskList->setAutoDelete(true);
 
+	m_pWildMaskIndex = new KviIrcMaskIndex<KviRegisteredUserMask>();
+
 	m_pMaskDict = new KviPointerHashTable<QString, KviRegisteredUserMaskList>(49, false); // copy keys here!
 	m_pMaskDict->setAutoDelete(true);
 
@@ -141,6 +144,7 @@ KviRegisteredUserDataBase::~KviRegisteredUserDataBase()
 {
 	emit(databaseCleared());
 	delete m_pUserDict;
+	delete m_pWildMaskIndex;
 	delete m_pWildMaskList;
 	delete m_pMaskDict;
 	delete m_pGroupDict;
@@ -182,7 +186,7 @@ KviRegisteredUser * KviRegisteredUserDataBase::getUser(const QString & name)
 	return u;
 }
 
-static void append_mask_to_list(KviRegisteredUserMaskList * l, KviRegisteredUser * u, KviIrcMask * mask)
+static KviRegisteredUserMask * append_mask_to_list(KviRegisteredUserMaskList * l, KviRegisteredUser * u, KviIrcMask * mask)
 {
 	KviRegisteredUserMask * newMask = new KviRegisteredUserMask(u, mask);
 	int idx = 0;
@@ -191,11 +195,12 @@ static void append_mask_to_list(KviRegisteredUserMaskList * l, KviRegisteredUser
 		if(m->nonWildChars() < newMask->nonWildChars())
 		{
 			l->insert(idx, newMask);
-			return;
+			return newMask;
 		}
 		idx++;
 	}
 	l->append(newMask);
+	return newMask;
 }
 
 KviRegisteredUser * KviRegisteredUserDataBase::addMask(KviRegisteredUser * u, KviIrcMask * mask)
@@ -263,13 +268,17 @@ KviRegisteredUser * KviRegisteredUserDataBase::addMask(KviRegisteredUser * u, Kv
 		qDebug("Oops! Received an incoherent regusers action, recovered?");
 		return nullptr; // ops...already there ?
 	}
-	append_mask_to_list(l, u, mask);
+	KviRegisteredUserMask * newMask = append_mask_to_list(l, u, mask);
+	// the index prefers the masks with more info like the list does
+	if(l == m_pWildMaskList)
+		m_pWildMaskIndex->insert(mask, newMask, newMask->nonWildChars());
 	return nullptr;
 }
 
 void KviRegisteredUserDataBase::copyFrom(KviRegisteredUserDataBase * db)
 {
 	m_pUserDict->clear();
+	m_pWildMaskIndex->clear();
 	m_pWildMaskList->clear();
 	m_pMaskDict->clear();
 	m_pGroupDict->clear();
@@ -365,6 +374,7 @@ bool KviRegisteredUserDataBase::removeMaskByPointer(KviIrcMask * mask)
 			{
 				// ok..got it, remove from the list and from the user struct (user struct deletes it!)
 				emit(userChanged(mask->nick()));
+				m_pWildMaskIndex->remove(mask, m);
 				m->user()->removeMask(mask);   // this one deletes m->mask()
 				m_pWildMaskList->removeRef(m); // this one deletes m
 				return true;
@@ -420,13 +430,8 @@ KviRegisteredUserMask * KviRegisteredUserDataBase::findMatchingMask(const QStrin
 				return m;
 		}
 	}
-	// not found....lookup the wild ones
-	for(KviRegisteredUserMask * m = m_pWildMaskList->first(); m; m = m_pWildMaskList->next())
-	{
-		if(m->mask()->matchesFixed(nick, user, host))
-			return m;
-	}
-	return nullptr; // no match at all
+	// not found....lookup the wild ones: only the ones that may match the host are tested
+	return m_pWildMaskIndex->findFirst(nick, user, host);
 }
 
 KviRegisteredUser * KviRegisteredUserDataBase::findUserWithMask(const KviIrcMask & mask)
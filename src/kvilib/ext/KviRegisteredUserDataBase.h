@@ -43,6 +43,9 @@
 class KviIrcMask;
 class QString;
 
+template <typename T>
+class KviIrcMaskIndex;
+
 //
 // KviRegisteredUserDataBase
 //
@@ -50,6 +53,7 @@ class QString;
 //    The users are identified by masks stored in m_pMaskDict and m_pWildMaskList
 //    m_pMaskDict contains lists of non wild-nick KviRegisteredUserMask that point to users
 //    m_pWildMaskList is a list of wild-nick KviRegisteredUserMask that point to users
+//    m_pWildMaskIndex indexes the masks of m_pWildMaskList by host, for the lookups
 //
 
 class KVILIB_API KviRegisteredUserDataBase : public QObject
@@ -63,6 +67,7 @@ private:
 	KviPointerHashTable<QString, KviRegisteredUser> * m_pUserDict;         // unique namespace, owns the objects, does not copy keys
 	KviPointerHashTable<QString, KviRegisteredUserMaskList> * m_pMaskDict; // owns the objects, copies the keys
 	KviRegisteredUserMaskList * m_pWildMaskList;                           // owns the objects
+	KviIrcMaskIndex<KviRegisteredUserMask> * m_pWildMaskIndex;             // same masks as m_pWildMaskList
 	KviPointerHashTable<QString, KviRegisteredUserGroup> * m_pGroupDict;
 
 public:
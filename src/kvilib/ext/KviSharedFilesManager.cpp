@@ -26,14 +26,96 @@
 #include "KviConfigurationFile.h"
 #include "KviFileUtils.h"
 #include "KviIrcMask.h"
+#include "KviMemory.h"
+#include "KviThread.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
 #include <QFileInfo>
 #include <QTimer>
 
+#include <atomic>
+
 // TODO: Match servers that the file requests come from
 // TODO: Max number of downloads ?
 
-// FIXME: MD5SUM ?
+#define KVI_SHARED_FILE_DIGEST_BLOCK_SIZE 1048576
+
+class KviSharedFileDigest
+{
+public:
+	QString szDigest;
+	qint64 iSize;
+	qint64 iLastModified;
+};
+
+// The result of a KviSharedFileDigestThread, posted as KviThreadDataEvent
+class KviSharedFileDigestResult
+{
+public:
+	QString szAbsPath;
+	KviSharedFileDigest digest;
+};
+
+class KviSharedFileDigestThread : public KviThread
+{
+public:
+	KviSharedFileDigestThread(QObject * pReceiver, const QString & szAbsPath)
+	    : KviThread(), m_pReceiver(pReceiver), m_szAbsPath(szAbsPath), m_bAbort(false){};
+
+private:
+	QObject * m_pReceiver;
+	QString m_szAbsPath;
+	std::atomic<bool> m_bAbort;
+
+public:
+	const QString & absPath() { return m_szAbsPath; };
+	void abort() { m_bAbort.store(true); };
+
+protected:
+	void run() override
+	{
+		KviSharedFileDigestResult * r = new KviSharedFileDigestResult();
+		r->szAbsPath = m_szAbsPath;
+
+		QFileInfo inf(m_szAbsPath);
+		r->digest.iSize = inf.size();
+		r->digest.iLastModified = inf.lastModified().toMSecsSinceEpoch();
+
+		QFile f(m_szAbsPath);
+		if(f.open(QIODevice::ReadOnly))
+		{
+			QCryptographicHash h(QCryptographicHash::Sha256);
+			char * pBuffer = (char *)KviMemory::allocate(KVI_SHARED_FILE_DIGEST_BLOCK_SIZE);
+			bool bOk = true;
+			while(!f.atEnd())
+			{
+				if(m_bAbort.load())
+				{
+					bOk = false;
+					break;
+				}
+				qint64 iRead = f.read(pBuffer, KVI_SHARED_FILE_DIGEST_BLOCK_SIZE);
+				if(iRead < 0)
+				{
+					bOk = false;
+					break;
+				}
+				h.addData(pBuffer, iRead);
+			}
+			KviMemory::free(pBuffer);
+			f.close();
+
+			// a file that changed while we were reading it has no valid digest
+			inf.refresh();
+			if(bOk && (inf.size() == r->digest.iSize) && (inf.lastModified().toMSecsSinceEpoch() == r->digest.iLastModified))
+				r->digest.szDigest = QString::fromLatin1(h.result().toHex());
+		}
+
+		postEvent(m_pReceiver, new KviThreadDataEvent<KviSharedFileDigestResult>(KVI_THREAD_EVENT_SUCCESS, r, this));
+	}
+};
 
 /*
 	@doc: shared_files
@@ -82,6 +164,10 @@ KviSharedFilesManager::KviSharedFilesManager()
 {
 	m_pSharedListDict = new KviPointerHashTable<QString, KviSharedFileList>();
 	m_pSharedListDict->setAutoDelete(true);
+	m_pDigestCache = new KviPointerHashTable<QString, KviSharedFileDigest>();
+	m_pDigestCache->setAutoDelete(true);
+	m_pDigestThreads = new KviPointerHashTable<QString, KviSharedFileDigestThread>();
+	m_pDigestThreads->setAutoDelete(true);
 	m_pCleanupTimer = new QTimer();
 	connect(m_pCleanupTimer, SIGNAL(timeout()), this, SLOT(cleanup()));
 }
@@ -91,9 +177,87 @@ KviSharedFilesManager::~KviSharedFilesManager()
 	if(m_pCleanupTimer->isActive())
 		m_pCleanupTimer->stop();
 	delete m_pCleanupTimer;
+
+	KviPointerHashTableIterator<QString, KviSharedFileDigestThread> it(*m_pDigestThreads);
+	while(KviSharedFileDigestThread * t = it.current())
+	{
+		t->abort();
+		t->wait();
+		++it;
+	}
+	delete m_pDigestThreads;
+	KviThreadManager::killPendingEvents(this);
+
+	delete m_pDigestCache;
 	delete m_pSharedListDict;
 }
 
+QString KviSharedFilesManager::cachedDigest(const QString & szAbsPath)
+{
+	KviSharedFileDigest * d = m_pDigestCache->find(szAbsPath);
+	if(!d)
+		return QString();
+
+	QFileInfo inf(szAbsPath);
+	if((inf.size() != d->iSize) || (inf.lastModified().toMSecsSinceEpoch() != d->iLastModified))
+	{
+		// the file has changed
+		m_pDigestCache->remove(szAbsPath);
+		return QString();
+	}
+	return d->szDigest;
+}
+
+bool KviSharedFilesManager::requestDigest(const QString & szAbsPath)
+{
+	if(!cachedDigest(szAbsPath).isEmpty())
+		return true;
+	if(m_pDigestThreads->find(szAbsPath))
+		return false; // already in progress
+
+	KviSharedFileDigestThread * t = new KviSharedFileDigestThread(this, szAbsPath);
+	m_pDigestThreads->replace(szAbsPath, t);
+	if(!t->start())
+	{
+		m_pDigestThreads->remove(szAbsPath);
+		emit digestReady(szAbsPath, QString());
+	}
+	return false;
+}
+
+bool KviSharedFilesManager::event(QEvent * e)
+{
+	if(e->type() == KVI_THREAD_EVENT)
+	{
+		if(((KviThreadEvent *)e)->id() == KVI_THREAD_EVENT_SUCCESS)
+		{
+			KviSharedFileDigestResult * r = ((KviThreadDataEvent<KviSharedFileDigestResult> *)e)->getData();
+			if(r)
+			{
+				KviSharedFileDigestThread * t = m_pDigestThreads->find(r->szAbsPath);
+				if(t)
+				{
+					t->wait();
+					m_pDigestThreads->remove(r->szAbsPath);
+				}
+
+				if(!r->digest.szDigest.isEmpty())
+				{
+					KviSharedFileDigest * d = new KviSharedFileDigest(r->digest);
+					m_pDigestCache->replace(r->szAbsPath, d);
+				}
+
+				QString szPath = r->szAbsPath;
+				QString szDigest = r->digest.szDigest;
+				delete r;
+				emit digestReady(szPath, szDigest);
+			}
+			return true;
+		}
+	}
+	return QObject::event(e);
+}
+
 void KviSharedFilesManager::cleanup()
 {
 	KviPointerHashTableIterator<QString, KviSharedFileList> it(*m_pSharedListDict);
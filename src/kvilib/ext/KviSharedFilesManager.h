@@ -31,6 +31,8 @@
 #include <QObject>
 
 class KviIrcMask;
+class KviSharedFileDigest;
+class KviSharedFileDigestThread;
 class QString;
 class QTimer;
 
@@ -44,6 +46,9 @@ public:
 private:
 	QTimer * m_pCleanupTimer;
 	KviPointerHashTable<QString, KviSharedFileList> * m_pSharedListDict;
+	// SHA-256 digests of the files, by absolute path
+	KviPointerHashTable<QString, KviSharedFileDigest> * m_pDigestCache;
+	KviPointerHashTable<QString, KviSharedFileDigestThread> * m_pDigestThreads;
 
 public:
 	void addSharedFile(KviSharedFile * f);
@@ -55,6 +60,17 @@ public:
 	void save(const QString & filename);
 	void clear();
 	KviPointerHashTable<QString, KviSharedFileList> * sharedFileListDict() { return m_pSharedListDict; };
+	// Returns the hex SHA-256 digest of the file if it is cached and the file
+	// hasn't changed (size and modification time) since it was computed.
+	// Returns an empty string otherwise.
+	QString cachedDigest(const QString & szAbsPath);
+	// Returns true if the digest is already cached. Otherwise starts computing
+	// it in a slave thread and emits digestReady() when done.
+	bool requestDigest(const QString & szAbsPath);
+
+protected:
+	bool event(QEvent * e) override;
+
 private:
 	void doInsert(KviSharedFileList * l, KviSharedFile * o);
 private slots:
@@ -63,6 +79,8 @@ signals:
 	void sharedFilesChanged(); // emitted when the list is cleared at once
 	void sharedFileAdded(KviSharedFile * f);
 	void sharedFileRemoved(KviSharedFile * f);
+	// szDigest is empty if the digest couldn't be computed
+	void digestReady(const QString & szAbsPath, const QString & szDigest);
 };
 
 #endif //_KVI_FILETRADER_H_
@@ -0,0 +1,154 @@
+//=============================================================================
+//
+//   File : KviYuvConversion.cpp
+//   Creation date : Sun 18 Oct 2026 17:48:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviYuvConversion.h"
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// The SSE2 code computes exactly the same values in 16 bit lanes:
+// the partial sums may wrap but the final ones always fit.
+static inline int yuvY(QRgb p)
+{
+	return ((66 * qRed(p) + 129 * qGreen(p) + 25 * qBlue(p) + 128) >> 8) + 16;
+}
+
+static inline int yuvU(QRgb p)
+{
+	return ((-38 * qRed(p) - 74 * qGreen(p) + 112 * qBlue(p) + 128) >> 8) + 128;
+}
+
+static inline int yuvV(QRgb p)
+{
+	return ((112 * qRed(p) - 94 * qGreen(p) - 18 * qBlue(p) + 128) >> 8) + 128;
+}
+
+#ifdef __SSE2__
+// Converts 8 argb32 pixels, the results are in 16 bit lanes
+static inline void rgb32toyuv8(const QRgb * rgb, __m128i & y, __m128i & u, __m128i & v)
+{
+	const __m128i mask = _mm_set1_epi32(0xff);
+	__m128i p0 = _mm_loadu_si128((const __m128i *)rgb);
+	__m128i p1 = _mm_loadu_si128((const __m128i *)(rgb + 4));
+
+	__m128i b = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+	__m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+	__m128i r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+
+	const __m128i round = _mm_set1_epi16(128);
+
+	y = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)), _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+	y = _mm_add_epi16(y, _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(25)), round));
+	y = _mm_add_epi16(_mm_srli_epi16(y, 8), _mm_set1_epi16(16)); // the sum is unsigned
+
+	u = _mm_sub_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(112)), _mm_mullo_epi16(r, _mm_set1_epi16(38)));
+	u = _mm_add_epi16(_mm_sub_epi16(u, _mm_mullo_epi16(g, _mm_set1_epi16(74))), round);
+	u = _mm_add_epi16(_mm_srai_epi16(u, 8), round);
+
+	v = _mm_sub_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(112)), _mm_mullo_epi16(g, _mm_set1_epi16(94)));
+	v = _mm_add_epi16(_mm_sub_epi16(v, _mm_mullo_epi16(b, _mm_set1_epi16(18))), round);
+	v = _mm_add_epi16(_mm_srai_epi16(v, 8), round);
+}
+
+// Averages the 2x2 blocks of two rows of 8 chroma samples into 4 bytes
+static inline quint32 average2x2(__m128i c0, __m128i c1)
+{
+	__m128i sum = _mm_madd_epi16(_mm_add_epi16(c0, c1), _mm_set1_epi16(1));
+	sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+	sum = _mm_packs_epi32(sum, sum);
+	return (quint32)_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));
+}
+#endif
+
+namespace KviYuvConversion
+{
+	void rgb32ToYuv444RowScalar(const QRgb * rgb, quint8 * y, quint8 * u, quint8 * v, int w)
+	{
+		for(int j = 0; j < w; j++)
+		{
+			y[j] = (quint8)yuvY(rgb[j]);
+			u[j] = (quint8)yuvU(rgb[j]);
+			v[j] = (quint8)yuvV(rgb[j]);
+		}
+	}
+
+	void rgb32ToYuv420RowsScalar(const QRgb * rgb0, const QRgb * rgb1, quint8 * y0, quint8 * y1, quint8 * u, quint8 * v, int w)
+	{
+		for(int j = 0; j < w; j += 2)
+		{
+			int k = (j + 1 < w) ? j + 1 : j;
+			y0[j] = (quint8)yuvY(rgb0[j]);
+			y0[k] = (quint8)yuvY(rgb0[k]);
+			if(y1)
+			{
+				y1[j] = (quint8)yuvY(rgb1[j]);
+				y1[k] = (quint8)yuvY(rgb1[k]);
+			}
+			u[j >> 1] = (quint8)((yuvU(rgb0[j]) + yuvU(rgb0[k]) + yuvU(rgb1[j]) + yuvU(rgb1[k]) + 2) >> 2);
+			v[j >> 1] = (quint8)((yuvV(rgb0[j]) + yuvV(rgb0[k]) + yuvV(rgb1[j]) + yuvV(rgb1[k]) + 2) >> 2);
+		}
+	}
+
+	void rgb32ToYuv444Row(const QRgb * rgb, quint8 * y, quint8 * u, quint8 * v, int w)
+	{
+		int j = 0;
+#ifdef __SSE2__
+		for(; j + 8 <= w; j += 8)
+		{
+			__m128i y16, u16, v16;
+			rgb32toyuv8(rgb + j, y16, u16, v16);
+			_mm_storel_epi64((__m128i *)(y + j), _mm_packus_epi16(y16, y16));
+			_mm_storel_epi64((__m128i *)(u + j), _mm_packus_epi16(u16, u16));
+			_mm_storel_epi64((__m128i *)(v + j), _mm_packus_epi16(v16, v16));
+		}
+#endif
+		// the tail
+		rgb32ToYuv444RowScalar(rgb + j, y + j, u + j, v + j, w - j);
+	}
+
+	void rgb32ToYuv420Rows(const QRgb * rgb0, const QRgb * rgb1, quint8 * y0, quint8 * y1, quint8 * u, quint8 * v, int w)
+	{
+		int j = 0;
+#ifdef __SSE2__
+		for(; j + 8 <= w; j += 8)
+		{
+			__m128i ya, ua, va, yb, ub, vb;
+			rgb32toyuv8(rgb0 + j, ya, ua, va);
+			rgb32toyuv8(rgb1 + j, yb, ub, vb);
+			_mm_storel_epi64((__m128i *)(y0 + j), _mm_packus_epi16(ya, ya));
+			if(y1)
+				_mm_storel_epi64((__m128i *)(y1 + j), _mm_packus_epi16(yb, yb));
+			quint32 uAvg = average2x2(ua, ub);
+			quint32 vAvg = average2x2(va, vb);
+			memcpy(u + (j >> 1), &uAvg, 4);
+			memcpy(v + (j >> 1), &vAvg, 4);
+		}
+#endif
+		// the tail: j is even here
+		rgb32ToYuv420RowsScalar(rgb0 + j, rgb1 + j, y0 + j, y1 ? y1 + j : nullptr, u + (j >> 1), v + (j >> 1), w - j);
+	}
+}
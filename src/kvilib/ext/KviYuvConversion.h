@@ -0,0 +1,83 @@
+#ifndef _KVI_YUVCONVERSION_H_
+#define _KVI_YUVCONVERSION_H_
+//=============================================================================
+//
+//   File : KviYuvConversion.h
+//   Creation date : Sun 18 Oct 2026 17:48:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviYuvConversion.h
+* \author the KVIrc development team
+* \brief The argb32 to Y'CbCr conversion of the video encoder
+*
+* This code was originally part of KviOggTheoraEncoder.cpp
+*/
+
+#include "kvi_settings.h"
+
+#include <QRgb>
+
+/**
+* \namespace KviYuvConversion
+* \brief ITU-R BT.601 conversion of argb32 pixels, in 8 bit fixed point
+*
+* The functions use SSE2 when the compiler targets it. The Scalar variants
+* give exactly the same results without it: they are there for comparisons.
+*/
+namespace KviYuvConversion
+{
+	/**
+	* \brief Converts a row of pixels to 4:4:4 planes
+	* \param rgb The source row
+	* \param y The luma output, w bytes
+	* \param u The blue chroma output, w bytes
+	* \param v The red chroma output, w bytes
+	* \param w The width of the row
+	* \return void
+	*/
+	extern KVILIB_API void rgb32ToYuv444Row(const QRgb * rgb, quint8 * y, quint8 * u, quint8 * v, int w);
+
+	/**
+	* \brief Converts two rows of pixels to 4:2:0 planes, the chroma is averaged over 2x2 blocks
+	* \param rgb0 The first source row
+	* \param rgb1 The second source row: the same as rgb0 at the bottom of a picture with an odd height
+	* \param y0 The luma output of the first row, w bytes
+	* \param y1 The luma output of the second row, w bytes; null to skip it
+	* \param u The blue chroma output, (w + 1) / 2 bytes
+	* \param v The red chroma output, (w + 1) / 2 bytes
+	* \param w The width of the rows
+	* \return void
+	*/
+	extern KVILIB_API void rgb32ToYuv420Rows(const QRgb * rgb0, const QRgb * rgb1, quint8 * y0, quint8 * y1, quint8 * u, quint8 * v, int w);
+
+	/**
+	* \brief The same as rgb32ToYuv444Row(), without SIMD
+	*/
+	extern KVILIB_API void rgb32ToYuv444RowScalar(const QRgb * rgb, quint8 * y, quint8 * u, quint8 * v, int w);
+
+	/**
+	* \brief The same as rgb32ToYuv420Rows(), without SIMD
+	*/
+	extern KVILIB_API void rgb32ToYuv420RowsScalar(const QRgb * rgb0, const QRgb * rgb1, quint8 * y0, quint8 * y1, quint8 * u, quint8 * v, int w);
+}
+
+#endif // _KVI_YUVCONVERSION_H_
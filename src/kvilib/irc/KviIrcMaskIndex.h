@@ -0,0 +1,374 @@
+#ifndef _KVI_IRCMASKINDEX_H_
+#define _KVI_IRCMASKINDEX_H_
+//=============================================================================
+//
+//   File : KviIrcMaskIndex.h
+//   Creation date : Sun 18 Oct 2026 20:05:31 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviIrcMaskIndex.h
+* \author the KVIrc development team
+* \brief An index of wildcard masks keyed by their host part
+*
+* Most of the masks found in the wild have a host part that is either
+* a literal host (*!*@host.isp.com), a domain (*!*@*.isp.com) or an
+* address range (*!*@192.168.1.*). The index puts such masks in hash
+* buckets keyed by the literal host, by a dot aligned domain suffix and
+* by a dot (or colon) aligned address prefix. A lookup then tests only the
+* masks in the buckets reachable from the host being matched plus the
+* few masks with a host that can't be indexed (like *!*@*).
+*/
+
+#include "kvi_settings.h"
+#include "KviIrcMask.h"
+#include "KviPointerHashTable.h"
+#include "KviPointerList.h"
+
+#include <QString>
+
+#include <vector>
+
+/**
+* \class KviIrcMaskIndex
+* \brief Finds the masks that match a nick!user@host without testing all of them
+*
+* The index doesn't own the masks nor the data associated to them:
+* remove an entry before deleting its mask.
+* The masks with a higher priority are preferred by findFirst(), the ones
+* inserted first are preferred among the masks with the same priority.
+*/
+template <typename T>
+class KviIrcMaskIndex
+{
+protected:
+	class Entry
+	{
+	public:
+		KviIrcMask * pMask;
+		T * pData;
+		int iPriority;
+		unsigned int uSerial;
+
+		bool isBetterThan(const Entry * e) const
+		{
+			if(iPriority != e->iPriority)
+				return iPriority > e->iPriority;
+			return uSerial < e->uSerial;
+		}
+	};
+
+	typedef KviPointerList<Entry> EntryList;
+
+	enum Bucket
+	{
+		Host,
+		Suffix,
+		Prefix,
+		Other
+	};
+
+public:
+	KviIrcMaskIndex()
+	{
+		// the hosts are case insensitive
+		m_pHostDict = new KviPointerHashTable<QString, EntryList>(31, false);
+		m_pHostDict->setAutoDelete(true);
+		m_pSuffixDict = new KviPointerHashTable<QString, EntryList>(17, false);
+		m_pSuffixDict->setAutoDelete(true);
+		m_pPrefixDict = new KviPointerHashTable<QString, EntryList>(17, false);
+		m_pPrefixDict->setAutoDelete(true);
+		m_pOtherList = new EntryList;
+		m_pOtherList->setAutoDelete(true);
+		m_uNextSerial = 0;
+		m_uCount = 0;
+	}
+
+	~KviIrcMaskIndex()
+	{
+		delete m_pHostDict;
+		delete m_pSuffixDict;
+		delete m_pPrefixDict;
+		delete m_pOtherList;
+	}
+
+protected:
+	KviPointerHashTable<QString, EntryList> * m_pHostDict;   // literal hosts
+	KviPointerHashTable<QString, EntryList> * m_pSuffixDict; // *.domain.tld: keyed by domain.tld
+	KviPointerHashTable<QString, EntryList> * m_pPrefixDict; // 10.0.*: keyed by 10.0.
+	EntryList * m_pOtherList;                                // everything else
+	unsigned int m_uNextSerial;
+	unsigned int m_uCount;
+
+public:
+	unsigned int count() const { return m_uCount; };
+
+	void clear()
+	{
+		m_pHostDict->clear();
+		m_pSuffixDict->clear();
+		m_pPrefixDict->clear();
+		m_pOtherList->clear();
+		m_uCount = 0;
+	}
+
+	/**
+	* \brief Adds a mask to the index
+	* \param pMask The mask: it must not change while it is in the index
+	* \param pData The data returned by the lookups
+	* \param iPriority The masks with a higher priority are preferred by findFirst()
+	* \return void
+	*/
+	void insert(KviIrcMask * pMask, T * pData, int iPriority = 0)
+	{
+		Entry * e = new Entry;
+		e->pMask = pMask;
+		e->pData = pData;
+		e->iPriority = iPriority;
+		e->uSerial = m_uNextSerial++;
+
+		EntryList * l = bucket(pMask, true);
+		// keep the list sorted: the entries inserted later go after the ones with the same priority
+		int idx = 0;
+		for(Entry * x = l->first(); x; x = l->next())
+		{
+			if(x->iPriority < iPriority)
+			{
+				l->insert(idx, e);
+				m_uCount++;
+				return;
+			}
+			idx++;
+		}
+		l->append(e);
+		m_uCount++;
+	}
+
+	/**
+	* \brief Removes a mask from the index
+	* \param pMask The mask passed to insert(): it must be still alive
+	* \param pData The data passed to insert()
+	* \return true if the entry has been found
+	*/
+	bool remove(KviIrcMask * pMask, T * pData)
+	{
+		EntryList * l = bucket(pMask, false);
+		if(!l)
+			return false;
+		for(Entry * e = l->first(); e; e = l->next())
+		{
+			if((e->pMask == pMask) && (e->pData == pData))
+			{
+				l->removeRef(e); // this one deletes e
+				m_uCount--;
+				if(l->isEmpty() && (l != m_pOtherList))
+				{
+					QString szKey;
+					switch(classify(pMask, szKey))
+					{
+						case Host:
+							m_pHostDict->remove(szKey);
+							break;
+						case Suffix:
+							m_pSuffixDict->remove(szKey);
+							break;
+						case Prefix:
+							m_pPrefixDict->remove(szKey);
+							break;
+						default:
+							break;
+					}
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	* \brief Finds the preferred mask that matches nick!user@host
+	* \return The data of the mask, nullptr if none matches
+	*/
+	T * findFirst(const QString & szNick, const QString & szUser, const QString & szHost)
+	{
+		Entry * pBest = nullptr;
+		std::vector<EntryList *> lCandidates;
+		candidates(szHost, lCandidates);
+		for(auto l : lCandidates)
+		{
+			// the lists are sorted: the first match is the best one of a list
+			for(Entry * e = l->first(); e; e = l->next())
+			{
+				if(pBest && !e->isBetterThan(pBest))
+					break;
+				if(e->pMask->matchesFixed(szNick, szUser, szHost))
+				{
+					pBest = e;
+					break;
+				}
+			}
+		}
+		return pBest ? pBest->pData : nullptr;
+	}
+
+	/**
+	* \brief Finds all the masks that match nick!user@host
+	* \param lMatches Receives the data of the matching masks, in no particular order
+	* \return void
+	*/
+	void findAll(const QString & szNick, const QString & szUser, const QString & szHost, std::vector<T *> & lMatches)
+	{
+		std::vector<EntryList *> lCandidates;
+		candidates(szHost, lCandidates);
+		for(auto l : lCandidates)
+		{
+			for(Entry * e = l->first(); e; e = l->next())
+			{
+				if(e->pMask->matchesFixed(szNick, szUser, szHost))
+					lMatches.push_back(e->pData);
+			}
+		}
+	}
+
+protected:
+	static bool isWild(const QChar * p, int iLen)
+	{
+		for(int i = 0; i < iLen; i++)
+		{
+			if((p[i].unicode() == '*') || (p[i].unicode() == '?'))
+				return true;
+		}
+		return false;
+	}
+
+	static bool isPrefixSeparator(QChar c)
+	{
+		return (c.unicode() == '.') || (c.unicode() == ':');
+	}
+
+	// Finds the bucket of a mask. The keys must be reachable by candidates() from every host matched by the mask.
+	static Bucket classify(KviIrcMask * pMask, QString & szKey)
+	{
+		const QString & szHost = pMask->host();
+		const QChar * p = szHost.unicode();
+		int iLen = szHost.length();
+		if(iLen < 1)
+			return Other;
+
+		if(!isWild(p, iLen))
+		{
+			szKey = szHost;
+			return Host;
+		}
+
+		if((p[0].unicode() == '*') && !isWild(p + 1, iLen - 1))
+		{
+			// *<literal>: the part after the first dot of the literal is a complete domain suffix of the host
+			int idx = szHost.indexOf(QChar('.'), 1);
+			if((idx < 0) || (idx == iLen - 1))
+				return Other;
+			szKey = szHost.mid(idx + 1);
+			return Suffix;
+		}
+
+		if((p[iLen - 1].unicode() == '*') && !isWild(p, iLen - 1))
+		{
+			// <literal>*: the literal up to its last separator is a complete address prefix of the host
+			int idx = iLen - 2;
+			while((idx >= 0) && !isPrefixSeparator(p[idx]))
+				idx--;
+			if(idx < 0)
+				return Other;
+			szKey = szHost.left(idx + 1);
+			return Prefix;
+		}
+
+		return Other;
+	}
+
+	EntryList * bucket(KviIrcMask * pMask, bool bCreate)
+	{
+		QString szKey;
+		KviPointerHashTable<QString, EntryList> * d;
+		switch(classify(pMask, szKey))
+		{
+			case Host:
+				d = m_pHostDict;
+				break;
+			case Suffix:
+				d = m_pSuffixDict;
+				break;
+			case Prefix:
+				d = m_pPrefixDict;
+				break;
+			default:
+				return m_pOtherList;
+				break;
+		}
+		EntryList * l = d->find(szKey);
+		if(!l && bCreate)
+		{
+			l = new EntryList;
+			l->setAutoDelete(true);
+			d->insert(szKey, l);
+		}
+		return l;
+	}
+
+	void candidates(const QString & szHost, std::vector<EntryList *> & lCandidates)
+	{
+		EntryList * l;
+		if(m_pHostDict->count() > 0)
+		{
+			l = m_pHostDict->find(szHost);
+			if(l)
+				lCandidates.push_back(l);
+		}
+
+		bool bSuffixes = m_pSuffixDict->count() > 0;
+		bool bPrefixes = m_pPrefixDict->count() > 0;
+		if(bSuffixes || bPrefixes)
+		{
+			const QChar * p = szHost.unicode();
+			int iLen = szHost.length();
+			for(int i = 0; i < iLen; i++)
+			{
+				if(bSuffixes && (p[i].unicode() == '.'))
+				{
+					l = m_pSuffixDict->find(szHost.mid(i + 1));
+					if(l)
+						lCandidates.push_back(l);
+				}
+				if(bPrefixes && isPrefixSeparator(p[i]))
+				{
+					l = m_pPrefixDict->find(szHost.left(i + 1));
+					if(l)
+						lCandidates.push_back(l);
+				}
+			}
+		}
+
+		if(!m_pOtherList->isEmpty())
+			lCandidates.push_back(m_pOtherList);
+	}
+};
+
+#endif //_KVI_IRCMASKINDEX_H_
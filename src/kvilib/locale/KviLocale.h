@@ -217,12 +217,38 @@ public:
 extern KVILIB_API KviMessageCatalogue * g_pMainCatalogue;
 #endif // !_KVI_LOCALE_CPP_
 
+/**
+* \class KviStaticTranslation
+* \brief The translation remembered by a __tr2qs_static() call site
+*
+* The translation is looked up in the catalogue on the first use and
+* again only after the catalogue generation has changed.
+*/
+class KviStaticTranslation
+{
+public:
+	const QString * m_pTranslation = nullptr;
+	unsigned int m_uGeneration = 0;
+
+	const QString & translate(KviMessageCatalogue * pCatalogue, const char * pcText)
+	{
+		if(m_uGeneration != KviMessageCatalogue::generation())
+		{
+			m_pTranslation = &(pCatalogue->translateToQString(pcText));
+			m_uGeneration = KviMessageCatalogue::generation();
+		}
+		return *m_pTranslation;
+	}
+};
+
 #define __tr(text) g_pMainCatalogue->translate(text)
 #define __tr_no_lookup(text) text
 #define __tr_no_xgettext(text) g_pMainCatalogue->translate(text)
 #define __tr2qs(text) g_pMainCatalogue->translateToQString(text)
 #define __tr2qs_no_lookup(text) text
 #define __tr2qs_no_xgettext(text) g_pMainCatalogue->translateToQString(text)
+// like __tr2qs() but the translation is kept by the call site: text must be a string literal
+#define __tr2qs_static(text) ([]() -> const QString & { static KviStaticTranslation s; return s.translate(g_pMainCatalogue, text); }())
 
 #define __tr_ctx(text, context) KviLocale::instance()->translate(text, context)
 #define __tr_no_lookup_ctx(text, context) text
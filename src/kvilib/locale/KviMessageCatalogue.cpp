@@ -127,6 +127,9 @@ int kvi_getFirstBiggerPrime(int iNumber)
 	return 9973; //error!
 }
 
+// starts at 1: KviStaticTranslation uses 0 for "not translated yet"
+unsigned int KviMessageCatalogue::m_uGeneration = 1;
+
 KviMessageCatalogue::KviMessageCatalogue()
 {
 	//m_uEncoding = 0;
@@ -141,6 +144,7 @@ KviMessageCatalogue::~KviMessageCatalogue()
 {
 	if(m_pMessages)
 		delete m_pMessages;
+	m_uGeneration++;
 }
 
 bool KviMessageCatalogue::load(const QString & szName)
@@ -246,6 +250,7 @@ bool KviMessageCatalogue::load(const QString & szName)
 	int iDictSize = kvi_getFirstBiggerPrime(iStringsNum);
 	if(m_pMessages)
 		delete m_pMessages;
+	m_uGeneration++;
 	m_pMessages = new KviPointerHashTable<const char *, KviTranslationEntry>(iDictSize, true, false); // dictSize, case sensitive, don't copy keys
 	m_pMessages->setAutoDelete(true);
 
@@ -60,8 +60,19 @@ public:
 protected:
 	KviPointerHashTable<const char *, KviTranslationEntry> * m_pMessages;
 	QTextCodec * m_pTextCodec;
+	static unsigned int m_uGeneration;
 
 public:
+	/**
+	* \brief Returns the generation of the message catalogues
+	*
+	* The generation changes every time a catalogue drops its translations,
+	* when it loads a new file or when it is destroyed. The references
+	* returned by translateToQString() before the change are no longer valid.
+	* \return unsigned int
+	*/
+	static unsigned int generation() { return m_uGeneration; };
+
 	/**
 	* \brief
 	* \param szName
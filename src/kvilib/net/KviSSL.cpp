@@ -554,6 +554,13 @@ int KviSSL::write(const char * buffer, int len)
 	return SSL_write(m_pSSL, buffer, len);
 }
 
+int KviSSL::pending()
+{
+	if(!m_pSSL)
+		return 0;
+	return SSL_pending(m_pSSL);
+}
+
 KviSSL::Result KviSSL::getProtocolError(int ret)
 {
 	if(!m_pSSL)
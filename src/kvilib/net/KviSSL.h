@@ -196,6 +196,8 @@ public:
 	KviSSL::Result accept();
 	int read(char * buffer, int len);
 	int write(const char * buffer, int len);
+	// number of bytes already decrypted and buffered: poll() and select() don't see them
+	int pending();
 	// SSL ERRORS
 	unsigned long getLastError(bool bPeek = false);
 	bool getLastErrorString(KviCString & buffer, bool bPeek = false);
@@ -620,6 +620,7 @@ void KviSensitiveThread::enqueueEvent(KviThreadEvent * e)
 	}
 	m_pLocalEventQueue->append(e);
 	m_pLocalEventQueueMutex->unlock();
+	eventEnqueued();
 	//qDebug("<<< KviSensitiveThread::enqueueEvent() (this=%d)",this);
 }
 
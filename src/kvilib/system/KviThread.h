@@ -354,6 +354,10 @@ protected:
 	// returns the first event in the local queue
 	// the event MUST BE DELETED after processing
 	KviThreadEvent * dequeueEvent();
+	// master side:
+	// called after an event has been enqueued, a slave that
+	// blocks in a system call may use it to wake itself up
+	virtual void eventEnqueued(){};
 };
 
 // =============================================================================================//
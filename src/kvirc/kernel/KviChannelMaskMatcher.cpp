@@ -0,0 +1,98 @@
+//=============================================================================
+//
+//   File : KviChannelMaskMatcher.cpp
+//   Creation date : Sun 18 Oct 2026 21:17:48 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviChannelMaskMatcher.h"
+#include "KviIrcMask.h"
+#include "KviMaskEditor.h"
+
+#include <algorithm>
+
+KviChannelMaskMatcher::KviChannelMaskMatcher()
+    = default;
+
+KviChannelMaskMatcher::~KviChannelMaskMatcher()
+{
+	clear();
+}
+
+bool KviChannelMaskMatcher::isExtban(const QString & szMask)
+{
+	if(szMask.isEmpty())
+		return true;
+	// $a:account, $~a (charybdis and friends), ~q:mask (unreal)
+	ushort c = szMask[0].unicode();
+	if((c == '$') || (c == '~'))
+		return true;
+	// m:nick!user@host, R:account (inspircd): a single letter before the colon
+	if((szMask.length() > 1) && (szMask[1].unicode() == ':') && szMask[0].isLetter())
+		return true;
+	// anything else that isn't a hostmask (the servers always send complete hostmasks)
+	return !(szMask.contains(QChar('!')) && szMask.contains(QChar('@')));
+}
+
+void KviChannelMaskMatcher::add(KviMaskEntry * pEntry)
+{
+	if(isExtban(pEntry->szMask))
+	{
+		m_Extbans.push_back(pEntry);
+		return;
+	}
+	KviIrcMask * pMask = new KviIrcMask(pEntry->szMask);
+	m_Masks[pEntry] = pMask;
+	m_Index.insert(pMask, pEntry);
+}
+
+void KviChannelMaskMatcher::remove(KviMaskEntry * pEntry)
+{
+	auto it = m_Masks.find(pEntry);
+	if(it != m_Masks.end())
+	{
+		m_Index.remove(it->second, pEntry);
+		delete it->second;
+		m_Masks.erase(it);
+		return;
+	}
+	auto ext = std::find(m_Extbans.begin(), m_Extbans.end(), pEntry);
+	if(ext != m_Extbans.end())
+		m_Extbans.erase(ext);
+}
+
+void KviChannelMaskMatcher::clear()
+{
+	m_Index.clear();
+	for(auto & it : m_Masks)
+		delete it.second;
+	m_Masks.clear();
+	m_Extbans.clear();
+}
+
+KviMaskEntry * KviChannelMaskMatcher::findFirst(const QString & szNick, const QString & szUser, const QString & szHost)
+{
+	return m_Index.findFirst(szNick, szUser, szHost);
+}
+
+void KviChannelMaskMatcher::findAll(const QString & szNick, const QString & szUser, const QString & szHost, std::vector<KviMaskEntry *> & lMatches)
+{
+	m_Index.findAll(szNick, szUser, szHost, lMatches);
+}
@@ -0,0 +1,114 @@
+#ifndef _KVI_CHANNELMASKMATCHER_H_
+#define _KVI_CHANNELMASKMATCHER_H_
+//=============================================================================
+//
+//   File : KviChannelMaskMatcher.h
+//   Creation date : Sun 18 Oct 2026 21:17:48 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviChannelMaskMatcher.h
+* \author the KVIrc development team
+* \brief The compiled form of a channel ban, ban exception or invite list
+*/
+
+#include "kvi_settings.h"
+#include "KviIrcMaskIndex.h"
+
+#include <QString>
+
+#include <map>
+#include <vector>
+
+class KviIrcMask;
+
+typedef struct _KviMaskEntry KviMaskEntry; // KviMaskEditor.h
+
+/**
+* \class KviChannelMaskMatcher
+* \brief Finds the entries of a channel mask list that match a user
+*
+* The channel keeps one of these for each one of its +b, +e and +I lists
+* and updates it as the modes change. The hostmasks are indexed by their
+* host part so a lookup tests only a few of them even on huge lists.
+* The extended bans ($a:account, ~q:mask, m:mask...) can't be matched
+* against nick!user@host and are kept apart.
+*/
+class KVIRC_API KviChannelMaskMatcher
+{
+public:
+	KviChannelMaskMatcher();
+	~KviChannelMaskMatcher();
+
+protected:
+	KviIrcMaskIndex<KviMaskEntry> m_Index;
+	std::map<KviMaskEntry *, KviIrcMask *> m_Masks; // owns the masks
+	std::vector<KviMaskEntry *> m_Extbans;
+
+public:
+	/**
+	* \brief Returns true if the string is an extended ban and not a hostmask
+	* \param szMask The mask
+	* \return bool
+	*/
+	static bool isExtban(const QString & szMask);
+
+	/**
+	* \brief Adds an entry: its mask must not change until it is removed
+	* \param pEntry The entry
+	* \return void
+	*/
+	void add(KviMaskEntry * pEntry);
+
+	/**
+	* \brief Removes an entry
+	* \param pEntry The entry
+	* \return void
+	*/
+	void remove(KviMaskEntry * pEntry);
+
+	/**
+	* \brief Removes all the entries
+	* \return void
+	*/
+	void clear();
+
+	/**
+	* \brief Returns the oldest entry with a hostmask that matches nick!user@host
+	* \return KviMaskEntry *, nullptr if none matches
+	*/
+	KviMaskEntry * findFirst(const QString & szNick, const QString & szUser, const QString & szHost);
+
+	/**
+	* \brief Finds all the entries with a hostmask that matches nick!user@host
+	* \param lMatches Receives the entries
+	* \return void
+	*/
+	void findAll(const QString & szNick, const QString & szUser, const QString & szHost, std::vector<KviMaskEntry *> & lMatches);
+
+	/**
+	* \brief Returns the extended bans of the list
+	* \return const std::vector<KviMaskEntry *> &
+	*/
+	const std::vector<KviMaskEntry *> & extbans() const { return m_Extbans; };
+};
+
+#endif //_KVI_CHANNELMASKMATCHER_H_
@@ -31,6 +31,7 @@ KviIrcConnectionServerInfo::KviIrcConnectionServerInfo()
 {
 	// default assumptions
 	buildModePrefixTable();
+	buildChannelTypeMap();
 	m_pServInfo = new KviBasicIrcServerInfo(this);
 }
 
@@ -42,9 +43,22 @@ KviIrcConnectionServerInfo::~KviIrcConnectionServerInfo()
 		KviMemory::free(m_pModePrefixTable);
 }
 
-bool KviIrcConnectionServerInfo::isSupportedChannelType(QChar c) const
+void KviIrcConnectionServerInfo::setSupportedChannelTypes(const QString & szSupportedChannelTypes)
 {
-	return m_szSupportedChannelTypes.contains(c);
+	m_szSupportedChannelTypes = szSupportedChannelTypes;
+	buildChannelTypeMap();
+}
+
+void KviIrcConnectionServerInfo::buildChannelTypeMap()
+{
+	for(auto & u : m_uChannelTypeMap)
+		u = 0;
+	for(auto c : m_szSupportedChannelTypes)
+	{
+		ushort u = c.unicode();
+		if(u < 256)
+			m_uChannelTypeMap[u >> 5] |= (1U << (u & 31));
+	}
 }
 
 void KviIrcConnectionServerInfo::addSupportedCaps(const QString & szCapList)
@@ -308,6 +308,7 @@ private:
 	unsigned int m_uPrefixes;
 	QString m_szSupportedModeFlags = "ov";      // the actually used mode flags     ov
 	QString m_szSupportedChannelTypes = "#&!+"; // the supported channel types
+	kvi_u32_t m_uChannelTypeMap[8];             // the latin1 channel types above as a bitmap
 	bool m_bSupportsWatchList = false;          // supports the watch list ?
 	bool m_bSupportsCodePages = false;          // supports the /CODEPAGE command ?
 	int m_iMaxTopicLen = -1;
@@ -357,7 +358,13 @@ public:
 	// Returning a QChar means the mode has another mode dependency (the QChar we're returning)
 	QChar getUserModeRequirement(QChar mode) const { return m_pServInfo ? m_pServInfo->getUserModeRequirement(mode) : QChar::Null; }
 
-	bool isSupportedChannelType(QChar c) const;
+	bool isSupportedChannelType(QChar c) const
+	{
+		ushort u = c.unicode();
+		if(u < 256)
+			return m_uChannelTypeMap[u >> 5] & (1U << (u & 31));
+		return m_szSupportedChannelTypes.contains(c);
+	}
 	bool isSupportedModePrefix(QChar c) const;
 	bool isSupportedModeFlag(QChar c) const;
 	QChar modePrefixChar(kvi_u32_t flag) const;
@@ -371,7 +378,7 @@ protected:
 	void setSupportedUserModes(const QString & szSupportedUserModes) { m_szSupportedUserModes = szSupportedUserModes; }
 	void setSupportedChannelModes(const QString & szSupportedChannelModes);
 	void setSupportedModePrefixes(const QString & szSupportedModePrefixes, const QString & szSupportedModeFlags);
-	void setSupportedChannelTypes(const QString & szSupportedChannelTypes) { m_szSupportedChannelTypes = szSupportedChannelTypes; }
+	void setSupportedChannelTypes(const QString & szSupportedChannelTypes);
 	void setSupportsWatchList(bool bSupportsWatchList) { m_bSupportsWatchList = bSupportsWatchList; }
 	void setSupportsCodePages(bool bSupportsCodePages) { m_bSupportsCodePages = bSupportsCodePages; }
 	void addSupportedCaps(const QString & szCapList);
@@ -380,6 +387,7 @@ protected:
 	void setSupportsWhox(bool bSupportsWhox) { m_bSupportsWhox = bSupportsWhox; }
 private:
 	void buildModePrefixTable();
+	void buildChannelTypeMap();
 };
 
 #endif //!_KVI_IRCCONNECTIONSERVERINFO_H_
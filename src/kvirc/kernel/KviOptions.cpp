@@ -332,7 +332,10 @@ KviBoolOption g_boolOptionsTable[KVI_NUM_BOOL_OPTIONS] = {
 	BOOL_OPTION("ShowTreeWindowListHandle", true, KviOption_sectFlagWindowList | KviOption_resetUpdateGui | KviOption_groupTheme),
 	BOOL_OPTION("MenuBarVisible", true, KviOption_sectFlagFrame | KviOption_resetUpdateGui),
 	BOOL_OPTION("WarnAboutHidingMenuBar", true, KviOption_sectFlagFrame),
-	BOOL_OPTION("WhoRepliesToActiveWindow", false, KviOption_sectFlagConnection)
+	BOOL_OPTION("WhoRepliesToActiveWindow", false, KviOption_sectFlagConnection),
+	BOOL_OPTION("PreallocateDccRecvFiles", true, KviOption_sectFlagDcc),
+	BOOL_OPTION("VerifyDccRecvDigests", false, KviOption_sectFlagDcc),
+	BOOL_OPTION("AcceptDccParallelStreamRequests", true, KviOption_sectFlagDcc)
 };
 
 // NOTICE: REUSE EQUIVALENT UNUSED KviOption_bool in KviOptions.h ENTRIES BEFORE ADDING NEW ENTRIES ABOVE
@@ -636,7 +639,9 @@ KviUIntOption g_uintOptionsTable[KVI_NUM_UINT_OPTIONS] = {
 	UINT_OPTION("ToolBarButtonStyle", 0, KviOption_groupTheme), // 0 = Qt::ToolButtonIconOnly
 	UINT_OPTION("MaximumBlowFishKeySize", 56, KviOption_sectFlagNone),
 	UINT_OPTION("CustomCursorWidth", 1, KviOption_resetUpdateGui),
-	UINT_OPTION("UserListMinimumWidth", 100, KviOption_sectFlagUserListView | KviOption_resetUpdateGui | KviOption_groupTheme)
+	UINT_OPTION("UserListMinimumWidth", 100, KviOption_sectFlagUserListView | KviOption_resetUpdateGui | KviOption_groupTheme),
+	UINT_OPTION("DccChatMaxBacklogLines", 2000, KviOption_sectFlagDcc),
+	UINT_OPTION("DccRecvParallelStreams", 1, KviOption_sectFlagDcc)
 };
 
 #define FONT_OPTION(_name, _face, _size, _flags) \
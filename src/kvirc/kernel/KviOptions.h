@@ -353,10 +353,13 @@ DECLARE_OPTION_STRUCT(KviStringListOption, QStringList)
 #define KviOption_boolMenuBarVisible 261
 #define KviOption_boolWarnAboutHidingMenuBar 262
 #define KviOption_boolWhoRepliesToActiveWindow 263                             /* irc::output */
+#define KviOption_boolPreallocateDccRecvFiles 264                              /* dcc::file transfers */
+#define KviOption_boolVerifyDccRecvDigests 265                                 /* dcc::file transfers */
+#define KviOption_boolAcceptDccParallelStreamRequests 266                      /* dcc::file transfers */
 
 // NOTICE: REUSE EQUIVALENT UNUSED BOOL_OPTION in KviOptions.cpp ENTRIES BEFORE ADDING NEW ENTRIES ABOVE
 
-#define KVI_NUM_BOOL_OPTIONS 264
+#define KVI_NUM_BOOL_OPTIONS 267
 
 #define KVI_STRING_OPTIONS_PREFIX "string"
 #define KVI_STRING_OPTIONS_PREFIX_LEN 6
@@ -595,8 +598,10 @@ DECLARE_OPTION_STRUCT(KviStringListOption, QStringList)
 #define KviOption_uintMaximumBlowFishKeySize 80
 #define KviOption_uintCustomCursorWidth 81                                    /* Interface */
 #define KviOption_uintUserListMinimumWidth 82
+#define KviOption_uintDccChatMaxBacklogLines 83                               /* dcc::chat */
+#define KviOption_uintDccRecvParallelStreams 84                               /* dcc::file transfers */
 
-#define KVI_NUM_UINT_OPTIONS 83
+#define KVI_NUM_UINT_OPTIONS 85
 
 namespace KviIdentdOutputMode
 {
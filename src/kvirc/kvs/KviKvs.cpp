@@ -31,6 +31,8 @@
 #include "KviKvsEventManager.h"
 #include "KviKvsScriptAddonManager.h"
 #include "KviKvsObjectController.h"
+#include "KviKvsParseCache.h"
+#include "KviKvsProfiler.h"
 
 namespace KviKvs
 {
@@ -45,6 +47,8 @@ namespace KviKvs
 		KviKvsScriptAddonManager::init();
 		KviKvsTimerManager::init();
 		KviKvsDnsManager::init();
+		KviKvsParseCache::init();
+		KviKvsProfiler::init();
 	}
 
 	void done()
@@ -56,6 +60,8 @@ namespace KviKvs
 		KviKvsScriptAddonManager::done();
 		KviKvsTimerManager::done();
 		KviKvsDnsManager::done();
+		KviKvsParseCache::done();
+		KviKvsProfiler::done();
 		KviKvsKernel::done();
 	}
 
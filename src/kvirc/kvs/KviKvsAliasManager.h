@@ -30,6 +30,7 @@
 #include "KviQString.h"
 
 #include "KviKvsScript.h"
+#include "KviKvsAtom.h"
 
 #include <vector>
 
@@ -57,6 +58,10 @@ public:
 	{
 		return m_pAliasDict->find(szName);
 	};
+	const KviKvsScript * lookup(const KviKvsAtom & atomName)
+	{
+		return atomName.find(m_pAliasDict);
+	};
 	void add(const QString & szName, KviKvsScript * pAlias);
 	bool remove(const QString & szName)
 	{
@@ -0,0 +1,116 @@
+//=============================================================================
+//
+//   File : KviKvsAtom.cpp
+//   Creation date : Sun 18 Oct 2026 17:40:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviKvsAtom.h"
+
+class KviKvsAtomData
+{
+public:
+	KviKvsAtomData(const QString & szName)
+	    : m_szName(szName), m_uRefs(1)
+	{
+		m_uHashCS = kvi_hash_hash(szName, true);
+		m_uHashCI = kvi_hash_hash(szName, false);
+	};
+
+public:
+	QString m_szName;
+	unsigned int m_uHashCS;
+	unsigned int m_uHashCI;
+	unsigned int m_uRefs;
+};
+
+// the spellings of the live atoms: it exists only while there are atoms around
+static KviPointerHashTable<QString, KviKvsAtomData> * g_pAtomTable = nullptr;
+
+KviKvsAtom::KviKvsAtom(const QString & szName)
+{
+	if(!g_pAtomTable)
+	{
+		g_pAtomTable = new KviPointerHashTable<QString, KviKvsAtomData>(257, true);
+		g_pAtomTable->setAutoDelete(false);
+	}
+
+	m_pData = g_pAtomTable->find(szName);
+	if(m_pData)
+	{
+		m_pData->m_uRefs++;
+		return;
+	}
+
+	m_pData = new KviKvsAtomData(szName);
+	g_pAtomTable->insert(szName, m_pData);
+}
+
+KviKvsAtom::KviKvsAtom(const KviKvsAtom & a)
+{
+	m_pData = a.m_pData;
+	if(m_pData)
+		m_pData->m_uRefs++;
+}
+
+KviKvsAtom::~KviKvsAtom()
+{
+	release();
+}
+
+KviKvsAtom & KviKvsAtom::operator=(const KviKvsAtom & a)
+{
+	if(a.m_pData)
+		a.m_pData->m_uRefs++;
+	release();
+	m_pData = a.m_pData;
+	return *this;
+}
+
+void KviKvsAtom::release()
+{
+	if(!m_pData)
+		return;
+
+	m_pData->m_uRefs--;
+	if(m_pData->m_uRefs == 0)
+	{
+		g_pAtomTable->remove(m_pData->m_szName);
+		delete m_pData;
+		if(g_pAtomTable->isEmpty())
+		{
+			delete g_pAtomTable;
+			g_pAtomTable = nullptr;
+		}
+	}
+	m_pData = nullptr;
+}
+
+const QString & KviKvsAtom::name() const
+{
+	return m_pData ? m_pData->m_szName : KviQString::Empty;
+}
+
+unsigned int KviKvsAtom::hash(bool bCaseSensitive) const
+{
+	if(!m_pData)
+		return 0;
+	return bCaseSensitive ? m_pData->m_uHashCS : m_pData->m_uHashCI;
+}
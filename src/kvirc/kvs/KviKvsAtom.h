@@ -0,0 +1,79 @@
+#ifndef _KVI_KVS_ATOM_H_
+#define _KVI_KVS_ATOM_H_
+//=============================================================================
+//
+//   File : KviKvsAtom.h
+//   Creation date : Sun 18 Oct 2026 17:40:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviKvsAtom.h
+* \author the KVIrc development team
+* \brief Interned KVS identifiers
+*
+* The identifiers that appear in the scripts (variable, alias, module
+* function and object method names) are looked up in the KviPointerHashTable
+* based dictionaries at every execution. An atom is created once by the
+* parser: it is unique for each identifier spelling and carries the
+* precomputed case sensitive and case insensitive hashes of the name,
+* so the lookups made through it never hash the string again.
+*/
+
+#include "kvi_settings.h"
+#include "KviQString.h"
+#include "KviPointerHashTable.h"
+
+class KviKvsAtomData;
+
+class KVIRC_API KviKvsAtom
+{
+public:
+	KviKvsAtom()
+	    : m_pData(nullptr){};
+	explicit KviKvsAtom(const QString & szName);
+	KviKvsAtom(const KviKvsAtom & a);
+	~KviKvsAtom();
+
+protected:
+	KviKvsAtomData * m_pData;
+
+public:
+	KviKvsAtom & operator=(const KviKvsAtom & a);
+	// atoms with the same spelling share the same data
+	bool operator==(const KviKvsAtom & a) const { return m_pData == a.m_pData; };
+	bool operator!=(const KviKvsAtom & a) const { return m_pData != a.m_pData; };
+
+	bool isNull() const { return !m_pData; };
+	const QString & name() const;
+	// this is the value of kvi_hash_hash(name(),bCaseSensitive)
+	unsigned int hash(bool bCaseSensitive) const;
+
+	template <typename T>
+	T * find(KviPointerHashTable<QString, T> * pDict) const
+	{
+		return pDict->find(name(), hash(pDict->isCaseSensitive()));
+	}
+
+protected:
+	void release();
+};
+
+#endif //!_KVI_KVS_ATOM_H_
@@ -515,13 +515,24 @@ namespace KviKvsCoreCallbackCommands
 		@short:
 			Adds a new event handler
 		@syntax:
-			event [-q] (<event_name>,<handler_name>)
+			event [-q] [-w=<window_mask>] [-n=<nick_mask>] [-m=<message_regexp>] [-k=<network_mask>] (<event_name>,<handler_name>)
 			{
 				<implementation>
 			}
 		@switches:
 			!sw: -q | --quiet
 			Do not print any warnings
+			!sw: -w=<window_mask> | --window=<window_mask>
+			Run the handler only if the target of the window the event is triggered in
+			(the channel or query name, or the window name for other windows)
+			matches the wildcard <window_mask>.
+			This switch can't be used with RAW events: they are always triggered in the console
+			!sw: -n=<nick_mask> | --nick=<nick_mask>
+			Run the handler only if the source nickname matches the wildcard <nick_mask>
+			!sw: -m=<message_regexp> | --message=<message_regexp>
+			Run the handler only if the message text matches the regular expression <message_regexp>
+			!sw: -k=<network_mask> | --network=<network_mask>
+			Run the handler only if the current network name matches the wildcard <network_mask>
 		@description:
 			Adds the handler <handler_name> with <implementation> to
 			the list of handlers for the event <event_name>.[br]
@@ -534,7 +545,22 @@ namespace KviKvsCoreCallbackCommands
 			provided handler name contains invalid characters, they are
 			silently removed. If the provided handler name does not contain
 			a single valid character, the handler will be named "unnamed".[br]
-			If the -q switch is specified then the command runs in quiet mode.
+			If the -q switch is specified then the command runs in quiet mode.[br]
+			The -w, -n, -m and -k switches attach native filters to the handler:
+			they are evaluated before the script is started, so events that
+			do not match all of them cost almost nothing. The filters are
+			case insensitive. Each builtin event declares which of its parameters
+			are the source nickname and the message text (usually the ones documented
+			as [i]Source nickname[/i] and [i]Message[/i]): for RAW events the nickname is extracted from $0 and the message is the last parameter.
+			Filters on events that do not provide such parameters never match.
+		@examples:
+			[example]
+			[comment]# Only react to messages in #kvirc on the freenode network[/comment]
+			event -w="#kvirc" -k=freenode (OnChannelMessage,kvirconly)
+			{
+				[cmd]echo[/cmd] $0 said $3
+			}
+			[/example]
 		@seealso:
 			[cmd]eventctl[/cmd] [fnc]$iseventenabled[/fnc]
 	*/
@@ -593,12 +619,41 @@ namespace KviKvsCoreCallbackCommands
 		}
 		else
 		{
+			QString szFilter;
+			KviKvsEventHandlerFilter * pFilter = new KviKvsEventHandlerFilter();
+			if(KVSCCC_pSwitches->getAsStringIfExisting('w', "window", szFilter))
+			{
+				if(bIsRaw)
+				{
+					delete pFilter;
+					KVSCCC_pContext->error(__tr2qs_ctx("The window filter can't be used with RAW events", "kvs"));
+					return false;
+				}
+				pFilter->setWindowMask(szFilter);
+			}
+			if(KVSCCC_pSwitches->getAsStringIfExisting('n', "nick", szFilter))
+				pFilter->setNickMask(szFilter);
+			if(KVSCCC_pSwitches->getAsStringIfExisting('m', "message", szFilter))
+				pFilter->setMessageRegExp(szFilter);
+			if(KVSCCC_pSwitches->getAsStringIfExisting('k', "network", szFilter))
+				pFilter->setNetworkMask(szFilter);
+
+			if(!pFilter->isValid())
+			{
+				QString szRegExp = pFilter->messageRegExp();
+				delete pFilter;
+				KVSCCC_pContext->error(__tr2qs_ctx("Invalid message filter regular expression '%Q'", "kvs"), &szRegExp);
+				return false;
+			}
+
+			KviKvsScriptEventHandler * pHandler;
 			if(bIsRaw)
 			{
 				// remove the old handler
 				KviKvsEventManager::instance()->removeScriptRawHandler(iNumber, szHandlerName);
 				QString szContext = QString("RawEvent%1::%2").arg(iNumber).arg(szHandlerName);
-				KviKvsScriptEventHandler * pHandler = new KviKvsScriptEventHandler(szHandlerName, szContext, KVSCCC_pCallback->code());
+				pHandler = new KviKvsScriptEventHandler(szHandlerName, szContext, KVSCCC_pCallback->code());
+				pHandler->setFilter(pFilter);
 				KviKvsEventManager::instance()->addRawHandler(iNumber, pHandler);
 			}
 			else
@@ -606,7 +661,8 @@ namespace KviKvsCoreCallbackCommands
 				// remove the old handler
 				KviKvsEventManager::instance()->removeScriptAppHandler(iNumber, szHandlerName);
 				QString szContext = QString("%1::%2").arg(szEventName, szHandlerName);
-				KviKvsScriptEventHandler * pHandler = new KviKvsScriptEventHandler(szHandlerName, szContext, KVSCCC_pCallback->code());
+				pHandler = new KviKvsScriptEventHandler(szHandlerName, szContext, KVSCCC_pCallback->code());
+				pHandler->setFilter(pFilter);
 				KviKvsEventManager::instance()->addAppHandler(iNumber, pHandler);
 			}
 		}
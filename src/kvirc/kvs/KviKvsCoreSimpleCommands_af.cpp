@@ -40,6 +40,7 @@
 #include "KviKvsEventManager.h"
 #include "KviKvsKernel.h"
 #include "KviKvsObjectController.h"
+#include "KviKvsParseCache.h"
 
 #include <map>
 
@@ -1421,10 +1422,10 @@ namespace KviKvsCoreSimpleCommands
 		KVSCSC_PARAMETER("commands", KVS_PT_STRING, KVS_PF_APPENDREMAINING, szCommands)
 		KVSCSC_PARAMETERS_END
 
-		KviKvsScript s("eval::inner", szCommands);
 		int iRunFlags = 0;
 		if(KVSCSC_pContext->reportingDisabled() || KVSCSC_pSwitches->find('q', "quiet"))
 			iRunFlags |= KviKvsScript::Quiet;
+		KviKvsScript s(KviKvsParseCache::script("eval::inner", szCommands, KviKvsScript::InstructionList, iRunFlags));
 		bool bRet = s.run(KVSCSC_pContext, iRunFlags) ? true : false;
 		if(!bRet)
 		{
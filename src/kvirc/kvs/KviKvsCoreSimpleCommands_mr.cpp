@@ -43,6 +43,7 @@
 
 #include "KviKvsVariantList.h"
 #include "KviKvsScript.h"
+#include "KviKvsParseCache.h"
 #include "KviKvsPopupManager.h"
 
 #include <QCursor>
@@ -757,7 +758,7 @@ namespace KviKvsCoreSimpleCommands
 			}
 		}
 
-		KviKvsScript s(szFileName, szBuffer);
+		KviKvsScript s(KviKvsParseCache::script(szFileName, szBuffer));
 
 		KviKvsVariant * pRetVal = KVSCSC_pSwitches->find('r', "propagate-return") ? KVSCSC_pContext->returnValue() : nullptr;
 		KviKvsVariant vFileName(szFileName);
@@ -78,6 +78,11 @@ KviKvsVariant * KviKvsHash::find(const QString & szKey) const
 	return m_pDict->find(szKey);
 }
 
+KviKvsVariant * KviKvsHash::find(const KviKvsAtom & atomKey) const
+{
+	return atomKey.find(m_pDict);
+}
+
 bool KviKvsHash::isEmpty() const
 {
 	return m_pDict->isEmpty();
@@ -148,3 +153,13 @@ KviKvsVariant * KviKvsHash::get(const QString & szKey)
 	m_pDict->replace(szKey, pVariant);
 	return pVariant;
 }
+
+KviKvsVariant * KviKvsHash::get(const KviKvsAtom & atomKey)
+{
+	KviKvsVariant * pVariant = atomKey.find(m_pDict);
+	if(pVariant)
+		return pVariant;
+	pVariant = new KviKvsVariant();
+	m_pDict->replace(atomKey.name(), pVariant);
+	return pVariant;
+}
@@ -35,6 +35,7 @@
 #include "KviQString.h"
 #include "KviKvsVariant.h"
 #include "KviHeapObject.h"
+#include "KviKvsAtom.h"
 
 typedef KVIRC_API_TYPEDEF KviPointerHashTableIterator<QString, KviKvsVariant> KviKvsHashIterator;
 
@@ -90,6 +91,15 @@ public:
 	*/
 	KviKvsVariant * find(const QString & szKey) const;
 
+	/**
+	* \brief Returns the element associated to the given key
+	*
+	* This is faster than find(const QString &) as the hash of the key is precomputed.
+	* \param atomKey The key of the element to retrieve
+	* \return KviKvsVariant *
+	*/
+	KviKvsVariant * find(const KviKvsAtom & atomKey) const;
+
 	/**
 	* \brief Returns the element associated to the given key
 	*
@@ -100,6 +110,16 @@ public:
 	*/
 	KviKvsVariant * get(const QString & szKey);
 
+	/**
+	* \brief Returns the element associated to the given key
+	*
+	* If the element doesn't exists, it returns an empty element.
+	* This is faster than get(const QString &) as the hash of the key is precomputed.
+	* \param atomKey The key of the element to retrieve
+	* \return KviKvsVariant *
+	*/
+	KviKvsVariant * get(const KviKvsAtom & atomKey);
+
 	/**
 	* \brief Returns true if the hash is empty
 	* \return bool
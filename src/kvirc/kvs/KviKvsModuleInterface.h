@@ -33,6 +33,7 @@
 #include "KviKvsSwitchList.h"
 #include "KviKvsScript.h"
 #include "KviQString.h"
+#include "KviKvsAtom.h"
 
 #include <vector>
 
@@ -195,6 +196,19 @@ public:
 	{
 		return m_pModuleFunctionExecRoutineDict->find(szFunction);
 	};
+	// these are used by the parse trees
+	KviKvsModuleSimpleCommandExecRoutine * kvsFindSimpleCommand(const KviKvsAtom & atomCommand)
+	{
+		return atomCommand.find(m_pModuleSimpleCommandExecRoutineDict);
+	};
+	KviKvsModuleCallbackCommandExecRoutine * kvsFindCallbackCommand(const KviKvsAtom & atomCommand)
+	{
+		return atomCommand.find(m_pModuleCallbackCommandExecRoutineDict);
+	};
+	KviKvsModuleFunctionExecRoutine * kvsFindFunction(const KviKvsAtom & atomFunction)
+	{
+		return atomFunction.find(m_pModuleFunctionExecRoutineDict);
+	};
 
 	void completeCommand(const QString & cmd, std::vector<QString> & matches);
 	void completeFunction(const QString & cmd, std::vector<QString> & matches);
@@ -0,0 +1,434 @@
+//=============================================================================
+//
+//   File : KviKvsParseCache.cpp
+//   Creation date : Sun 18 Oct 2026 10:12:40 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviKvsParseCache.h"
+#include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeReader.h"
+#include "KviKvsTreeNodeWriter.h"
+#include "KviApplication.h"
+#include "KviBuildInfo.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#define KVI_KVS_PARSE_CACHE_FILE_MAGIC 0x4B565343 // "KVSC"
+#define KVI_KVS_PARSE_CACHE_KEY_LENGTH 20         // a SHA-1
+
+//
+// The layout of the tree file:
+//
+//   header : KviKvsParseCacheFileHeader
+//   index  : uCount KviKvsParseCacheFileEntry structures
+//   data   : the trees serialized by KviKvsTreeNodeWriter
+//
+// Everything is in the native byte order: a file coming from another
+// machine doesn't match the magic number (or the build id) and it's ignored.
+//
+
+struct KviKvsParseCacheFileHeader
+{
+	quint32 uMagic;
+	quint32 uVersion; // KVI_KVS_TREENODE_SERIALIZATION_VERSION
+	quint32 uCount;
+	quint32 uReserved;
+	char buildId[KVI_KVS_PARSE_CACHE_KEY_LENGTH];
+};
+
+struct KviKvsParseCacheFileEntry
+{
+	char key[KVI_KVS_PARSE_CACHE_KEY_LENGTH];
+	quint32 uAge;
+	qint64 iOffset; // from the beginning of the file
+	qint64 iLength;
+};
+
+KviKvsParseCache * KviKvsParseCache::m_pInstance = nullptr;
+
+KviKvsParseCache::KviKvsParseCache()
+{
+	m_pInstance = this;
+	m_pScriptDict = new KviPointerHashTable<QString, KviKvsScript>(131, true);
+	m_pScriptDict->setAutoDelete(true);
+	m_uSize = 0;
+	m_uHits = 0;
+	m_uMisses = 0;
+
+	// the trees are meaningful only for the build that wrote them
+	QString szBuild = QString("%1 %2 %3").arg(QString(KVI_VERSION), KviBuildInfo::buildDate(), KviBuildInfo::buildRevision());
+	m_buildId = QCryptographicHash::hash(szBuild.toUtf8(), QCryptographicHash::Sha1);
+
+	m_pFile = nullptr;
+	m_pMappedData = nullptr;
+	m_iNewTreesSize = 0;
+	m_uTreeHits = 0;
+	m_uTreeMisses = 0;
+
+	loadTreeFile();
+}
+
+KviKvsParseCache::~KviKvsParseCache()
+{
+	delete m_pScriptDict;
+	unmapTreeFile();
+	m_pInstance = nullptr;
+}
+
+void KviKvsParseCache::init()
+{
+	if(KviKvsParseCache::instance())
+	{
+		qDebug("WARNING: trying to create the KviKvsParseCache twice!");
+		return;
+	}
+	(void)new KviKvsParseCache();
+}
+
+void KviKvsParseCache::done()
+{
+	if(!KviKvsParseCache::instance())
+	{
+		qDebug("WARNING: trying to destroy the KviKvsParseCache twice!");
+		return;
+	}
+	KviKvsParseCache::instance()->saveTreeFile();
+	delete KviKvsParseCache::instance();
+}
+
+KviKvsScript KviKvsParseCache::script(const QString & szName, const QString & szBuffer, KviKvsScript::ScriptType eType, int iRunFlags)
+{
+	if(!m_pInstance)
+		return KviKvsScript(szName, szBuffer, eType);
+	return m_pInstance->lookup(szName, szBuffer, eType, iRunFlags);
+}
+
+KviKvsScript KviKvsParseCache::lookup(const QString & szName, const QString & szBuffer, KviKvsScript::ScriptType eType, int iRunFlags)
+{
+	if(szBuffer.length() > KVI_KVS_PARSE_CACHE_MAX_SCRIPT_LENGTH)
+	{
+		m_uMisses++;
+		return KviKvsScript(szName, szBuffer, eType);
+	}
+
+	// the parse flags change the tree and Quiet suppresses the parse errors:
+	// the same code run with different flags gets its own entry.
+	// The context name is part of the script data (it's used in the error reports)
+	int iFlags = iRunFlags & (KviKvsScript::AssumeLocals | KviKvsScript::Pedantic | KviKvsScript::Quiet);
+	QString szKey = QString("%1:%2:%3").arg((int)eType).arg(iFlags).arg(szName);
+	szKey.append(QChar('\n'));
+	szKey.append(szBuffer);
+
+	KviKvsScript * pScript = m_pScriptDict->find(szKey);
+	if(pScript)
+	{
+		m_uHits++;
+		return KviKvsScript(*pScript);
+	}
+
+	m_uMisses++;
+
+	// the budget counts the keys: each of them embeds the whole source
+	while(!m_lKeys.isEmpty() && ((m_uSize + szKey.length()) > KVI_KVS_PARSE_CACHE_MAX_SIZE))
+	{
+		// the running copies keep their own reference, so this is safe
+		m_uSize -= m_lKeys.first().length();
+		m_pScriptDict->remove(m_lKeys.first());
+		m_lKeys.removeFirst();
+	}
+
+	pScript = new KviKvsScript(szName, szBuffer, eType);
+	m_pScriptDict->insert(szKey, pScript);
+	m_lKeys.append(szKey);
+	m_uSize += szKey.length();
+	return KviKvsScript(*pScript);
+}
+
+void KviKvsParseCache::clear()
+{
+	m_pScriptDict->clear();
+	m_lKeys.clear();
+	m_uSize = 0;
+
+	// the mapped file stays there until exit, but it's not going to be used nor saved
+	m_hTrees.clear();
+	m_hNewTrees.clear();
+	m_iNewTreesSize = 0;
+}
+
+void KviKvsParseCache::resetStats()
+{
+	m_uHits = 0;
+	m_uMisses = 0;
+	m_uTreeHits = 0;
+	m_uTreeMisses = 0;
+}
+
+unsigned int KviKvsParseCache::treeCount() const
+{
+	unsigned int uCount = m_hNewTrees.count();
+	for(QHash<QByteArray, KviKvsParseCacheTreeEntry>::const_iterator it = m_hTrees.constBegin(); it != m_hTrees.constEnd(); ++it)
+	{
+		// a tree reparsed after a corruption is in both
+		if(!m_hNewTrees.contains(it.key()))
+			uCount++;
+	}
+	return uCount;
+}
+
+QByteArray KviKvsParseCache::treeKey(const QString & szBuffer, int iType, int iParseFlags) const
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(m_buildId);
+	qint32 aHeader[3] = { KVI_KVS_TREENODE_SERIALIZATION_VERSION, iType, iParseFlags };
+	hash.addData((const char *)aHeader, sizeof(aHeader));
+	hash.addData((const char *)szBuffer.constData(), szBuffer.length() * sizeof(QChar));
+	return hash.result();
+}
+
+KviKvsTreeNodeInstruction * KviKvsParseCache::loadTree(const QByteArray & key, const QChar * pBuffer, int iBufferLength)
+{
+	// the same script may be parsed again in this session (a detached copy, an edited and restored alias...)
+	QHash<QByteArray, QByteArray>::const_iterator n = m_hNewTrees.constFind(key);
+	if(n != m_hNewTrees.constEnd())
+	{
+		KviKvsTreeNodeReader r(pBuffer, iBufferLength, n.value().constData(), n.value().size());
+		KviKvsTreeNodeInstruction * pTree = r.readTree();
+		if(pTree)
+		{
+			m_uTreeHits++;
+			return pTree;
+		}
+		// can't happen, unless the writer and the reader disagree
+		m_iNewTreesSize -= n.value().size();
+		m_hNewTrees.remove(key);
+	}
+
+	QHash<QByteArray, KviKvsParseCacheTreeEntry>::iterator e = m_hTrees.find(key);
+	if(e != m_hTrees.end())
+	{
+		// straight from the mapped file: no copy
+		KviKvsTreeNodeReader r(pBuffer, iBufferLength, (const char *)(m_pMappedData + e.value().iOffset), (int)e.value().iLength);
+		KviKvsTreeNodeInstruction * pTree = r.readTree();
+		if(pTree)
+		{
+			e.value().bUsed = true;
+			m_uTreeHits++;
+			return pTree;
+		}
+		// a corrupted entry: the tree will be parsed and stored again
+		m_hTrees.erase(e);
+	}
+
+	m_uTreeMisses++;
+	return nullptr;
+}
+
+void KviKvsParseCache::storeTree(const QByteArray & key, KviKvsTreeNodeInstruction * pTree, const QChar * pBuffer, int iBufferLength)
+{
+	if(m_hTrees.contains(key) || m_hNewTrees.contains(key))
+		return;
+	if(m_iNewTreesSize >= KVI_KVS_PARSE_CACHE_MAX_FILE_SIZE)
+		return; // full: the scripts built on the fly should not push out everything else
+
+	KviKvsTreeNodeWriter w(pBuffer, iBufferLength);
+	if(!w.writeTree(pTree))
+		return;
+
+	m_hNewTrees.insert(key, w.data());
+	m_iNewTreesSize += w.data().size();
+}
+
+void KviKvsParseCache::loadTreeFile()
+{
+	if(!g_pApp)
+		return;
+
+	QString szFileName;
+	g_pApp->getLocalKvircDirectory(szFileName, KviApplication::Config, KVI_KVS_PARSE_CACHE_FILE_NAME);
+
+	m_pFile = new QFile(szFileName);
+	if(!m_pFile->open(QIODevice::ReadOnly))
+	{
+		// not there yet
+		unmapTreeFile();
+		return;
+	}
+
+	qint64 iSize = m_pFile->size();
+	if((iSize < (qint64)sizeof(KviKvsParseCacheFileHeader)) || (iSize > (KVI_KVS_PARSE_CACHE_MAX_FILE_SIZE * 2)))
+	{
+		unmapTreeFile();
+		return;
+	}
+
+	m_pMappedData = m_pFile->map(0, iSize);
+	if(!m_pMappedData)
+	{
+		unmapTreeFile();
+		return;
+	}
+
+	KviKvsParseCacheFileHeader hdr;
+	memcpy(&hdr, m_pMappedData, sizeof(hdr));
+
+	if((hdr.uMagic != KVI_KVS_PARSE_CACHE_FILE_MAGIC) || (hdr.uVersion != KVI_KVS_TREENODE_SERIALIZATION_VERSION) || (m_buildId != QByteArray::fromRawData(hdr.buildId, KVI_KVS_PARSE_CACHE_KEY_LENGTH)))
+	{
+		// another build (or garbage): it will be overwritten on exit
+		unmapTreeFile();
+		return;
+	}
+
+	qint64 iDataStart = sizeof(KviKvsParseCacheFileHeader) + ((qint64)hdr.uCount * sizeof(KviKvsParseCacheFileEntry));
+	if(iDataStart > iSize)
+	{
+		unmapTreeFile();
+		return;
+	}
+
+	const uchar * pEntry = m_pMappedData + sizeof(KviKvsParseCacheFileHeader);
+	for(quint32 u = 0; u < hdr.uCount; u++)
+	{
+		KviKvsParseCacheFileEntry ent;
+		memcpy(&ent, pEntry, sizeof(ent));
+		pEntry += sizeof(ent);
+
+		// the contents of each tree are checked by KviKvsTreeNodeReader, the bounds here
+		if((ent.iOffset < iDataStart) || (ent.iLength < 0) || (ent.iLength > (iSize - ent.iOffset)))
+			continue;
+
+		KviKvsParseCacheTreeEntry e;
+		e.iOffset = ent.iOffset;
+		e.iLength = ent.iLength;
+		e.uAge = ent.uAge;
+		e.bUsed = false;
+		m_hTrees.insert(QByteArray(ent.key, KVI_KVS_PARSE_CACHE_KEY_LENGTH), e);
+	}
+}
+
+void KviKvsParseCache::unmapTreeFile()
+{
+	if(!m_pFile)
+		return;
+	if(m_pMappedData)
+		m_pFile->unmap(m_pMappedData);
+	m_pMappedData = nullptr;
+	delete m_pFile; // closes it
+	m_pFile = nullptr;
+	m_hTrees.clear();
+}
+
+void KviKvsParseCache::saveTreeFile()
+{
+	if(!g_pApp)
+		return;
+
+	struct SavedTree
+	{
+		QByteArray key;
+		quint32 uAge;
+		const char * pData;
+		qint64 iLength;
+	};
+
+	std::vector<SavedTree> lTrees;
+
+	for(QHash<QByteArray, QByteArray>::const_iterator it = m_hNewTrees.constBegin(); it != m_hNewTrees.constEnd(); ++it)
+		lTrees.push_back({ it.key(), 0, it.value().constData(), it.value().size() });
+
+	for(QHash<QByteArray, KviKvsParseCacheTreeEntry>::const_iterator it = m_hTrees.constBegin(); it != m_hTrees.constEnd(); ++it)
+	{
+		if(m_hNewTrees.contains(it.key()))
+			continue;
+		quint32 uAge = it.value().bUsed ? 0 : it.value().uAge + 1;
+		if(uAge > KVI_KVS_PARSE_CACHE_MAX_TREE_AGE)
+			continue; // not used for a long time
+		lTrees.push_back({ it.key(), uAge, (const char *)(m_pMappedData + it.value().iOffset), it.value().iLength });
+	}
+
+	// keep the most recently used trees within the size limit
+	std::stable_sort(lTrees.begin(), lTrees.end(), [](const SavedTree & a, const SavedTree & b) { return a.uAge < b.uAge; });
+
+	qint64 iSize = sizeof(KviKvsParseCacheFileHeader);
+	size_t uCount = 0;
+	while(uCount < lTrees.size())
+	{
+		qint64 iTreeSize = sizeof(KviKvsParseCacheFileEntry) + lTrees[uCount].iLength;
+		if((iSize + iTreeSize) > KVI_KVS_PARSE_CACHE_MAX_FILE_SIZE)
+			break;
+		iSize += iTreeSize;
+		uCount++;
+	}
+
+	QString szFileName;
+	g_pApp->getLocalKvircDirectory(szFileName, KviApplication::Config, KVI_KVS_PARSE_CACHE_FILE_NAME);
+
+	if(uCount == 0)
+	{
+		unmapTreeFile();
+		QFile::remove(szFileName);
+		return;
+	}
+
+	// write to a temporary file: the old one is mapped and the data comes from there
+	QSaveFile f(szFileName);
+	if(!f.open(QIODevice::WriteOnly))
+	{
+		unmapTreeFile();
+		return;
+	}
+
+	KviKvsParseCacheFileHeader hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.uMagic = KVI_KVS_PARSE_CACHE_FILE_MAGIC;
+	hdr.uVersion = KVI_KVS_TREENODE_SERIALIZATION_VERSION;
+	hdr.uCount = (quint32)uCount;
+	memcpy(hdr.buildId, m_buildId.constData(), KVI_KVS_PARSE_CACHE_KEY_LENGTH);
+	f.write((const char *)&hdr, sizeof(hdr));
+
+	qint64 iOffset = sizeof(KviKvsParseCacheFileHeader) + ((qint64)uCount * sizeof(KviKvsParseCacheFileEntry));
+	for(size_t u = 0; u < uCount; u++)
+	{
+		KviKvsParseCacheFileEntry ent;
+		memset(&ent, 0, sizeof(ent));
+		memcpy(ent.key, lTrees[u].key.constData(), KVI_KVS_PARSE_CACHE_KEY_LENGTH);
+		ent.uAge = lTrees[u].uAge;
+		ent.iOffset = iOffset;
+		ent.iLength = lTrees[u].iLength;
+		f.write((const char *)&ent, sizeof(ent));
+		iOffset += lTrees[u].iLength;
+	}
+
+	for(size_t u = 0; u < uCount; u++)
+		f.write(lTrees[u].pData, lTrees[u].iLength);
+
+	// the data has been copied: the old file can go away now (it can't be replaced while mapped on some platforms)
+	unmapTreeFile();
+
+	if(!f.commit())
+		qDebug("WARNING: can't save the KVS parse cache to %s", szFileName.toUtf8().data());
+}
@@ -0,0 +1,174 @@
+#ifndef _KVI_KVS_PARSECACHE_H_
+#define _KVI_KVS_PARSECACHE_H_
+//=============================================================================
+//
+//   File : KviKvsParseCache.h
+//   Creation date : Sun 18 Oct 2026 10:12:40 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviKvsParseCache.h
+* \author the KVIrc development team
+* \brief Cache of the syntax trees of the transient scripts
+*
+* The scripts that are built on the fly (eval, parse, the static
+* KviKvsScript::run() and KviKvsScript::evaluate() helpers...) are
+* destroyed right after running and thus are reparsed at every call.
+* This cache keeps a shallow copy of each of them, keyed by the
+* script type, parse flags, context name and source: the copies returned
+* by script() share the syntax tree, so an unchanged script is parsed only once.
+*
+* The trees themselves are also kept across the sessions: any script parsed
+* without errors and warnings is serialized, keyed by a hash of this build
+* and of the source, and saved in the local KVIrc directory on exit. The file
+* is memory mapped at startup and an unchanged script is rebuilt from there
+* by KviKvsScript::parse() without running the parser at all.
+*/
+
+#include "kvi_settings.h"
+#include "KviQString.h"
+#include "KviPointerHashTable.h"
+#include "KviKvsScript.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+
+// maximum total size of the cached sources (in characters)
+#define KVI_KVS_PARSE_CACHE_MAX_SIZE 1048576
+// scripts longer than this (in characters) are never cached
+#define KVI_KVS_PARSE_CACHE_MAX_SCRIPT_LENGTH 65536
+
+// the file with the serialized trees, in the local KVIrc config directory
+#define KVI_KVS_PARSE_CACHE_FILE_NAME "kvsparsecache.kvc"
+// maximum size of the file (in bytes)
+#define KVI_KVS_PARSE_CACHE_MAX_FILE_SIZE 8388608
+// the trees not used in this many sessions are dropped from the file
+#define KVI_KVS_PARSE_CACHE_MAX_TREE_AGE 10
+
+class KviKvsTreeNodeInstruction;
+class QFile;
+
+// a tree in the mapped file
+struct KviKvsParseCacheTreeEntry
+{
+	qint64 iOffset;
+	qint64 iLength;
+	quint32 uAge; // number of sessions since the last use
+	bool bUsed;   // used in this session
+};
+
+class KVIRC_API KviKvsParseCache
+{
+protected: // it only can be created and destroyed by KviKvs::init()/done()
+	KviKvsParseCache();
+	~KviKvsParseCache();
+
+protected:
+	static KviKvsParseCache * m_pInstance;
+
+	KviPointerHashTable<QString, KviKvsScript> * m_pScriptDict;
+	QStringList m_lKeys; // insertion order, used to evict the oldest entries
+	unsigned int m_uSize; // total length of the cached keys
+	unsigned int m_uHits;
+	unsigned int m_uMisses;
+
+	QByteArray m_buildId; // hash of the version, build date and revision
+	QFile * m_pFile;      // the mapped tree file, may be 0
+	uchar * m_pMappedData;
+	QHash<QByteArray, KviKvsParseCacheTreeEntry> m_hTrees; // the trees in the mapped file
+	QHash<QByteArray, QByteArray> m_hNewTrees;              // the trees serialized in this session
+	qint64 m_iNewTreesSize;                                 // total size of m_hNewTrees
+	unsigned int m_uTreeHits;
+	unsigned int m_uTreeMisses;
+
+public:
+	static KviKvsParseCache * instance() { return m_pInstance; };
+	static void init(); // called by KviKvs::init()
+	static void done(); // called by KviKvs::done()
+
+	/**
+	* \brief Returns a script sharing the data (and the syntax tree) of the cached copy
+	*
+	* The script is created and cached if it's not there yet. The tree is
+	* built by the first run() of any of the copies. If the cache does not
+	* exist (before KviKvs::init() or after KviKvs::done()) a plain script is returned.
+	* \param szName The name of the context
+	* \param szBuffer The code
+	* \param eType The type of the code in the buffer
+	* \param iRunFlags The KviKvsScript::RunFlags the script will be run with
+	* \return KviKvsScript
+	*/
+	static KviKvsScript script(const QString & szName, const QString & szBuffer, KviKvsScript::ScriptType eType = KviKvsScript::InstructionList, int iRunFlags = 0);
+
+	unsigned int hits() const { return m_uHits; };
+	unsigned int misses() const { return m_uMisses; };
+	unsigned int count() const { return m_pScriptDict->count(); };
+	unsigned int size() const { return m_uSize; };
+
+	unsigned int treeHits() const { return m_uTreeHits; };
+	unsigned int treeMisses() const { return m_uTreeMisses; };
+	unsigned int treeCount() const;
+
+	void clear(); // drops also the serialized trees
+	void resetStats();
+
+	/**
+	* \brief Returns the key of a serialized tree
+	*
+	* This is a hash of the build id, of the script type, of the parse flags and of the source
+	* \param szBuffer The source code
+	* \param iType The KviKvsScript::ScriptType
+	* \param iParseFlags The KviKvsParser::Flags
+	* \return QByteArray
+	*/
+	QByteArray treeKey(const QString & szBuffer, int iType, int iParseFlags) const;
+
+	/**
+	* \brief Rebuilds a tree from its serialized form
+	* \param key The key returned by treeKey()
+	* \param pBuffer The source buffer the tree will point to: it must be the one that was hashed
+	* \param iBufferLength The length of the buffer (in characters)
+	* \return KviKvsTreeNodeInstruction * null if the tree is not in the cache
+	*/
+	KviKvsTreeNodeInstruction * loadTree(const QByteArray & key, const QChar * pBuffer, int iBufferLength);
+
+	/**
+	* \brief Serializes a freshly parsed tree
+	*
+	* The tree is not taken: it's written to a buffer that is saved on exit.
+	* Trees that can't be serialized are silently skipped
+	* \param key The key returned by treeKey()
+	* \param pTree The tree
+	* \param pBuffer The source buffer the tree was parsed from
+	* \param iBufferLength The length of the buffer (in characters)
+	* \return void
+	*/
+	void storeTree(const QByteArray & key, KviKvsTreeNodeInstruction * pTree, const QChar * pBuffer, int iBufferLength);
+
+protected:
+	KviKvsScript lookup(const QString & szName, const QString & szBuffer, KviKvsScript::ScriptType eType, int iRunFlags);
+	void loadTreeFile();
+	void saveTreeFile();
+	void unmapTreeFile();
+};
+
+#endif //!_KVI_KVS_PARSECACHE_H_
@@ -0,0 +1,247 @@
+//=============================================================================
+//
+//   File : KviKvsProfiler.cpp
+//   Creation date : Sun 18 Oct 2026 14:21:05 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviKvsProfiler.h"
+#include "KviKvsRunTimeContext.h"
+#include "KviKvsScript.h"
+#include "KviKvsReport.h"
+#include "KviKvsTreeNodeInstruction.h"
+
+#include <QFile>
+#include <QTextStream>
+
+KviKvsProfiler * KviKvsProfiler::m_pInstance = nullptr;
+bool KviKvsProfiler::m_bEnabled = false;
+bool KviKvsProfiler::m_bNodeTimingEnabled = false;
+
+KviKvsProfiler::KviKvsProfiler()
+{
+	m_pInstance = this;
+	m_pScriptEntries = new KviPointerHashTable<QString, KviKvsProfilerEntry>(131, true);
+	m_pScriptEntries->setAutoDelete(true);
+	m_pStackEntries = new KviPointerHashTable<QString, KviKvsProfilerEntry>(131, true);
+	m_pStackEntries->setAutoDelete(true);
+	m_pNodeEntries = new KviPointerHashTable<QString, KviKvsProfilerEntry>(131, true);
+	m_pNodeEntries->setAutoDelete(true);
+	m_iStartTime = 0;
+	m_iProfiledTime = 0;
+	m_timer.start();
+}
+
+KviKvsProfiler::~KviKvsProfiler()
+{
+	m_bEnabled = false;
+	m_bNodeTimingEnabled = false;
+	delete m_pScriptEntries;
+	delete m_pStackEntries;
+	delete m_pNodeEntries;
+	m_pInstance = nullptr;
+}
+
+void KviKvsProfiler::init()
+{
+	if(KviKvsProfiler::instance())
+	{
+		qDebug("WARNING: trying to create the KviKvsProfiler twice!");
+		return;
+	}
+	(void)new KviKvsProfiler();
+}
+
+void KviKvsProfiler::done()
+{
+	if(!KviKvsProfiler::instance())
+	{
+		qDebug("WARNING: trying to destroy the KviKvsProfiler twice!");
+		return;
+	}
+	delete KviKvsProfiler::instance();
+}
+
+void KviKvsProfiler::start(bool bNodeTiming)
+{
+	if(!m_bEnabled)
+	{
+		// the scripts that are running now have not been entered
+		m_frames.clear();
+		m_iStartTime = now();
+	}
+	m_bEnabled = true;
+	m_bNodeTimingEnabled = bNodeTiming;
+}
+
+void KviKvsProfiler::stop()
+{
+	if(m_bEnabled)
+		m_iProfiledTime += now() - m_iStartTime;
+	m_bEnabled = false;
+	m_bNodeTimingEnabled = false;
+	m_frames.clear();
+}
+
+void KviKvsProfiler::clear()
+{
+	m_pScriptEntries->clear();
+	m_pStackEntries->clear();
+	m_pNodeEntries->clear();
+	m_iProfiledTime = 0;
+	m_iStartTime = now();
+	// keep the current frames: they will be accounted when they return
+}
+
+qint64 KviKvsProfiler::profiledTime()
+{
+	return m_bEnabled ? m_iProfiledTime + (now() - m_iStartTime) : m_iProfiledTime;
+}
+
+KviKvsProfilerEntry * KviKvsProfiler::entry(KviPointerHashTable<QString, KviKvsProfilerEntry> * pDict, const QString & szKey, const QString & szName)
+{
+	KviKvsProfilerEntry * e = pDict->find(szKey);
+	if(!e)
+	{
+		e = new KviKvsProfilerEntry(szName);
+		pDict->insert(szKey, e);
+	}
+	return e;
+}
+
+void KviKvsProfiler::enterScript(const QString & szName)
+{
+	Frame f;
+	f.szName = szName;
+	// ';' is the frame separator of the collapsed stack format
+	f.szName.replace(QChar(';'), QChar(','));
+	if(m_frames.empty())
+		f.szStack = f.szName;
+	else
+		f.szStack = m_frames.back().szStack + QChar(';') + f.szName;
+	f.iChildTime = 0;
+	f.iStart = now();
+	m_frames.push_back(f);
+}
+
+void KviKvsProfiler::leaveScript()
+{
+	// the profiler might have been restarted while the script was running
+	if(m_frames.empty())
+		return;
+
+	qint64 iElapsed = now() - m_frames.back().iStart;
+	qint64 iSelf = iElapsed - m_frames.back().iChildTime;
+
+	KviKvsProfilerEntry * e = entry(m_pScriptEntries, m_frames.back().szName, m_frames.back().szName);
+	e->m_uCalls++;
+	e->m_iSelfTime += iSelf;
+	// recursive calls would be counted twice in the total time:
+	// account it only for the outermost one
+	bool bRecursive = false;
+	for(size_t u = 0; u < m_frames.size() - 1; u++)
+	{
+		if(m_frames[u].szName == m_frames.back().szName)
+		{
+			bRecursive = true;
+			break;
+		}
+	}
+	if(!bRecursive)
+		e->m_iTotalTime += iElapsed;
+	if(iElapsed > e->m_iMaxTime)
+		e->m_iMaxTime = iElapsed;
+
+	e = entry(m_pStackEntries, m_frames.back().szStack, m_frames.back().szStack);
+	e->m_uCalls++;
+	e->m_iSelfTime += iSelf;
+	e->m_iTotalTime += iElapsed;
+
+	m_frames.pop_back();
+	if(!m_frames.empty())
+		m_frames.back().iChildTime += iElapsed;
+}
+
+void KviKvsProfiler::enterInstruction()
+{
+	m_instructionChildTimes.push_back(0);
+}
+
+void KviKvsProfiler::leaveInstruction(KviKvsRunTimeContext * c, KviKvsTreeNodeInstruction * i, qint64 iElapsed)
+{
+	// every enterInstruction() is paired with a leaveInstruction() by the block that runs the instruction
+	qint64 iChildTime = m_instructionChildTimes.back();
+	m_instructionChildTimes.pop_back();
+	// control structures include the time of their nested instructions: that is not their self time
+	if(!m_instructionChildTimes.empty())
+		m_instructionChildTimes.back() += iElapsed;
+	recordInstruction(c, i, iElapsed, iElapsed - iChildTime);
+}
+
+void KviKvsProfiler::recordInstruction(KviKvsRunTimeContext * c, KviKvsTreeNodeInstruction * i, qint64 iElapsed, qint64 iSelf)
+{
+	KviKvsScript * s = c->script();
+	const QChar * pBuffer = s->buffer();
+	const QChar * pLocation = i->location();
+	int iOffset = (pLocation && (pLocation >= pBuffer) && (pLocation <= (pBuffer + s->code().length()))) ? (int)(pLocation - pBuffer) : -1;
+
+	QString szKey = QString("%1@%2").arg(s->name()).arg(iOffset);
+	KviKvsProfilerEntry * e = m_pNodeEntries->find(szKey);
+	if(!e)
+	{
+		// compute the (expensive) line number only once per instruction
+		QString szName = s->name();
+		if(iOffset >= 0)
+		{
+			int iLine, iCol;
+			KviKvsReport::findLineAndCol(pBuffer, pLocation, iLine, iCol);
+			szName += QString(":%1:%2").arg(iLine).arg(iCol);
+		}
+		e = new KviKvsProfilerEntry(szName);
+		m_pNodeEntries->insert(szKey, e);
+	}
+	e->m_uCalls++;
+	e->m_iTotalTime += iElapsed;
+	e->m_iSelfTime += iSelf;
+	if(iElapsed > e->m_iMaxTime)
+		e->m_iMaxTime = iElapsed;
+}
+
+bool KviKvsProfiler::exportCollapsedStacks(const QString & szFileName)
+{
+	QFile f(szFileName);
+	if(!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+
+	QTextStream ts(&f);
+	ts.setCodec("UTF-8");
+
+	KviPointerHashTableIterator<QString, KviKvsProfilerEntry> it(*m_pStackEntries);
+	while(KviKvsProfilerEntry * e = it.current())
+	{
+		qint64 iMicroSeconds = e->m_iSelfTime / 1000;
+		if(iMicroSeconds > 0)
+			ts << e->m_szName << " " << iMicroSeconds << "\n";
+		++it;
+	}
+
+	f.close();
+	return true;
+}
@@ -0,0 +1,131 @@
+#ifndef _KVI_KVS_PROFILER_H_
+#define _KVI_KVS_PROFILER_H_
+//=============================================================================
+//
+//   File : KviKvsProfiler.h
+//   Creation date : Sun 18 Oct 2026 14:21:05 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviKvsProfiler.h
+* \author the KVIrc development team
+* \brief Runtime profiler for the KVS interpreter
+*
+* When enabled, every script run (aliases, event handlers, timers,
+* object methods, popups...) is timed and accounted by its context name.
+* The nesting of the runs is tracked too, so the self time of each call
+* stack can be exported in the "collapsed stack" format understood by
+* the flamegraph tools. Optionally the single instructions can be timed.
+* When disabled the cost is a single static flag test per script run.
+*/
+
+#include "kvi_settings.h"
+#include "KviQString.h"
+#include "KviPointerHashTable.h"
+
+#include <QElapsedTimer>
+
+#include <vector>
+
+class KviKvsRunTimeContext;
+class KviKvsTreeNodeInstruction;
+
+class KVIRC_API KviKvsProfilerEntry
+{
+public:
+	KviKvsProfilerEntry(const QString & szName)
+	    : m_szName(szName), m_uCalls(0), m_iTotalTime(0), m_iSelfTime(0), m_iMaxTime(0){};
+
+public:
+	QString m_szName;
+	unsigned int m_uCalls;
+	qint64 m_iTotalTime; // nanoseconds, children included
+	qint64 m_iSelfTime;  // nanoseconds, children excluded
+	qint64 m_iMaxTime;   // the longest single call, in nanoseconds
+};
+
+class KVIRC_API KviKvsProfiler
+{
+protected: // it only can be created and destroyed by KviKvs::init()/done()
+	KviKvsProfiler();
+	~KviKvsProfiler();
+
+protected:
+	class Frame
+	{
+	public:
+		QString szName;
+		QString szStack; // the whole call stack, ';' separated
+		qint64 iStart;
+		qint64 iChildTime;
+	};
+
+	static KviKvsProfiler * m_pInstance;
+	static bool m_bEnabled;
+	static bool m_bNodeTimingEnabled;
+
+	QElapsedTimer m_timer;
+	qint64 m_iStartTime;
+	qint64 m_iProfiledTime;
+	std::vector<Frame> m_frames;
+	// the time spent in the nested instructions of each instruction that is running
+	std::vector<qint64> m_instructionChildTimes;
+	KviPointerHashTable<QString, KviKvsProfilerEntry> * m_pScriptEntries;
+	KviPointerHashTable<QString, KviKvsProfilerEntry> * m_pStackEntries;
+	KviPointerHashTable<QString, KviKvsProfilerEntry> * m_pNodeEntries;
+
+public:
+	static KviKvsProfiler * instance() { return m_pInstance; };
+	static void init(); // called by KviKvs::init()
+	static void done(); // called by KviKvs::done()
+
+	// these are the hot path checks
+	static bool isEnabled() { return m_bEnabled; };
+	static bool nodeTimingEnabled() { return m_bNodeTimingEnabled; };
+
+	void start(bool bNodeTiming = false);
+	void stop();
+	void clear();
+
+	// nanoseconds spent with the profiler enabled
+	qint64 profiledTime();
+
+	KviPointerHashTable<QString, KviKvsProfilerEntry> * scriptEntries() { return m_pScriptEntries; };
+	KviPointerHashTable<QString, KviKvsProfilerEntry> * nodeEntries() { return m_pNodeEntries; };
+
+	// called by KviKvsScript around the tree execution
+	void enterScript(const QString & szName);
+	void leaveScript();
+
+	// called by the instruction blocks around each instruction when the node timing is enabled
+	qint64 now() { return m_timer.nsecsElapsed(); };
+	void enterInstruction();
+	void leaveInstruction(KviKvsRunTimeContext * c, KviKvsTreeNodeInstruction * i, qint64 iElapsed);
+
+	// writes one "frame1;frame2;frame3 <self time in microseconds>" line per call stack
+	bool exportCollapsedStacks(const QString & szFileName);
+
+protected:
+	KviKvsProfilerEntry * entry(KviPointerHashTable<QString, KviKvsProfilerEntry> * pDict, const QString & szKey, const QString & szName);
+	void recordInstruction(KviKvsRunTimeContext * c, KviKvsTreeNodeInstruction * i, qint64 iElapsed, qint64 iSelf);
+};
+
+#endif //!_KVI_KVS_PROFILER_H_
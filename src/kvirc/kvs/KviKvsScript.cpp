@@ -30,6 +30,8 @@
 #include "KviKvsTreeNodeInstruction.h"
 #include "KviKvsVariantList.h"
 #include "KviKvsKernel.h"
+#include "KviKvsParseCache.h"
+#include "KviKvsProfiler.h"
 #include "KviLocale.h"
 #include "KviWindow.h"
 #include "KviApplication.h"
@@ -146,14 +148,14 @@ const QChar * KviKvsScript::buffer() const
 int KviKvsScript::run(const QString & szCode, KviWindow * pWindow, KviKvsVariantList * pParams, KviKvsVariant * pRetVal)
 {
 	// static helper
-	KviKvsScript s("kvirc::corecall(run)", szCode);
+	KviKvsScript s(KviKvsParseCache::script("kvirc::corecall(run)", szCode));
 	return s.run(pWindow, pParams, pRetVal, PreserveParams);
 }
 
 int KviKvsScript::evaluate(const QString & szCode, KviWindow * pWindow, KviKvsVariantList * pParams, KviKvsVariant * pRetVal)
 {
 	// static helper
-	KviKvsScript s("kvirc::corecall(evaluate)", szCode, Parameter);
+	KviKvsScript s(KviKvsParseCache::script("kvirc::corecall(evaluate)", szCode, Parameter));
 	return s.run(pWindow, pParams, pRetVal, PreserveParams);
 }
 
@@ -161,7 +163,7 @@ int KviKvsScript::evaluateAsString(const QString & szCode, KviWindow * pWindow,
 {
 	// static helper
 	KviKvsVariant ret;
-	KviKvsScript s("kvirc::corecall(evaluate)", szCode, Parameter);
+	KviKvsScript s(KviKvsParseCache::script("kvirc::corecall(evaluate)", szCode, Parameter));
 	int iRet = s.run(pWindow, pParams, &ret, PreserveParams);
 	ret.asString(szRetVal);
 	return iRet;
@@ -264,13 +266,24 @@ bool KviKvsScript::parse(KviWindow * pOutput, int iRunFlags)
 		}
 	} // else there is no tree at all, nobody can be locked inside
 
-	KviKvsParser p(this, (iRunFlags & Quiet) ? nullptr : pOutput);
-	// parse never blocks
-
 	int iFlags = iRunFlags & AssumeLocals ? KviKvsParser::AssumeLocals : 0;
 	if(iRunFlags & Pedantic)
 		iFlags |= KviKvsParser::Pedantic;
 
+	// an unchanged script may have been parsed in a previous session (or by a detached copy)
+	KviKvsParseCache * pCache = KviKvsParseCache::instance();
+	QByteArray key;
+	if(pCache)
+	{
+		key = pCache->treeKey(m_pData->m_szBuffer, (int)m_pData->m_eType, iFlags);
+		m_pData->m_pTree = pCache->loadTree(key, m_pData->m_pBuffer, m_pData->m_szBuffer.length());
+		if(m_pData->m_pTree)
+			return true;
+	}
+
+	KviKvsParser p(this, (iRunFlags & Quiet) ? nullptr : pOutput);
+	// parse never blocks
+
 	switch(m_pData->m_eType)
 	{
 		case Expression:
@@ -289,6 +302,10 @@ bool KviKvsScript::parse(KviWindow * pOutput, int iRunFlags)
 	//dump("");
 	//qDebug("END OF SCRIPT DUMP\n\n");
 
+	// the warnings would not be shown again if the tree came from the cache
+	if(pCache && m_pData->m_pTree && !p.error() && !p.hasWarnings())
+		pCache->storeTree(key, m_pData->m_pTree, m_pData->m_pBuffer, m_pData->m_szBuffer.length());
+
 	return !p.error();
 }
 
@@ -299,6 +316,11 @@ int KviKvsScript::executeInternal(KviKvsRunTimeContext * pContext)
 
 	int iRunStatus = Success;
 
+	// the profiler might be toggled by the script itself: remember if we entered it
+	bool bProfiled = KviKvsProfiler::isEnabled();
+	if(bProfiled)
+		KviKvsProfiler::instance()->enterScript(m_pData->m_szName);
+
 	if(!m_pData->m_pTree->execute(pContext))
 	{
 		if(pContext->error())
@@ -311,6 +333,9 @@ int KviKvsScript::executeInternal(KviKvsRunTimeContext * pContext)
 		}
 	}
 
+	if(bProfiled)
+		KviKvsProfiler::instance()->leaveScript();
+
 	// we can't block any longer: unlock
 	m_pData->m_uLock--;
 
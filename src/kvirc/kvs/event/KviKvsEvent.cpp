@@ -34,6 +34,48 @@ void KviKvsEvent::clear()
 	if(m_pHandlers)
 		delete m_pHandlers;
 	m_pHandlers = nullptr;
+	m_bWindowFiltered = false;
+}
+
+bool KviKvsEvent::handlersWindowFiltered(KviPointerList<KviKvsEventHandler> * pHandlers)
+{
+	if(!pHandlers)
+		return false;
+	// this may be called by a handler while the list is being triggered: use an iterator
+	KviPointerListIterator<KviKvsEventHandler> it(*pHandlers);
+	while(KviKvsEventHandler * h = it.current())
+	{
+		if(h->type() != KviKvsEventHandler::Script)
+			return false;
+		KviKvsEventHandlerFilter * f = ((KviKvsScriptEventHandler *)h)->filter();
+		if(!(f && f->hasWindowConditions()))
+			return false;
+		++it;
+	}
+	return true;
+}
+
+bool KviKvsEvent::handlersAcceptWindow(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd)
+{
+	if(!pHandlers)
+		return false;
+	// as above, don't disturb the list iteration
+	KviPointerListIterator<KviKvsEventHandler> it(*pHandlers);
+	while(KviKvsEventHandler * h = it.current())
+	{
+		if(h->type() != KviKvsEventHandler::Script)
+			return true;
+		KviKvsScriptEventHandler * s = (KviKvsScriptEventHandler *)h;
+		if(s->isEnabled() && ((!s->filter()) || s->filter()->matchesWindow(pWnd)))
+			return true;
+		++it;
+	}
+	return false;
+}
+
+void KviKvsEvent::updateFilterState()
+{
+	m_bWindowFiltered = handlersWindowFiltered(m_pHandlers);
 }
 
 void KviKvsEvent::removeHandler(KviKvsEventHandler * h)
@@ -44,6 +86,7 @@ void KviKvsEvent::removeHandler(KviKvsEventHandler * h)
 		delete m_pHandlers;
 		m_pHandlers = nullptr;
 	}
+	updateFilterState();
 }
 
 void KviKvsEvent::addHandler(KviKvsEventHandler * h)
@@ -54,6 +97,7 @@ void KviKvsEvent::addHandler(KviKvsEventHandler * h)
 		m_pHandlers->setAutoDelete(true);
 	}
 	m_pHandlers->append(h);
+	updateFilterState();
 }
 
 void KviKvsEvent::clearScriptHandlers()
@@ -77,4 +121,5 @@ void KviKvsEvent::clearScriptHandlers()
 		delete m_pHandlers;
 		m_pHandlers = nullptr;
 	}
+	updateFilterState();
 }
@@ -30,26 +30,54 @@
 
 #include "KviKvsEventHandler.h"
 
+class KviWindow;
+
 class KVIRC_API KviKvsEvent
 {
 protected:
 	QString m_szName;
 	QString m_szParameterDescription;
 	KviPointerList<KviKvsEventHandler> * m_pHandlers;
+	// parameters used by the handler filters (declared in the event table), -1 if missing
+	int m_iNickParameter;
+	int m_iMessageParameter;
+	// true if every handler has window or network filter conditions
+	bool m_bWindowFiltered;
 
 public:
 	// the event name and the parameter description are NOT translated
-	KviKvsEvent(const char * szEventName, const char * szParameterDescription)
-	    : m_szName(szEventName), m_szParameterDescription(szParameterDescription), m_pHandlers(0){};
+	// iNickParameter and iMessageParameter are the indexes of the source nickname
+	// and of the message text in the parameter list, -1 if the event has none
+	KviKvsEvent(const char * szEventName, const char * szParameterDescription, int iNickParameter = -1, int iMessageParameter = -1)
+	    : m_szName(szEventName), m_szParameterDescription(szParameterDescription), m_pHandlers(nullptr), m_iNickParameter(iNickParameter), m_iMessageParameter(iMessageParameter), m_bWindowFiltered(false){};
 	~KviKvsEvent();
 	void clear();
 	void clearScriptHandlers();
 	bool hasHandlers() { return m_pHandlers != 0; };
+	// like hasHandlers() but also checks the window filters, so
+	// the callers can skip building the parameter list at all
+	bool hasHandlers(KviWindow * pWnd)
+	{
+		if(!m_pHandlers)
+			return false;
+		return m_bWindowFiltered ? hasHandlersForWindow(pWnd) : true;
+	};
 	KviPointerList<KviKvsEventHandler> * handlers() { return m_pHandlers; };
 	void addHandler(KviKvsEventHandler * h);
 	void removeHandler(KviKvsEventHandler * h);
+	// must be called when the filter of one of the handlers changes
+	void updateFilterState();
 	const QString & name() { return m_szName; };
 	const QString & parameterDescription() { return m_szParameterDescription; };
+	int nickParameter() { return m_iNickParameter; };
+	int messageParameter() { return m_iMessageParameter; };
+
+	// helpers shared with the raw event table
+	static bool handlersWindowFiltered(KviPointerList<KviKvsEventHandler> * pHandlers);
+	static bool handlersAcceptWindow(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd);
+
+protected:
+	bool hasHandlersForWindow(KviWindow * pWnd) { return handlersAcceptWindow(m_pHandlers, pWnd); };
 };
 
 #endif //!_KVI_KVS_EVENT_H_
@@ -23,6 +23,127 @@
 //=============================================================================
 
 #include "KviKvsEventHandler.h"
+#include "KviKvsVariantList.h"
+#include "KviWindow.h"
+#include "KviIrcConnection.h"
+
+KviKvsEventHandlerFilter::KviKvsEventHandlerFilter()
+    : m_rxWindow(QString(), Qt::CaseInsensitive, QRegExp::Wildcard),
+      m_rxNick(QString(), Qt::CaseInsensitive, QRegExp::Wildcard),
+      m_rxMessage(QString(), Qt::CaseInsensitive, QRegExp::RegExp2),
+      m_rxNetwork(QString(), Qt::CaseInsensitive, QRegExp::Wildcard)
+{
+}
+
+KviKvsEventHandlerFilter::KviKvsEventHandlerFilter(const KviKvsEventHandlerFilter & f)
+    : m_szWindowMask(f.m_szWindowMask),
+      m_szNickMask(f.m_szNickMask),
+      m_szMessageRegExp(f.m_szMessageRegExp),
+      m_szNetworkMask(f.m_szNetworkMask),
+      m_rxWindow(f.m_rxWindow),
+      m_rxNick(f.m_rxNick),
+      m_rxMessage(f.m_rxMessage),
+      m_rxNetwork(f.m_rxNetwork)
+{
+}
+
+KviKvsEventHandlerFilter::~KviKvsEventHandlerFilter()
+    = default;
+
+KviKvsEventHandlerFilter & KviKvsEventHandlerFilter::operator=(const KviKvsEventHandlerFilter & f)
+{
+	m_szWindowMask = f.m_szWindowMask;
+	m_szNickMask = f.m_szNickMask;
+	m_szMessageRegExp = f.m_szMessageRegExp;
+	m_szNetworkMask = f.m_szNetworkMask;
+	m_rxWindow = f.m_rxWindow;
+	m_rxNick = f.m_rxNick;
+	m_rxMessage = f.m_rxMessage;
+	m_rxNetwork = f.m_rxNetwork;
+	return *this;
+}
+
+void KviKvsEventHandlerFilter::setWindowMask(const QString & szMask)
+{
+	m_szWindowMask = szMask;
+	m_rxWindow.setPattern(szMask);
+}
+
+void KviKvsEventHandlerFilter::setNickMask(const QString & szMask)
+{
+	m_szNickMask = szMask;
+	m_rxNick.setPattern(szMask);
+}
+
+void KviKvsEventHandlerFilter::setMessageRegExp(const QString & szRegExp)
+{
+	m_szMessageRegExp = szRegExp;
+	m_rxMessage.setPattern(szRegExp);
+}
+
+void KviKvsEventHandlerFilter::setNetworkMask(const QString & szMask)
+{
+	m_szNetworkMask = szMask;
+	m_rxNetwork.setPattern(szMask);
+}
+
+bool KviKvsEventHandlerFilter::isEmpty() const
+{
+	return m_szWindowMask.isEmpty() && m_szNickMask.isEmpty() && m_szMessageRegExp.isEmpty() && m_szNetworkMask.isEmpty();
+}
+
+bool KviKvsEventHandlerFilter::matchesWindow(KviWindow * pWnd)
+{
+	if(!m_szWindowMask.isEmpty())
+	{
+		if(!pWnd)
+			return false;
+		const QString & szTarget = pWnd->target();
+		if(!m_rxWindow.exactMatch(szTarget.isEmpty() ? pWnd->windowName() : szTarget))
+			return false;
+	}
+
+	if(!m_szNetworkMask.isEmpty())
+	{
+		if(!pWnd || !pWnd->connection())
+			return false;
+		if(!m_rxNetwork.exactMatch(pWnd->connection()->currentNetworkName()))
+			return false;
+	}
+
+	return true;
+}
+
+bool KviKvsEventHandlerFilter::matchesParameters(KviKvsVariantList * pParams, int iNickParam, int iMessageParam)
+{
+	if(!m_szNickMask.isEmpty())
+	{
+		KviKvsVariant * v = (pParams && (iNickParam >= 0)) ? pParams->at(iNickParam) : nullptr;
+		if(!v)
+			return false;
+		QString szNick;
+		v->asString(szNick);
+		// raw events pass the full nick!user@host prefix
+		int idx = szNick.indexOf(QChar('!'));
+		if(idx != -1)
+			szNick.truncate(idx);
+		if(!m_rxNick.exactMatch(szNick))
+			return false;
+	}
+
+	if(!m_szMessageRegExp.isEmpty())
+	{
+		KviKvsVariant * v = (pParams && (iMessageParam >= 0)) ? pParams->at(iMessageParam) : nullptr;
+		if(!v)
+			return false;
+		QString szMessage;
+		v->asString(szMessage);
+		if(m_rxMessage.indexIn(szMessage) == -1)
+			return false;
+	}
+
+	return true;
+}
 
 KviKvsEventHandler::KviKvsEventHandler(Type t)
     : KviHeapObject(), m_type(t)
@@ -33,7 +154,7 @@ KviKvsEventHandler::~KviKvsEventHandler()
     = default;
 
 KviKvsScriptEventHandler::KviKvsScriptEventHandler(const QString & szHandlerName, const QString & szContextName, const QString & szCode, bool bEnabled)
-    : KviKvsEventHandler(KviKvsEventHandler::Script), m_szName(szHandlerName), m_bEnabled(bEnabled)
+    : KviKvsEventHandler(KviKvsEventHandler::Script), m_szName(szHandlerName), m_bEnabled(bEnabled), m_pFilter(nullptr)
 {
 	m_pScript = new KviKvsScript(szContextName, szCode);
 }
@@ -41,6 +162,20 @@ KviKvsScriptEventHandler::KviKvsScriptEventHandler(const QString & szHandlerName
 KviKvsScriptEventHandler::~KviKvsScriptEventHandler()
 {
 	delete m_pScript;
+	if(m_pFilter)
+		delete m_pFilter;
+}
+
+void KviKvsScriptEventHandler::setFilter(KviKvsEventHandlerFilter * pFilter)
+{
+	if(m_pFilter)
+		delete m_pFilter;
+	if(pFilter && pFilter->isEmpty())
+	{
+		delete pFilter;
+		pFilter = nullptr;
+	}
+	m_pFilter = pFilter;
 }
 
 KviKvsScriptEventHandler * KviKvsScriptEventHandler::createInstance(const QString & szHandlerName, const QString & szContextName, const QString & szCode, bool bEnabled)
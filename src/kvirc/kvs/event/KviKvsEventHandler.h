@@ -30,6 +30,60 @@
 #include "KviKvsModuleInterface.h"
 #include "KviHeapObject.h"
 
+#include <QRegExp>
+
+class KviWindow;
+class KviKvsVariantList;
+
+//
+// Native precondition filter attached to a script event handler.
+// All the non empty fields must match for the handler to be run:
+// the filter is evaluated before the script is started so the
+// non matching traffic never enters the interpreter.
+//
+class KVIRC_API KviKvsEventHandlerFilter
+{
+public:
+	KviKvsEventHandlerFilter();
+	KviKvsEventHandlerFilter(const KviKvsEventHandlerFilter & f);
+	~KviKvsEventHandlerFilter();
+
+protected:
+	QString m_szWindowMask;    // wildcard, matched against the window target (or name)
+	QString m_szNickMask;      // wildcard, matched against the source nickname
+	QString m_szMessageRegExp; // regular expression, matched against the message text
+	QString m_szNetworkMask;   // wildcard, matched against the current network name
+	QRegExp m_rxWindow;
+	QRegExp m_rxNick;
+	QRegExp m_rxMessage;
+	QRegExp m_rxNetwork;
+
+public:
+	KviKvsEventHandlerFilter & operator=(const KviKvsEventHandlerFilter & f);
+
+	const QString & windowMask() const { return m_szWindowMask; };
+	const QString & nickMask() const { return m_szNickMask; };
+	const QString & messageRegExp() const { return m_szMessageRegExp; };
+	const QString & networkMask() const { return m_szNetworkMask; };
+
+	void setWindowMask(const QString & szMask);
+	void setNickMask(const QString & szMask);
+	void setMessageRegExp(const QString & szRegExp);
+	void setNetworkMask(const QString & szMask);
+
+	bool isEmpty() const;
+	// true if the filter depends only on the target window (and its network)
+	bool hasWindowConditions() const { return !(m_szWindowMask.isEmpty() && m_szNetworkMask.isEmpty()); };
+	// returns false if the message regexp (if any) is invalid
+	bool isValid() const { return m_szMessageRegExp.isEmpty() || m_rxMessage.isValid(); };
+
+	// checks the window and network conditions
+	bool matchesWindow(KviWindow * pWnd);
+	// checks the nickname and message conditions: the parameter indexes
+	// are provided by the triggered event, -1 means "not available"
+	bool matchesParameters(KviKvsVariantList * pParams, int iNickParam, int iMessageParam);
+};
+
 class KVIRC_API KviKvsEventHandler : public KviHeapObject
 {
 public:
@@ -61,6 +115,7 @@ protected:
 	QString m_szName;
 	KviKvsScript * m_pScript;
 	bool m_bEnabled;
+	KviKvsEventHandlerFilter * m_pFilter; // owned, may be 0
 
 public:
 	KviKvsScript * script() { return m_pScript; };
@@ -70,6 +125,10 @@ public:
 	bool isEnabled() { return m_bEnabled; };
 	void setEnabled(bool bEnabled) { m_bEnabled = bEnabled; };
 
+	KviKvsEventHandlerFilter * filter() { return m_pFilter; };
+	// takes the ownership of pFilter, empty filters are discarded
+	void setFilter(KviKvsEventHandlerFilter * pFilter);
+
 	// Static allocator function.
 	// This MUST be used by the modules to allocate event structures
 	// instead of the new operator.
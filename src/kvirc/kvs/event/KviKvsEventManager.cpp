@@ -95,6 +95,7 @@ KviKvsEventManager::KviKvsEventManager()
 	m_pInstance = this;
 	for(auto & i : m_rawEventTable)
 		i = nullptr;
+	m_rawEventWindowFiltered.reset();
 }
 
 KviKvsEventManager::~KviKvsEventManager()
@@ -148,6 +149,20 @@ KviKvsEvent * KviKvsEventManager::findAppEventByName(const QString & szName)
 	return nullptr;
 }
 
+void KviKvsEventManager::updateAppFilterState(unsigned int uEvIdx)
+{
+	if(uEvIdx >= KVI_KVS_NUM_APP_EVENTS)
+		return;
+	m_appEventTable[uEvIdx].updateFilterState();
+}
+
+void KviKvsEventManager::updateRawFilterState(unsigned int uEvIdx)
+{
+	if(uEvIdx >= KVI_KVS_NUM_RAW_EVENTS)
+		return;
+	m_rawEventWindowFiltered.set(uEvIdx, KviKvsEvent::handlersWindowFiltered(m_rawEventTable[uEvIdx]));
+}
+
 bool KviKvsEventManager::addAppHandler(unsigned int uEvIdx, KviKvsEventHandler * h)
 {
 	if(uEvIdx >= KVI_KVS_NUM_APP_EVENTS)
@@ -166,6 +181,7 @@ bool KviKvsEventManager::addRawHandler(unsigned int uRawIdx, KviKvsEventHandler
 		m_rawEventTable[uRawIdx]->setAutoDelete(true);
 	}
 	m_rawEventTable[uRawIdx]->append(h);
+	updateRawFilterState(uRawIdx);
 	return true;
 }
 
@@ -321,6 +337,9 @@ void KviKvsEventManager::removeAllModuleRawHandlers(KviKvsModuleInterface * pIfa
 			i = nullptr;
 		}
 	}
+
+	for(unsigned int u = 0; u < KVI_KVS_NUM_RAW_EVENTS; u++)
+		updateRawFilterState(u);
 }
 
 bool KviKvsEventManager::removeScriptRawHandler(unsigned int uEvIdx, const QString & szName)
@@ -342,6 +361,7 @@ bool KviKvsEventManager::removeScriptRawHandler(unsigned int uEvIdx, const QStri
 					delete m_rawEventTable[uEvIdx];
 					m_rawEventTable[uEvIdx] = nullptr;
 				}
+				updateRawFilterState(uEvIdx);
 				return true;
 			}
 		}
@@ -377,6 +397,7 @@ bool KviKvsEventManager::removeModuleRawHandler(unsigned int uRawIdx, KviKvsModu
 					delete m_rawEventTable[uRawIdx];
 					m_rawEventTable[uRawIdx] = nullptr;
 				}
+				updateRawFilterState(uRawIdx);
 				return true;
 			}
 		}
@@ -425,6 +446,9 @@ void KviKvsEventManager::removeAllScriptRawHandlers()
 			}
 		}
 	}
+
+	for(unsigned int u = 0; u < KVI_KVS_NUM_RAW_EVENTS; u++)
+		updateRawFilterState(u);
 }
 
 void KviKvsEventManager::clearRawEvents()
@@ -435,6 +459,7 @@ void KviKvsEventManager::clearRawEvents()
 			delete i;
 		i = nullptr;
 	}
+	m_rawEventWindowFiltered.reset();
 }
 
 void KviKvsEventManager::clearAppEvents()
@@ -451,7 +476,13 @@ void KviKvsEventManager::clear()
 	clearAppEvents();
 }
 
-bool KviKvsEventManager::triggerHandlers(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd, KviKvsVariantList * pParams)
+bool KviKvsEventManager::triggerRaw(unsigned int uEvIdx, KviWindow * pWnd, KviKvsVariantList * pParams)
+{
+	// raw events get the source prefix in $0 and the trailing parameter last
+	return triggerHandlers(m_rawEventTable[uEvIdx], pWnd, pParams, 0, pParams ? ((int)pParams->count()) - 1 : -1);
+}
+
+bool KviKvsEventManager::triggerHandlers(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd, KviKvsVariantList * pParams, int iNickParam, int iMessageParam)
 {
 	if(!pHandlers)
 		return false;
@@ -465,6 +496,11 @@ bool KviKvsEventManager::triggerHandlers(KviPointerList<KviKvsEventHandler> * pH
 			{
 				if(((KviKvsScriptEventHandler *)h)->isEnabled())
 				{
+					// evaluate the native filters before starting the interpreter
+					KviKvsEventHandlerFilter * f = ((KviKvsScriptEventHandler *)h)->filter();
+					if(f && !(f->matchesWindow(pWnd) && f->matchesParameters(pParams, iNickParam, iMessageParam)))
+						break;
+
 					KviKvsScript * s = ((KviKvsScriptEventHandler *)h)->script();
 					KviKvsScript copy(*s);
 					KviKvsVariant retVal;
@@ -500,6 +536,33 @@ bool KviKvsEventManager::triggerHandlers(KviPointerList<KviKvsEventHandler> * pH
 	return bGotHalt;
 }
 
+static void loadHandlerFilter(KviConfigurationFile & cfg, unsigned int uIdx, KviKvsScriptEventHandler * pHandler, bool bRaw)
+{
+	KviKvsEventHandlerFilter * pFilter = new KviKvsEventHandlerFilter();
+	// the raw events are triggered in the console: a window filter would never match a channel
+	if(!bRaw)
+		pFilter->setWindowMask(cfg.readEntry(QString("WindowFilter%1").arg(uIdx), ""));
+	pFilter->setNickMask(cfg.readEntry(QString("NickFilter%1").arg(uIdx), ""));
+	pFilter->setMessageRegExp(cfg.readEntry(QString("MessageFilter%1").arg(uIdx), ""));
+	pFilter->setNetworkMask(cfg.readEntry(QString("NetworkFilter%1").arg(uIdx), ""));
+	pHandler->setFilter(pFilter); // empty filters are dropped here
+}
+
+static void saveHandlerFilter(KviConfigurationFile & cfg, int iIdx, KviKvsScriptEventHandler * pHandler)
+{
+	KviKvsEventHandlerFilter * pFilter = pHandler->filter();
+	if(!pFilter)
+		return;
+	if(!pFilter->windowMask().isEmpty())
+		cfg.writeEntry(QString("WindowFilter%1").arg(iIdx), pFilter->windowMask());
+	if(!pFilter->nickMask().isEmpty())
+		cfg.writeEntry(QString("NickFilter%1").arg(iIdx), pFilter->nickMask());
+	if(!pFilter->messageRegExp().isEmpty())
+		cfg.writeEntry(QString("MessageFilter%1").arg(iIdx), pFilter->messageRegExp());
+	if(!pFilter->networkMask().isEmpty())
+		cfg.writeEntry(QString("NetworkFilter%1").arg(iIdx), pFilter->networkMask());
+}
+
 void KviKvsEventManager::loadRawEvents(const QString & szFileName)
 {
 	KviConfigurationFile cfg(szFileName, KviConfigurationFile::Read);
@@ -526,8 +589,10 @@ void KviKvsEventManager::loadRawEvents(const QString & szFileName)
 					KviKvsScriptEventHandler * pScript = new KviKvsScriptEventHandler(szName, szTmp, szCode);
 					szTmp = QString("Enabled%1").arg(uIdx);
 					pScript->setEnabled(cfg.readBoolEntry(szTmp, false));
+					loadHandlerFilter(cfg, uIdx, pScript, true);
 					m_rawEventTable[i]->append(pScript);
 				}
+				updateRawFilterState(i);
 			}
 		}
 	}
@@ -556,6 +621,7 @@ void KviKvsEventManager::saveRawEvents(const QString & szFileName)
 					cfg.writeEntry(szTmp, ((KviKvsScriptEventHandler *)pEvent)->code());
 					szTmp = QString("Enabled%1").arg(iIdx);
 					cfg.writeEntry(szTmp, ((KviKvsScriptEventHandler *)pEvent)->isEnabled());
+					saveHandlerFilter(cfg, iIdx, (KviKvsScriptEventHandler *)pEvent);
 					iIdx++;
 				}
 			}
@@ -591,6 +657,7 @@ void KviKvsEventManager::loadAppEvents(const QString & szFileName)
 					bool bEnabled = cfg.readBoolEntry(szTmp, false);
 					QString szCntx = QString("%1::%2").arg(m_appEventTable[i].name(), szName);
 					KviKvsScriptEventHandler * pEvent = new KviKvsScriptEventHandler(szName, szCntx, szCode, bEnabled);
+					loadHandlerFilter(cfg, uIdx, pEvent, false);
 					m_appEventTable[i].addHandler(pEvent);
 				}
 			}
@@ -627,6 +694,7 @@ void KviKvsEventManager::saveAppEvents(const QString & szFileName)
 					cfg.writeEntry(szTmp, ((KviKvsScriptEventHandler *)pEvent)->code());
 					szTmp = QString("Enabled%1").arg(iIdx);
 					cfg.writeEntry(szTmp, ((KviKvsScriptEventHandler *)pEvent)->isEnabled());
+					saveHandlerFilter(cfg, iIdx, (KviKvsScriptEventHandler *)pEvent);
 					iIdx++;
 				}
 			}
@@ -30,6 +30,8 @@
 #include "KviPointerList.h"
 #include "KviKvsEventTable.h"
 
+#include <bitset>
+
 class KviWindow;
 class KviKvsModuleInterface;
 class KviKvsVariantList;
@@ -52,6 +54,8 @@ protected:
 
 	static KviKvsEvent m_appEventTable[KVI_KVS_NUM_APP_EVENTS];
 	KviPointerList<KviKvsEventHandler> * m_rawEventTable[KVI_KVS_NUM_RAW_EVENTS];
+	// bit set: all the handlers of the raw event have window/network filters
+	std::bitset<KVI_KVS_NUM_RAW_EVENTS> m_rawEventWindowFiltered;
 
 public:
 	static KviKvsEventManager * instance() { return m_pInstance; };
@@ -61,9 +65,17 @@ public:
 	KviKvsEvent * appEvent(unsigned int uEvIdx) { return &(m_appEventTable[uEvIdx]); };
 
 	bool hasAppHandlers(unsigned int uEvIdx) { return m_appEventTable[uEvIdx].hasHandlers(); };
+	// this one also evaluates the handler window filters
+	bool hasAppHandlers(unsigned int uEvIdx, KviWindow * pWnd) { return m_appEventTable[uEvIdx].hasHandlers(pWnd); };
 	KviPointerList<KviKvsEventHandler> * appHandlers(unsigned int uEvIdx) { return m_appEventTable[uEvIdx].handlers(); };
 
 	bool hasRawHandlers(unsigned int uEvIdx) { return m_rawEventTable[uEvIdx]; };
+	bool hasRawHandlers(unsigned int uEvIdx, KviWindow * pWnd)
+	{
+		if(!m_rawEventTable[uEvIdx])
+			return false;
+		return m_rawEventWindowFiltered.test(uEvIdx) ? KviKvsEvent::handlersAcceptWindow(m_rawEventTable[uEvIdx], pWnd) : true;
+	};
 	KviPointerList<KviKvsEventHandler> * rawHandlers(unsigned int uEvIdx) { return m_rawEventTable[uEvIdx]; };
 
 	KviKvsEvent * findAppEventByName(const QString & szName);
@@ -99,22 +111,24 @@ public:
 	KviKvsScriptEventHandler * findScriptRawHandler(unsigned int uEvIdx, const QString & szName);
 	KviKvsScriptEventHandler * findScriptAppHandler(unsigned int uEvIdx, const QString & szName);
 
+	// must be called after changing the filter of a handler that is already registered
+	void updateAppFilterState(unsigned int uEvIdx);
+	void updateRawFilterState(unsigned int uEvIdx);
+
 	// returns true if further processing should be stopped
 	// none of these functions takes params ownership, so be sure to delete them !
-	bool triggerHandlers(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd, KviKvsVariantList * pParams);
+	// iNickParam and iMessageParam are the parameters checked by the handler filters (-1 if not available)
+	bool triggerHandlers(KviPointerList<KviKvsEventHandler> * pHandlers, KviWindow * pWnd, KviKvsVariantList * pParams, int iNickParam = -1, int iMessageParam = -1);
 	bool trigger(unsigned int uEvIdx, KviWindow * pWnd, KviKvsVariantList * pParams)
 	{
-		return triggerHandlers(m_appEventTable[uEvIdx].handlers(), pWnd, pParams);
-	};
-	bool triggerRaw(unsigned int uEvIdx, KviWindow * pWnd, KviKvsVariantList * pParams)
-	{
-		return triggerHandlers(m_rawEventTable[uEvIdx], pWnd, pParams);
+		return triggerHandlers(m_appEventTable[uEvIdx].handlers(), pWnd, pParams, m_appEventTable[uEvIdx].nickParameter(), m_appEventTable[uEvIdx].messageParameter());
 	};
+	bool triggerRaw(unsigned int uEvIdx, KviWindow * pWnd, KviKvsVariantList * pParams);
 
 	// this is the only that takes parameter ownership and deletes them
 	bool triggerDeleteParams(unsigned int uEvIdx, KviWindow * pWnd, KviKvsVariantList * pParams)
 	{
-		bool bRet = triggerHandlers(m_appEventTable[uEvIdx].handlers(), pWnd, pParams);
+		bool bRet = trigger(uEvIdx, pWnd, pParams);
 		delete pParams;
 		return bRet;
 	};
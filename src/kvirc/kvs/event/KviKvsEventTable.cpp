@@ -32,6 +32,8 @@
  */
 
 #define EVENT(_name, _parm) KviKvsEvent(_name, _parm)
+// _nick and _message are the parameters checked by the -n and -m handler filters (-1 if not available)
+#define EVENT_WITH_SOURCE(_name, _parm, _nick, _message) KviKvsEvent(_name, _parm, _nick, _message)
 
 KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 	// Application
@@ -287,14 +289,14 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			check the values of [fnc]$channel[/fnc] or [fnc]$query[/fnc].
 	*/
 
-	EVENT("OnHighlight",
+	EVENT_WITH_SOURCE("OnHighlight",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message\n"
 	    "$4 = Highlight word\n"
 	    "$5 = Message type\n"
-	    "$6 = Is action"),
+	    "$6 = Is action", 0, 3),
 
 	/*
 		@doc: onwindowactivated
@@ -339,8 +341,8 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 
 	*/
 
-	EVENT("OnNotifyOnline",
-	    "$0 = Nickname"),
+	EVENT_WITH_SOURCE("OnNotifyOnline",
+	    "$0 = Nickname", 0, -1),
 
 	/*
 		@doc: onnotifyoffline
@@ -365,8 +367,8 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			This is a good place to play a sound or attract the user attention in some other way.[br]
 	*/
 
-	EVENT("OnNotifyOffline",
-	    "$0 = Nickname"),
+	EVENT_WITH_SOURCE("OnNotifyOffline",
+	    "$0 = Nickname", 0, -1),
 
 	/*
 		@doc: onping
@@ -526,8 +528,8 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			A good example might be a [cmd]whois[/cmd] query or a [cmd]dcc.chat[/cmd]
 	*/
 
-	EVENT("OnNotifyListDefaultActionRequest",
-	    "$0 = Nickname"),
+	EVENT_WITH_SOURCE("OnNotifyListDefaultActionRequest",
+	    "$0 = Nickname", 0, -1),
 
 	/*
 		@doc: onwallops
@@ -550,11 +552,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 		@seealso:
 	*/
 
-	EVENT("OnWallops",
+	EVENT_WITH_SOURCE("OnWallops",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Message text"),
+	    "$3 = Message text", 0, 3),
 
 	/*
 		@doc: OnIgnoredMessage
@@ -577,13 +579,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			Triggered when a message is ignored.
 	*/
 
-	EVENT("OnIgnoredMessage",
+	EVENT_WITH_SOURCE("OnIgnoredMessage",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message target\n"
 	    "$4 = Message\n"
-	    "$5 = Message tags"),
+	    "$5 = Message tags", 0, 4),
 
 	/*
 		@doc: onservernotice
@@ -604,9 +606,9 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onchannelnotice]OnChannelNotice[/event]
 	*/
 
-	EVENT("OnServerNotice",
+	EVENT_WITH_SOURCE("OnServerNotice",
 	    "$0 = Source nickname\n"
-	    "$1 = Message"),
+	    "$1 = Message", 0, 1),
 
 	// Connection
 	/*
@@ -803,10 +805,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 		@seealso:
 	*/
 
-	EVENT("OnUnhandledLiteral",
+	EVENT_WITH_SOURCE("OnUnhandledLiteral",
 	    "$0 = Source mask\n"
 	    "$1 = Message\n"
-	    "$2- = Parameters"),
+	    "$2- = Parameters", -1, 1),
 
 	/*
 		@doc: onoutboundtraffic
@@ -1266,14 +1268,14 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondccchatmessage]OnDCCChatMessage[/event]
 	*/
 
-	EVENT("OnChannelMessage",
+	EVENT_WITH_SOURCE("OnChannelMessage",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message\n"
 	    "$4 = Target mode prefixes\n"
 	    "$5 = Was encrypted\n"
-	    "$6 = Message tags"),
+	    "$6 = Message tags", 0, 3),
 
 	/*
 		@doc: onchannelnotice
@@ -1303,12 +1305,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onservernotice]OnServerNotice[/event]
 	*/
 
-	EVENT("OnChannelNotice",
+	EVENT_WITH_SOURCE("OnChannelNotice",
 	    "$0 = Source nickname\n"
 	    "$1 = Message\n"
 	    "$2 = Target\n"
 	    "$3 = Was encrypted\n"
-	    "$4 = Message tags"),
+	    "$4 = Message tags", 0, 1),
 
 	// Queries
 	/*
@@ -1347,13 +1349,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondccchatmessage]OnDCCChatMessage[/event]
 	*/
 
-	EVENT("OnQueryMessage",
+	EVENT_WITH_SOURCE("OnQueryMessage",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message\n"
 	    "$4 = Was encrypted\n"
-	    "$5 = Message tags"),
+	    "$5 = Message tags", 0, 3),
 
 	/*
 		@doc: onquerynotice
@@ -1381,13 +1383,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onchannelnotice]OnChannelNotice[/event]
 	*/
 
-	EVENT("OnQueryNotice",
+	EVENT_WITH_SOURCE("OnQueryNotice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message\n"
 	    "$4 = Was encrypted\n"
-	    "$5 = Message tags"),
+	    "$5 = Message tags", 0, 3),
 
 	/*
 		@doc: onquerywindowrequest
@@ -1421,12 +1423,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			the parameters passed to this event.
 	*/
 
-	EVENT("OnQueryWindowRequest",
+	EVENT_WITH_SOURCE("OnQueryWindowRequest",
 	    "$0 = Source nickname\n"
 	    "$1 = Source user\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message\n"
-	    "$4 = Message tags"),
+	    "$4 = Message tags", 0, 3),
 
 	/*
 		@doc: onquerywindowcreated
@@ -1477,10 +1479,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			when a new query target is added by using [cmd]addtarget[/cmd].
 	*/
 
-	EVENT("OnQueryTargetAdded",
+	EVENT_WITH_SOURCE("OnQueryTargetAdded",
 	    "$0 = Nickname\n"
 	    "$1 = Username (may be *)\n"
-	    "$2 = Hostname (may be *)"),
+	    "$2 = Hostname (may be *)", 0, -1),
 
 	/*
 		@doc: OnQueryFileDropped
@@ -1500,9 +1502,9 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			$target is the nick.[br]
 	*/
 
-	EVENT("OnQueryFileDropped",
+	EVENT_WITH_SOURCE("OnQueryFileDropped",
 	    "$0 = Source nickname\n"
-	    "$1 = File dropped"),
+	    "$1 = File dropped", 0, -1),
 
 	// Actions
 	/*
@@ -1576,10 +1578,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmejoin]OnMeJoin[/event]
 	*/
 
-	EVENT("OnJoin",
+	EVENT_WITH_SOURCE("OnJoin",
 	    "$0 = Nickname\n"
 	    "$1 = Username\n"
-	    "$2 = Hostname"),
+	    "$2 = Hostname", 0, -1),
 
 	/*
 		@doc: onmejoin
@@ -1635,11 +1637,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmepart]OnMePart[/event]
 	*/
 
-	EVENT("OnPart",
+	EVENT_WITH_SOURCE("OnPart",
 	    "$0 = Nickname\n"
 	    "$1 = Username\n"
 	    "$2 = Hostname\n"
-	    "$3 = Part message"),
+	    "$3 = Part message", 0, 3),
 
 	/*
 		@doc: onmepart
@@ -1669,8 +1671,8 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onpart]OnPart[/event]
 	*/
 
-	EVENT("OnMePart",
-	    "$0 = Part message"),
+	EVENT_WITH_SOURCE("OnMePart",
+	    "$0 = Part message", -1, 0),
 
 	/*
 		@doc: onkick
@@ -1702,12 +1704,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmekick]OnMeKick[/event]
 	*/
 
-	EVENT("OnKick",
+	EVENT_WITH_SOURCE("OnKick",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Kicked nickname\n"
-	    "$4 = Reason"),
+	    "$4 = Reason", 0, -1),
 
 	/*
 		@doc: onmekick
@@ -1739,11 +1741,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onkick]OnKick[/event]
 	*/
 
-	EVENT("OnMeKick",
+	EVENT_WITH_SOURCE("OnMeKick",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Reason"),
+	    "$3 = Reason", 0, -1),
 
 	/*
 		@doc: ontopic
@@ -1773,11 +1775,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmejoin]OnMeJoin[/event]
 	*/
 
-	EVENT("OnTopic",
+	EVENT_WITH_SOURCE("OnTopic",
 	    "$0 = Nickname\n"
 	    "$1 = Username\n"
 	    "$2 = Hostname\n"
-	    "$3 = Topic"),
+	    "$3 = Topic", 0, -1),
 
 	/*
 		@doc: onquit
@@ -1814,12 +1816,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[/example]
 	*/
 
-	EVENT("OnQuit",
+	EVENT_WITH_SOURCE("OnQuit",
 	    "$0 = Nickname\n"
 	    "$1 = Username\n"
 	    "$2 = Hostname\n"
 	    "$3 = Quit message\n"
-	    "$4 = Channels"),
+	    "$4 = Channels", 0, 3),
 
 	// IRC modes
 	/*
@@ -1844,12 +1846,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			the unparsed mode parameter string (you need to split it!).
 	*/
 
-	EVENT("OnChannelModeChange",
+	EVENT_WITH_SOURCE("OnChannelModeChange",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Mode flags\n"
-	    "$4 = Mode params"),
+	    "$4 = Mode params", 0, -1),
 
 	/*
 		@doc: onusermodechange
@@ -1894,11 +1896,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onunban]OnUnban[/event]
 	*/
 
-	EVENT("OnBan",
+	EVENT_WITH_SOURCE("OnBan",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onunban
@@ -1921,11 +1923,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onban]OnBan[/event]
 	*/
 
-	EVENT("OnUnBan",
+	EVENT_WITH_SOURCE("OnUnBan",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onmeban
@@ -1948,11 +1950,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeunban]OnMeUnban[/event]
 	*/
 
-	EVENT("OnMeBan",
+	EVENT_WITH_SOURCE("OnMeBan",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onmeunban
@@ -1975,11 +1977,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeban]OnMeBan[/event]
 	*/
 
-	EVENT("OnMeUnban",
+	EVENT_WITH_SOURCE("OnMeUnban",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onbanexception
@@ -2002,11 +2004,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onbanexceptionremove]OnBanExceptionRemove[/event]
 	*/
 
-	EVENT("OnBanException",
+	EVENT_WITH_SOURCE("OnBanException",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban exception mask"),
+	    "$3 = Ban exception mask", 0, -1),
 
 	/*
 		@doc: onbanexceptionremove
@@ -2029,11 +2031,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onbanexception]OnBanException[/event]
 	*/
 
-	EVENT("OnBanExceptionRemove",
+	EVENT_WITH_SOURCE("OnBanExceptionRemove",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban exception mask"),
+	    "$3 = Ban exception mask", 0, -1),
 
 	/*
 		@doc: onmebanexception
@@ -2056,11 +2058,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmebanexceptionremove]OnMeBanExceptionRemove[/event]
 	*/
 
-	EVENT("OnMeBanException",
+	EVENT_WITH_SOURCE("OnMeBanException",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Mask"),
+	    "$3 = Mask", 0, -1),
 
 	/*
 		@doc: onmebanexceptionremove
@@ -2083,11 +2085,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmebanexception]OnMeBanException[/event]
 	*/
 
-	EVENT("OnMeBanExceptionRemove",
+	EVENT_WITH_SOURCE("OnMeBanExceptionRemove",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Mask"),
+	    "$3 = Mask", 0, -1),
 
 	/*
 		@doc: oninvite
@@ -2108,11 +2110,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			Triggered when someone invites the local user to join a channel
 	*/
 
-	EVENT("OnInvite",
+	EVENT_WITH_SOURCE("OnInvite",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Channel"),
+	    "$3 = Channel", 0, -1),
 
 	/*
 		@doc: oninviteexception
@@ -2135,11 +2137,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:oninviteexceptionremove]OnInviteExceptionRemove[/event]
 	*/
 
-	EVENT("OnInviteException",
+	EVENT_WITH_SOURCE("OnInviteException",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target mask"),
+	    "$3 = Target mask", 0, -1),
 
 	/*
 		@doc: oninviteexceptionremove
@@ -2162,11 +2164,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:oninviteexceptionremove]OnInviteExceptionRemove[/event]
 	*/
 
-	EVENT("OnInviteExceptionRemove",
+	EVENT_WITH_SOURCE("OnInviteExceptionRemove",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target mask"),
+	    "$3 = Target mask", 0, -1),
 
 	/*
 		@doc: onmeinviteexception
@@ -2190,11 +2192,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeinviteexceptionremove]OnMeInviteExceptionRemove[/event]
 	*/
 
-	EVENT("OnMeInviteException",
+	EVENT_WITH_SOURCE("OnMeInviteException",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Mask"),
+	    "$3 = Mask", 0, -1),
 
 	/*
 		@doc: onmeinviteexceptionremove
@@ -2218,11 +2220,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeinviteexceptionremove]OnMeInviteExceptionRemove[/event]
 	*/
 
-	EVENT("OnMeInviteExceptionRemove",
+	EVENT_WITH_SOURCE("OnMeInviteExceptionRemove",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Mask"),
+	    "$3 = Mask", 0, -1),
 
 	/*
 		@doc: onlimitset
@@ -2245,11 +2247,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onlimitunset]OnLimitUnset[/event]
 	*/
 
-	EVENT("OnLimitSet",
+	EVENT_WITH_SOURCE("OnLimitSet",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Limit"),
+	    "$3 = Limit", 0, -1),
 
 	/*
 		@doc: onlimitunset
@@ -2271,10 +2273,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onlimitunset]OnLimitUnset[/event]
 	*/
 
-	EVENT("OnLimitUnset",
+	EVENT_WITH_SOURCE("OnLimitUnset",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onkeyset
@@ -2297,11 +2299,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onkeyunset]OnKeyUnset[/event]
 	*/
 
-	EVENT("OnKeySet",
+	EVENT_WITH_SOURCE("OnKeySet",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Key"),
+	    "$3 = Key", 0, -1),
 
 	/*
 		@doc: onkeyunset
@@ -2323,10 +2325,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onkeyunset]OnKeyUnset[/event]
 	*/
 
-	EVENT("OnKeyUnset",
+	EVENT_WITH_SOURCE("OnKeyUnset",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onnickchange
@@ -2350,11 +2352,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmenickchange]OnMeNickChange[/event]
 	*/
 
-	EVENT("OnNickChange",
+	EVENT_WITH_SOURCE("OnNickChange",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = New nickname"),
+	    "$3 = New nickname", 0, -1),
 
 	/*
 		@doc: onmenickchange
@@ -2401,11 +2403,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondechanowner]OnDeChanOwner[/event]
 	*/
 
-	EVENT("OnChanOwner",
+	EVENT_WITH_SOURCE("OnChanOwner",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target nickname"),
+	    "$3 = Target nickname", 0, -1),
 
 	/*
 		@doc: ondechanowner
@@ -2428,11 +2430,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onchanowner]OnChanOwner[/event]
 	*/
 
-	EVENT("OnDeChanOwner",
+	EVENT_WITH_SOURCE("OnDeChanOwner",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target nickname"),
+	    "$3 = Target nickname", 0, -1),
 
 	/*
 		@doc: onmechanowner
@@ -2454,10 +2456,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedechanowner]OnMeDeChanOwner[/event]
 	*/
 
-	EVENT("OnMeChanOwner",
+	EVENT_WITH_SOURCE("OnMeChanOwner",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedechanowner
@@ -2479,10 +2481,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmechanowner]OnMeChanOwner[/event]
 	*/
 
-	EVENT("OnMeDeChanOwner",
+	EVENT_WITH_SOURCE("OnMeDeChanOwner",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onchanadmin
@@ -2505,11 +2507,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondechanadmin]OnDeChanAdmin[/event]
 	*/
 
-	EVENT("OnChanAdmin",
+	EVENT_WITH_SOURCE("OnChanAdmin",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target nickname"),
+	    "$3 = Target nickname", 0, -1),
 
 	/*
 		@doc: ondechanadmin
@@ -2532,11 +2534,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onchanadmin]OnChanAdmin[/event]
 	*/
 
-	EVENT("OnDeChanAdmin",
+	EVENT_WITH_SOURCE("OnDeChanAdmin",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Target nickname"),
+	    "$3 = Target nickname", 0, -1),
 
 	/*
 		@doc: onmechanadmin
@@ -2558,10 +2560,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedeop]OnMeDeChanAdmin[/event]
 	*/
 
-	EVENT("OnMeChanAdmin",
+	EVENT_WITH_SOURCE("OnMeChanAdmin",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedechanadmin
@@ -2583,10 +2585,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeop]OnMeOp[/event]
 	*/
 
-	EVENT("OnMeDeChanAdmin",
+	EVENT_WITH_SOURCE("OnMeDeChanAdmin",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onop
@@ -2609,11 +2611,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondeop]OnDeOp[/event]
 	*/
 
-	EVENT("OnOp",
+	EVENT_WITH_SOURCE("OnOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Opped nickname"),
+	    "$3 = Opped nickname", 0, -1),
 
 	/*
 		@doc: ondeop
@@ -2636,11 +2638,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onop]OnOp[/event]
 	*/
 
-	EVENT("OnDeOp",
+	EVENT_WITH_SOURCE("OnDeOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Deopped nickname"),
+	    "$3 = Deopped nickname", 0, -1),
 
 	/*
 		@doc: onmeop
@@ -2662,10 +2664,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedeop]OnMeDeOp[/event]
 	*/
 
-	EVENT("OnMeOp",
+	EVENT_WITH_SOURCE("OnMeOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedeop
@@ -2687,10 +2689,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeop]OnMeOp[/event]
 	*/
 
-	EVENT("OnMeDeOp",
+	EVENT_WITH_SOURCE("OnMeDeOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onhalfop
@@ -2713,11 +2715,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondehalfop]OnDeHalfOp[/event]
 	*/
 
-	EVENT("OnHalfOp",
+	EVENT_WITH_SOURCE("OnHalfOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Halfopped nickname"),
+	    "$3 = Halfopped nickname", 0, -1),
 
 	/*
 		@doc: ondehalfop
@@ -2740,11 +2742,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onhalfop]OnHalfOp[/event]
 	*/
 
-	EVENT("OnDeHalfOp",
+	EVENT_WITH_SOURCE("OnDeHalfOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Dehalfopped nickname"),
+	    "$3 = Dehalfopped nickname", 0, -1),
 
 	/*
 		@doc: onmehalfop
@@ -2766,10 +2768,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedehalfop]OnMeDeHalfOp[/event]
 	*/
 
-	EVENT("OnMeHalfOp",
+	EVENT_WITH_SOURCE("OnMeHalfOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedehalfop
@@ -2791,10 +2793,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmehalfop]OnMeHalfOp[/event]
 	*/
 
-	EVENT("OnMeDeHalfOp",
+	EVENT_WITH_SOURCE("OnMeDeHalfOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onvoice
@@ -2817,11 +2819,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondevoice]OnDeVoice[/event]
 	*/
 
-	EVENT("OnVoice",
+	EVENT_WITH_SOURCE("OnVoice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Voiced nickname"),
+	    "$3 = Voiced nickname", 0, -1),
 
 	/*
 		@doc: ondevoice
@@ -2844,11 +2846,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondevoice]OnDeVoice[/event]
 	*/
 
-	EVENT("OnDeVoice",
+	EVENT_WITH_SOURCE("OnDeVoice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Devoiced nickname"),
+	    "$3 = Devoiced nickname", 0, -1),
 
 	/*
 		@doc: onmevoice
@@ -2870,10 +2872,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedevoice]OnMeDeVoice[/event]
 	*/
 
-	EVENT("OnMeVoice",
+	EVENT_WITH_SOURCE("OnMeVoice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedevoice
@@ -2895,10 +2897,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmevoice]OnMeVoice[/event]
 	*/
 
-	EVENT("OnMeDeVoice",
+	EVENT_WITH_SOURCE("OnMeDeVoice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onuserop
@@ -2921,11 +2923,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondeuserop]OnDeUserOp[/event]
 	*/
 
-	EVENT("OnUserOp",
+	EVENT_WITH_SOURCE("OnUserOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Useropped nickname"),
+	    "$3 = Useropped nickname", 0, -1),
 
 	/*
 		@doc: ondeuserop
@@ -2948,11 +2950,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onuserop]OnUserOp[/event]
 	*/
 
-	EVENT("OnDeUserOp",
+	EVENT_WITH_SOURCE("OnDeUserOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Deuseropped nickname"),
+	    "$3 = Deuseropped nickname", 0, -1),
 
 	/*
 		@doc: onmeuserop
@@ -2974,10 +2976,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedeuserop]OnMeDeUserOp[/event]
 	*/
 
-	EVENT("OnMeUserOp",
+	EVENT_WITH_SOURCE("OnMeUserOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedeuserop
@@ -2999,10 +3001,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeuserop]OnMeUserOp[/event]
 	*/
 
-	EVENT("OnMeDeUserOp",
+	EVENT_WITH_SOURCE("OnMeDeUserOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onircop
@@ -3025,11 +3027,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:ondeircop]OnDeIrcOp[/event]
 	*/
 
-	EVENT("OnIrcOp",
+	EVENT_WITH_SOURCE("OnIrcOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ircopped nickname"),
+	    "$3 = Ircopped nickname", 0, -1),
 
 	/*
 		@doc: ondeircop
@@ -3052,11 +3054,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onircop]OnIrcOp[/event]
 	*/
 
-	EVENT("OnDeIrcOp",
+	EVENT_WITH_SOURCE("OnDeIrcOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Deircopped nickname"),
+	    "$3 = Deircopped nickname", 0, -1),
 
 	/*
 		@doc: onmeircop
@@ -3078,10 +3080,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmedeircop]OnMeDeIrcOp[/event]
 	*/
 
-	EVENT("OnMeIrcOp",
+	EVENT_WITH_SOURCE("OnMeIrcOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	/*
 		@doc: onmedeircop
@@ -3103,10 +3105,10 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmeircop]OnMeIrcOp[/event]
 	*/
 
-	EVENT("OnMeDeIrcOp",
+	EVENT_WITH_SOURCE("OnMeDeIrcOp",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
-	    "$2 = Source hostname"),
+	    "$2 = Source hostname", 0, -1),
 
 	// Services
 	/*
@@ -3135,12 +3137,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmemoservnotice]OnMemoServNotice[/event]
 	*/
 
-	EVENT("OnChanServNotice",
+	EVENT_WITH_SOURCE("OnChanServNotice",
 	    "$0 = ChanServ nickname\n"
 	    "$1 = ChanServ username\n"
 	    "$2 = ChanServ hostname\n"
 	    "$3 = Message\n"
-	    "$4 = Message tags"),
+	    "$4 = Message tags", 0, 3),
 
 	/*
 		@doc: onnickservnotice
@@ -3169,12 +3171,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmemoservnotice]OnMemoServNotice[/event]
 	*/
 
-	EVENT("OnNickServNotice",
+	EVENT_WITH_SOURCE("OnNickServNotice",
 	    "$0 = NickServ nickname\n"
 	    "$1 = NickServ username\n"
 	    "$2 = NickServ hostname\n"
 	    "$3 = Message\n"
-	    "$4 = Message tags"),
+	    "$4 = Message tags", 0, 3),
 
 	/*
 		@doc: OnNickServAuth
@@ -3227,14 +3229,14 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			Calling [cmd]halt[/cmd] in this event stops the message output.[br]
 	*/
 
-	EVENT("OnAction",
+	EVENT_WITH_SOURCE("OnAction",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Message target\n"
 	    "$4 = Action message text\n"
 	    "$5 = Message tags\n"
-	    "$6 = Was encrypted"),
+	    "$6 = Was encrypted", 0, 4),
 
 	/*
 		@doc: onmeaction
@@ -3262,9 +3264,9 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[/example]
 	*/
 
-	EVENT("OnMeAction",
+	EVENT_WITH_SOURCE("OnMeAction",
 	    "$0 = Action message text\n"
-	    "$1 = Action target"),
+	    "$1 = Action target", -1, 0),
 
 	/*
 		@doc: onctcprequest
@@ -3291,13 +3293,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onctcpreply]OnCTCPReply[/event]
 	*/
 
-	EVENT("OnCTCPRequest",
+	EVENT_WITH_SOURCE("OnCTCPRequest",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Target\n"
 	    "$4 = CTCP type\n"
-	    "$5- = CTCP parameters"),
+	    "$5- = CTCP parameters", 0, -1),
 
 	/*
 		@doc: onctcpreply
@@ -3324,13 +3326,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onctcpreply]OnCTCPReply[/event]
 	*/
 
-	EVENT("OnCTCPReply",
+	EVENT_WITH_SOURCE("OnCTCPReply",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Target\n"
 	    "$4 = CTCP type\n"
-	    "$5- = CTCP parameters"),
+	    "$5- = CTCP parameters", 0, -1),
 
 	/*
 		@doc: onctcpflood
@@ -3356,13 +3358,13 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onctcpreply]OnCTCPReply[/event]
 	*/
 
-	EVENT("OnCTCPFlood",
+	EVENT_WITH_SOURCE("OnCTCPFlood",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Target\n"
 	    "$4 = CTCP type\n"
-	    "$5- = CTCP parameters"),
+	    "$5- = CTCP parameters", 0, -1),
 
 	/*
 		@doc: ondccsessioncreated
@@ -3502,9 +3504,9 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 		@seealso:
 	*/
 
-	EVENT("OnDCCChatMessage",
+	EVENT_WITH_SOURCE("OnDCCChatMessage",
 	    "$0 = Message text\n"
-	    "$1 = DCC session ID"),
+	    "$1 = DCC session ID", -1, 0),
 
 	/*
 		@doc: ondccchaterror
@@ -3756,8 +3758,8 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			It will be triggered only at the left mouse button click
 	*/
 
-	EVENT("OnConsoleNickLinkClick",
-	    "$0 = Nickname"),
+	EVENT_WITH_SOURCE("OnConsoleNickLinkClick",
+	    "$0 = Nickname", 0, -1),
 
 	/*
 		@doc: OnHostLinkClick
@@ -4019,12 +4021,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onchanservnotice]OnChanServNotice[/event]
 	*/
 
-	EVENT("OnMemoServNotice",
+	EVENT_WITH_SOURCE("OnMemoServNotice",
 	    "$0 = MemoServ nickname\n"
 	    "$1 = MemoServ username\n"
 	    "$2 = MemoServ hostname\n"
 	    "$3 = Message\n"
-	    "$4 = Message tags"),
+	    "$4 = Message tags", 0, 3),
 
 	/*
 		@doc: onbroadcastnotice
@@ -4050,12 +4052,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onservernotice]OnServerNotice[/event]
 	*/
 
-	EVENT("OnBroadcastNotice",
+	EVENT_WITH_SOURCE("OnBroadcastNotice",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
 	    "$3 = Target\n"
-	    "$4 = Message"),
+	    "$4 = Message", 0, 4),
 
 	/*
 		@doc: onquietban
@@ -4078,11 +4080,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onquietunban]OnQuietUnban[/event]
 	*/
 
-	EVENT("OnQuietBan",
+	EVENT_WITH_SOURCE("OnQuietBan",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onquietunban
@@ -4105,11 +4107,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onquietban]OnQuietBan[/event]
 	*/
 
-	EVENT("OnQuietUnban",
+	EVENT_WITH_SOURCE("OnQuietUnban",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onmequietban
@@ -4132,11 +4134,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmequietunban]OnMeQuietUnban[/event]
 	*/
 
-	EVENT("OnMeQuietBan",
+	EVENT_WITH_SOURCE("OnMeQuietBan",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onmequietunban
@@ -4159,11 +4161,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmequietban]OnMeQuietBan[/event]
 	*/
 
-	EVENT("OnMeQuietUnban",
+	EVENT_WITH_SOURCE("OnMeQuietUnban",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Ban mask"),
+	    "$3 = Ban mask", 0, -1),
 
 	/*
 		@doc: onmehostchange
@@ -4210,12 +4212,12 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			[event:onmehostchange]OnMeHostChange[/event]
 	*/
 
-	EVENT("OnHostChange",
+	EVENT_WITH_SOURCE("OnHostChange",
 	    "$0 = Source nickname\n"
 	    "$1 = Source old username\n"
 	    "$2 = Source old hostname\n"
 	    "$3 = Source new username\n"
-	    "$4 = Source new hostname"),
+	    "$4 = Source new hostname", 0, -1),
 
 	/*
 		@doc: onaccount
@@ -4238,11 +4240,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			CAP ACCOUNT-NOTIFY support from the server.
 	*/
 
-	EVENT("OnAccount",
+	EVENT_WITH_SOURCE("OnAccount",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Source account name"),
+	    "$3 = Source account name", 0, -1),
 
 	/*
 		@doc: onaway
@@ -4267,11 +4269,11 @@ KviKvsEvent KviKvsEventManager::m_appEventTable[KVI_KVS_NUM_APP_EVENTS] = {
 			CAP AWAY-NOTIFY support from the server.
 	*/
 
-	EVENT("OnAway",
+	EVENT_WITH_SOURCE("OnAway",
 	    "$0 = Source nickname\n"
 	    "$1 = Source username\n"
 	    "$2 = Source hostname\n"
-	    "$3 = Away message"),
+	    "$3 = Away message", 0, 3),
 
 	/*
 		@doc: oncap
@@ -45,196 +45,244 @@
 //
 
 // These two allow reusing the parameter lists (but may require more code)
-#define KVS_TRIGGER_EVENT(__idx, __wnd, __parms)              \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx)) \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, __parms);
+#define KVS_TRIGGER_EVENT(__idx, __wnd, __parms)                                 \
+	{                                                                            \
+		KviWindow * _pEventWnd = (__wnd);                                        \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))    \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, __parms); \
+	}
 
-#define KVS_TRIGGER_EVENT_HALTED(__idx, __wnd, __parms) \
-	(KviKvsEventManager::instance()->hasAppHandlers(__idx) ? KviKvsEventManager::instance()->trigger(__idx, __wnd, __parms) : false)
+#define KVS_TRIGGER_EVENT_HALTED(__idx, __wnd, __parms)                             \
+	([&]() -> bool {                                                                \
+		KviWindow * _pEventWnd = (__wnd);                                           \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))      \
+			return false;                                                           \
+		return KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, __parms); \
+	}())
 
 // These require less code (but param lists can't be reused)
-#define KVS_TRIGGER_EVENT_0(__idx, __wnd)                                         \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                     \
-	{                                                                             \
-		KviKvsVariantList _vLocalParamList;                                       \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList); \
+#define KVS_TRIGGER_EVENT_0(__idx, __wnd)                                                  \
+	{                                                                                      \
+		KviWindow * _pEventWnd = (__wnd);                                                  \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))              \
+		{                                                                                  \
+			KviKvsVariantList _vLocalParamList;                                            \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList); \
+		}                                                                                  \
 	}
 
-#define KVS_TRIGGER_EVENT_1(__idx, __wnd, __param1)                               \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                     \
-	{                                                                             \
-		KviKvsVariantList _vLocalParamList(                                       \
-		    new KviKvsVariant(__param1));                                         \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList); \
+#define KVS_TRIGGER_EVENT_1(__idx, __wnd, __param1)                                        \
+	{                                                                                      \
+		KviWindow * _pEventWnd = (__wnd);                                                  \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))              \
+		{                                                                                  \
+			KviKvsVariantList _vLocalParamList(                                            \
+			    new KviKvsVariant(__param1));                                              \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList); \
+		}                                                                                  \
 	}
 
-#define KVS_TRIGGER_EVENT_2(__idx, __wnd, __param1, __param2)                     \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                     \
-	{                                                                             \
-		KviKvsVariantList _vLocalParamList(                                       \
-		    new KviKvsVariant(__param1),                                          \
-		    new KviKvsVariant(__param2));                                         \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList); \
+#define KVS_TRIGGER_EVENT_2(__idx, __wnd, __param1, __param2)                              \
+	{                                                                                      \
+		KviWindow * _pEventWnd = (__wnd);                                                  \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))              \
+		{                                                                                  \
+			KviKvsVariantList _vLocalParamList(                                            \
+			    new KviKvsVariant(__param1),                                               \
+			    new KviKvsVariant(__param2));                                              \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList); \
+		}                                                                                  \
 	}
 
-#define KVS_TRIGGER_EVENT_3(__idx, __wnd, __param1, __param2, __param3)           \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                     \
-	{                                                                             \
-		KviKvsVariantList _vLocalParamList(                                       \
-		    new KviKvsVariant(__param1),                                          \
-		    new KviKvsVariant(__param2),                                          \
-		    new KviKvsVariant(__param3));                                         \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList); \
+#define KVS_TRIGGER_EVENT_3(__idx, __wnd, __param1, __param2, __param3)                    \
+	{                                                                                      \
+		KviWindow * _pEventWnd = (__wnd);                                                  \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))              \
+		{                                                                                  \
+			KviKvsVariantList _vLocalParamList(                                            \
+			    new KviKvsVariant(__param1),                                               \
+			    new KviKvsVariant(__param2),                                               \
+			    new KviKvsVariant(__param3));                                              \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList); \
+		}                                                                                  \
 	}
 
-#define KVS_TRIGGER_EVENT_4(__idx, __wnd, __param1, __param2, __param3, __param4) \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                     \
-	{                                                                             \
-		KviKvsVariantList _vLocalParamList(                                       \
-		    new KviKvsVariant(__param1),                                          \
-		    new KviKvsVariant(__param2),                                          \
-		    new KviKvsVariant(__param3),                                          \
-		    new KviKvsVariant(__param4));                                         \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList); \
+#define KVS_TRIGGER_EVENT_4(__idx, __wnd, __param1, __param2, __param3, __param4)          \
+	{                                                                                      \
+		KviWindow * _pEventWnd = (__wnd);                                                  \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))              \
+		{                                                                                  \
+			KviKvsVariantList _vLocalParamList(                                            \
+			    new KviKvsVariant(__param1),                                               \
+			    new KviKvsVariant(__param2),                                               \
+			    new KviKvsVariant(__param3),                                               \
+			    new KviKvsVariant(__param4));                                              \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList); \
+		}                                                                                  \
 	}
 
 #define KVS_TRIGGER_EVENT_5(__idx, __wnd, __param1, __param2, __param3, __param4, __param5) \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                               \
 	{                                                                                       \
-		KviKvsVariantList _vLocalParamList(                                                 \
-		    new KviKvsVariant(__param1),                                                    \
-		    new KviKvsVariant(__param2),                                                    \
-		    new KviKvsVariant(__param3),                                                    \
-		    new KviKvsVariant(__param4),                                                    \
-		    new KviKvsVariant(__param5));                                                   \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList);           \
+		KviWindow * _pEventWnd = (__wnd);                                                   \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))               \
+		{                                                                                   \
+			KviKvsVariantList _vLocalParamList(                                             \
+			    new KviKvsVariant(__param1),                                                \
+			    new KviKvsVariant(__param2),                                                \
+			    new KviKvsVariant(__param3),                                                \
+			    new KviKvsVariant(__param4),                                                \
+			    new KviKvsVariant(__param5));                                               \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList);  \
+		}                                                                                   \
 	}
 
 #define KVS_TRIGGER_EVENT_6(__idx, __wnd, __param1, __param2, __param3, __param4, __param5, __param6) \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                                         \
 	{                                                                                                 \
-		KviKvsVariantList _vLocalParamList(                                                           \
-		    new KviKvsVariant(__param1),                                                              \
-		    new KviKvsVariant(__param2),                                                              \
-		    new KviKvsVariant(__param3),                                                              \
-		    new KviKvsVariant(__param4),                                                              \
-		    new KviKvsVariant(__param5),                                                              \
-		    new KviKvsVariant(__param6));                                                             \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList);                     \
+		KviWindow * _pEventWnd = (__wnd);                                                             \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))                         \
+		{                                                                                             \
+			KviKvsVariantList _vLocalParamList(                                                       \
+			    new KviKvsVariant(__param1),                                                          \
+			    new KviKvsVariant(__param2),                                                          \
+			    new KviKvsVariant(__param3),                                                          \
+			    new KviKvsVariant(__param4),                                                          \
+			    new KviKvsVariant(__param5),                                                          \
+			    new KviKvsVariant(__param6));                                                         \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList);            \
+		}                                                                                             \
 	}
 
 #define KVS_TRIGGER_EVENT_7(__idx, __wnd, __param1, __param2, __param3, __param4, __param5, __param6, __param7) \
-	if(KviKvsEventManager::instance()->hasAppHandlers(__idx))                                                   \
 	{                                                                                                           \
-		KviKvsVariantList _vLocalParamList(                                                                     \
-		    new KviKvsVariant(__param1),                                                                        \
-		    new KviKvsVariant(__param2),                                                                        \
-		    new KviKvsVariant(__param3),                                                                        \
-		    new KviKvsVariant(__param4),                                                                        \
-		    new KviKvsVariant(__param5),                                                                        \
-		    new KviKvsVariant(__param6),                                                                        \
-		    new KviKvsVariant(__param7));                                                                       \
-		KviKvsEventManager::instance()->trigger(__idx, __wnd, &_vLocalParamList);                               \
+		KviWindow * _pEventWnd = (__wnd);                                                                       \
+		if(KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))                                   \
+		{                                                                                                       \
+			KviKvsVariantList _vLocalParamList(                                                                 \
+			    new KviKvsVariant(__param1),                                                                    \
+			    new KviKvsVariant(__param2),                                                                    \
+			    new KviKvsVariant(__param3),                                                                    \
+			    new KviKvsVariant(__param4),                                                                    \
+			    new KviKvsVariant(__param5),                                                                    \
+			    new KviKvsVariant(__param6),                                                                    \
+			    new KviKvsVariant(__param7));                                                                   \
+			KviKvsEventManager::instance()->trigger(__idx, _pEventWnd, &_vLocalParamList);                      \
+		}                                                                                                       \
 	}
 
-#define KVS_TRIGGER_EVENT_0_HALTED(__idx, __wnd)                   \
-	(                                                              \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)      \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams( \
-	              __idx,                                           \
-	              __wnd,                                           \
-	              new KviKvsVariantList())                         \
-	        : false)
-
-#define KVS_TRIGGER_EVENT_1_HALTED(__idx, __wnd, __param1)         \
-	(                                                              \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)      \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams( \
-	              __idx,                                           \
-	              __wnd,                                           \
-	              new KviKvsVariantList(                           \
-	                  new KviKvsVariant(__param1)))                \
-	        : false)
-
-#define KVS_TRIGGER_EVENT_2_HALTED(__idx, __wnd, __param1, __param2) \
-	(                                                                \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)        \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(   \
-	              __idx,                                             \
-	              __wnd,                                             \
-	              new KviKvsVariantList(                             \
-	                  new KviKvsVariant(__param1),                   \
-	                  new KviKvsVariant(__param2)))                  \
-	        : false)
+#define KVS_TRIGGER_EVENT_0_HALTED(__idx, __wnd)                               \
+	([&]() -> bool {                                                           \
+		KviWindow * _pEventWnd = (__wnd);                                      \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd)) \
+			return false;                                                      \
+		return KviKvsEventManager::instance()->triggerDeleteParams(            \
+		    __idx,                                                             \
+		    _pEventWnd,                                                        \
+		    new KviKvsVariantList());                                          \
+	}())
+
+#define KVS_TRIGGER_EVENT_1_HALTED(__idx, __wnd, __param1)                     \
+	([&]() -> bool {                                                           \
+		KviWindow * _pEventWnd = (__wnd);                                      \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd)) \
+			return false;                                                      \
+		return KviKvsEventManager::instance()->triggerDeleteParams(            \
+		    __idx,                                                             \
+		    _pEventWnd,                                                        \
+		    new KviKvsVariantList(                                             \
+		        new KviKvsVariant(__param1)));                                 \
+	}())
+
+#define KVS_TRIGGER_EVENT_2_HALTED(__idx, __wnd, __param1, __param2)           \
+	([&]() -> bool {                                                           \
+		KviWindow * _pEventWnd = (__wnd);                                      \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd)) \
+			return false;                                                      \
+		return KviKvsEventManager::instance()->triggerDeleteParams(            \
+		    __idx,                                                             \
+		    _pEventWnd,                                                        \
+		    new KviKvsVariantList(                                             \
+		        new KviKvsVariant(__param1),                                   \
+		        new KviKvsVariant(__param2)));                                 \
+	}())
 
 #define KVS_TRIGGER_EVENT_3_HALTED(__idx, __wnd, __param1, __param2, __param3) \
-	(                                                                          \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)                  \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(             \
-	              __idx,                                                       \
-	              __wnd,                                                       \
-	              new KviKvsVariantList(                                       \
-	                  new KviKvsVariant(__param1),                             \
-	                  new KviKvsVariant(__param2),                             \
-	                  new KviKvsVariant(__param3)))                            \
-	        : false)
+	([&]() -> bool {                                                           \
+		KviWindow * _pEventWnd = (__wnd);                                      \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd)) \
+			return false;                                                      \
+		return KviKvsEventManager::instance()->triggerDeleteParams(            \
+		    __idx,                                                             \
+		    _pEventWnd,                                                        \
+		    new KviKvsVariantList(                                             \
+		        new KviKvsVariant(__param1),                                   \
+		        new KviKvsVariant(__param2),                                   \
+		        new KviKvsVariant(__param3)));                                 \
+	}())
 
 #define KVS_TRIGGER_EVENT_4_HALTED(__idx, __wnd, __param1, __param2, __param3, __param4) \
-	(                                                                                    \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)                            \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(                       \
-	              __idx,                                                                 \
-	              __wnd,                                                                 \
-	              new KviKvsVariantList(                                                 \
-	                  new KviKvsVariant(__param1),                                       \
-	                  new KviKvsVariant(__param2),                                       \
-	                  new KviKvsVariant(__param3),                                       \
-	                  new KviKvsVariant(__param4)))                                      \
-	        : false)
+	([&]() -> bool {                                                                     \
+		KviWindow * _pEventWnd = (__wnd);                                                \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))           \
+			return false;                                                                \
+		return KviKvsEventManager::instance()->triggerDeleteParams(                      \
+		    __idx,                                                                       \
+		    _pEventWnd,                                                                  \
+		    new KviKvsVariantList(                                                       \
+		        new KviKvsVariant(__param1),                                             \
+		        new KviKvsVariant(__param2),                                             \
+		        new KviKvsVariant(__param3),                                             \
+		        new KviKvsVariant(__param4)));                                           \
+	}())
 
 #define KVS_TRIGGER_EVENT_5_HALTED(__idx, __wnd, __param1, __param2, __param3, __param4, __param5) \
-	(                                                                                              \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)                                      \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(                                 \
-	              __idx,                                                                           \
-	              __wnd,                                                                           \
-	              new KviKvsVariantList(                                                           \
-	                  new KviKvsVariant(__param1),                                                 \
-	                  new KviKvsVariant(__param2),                                                 \
-	                  new KviKvsVariant(__param3),                                                 \
-	                  new KviKvsVariant(__param4),                                                 \
-	                  new KviKvsVariant(__param5)))                                                \
-	        : false)
+	([&]() -> bool {                                                                               \
+		KviWindow * _pEventWnd = (__wnd);                                                          \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))                     \
+			return false;                                                                          \
+		return KviKvsEventManager::instance()->triggerDeleteParams(                                \
+		    __idx,                                                                                 \
+		    _pEventWnd,                                                                            \
+		    new KviKvsVariantList(                                                                 \
+		        new KviKvsVariant(__param1),                                                       \
+		        new KviKvsVariant(__param2),                                                       \
+		        new KviKvsVariant(__param3),                                                       \
+		        new KviKvsVariant(__param4),                                                       \
+		        new KviKvsVariant(__param5)));                                                     \
+	}())
 
 #define KVS_TRIGGER_EVENT_6_HALTED(__idx, __wnd, __param1, __param2, __param3, __param4, __param5, __param6) \
-	(                                                                                                        \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)                                                \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(                                           \
-	              __idx,                                                                                     \
-	              __wnd,                                                                                     \
-	              new KviKvsVariantList(                                                                     \
-	                  new KviKvsVariant(__param1),                                                           \
-	                  new KviKvsVariant(__param2),                                                           \
-	                  new KviKvsVariant(__param3),                                                           \
-	                  new KviKvsVariant(__param4),                                                           \
-	                  new KviKvsVariant(__param5),                                                           \
-	                  new KviKvsVariant(__param6)))                                                          \
-	        : false)
+	([&]() -> bool {                                                                                         \
+		KviWindow * _pEventWnd = (__wnd);                                                                    \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))                               \
+			return false;                                                                                    \
+		return KviKvsEventManager::instance()->triggerDeleteParams(                                          \
+		    __idx,                                                                                           \
+		    _pEventWnd,                                                                                      \
+		    new KviKvsVariantList(                                                                           \
+		        new KviKvsVariant(__param1),                                                                 \
+		        new KviKvsVariant(__param2),                                                                 \
+		        new KviKvsVariant(__param3),                                                                 \
+		        new KviKvsVariant(__param4),                                                                 \
+		        new KviKvsVariant(__param5),                                                                 \
+		        new KviKvsVariant(__param6)));                                                               \
+	}())
 
 #define KVS_TRIGGER_EVENT_7_HALTED(__idx, __wnd, __param1, __param2, __param3, __param4, __param5, __param6, __param7) \
-	(                                                                                                                  \
-	    KviKvsEventManager::instance()->hasAppHandlers(__idx)                                                          \
-	        ? KviKvsEventManager::instance()->triggerDeleteParams(                                                     \
-	              __idx,                                                                                               \
-	              __wnd,                                                                                               \
-	              new KviKvsVariantList(                                                                               \
-	                  new KviKvsVariant(__param1),                                                                     \
-	                  new KviKvsVariant(__param2),                                                                     \
-	                  new KviKvsVariant(__param3),                                                                     \
-	                  new KviKvsVariant(__param4),                                                                     \
-	                  new KviKvsVariant(__param5),                                                                     \
-	                  new KviKvsVariant(__param6),                                                                     \
-	                  new KviKvsVariant(__param7)))                                                                    \
-	        : false)
+	([&]() -> bool {                                                                                                   \
+		KviWindow * _pEventWnd = (__wnd);                                                                              \
+		if(!KviKvsEventManager::instance()->hasAppHandlers(__idx, _pEventWnd))                                         \
+			return false;                                                                                              \
+		return KviKvsEventManager::instance()->triggerDeleteParams(                                                    \
+		    __idx,                                                                                                     \
+		    _pEventWnd,                                                                                                \
+		    new KviKvsVariantList(                                                                                     \
+		        new KviKvsVariant(__param1),                                                                           \
+		        new KviKvsVariant(__param2),                                                                           \
+		        new KviKvsVariant(__param3),                                                                           \
+		        new KviKvsVariant(__param4),                                                                           \
+		        new KviKvsVariant(__param5),                                                                           \
+		        new KviKvsVariant(__param6),                                                                           \
+		        new KviKvsVariant(__param7)));                                                                         \
+	}())
 
 #endif //!_KVI_KVS_EVENTTRIGGERS_H_
@@ -1653,6 +1653,23 @@ KviKvsObjectFunctionHandler * KviKvsObject::lookupFunctionHandler(const QString
 	return h;
 }
 
+KviKvsObjectFunctionHandler * KviKvsObject::lookupFunctionHandler(const KviKvsAtom & atomFuncName, const QString & classOverride)
+{
+	KviKvsObjectFunctionHandler * h = nullptr;
+
+	if(classOverride.isEmpty() && m_pFunctionHandlers)
+		h = atomFuncName.find(m_pFunctionHandlers);
+
+	if(!h)
+	{
+		KviKvsObjectClass * cl = getClass(classOverride);
+		if(cl)
+			return cl->lookupFunctionHandler(atomFuncName);
+	}
+
+	return h;
+}
+
 bool KviKvsObject::die()
 {
 	if(m_bAboutToDie)
@@ -1746,8 +1763,18 @@ bool KviKvsObject::callFunction(
     KviKvsVariant * pRetVal,
     KviKvsVariantList * pParams)
 {
-	KviKvsObjectFunctionHandler * h = lookupFunctionHandler(fncName, classOverride);
+	return callFunctionHandler(pCaller, lookupFunctionHandler(fncName, classOverride), fncName, classOverride, pContext, pRetVal, pParams);
+}
 
+bool KviKvsObject::callFunctionHandler(
+    KviKvsObject * pCaller,
+    KviKvsObjectFunctionHandler * h,
+    const QString & fncName,
+    const QString & classOverride,
+    KviKvsRunTimeContext * pContext,
+    KviKvsVariant * pRetVal,
+    KviKvsVariantList * pParams)
+{
 	if(!h)
 	{
 		if(classOverride.isEmpty())
@@ -31,6 +31,7 @@
 #include "KviKvsParameterProcessor.h"
 #include "KviKvsObjectFunctionHandler.h"
 #include "KviKvsTypes.h"
+#include "KviKvsAtom.h"
 
 #include <QObject>
 
@@ -128,6 +129,9 @@ public:
 	bool inheritsClass(const QString & szClass);
 
 	KviKvsObjectFunctionHandler * lookupFunctionHandler(const QString & funcName, const QString & classOverride = QString());
+	KviKvsObjectFunctionHandler * lookupFunctionHandler(const KviKvsAtom & atomFuncName, const QString & classOverride = QString());
+	// true if this object has per-instance function implementations that shadow the class ones
+	bool hasPrivateImplementations() { return m_pFunctionHandlers; }
 
 	// Registers a private implementation of a function
 	// The function may or may not be already registered in the class
@@ -143,6 +147,15 @@ public:
 	    KviKvsRunTimeContext * pContext, // calling runtime context (you'll have problems with instantiating this... :P )
 	    KviKvsVariant * pRetVal,         // the return value
 	    KviKvsVariantList * pParams);    // the parameters for the call
+	// same as above but with the handler already looked up (h may be zero, in that case an error is reported)
+	bool callFunctionHandler(
+	    KviKvsObject * pCaller,
+	    KviKvsObjectFunctionHandler * h,
+	    const QString & fncName,
+	    const QString & classOverride,
+	    KviKvsRunTimeContext * pContext,
+	    KviKvsVariant * pRetVal,
+	    KviKvsVariantList * pParams);
 	// a nice and simple wrapper: it accepts a parameter list only (eventually 0)
 	bool callFunction(KviKvsObject * pCaller, const QString & fncName, KviKvsVariantList * pParams = 0);
 	// this one gets a non null ret val too
@@ -36,6 +36,8 @@
 #include "KviCommandFormatter.h"
 #include "KviLocale.h"
 
+unsigned int KviKvsObjectClass::m_uHandlersGeneration = 0;
+
 KviKvsObjectClass::KviKvsObjectClass(
     KviKvsObjectClass * pParent,
     const QString & szName,
@@ -72,6 +74,8 @@ KviKvsObjectClass::KviKvsObjectClass(
 
 	// "object" class is automatically registered in the controller constructor
 	KviKvsKernel::instance()->objectController()->registerClass(this);
+	// a new class might reuse the address of a dead one
+	invalidateLookupCaches();
 }
 
 KviKvsObjectClass::~KviKvsObjectClass()
@@ -93,6 +97,7 @@ KviKvsObjectClass::~KviKvsObjectClass()
 	// unregister from the object controller
 	KviKvsKernel::instance()->objectController()->unregisterClass(this);
 	// and start effectively dying
+	invalidateLookupCaches();
 	delete m_pFunctionHandlers;
 	// this is empty now
 	delete m_pChildClasses;
@@ -101,6 +106,7 @@ KviKvsObjectClass::~KviKvsObjectClass()
 void KviKvsObjectClass::registerFunctionHandler(const QString & szFunctionName, KviKvsObjectFunctionHandlerProc pProc, unsigned int uFlags)
 {
 	m_pFunctionHandlers->replace(szFunctionName, new KviKvsObjectCoreCallFunctionHandler(pProc, uFlags));
+	invalidateLookupCaches();
 }
 
 void KviKvsObjectClass::registerFunctionHandler(const QString & szFunctionName, const QString & szBuffer, const QString & szReminder, unsigned int uFlags)
@@ -109,21 +115,25 @@ void KviKvsObjectClass::registerFunctionHandler(const QString & szFunctionName,
 	szContext += "::";
 	szContext += szFunctionName;
 	m_pFunctionHandlers->replace(szFunctionName, new KviKvsObjectScriptFunctionHandler(szContext, szBuffer, szReminder, uFlags));
+	invalidateLookupCaches();
 }
 
 void KviKvsObjectClass::registerStandardNothingReturnFunctionHandler(const QString & szFunctionName)
 {
 	m_pFunctionHandlers->replace(szFunctionName, new KviKvsObjectStandardNothingReturnFunctionHandler());
+	invalidateLookupCaches();
 }
 
 void KviKvsObjectClass::registerStandardTrueReturnFunctionHandler(const QString & szFunctionName)
 {
 	m_pFunctionHandlers->replace(szFunctionName, new KviKvsObjectStandardTrueReturnFunctionHandler());
+	invalidateLookupCaches();
 }
 
 void KviKvsObjectClass::registerStandardFalseReturnFunctionHandler(const QString & szFunctionName)
 {
 	m_pFunctionHandlers->replace(szFunctionName, new KviKvsObjectStandardFalseReturnFunctionHandler());
+	invalidateLookupCaches();
 }
 
 KviKvsObject * KviKvsObjectClass::allocateInstance(KviKvsObject * pParent, const QString & szName, KviKvsRunTimeContext * pContext, KviKvsVariantList * pParams)
@@ -31,6 +31,7 @@
 #include "KviPointerHashTable.h"
 
 #include "KviKvsObjectFunctionHandler.h"
+#include "KviKvsAtom.h"
 
 class KviKvsObject;
 class KviKvsObjectClass;
@@ -68,11 +69,16 @@ protected:
 	KviPointerList<KviKvsObjectClass> * m_pChildClasses;                             //
 	KviKvsObjectAllocateInstanceProc m_allocProc;
 	bool m_bDirty; // not yet flushed to disk (only for not builtin classes)
+	static unsigned int m_uHandlersGeneration; // bumped when any class or function handler is created or destroyed
 protected:
 	void registerChildClass(KviKvsObjectClass * pClass);
 	void unregisterChildClass(KviKvsObjectClass * pClass);
 	KviPointerHashTable<QString, KviKvsObjectFunctionHandler> * functionHandlers() { return m_pFunctionHandlers; };
+	static void invalidateLookupCaches() { m_uHandlersGeneration++; };
+
 public:
+	// the call sites cache the resolved handlers: they are valid as long as this doesn't change
+	static unsigned int handlersGeneration() { return m_uHandlersGeneration; };
 	void clearDirtyFlag() { m_bDirty = false; };
 	bool isDirty() { return m_bDirty; };
 	bool isBuiltin() { return m_bBuiltin; };
@@ -101,6 +107,7 @@ public:
 	void registerStandardFalseReturnFunctionHandler(const QString & szFunc);
 
 	KviKvsObjectFunctionHandler * lookupFunctionHandler(const QString & szFunc) { return m_pFunctionHandlers->find(szFunc); };
+	KviKvsObjectFunctionHandler * lookupFunctionHandler(const KviKvsAtom & atomFunc) { return atomFunc.find(m_pFunctionHandlers); };
 	KviKvsObject * allocateInstance(KviKvsObject * pParent, const QString & szName, KviKvsRunTimeContext * pContext, KviKvsVariantList * pParams);
 
 	bool save(const QString & szFileName);
@@ -38,6 +38,7 @@ KviKvsParser::KviKvsParser(KviKvsScript * pScript, KviWindow * pOutputWindow)
 	// no need to initialize m_pBuffer
 	// no need to initialize m_ptr
 	// no need to initialize m_bError
+	// no need to initialize m_bWarning
 	m_pGlobals = nullptr;
 	m_pScript = pScript;
 	m_pWindow = pOutputWindow;
@@ -129,6 +130,8 @@ void KviKvsParser::error(const QChar * pLocation, QString szMsgFmt, ...)
 
 void KviKvsParser::warning(const QChar * pLocation, QString szMsgFmt, ...)
 {
+	m_bWarning = true;
+
 	kvi_va_list va;
 	kvi_va_start(va, szMsgFmt);
 	report(false, pLocation, szMsgFmt, va);
@@ -140,6 +143,7 @@ KviKvsTreeNodeInstruction * KviKvsParser::parse(const QChar * pBuffer, int iFlag
 	m_iFlags = iFlags;
 
 	m_bError = false;
+	m_bWarning = false;
 	if(m_pGlobals)
 		m_pGlobals->clear(); // this shouldn't be needed since this is a one time parser
 
@@ -159,6 +163,7 @@ KviKvsTreeNodeInstruction * KviKvsParser::parseAsExpression(const QChar * pBuffe
 	m_iFlags = iFlags;
 
 	m_bError = false;
+	m_bWarning = false;
 	if(m_pGlobals)
 		m_pGlobals->clear(); // this shouldn't be needed since this is a one time parser
 
@@ -182,6 +187,7 @@ KviKvsTreeNodeInstruction * KviKvsParser::parseAsParameter(const QChar * pBuffer
 	m_iFlags = iFlags;
 
 	m_bError = false;
+	m_bWarning = false;
 	if(m_pGlobals)
 		m_pGlobals->clear(); // this shouldn't be needed since this is a one time parser
 
@@ -66,6 +66,7 @@ private:
 	KviPointerHashTable<QString, QString> * m_pGlobals; // the dict of the vars declared with global in this script
 	int m_iFlags;                                       // the current parsing flags
 	bool m_bError;                                      // error(..) was called ?
+	bool m_bWarning;                                    // warning(..) was called ?
 	// this stuff is used only for reporting errors and warnings
 	KviKvsScript * m_pScript; // parent script
 	KviWindow * m_pWindow;    // output window
@@ -77,6 +78,8 @@ public:                       // public interface
 	};
 	// was there an error ?
 	bool error() const { return m_bError; };
+	// were there warnings ? (they are printed only when parsing)
+	bool hasWarnings() const { return m_bWarning; };
 	// parses the buffer pointed by pBuffer and returns
 	// a syntax tree or 0 in case of failure
 	// if the parsing fails, the error code can be retrieved by calling error()
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeAliasFunctionCall.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsVariantList.h"
 #include "KviKvsAliasManager.h"
 #include "KviLocale.h"
@@ -48,6 +49,14 @@ void KviKvsTreeNodeAliasFunctionCall::dump(const char * prefix)
 	m_pParams->dump(szTmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeAliasFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::AliasFunctionCall, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szFunctionName);
+	return w->writeChild(m_pParams);
+}
+
 bool KviKvsTreeNodeAliasFunctionCall::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariantList l;
@@ -56,7 +65,7 @@ bool KviKvsTreeNodeAliasFunctionCall::evaluateReadOnly(KviKvsRunTimeContext * c,
 
 	pBuffer->setNothing();
 
-	const KviKvsScript * s = KviKvsAliasManager::instance()->lookup(m_szFunctionName);
+	const KviKvsScript * s = KviKvsAliasManager::instance()->lookup(m_atomFunctionName);
 	if(!s)
 	{
 		c->error(this, __tr2qs_ctx("Call to undefined function '%Q'", "kvs"), &m_szFunctionName);
@@ -66,6 +66,13 @@ public:
 	*/
 	virtual void dump(const char * prefix);
 
+	/**
+	* \brief Serializes the node
+	* \param w The writer
+	* \return bool
+	*/
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
+
 	/**
 	* \brief Sets the buffer as Alias Function Call
 	* \param szBuffer The buffer :)
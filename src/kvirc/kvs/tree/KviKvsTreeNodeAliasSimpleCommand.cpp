@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeAliasSimpleCommand.h"
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsAliasManager.h"
 #include "KviLocale.h"
 #include "KviOptions.h"
@@ -55,6 +56,16 @@ void KviKvsTreeNodeAliasSimpleCommand::dump(const char * prefix)
 	dumpParameterList(prefix);
 }
 
+bool KviKvsTreeNodeAliasSimpleCommand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::AliasSimpleCommand, m_pLocation))
+		return false;
+	w->writeString(m_szCmdName);
+	if(!w->writeChild(m_pParams))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeAliasSimpleCommand::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList l;
@@ -68,7 +79,7 @@ bool KviKvsTreeNodeAliasSimpleCommand::execute(KviKvsRunTimeContext * c)
 			return false;
 	}
 
-	const KviKvsScript * s = KviKvsAliasManager::instance()->lookup(m_szCmdName);
+	const KviKvsScript * s = KviKvsAliasManager::instance()->lookup(m_atomCmdName);
 	if(!s)
 	{
 		if(KVI_OPTION_BOOL(KviOption_boolSendUnknownCommandsAsRaw))
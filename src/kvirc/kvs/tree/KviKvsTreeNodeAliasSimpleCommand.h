@@ -73,6 +73,13 @@ public:
 	*/
 	virtual void dump(const char * prefix);
 
+	/**
+	* \brief Serializes the node
+	* \param w The writer
+	* \return bool
+	*/
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
+
 	/**
 	* \brief Evaluates the command
 	* \param c The context where the command is bound to
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeArrayCount.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsVariant.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
@@ -46,6 +47,13 @@ void KviKvsTreeNodeArrayCount::dump(const char * prefix)
 	qDebug("%s ArrayCount", prefix);
 }
 
+bool KviKvsTreeNodeArrayCount::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ArrayCount, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pSource);
+}
+
 bool KviKvsTreeNodeArrayCount::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariant val;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeArrayElement.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 #include "KviKvsArray.h"
@@ -54,6 +55,15 @@ void KviKvsTreeNodeArrayElement::dump(const char * prefix)
 	m_pIndex->dump(szTmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeArrayElement::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ArrayElement, m_pLocation, m_pEndingLocation))
+		return false;
+	if(!w->writeChild(m_pSource))
+		return false;
+	return w->writeChild(m_pIndex);
+}
+
 bool KviKvsTreeNodeArrayElement::evaluateIndex(KviKvsRunTimeContext * c, kvs_int_t & iVal)
 {
 	KviKvsVariant idx;
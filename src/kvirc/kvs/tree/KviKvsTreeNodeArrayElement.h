@@ -77,6 +77,13 @@ public:
 	*/
 	virtual void dump(const char * prefix);
 
+	/**
+	* \brief Serializes the node
+	* \param w The writer
+	* \return bool
+	*/
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
+
 	/**
 	* \brief Evaluates the array element in read-only mode
 	* \param c The context where the alias is bound to
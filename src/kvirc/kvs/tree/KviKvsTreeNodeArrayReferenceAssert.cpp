@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeArrayReferenceAssert.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRWEvaluationResult.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
@@ -52,6 +53,13 @@ void KviKvsTreeNodeArrayReferenceAssert::dump(const char * prefix)
 	qDebug("%s ArrayReferenceAssert", prefix);
 }
 
+bool KviKvsTreeNodeArrayReferenceAssert::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ArrayReferenceAssert, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pSource);
+}
+
 bool KviKvsTreeNodeArrayReferenceAssert::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	if(o)
@@ -29,3 +29,8 @@ KviKvsTreeNode::KviKvsTreeNode(const QChar * pLocation)
 	m_pParent = nullptr;
 	m_pLocation = pLocation;
 }
+
+bool KviKvsTreeNode::serialize(KviKvsTreeNodeWriter *)
+{
+	return false;
+}
@@ -33,6 +33,8 @@
 #include "kvi_settings.h"
 #include "KviQString.h"
 
+class KviKvsTreeNodeWriter;
+
 /**
 * \class KviKvsTreeNode
 * \brief Treenode class
@@ -92,6 +94,17 @@ public:
 	*/
 	virtual void contextDescription(QString & szBuffer) = 0;
 
+	/**
+	* \brief Serializes the node and its children
+	*
+	* The concrete node classes write their type, their fields and their
+	* children so that KviKvsTreeNodeReader can rebuild them.
+	* The default implementation fails: the tree is then not cached
+	* \param w The writer
+	* \return bool
+	*/
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
+
 protected:
 	/**
 	* \brief Sets the location char
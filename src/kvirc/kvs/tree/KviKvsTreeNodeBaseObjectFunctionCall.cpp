@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeBaseObjectFunctionCall.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsObject.h"
 #include "KviKvsVariant.h"
 
@@ -48,6 +49,15 @@ void KviKvsTreeNodeBaseObjectFunctionCall::dump(const char * prefix)
 	m_pParams->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeBaseObjectFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::BaseObjectFunctionCall, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szBaseClass);
+	w->writeString(m_szFunctionName);
+	return w->writeChild(m_pParams);
+}
+
 bool KviKvsTreeNodeBaseObjectFunctionCall::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariantList l;
@@ -55,5 +65,5 @@ bool KviKvsTreeNodeBaseObjectFunctionCall::evaluateReadOnlyInObjectScope(KviKvsO
 		return false;
 	pBuffer->setNothing();
 	c->setDefaultReportLocation(this);
-	return o->callFunction(c->thisObject(), m_szFunctionName, m_szBaseClass, c, pBuffer, &l);
+	return o->callFunctionHandler(c->thisObject(), lookupFunctionHandler(o, m_szBaseClass), m_szFunctionName, m_szBaseClass, c, pBuffer, &l);
 }
@@ -45,6 +45,7 @@ protected:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 
 	virtual bool evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer);
 };
@@ -27,6 +27,7 @@
 #include "kvi_settings.h"
 #include "KviQString.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsAtom.h"
 
 class KviKvsParser;
 class KviKvsTreeNodeSwitchList;
@@ -35,6 +36,7 @@ class KVIRC_API KviKvsTreeNodeCommand : public KviKvsTreeNodeInstruction
 {
 	// never instantiated
 	friend class KviKvsParser;
+	friend class KviKvsTreeNodeReader;
 
 public:
 	KviKvsTreeNodeCommand(const QChar * pLocation, const QString & szCmdName);
@@ -42,6 +44,7 @@ public:
 
 protected:
 	QString m_szCmdName;                    // command visible name
+	KviKvsAtom m_atomCmdName;               // used for the alias and module command lookups
 	KviKvsTreeNodeSwitchList * m_pSwitches; // MAY BE 0!
 public:
 	virtual void contextDescription(QString & szBuffer);
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeCommandEvaluation.h"
+#include "KviKvsTreeNodeWriter.h"
 
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
@@ -46,3 +47,10 @@ bool KviKvsTreeNodeCommandEvaluation::evaluateReadOnly(KviKvsRunTimeContext * c,
 	c->swapReturnValuePointer(pTmp);
 	return bRet;
 }
+
+bool KviKvsTreeNodeCommandEvaluation::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::CommandEvaluation, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pInstruction);
+}
@@ -42,6 +42,7 @@ protected:
 	KviKvsTreeNodeInstruction * m_pInstruction; // owned, never 0
 public:
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 };
 
 #endif //!_KVI_KVS_TREENODE_COMMANDEVALUATION_H_
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeCompositeData.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviQString.h"
 
 #define DEBUGME
@@ -81,3 +82,16 @@ void KviKvsTreeNodeCompositeData::dump(const char * prefix)
 		p->dump(tmp.toUtf8().data());
 	}
 }
+
+bool KviKvsTreeNodeCompositeData::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::CompositeData, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeInt(m_pSubData->count());
+	for(KviKvsTreeNodeData * d = m_pSubData->first(); d; d = m_pSubData->next())
+	{
+		if(!w->writeChild(d))
+			return false;
+	}
+	return true;
+}
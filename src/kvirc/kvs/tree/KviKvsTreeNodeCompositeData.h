@@ -42,6 +42,7 @@ public:
 	virtual void contextDescription(QString & szBuffer);
 
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 };
 
 #endif //!_KVI_KVS_TREENODE_COMPOSITEDATA_H_
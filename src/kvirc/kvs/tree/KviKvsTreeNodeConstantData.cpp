@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeConstantData.h"
+#include "KviKvsTreeNodeWriter.h"
 
 KviKvsTreeNodeConstantData::KviKvsTreeNodeConstantData(const QChar * pLocation, KviKvsVariant * v)
     : KviKvsTreeNodeData(pLocation)
@@ -69,6 +70,13 @@ void KviKvsTreeNodeConstantData::dump(const char * prefix)
 	m_pValue->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeConstantData::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ConstantData, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeVariant(m_pValue);
+}
+
 bool KviKvsTreeNodeConstantData::evaluateReadOnly(KviKvsRunTimeContext *, KviKvsVariant * pBuffer)
 {
 	pBuffer->copyFrom(m_pValue);
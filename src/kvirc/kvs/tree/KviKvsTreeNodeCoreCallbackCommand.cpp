@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeCoreCallbackCommand.h"
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsScript.h"
 #include "KviKvsRunTimeContext.h"
 
@@ -50,6 +51,20 @@ void KviKvsTreeNodeCoreCallbackCommand::dump(const char * prefix)
 	dumpCallback(prefix);
 }
 
+bool KviKvsTreeNodeCoreCallbackCommand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::CoreCallbackCommand, m_pLocation))
+		return false;
+	w->writeString(m_szCmdName);
+	if(!w->writeChild(m_pParams))
+		return false;
+	if(!m_pCallback)
+		return false;
+	w->writeString(m_pCallback->name());
+	w->writeString(m_pCallback->code());
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeCoreCallbackCommand::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList l;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeCoreFunctionCall.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeCoreFunctionCall::KviKvsTreeNodeCoreFunctionCall(const QChar * pLocation, const QString & szFncName, KviKvsCoreFunctionExecRoutine * r, KviKvsTreeNodeDataList * pParams)
@@ -47,6 +48,14 @@ void KviKvsTreeNodeCoreFunctionCall::dump(const char * prefix)
 	m_pParams->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeCoreFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::CoreFunctionCall, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szFunctionName);
+	return w->writeChild(m_pParams);
+}
+
 bool KviKvsTreeNodeCoreFunctionCall::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariantList l;
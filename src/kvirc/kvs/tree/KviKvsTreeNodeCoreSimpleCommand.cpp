@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeCoreSimpleCommand.h"
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeCoreSimpleCommand::KviKvsTreeNodeCoreSimpleCommand(const QChar * pLocation, const QString & szCmdName, KviKvsTreeNodeDataList * params, KviKvsCoreSimpleCommandExecRoutine * r)
@@ -48,6 +49,16 @@ void KviKvsTreeNodeCoreSimpleCommand::dump(const char * prefix)
 	dumpParameterList(prefix);
 }
 
+bool KviKvsTreeNodeCoreSimpleCommand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::CoreSimpleCommand, m_pLocation))
+		return false;
+	w->writeString(m_szCmdName);
+	if(!w->writeChild(m_pParams))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeCoreSimpleCommand::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList l;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeDataList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 #include "KviQString.h"
@@ -74,6 +75,19 @@ void KviKvsTreeNodeDataList::dump(const char * prefix)
 	}
 }
 
+bool KviKvsTreeNodeDataList::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::DataList, m_pLocation))
+		return false;
+	w->writeInt(m_pDataList->count());
+	for(KviKvsTreeNodeData * d = m_pDataList->first(); d; d = m_pDataList->next())
+	{
+		if(!w->writeChild(d))
+			return false;
+	}
+	return true;
+}
+
 bool KviKvsTreeNodeDataList::evaluate(KviKvsRunTimeContext * c, KviKvsVariantList * pBuffer)
 {
 	pBuffer->clear();
@@ -35,6 +35,7 @@ class KviKvsRunTimeContext;
 class KVIRC_API KviKvsTreeNodeDataList : public KviKvsTreeNode
 {
 	friend class KviKvsParser;
+	friend class KviKvsTreeNodeReader;
 
 public:
 	KviKvsTreeNodeDataList(const QChar * pLocation);
@@ -54,6 +55,7 @@ public:
 	virtual void contextDescription(QString & szBuffer);
 
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 };
 
 #endif //!_KVI_KVS_TREENODE_DATALIST_H_
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeExpression.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviLocale.h"
 
 #include <math.h>
@@ -114,6 +115,13 @@ void KviKvsTreeNodeExpressionVariableOperand::dump(const char * prefix)
 	m_pData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionVariableOperand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionVariableOperand, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pData);
+}
+
 bool KviKvsTreeNodeExpressionVariableOperand::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	return m_pData->evaluateReadOnly(c, pBuffer);
@@ -143,6 +151,13 @@ void KviKvsTreeNodeExpressionConstantOperand::dump(const char * prefix)
 	m_pConstant->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionConstantOperand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionConstantOperand, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeVariant(m_pConstant);
+}
+
 bool KviKvsTreeNodeExpressionConstantOperand::evaluateReadOnly(KviKvsRunTimeContext *, KviKvsVariant * pBuffer)
 {
 	pBuffer->copyFrom(m_pConstant);
@@ -228,6 +243,13 @@ void KviKvsTreeNodeExpressionUnaryOperatorNegate::dump(const char * prefix)
 	m_pData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionUnaryOperatorNegate::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionUnaryOperatorNegate, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pData);
+}
+
 int KviKvsTreeNodeExpressionUnaryOperatorNegate::precedence()
 {
 	return PREC_OP_NEGATE;
@@ -265,6 +287,13 @@ void KviKvsTreeNodeExpressionUnaryOperatorBitwiseNot::dump(const char * prefix)
 	m_pData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionUnaryOperatorBitwiseNot::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionUnaryOperatorBitwiseNot, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pData);
+}
+
 int KviKvsTreeNodeExpressionUnaryOperatorBitwiseNot::precedence()
 {
 	return PREC_OP_BITWISENOT;
@@ -302,6 +331,13 @@ void KviKvsTreeNodeExpressionUnaryOperatorLogicalNot::dump(const char * prefix)
 	m_pData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionUnaryOperatorLogicalNot::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionUnaryOperatorLogicalNot, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pData);
+}
+
 int KviKvsTreeNodeExpressionUnaryOperatorLogicalNot::precedence()
 {
 	return PREC_OP_LOGICALNOT;
@@ -403,19 +439,27 @@ void KviKvsTreeNodeExpressionBinaryOperator::dump(const char * prefix)
 	dumpOperands(prefix);
 }
 
-#define PREIMPLEMENT_BINARY_OPERATOR(__name, __stringname, __contextdescription, __precedence) \
-	__name::__name(const QChar * pLocation)                                                    \
-	    : KviKvsTreeNodeExpressionBinaryOperator(pLocation) {}                                 \
-	__name::~__name() {}                                                                       \
-	void __name::dump(const char * prefix)                                                     \
-	{                                                                                          \
-		qDebug("%s " __stringname, prefix);                                                    \
-		dumpOperands(prefix);                                                                  \
-	}                                                                                          \
-	void __name::contextDescription(QString & szBuffer) { szBuffer = __contextdescription; }   \
+#define PREIMPLEMENT_BINARY_OPERATOR(__name, __type, __stringname, __contextdescription, __precedence) \
+	__name::__name(const QChar * pLocation)                                                            \
+	    : KviKvsTreeNodeExpressionBinaryOperator(pLocation) {}                                         \
+	__name::~__name() {}                                                                               \
+	void __name::dump(const char * prefix)                                                             \
+	{                                                                                                  \
+		qDebug("%s " __stringname, prefix);                                                            \
+		dumpOperands(prefix);                                                                          \
+	}                                                                                                  \
+	bool __name::serialize(KviKvsTreeNodeWriter * w)                                                   \
+	{                                                                                                  \
+		if(!w->writeNode(KviKvsTreeNodeWriter::__type, m_pLocation, m_pEndingLocation))                \
+			return false;                                                                              \
+		if(!w->writeChild(m_pLeft))                                                                    \
+			return false;                                                                              \
+		return w->writeChild(m_pRight);                                                                \
+	}                                                                                                  \
+	void __name::contextDescription(QString & szBuffer) { szBuffer = __contextdescription; }           \
 	int __name::precedence() { return __precedence; };
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorSum, "ExpressionBinaryOperatorSum", "Expression Binary Operator \"+\"", PREC_OP_SUM)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorSum, ExpressionBinaryOperatorSum, "ExpressionBinaryOperatorSum", "Expression Binary Operator \"+\"", PREC_OP_SUM)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorSum::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -438,7 +482,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorSum::evaluateReadOnly(KviKvsRunTimeCo
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorSubtraction, "ExpressionBinaryOperatorSubtraction", "Expression Binary Operator \"-\"", PREC_OP_SUBTRACTION)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorSubtraction, ExpressionBinaryOperatorSubtraction, "ExpressionBinaryOperatorSubtraction", "Expression Binary Operator \"-\"", PREC_OP_SUBTRACTION)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorSubtraction::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -461,7 +505,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorSubtraction::evaluateReadOnly(KviKvsR
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorMultiplication, "ExpressionBinaryOperatorMultiplication", "Expression Binary Operator \"*\"", PREC_OP_MULTIPLICATION)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorMultiplication, ExpressionBinaryOperatorMultiplication, "ExpressionBinaryOperatorMultiplication", "Expression Binary Operator \"*\"", PREC_OP_MULTIPLICATION)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorMultiplication::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -484,7 +528,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorMultiplication::evaluateReadOnly(KviK
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorDivision, "ExpressionBinaryOperatorDivision", "Expression Binary Operator \"/\"", PREC_OP_DIVISION)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorDivision, ExpressionBinaryOperatorDivision, "ExpressionBinaryOperatorDivision", "Expression Binary Operator \"/\"", PREC_OP_DIVISION)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorDivision::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -518,7 +562,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorDivision::evaluateReadOnly(KviKvsRunT
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorModulus, "ExpressionBinaryOperatorModulus", "Expression Binary Operator \"modulus\"", PREC_OP_MODULUS)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorModulus, ExpressionBinaryOperatorModulus, "ExpressionBinaryOperatorModulus", "Expression Binary Operator \"modulus\"", PREC_OP_MODULUS)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorModulus::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -552,7 +596,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorModulus::evaluateReadOnly(KviKvsRunTi
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseAnd, "ExpressionBinaryOperatorBitwiseAnd", "Expression Binary Operator \"&\"", PREC_OP_BITWISEAND)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseAnd, ExpressionBinaryOperatorBitwiseAnd, "ExpressionBinaryOperatorBitwiseAnd", "Expression Binary Operator \"&\"", PREC_OP_BITWISEAND)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseAnd::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -564,7 +608,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseAnd::evaluateReadOnly(KviKvsRu
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseOr, "ExpressionBinaryOperatorBitwiseOr", "Expression Binary Operator \"|\"", PREC_OP_BITWISEOR)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseOr, ExpressionBinaryOperatorBitwiseOr, "ExpressionBinaryOperatorBitwiseOr", "Expression Binary Operator \"|\"", PREC_OP_BITWISEOR)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseOr::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -576,7 +620,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseOr::evaluateReadOnly(KviKvsRun
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseXor, "ExpressionBinaryOperatorBitwiseXor", "Expression Binary Operator \"^\"", PREC_OP_BITWISEXOR)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorBitwiseXor, ExpressionBinaryOperatorBitwiseXor, "ExpressionBinaryOperatorBitwiseXor", "Expression Binary Operator \"^\"", PREC_OP_BITWISEXOR)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseXor::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -588,7 +632,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorBitwiseXor::evaluateReadOnly(KviKvsRu
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorShiftLeft, "ExpressionBinaryOperatorShiftLeft", "Expression Binary Operator \"<<\"", PREC_OP_SHIFTLEFT)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorShiftLeft, ExpressionBinaryOperatorShiftLeft, "ExpressionBinaryOperatorShiftLeft", "Expression Binary Operator \"<<\"", PREC_OP_SHIFTLEFT)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorShiftLeft::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -600,7 +644,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorShiftLeft::evaluateReadOnly(KviKvsRun
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorShiftRight, "ExpressionBinaryOperatorShiftRight", "Expression Binary Operator \">>\"", PREC_OP_SHIFTRIGHT)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorShiftRight, ExpressionBinaryOperatorShiftRight, "ExpressionBinaryOperatorShiftRight", "Expression Binary Operator \">>\"", PREC_OP_SHIFTRIGHT)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorShiftRight::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -612,7 +656,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorShiftRight::evaluateReadOnly(KviKvsRu
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorAnd, "ExpressionBinaryOperatorAnd", "Expression Binary Operator \"&&\"", PREC_OP_AND)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorAnd, ExpressionBinaryOperatorAnd, "ExpressionBinaryOperatorAnd", "Expression Binary Operator \"&&\"", PREC_OP_AND)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorAnd::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -632,7 +676,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorAnd::evaluateReadOnly(KviKvsRunTimeCo
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorOr, "ExpressionBinaryOperatorOr", "Expression Binary Operator \"||\"", PREC_OP_OR)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorOr, ExpressionBinaryOperatorOr, "ExpressionBinaryOperatorOr", "Expression Binary Operator \"||\"", PREC_OP_OR)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorOr::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -652,7 +696,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorOr::evaluateReadOnly(KviKvsRunTimeCon
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorXor, "ExpressionBinaryOperatorXor", "Expression Binary Operator \"^^\"", PREC_OP_XOR)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorXor, ExpressionBinaryOperatorXor, "ExpressionBinaryOperatorXor", "Expression Binary Operator \"^^\"", PREC_OP_XOR)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorXor::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -675,7 +719,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorXor::evaluateReadOnly(KviKvsRunTimeCo
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorLowerThan, "ExpressionBinaryOperatorLowerThan", "Expression Binary Operator \"<\"", PREC_OP_LOWERTHAN)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorLowerThan, ExpressionBinaryOperatorLowerThan, "ExpressionBinaryOperatorLowerThan", "Expression Binary Operator \"<\"", PREC_OP_LOWERTHAN)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorLowerThan::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -689,7 +733,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorLowerThan::evaluateReadOnly(KviKvsRun
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorGreaterThan, "ExpressionBinaryOperatorGreaterThan", "Expression Binary Operator \">\"", PREC_OP_GREATERTHAN)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorGreaterThan, ExpressionBinaryOperatorGreaterThan, "ExpressionBinaryOperatorGreaterThan", "Expression Binary Operator \">\"", PREC_OP_GREATERTHAN)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorGreaterThan::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -703,7 +747,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorGreaterThan::evaluateReadOnly(KviKvsR
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorLowerOrEqualTo, "ExpressionBinaryOperatorLowerOrEqualTo", "Expression Binary Operator \"<=\"", PREC_OP_LOWEROREQUALTO)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorLowerOrEqualTo, ExpressionBinaryOperatorLowerOrEqualTo, "ExpressionBinaryOperatorLowerOrEqualTo", "Expression Binary Operator \"<=\"", PREC_OP_LOWEROREQUALTO)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorLowerOrEqualTo::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -717,7 +761,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorLowerOrEqualTo::evaluateReadOnly(KviK
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorGreaterOrEqualTo, "ExpressionBinaryOperatorGreaterOrEqualTo", "Expression Binary Operator \">=\"", PREC_OP_GREATEROREQUALTO)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorGreaterOrEqualTo, ExpressionBinaryOperatorGreaterOrEqualTo, "ExpressionBinaryOperatorGreaterOrEqualTo", "Expression Binary Operator \">=\"", PREC_OP_GREATEROREQUALTO)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorGreaterOrEqualTo::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -731,7 +775,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorGreaterOrEqualTo::evaluateReadOnly(Kv
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorEqualTo, "ExpressionBinaryOperatorEqualTo", "Expression Binary Operator \"==\"", PREC_OP_EQUALTO)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorEqualTo, ExpressionBinaryOperatorEqualTo, "ExpressionBinaryOperatorEqualTo", "Expression Binary Operator \"==\"", PREC_OP_EQUALTO)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorEqualTo::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
@@ -745,7 +789,7 @@ bool KviKvsTreeNodeExpressionBinaryOperatorEqualTo::evaluateReadOnly(KviKvsRunTi
 	return true;
 }
 
-PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorNotEqualTo, "ExpressionBinaryOperatorNotEqualTo", "Expression Binary Operator \"!=\"", PREC_OP_NOTEQUALTO)
+PREIMPLEMENT_BINARY_OPERATOR(KviKvsTreeNodeExpressionBinaryOperatorNotEqualTo, ExpressionBinaryOperatorNotEqualTo, "ExpressionBinaryOperatorNotEqualTo", "Expression Binary Operator \"!=\"", PREC_OP_NOTEQUALTO)
 
 bool KviKvsTreeNodeExpressionBinaryOperatorNotEqualTo::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
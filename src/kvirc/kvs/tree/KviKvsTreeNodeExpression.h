@@ -99,6 +99,7 @@ protected:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult);
 };
 
@@ -114,6 +115,7 @@ public:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult);
 };
 
@@ -153,6 +155,7 @@ public:
 	virtual int precedence();
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult);
 };
 
@@ -166,6 +169,7 @@ public:
 	virtual int precedence();
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult);
 };
 
@@ -179,6 +183,7 @@ public:
 	virtual int precedence();
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult);
 };
 
@@ -219,6 +224,7 @@ protected:
 	public:                                                                               \
 		virtual void contextDescription(QString & szBuffer);                              \
 		virtual void dump(const char * prefix);                                           \
+		virtual bool serialize(KviKvsTreeNodeWriter * w);                                 \
 		virtual bool evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pResult); \
 		virtual int precedence();                                                         \
 	}
@@ -24,6 +24,7 @@
 
 #include "KviKvsTreeNodeExpressionReturn.h"
 #include "KviKvsTreeNodeExpression.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -52,6 +53,13 @@ void KviKvsTreeNodeExpressionReturn::dump(const char * prefix)
 	m_pExpression->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExpressionReturn::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExpressionReturn, m_pLocation))
+		return false;
+	return w->writeChild(m_pExpression);
+}
+
 bool KviKvsTreeNodeExpressionReturn::execute(KviKvsRunTimeContext * c)
 {
 	return m_pExpression->evaluateReadOnly(c, c->returnValue());
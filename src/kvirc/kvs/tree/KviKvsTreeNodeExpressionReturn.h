@@ -41,6 +41,7 @@ protected:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool execute(KviKvsRunTimeContext * c);
 };
 
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeExtendedScopeVariable.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -46,6 +47,14 @@ void KviKvsTreeNodeExtendedScopeVariable::dump(const char * prefix)
 	qDebug("%s ExtendedScopeVariable(%s)", prefix, m_szIdentifier.toUtf8().data());
 }
 
+bool KviKvsTreeNodeExtendedScopeVariable::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ExtendedScopeVariable, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szIdentifier);
+	return true;
+}
+
 bool KviKvsTreeNodeExtendedScopeVariable::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	if(!c->extendedScopeVariables())
@@ -54,7 +63,7 @@ bool KviKvsTreeNodeExtendedScopeVariable::evaluateReadOnly(KviKvsRunTimeContext
 		return false;
 	}
 
-	KviKvsVariant * v = c->extendedScopeVariables()->find(m_szIdentifier);
+	KviKvsVariant * v = c->extendedScopeVariables()->find(m_atomIdentifier);
 	if(v)
 	{
 		pBuffer->copyFrom(v);
@@ -74,5 +83,5 @@ KviKvsRWEvaluationResult * KviKvsTreeNodeExtendedScopeVariable::evaluateReadWrit
 		return nullptr;
 	}
 
-	return new KviKvsHashElement(nullptr, c->extendedScopeVariables()->get(m_szIdentifier), c->extendedScopeVariables(), m_szIdentifier);
+	return new KviKvsHashElement(nullptr, c->extendedScopeVariables()->get(m_atomIdentifier), c->extendedScopeVariables(), m_szIdentifier);
 }
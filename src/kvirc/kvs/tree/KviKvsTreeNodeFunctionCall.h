@@ -27,6 +27,7 @@
 #include "kvi_settings.h"
 #include "KviKvsTreeNodeData.h"
 #include "KviKvsTreeNodeDataList.h"
+#include "KviKvsAtom.h"
 
 class KVIRC_API KviKvsTreeNodeFunctionCall : public KviKvsTreeNodeData
 {
@@ -36,6 +37,7 @@ public:
 
 protected:
 	QString m_szFunctionName;
+	KviKvsAtom m_atomFunctionName; // used for the alias, module and object function lookups
 	KviKvsTreeNodeDataList * m_pParams; // never 0
 public:
 	virtual void contextDescription(QString & szBuffer);
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeGlobalVariable.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeGlobalVariable::KviKvsTreeNodeGlobalVariable(const QChar * pLocation, const QString & szIdentifier)
@@ -45,9 +46,17 @@ void KviKvsTreeNodeGlobalVariable::dump(const char * prefix)
 	qDebug("%s GlobalVariable(%s)", prefix, m_szIdentifier.toUtf8().data());
 }
 
+bool KviKvsTreeNodeGlobalVariable::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::GlobalVariable, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szIdentifier);
+	return true;
+}
+
 bool KviKvsTreeNodeGlobalVariable::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
-	KviKvsVariant * v = c->globalVariables()->find(m_szIdentifier);
+	KviKvsVariant * v = c->globalVariables()->find(m_atomIdentifier);
 	if(v)
 		pBuffer->copyFrom(v);
 	else
@@ -57,5 +66,5 @@ bool KviKvsTreeNodeGlobalVariable::evaluateReadOnly(KviKvsRunTimeContext * c, Kv
 
 KviKvsRWEvaluationResult * KviKvsTreeNodeGlobalVariable::evaluateReadWrite(KviKvsRunTimeContext * c)
 {
-	return new KviKvsHashElement(nullptr, c->globalVariables()->get(m_szIdentifier), c->globalVariables(), m_szIdentifier);
+	return new KviKvsHashElement(nullptr, c->globalVariables()->get(m_atomIdentifier), c->globalVariables(), m_szIdentifier);
 }
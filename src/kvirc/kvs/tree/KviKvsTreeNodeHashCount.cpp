@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeHashCount.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsVariant.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsObject.h"
@@ -46,6 +47,13 @@ void KviKvsTreeNodeHashCount::dump(const char * prefix)
 	qDebug("%s HashCount", prefix);
 }
 
+bool KviKvsTreeNodeHashCount::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::HashCount, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pSource);
+}
+
 bool KviKvsTreeNodeHashCount::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariant val;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeHashElement.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 #include "KviKvsHash.h"
@@ -54,6 +55,15 @@ void KviKvsTreeNodeHashElement::dump(const char * prefix)
 	m_pKey->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeHashElement::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::HashElement, m_pLocation, m_pEndingLocation))
+		return false;
+	if(!w->writeChild(m_pSource))
+		return false;
+	return w->writeChild(m_pKey);
+}
+
 bool KviKvsTreeNodeHashElement::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariant key;
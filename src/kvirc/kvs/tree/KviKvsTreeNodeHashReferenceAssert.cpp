@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeHashReferenceAssert.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRWEvaluationResult.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
@@ -51,6 +52,13 @@ void KviKvsTreeNodeHashReferenceAssert::dump(const char * prefix)
 	qDebug("%s HashReferenceAssert", prefix);
 }
 
+bool KviKvsTreeNodeHashReferenceAssert::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::HashReferenceAssert, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pSource);
+}
+
 bool KviKvsTreeNodeHashReferenceAssert::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	if(o)
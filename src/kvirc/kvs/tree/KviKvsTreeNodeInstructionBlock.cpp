@@ -23,7 +23,9 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeInstructionBlock.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
+#include "KviKvsProfiler.h"
 
 KviKvsTreeNodeInstructionBlock::KviKvsTreeNodeInstructionBlock(const QChar * pLocation)
     : KviKvsTreeNodeInstruction(pLocation)
@@ -53,6 +55,19 @@ void KviKvsTreeNodeInstructionBlock::dump(const char * prefix)
 	}
 }
 
+bool KviKvsTreeNodeInstructionBlock::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::InstructionBlock, m_pLocation))
+		return false;
+	w->writeInt(m_pInstructionList->count());
+	for(KviKvsTreeNodeInstruction * i = m_pInstructionList->first(); i; i = m_pInstructionList->next())
+	{
+		if(!w->writeChild(i))
+			return false;
+	}
+	return true;
+}
+
 KviKvsTreeNodeInstruction * KviKvsTreeNodeInstructionBlock::releaseFirst()
 {
 	m_pInstructionList->setAutoDelete(false);
@@ -74,6 +89,9 @@ void KviKvsTreeNodeInstructionBlock::addInstruction(KviKvsTreeNodeInstruction *
 
 bool KviKvsTreeNodeInstructionBlock::execute(KviKvsRunTimeContext * c)
 {
+	if(KviKvsProfiler::nodeTimingEnabled())
+		return executeProfiled(c);
+
 	// to accommodate recursion we need to use an iterator here
 	KviPointerListIterator<KviKvsTreeNodeInstruction> it(*m_pInstructionList);
 	while(KviKvsTreeNodeInstruction * i = it.current())
@@ -84,3 +102,20 @@ bool KviKvsTreeNodeInstructionBlock::execute(KviKvsRunTimeContext * c)
 	}
 	return true;
 }
+
+bool KviKvsTreeNodeInstructionBlock::executeProfiled(KviKvsRunTimeContext * c)
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	KviPointerListIterator<KviKvsTreeNodeInstruction> it(*m_pInstructionList);
+	while(KviKvsTreeNodeInstruction * i = it.current())
+	{
+		p->enterInstruction();
+		qint64 iStart = p->now();
+		bool bRet = i->execute(c);
+		p->leaveInstruction(c, i, p->now() - iStart);
+		if(!bRet)
+			return false;
+		++it;
+	}
+	return true;
+}
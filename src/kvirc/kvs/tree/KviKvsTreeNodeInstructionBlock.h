@@ -47,8 +47,12 @@ public:
 	KviKvsTreeNodeInstruction * releaseFirst();
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 
 	virtual bool execute(KviKvsRunTimeContext * c);
+
+protected:
+	bool executeProfiled(KviKvsRunTimeContext * c);
 };
 
 #endif //!_KVI_KVS_TREENODE_INSTRUCTIONBLOCK_H_
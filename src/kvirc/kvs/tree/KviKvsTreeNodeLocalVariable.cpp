@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeLocalVariable.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeLocalVariable::KviKvsTreeNodeLocalVariable(const QChar * pLocation, const QString & szIdentifier)
@@ -45,9 +46,17 @@ void KviKvsTreeNodeLocalVariable::dump(const char * prefix)
 	qDebug("%s LocalVariable(%s)", prefix, m_szIdentifier.toUtf8().data());
 }
 
+bool KviKvsTreeNodeLocalVariable::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::LocalVariable, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szIdentifier);
+	return true;
+}
+
 bool KviKvsTreeNodeLocalVariable::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
-	KviKvsVariant * v = c->localVariables()->find(m_szIdentifier);
+	KviKvsVariant * v = c->localVariables()->find(m_atomIdentifier);
 
 	if(v)
 		pBuffer->copyFrom(v);
@@ -61,7 +70,7 @@ KviKvsRWEvaluationResult * KviKvsTreeNodeLocalVariable::evaluateReadWrite(KviKvs
 {
 	return new KviKvsHashElement(
 	    nullptr,
-	    c->localVariables()->get(m_szIdentifier),
+	    c->localVariables()->get(m_atomIdentifier),
 	    c->localVariables(),
 	    m_szIdentifier);
 }
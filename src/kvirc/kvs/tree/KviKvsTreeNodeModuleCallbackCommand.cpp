@@ -25,6 +25,8 @@
 #include "KviKvsTreeNodeModuleCallbackCommand.h"
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
+#include "KviKvsScript.h"
 
 #include "KviModuleManager.h"
 #include "KviLocale.h"
@@ -57,6 +59,21 @@ void KviKvsTreeNodeModuleCallbackCommand::dump(const char * prefix)
 	dumpCallback(prefix);
 }
 
+bool KviKvsTreeNodeModuleCallbackCommand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ModuleCallbackCommand, m_pLocation))
+		return false;
+	w->writeString(m_szModuleName);
+	w->writeString(m_szCmdName);
+	if(!w->writeChild(m_pParams))
+		return false;
+	if(!m_pCallback)
+		return false;
+	w->writeString(m_pCallback->name());
+	w->writeString(m_pCallback->code());
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeModuleCallbackCommand::execute(KviKvsRunTimeContext * c)
 {
 	KviModule * m = g_pModuleManager->getModule(m_szModuleName);
@@ -67,7 +84,7 @@ bool KviKvsTreeNodeModuleCallbackCommand::execute(KviKvsRunTimeContext * c)
 		return false;
 	}
 
-	KviKvsModuleCallbackCommandExecRoutine * proc = m->kvsFindCallbackCommand(m_szCmdName);
+	KviKvsModuleCallbackCommandExecRoutine * proc = m->kvsFindCallbackCommand(m_atomCmdName);
 	if(!proc)
 	{
 		c->error(this, __tr2qs_ctx("Module command call failed: the module '%Q' doesn't export a callback command named '%Q'", "kvs"), &m_szModuleName, &m_szCmdName);
@@ -44,6 +44,7 @@ protected:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	bool execute(KviKvsRunTimeContext * c);
 };
 
@@ -24,6 +24,7 @@
 
 #include "KviKvsTreeNodeModuleFunctionCall.h"
 #include "KviKvsTreeNodeDataList.h"
+#include "KviKvsTreeNodeWriter.h"
 
 #include "KviModuleManager.h"
 #include "KviLocale.h"
@@ -56,6 +57,15 @@ void KviKvsTreeNodeModuleFunctionCall::dump(const char * prefix)
 	m_pParams->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeModuleFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ModuleFunctionCall, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szModuleName);
+	w->writeString(m_szFunctionName);
+	return w->writeChild(m_pParams);
+}
+
 bool KviKvsTreeNodeModuleFunctionCall::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviModule * m = g_pModuleManager->getModule(m_szModuleName);
@@ -66,7 +76,7 @@ bool KviKvsTreeNodeModuleFunctionCall::evaluateReadOnly(KviKvsRunTimeContext * c
 		return false;
 	}
 
-	KviKvsModuleFunctionExecRoutine * proc = m->kvsFindFunction(m_szFunctionName);
+	KviKvsModuleFunctionExecRoutine * proc = m->kvsFindFunction(m_atomFunctionName);
 	if(!proc)
 	{
 		c->error(this, __tr2qs_ctx("Module function call failed: the module '%Q' doesn't export a function named '%Q'", "kvs"), &m_szModuleName, &m_szFunctionName);
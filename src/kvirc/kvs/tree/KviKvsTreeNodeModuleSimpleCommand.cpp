@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeModuleSimpleCommand.h"
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 
 #include "KviModuleManager.h"
 #include "KviLocale.h"
@@ -56,6 +57,17 @@ void KviKvsTreeNodeModuleSimpleCommand::dump(const char * prefix)
 	dumpParameterList(prefix);
 }
 
+bool KviKvsTreeNodeModuleSimpleCommand::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ModuleSimpleCommand, m_pLocation))
+		return false;
+	w->writeString(m_szModuleName);
+	w->writeString(m_szCmdName);
+	if(!w->writeChild(m_pParams))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeModuleSimpleCommand::execute(KviKvsRunTimeContext * c)
 {
 	KviModule * m = g_pModuleManager->getModule(m_szModuleName);
@@ -66,10 +78,10 @@ bool KviKvsTreeNodeModuleSimpleCommand::execute(KviKvsRunTimeContext * c)
 		return false;
 	}
 
-	KviKvsModuleSimpleCommandExecRoutine * proc = m->kvsFindSimpleCommand(m_szCmdName);
+	KviKvsModuleSimpleCommandExecRoutine * proc = m->kvsFindSimpleCommand(m_atomCmdName);
 	if(!proc)
 	{
-		KviKvsModuleCallbackCommandExecRoutine * tmpProc = m->kvsFindCallbackCommand(m_szCmdName);
+		KviKvsModuleCallbackCommandExecRoutine * tmpProc = m->kvsFindCallbackCommand(m_atomCmdName);
 		if(tmpProc)
 		{
 			c->error(this, __tr2qs_ctx("Module command call failed, however the module '%Q' exports a callback command named '%Q' - possibly missing brackets in a callback command?", "kvs"), &m_szModuleName, &m_szCmdName);
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeMultipleParameterIdentifier.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
 
@@ -54,6 +55,15 @@ void KviKvsTreeNodeMultipleParameterIdentifier::dump(const char * prefix)
 		qDebug("%s MultipleParameterIdentifier(%d-%d)", prefix, m_iStart, m_iEnd);
 }
 
+bool KviKvsTreeNodeMultipleParameterIdentifier::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::MultipleParameterIdentifier, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeInt(m_iStart);
+	w->writeInt(m_iEnd);
+	return true;
+}
+
 bool KviKvsTreeNodeMultipleParameterIdentifier::evaluateReadOnly(KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariant * v = c->parameterList()->at(m_iStart);
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeObjectField.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsObject.h"
 #include "KviKvsHash.h"
@@ -47,6 +48,14 @@ void KviKvsTreeNodeObjectField::dump(const char * prefix)
 	qDebug("%s ObjectField(%s)", prefix, m_szIdentifier.toUtf8().data());
 }
 
+bool KviKvsTreeNodeObjectField::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ObjectField, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szIdentifier);
+	return true;
+}
+
 bool KviKvsTreeNodeObjectField::canEvaluateInObjectScope()
 {
 	return true;
@@ -54,7 +63,7 @@ bool KviKvsTreeNodeObjectField::canEvaluateInObjectScope()
 
 bool KviKvsTreeNodeObjectField::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext *, KviKvsVariant * pBuffer)
 {
-	KviKvsVariant * v = o->dataContainer()->find(m_szIdentifier);
+	KviKvsVariant * v = o->dataContainer()->find(m_atomIdentifier);
 	if(v)
 		pBuffer->copyFrom(v);
 	else
@@ -64,5 +73,5 @@ bool KviKvsTreeNodeObjectField::evaluateReadOnlyInObjectScope(KviKvsObject * o,
 
 KviKvsRWEvaluationResult * KviKvsTreeNodeObjectField::evaluateReadWriteInObjectScope(KviKvsObject * o, KviKvsRunTimeContext *)
 {
-	return new KviKvsHashElement(nullptr, o->dataContainer()->get(m_szIdentifier), o->dataContainer(), m_szIdentifier);
+	return new KviKvsHashElement(nullptr, o->dataContainer()->get(m_atomIdentifier), o->dataContainer(), m_szIdentifier);
 }
@@ -23,10 +23,15 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeObjectFunctionCall.h"
+#include "KviKvsObject.h"
+#include "KviKvsObjectClass.h"
 
 KviKvsTreeNodeObjectFunctionCall::KviKvsTreeNodeObjectFunctionCall(const QChar * pLocation, const QString & szFncName, KviKvsTreeNodeDataList * pParams)
     : KviKvsTreeNodeFunctionCall(pLocation, szFncName, pParams)
 {
+	m_pCachedClass = nullptr;
+	m_uCachedGeneration = 0;
+	m_pCachedHandler = nullptr;
 }
 
 KviKvsTreeNodeObjectFunctionCall::~KviKvsTreeNodeObjectFunctionCall()
@@ -47,6 +52,24 @@ void KviKvsTreeNodeObjectFunctionCall::dump(const char * prefix)
 	m_pParams->dump(tmp.toUtf8().data());
 }
 
+KviKvsObjectFunctionHandler * KviKvsTreeNodeObjectFunctionCall::lookupFunctionHandler(KviKvsObject * o, const QString & szClassOverride)
+{
+	// the private implementations shadow the class handlers: never cache them
+	if(szClassOverride.isEmpty() && o->hasPrivateImplementations())
+		return o->lookupFunctionHandler(m_atomFunctionName);
+
+	// the class override of a call site never changes, so the resolved
+	// handler depends only on the exact class of the object
+	KviKvsObjectClass * pClass = o->getExactClass();
+	if((pClass == m_pCachedClass) && (m_uCachedGeneration == KviKvsObjectClass::handlersGeneration()))
+		return m_pCachedHandler;
+
+	m_pCachedHandler = o->lookupFunctionHandler(m_atomFunctionName, szClassOverride);
+	m_pCachedClass = pClass;
+	m_uCachedGeneration = KviKvsObjectClass::handlersGeneration();
+	return m_pCachedHandler;
+}
+
 bool KviKvsTreeNodeObjectFunctionCall::canEvaluateInObjectScope()
 {
 	return true;
@@ -29,12 +29,26 @@
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeFunctionCall.h"
 
+class KviKvsObject;
+class KviKvsObjectClass;
+class KviKvsObjectFunctionHandler;
+
 class KVIRC_API KviKvsTreeNodeObjectFunctionCall : public KviKvsTreeNodeFunctionCall
 {
 public:
 	KviKvsTreeNodeObjectFunctionCall(const QChar * pLocation, const QString & szFncName, KviKvsTreeNodeDataList * pParams);
 	~KviKvsTreeNodeObjectFunctionCall();
 
+protected:
+	// the handler resolved the last time this call site was executed
+	KviKvsObjectClass * m_pCachedClass;
+	unsigned int m_uCachedGeneration;
+	KviKvsObjectFunctionHandler * m_pCachedHandler;
+
+protected:
+	// looks up the handler of m_szFunctionName for the object o, going through the cache
+	KviKvsObjectFunctionHandler * lookupFunctionHandler(KviKvsObject * o, const QString & szClassOverride);
+
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
@@ -24,6 +24,7 @@
 
 #include "KviKvsTreeNodeOperation.h"
 #include "KviKvsTreeNodeData.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -87,6 +88,15 @@ void KviKvsTreeNodeOperationAssignment::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationAssignment::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationAssignment, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationAssignment::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -123,6 +133,13 @@ void KviKvsTreeNodeOperationDecrement::dump(const char * prefix)
 	m_pTargetData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationDecrement::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationDecrement, m_pLocation))
+		return false;
+	return w->writeChild(m_pTargetData);
+}
+
 bool KviKvsTreeNodeOperationDecrement::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsRWEvaluationResult * v = m_pTargetData->evaluateReadWrite(c);
@@ -173,6 +190,13 @@ void KviKvsTreeNodeOperationIncrement::dump(const char * prefix)
 	m_pTargetData->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationIncrement::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationIncrement, m_pLocation))
+		return false;
+	return w->writeChild(m_pTargetData);
+}
+
 bool KviKvsTreeNodeOperationIncrement::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsRWEvaluationResult * v = m_pTargetData->evaluateReadWrite(c);
@@ -227,6 +251,15 @@ void KviKvsTreeNodeOperationSelfAnd::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfAnd::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfAnd, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfAnd::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -286,6 +319,15 @@ void KviKvsTreeNodeOperationSelfDivision::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfDivision::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfDivision, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfDivision::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -373,6 +415,15 @@ void KviKvsTreeNodeOperationSelfModulus::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfModulus::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfModulus, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfModulus::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -457,6 +508,15 @@ void KviKvsTreeNodeOperationSelfMultiplication::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfMultiplication::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfMultiplication, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfMultiplication::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -526,6 +586,15 @@ void KviKvsTreeNodeOperationSelfOr::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfOr::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfOr, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfOr::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -584,6 +653,15 @@ void KviKvsTreeNodeOperationSelfShl::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfShl::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfShl, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfShl::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -643,6 +721,15 @@ void KviKvsTreeNodeOperationSelfShr::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfShr::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfShr, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfShr::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -702,6 +789,15 @@ void KviKvsTreeNodeOperationSelfSubtraction::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfSubtraction::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfSubtraction, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfSubtraction::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -774,6 +870,15 @@ void KviKvsTreeNodeOperationSelfSum::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfSum::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfSum, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfSum::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -847,6 +952,15 @@ void KviKvsTreeNodeOperationSelfXor::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationSelfXor::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationSelfXor, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationSelfXor::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -906,6 +1020,15 @@ void KviKvsTreeNodeOperationStringAppend::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationStringAppend::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationStringAppend, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationStringAppend::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -949,6 +1072,15 @@ void KviKvsTreeNodeOperationArrayAppend::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationArrayAppend::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationArrayAppend, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationArrayAppend::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -1027,6 +1159,15 @@ void KviKvsTreeNodeOperationStringAppendWithComma::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationStringAppendWithComma::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationStringAppendWithComma, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationStringAppendWithComma::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -1080,6 +1221,15 @@ void KviKvsTreeNodeOperationStringAppendWithSpace::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationStringAppendWithSpace::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationStringAppendWithSpace, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeOperationStringAppendWithSpace::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -1140,6 +1290,19 @@ void KviKvsTreeNodeOperationStringTransliteration::dump(const char * prefix)
 	m_pFlags->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationStringTransliteration::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationStringTransliteration, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	if(!w->writeChild(m_pLeft))
+		return false;
+	if(!w->writeChild(m_pRight))
+		return false;
+	return w->writeChild(m_pFlags);
+}
+
 bool KviKvsTreeNodeOperationStringTransliteration::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant vl;
@@ -1203,6 +1366,19 @@ void KviKvsTreeNodeOperationStringSubstitution::dump(const char * prefix)
 	m_pFlags->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeOperationStringSubstitution::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::OperationStringSubstitution, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetData))
+		return false;
+	if(!w->writeChild(m_pLeft))
+		return false;
+	if(!w->writeChild(m_pRight))
+		return false;
+	return w->writeChild(m_pFlags);
+}
+
 bool KviKvsTreeNodeOperationStringSubstitution::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant vl;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeParameterCount.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
 
@@ -44,6 +45,11 @@ void KviKvsTreeNodeParameterCount::dump(const char * prefix)
 	qDebug("%s ParameterCount", prefix);
 }
 
+bool KviKvsTreeNodeParameterCount::serialize(KviKvsTreeNodeWriter * w)
+{
+	return w->writeNode(KviKvsTreeNodeWriter::ParameterCount, m_pLocation, m_pEndingLocation);
+}
+
 bool KviKvsTreeNodeParameterCount::canEvaluateToObjectReference()
 {
 	return true;
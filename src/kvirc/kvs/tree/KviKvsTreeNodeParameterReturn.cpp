@@ -24,6 +24,7 @@
 
 #include "KviKvsTreeNodeParameterReturn.h"
 #include "KviKvsTreeNodeDataList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariantList.h"
 #include "KviLocale.h"
@@ -53,6 +54,13 @@ void KviKvsTreeNodeParameterReturn::dump(const char * prefix)
 	m_pDataList->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeParameterReturn::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ParameterReturn, m_pLocation))
+		return false;
+	return w->writeChild(m_pDataList);
+}
+
 bool KviKvsTreeNodeParameterReturn::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList lBuffer;
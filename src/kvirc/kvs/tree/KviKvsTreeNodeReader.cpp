@@ -0,0 +1,984 @@
+//=============================================================================
+//
+//   File : KviKvsTreeNodeReader.cpp
+//   Creation date : Sun 18 Oct 2026 21:38:47 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviKvsTreeNodeReader.h"
+#include "KviKvsTreeNodeWriter.h"
+#include "KviKvsTreeNode.h"
+#include "KviKvsKernel.h"
+#include "KviKvsScript.h"
+#include "KviKvsVariant.h"
+
+#include <string.h>
+
+KviKvsTreeNodeReader::KviKvsTreeNodeReader(const QChar * pBuffer, int iBufferLength, const char * pData, int iDataLength)
+{
+	m_pBuffer = pBuffer;
+	m_iBufferLength = iBufferLength;
+	m_pData = pData;
+	m_pDataEnd = pData + iDataLength;
+	m_ptr = pData;
+	m_bError = false;
+}
+
+KviKvsTreeNodeReader::~KviKvsTreeNodeReader()
+    = default;
+
+KviKvsTreeNodeInstruction * KviKvsTreeNodeReader::readTree()
+{
+	m_ptr = m_pData;
+	m_bError = false;
+
+	std::unique_ptr<KviKvsTreeNodeInstruction> pRoot;
+	if(!readChild(pRoot))
+		return nullptr;
+
+	// trailing garbage means that this is not what we have written
+	if(m_ptr != m_pDataEnd)
+		return nullptr;
+
+	return pRoot.release();
+}
+
+bool KviKvsTreeNodeReader::readRaw(void * pBuffer, int iLength)
+{
+	if((m_pDataEnd - m_ptr) < iLength)
+	{
+		m_bError = true;
+		return false;
+	}
+	memcpy(pBuffer, m_ptr, iLength);
+	m_ptr += iLength;
+	return true;
+}
+
+bool KviKvsTreeNodeReader::readLocation(const QChar *& pLocation)
+{
+	qint32 iOffset;
+	if(!readRaw(&iOffset, sizeof(iOffset)))
+		return false;
+	if(iOffset == -1)
+	{
+		pLocation = nullptr;
+		return true;
+	}
+	if((iOffset < 0) || (iOffset > m_iBufferLength))
+	{
+		m_bError = true;
+		return false;
+	}
+	pLocation = m_pBuffer + iOffset;
+	return true;
+}
+
+bool KviKvsTreeNodeReader::readInt(qint64 & iValue)
+{
+	return readRaw(&iValue, sizeof(iValue));
+}
+
+bool KviKvsTreeNodeReader::readCount(int & iCount)
+{
+	qint64 iValue;
+	if(!readInt(iValue))
+		return false;
+	// each item takes at least a couple of bytes: this also catches absurd counts
+	if((iValue < 0) || (iValue > (m_pDataEnd - m_ptr)))
+	{
+		m_bError = true;
+		return false;
+	}
+	iCount = (int)iValue;
+	return true;
+}
+
+bool KviKvsTreeNodeReader::readBool(bool & bValue)
+{
+	quint8 uValue;
+	if(!readRaw(&uValue, sizeof(uValue)))
+		return false;
+	bValue = uValue != 0;
+	return true;
+}
+
+bool KviKvsTreeNodeReader::readString(QString & szValue)
+{
+	qint32 iLength;
+	if(!readRaw(&iLength, sizeof(iLength)))
+		return false;
+	if(iLength == -1)
+	{
+		szValue = QString();
+		return true;
+	}
+	// check the length before allocating anything
+	if((iLength < 0) || ((m_pDataEnd - m_ptr) / (int)sizeof(QChar)) < iLength)
+	{
+		m_bError = true;
+		return false;
+	}
+	szValue.resize(iLength); // an empty but non null string for 0
+	if(iLength > 0)
+		return readRaw(szValue.data(), iLength * sizeof(QChar));
+	return true;
+}
+
+KviKvsVariant * KviKvsTreeNodeReader::readVariant()
+{
+	quint8 uType;
+	if(!readRaw(&uType, sizeof(uType)))
+		return nullptr;
+
+	switch(uType)
+	{
+		case KviKvsVariantData::Nothing:
+			return new KviKvsVariant();
+		case KviKvsVariantData::String:
+		{
+			QString szValue;
+			if(!readString(szValue))
+				return nullptr;
+			return new KviKvsVariant(szValue);
+		}
+		case KviKvsVariantData::Integer:
+		{
+			qint64 iValue;
+			if(!readInt(iValue))
+				return nullptr;
+			return new KviKvsVariant((kvs_int_t)iValue);
+		}
+		case KviKvsVariantData::Real:
+		{
+			kvs_real_t dValue;
+			if(!readRaw(&dValue, sizeof(dValue)))
+				return nullptr;
+			return new KviKvsVariant(dValue);
+		}
+		case KviKvsVariantData::Boolean:
+		{
+			bool bValue;
+			if(!readBool(bValue))
+				return nullptr;
+			return new KviKvsVariant(bValue);
+		}
+		default:
+			break;
+	}
+
+	m_bError = true;
+	return nullptr;
+}
+
+template <typename T>
+bool KviKvsTreeNodeReader::readChild(std::unique_ptr<T> & pChild, bool bOptional)
+{
+	KviKvsTreeNode * pNode = readNode();
+	if(!pNode)
+	{
+		// a null child is fine only where the parser allows it
+		if(!m_bError && !bOptional)
+			m_bError = true;
+		return !m_bError;
+	}
+
+	pChild.reset(dynamic_cast<T *>(pNode));
+	if(pChild)
+		return true;
+
+	// a node of the wrong class: this is not our data
+	delete pNode;
+	m_bError = true;
+	return false;
+}
+
+KviKvsTreeNode * KviKvsTreeNodeReader::readNode()
+{
+	quint16 uType;
+	if(!readRaw(&uType, sizeof(uType)))
+		return nullptr;
+	if(uType == KviKvsTreeNodeWriter::Null)
+		return nullptr;
+
+	const QChar * pLocation;
+	const QChar * pEndingLocation;
+	if(!readLocation(pLocation) || !readLocation(pEndingLocation))
+		return nullptr;
+
+	std::unique_ptr<KviKvsTreeNode> pNode(createNode(uType, pLocation));
+	if(!pNode)
+	{
+		m_bError = true;
+		return nullptr;
+	}
+
+	if(pEndingLocation)
+	{
+		KviKvsTreeNodeData * pData = dynamic_cast<KviKvsTreeNodeData *>(pNode.get());
+		if(!pData)
+		{
+			m_bError = true;
+			return nullptr;
+		}
+		pData->setEndingLocation(pEndingLocation);
+	}
+
+	// the commands are followed by their switch list
+	KviKvsTreeNodeCommand * pCommand = dynamic_cast<KviKvsTreeNodeCommand *>(pNode.get());
+	if(pCommand)
+	{
+		std::unique_ptr<KviKvsTreeNodeSwitchList> pSwitches;
+		if(!readChild(pSwitches, true))
+			return nullptr;
+		if(pSwitches)
+			pCommand->setSwitchList(pSwitches.release());
+	}
+
+	return pNode.release();
+}
+
+KviKvsTreeNode * KviKvsTreeNodeReader::createNode(int iType, const QChar * pLocation)
+{
+	switch(iType)
+	{
+		case KviKvsTreeNodeWriter::InstructionBlock:
+		{
+			int iCount;
+			if(!readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviKvsTreeNodeInstructionBlock> pBlock(new KviKvsTreeNodeInstructionBlock(pLocation));
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeInstruction> pInstruction;
+				if(!readChild(pInstruction))
+					return nullptr;
+				pBlock->addInstruction(pInstruction.release());
+			}
+			return pBlock.release();
+		}
+		case KviKvsTreeNodeWriter::CoreSimpleCommand:
+		{
+			QString szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams))
+				return nullptr;
+			// the routines are looked up again: they live in this process only
+			KviKvsCoreSimpleCommandExecRoutine * r = KviKvsKernel::instance()->findCoreSimpleCommandExecRoutine(szName);
+			if(!r)
+				return nullptr;
+			return new KviKvsTreeNodeCoreSimpleCommand(pLocation, szName, pParams.release(), r);
+		}
+		case KviKvsTreeNodeWriter::ModuleSimpleCommand:
+		{
+			QString szModuleName, szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szModuleName) || !readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeModuleSimpleCommand(pLocation, szModuleName, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::AliasSimpleCommand:
+		{
+			QString szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeAliasSimpleCommand(pLocation, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::CoreCallbackCommand:
+		{
+			QString szName, szCallbackName, szCallbackCode;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams) || !readString(szCallbackName) || !readString(szCallbackCode))
+				return nullptr;
+			KviKvsCoreCallbackCommandExecRoutine * r = KviKvsKernel::instance()->findCoreCallbackCommandExecRoutine(szName);
+			if(!r)
+				return nullptr;
+			return new KviKvsTreeNodeCoreCallbackCommand(pLocation, szName, pParams.release(), r, new KviKvsScript(szCallbackName, szCallbackCode));
+		}
+		case KviKvsTreeNodeWriter::ModuleCallbackCommand:
+		{
+			QString szModuleName, szName, szCallbackName, szCallbackCode;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szModuleName) || !readString(szName) || !readChild(pParams) || !readString(szCallbackName) || !readString(szCallbackCode))
+				return nullptr;
+			return new KviKvsTreeNodeModuleCallbackCommand(pLocation, szModuleName, szName, pParams.release(), new KviKvsScript(szCallbackName, szCallbackCode));
+		}
+		case KviKvsTreeNodeWriter::RebindingSwitch:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pTargetWindow;
+			std::unique_ptr<KviKvsTreeNodeCommand> pChildCommand;
+			if(!readChild(pTargetWindow) || !readChild(pChildCommand))
+				return nullptr;
+			return new KviKvsTreeNodeRebindingSwitch(pLocation, pTargetWindow.release(), pChildCommand.release());
+		}
+		case KviKvsTreeNodeWriter::SwitchList:
+		{
+			std::unique_ptr<KviKvsTreeNodeSwitchList> pSwitches(new KviKvsTreeNodeSwitchList(pLocation));
+			int iCount;
+			if(!readCount(iCount))
+				return nullptr;
+			for(int i = 0; i < iCount; i++)
+			{
+				qint64 iKey;
+				std::unique_ptr<KviKvsTreeNodeData> pValue;
+				if(!readInt(iKey) || !readChild(pValue))
+					return nullptr;
+				pSwitches->addShort((int)iKey, pValue.release());
+			}
+			if(!readCount(iCount))
+				return nullptr;
+			for(int i = 0; i < iCount; i++)
+			{
+				QString szKey;
+				std::unique_ptr<KviKvsTreeNodeData> pValue;
+				if(!readString(szKey) || !readChild(pValue))
+					return nullptr;
+				pSwitches->addLong(szKey, pValue.release());
+			}
+			return pSwitches.release();
+		}
+		case KviKvsTreeNodeWriter::DataList:
+		{
+			int iCount;
+			if(!readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviKvsTreeNodeDataList> pList(new KviKvsTreeNodeDataList(pLocation));
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeData> pItem;
+				if(!readChild(pItem))
+					return nullptr;
+				pList->addItem(pItem.release());
+			}
+			return pList.release();
+		}
+		case KviKvsTreeNodeWriter::ConstantData:
+		{
+			KviKvsVariant * v = readVariant();
+			if(!v)
+				return nullptr;
+			return new KviKvsTreeNodeConstantData(pLocation, v);
+		}
+		case KviKvsTreeNodeWriter::CompositeData:
+		{
+			int iCount;
+			if(!readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviPointerList<KviKvsTreeNodeData>> pSubData(new KviPointerList<KviKvsTreeNodeData>);
+			pSubData->setAutoDelete(true);
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeData> pItem;
+				if(!readChild(pItem))
+					return nullptr;
+				pSubData->append(pItem.release());
+			}
+			return new KviKvsTreeNodeCompositeData(pLocation, pSubData.release());
+		}
+		case KviKvsTreeNodeWriter::CoreFunctionCall:
+		{
+			QString szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams))
+				return nullptr;
+			// the parser builds these also for the unknown names (the error is raised at runtime)
+			KviKvsCoreFunctionExecRoutine * r = KviKvsKernel::instance()->findCoreFunctionExecRoutine(szName);
+			return new KviKvsTreeNodeCoreFunctionCall(pLocation, szName, r, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::AliasFunctionCall:
+		{
+			QString szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeAliasFunctionCall(pLocation, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::ModuleFunctionCall:
+		{
+			QString szModuleName, szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szModuleName) || !readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeModuleFunctionCall(pLocation, szModuleName, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::BaseObjectFunctionCall:
+		{
+			QString szBaseClass, szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szBaseClass) || !readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeBaseObjectFunctionCall(pLocation, szBaseClass, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::ThisObjectFunctionCall:
+		{
+			QString szName;
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			if(!readString(szName) || !readChild(pParams))
+				return nullptr;
+			return new KviKvsTreeNodeThisObjectFunctionCall(pLocation, szName, pParams.release());
+		}
+		case KviKvsTreeNodeWriter::VoidFunctionCall:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pCall;
+			if(!readChild(pCall))
+				return nullptr;
+			// this may be a scope operator too: the parser does the very same cast
+			return new KviKvsTreeNodeVoidFunctionCall(pLocation, (KviKvsTreeNodeFunctionCall *)pCall.release());
+		}
+		case KviKvsTreeNodeWriter::CommandEvaluation:
+		{
+			std::unique_ptr<KviKvsTreeNodeInstruction> pInstruction;
+			if(!readChild(pInstruction))
+				return nullptr;
+			return new KviKvsTreeNodeCommandEvaluation(pLocation, pInstruction.release());
+		}
+		case KviKvsTreeNodeWriter::LocalVariable:
+		case KviKvsTreeNodeWriter::GlobalVariable:
+		case KviKvsTreeNodeWriter::ExtendedScopeVariable:
+		case KviKvsTreeNodeWriter::ObjectField:
+		{
+			QString szIdentifier;
+			if(!readString(szIdentifier))
+				return nullptr;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::LocalVariable:
+					return new KviKvsTreeNodeLocalVariable(pLocation, szIdentifier);
+				case KviKvsTreeNodeWriter::GlobalVariable:
+					return new KviKvsTreeNodeGlobalVariable(pLocation, szIdentifier);
+				case KviKvsTreeNodeWriter::ExtendedScopeVariable:
+					return new KviKvsTreeNodeExtendedScopeVariable(pLocation, szIdentifier);
+				default:
+					return new KviKvsTreeNodeObjectField(pLocation, szIdentifier);
+			}
+		}
+		case KviKvsTreeNodeWriter::ArrayElement:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pSource;
+			std::unique_ptr<KviKvsTreeNodeExpression> pIndex;
+			if(!readChild(pSource) || !readChild(pIndex))
+				return nullptr;
+			return new KviKvsTreeNodeArrayElement(pLocation, pSource.release(), pIndex.release());
+		}
+		case KviKvsTreeNodeWriter::HashElement:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pSource;
+			std::unique_ptr<KviKvsTreeNodeData> pKey;
+			if(!readChild(pSource) || !readChild(pKey))
+				return nullptr;
+			return new KviKvsTreeNodeHashElement(pLocation, pSource.release(), pKey.release());
+		}
+		case KviKvsTreeNodeWriter::ArrayCount:
+		case KviKvsTreeNodeWriter::HashCount:
+		case KviKvsTreeNodeWriter::ArrayReferenceAssert:
+		case KviKvsTreeNodeWriter::HashReferenceAssert:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pSource;
+			if(!readChild(pSource))
+				return nullptr;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::ArrayCount:
+					return new KviKvsTreeNodeArrayCount(pLocation, pSource.release());
+				case KviKvsTreeNodeWriter::HashCount:
+					return new KviKvsTreeNodeHashCount(pLocation, pSource.release());
+				case KviKvsTreeNodeWriter::ArrayReferenceAssert:
+					return new KviKvsTreeNodeArrayReferenceAssert(pLocation, pSource.release());
+				default:
+					return new KviKvsTreeNodeHashReferenceAssert(pLocation, pSource.release());
+			}
+		}
+		case KviKvsTreeNodeWriter::MultipleParameterIdentifier:
+		{
+			qint64 iStart, iEnd;
+			if(!readInt(iStart) || !readInt(iEnd))
+				return nullptr;
+			return new KviKvsTreeNodeMultipleParameterIdentifier(pLocation, (int)iStart, (int)iEnd);
+		}
+		case KviKvsTreeNodeWriter::SingleParameterIdentifier:
+		{
+			qint64 iStart;
+			if(!readInt(iStart))
+				return nullptr;
+			return new KviKvsTreeNodeSingleParameterIdentifier(pLocation, (int)iStart);
+		}
+		case KviKvsTreeNodeWriter::ParameterCount:
+			return new KviKvsTreeNodeParameterCount(pLocation);
+		case KviKvsTreeNodeWriter::ParameterReturn:
+		{
+			std::unique_ptr<KviKvsTreeNodeDataList> pDataList;
+			if(!readChild(pDataList))
+				return nullptr;
+			return new KviKvsTreeNodeParameterReturn(pLocation, pDataList.release());
+		}
+		case KviKvsTreeNodeWriter::ExpressionReturn:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pExpression;
+			if(!readChild(pExpression))
+				return nullptr;
+			return new KviKvsTreeNodeExpressionReturn(pLocation, pExpression.release());
+		}
+		case KviKvsTreeNodeWriter::ScopeOperator:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pObject;
+			std::unique_ptr<KviKvsTreeNodeData> pRightSide;
+			if(!readChild(pObject) || !readChild(pRightSide))
+				return nullptr;
+			return new KviKvsTreeNodeScopeOperator(pLocation, pObject.release(), pRightSide.release());
+		}
+		case KviKvsTreeNodeWriter::StringCast:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pChild;
+			if(!readChild(pChild))
+				return nullptr;
+			return new KviKvsTreeNodeStringCast(pLocation, pChild.release());
+		}
+		case KviKvsTreeNodeWriter::ExpressionVariableOperand:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pData;
+			if(!readChild(pData))
+				return nullptr;
+			return new KviKvsTreeNodeExpressionVariableOperand(pLocation, pData.release());
+		}
+		case KviKvsTreeNodeWriter::ExpressionConstantOperand:
+		{
+			KviKvsVariant * v = readVariant();
+			if(!v)
+				return nullptr;
+			return new KviKvsTreeNodeExpressionConstantOperand(pLocation, v);
+		}
+		case KviKvsTreeNodeWriter::ExpressionUnaryOperatorNegate:
+		case KviKvsTreeNodeWriter::ExpressionUnaryOperatorBitwiseNot:
+		case KviKvsTreeNodeWriter::ExpressionUnaryOperatorLogicalNot:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pOperand;
+			if(!readChild(pOperand))
+				return nullptr;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::ExpressionUnaryOperatorNegate:
+					return new KviKvsTreeNodeExpressionUnaryOperatorNegate(pLocation, pOperand.release());
+				case KviKvsTreeNodeWriter::ExpressionUnaryOperatorBitwiseNot:
+					return new KviKvsTreeNodeExpressionUnaryOperatorBitwiseNot(pLocation, pOperand.release());
+				default:
+					return new KviKvsTreeNodeExpressionUnaryOperatorLogicalNot(pLocation, pOperand.release());
+			}
+		}
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorSum:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorSubtraction:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorMultiplication:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorDivision:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorModulus:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseAnd:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseOr:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseXor:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorShiftLeft:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorShiftRight:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorAnd:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorOr:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorXor:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorLowerThan:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorGreaterThan:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorLowerOrEqualTo:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorGreaterOrEqualTo:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorEqualTo:
+		case KviKvsTreeNodeWriter::ExpressionBinaryOperatorNotEqualTo:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pLeft;
+			std::unique_ptr<KviKvsTreeNodeExpression> pRight;
+			if(!readChild(pLeft) || !readChild(pRight))
+				return nullptr;
+			KviKvsTreeNodeExpressionBinaryOperator * pOperator;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorSum:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorSum(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorSubtraction:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorSubtraction(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorMultiplication:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorMultiplication(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorDivision:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorDivision(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorModulus:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorModulus(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseAnd:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorBitwiseAnd(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseOr:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorBitwiseOr(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorBitwiseXor:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorBitwiseXor(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorShiftLeft:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorShiftLeft(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorShiftRight:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorShiftRight(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorAnd:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorAnd(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorOr:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorOr(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorXor:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorXor(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorLowerThan:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorLowerThan(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorGreaterThan:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorGreaterThan(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorLowerOrEqualTo:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorLowerOrEqualTo(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorGreaterOrEqualTo:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorGreaterOrEqualTo(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::ExpressionBinaryOperatorEqualTo:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorEqualTo(pLocation);
+					break;
+				default:
+					pOperator = new KviKvsTreeNodeExpressionBinaryOperatorNotEqualTo(pLocation);
+					break;
+			}
+			pOperator->setLeft(pLeft.release());
+			pOperator->setRight(pRight.release());
+			return pOperator;
+		}
+		case KviKvsTreeNodeWriter::OperationDecrement:
+		case KviKvsTreeNodeWriter::OperationIncrement:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pTarget;
+			if(!readChild(pTarget))
+				return nullptr;
+			KviKvsTreeNodeOperation * pOperation;
+			if(iType == KviKvsTreeNodeWriter::OperationDecrement)
+				pOperation = new KviKvsTreeNodeOperationDecrement(pLocation);
+			else
+				pOperation = new KviKvsTreeNodeOperationIncrement(pLocation);
+			pOperation->setTargetVariableReference(pTarget.release());
+			return pOperation;
+		}
+		case KviKvsTreeNodeWriter::OperationAssignment:
+		case KviKvsTreeNodeWriter::OperationSelfAnd:
+		case KviKvsTreeNodeWriter::OperationSelfDivision:
+		case KviKvsTreeNodeWriter::OperationSelfModulus:
+		case KviKvsTreeNodeWriter::OperationSelfMultiplication:
+		case KviKvsTreeNodeWriter::OperationSelfOr:
+		case KviKvsTreeNodeWriter::OperationSelfShl:
+		case KviKvsTreeNodeWriter::OperationSelfShr:
+		case KviKvsTreeNodeWriter::OperationSelfSubtraction:
+		case KviKvsTreeNodeWriter::OperationSelfSum:
+		case KviKvsTreeNodeWriter::OperationSelfXor:
+		case KviKvsTreeNodeWriter::OperationStringAppend:
+		case KviKvsTreeNodeWriter::OperationArrayAppend:
+		case KviKvsTreeNodeWriter::OperationStringAppendWithComma:
+		case KviKvsTreeNodeWriter::OperationStringAppendWithSpace:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pTarget;
+			std::unique_ptr<KviKvsTreeNodeData> pRightSide;
+			if(!readChild(pTarget) || !readChild(pRightSide))
+				return nullptr;
+			KviKvsTreeNodeOperation * pOperation;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::OperationAssignment:
+					pOperation = new KviKvsTreeNodeOperationAssignment(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfAnd:
+					pOperation = new KviKvsTreeNodeOperationSelfAnd(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfDivision:
+					pOperation = new KviKvsTreeNodeOperationSelfDivision(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfModulus:
+					pOperation = new KviKvsTreeNodeOperationSelfModulus(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfMultiplication:
+					pOperation = new KviKvsTreeNodeOperationSelfMultiplication(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfOr:
+					pOperation = new KviKvsTreeNodeOperationSelfOr(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfShl:
+					pOperation = new KviKvsTreeNodeOperationSelfShl(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfShr:
+					pOperation = new KviKvsTreeNodeOperationSelfShr(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfSubtraction:
+					pOperation = new KviKvsTreeNodeOperationSelfSubtraction(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfSum:
+					pOperation = new KviKvsTreeNodeOperationSelfSum(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationSelfXor:
+					pOperation = new KviKvsTreeNodeOperationSelfXor(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationStringAppend:
+					pOperation = new KviKvsTreeNodeOperationStringAppend(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationArrayAppend:
+					pOperation = new KviKvsTreeNodeOperationArrayAppend(pLocation, pRightSide.release());
+					break;
+				case KviKvsTreeNodeWriter::OperationStringAppendWithComma:
+					pOperation = new KviKvsTreeNodeOperationStringAppendWithComma(pLocation, pRightSide.release());
+					break;
+				default:
+					pOperation = new KviKvsTreeNodeOperationStringAppendWithSpace(pLocation, pRightSide.release());
+					break;
+			}
+			pOperation->setTargetVariableReference(pTarget.release());
+			return pOperation;
+		}
+		case KviKvsTreeNodeWriter::OperationStringTransliteration:
+		case KviKvsTreeNodeWriter::OperationStringSubstitution:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pTarget;
+			std::unique_ptr<KviKvsTreeNodeData> pLeft;
+			std::unique_ptr<KviKvsTreeNodeData> pRight;
+			std::unique_ptr<KviKvsTreeNodeData> pFlags;
+			if(!readChild(pTarget) || !readChild(pLeft) || !readChild(pRight) || !readChild(pFlags))
+				return nullptr;
+			KviKvsTreeNodeOperation * pOperation;
+			if(iType == KviKvsTreeNodeWriter::OperationStringTransliteration)
+				pOperation = new KviKvsTreeNodeOperationStringTransliteration(pLocation, pLeft.release(), pRight.release(), pFlags.release());
+			else
+				pOperation = new KviKvsTreeNodeOperationStringSubstitution(pLocation, pLeft.release(), pRight.release(), pFlags.release());
+			pOperation->setTargetVariableReference(pTarget.release());
+			return pOperation;
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandBreak:
+			return new KviKvsTreeNodeSpecialCommandBreak(pLocation);
+		case KviKvsTreeNodeWriter::SpecialCommandContinue:
+			return new KviKvsTreeNodeSpecialCommandContinue(pLocation);
+		case KviKvsTreeNodeWriter::SpecialCommandClass:
+		{
+			std::unique_ptr<KviKvsTreeNodeDataList> pParams;
+			int iCount;
+			if(!readChild(pParams) || !readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviKvsTreeNodeSpecialCommandClass> pClass(new KviKvsTreeNodeSpecialCommandClass(pLocation, pParams.release()));
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeSpecialCommandClassFunctionDefinition> pDefinition;
+				if(!readChild(pDefinition))
+					return nullptr;
+				pClass->addFunctionDefinition(pDefinition.release());
+			}
+			return pClass.release();
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandClassFunctionDefinition:
+		{
+			QString szName, szBuffer, szReminder;
+			qint64 iHandlerFlags;
+			if(!readString(szName) || !readString(szBuffer) || !readString(szReminder) || !readInt(iHandlerFlags))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandClassFunctionDefinition(pLocation, szName, szBuffer, szReminder, (unsigned int)iHandlerFlags);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopup:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pPopupName;
+			std::unique_ptr<KviKvsTreeNodeSpecialCommandDefpopupLabelPopup> pMainPopup;
+			if(!readChild(pPopupName) || !readChild(pMainPopup))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandDefpopup(pLocation, pPopupName.release(), pMainPopup.release());
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelSeparator:
+		{
+			QString szCondition, szItemName;
+			if(!readString(szCondition) || !readString(szItemName))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandDefpopupLabelSeparator(pLocation, szCondition, szItemName);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelExtpopup:
+		{
+			QString szCondition, szText, szIcon, szName, szItemName;
+			if(!readString(szCondition) || !readString(szText) || !readString(szIcon) || !readString(szName) || !readString(szItemName))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandDefpopupLabelExtpopup(pLocation, szCondition, szText, szIcon, szName, szItemName);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelItem:
+		{
+			QString szCondition, szText, szIcon, szInstruction, szItemName;
+			if(!readString(szCondition) || !readString(szText) || !readString(szIcon) || !readString(szInstruction) || !readString(szItemName))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandDefpopupLabelItem(pLocation, szCondition, szText, szIcon, szInstruction, szItemName);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelLabel:
+		{
+			QString szCondition, szText, szIcon, szItemName;
+			if(!readString(szCondition) || !readString(szText) || !readString(szIcon) || !readString(szItemName))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandDefpopupLabelLabel(pLocation, szCondition, szText, szIcon, szItemName);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelPrologue:
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelEpilogue:
+		{
+			QString szInstruction, szItemName;
+			if(!readString(szInstruction) || !readString(szItemName))
+				return nullptr;
+			if(iType == KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelPrologue)
+				return new KviKvsTreeNodeSpecialCommandDefpopupLabelPrologue(pLocation, szInstruction, szItemName);
+			return new KviKvsTreeNodeSpecialCommandDefpopupLabelEpilogue(pLocation, szInstruction, szItemName);
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelPopup:
+		{
+			QString szCondition, szText, szIcon, szItemName;
+			int iCount;
+			if(!readString(szCondition) || !readString(szText) || !readString(szIcon) || !readString(szItemName) || !readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviKvsTreeNodeSpecialCommandDefpopupLabelPopup> pPopup(new KviKvsTreeNodeSpecialCommandDefpopupLabelPopup(pLocation));
+			pPopup->setCondition(szCondition);
+			pPopup->setText(szText);
+			pPopup->setIcon(szIcon);
+			pPopup->setItemName(szItemName);
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeSpecialCommandDefpopupLabel> pLabel;
+				if(!readChild(pLabel))
+					return nullptr;
+				pPopup->addLabel(pLabel.release());
+			}
+			return pPopup.release();
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandDo:
+		case KviKvsTreeNodeWriter::SpecialCommandWhile:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pExpression;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pInstruction;
+			if(!readChild(pExpression) || !readChild(pInstruction, true))
+				return nullptr;
+			if(iType == KviKvsTreeNodeWriter::SpecialCommandDo)
+				return new KviKvsTreeNodeSpecialCommandDo(pLocation, pExpression.release(), pInstruction.release());
+			return new KviKvsTreeNodeSpecialCommandWhile(pLocation, pExpression.release(), pInstruction.release());
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandFor:
+		{
+			std::unique_ptr<KviKvsTreeNodeInstruction> pInit;
+			std::unique_ptr<KviKvsTreeNodeExpression> pCondition;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pUpdate;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pLoop;
+			if(!readChild(pInit, true) || !readChild(pCondition, true) || !readChild(pUpdate, true) || !readChild(pLoop, true))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandFor(pLocation, pInit.release(), pCondition.release(), pUpdate.release(), pLoop.release());
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandForeach:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pVariable;
+			std::unique_ptr<KviKvsTreeNodeDataList> pArgs;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pLoop;
+			if(!readChild(pVariable) || !readChild(pArgs) || !readChild(pLoop))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandForeach(pLocation, pVariable.release(), pArgs.release(), pLoop.release());
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandIf:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pExpression;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pIf;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pElse;
+			if(!readChild(pExpression) || !readChild(pIf, true) || !readChild(pElse, true))
+				return nullptr;
+			return new KviKvsTreeNodeSpecialCommandIf(pLocation, pExpression.release(), pIf.release(), pElse.release());
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandSwitch:
+		{
+			std::unique_ptr<KviKvsTreeNodeExpression> pExpression;
+			int iCount;
+			if(!readChild(pExpression) || !readCount(iCount))
+				return nullptr;
+			std::unique_ptr<KviKvsTreeNodeSpecialCommandSwitch> pSwitch(new KviKvsTreeNodeSpecialCommandSwitch(pLocation, pExpression.release()));
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeSpecialCommandSwitchLabel> pLabel;
+				if(!readChild(pLabel))
+					return nullptr;
+				pSwitch->addLabel(pLabel.release());
+			}
+			return pSwitch.release();
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelCase:
+		case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelMatch:
+		case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelRegexp:
+		case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelDefault:
+		{
+			std::unique_ptr<KviKvsTreeNodeData> pParameter;
+			std::unique_ptr<KviKvsTreeNodeInstruction> pInstruction;
+			bool bTerminatingBreak;
+			if(!readChild(pParameter, true) || !readChild(pInstruction, true) || !readBool(bTerminatingBreak))
+				return nullptr;
+			KviKvsTreeNodeSpecialCommandSwitchLabel * pLabel;
+			switch(iType)
+			{
+				case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelCase:
+					pLabel = new KviKvsTreeNodeSpecialCommandSwitchLabelCase(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelMatch:
+					pLabel = new KviKvsTreeNodeSpecialCommandSwitchLabelMatch(pLocation);
+					break;
+				case KviKvsTreeNodeWriter::SpecialCommandSwitchLabelRegexp:
+					pLabel = new KviKvsTreeNodeSpecialCommandSwitchLabelRegexp(pLocation);
+					break;
+				default:
+					pLabel = new KviKvsTreeNodeSpecialCommandSwitchLabelDefault(pLocation);
+					break;
+			}
+			if(pParameter)
+				pLabel->setParameter(pParameter.release());
+			if(pInstruction)
+				pLabel->setInstruction(pInstruction.release());
+			pLabel->setTerminatingBreak(bTerminatingBreak);
+			return pLabel;
+		}
+		case KviKvsTreeNodeWriter::SpecialCommandUnset:
+		{
+			int iCount;
+			if(!readCount(iCount))
+				return nullptr;
+			KviPointerList<KviKvsTreeNodeVariable> * pVarList = new KviPointerList<KviKvsTreeNodeVariable>;
+			pVarList->setAutoDelete(true);
+			for(int i = 0; i < iCount; i++)
+			{
+				std::unique_ptr<KviKvsTreeNodeVariable> pVariable;
+				if(!readChild(pVariable))
+				{
+					delete pVarList;
+					return nullptr;
+				}
+				pVarList->append(pVariable.release());
+			}
+			return new KviKvsTreeNodeSpecialCommandUnset(pLocation, pVarList);
+		}
+		default:
+			break;
+	}
+
+	// unknown type
+	return nullptr;
+}
@@ -0,0 +1,95 @@
+#ifndef _KVI_KVS_TREENODE_READER_H_
+#define _KVI_KVS_TREENODE_READER_H_
+//=============================================================================
+//
+//   File : KviKvsTreeNodeReader.h
+//   Creation date : Sun 18 Oct 2026 21:38:47 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviKvsTreeNodeReader.h
+* \author the KVIrc development team
+* \brief Deserialization of the syntax trees
+*/
+
+#include "kvi_settings.h"
+#include "KviQString.h"
+
+#include <memory>
+
+class KviKvsTreeNode;
+class KviKvsTreeNodeInstruction;
+class KviKvsVariant;
+
+/**
+* \class KviKvsTreeNodeReader
+* \brief Rebuilds a syntax tree written by KviKvsTreeNodeWriter
+*
+* The nodes are built with the same constructors and setters used by
+* KviKvsParser, on top of the same source buffer. The blob may come from
+* a file: every read is bounds checked and any inconsistency makes
+* readTree() fail cleanly, so the caller can fall back to the parser.
+*/
+class KVIRC_API KviKvsTreeNodeReader
+{
+public:
+	/**
+	* \brief Constructs the reader object
+	* \param pBuffer The source buffer the tree was parsed from
+	* \param iBufferLength The length of the buffer (in characters)
+	* \param pData The serialized tree (it is not copied)
+	* \param iDataLength The length of the serialized tree
+	* \return KviKvsTreeNodeReader
+	*/
+	KviKvsTreeNodeReader(const QChar * pBuffer, int iBufferLength, const char * pData, int iDataLength);
+	~KviKvsTreeNodeReader();
+
+protected:
+	const QChar * m_pBuffer;
+	int m_iBufferLength;
+	const char * m_pData;
+	const char * m_pDataEnd;
+	const char * m_ptr;
+	bool m_bError;
+
+public:
+	/**
+	* \brief Rebuilds the tree
+	* \return KviKvsTreeNodeInstruction * null if the data is corrupted
+	*/
+	KviKvsTreeNodeInstruction * readTree();
+
+protected:
+	KviKvsTreeNode * readNode();
+	KviKvsTreeNode * createNode(int iType, const QChar * pLocation);
+	template <typename T>
+	bool readChild(std::unique_ptr<T> & pChild, bool bOptional = false);
+
+	bool readRaw(void * pBuffer, int iLength);
+	bool readLocation(const QChar *& pLocation);
+	bool readInt(qint64 & iValue);
+	bool readCount(int & iCount);
+	bool readBool(bool & bValue);
+	bool readString(QString & szValue);
+	KviKvsVariant * readVariant();
+};
+
+#endif //!_KVI_KVS_TREENODE_READER_H_
@@ -24,6 +24,7 @@
 
 #include "KviKvsTreeNodeRebindingSwitch.h"
 #include "KviKvsTreeNodeData.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviWindow.h"
 #include "KviApplication.h"
 #include "KviLocale.h"
@@ -58,6 +59,17 @@ void KviKvsTreeNodeRebindingSwitch::dump(const char * prefix)
 	m_pChildCommand->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeRebindingSwitch::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::RebindingSwitch, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pTargetWindow))
+		return false;
+	if(!w->writeChild(m_pChildCommand))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 const QString & KviKvsTreeNodeRebindingSwitch::commandName()
 {
 	return m_pChildCommand->commandName();
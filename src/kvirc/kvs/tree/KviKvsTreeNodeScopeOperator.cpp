@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeScopeOperator.h"
+#include "KviKvsTreeNodeWriter.h"
 
 #include "KviQString.h"
 
@@ -63,6 +64,15 @@ void KviKvsTreeNodeScopeOperator::dump(const char * prefix)
 	m_pRightSide->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeScopeOperator::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ScopeOperator, m_pLocation, m_pEndingLocation))
+		return false;
+	if(!w->writeChild(m_pObjectReference))
+		return false;
+	return w->writeChild(m_pRightSide);
+}
+
 bool KviKvsTreeNodeScopeOperator::isReadOnly()
 {
 	return m_pRightSide->isReadOnly();
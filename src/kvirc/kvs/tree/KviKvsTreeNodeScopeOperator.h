@@ -41,6 +41,7 @@ public:
 public:
 	virtual void contextDescription(QString & szBuffer);
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual bool isReadOnly();                   // gets the m_pRightSide read only state
 	virtual bool canEvaluateToObjectReference(); // gets the m_pRightSide result
 	virtual bool isFunctionCall();               // gets the m_pRightSide result
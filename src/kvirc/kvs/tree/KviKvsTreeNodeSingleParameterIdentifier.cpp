@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeSingleParameterIdentifier.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsVariant.h"
 
@@ -47,6 +48,14 @@ void KviKvsTreeNodeSingleParameterIdentifier::dump(const char * prefix)
 	qDebug("%s SingleParameterIdentifier(%d)", prefix, m_iStart);
 }
 
+bool KviKvsTreeNodeSingleParameterIdentifier::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SingleParameterIdentifier, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeInt(m_iStart);
+	return true;
+}
+
 bool KviKvsTreeNodeSingleParameterIdentifier::canEvaluateToObjectReference()
 {
 	return true;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeSpecialCommandBreak.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -44,6 +45,13 @@ void KviKvsTreeNodeSpecialCommandBreak::dump(const char * prefix)
 	qDebug("%s SpecialCommandBreak", prefix);
 }
 
+bool KviKvsTreeNodeSpecialCommandBreak::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandBreak, m_pLocation))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandBreak::execute(KviKvsRunTimeContext * c)
 {
 	c->setBreakPending();
@@ -25,6 +25,7 @@
 #include "KviKvsVariantList.h"
 #include "KviKvsVariant.h"
 #include "KviKvsTreeNodeSpecialCommandClass.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsKernel.h"
 #include "KviKvsObjectController.h"
 #include "KviKvsObjectClass.h"
@@ -44,6 +45,17 @@ void KviKvsTreeNodeSpecialCommandClassFunctionDefinition::dump(const char * pref
 	qDebug("%s    (command buffer with %d characters)", prefix, m_szBuffer.length());
 }
 
+bool KviKvsTreeNodeSpecialCommandClassFunctionDefinition::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandClassFunctionDefinition, m_pLocation))
+		return false;
+	w->writeString(m_szName);
+	w->writeString(m_szBuffer);
+	w->writeString(m_szReminder);
+	w->writeInt(m_uHandlerFlags);
+	return true;
+}
+
 void KviKvsTreeNodeSpecialCommandClassFunctionDefinition::contextDescription(QString & szBuffer)
 {
 	szBuffer = QString("Object Member Function Definition '%1'").arg(m_szName);
@@ -85,6 +97,21 @@ void KviKvsTreeNodeSpecialCommandClass::dump(const char * prefix)
 		d->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandClass::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandClass, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pParams))
+		return false;
+	w->writeInt(m_pFunctions->count());
+	for(KviKvsTreeNodeSpecialCommandClassFunctionDefinition * d = m_pFunctions->first(); d; d = m_pFunctions->next())
+	{
+		if(!w->writeChild(d))
+			return false;
+	}
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandClass::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList l;
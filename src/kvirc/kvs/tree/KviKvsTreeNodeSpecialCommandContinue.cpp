@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeSpecialCommandContinue.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -44,6 +45,13 @@ void KviKvsTreeNodeSpecialCommandContinue::dump(const char * prefix)
 	qDebug("%s SpecialCommandContinue", prefix);
 }
 
+bool KviKvsTreeNodeSpecialCommandContinue::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandContinue, m_pLocation))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandContinue::execute(KviKvsRunTimeContext * c)
 {
 	c->setContinuePending();
@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeSpecialCommandDefpopup.h"
 #include "KviKvsTreeNodeExpression.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 #include "KviKvsPopupManager.h"
@@ -59,6 +60,18 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelExtpopup::dump(const char * prefix
 	qDebug("%s", x.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelExtpopup::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelExtpopup, m_pLocation))
+		return false;
+	w->writeString(m_szCondition);
+	w->writeString(m_szText);
+	w->writeString(m_szIcon);
+	w->writeString(m_szName);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelExtpopup::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addExtPopup(m_szItemName, m_szName, m_szText, m_szIcon, m_szCondition);
@@ -93,6 +106,18 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelItem::dump(const char * prefix)
 	qDebug("%s", x.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelItem::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelItem, m_pLocation))
+		return false;
+	w->writeString(m_szCondition);
+	w->writeString(m_szText);
+	w->writeString(m_szIcon);
+	w->writeString(m_szInstruction);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelItem::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addItem(m_szItemName, m_szInstruction, m_szText, m_szIcon, m_szCondition);
@@ -123,6 +148,17 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelLabel::dump(const char * prefix)
 	qDebug("%s", x.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelLabel::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelLabel, m_pLocation))
+		return false;
+	w->writeString(m_szCondition);
+	w->writeString(m_szText);
+	w->writeString(m_szIcon);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelLabel::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addLabel(m_szItemName, m_szText, m_szIcon, m_szCondition);
@@ -143,6 +179,15 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelSeparator::dump(const char * prefi
 	qDebug("%s", tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelSeparator::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelSeparator, m_pLocation))
+		return false;
+	w->writeString(m_szCondition);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelSeparator::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addSeparator(m_szItemName, m_szCondition);
@@ -163,6 +208,15 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelEpilogue::dump(const char * prefix
 	qDebug("%s", tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelEpilogue::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelEpilogue, m_pLocation))
+		return false;
+	w->writeString(m_szInstruction);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelEpilogue::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addEpilogue(m_szItemName, m_szInstruction);
@@ -183,6 +237,15 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelPrologue::dump(const char * prefix
 	qDebug("%s", tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelPrologue::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelPrologue, m_pLocation))
+		return false;
+	w->writeString(m_szInstruction);
+	w->writeString(m_szItemName);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopupLabelPrologue::execute(KviKvsRunTimeContext *, KviKvsPopupMenu * p)
 {
 	p->addPrologue(m_szItemName, m_szInstruction);
@@ -227,6 +290,23 @@ void KviKvsTreeNodeSpecialCommandDefpopupLabelPopup::dump(const char * prefix)
 		l->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopupLabelPopup::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopupLabelPopup, m_pLocation))
+		return false;
+	w->writeString(m_szCondition);
+	w->writeString(m_szText);
+	w->writeString(m_szIcon);
+	w->writeString(m_szItemName);
+	w->writeInt(m_pLabels->count());
+	for(KviKvsTreeNodeSpecialCommandDefpopupLabel * l = m_pLabels->first(); l; l = m_pLabels->next())
+	{
+		if(!w->writeChild(l))
+			return false;
+	}
+	return true;
+}
+
 void KviKvsTreeNodeSpecialCommandDefpopupLabelPopup::addLabel(KviKvsTreeNodeSpecialCommandDefpopupLabel * pLabel)
 {
 	pLabel->setParent(this);
@@ -284,6 +364,17 @@ void KviKvsTreeNodeSpecialCommandDefpopup::dump(const char * prefix)
 	m_pMainPopup->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandDefpopup::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandDefpopup, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pPopupName))
+		return false;
+	if(!w->writeChild(m_pMainPopup))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandDefpopup::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
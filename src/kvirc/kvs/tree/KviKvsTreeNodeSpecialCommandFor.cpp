@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeSpecialCommandFor.h"
 #include "KviKvsTreeNodeExpression.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -77,6 +78,21 @@ void KviKvsTreeNodeSpecialCommandFor::dump(const char * prefix)
 		m_pLoop->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandFor::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandFor, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pInitialization))
+		return false;
+	if(!w->writeChild(m_pCondition))
+		return false;
+	if(!w->writeChild(m_pUpdate))
+		return false;
+	if(!w->writeChild(m_pLoop))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandFor::execute(KviKvsRunTimeContext * c)
 {
 	if(m_pInitialization)
@@ -27,6 +27,7 @@
 #include "KviKvsTreeNodeDataList.h"
 #include "KviKvsTreeNodeInstruction.h"
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -63,6 +64,19 @@ void KviKvsTreeNodeSpecialCommandForeach::dump(const char * prefix)
 	m_pLoop->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandForeach::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandForeach, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pIterationVariable))
+		return false;
+	if(!w->writeChild(m_pIterationData))
+		return false;
+	if(!w->writeChild(m_pLoop))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandForeach::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariantList l;
@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeSpecialCommandIf.h"
 #include "KviKvsTreeNodeExpression.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -59,6 +60,19 @@ void KviKvsTreeNodeSpecialCommandIf::dump(const char *)
 {
 }
 
+bool KviKvsTreeNodeSpecialCommandIf::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandIf, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pExpression))
+		return false;
+	if(!w->writeChild(m_pIfInstruction))
+		return false;
+	if(!w->writeChild(m_pElseInstruction))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandIf::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
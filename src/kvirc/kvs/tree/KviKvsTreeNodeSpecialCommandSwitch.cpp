@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeSpecialCommandSwitch.h"
 #include "KviKvsTreeNodeExpression.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -88,6 +89,18 @@ void KviKvsTreeNodeSpecialCommandSwitchLabelCase::dump(const char * prefix)
 		m_pInstruction->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandSwitchLabelCase::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandSwitchLabelCase, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pParameter))
+		return false;
+	if(!w->writeChild(m_pInstruction))
+		return false;
+	w->writeBool(m_bHasTerminatingBreak);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandSwitchLabelCase::execute(KviKvsRunTimeContext * c, KviKvsVariant * pRealParameter, bool * bPassThrough)
 {
 	if(!(*bPassThrough))
@@ -182,6 +195,18 @@ void KviKvsTreeNodeSpecialCommandSwitchLabelMatch::dump(const char * prefix)
 		m_pInstruction->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandSwitchLabelMatch::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandSwitchLabelMatch, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pParameter))
+		return false;
+	if(!w->writeChild(m_pInstruction))
+		return false;
+	w->writeBool(m_bHasTerminatingBreak);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandSwitchLabelMatch::execute(KviKvsRunTimeContext * c, KviKvsVariant * pRealParameter, bool * bPassThrough)
 {
 	if(!(*bPassThrough))
@@ -241,6 +266,18 @@ void KviKvsTreeNodeSpecialCommandSwitchLabelRegexp::dump(const char * prefix)
 		m_pInstruction->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandSwitchLabelRegexp::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandSwitchLabelRegexp, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pParameter))
+		return false;
+	if(!w->writeChild(m_pInstruction))
+		return false;
+	w->writeBool(m_bHasTerminatingBreak);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandSwitchLabelRegexp::execute(KviKvsRunTimeContext * c, KviKvsVariant * pRealParameter, bool * bPassThrough)
 {
 	if(!(*bPassThrough))
@@ -298,6 +335,18 @@ void KviKvsTreeNodeSpecialCommandSwitchLabelDefault::dump(const char * prefix)
 		m_pInstruction->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandSwitchLabelDefault::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandSwitchLabelDefault, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pParameter))
+		return false;
+	if(!w->writeChild(m_pInstruction))
+		return false;
+	w->writeBool(m_bHasTerminatingBreak);
+	return true;
+}
+
 bool KviKvsTreeNodeSpecialCommandSwitchLabelDefault::execute(KviKvsRunTimeContext * c, KviKvsVariant *, bool * bPassThrough)
 {
 	*bPassThrough = true;
@@ -351,6 +400,21 @@ void KviKvsTreeNodeSpecialCommandSwitch::dump(const char * prefix)
 		l->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeSpecialCommandSwitch::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandSwitch, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pExpression))
+		return false;
+	w->writeInt(m_pLabels->count());
+	for(KviKvsTreeNodeSpecialCommandSwitchLabel * l = m_pLabels->first(); l; l = m_pLabels->next())
+	{
+		if(!w->writeChild(l))
+			return false;
+	}
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandSwitch::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeSpecialCommandUnset.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviKvsRWEvaluationResult.h"
 #include "KviLocale.h"
@@ -58,6 +59,19 @@ void KviKvsTreeNodeSpecialCommandUnset::dump(const char * prefix)
 	}
 }
 
+bool KviKvsTreeNodeSpecialCommandUnset::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandUnset, m_pLocation))
+		return false;
+	w->writeInt(m_pVariableList->count());
+	for(KviKvsTreeNodeVariable * v = m_pVariableList->first(); v; v = m_pVariableList->next())
+	{
+		if(!w->writeChild(v))
+			return false;
+	}
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandUnset::execute(KviKvsRunTimeContext * c)
 {
 	for(KviKvsTreeNodeVariable * pVar = m_pVariableList->first(); pVar; pVar = m_pVariableList->next())
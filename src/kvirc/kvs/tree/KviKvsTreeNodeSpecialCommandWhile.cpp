@@ -25,6 +25,7 @@
 #include "KviKvsTreeNodeSpecialCommandWhile.h"
 #include "KviKvsTreeNodeExpression.h"
 #include "KviKvsTreeNodeInstruction.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 #include "KviLocale.h"
 
@@ -54,6 +55,17 @@ void KviKvsTreeNodeSpecialCommandWhile::dump(const char *)
 {
 }
 
+bool KviKvsTreeNodeSpecialCommandWhile::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SpecialCommandWhile, m_pLocation))
+		return false;
+	if(!w->writeChild(m_pExpression))
+		return false;
+	if(!w->writeChild(m_pInstruction))
+		return false;
+	return w->writeChild(m_pSwitches);
+}
+
 bool KviKvsTreeNodeSpecialCommandWhile::execute(KviKvsRunTimeContext * c)
 {
 	for(;;)
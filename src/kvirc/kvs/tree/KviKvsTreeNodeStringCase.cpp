@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeStringCase.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviQString.h"
 
 KviKvsTreeNodeStringCast::KviKvsTreeNodeStringCast(const QChar * pLocation, KviKvsTreeNodeData * pChildData)
@@ -62,3 +63,10 @@ void KviKvsTreeNodeStringCast::dump(const char * prefix)
 	tmp.append("  ");
 	m_pChildData->dump(tmp.toUtf8().data());
 }
+
+bool KviKvsTreeNodeStringCast::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::StringCast, m_pLocation, m_pEndingLocation))
+		return false;
+	return w->writeChild(m_pChildData);
+}
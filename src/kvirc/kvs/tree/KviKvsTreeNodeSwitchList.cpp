@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeSwitchList.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeSwitchList::KviKvsTreeNodeSwitchList(const QChar * pLocation)
@@ -79,6 +80,45 @@ void KviKvsTreeNodeSwitchList::dump(const char * prefix)
 #endif
 }
 
+bool KviKvsTreeNodeSwitchList::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::SwitchList, m_pLocation))
+		return false;
+	if(m_pShortSwitchDict)
+	{
+		w->writeInt(m_pShortSwitchDict->count());
+		KviPointerHashTableIterator<int, KviKvsTreeNodeData> it(*m_pShortSwitchDict);
+		while(KviKvsTreeNodeData * d = it.current())
+		{
+			w->writeInt(it.currentKey());
+			if(!w->writeChild(d))
+				return false;
+			++it;
+		}
+	}
+	else
+	{
+		w->writeInt(0);
+	}
+	if(m_pLongSwitchDict)
+	{
+		w->writeInt(m_pLongSwitchDict->count());
+		KviPointerHashTableIterator<QString, KviKvsTreeNodeData> it(*m_pLongSwitchDict);
+		while(KviKvsTreeNodeData * d = it.current())
+		{
+			w->writeString(it.currentKey());
+			if(!w->writeChild(d))
+				return false;
+			++it;
+		}
+	}
+	else
+	{
+		w->writeInt(0);
+	}
+	return true;
+}
+
 void KviKvsTreeNodeSwitchList::addShort(int iShortKey, KviKvsTreeNodeData * p)
 {
 	if(!m_pShortSwitchDict)
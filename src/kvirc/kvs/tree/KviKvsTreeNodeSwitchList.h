@@ -50,6 +50,7 @@ public:
 	void addLong(const QString & szLongKey, KviKvsTreeNodeData * p);
 	bool isEmpty() { return (m_pShortSwitchDict == 0) && (m_pLongSwitchDict == 0); };
 	virtual void dump(const char * prefix);
+	virtual bool serialize(KviKvsTreeNodeWriter * w);
 	virtual void contextDescription(QString & szBuffer);
 
 	KviKvsTreeNodeData * getStandardRebindingSwitch();
@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeThisObjectFunctionCall.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsObject.h"
 
 KviKvsTreeNodeThisObjectFunctionCall::KviKvsTreeNodeThisObjectFunctionCall(const QChar * pLocation, const QString & szFncName, KviKvsTreeNodeDataList * pParams)
@@ -48,6 +49,14 @@ void KviKvsTreeNodeThisObjectFunctionCall::dump(const char * prefix)
 	m_pParams->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeThisObjectFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::ThisObjectFunctionCall, m_pLocation, m_pEndingLocation))
+		return false;
+	w->writeString(m_szFunctionName);
+	return w->writeChild(m_pParams);
+}
+
 bool KviKvsTreeNodeThisObjectFunctionCall::evaluateReadOnlyInObjectScope(KviKvsObject * o, KviKvsRunTimeContext * c, KviKvsVariant * pBuffer)
 {
 	KviKvsVariantList l;
@@ -55,5 +64,5 @@ bool KviKvsTreeNodeThisObjectFunctionCall::evaluateReadOnlyInObjectScope(KviKvsO
 		return false;
 	pBuffer->setNothing();
 	c->setDefaultReportLocation(this);
-	return o->callFunction(c->thisObject(), m_szFunctionName, QString(), c, pBuffer, &l);
+	return o->callFunctionHandler(c->thisObject(), lookupFunctionHandler(o, QString()), m_szFunctionName, QString(), c, pBuffer, &l);
 }
@@ -25,7 +25,7 @@
 #include "KviKvsTreeNodeVariable.h"
 
 KviKvsTreeNodeVariable::KviKvsTreeNodeVariable(const QChar * pLocation, const QString & szIdentifier)
-    : KviKvsTreeNodeData(pLocation)
+    : KviKvsTreeNodeData(pLocation), m_atomIdentifier(szIdentifier)
 {
 	m_szIdentifier = szIdentifier;
 }
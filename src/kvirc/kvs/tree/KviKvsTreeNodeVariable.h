@@ -28,6 +28,7 @@
 #include "KviQString.h"
 #include "KviKvsTreeNodeData.h"
 #include "KviKvsVariant.h"
+#include "KviKvsAtom.h"
 
 class KviKvsRunTimeContext;
 
@@ -39,6 +40,7 @@ public:
 
 protected:
 	QString m_szIdentifier;
+	KviKvsAtom m_atomIdentifier;
 
 protected:
 	virtual bool isReadOnly();
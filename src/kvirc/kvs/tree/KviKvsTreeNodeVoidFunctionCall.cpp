@@ -23,6 +23,7 @@
 //=============================================================================
 
 #include "KviKvsTreeNodeVoidFunctionCall.h"
+#include "KviKvsTreeNodeWriter.h"
 #include "KviKvsRunTimeContext.h"
 
 KviKvsTreeNodeVoidFunctionCall::KviKvsTreeNodeVoidFunctionCall(const QChar * pLocation, KviKvsTreeNodeFunctionCall * r)
@@ -49,6 +50,13 @@ void KviKvsTreeNodeVoidFunctionCall::dump(const char * prefix)
 	m_pFunctionCall->dump(tmp.toUtf8().data());
 }
 
+bool KviKvsTreeNodeVoidFunctionCall::serialize(KviKvsTreeNodeWriter * w)
+{
+	if(!w->writeNode(KviKvsTreeNodeWriter::VoidFunctionCall, m_pLocation))
+		return false;
+	return w->writeChild(m_pFunctionCall);
+}
+
 bool KviKvsTreeNodeVoidFunctionCall::execute(KviKvsRunTimeContext * c)
 {
 	KviKvsVariant v;
@@ -0,0 +1,156 @@
+//=============================================================================
+//
+//   File : KviKvsTreeNodeWriter.cpp
+//   Creation date : Sun 18 Oct 2026 21:05:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviKvsTreeNodeWriter.h"
+#include "KviKvsTreeNodeBase.h"
+#include "KviKvsVariant.h"
+
+//
+// The encoding (native byte order, the cache file header takes care of it):
+//
+//   node     : quint16 type, qint32 location offset, qint32 ending location offset
+//   location : the offset from the beginning of the buffer, -1 for a null pointer
+//   int      : qint64
+//   bool     : quint8
+//   string   : qint32 length (-1 for a null string) followed by the UTF-16 characters
+//   variant  : quint8 KviKvsVariantData::Type followed by the value
+//
+
+KviKvsTreeNodeWriter::KviKvsTreeNodeWriter(const QChar * pBuffer, int iBufferLength)
+{
+	m_pBuffer = pBuffer;
+	m_iBufferLength = iBufferLength;
+}
+
+KviKvsTreeNodeWriter::~KviKvsTreeNodeWriter()
+    = default;
+
+bool KviKvsTreeNodeWriter::writeTree(KviKvsTreeNode * pRoot)
+{
+	m_data.clear();
+	if(!pRoot)
+		return false;
+	if(pRoot->serialize(this))
+		return true;
+	m_data.clear();
+	return false;
+}
+
+void KviKvsTreeNodeWriter::writeRaw(const void * pData, int iLength)
+{
+	m_data.append((const char *)pData, iLength);
+}
+
+bool KviKvsTreeNodeWriter::writeLocation(const QChar * pLocation)
+{
+	qint32 iOffset = -1;
+	if(pLocation)
+	{
+		// the tree may point into another buffer (or into a temporary one): can't store it
+		if((pLocation < m_pBuffer) || (pLocation > (m_pBuffer + m_iBufferLength)))
+			return false;
+		iOffset = (qint32)(pLocation - m_pBuffer);
+	}
+	writeRaw(&iOffset, sizeof(iOffset));
+	return true;
+}
+
+bool KviKvsTreeNodeWriter::writeNode(NodeType eType, const QChar * pLocation, const QChar * pEndingLocation)
+{
+	quint16 uType = (quint16)eType;
+	writeRaw(&uType, sizeof(uType));
+	if(!writeLocation(pLocation))
+		return false;
+	return writeLocation(pEndingLocation);
+}
+
+bool KviKvsTreeNodeWriter::writeChild(KviKvsTreeNode * pNode)
+{
+	if(pNode)
+		return pNode->serialize(this);
+	quint16 uType = Null;
+	writeRaw(&uType, sizeof(uType));
+	return true;
+}
+
+void KviKvsTreeNodeWriter::writeInt(qint64 iValue)
+{
+	writeRaw(&iValue, sizeof(iValue));
+}
+
+void KviKvsTreeNodeWriter::writeBool(bool bValue)
+{
+	quint8 uValue = bValue ? 1 : 0;
+	writeRaw(&uValue, sizeof(uValue));
+}
+
+void KviKvsTreeNodeWriter::writeString(const QString & szValue)
+{
+	qint32 iLength = szValue.isNull() ? -1 : szValue.length();
+	writeRaw(&iLength, sizeof(iLength));
+	if(iLength > 0)
+		writeRaw(szValue.constData(), iLength * sizeof(QChar));
+}
+
+bool KviKvsTreeNodeWriter::writeVariant(KviKvsVariant * pValue)
+{
+	quint8 uType;
+	if(pValue->isNothing())
+	{
+		uType = KviKvsVariantData::Nothing;
+		writeRaw(&uType, sizeof(uType));
+		return true;
+	}
+	if(pValue->isString())
+	{
+		uType = KviKvsVariantData::String;
+		writeRaw(&uType, sizeof(uType));
+		writeString(pValue->string());
+		return true;
+	}
+	if(pValue->isInteger())
+	{
+		uType = KviKvsVariantData::Integer;
+		writeRaw(&uType, sizeof(uType));
+		writeInt(pValue->integer());
+		return true;
+	}
+	if(pValue->isReal())
+	{
+		uType = KviKvsVariantData::Real;
+		writeRaw(&uType, sizeof(uType));
+		kvs_real_t dValue = pValue->real();
+		writeRaw(&dValue, sizeof(dValue));
+		return true;
+	}
+	if(pValue->isBoolean())
+	{
+		uType = KviKvsVariantData::Boolean;
+		writeRaw(&uType, sizeof(uType));
+		writeBool(pValue->boolean());
+		return true;
+	}
+	// arrays, hashes and objects never appear as constants
+	return false;
+}
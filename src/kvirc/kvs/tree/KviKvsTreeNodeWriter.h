@@ -0,0 +1,238 @@
+#ifndef _KVI_KVS_TREENODE_WRITER_H_
+#define _KVI_KVS_TREENODE_WRITER_H_
+//=============================================================================
+//
+//   File : KviKvsTreeNodeWriter.h
+//   Creation date : Sun 18 Oct 2026 21:05:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+/**
+* \file KviKvsTreeNodeWriter.h
+* \author the KVIrc development team
+* \brief Serialization of the syntax trees
+*
+* A syntax tree is stored as a flat sequence of nodes in depth first order.
+* Each node starts with its type and with the offsets of its locations
+* in the source buffer, followed by its own fields and children.
+* The format is private to KviKvsTreeNodeWriter and KviKvsTreeNodeReader:
+* the blobs are meant to be read back by the same build only.
+*/
+
+#include "kvi_settings.h"
+#include "KviQString.h"
+
+#include <QByteArray>
+
+// bump this when the format or the meaning of a node changes
+#define KVI_KVS_TREENODE_SERIALIZATION_VERSION 1
+
+class KviKvsTreeNode;
+class KviKvsVariant;
+
+/**
+* \class KviKvsTreeNodeWriter
+* \brief Serializes a syntax tree built on a given source buffer
+*
+* The nodes write themselves with KviKvsTreeNode::serialize().
+* Any node that can't be represented (a location outside of the buffer,
+* a class that doesn't implement serialize()...) makes the whole tree
+* unserializable: the caller then simply doesn't cache it.
+*/
+class KVIRC_API KviKvsTreeNodeWriter
+{
+public:
+	/**
+	* \enum NodeType
+	* \brief The concrete node classes that can be serialized
+	*
+	* The values are stored in the blobs: never reorder them
+	* without changing KVI_KVS_TREENODE_SERIALIZATION_VERSION.
+	*/
+	enum NodeType
+	{
+		Null = 0,
+		InstructionBlock,
+		CoreSimpleCommand,
+		ModuleSimpleCommand,
+		AliasSimpleCommand,
+		CoreCallbackCommand,
+		ModuleCallbackCommand,
+		RebindingSwitch,
+		SwitchList,
+		DataList,
+		ConstantData,
+		CompositeData,
+		CoreFunctionCall,
+		AliasFunctionCall,
+		ModuleFunctionCall,
+		BaseObjectFunctionCall,
+		ThisObjectFunctionCall,
+		VoidFunctionCall,
+		CommandEvaluation,
+		LocalVariable,
+		GlobalVariable,
+		ExtendedScopeVariable,
+		ObjectField,
+		ArrayElement,
+		HashElement,
+		ArrayCount,
+		HashCount,
+		ArrayReferenceAssert,
+		HashReferenceAssert,
+		MultipleParameterIdentifier,
+		SingleParameterIdentifier,
+		ParameterCount,
+		ParameterReturn,
+		ExpressionReturn,
+		ScopeOperator,
+		StringCast,
+		ExpressionVariableOperand,
+		ExpressionConstantOperand,
+		ExpressionUnaryOperatorNegate,
+		ExpressionUnaryOperatorBitwiseNot,
+		ExpressionUnaryOperatorLogicalNot,
+		ExpressionBinaryOperatorSum,
+		ExpressionBinaryOperatorSubtraction,
+		ExpressionBinaryOperatorMultiplication,
+		ExpressionBinaryOperatorDivision,
+		ExpressionBinaryOperatorModulus,
+		ExpressionBinaryOperatorBitwiseAnd,
+		ExpressionBinaryOperatorBitwiseOr,
+		ExpressionBinaryOperatorBitwiseXor,
+		ExpressionBinaryOperatorShiftLeft,
+		ExpressionBinaryOperatorShiftRight,
+		ExpressionBinaryOperatorAnd,
+		ExpressionBinaryOperatorOr,
+		ExpressionBinaryOperatorXor,
+		ExpressionBinaryOperatorLowerThan,
+		ExpressionBinaryOperatorGreaterThan,
+		ExpressionBinaryOperatorLowerOrEqualTo,
+		ExpressionBinaryOperatorGreaterOrEqualTo,
+		ExpressionBinaryOperatorEqualTo,
+		ExpressionBinaryOperatorNotEqualTo,
+		OperationAssignment,
+		OperationDecrement,
+		OperationIncrement,
+		OperationSelfAnd,
+		OperationSelfDivision,
+		OperationSelfModulus,
+		OperationSelfMultiplication,
+		OperationSelfOr,
+		OperationSelfShl,
+		OperationSelfShr,
+		OperationSelfSubtraction,
+		OperationSelfSum,
+		OperationSelfXor,
+		OperationStringAppend,
+		OperationArrayAppend,
+		OperationStringAppendWithComma,
+		OperationStringAppendWithSpace,
+		OperationStringTransliteration,
+		OperationStringSubstitution,
+		SpecialCommandBreak,
+		SpecialCommandContinue,
+		SpecialCommandClass,
+		SpecialCommandClassFunctionDefinition,
+		SpecialCommandDefpopup,
+		SpecialCommandDefpopupLabelSeparator,
+		SpecialCommandDefpopupLabelExtpopup,
+		SpecialCommandDefpopupLabelItem,
+		SpecialCommandDefpopupLabelLabel,
+		SpecialCommandDefpopupLabelPrologue,
+		SpecialCommandDefpopupLabelEpilogue,
+		SpecialCommandDefpopupLabelPopup,
+		SpecialCommandDo,
+		SpecialCommandFor,
+		SpecialCommandForeach,
+		SpecialCommandIf,
+		SpecialCommandSwitch,
+		SpecialCommandSwitchLabelCase,
+		SpecialCommandSwitchLabelMatch,
+		SpecialCommandSwitchLabelRegexp,
+		SpecialCommandSwitchLabelDefault,
+		SpecialCommandUnset,
+		SpecialCommandWhile,
+		LastNodeType
+	};
+
+	/**
+	* \brief Constructs the writer object
+	* \param pBuffer The source buffer the tree was parsed from
+	* \param iBufferLength The length of the buffer (in characters)
+	* \return KviKvsTreeNodeWriter
+	*/
+	KviKvsTreeNodeWriter(const QChar * pBuffer, int iBufferLength);
+	~KviKvsTreeNodeWriter();
+
+protected:
+	const QChar * m_pBuffer;
+	int m_iBufferLength;
+	QByteArray m_data;
+
+public:
+	/**
+	* \brief Serializes a whole tree
+	* \param pRoot The root of the tree
+	* \return bool false if the tree can't be serialized
+	*/
+	bool writeTree(KviKvsTreeNode * pRoot);
+
+	/**
+	* \brief Returns the serialized tree
+	* \return const QByteArray &
+	*/
+	const QByteArray & data() const { return m_data; };
+
+	/**
+	* \brief Writes the header of a node: called first by every KviKvsTreeNode::serialize()
+	* \param eType The type of the node
+	* \param pLocation The location of the node
+	* \param pEndingLocation The ending location of the data nodes
+	* \return bool false if a location is outside of the buffer
+	*/
+	bool writeNode(NodeType eType, const QChar * pLocation, const QChar * pEndingLocation = nullptr);
+
+	/**
+	* \brief Writes a child node which may be null
+	* \param pNode The child node
+	* \return bool false if the child can't be serialized
+	*/
+	bool writeChild(KviKvsTreeNode * pNode);
+
+	void writeInt(qint64 iValue);
+	void writeBool(bool bValue);
+	void writeString(const QString & szValue); // keeps the null strings apart from the empty ones
+
+	/**
+	* \brief Writes a constant
+	*
+	* Only the scalar types that the parser produces are supported
+	* \param pValue The constant
+	* \return bool false for the other types
+	*/
+	bool writeVariant(KviKvsVariant * pValue);
+
+protected:
+	bool writeLocation(const QChar * pLocation);
+	void writeRaw(const void * pData, int iLength);
+};
+
+#endif //!_KVI_KVS_TREENODE_WRITER_H_
@@ -27,6 +27,7 @@
 #include "KviAntiSpam.h"
 #include "KviCString.h"
 #include "KviOptions.h"
+#include "KviMultiStringMatcher.h"
 
 // - A spam message is generally a single PRIVMSG <mynick> :<text>
 //		so this function should be (and is) called when
@@ -66,20 +67,28 @@
 		[/example]
 */
 
-bool kvi_mayBeSpam(KviCString msg, KviCString & spamWord)
+// The spam words, compiled into a single automaton: it is rebuilt when the option changes.
+// This is used only from the GUI thread.
+static KviMultiStringMatcher g_spamWordsMatcher;
+static QStringList g_lSpamWordsMatcherWords;
+
+bool kvi_mayBeSpam(const KviCString & msg, KviCString & spamWord)
 {
-	for(auto & it : KVI_OPTION_STRINGLIST(KviOption_stringlistSpamWords))
+	// the comparison is immediate as long as the option isn't touched (shared data)
+	if(g_lSpamWordsMatcherWords != KVI_OPTION_STRINGLIST(KviOption_stringlistSpamWords))
 	{
-		// FIXME : This is SLOOOOOOOOW (QString -> ascii translation!!)
-		const char * aux = it.toLatin1();
-		if(aux)
-		{
-			if(msg.findFirstIdx(aux, false) != -1)
-			{
-				spamWord = aux;
-				return true;
-			}
-		}
+		g_lSpamWordsMatcherWords = KVI_OPTION_STRINGLIST(KviOption_stringlistSpamWords); // shallow copy
+		g_spamWordsMatcher.clear();
+		g_spamWordsMatcher.setCaseSensitivity(Qt::CaseInsensitive);
+		for(auto & it : g_lSpamWordsMatcherWords)
+			g_spamWordsMatcher.addPattern(it);
+		g_spamWordsMatcher.compile();
 	}
-	return false;
+
+	// the message is scanned once, whatever the number of the spam words
+	int iWord = g_spamWordsMatcher.match(msg.ptr(), msg.len());
+	if(iWord < 0)
+		return false;
+	spamWord = g_spamWordsMatcher.pattern(iWord);
+	return true;
 }
@@ -55,7 +55,7 @@ void KviIrcServerParser::parseMessage(const char * message, KviIrcConnection * p
 
 	if(msg.isNumeric())
 	{
-		if(KviKvsEventManager::instance()->hasRawHandlers(msg.numeric()))
+		if(KviKvsEventManager::instance()->hasRawHandlers(msg.numeric(), pConnection->console()))
 		{
 			KviKvsVariantList parms;
 			parms.append(pConnection->decodeText(msg.safePrefix()));
@@ -396,13 +396,13 @@ void KviIrcServerParser::parseLiteralJoin(KviIrcMessage * msg)
 		if(chExtMode != 0)
 		{
 			chan->output(KVI_OUT_JOIN,
-			    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has joined \r!c\r%Q\r [implicit +%c umode change]"),
+			    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has joined \r!c\r%Q\r [implicit +%c umode change]"),
 			    &szNick, &szUser, &szHost, &channel, chExtMode);
 		}
 		else
 		{
 			chan->output(KVI_OUT_JOIN,
-			    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has joined \r!c\r%Q\r"),
+			    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has joined \r!c\r%Q\r"),
 			    &szNick, &szUser, &szHost, &channel);
 		}
 	}
@@ -415,7 +415,7 @@ void KviIrcServerParser::parseLiteralJoin(KviIrcMessage * msg)
 		if(KVI_OPTION_BOOL(KviOption_boolEnableQueryTracing))
 		{
 			q->output(KVI_OUT_QUERYTRACE,
-			    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has just joined \r!c\r%Q\r"), &szNick, &szUser,
+			    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has just joined \r!c\r%Q\r"), &szNick, &szUser,
 			    &szHost, &channel);
 			q->notifyCommonChannels(szNick, szUser, szHost, iChans, szChans);
 		}
@@ -495,11 +495,11 @@ void KviIrcServerParser::parseLiteralPart(KviIrcMessage * msg)
 		{
 			if(!partMsg.isEmpty())
 				chan->output(KVI_OUT_PART,
-				    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has left \r!c\r%Q\r: %Q"), &szNick, &szUser,
+				    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has left \r!c\r%Q\r: %Q"), &szNick, &szUser,
 				    &szHost, &szChan, &partMsg);
 			else
 				chan->output(KVI_OUT_PART,
-				    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has left \r!c\r%Q\r"), &szNick, &szUser,
+				    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has left \r!c\r%Q\r"), &szNick, &szUser,
 				    &szHost, &szChan);
 		}
 
@@ -512,11 +512,11 @@ void KviIrcServerParser::parseLiteralPart(KviIrcMessage * msg)
 			{
 				if(!partMsg.isEmpty())
 					q->output(KVI_OUT_QUERYTRACE,
-					    __tr2qs("\r!nc\r%Q\r [%Q@\r!h\r%Q\r] has just left \r!c\r%Q\r: %Q"),
+					    __tr2qs_static("\r!nc\r%Q\r [%Q@\r!h\r%Q\r] has just left \r!c\r%Q\r: %Q"),
 					    &szNick, &szUser, &szHost, &szChan, &partMsg);
 				else
 					q->output(KVI_OUT_QUERYTRACE,
-					    __tr2qs("\r!nc\r%Q\r [%Q@\r!h\r%Q\r] has just left \r!c\r%Q\r"),
+					    __tr2qs_static("\r!nc\r%Q\r [%Q@\r!h\r%Q\r] has just left \r!c\r%Q\r"),
 					    &szNick, &szUser, &szHost, &szChan);
 				q->notifyCommonChannels(szNick, szUser, szHost, iChans, szChans);
 			}
@@ -644,7 +644,7 @@ void KviIrcServerParser::parseLiteralQuit(KviIrcMessage * msg)
 
 				if(!msg->haltOutput())
 					c->output(KVI_OUT_QUIT,
-					    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has quit IRC: %Q"),
+					    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has quit IRC: %Q"),
 					    &szNick, &szUser, &szHost, &quitMsg);
 			}
 		}
@@ -660,7 +660,7 @@ void KviIrcServerParser::parseLiteralQuit(KviIrcMessage * msg)
 			{
 				quitMsg.prepend("NETSPLIT ");
 			}
-			q->output(KVI_OUT_QUIT, __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has quit IRC: %Q"),
+			q->output(KVI_OUT_QUIT, __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has quit IRC: %Q"),
 			    &szNick, &szUser, &szHost, &quitMsg);
 		}
 	}
@@ -777,7 +777,7 @@ void KviIrcServerParser::parseLiteralKick(KviIrcMessage * msg)
 		{
 			// FIXME: #warning "OPTION FOR THIS TO GO TO THE CONSOLE!"
 			chan->output(KVI_OUT_KICK,
-			    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has been kicked from \r!c\r%Q\r by \r!n\r%Q\r [%Q@\r!h\r%Q\r]: %Q"),
+			    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has been kicked from \r!c\r%Q\r by \r!n\r%Q\r [%Q@\r!h\r%Q\r]: %Q"),
 			    &victim, &szVUser, &szVHost, &szChan, &szNick, &szUser, &szHost, &szKickMsg);
 		}
 
@@ -789,7 +789,7 @@ void KviIrcServerParser::parseLiteralKick(KviIrcMessage * msg)
 				QString szChans;
 				int iChans = console->connection()->getCommonChannels(victim, szChans);
 				q->output(KVI_OUT_QUERYTRACE,
-				    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has just been kicked from \r!c\r%Q\r by \r!n\r%Q\r [%Q@\r!h\r%Q\r]: %Q"),
+				    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has just been kicked from \r!c\r%Q\r by \r!n\r%Q\r [%Q@\r!h\r%Q\r]: %Q"),
 				    &victim, &szVUser, &szVHost, &szChan,
 				    &szNick, &szUser, &szHost, &szKickMsg);
 				q->notifyCommonChannels(victim, szVUser, szVHost, iChans, szChans);
@@ -991,8 +991,8 @@ void KviIrcServerParser::parseLiteralPrivmsg(KviIrcMessage * msg)
 			// spam message...
 			if(KVI_OPTION_BOOL(KviOption_boolUseAntiSpamOnPrivmsg))
 			{
-				KviCString theMsg = msg->trailingString();
-				if(theMsg)
+				KviCString & theMsg = msg->safeTrailingString();
+				if(theMsg.hasData())
 				{
 					KviCString spamWord;
 					if(kvi_mayBeSpam(theMsg, spamWord))
@@ -1448,8 +1448,8 @@ void KviIrcServerParser::parseLiteralNotice(KviIrcMessage * msg)
 			// spam message...
 			if(KVI_OPTION_BOOL(KviOption_boolUseAntiSpamOnNotice))
 			{
-				KviCString theMsg = msg->trailingString(); // FIXME
-				if(theMsg)
+				KviCString & theMsg = msg->safeTrailingString();
+				if(theMsg.hasData())
 				{
 					KviCString spamWord;
 					if(kvi_mayBeSpam(theMsg, spamWord))
@@ -1741,7 +1741,7 @@ void KviIrcServerParser::parseLiteralTopic(KviIrcMessage * msg)
 	if(!msg->haltOutput())
 	{
 		chan->output(msgtype,
-		    __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has changed topic to \"%Q%c\""),
+		    __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] has changed topic to \"%Q%c\""),
 		    &szNick, &szUser, &szHost, &szTopic, KviControlCodes::Reset);
 	}
 }
@@ -1781,7 +1781,7 @@ void KviIrcServerParser::parseLiteralNick(KviIrcMessage * msg)
 		if(c->nickChange(szNick, szNewNick))
 		{
 			if(!msg->haltOutput())
-				c->output(KVI_OUT_NICK, __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
+				c->output(KVI_OUT_NICK, __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
 				    &szNick, &szUser, &szHost, &szNewNick);
 			// FIXME if(bIsMe)output(YOU ARE now known as.. ?)
 		}
@@ -1837,7 +1837,7 @@ void KviIrcServerParser::parseLiteralNick(KviIrcMessage * msg)
 			old->mergeQuery(q);
 			g_pMainWindow->closeWindow(q); // deleted path
 			if(!msg->haltOutput())
-				old->output(KVI_OUT_NICK, __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
+				old->output(KVI_OUT_NICK, __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
 				    &szNick, &szUser, &szHost, &szNewNick);
 			if(!_OUTPUT_MUTE)
 				old->output(KVI_OUT_SYSTEMWARNING, __tr2qs("End of merged output"));
@@ -1860,7 +1860,7 @@ void KviIrcServerParser::parseLiteralNick(KviIrcMessage * msg)
 			if(!q->nickChange(szNick, szNewNick))
 				qDebug("Internal error: query %s failed to change nick from %s to %s", szNick.toUtf8().data(), szNick.toUtf8().data(), szNewNick.toUtf8().data());
 			if(!msg->haltOutput())
-				q->output(KVI_OUT_NICK, __tr2qs("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
+				q->output(KVI_OUT_NICK, __tr2qs_static("\r!n\r%Q\r [%Q@\r!h\r%Q\r] is now known as \r!n\r%Q\r"),
 				    &szNick, &szUser, &szHost, &szNewNick);
 			q->userAction(szNewNick, szUser, szHost, KVI_USERACTION_NICK);
 		}
@@ -2132,11 +2132,11 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 				{
 					if(bSet)
 						chan->output(KVI_OUT_KEY,
-						    __tr2qs("%Q [%Q@%Q] has set channel key to \"\r!m-k %Q\r%Q\r\""),
+						    __tr2qs_static("%Q [%Q@%Q] has set channel key to \"\r!m-k %Q\r%Q\r\""),
 						    &szNickBuffer, &szUser, &szHostBuffer, &aParam, &aParam);
 					else
 						chan->output(KVI_OUT_KEY,
-						    __tr2qs("%Q [%Q@%Q] has unset the channel key"),
+						    __tr2qs_static("%Q [%Q@%Q] has unset the channel key"),
 						    &szNickBuffer, &szUser, &szHostBuffer);
 				}
 
@@ -2165,11 +2165,11 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 				{
 					if(bSet)
 						chan->output(KVI_OUT_LIMIT,
-						    __tr2qs("%Q [%Q@%Q] has set channel \r!m-l\rlimit to %Q\r"),
+						    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m-l\rlimit to %Q\r"),
 						    &szNickBuffer, &szUser, &szHostBuffer, &aParam);
 					else
 						chan->output(KVI_OUT_LIMIT,
-						    __tr2qs("%Q [%Q@%Q] has unset the channel limit"),
+						    __tr2qs_static("%Q [%Q@%Q] has unset the channel limit"),
 						    &szNickBuffer, &szUser, &szHostBuffer);
 				}
 
@@ -2197,7 +2197,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 			if(!(msg->haltOutput() || bShowAsCompact))                                                                                    \
 			{                                                                                                                             \
 				chan->output(bSet ? (bIsMe ? icomeset : icoset) : (bIsMe ? icomeunset : icounset),                                        \
-				    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),                                                                   \
+				    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),                                                            \
 				    &szNickBuffer, &szUser, &szHostBuffer, bSet ? '+' : '-', modechar, &aParam);                                          \
 			}                                                                                                                             \
 			if(bIsMultiSingleMode)                                                                                                        \
@@ -2209,7 +2209,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 			if(!(msg->haltOutput() || bShowAsCompact))                                                                                    \
 			{                                                                                                                             \
 				chan->output(KVI_OUT_CHANMODE,                                                                                            \
-				    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),                                                          \
+				    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),                                                   \
 				    &szNickBuffer, &szUser, &szHostBuffer,                                                                                \
 				    bSet ? '-' : '+', modechar, bSet ? '+' : '-', modechar);                                                              \
 			}                                                                                                                             \
@@ -2260,7 +2260,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 						if(!(msg->haltOutput() || bShowAsCompact))
 						{
 							chan->output(bSet ? (bIsMe ? KVI_OUT_MEBAN : KVI_OUT_BAN) : (bIsMe ? KVI_OUT_MEUNBAN : KVI_OUT_UNBAN),
-							    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '+' : '-', *aux, bSet ? '-' : '+', *aux, &aParam, &aParam);
 						}
@@ -2288,7 +2288,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 							if(!(msg->haltOutput() || bShowAsCompact))
 							{
 								chan->output(bSet ? (bIsMe ? KVI_OUT_MECHANOWNER : KVI_OUT_CHANOWNER) : (bIsMe ? KVI_OUT_MEDECHANOWNER : KVI_OUT_DECHANOWNER),
-								    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),
+								    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),
 								    &szNickBuffer, &szUser, &szHostBuffer, bSet ? '+' : '-', *aux, &aParam);
 							}
 							if(bIsMultiSingleMode)
@@ -2313,7 +2313,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 							if(!(msg->haltOutput() || bShowAsCompact))
 							{
 								chan->output(bSet ? (bIsMe ? KVI_OUT_MECHANADMIN : KVI_OUT_CHANADMIN) : (bIsMe ? KVI_OUT_MEDECHANADMIN : KVI_OUT_DECHANADMIN),
-								    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),
+								    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!n\r%Q\r"),
 								    &szNickBuffer, &szUser, &szHostBuffer, bSet ? '+' : '-', *aux, &aParam);
 							}
 							if(bIsMultiSingleMode)
@@ -2332,14 +2332,14 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 						if(aParam.isEmpty())
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '-' : '+', *aux, bSet ? '+' : '-', *aux);
 						}
 						else
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '+' : '-', *aux, bSet ? '-' : '+', *aux, &aParam, &aParam);
 						}
@@ -2361,7 +2361,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 					if(!(msg->haltOutput() || bShowAsCompact))
 					{
 						chan->output(KVI_OUT_CHANMODE,
-						    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
+						    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
 						    &szNickBuffer, &szUser, &szHostBuffer,
 						    bSet ? '-' : '+', *aux, bSet ? '+' : '-', *aux);
 					}
@@ -2396,7 +2396,7 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 			auto aParamEscaped = aParam;                                                                                                \
 			KviQString::escapeKvs(&aParamEscaped);                                                                                      \
 			chan->output(bSet ? (bIsMe ? icomeset : icoset) : (bIsMe ? icomeunset : icounset),                                              \
-			    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),                                                                  \
+			    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),                                                           \
 			    &szNickBuffer, &szUser, &szHostBuffer,                                                                                      \
 			    bSet ? '+' : '-', modefl, bSet ? '-' : '+', modefl, &aParamEscaped, &aParam);                                               \
 		}                                                                                                                                   \
@@ -2424,14 +2424,14 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 						if(aParam.isEmpty())
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '-' : '+', *aux, bSet ? '+' : '-', *aux);
 						}
 						else
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '+' : '-', *aux, bSet ? '-' : '+', *aux, &aParam, &aParam);
 						}
@@ -2453,14 +2453,14 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 						if(aParam.isEmpty())
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '-' : '+', *aux, bSet ? '+' : '-', *aux);
 						}
 						else
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '+' : '-', *aux, bSet ? '-' : '+', *aux, &aParam, &aParam);
 						}
@@ -2482,14 +2482,14 @@ void KviIrcServerParser::parseChannelMode(const QString & szNick, const QString
 						if(aParam.isEmpty())
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set channel \r!m%c%c\rmode %c%c\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '-' : '+', *aux, bSet ? '+' : '-', *aux);
 						}
 						else
 						{
 							chan->output(KVI_OUT_CHANMODE,
-							    __tr2qs("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
+							    __tr2qs_static("%Q [%Q@%Q] has set mode %c%c \r!m%c%c %Q\r%Q\r"),
 							    &szNickBuffer, &szUser, &szHostBuffer,
 							    bSet ? '+' : '-', *aux, bSet ? '-' : '+', *aux, &aParam, &aParam);
 						}
@@ -39,6 +39,7 @@
 #include "KviMainWindow.h"
 #include "KviConfigurationFile.h"
 #include "KviMaskEditor.h"
+#include "KviChannelMaskMatcher.h"
 #include "KviControlCodes.h"
 #include "KviModeEditor.h"
 #include "KviApplication.h"
@@ -268,6 +269,9 @@ KviChannelWindow::~KviChannelWindow()
 	for(auto i : m_ListEditorButtons)
 		delete i.second;
 
+	for(auto i : m_ModeListMatchers)
+		delete i.second;
+
 	for(auto i : m_ModeLists)
 		for(auto ii : i.second)
 			delete ii;
@@ -757,6 +761,10 @@ void KviChannelWindow::setDeadChan()
 		iter.second.clear();
 
 	m_ModeLists.clear();
+
+	for(auto & iter : m_ModeListMatchers)
+		delete iter.second;
+	m_ModeListMatchers.clear();
 	m_szSentModeRequests.clear();
 
 	m_pTopicWidget->reset();
@@ -1923,11 +1931,53 @@ void KviChannelWindow::setModeInList(char cMode, const QString & szMask, bool bA
 	if(m_ListEditors.count(cMode))
 		pEditor = m_ListEditors[cMode];
 
-	internalMask(szMask, bAdd, szSetBy, uSetAt, pList, &pEditor, szChangeMask);
+	KviChannelMaskMatcher * pMatcher = nullptr;
+	if(isMatchableModeList(cMode))
+	{
+		auto it = m_ModeListMatchers.find(cMode);
+		if(it != m_ModeListMatchers.end())
+		{
+			pMatcher = it->second;
+		}
+		else
+		{
+			pMatcher = new KviChannelMaskMatcher();
+			m_ModeListMatchers.emplace(cMode, pMatcher);
+			// the list may have been filled before
+			for(auto & e : pList)
+				pMatcher->add(e);
+		}
+	}
+
+	internalMask(szMask, bAdd, szSetBy, uSetAt, pList, &pEditor, szChangeMask, pMatcher);
 	m_pUserListView->setMaskEntries(cMode, pList.size());
 }
 
-void KviChannelWindow::internalMask(const QString & szMask, bool bAdd, const QString & szSetBy, unsigned int uSetAt, std::vector<KviMaskEntry *> & pList, KviMaskEditor ** ppEd, QString & szChangeMask)
+void KviChannelWindow::matchingModeMasks(char cMode, const QString & szNick, const QString & szUser, const QString & szHost, std::vector<KviMaskEntry *> & lMatches)
+{
+	auto it = m_ModeListMatchers.find(cMode);
+	if(it != m_ModeListMatchers.end())
+		it->second->findAll(szNick, szUser, szHost, lMatches);
+}
+
+KviMaskEntry * KviChannelWindow::firstMatchingModeMask(char cMode, const QString & szNick, const QString & szUser, const QString & szHost)
+{
+	auto it = m_ModeListMatchers.find(cMode);
+	if(it == m_ModeListMatchers.end())
+		return nullptr;
+	return it->second->findFirst(szNick, szUser, szHost);
+}
+
+const std::vector<KviMaskEntry *> & KviChannelWindow::unindexedModeMasks(char cMode) const
+{
+	static const std::vector<KviMaskEntry *> EMPTY_VECTOR;
+	auto it = m_ModeListMatchers.find(cMode);
+	if(it == m_ModeListMatchers.end())
+		return EMPTY_VECTOR;
+	return it->second->extbans();
+}
+
+void KviChannelWindow::internalMask(const QString & szMask, bool bAdd, const QString & szSetBy, unsigned int uSetAt, std::vector<KviMaskEntry *> & pList, KviMaskEditor ** ppEd, QString & szChangeMask, KviChannelMaskMatcher * pMatcher)
 {
 	KviMaskEntry * pEntry = nullptr;
 	if(bAdd)
@@ -1942,6 +1992,8 @@ void KviChannelWindow::internalMask(const QString & szMask, bool bAdd, const QSt
 		pEntry->szSetBy = (!szSetBy.isEmpty()) ? szSetBy : __tr2qs("(Unknown)");
 		pEntry->uSetAt = uSetAt;
 		pList.push_back(pEntry);
+		if(pMatcher)
+			pMatcher->add(pEntry);
 		if(*ppEd)
 			(*ppEd)->addMask(pEntry);
 	}
@@ -1956,6 +2008,9 @@ void KviChannelWindow::internalMask(const QString & szMask, bool bAdd, const QSt
 			if(*ppEd)
 				(*ppEd)->removeMask(*iter);
 
+			if(pMatcher)
+				pMatcher->remove(*iter);
+
 			if(szChangeMask.isNull())
 			{
 				//delete mask
@@ -1965,6 +2020,8 @@ void KviChannelWindow::internalMask(const QString & szMask, bool bAdd, const QSt
 			{
 				//update mask
 				(*iter)->szMask = szChangeMask;
+				if(pMatcher)
+					pMatcher->add(*iter);
 				if(*ppEd)
 					(*ppEd)->addMask(*iter);
 			}
@@ -2081,43 +2138,11 @@ bool KviChannelWindow::eventFilter(QObject * pObject, QEvent * pEvent)
 
 void KviChannelWindow::preprocessMessage(QString & szMessage)
 {
-	// FIXME: slow
-
 	KviIrcConnectionServerInfo * pServerInfo = serverInfo();
 	if(!pServerInfo)
 		return;
 
-	static QString szNonStandardLinkPrefix = QString::fromLatin1("\r![");
-
-	if(szMessage.contains(szNonStandardLinkPrefix))
-		return; // contains a non standard link that may contain spaces, do not break it.
-
-	QStringList strings = szMessage.split(" ", QString::KeepEmptyParts);
-	for(auto & it : strings)
-	{
-		if(it.contains('\r'))
-			continue;
-
-		QString szTmp = KviControlCodes::stripControlBytes(it).trimmed();
-		if(szTmp.length() < 1)
-			continue;
-
-		// FIXME: Do we REALLY need this ?
-		if(findEntry(it))
-		{
-			it = QString("\r!n\r%1\r").arg(it);
-			continue;
-		}
-
-		if(pServerInfo->supportedChannelTypes().contains(szTmp[0]))
-		{
-			if(it == szTmp)
-				it = QString("\r!c\r%1\r").arg(it);
-			else
-				it = QString("\r!c%1\r%2\r").arg(szTmp, it);
-		}
-	}
-	szMessage = strings.join(" ");
+	linkifyMessage(szMessage, pServerInfo, m_pUserListView);
 }
 
 void KviChannelWindow::unhighlight()
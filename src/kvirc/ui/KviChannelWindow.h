@@ -48,6 +48,7 @@
 #include <map>
 #include <vector>
 
+class KviChannelMaskMatcher;
 class KviConsoleWindow;
 class KviIrcMask;
 class KviMaskEditor;
@@ -177,6 +178,7 @@ protected:
 	QString m_szChannelMode;
 	std::map<char, QString> m_szChannelParameterModes;
 	std::map<char, std::vector<KviMaskEntry *>> m_ModeLists;
+	std::map<char, KviChannelMaskMatcher *> m_ModeListMatchers; // for the b, e and I lists only
 	KviPixmap m_privateBackground;
 	QDateTime m_joinTime;
 	QString m_szNameWithUserFlag;
@@ -311,6 +313,48 @@ public:
 	*/
 	size_t maskCount(char cMode) const { return this->modeMasks(cMode).size(); };
 
+	/**
+	* \brief Returns true if the masks of the specified mode list can be matched by matchingModeMasks()
+	*
+	* This is true for the ban (b), ban exception (e) and invite exception (I) lists.
+	* \param cMode The list mode
+	* \return bool
+	*/
+	static bool isMatchableModeList(char cMode) { return (cMode == 'b') || (cMode == 'e') || (cMode == 'I'); };
+
+	/**
+	* \brief Finds the masks of a channel list that match nick!user@host
+	*
+	* Only the lists for which isMatchableModeList() returns true are indexed:
+	* the lookup tests only a few masks even on lists with hundreds of bans.
+	* The extended bans and the other odd entries are skipped: see unindexedModeMasks().
+	* \param cMode The list mode
+	* \param szNick The nickname of the user
+	* \param szUser The username of the user
+	* \param szHost The hostname of the user
+	* \param lMatches Receives the matching masks
+	* \return void
+	*/
+	void matchingModeMasks(char cMode, const QString & szNick, const QString & szUser, const QString & szHost, std::vector<KviMaskEntry *> & lMatches);
+
+	/**
+	* \brief Returns the oldest mask of a channel list that matches nick!user@host
+	*
+	* See matchingModeMasks()
+	* \return KviMaskEntry *, nullptr if no mask matches
+	*/
+	KviMaskEntry * firstMatchingModeMask(char cMode, const QString & szNick, const QString & szUser, const QString & szHost);
+
+	/**
+	* \brief Returns the masks of a channel list that matchingModeMasks() doesn't look at
+	*
+	* These are the extended bans and the other entries that aren't a nick!user@host mask,
+	* in the order they have been added to the list.
+	* \param cMode The list mode
+	* \return const std::vector<KviMaskEntry *> &
+	*/
+	const std::vector<KviMaskEntry *> & unindexedModeMasks(char cMode) const;
+
 	/**
 	* \brief Called when someone sets a channel mode that is stored in a list; these modes require a parameter that is tipically a mask
 	*
@@ -968,9 +1012,10 @@ protected:
 	* \param l The list of masks in the channel lists
 	* \param ppEd The mask editor window
 	* \param szChangeMask If bAdd is false and this string is set, the mask will be updated instead that removed
+	* \param pMatcher The compiled form of the list, if any: it is kept in sync
 	* \return void
 	*/
-	void internalMask(const QString & szMask, bool bAdd, const QString & szSetBy, unsigned int uSetAt, std::vector<KviMaskEntry *> & l, KviMaskEditor ** ppEd, QString & szChangeMask);
+	void internalMask(const QString & szMask, bool bAdd, const QString & szSetBy, unsigned int uSetAt, std::vector<KviMaskEntry *> & l, KviMaskEditor ** ppEd, QString & szChangeMask, KviChannelMaskMatcher * pMatcher = nullptr);
 
 	/**
 	* \brief Splits the channel view into two views
@@ -69,6 +69,7 @@
 #include "KviKvsEventTriggers.h"
 #include "KviTalHBox.h"
 #include "KviNickColors.h"
+#include "KviMultiStringMatcher.h"
 
 #ifdef COMPILE_SSL_SUPPORT
 #include "KviSSLMaster.h"
@@ -79,7 +80,6 @@
 #include <QMessageBox>
 #include <QStringList>
 #include <QCloseEvent>
-#include <QRegExp>
 #include <QMenu>
 
 #include "kvi_debug.h"
@@ -136,6 +136,9 @@ KviConsoleWindow::KviConsoleWindow(int iFlags) : KviWindow(KviWindow::Console, _
 	m_pInput = new KviInput(this, m_pNotifyListView);
 
 	m_pTmpHighLightedChannels = new QStringList;
+	m_pHighlightMatcher = nullptr;
+	m_bHighlightMatcherWholeWords = false;
+	m_eHighlightMatcherCaseSensitivity = Qt::CaseSensitive;
 
 	applyOptions();
 }
@@ -187,6 +190,9 @@ KviConsoleWindow::~KviConsoleWindow()
 	m_pContext = nullptr;
 
 	delete m_pTmpHighLightedChannels;
+
+	if(m_pHighlightMatcher)
+		delete m_pHighlightMatcher;
 }
 
 void KviConsoleWindow::triggerCreationEvents()
@@ -584,6 +590,46 @@ void KviConsoleWindow::closeEvent(QCloseEvent * e)
 	g_pApp->quit();
 }
 
+// internal helper for applyHighlighting: rebuilds the matcher only when the options or the nickname change
+void KviConsoleWindow::updateHighlightMatcher()
+{
+	QString szNick;
+	if(KVI_OPTION_BOOL(KviOption_boolAlwaysHighlightNick) && connection())
+		szNick = connection()->userInfo()->nickName();
+	QStringList lWords;
+	if(KVI_OPTION_BOOL(KviOption_boolUseWordHighlighting))
+		lWords = KVI_OPTION_STRINGLIST(KviOption_stringlistHighlightWords); // shallow copy
+	bool bWholeWords = !KVI_OPTION_BOOL(KviOption_boolUseFullWordHighlighting);
+	QString szSplitters;
+	if(bWholeWords)
+		szSplitters = KVI_OPTION_STRING(KviOption_stringWordSplitters);
+	Qt::CaseSensitivity cs = KVI_OPTION_BOOL(KviOption_boolCaseSensitiveHighlighting) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+	// the string list comparison is immediate as long as the option isn't touched (shared data)
+	if(m_pHighlightMatcher && (m_bHighlightMatcherWholeWords == bWholeWords) && (m_eHighlightMatcherCaseSensitivity == cs)
+	    && (m_szHighlightMatcherNick == szNick) && (m_szHighlightMatcherSplitters == szSplitters) && (m_lHighlightMatcherWords == lWords))
+		return;
+
+	if(!m_pHighlightMatcher)
+		m_pHighlightMatcher = new KviMultiStringMatcher();
+	else
+		m_pHighlightMatcher->clear();
+
+	m_szHighlightMatcherNick = szNick;
+	m_lHighlightMatcherWords = lWords;
+	m_szHighlightMatcherSplitters = szSplitters;
+	m_bHighlightMatcherWholeWords = bWholeWords;
+	m_eHighlightMatcherCaseSensitivity = cs;
+
+	// the nickname comes first: it has the precedence over the words
+	m_pHighlightMatcher->addPattern(szNick);
+	for(auto & it : lWords)
+		m_pHighlightMatcher->addPattern(it);
+	m_pHighlightMatcher->setCaseSensitivity(cs);
+	m_pHighlightMatcher->setWholeWords(bWholeWords, szSplitters);
+	m_pHighlightMatcher->compile();
+}
+
 // internal helper for applyHighlighting
 int KviConsoleWindow::triggerOnHighlight(KviWindow * pWnd, int iType, const QString & szNick, const QString & szUser, const QString & szHost, const QString & szMsg, const QString & szTrigger)
 {
@@ -625,57 +671,17 @@ void KviConsoleWindow::removeHighlightedChannel(const QString & szChan)
 // if it returns -1 you should just return and not display the message
 int KviConsoleWindow::applyHighlighting(KviWindow * wnd, int type, const QString & nick, const QString & user, const QString & host, const QString & szMsg)
 {
-	QString szPattern = KVI_OPTION_STRING(KviOption_stringWordSplitters);
-	QString szSource;
-	QString szStripMsg = KviControlCodes::stripControlBytes(szMsg);
-	QRegExp rgxHlite;
-	Qt::CaseSensitivity cs = KVI_OPTION_BOOL(KviOption_boolCaseSensitiveHighlighting) ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-	if(KVI_OPTION_BOOL(KviOption_boolAlwaysHighlightNick) && connection())
-	{
-		if(KVI_OPTION_BOOL(KviOption_boolUseFullWordHighlighting))
-		{
-			if(szStripMsg.contains(connection()->userInfo()->nickName(), cs))
-				return triggerOnHighlight(wnd, type, nick, user, host, szMsg, connection()->userInfo()->nickName());
-		}
-		else
-		{
-			if(!szPattern.isEmpty())
-				rgxHlite.setPattern(
-				    QString("(?:[%1]|\\s|^)%2(?:[%1]|\\s|$)").arg(QRegExp::escape(szPattern), QRegExp::escape(connection()->userInfo()->nickName())));
-			else
-				rgxHlite.setPattern(
-				    QString("(?:\\s|^)%1(?:\\s|$)").arg(QRegExp::escape(connection()->userInfo()->nickName())));
-			rgxHlite.setCaseSensitivity(cs);
-			if(szStripMsg.contains(rgxHlite))
-				return triggerOnHighlight(wnd, type, nick, user, host, szMsg, connection()->userInfo()->nickName());
-		}
-	}
+	updateHighlightMatcher();
 
-	if(KVI_OPTION_BOOL(KviOption_boolUseWordHighlighting))
+	if(!m_pHighlightMatcher->isEmpty())
 	{
-		for(auto & it : KVI_OPTION_STRINGLIST(KviOption_stringlistHighlightWords))
+		// all the triggers are looked for in a single pass
+		int iTrigger = m_pHighlightMatcher->match(KviControlCodes::stripControlBytes(szMsg));
+		if(iTrigger >= 0)
 		{
-			if(it.isEmpty())
-				continue;
-
-			if(KVI_OPTION_BOOL(KviOption_boolUseFullWordHighlighting))
-			{
-				if(szStripMsg.contains(it, cs))
-					return triggerOnHighlight(wnd, type, nick, user, host, szMsg, it);
-			}
-			else
-			{
-				if(!szPattern.isEmpty())
-					rgxHlite.setPattern(
-					    QString("(?:[%1]|\\s|^)%2(?:[%1]|\\s|$)").arg(QRegExp::escape(szPattern), QRegExp::escape(it)));
-				else
-					rgxHlite.setPattern(
-					    QString("(?:\\s|^)%1(?:\\s|$)").arg(QRegExp::escape(it)));
-				rgxHlite.setCaseSensitivity(cs);
-				if(szStripMsg.contains(rgxHlite))
-					return triggerOnHighlight(wnd, type, nick, user, host, szMsg, it);
-			}
+			// the event handlers may rebuild the matcher: don't keep a reference into it
+			QString szTrigger = m_pHighlightMatcher->pattern(iTrigger);
+			return triggerOnHighlight(wnd, type, nick, user, host, szMsg, szTrigger);
 		}
 	}
 
@@ -47,6 +47,7 @@ class KviDnsResolver;
 class KviIrcUserDataBase;
 class KviIrcUserEntry;
 class KviIrcServer;
+class KviMultiStringMatcher;
 class KviIrcNetwork;
 class KviProxy;
 class KviUserListView;
@@ -95,6 +96,13 @@ protected:
 	QStringList * m_pTmpHighLightedChannels;
 	KviIrcContext * m_pContext;
 	QList<int> m_SplitterSizesList;
+	// the compiled highlighting triggers and the state they have been built for
+	KviMultiStringMatcher * m_pHighlightMatcher;
+	QString m_szHighlightMatcherNick;
+	QStringList m_lHighlightMatcherWords;
+	QString m_szHighlightMatcherSplitters;
+	bool m_bHighlightMatcherWholeWords;
+	Qt::CaseSensitivity m_eHighlightMatcherCaseSensitivity;
 
 protected:
 	// UI
@@ -116,7 +124,8 @@ protected:
 	virtual void saveProperties(KviConfigurationFile * cfg);
 
 	void destroyConnection();
-	// internal helper for applyHighlighting
+	// internal helpers for applyHighlighting
+	void updateHighlightMatcher();
 	int triggerOnHighlight(KviWindow * wnd, int type, const QString & nick, const QString & user, const QString & host, const QString & szMsg, const QString & trigger);
 
 	void showNotifyList(bool bShow, bool bIgnoreSizeChange = false);
@@ -0,0 +1,53 @@
+#ifndef _KVI_THEMEDTREEVIEW_H_
+#define _KVI_THEMEDTREEVIEW_H_
+//=============================================================================
+//
+//   File : KviThemedTreeView.h
+//   Creation date : Sun 18 Oct 2026 23:05:12 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "kvi_settings.h"
+
+#include <QTreeView>
+#include <QPainter>
+
+class KviWindow;
+
+class KVIRC_API KviThemedTreeView : public QTreeView
+{
+	Q_OBJECT
+	Q_PROPERTY(int TransparencyCapable READ dummyRead)
+public:
+	KviThemedTreeView(QWidget * par, KviWindow * pWindow, const char * name);
+	~KviThemedTreeView();
+
+protected:
+	KviWindow * m_pKviWindow;
+
+protected:
+	virtual void paintEvent(QPaintEvent * event);
+
+public:
+	int dummyRead() const { return 0; };
+	void applyOptions();
+};
+
+#endif //_KVI_THEMEDTREEVIEW_H_
@@ -399,6 +399,16 @@ public:
 	*/
 	KviUserListEntry * findEntry(const QString & szNick) { return szNick.isEmpty() ? 0 : m_pEntryDict->find(szNick); };
 
+	/**
+	* \brief Searches an entry in the userlist by a part of a longer string
+	*
+	* This is the same as findEntry(const QString &) but no string is built.
+	* If the nick is not found, it returns 0
+	* \param szNick The nickname to find
+	* \return KviUserListEntry *
+	*/
+	KviUserListEntry * findEntry(const QStringRef & szNick) { return szNick.isEmpty() ? 0 : m_pEntryDict->findRef(szNick); };
+
 	/**
 	* \brief Appends the selected nicknames to the buffer
 	* \param szBuffer The buffer to use
@@ -50,6 +50,8 @@
 #include "KviConsoleWindow.h"
 #include "KviIrcConnectionServerInfo.h"
 #include "KviControlCodes.h"
+#include "KviCompiledFormat.h"
+#include "KviUserListView.h"
 #include "KviWindowToolWidget.h"
 #include "KviKvsScript.h"
 #include "KviTalToolTip.h"
@@ -1212,13 +1214,20 @@ void KviWindow::internalOutput(KviIrcView * pView, int iMsgType, const kvi_wchar
 	m_pWindowListItem->highlight(KVI_OPTION_MSGTYPE(iMsgType).level());
 }
 
+// The output formats are mostly translated strings used over and over: they are parsed once.
+// The windows are used by the GUI thread only.
+static KviCompiledFormatCache * output_format_cache()
+{
+	static KviCompiledFormatCache cache;
+	return &cache;
+}
+
 void KviWindow::output(int iMsgType, const char * pcFormat, ...)
 {
-	QString szFmt(pcFormat);
 	kvi_va_list l;
 	kvi_va_start(l, pcFormat);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, pcFormat, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1232,7 +1241,7 @@ void KviWindow::output(int iMsgType, QString szFmt, ...)
 	kvi_va_list l;
 	kvi_va_start(l, szFmt);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, szFmt, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1243,11 +1252,10 @@ void KviWindow::output(int iMsgType, QString szFmt, ...)
 
 void KviWindow::output(int iMsgType, const kvi_wchar_t * pwFormat, ...)
 {
-	QString szFmt = QString::fromUtf8(KviCString(pwFormat).ptr());
 	kvi_va_list l;
 	kvi_va_start(l, pwFormat);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, pwFormat, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1258,11 +1266,10 @@ void KviWindow::output(int iMsgType, const kvi_wchar_t * pwFormat, ...)
 
 void KviWindow::output(int iMsgType, const QDateTime & datetime, const char * pcFormat, ...)
 {
-	QString szFmt(pcFormat);
 	kvi_va_list l;
 	kvi_va_start(l, pcFormat);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, pcFormat, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1276,7 +1283,7 @@ void KviWindow::output(int iMsgType, const QDateTime & datetime, QString szFmt,
 	kvi_va_list l;
 	kvi_va_start(l, szFmt);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, szFmt, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1287,11 +1294,10 @@ void KviWindow::output(int iMsgType, const QDateTime & datetime, QString szFmt,
 
 void KviWindow::output(int iMsgType, const QDateTime & datetime, const kvi_wchar_t * pwFormat, ...)
 {
-	QString szFmt = QString::fromUtf8(KviCString(pwFormat).ptr());
 	kvi_va_list l;
 	kvi_va_start(l, pwFormat);
 	QString szBuf;
-	KviQString::vsprintf(szBuf, szFmt, l);
+	output_format_cache()->vsprintf(szBuf, pwFormat, l);
 	kvi_va_end(l);
 	preprocessMessage(szBuf);
 	const QChar * pC = szBuf.constData();
@@ -1328,11 +1334,14 @@ void KviWindow::unhighlight()
 
 void KviWindow::preprocessMessage(QString & szMessage)
 {
-	// FIXME: slow
-
 	if(!m_pConsole || !m_pConsole->connection())
 		return;
 
+	linkifyMessage(szMessage, m_pConsole->connection()->serverInfo());
+}
+
+void KviWindow::linkifyMessage(QString & szMessage, KviIrcConnectionServerInfo * pServerInfo, KviUserListView * pUserList)
+{
 	static QString szNonStandardLinkPrefix = QString::fromLatin1("\r![");
 
 	if(szMessage.contains(szNonStandardLinkPrefix))
@@ -1340,24 +1349,99 @@ void KviWindow::preprocessMessage(QString & szMessage)
 
 	// FIXME: This STILL breaks $fmtlink() in certain configurations
 
-	QStringList strings = szMessage.split(" ");
-	for(auto & it : strings)
+	// The words are separated by single spaces. A word becomes a link if its text,
+	// without control codes and surrounding whitespace, starts with a channel type
+	// (or is a nickname in pUserList). Words that already contain escapes are left alone.
+	const QChar * pBuffer = szMessage.constData();
+	int iLen = szMessage.length();
+	QString szOut;  // allocated only when the first link is found
+	int iDone = 0;  // szMessage up to here has been copied to szOut
+	bool bChanged = false;
+
+	int iBegin = 0;
+	while(iBegin < iLen)
 	{
-		if(it.contains('\r'))
-			continue;
-		QString szTmp(it);
-		szTmp = KviControlCodes::stripControlBytes(szTmp).trimmed();
-		if(szTmp.length() < 1)
-			continue;
-		if(m_pConsole->connection()->serverInfo()->supportedChannelTypes().contains(szTmp[0]))
+		int iEnd = iBegin;
+		bool bLowChars = false; // control codes, '\r' and the like
+		while((iEnd < iLen) && (pBuffer[iEnd].unicode() != ' '))
+		{
+			if(pBuffer[iEnd].unicode() < 0x20)
+				bLowChars = true;
+			iEnd++;
+		}
+
+		if(iEnd > iBegin)
 		{
-			if(it == szTmp)
-				it = QString("\r!c\r%1\r").arg(it);
+			const QChar * pWord = pBuffer + iBegin;
+			int iWordLen = iEnd - iBegin;
+
+			QString szWord;
+			QString szText;
+			// FIXME: Do we REALLY need the nicknames ?
+			bool bNick = false;
+			if(bLowChars)
+			{
+				szWord = QString(pWord, iWordLen);
+				if(!szWord.contains('\r'))
+				{
+					szText = KviControlCodes::stripControlBytes(szWord).trimmed();
+					bNick = !szText.isEmpty() && pUserList && pUserList->findEntry(szWord);
+				}
+			}
 			else
-				it = QString("\r!c%1\r%2\r").arg(szTmp, it);
+			{
+				// no control codes: the text is the word without the surrounding whitespace
+				int iFirst = 0;
+				while((iFirst < iWordLen) && pWord[iFirst].isSpace())
+					iFirst++;
+				if(iFirst < iWordLen)
+				{
+					// the nickname is looked up in place: the strings are built for the links only
+					bNick = pUserList && pUserList->findEntry(QStringRef(&szMessage, iBegin, iWordLen));
+					if(bNick || pServerInfo->isSupportedChannelType(pWord[iFirst]))
+					{
+						szWord = QString(pWord, iWordLen);
+						szText = szWord.trimmed();
+					}
+				}
+			}
+
+			if(!szText.isEmpty())
+			{
+				if(bNick || pServerInfo->isSupportedChannelType(szText[0]))
+				{
+					if(!bChanged)
+					{
+						szOut.reserve(iLen + 32);
+						bChanged = true;
+					}
+					szOut.append(pBuffer + iDone, iBegin - iDone);
+					if(bNick)
+					{
+						szOut.append(QLatin1String("\r!n\r"));
+					}
+					else
+					{
+						szOut.append(QLatin1String("\r!c"));
+						if(szText.length() != iWordLen)
+							szOut.append(szText);
+						szOut.append(QChar('\r'));
+					}
+					szOut.append(szWord);
+					szOut.append(QChar('\r'));
+					iDone = iEnd;
+				}
+			}
 		}
+
+		iBegin = iEnd + 1;
 	}
-	szMessage = strings.join(" ");
+
+	if(!bChanged)
+		return;
+
+	szOut.append(pBuffer + iDone, iLen - iDone);
+	szMessage = szOut;
 }
 
 QTextCodec * KviWindow::defaultTextCodec()
@@ -56,6 +56,8 @@ class KviConfigurationFile;
 class KviIrcView;
 class KviConsoleWindow;
 class KviIrcConnection;
+class KviIrcConnectionServerInfo;
+class KviUserListView;
 class KviWindowToolPageButton;
 class QMenu;
 class KviTalHBox;
@@ -509,6 +511,9 @@ protected:
 	virtual bool focusNextPrevChild(bool bNext);
 
 	virtual void preprocessMessage(QString & szMessage);
+	// Turns the channel names in szMessage (and the nicknames in pUserList, if not null) into links.
+	// The message is scanned once and copied only when a link is added.
+	void linkifyMessage(QString & szMessage, KviIrcConnectionServerInfo * pServerInfo, KviUserListView * pUserList = nullptr);
 public slots:
 	void dock();
 	void undock();
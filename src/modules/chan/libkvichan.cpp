@@ -68,6 +68,47 @@ static KviChannelWindow * chan_kvs_find_channel(KviKvsModuleFunctionCall * c, QS
 	return nullptr;
 }
 
+// Returns the first mask of a channel list that matches szMask
+static KviMaskEntry * chan_kvs_find_matching_mask(KviChannelWindow * ch, char cMode, const QString & szMask)
+{
+	// a complete nick!user@host is looked up in the compiled form of the list:
+	// the hostmasks are matched part by part, as the servers do
+	if(KviChannelWindow::isMatchableModeList(cMode) && szMask.contains(QChar('!')) && szMask.contains(QChar('@')))
+	{
+		KviIrcMask mask(szMask);
+		KviMaskEntry * pFound = ch->firstMatchingModeMask(cMode, mask.nick(), mask.user(), mask.host());
+
+		// the extended bans and the odd entries are not in the index: they get the plain wildcard match
+		KviMaskEntry * pUnindexed = nullptr;
+		for(auto e : ch->unindexedModeMasks(cMode))
+		{
+			if(KviQString::matchString(e->szMask, szMask))
+			{
+				pUnindexed = e;
+				break;
+			}
+		}
+
+		if(!(pFound && pUnindexed))
+			return pFound ? pFound : pUnindexed;
+
+		// both kinds match: return the one that comes first in the list
+		for(auto e : ch->modeMasks(cMode))
+		{
+			if((e == pFound) || (e == pUnindexed))
+				return e;
+		}
+		return pFound;
+	}
+
+	for(auto e : ch->modeMasks(cMode))
+	{
+		if(KviQString::matchString(e->szMask, szMask))
+			return e;
+	}
+	return nullptr;
+}
+
 /*
 	@doc: chan.name
 	@type:
@@ -1515,6 +1556,10 @@ static bool chan_kvs_fnc_masklist(KviKvsModuleFunctionCall * c)
 		If [window_id] is empty, the current window is used.[br]
 		If the window designated by [window_id] is not a channel a warning is printed and an empty string is returned.[br]
 		This function is useful to determine if a ban set on the channel matches a user.[br]
+		When <complete_mask> is a complete nick!user@host mask, the nickname, username and hostname
+		of each ban mask are matched against the corresponding parts of <complete_mask>, as the IRC servers do.
+		The extended bans and any other mask are matched as wildcard expressions against the whole <complete_mask>,
+		and they match if they match any part of it.[br]
 */
 
 static bool chan_kvs_fnc_matchban(KviKvsModuleFunctionCall * c)
@@ -1533,23 +1578,11 @@ static bool chan_kvs_fnc_matchban(KviKvsModuleFunctionCall * c)
 		return true;
 	}
 
-	const std::vector<KviMaskEntry *> & l = ch->modeMasks('b');
-	if(l.empty())
-	{
+	KviMaskEntry * e = chan_kvs_find_matching_mask(ch, 'b', szMask);
+	if(e)
+		c->returnValue()->setString(e->szMask);
+	else
 		c->returnValue()->setNothing();
-		return true;
-	}
-
-	for(auto e : l)
-	{
-		if(KviQString::matchString(e->szMask, szMask))
-		{
-			c->returnValue()->setString(e->szMask);
-			return true;
-		}
-	}
-
-	c->returnValue()->setNothing();
 	return true;
 }
 
@@ -1569,6 +1602,10 @@ static bool chan_kvs_fnc_matchban(KviKvsModuleFunctionCall * c)
 		If [window_id] is empty, the current window is used.[br]
 		If the window designated by [window_id] is not a channel a warning is printed and an empty string is returned.[br]
 		This function is useful to determine if a ban exception set on the channel matches a user.[br]
+		When <complete_mask> is a complete nick!user@host mask, the nickname, username and hostname
+		of each ban exception mask are matched against the corresponding parts of <complete_mask>, as the IRC servers do.
+		The extended bans and any other mask are matched as wildcard expressions against the whole <complete_mask>,
+		and they match if they match any part of it.[br]
 */
 
 static bool chan_kvs_fnc_matchbanexception(KviKvsModuleFunctionCall * c)
@@ -1587,23 +1624,11 @@ static bool chan_kvs_fnc_matchbanexception(KviKvsModuleFunctionCall * c)
 		return true;
 	}
 
-	const std::vector<KviMaskEntry *> & l = ch->modeMasks('e');
-	if(l.empty())
-	{
+	KviMaskEntry * e = chan_kvs_find_matching_mask(ch, 'e', szMask);
+	if(e)
+		c->returnValue()->setString(e->szMask);
+	else
 		c->returnValue()->setNothing();
-		return true;
-	}
-
-	for(auto e : l)
-	{
-		if(KviQString::matchString(e->szMask, szMask))
-		{
-			c->returnValue()->setString(e->szMask);
-			return true;
-		}
-	}
-
-	c->returnValue()->setNothing();
 	return true;
 }
 
@@ -1623,6 +1648,10 @@ static bool chan_kvs_fnc_matchbanexception(KviKvsModuleFunctionCall * c)
 		If [window_id] is empty, the current window is used.[br]
 		If the window designated by [window_id] is not a channel a warning is printed and an empty string is returned.[br]
 		This function is useful to determine if a invite set on the channel matches a user.[br]
+		When <complete_mask> is a complete nick!user@host mask, the nickname, username and hostname
+		of each invite mask are matched against the corresponding parts of <complete_mask>, as the IRC servers do.
+		The extended bans and any other mask are matched as wildcard expressions against the whole <complete_mask>,
+		and they match if they match any part of it.[br]
 */
 
 static bool chan_kvs_fnc_matchinvite(KviKvsModuleFunctionCall * c)
@@ -1641,23 +1670,11 @@ static bool chan_kvs_fnc_matchinvite(KviKvsModuleFunctionCall * c)
 		return true;
 	}
 
-	const std::vector<KviMaskEntry *> & l = ch->modeMasks('I');
-	if(l.empty())
-	{
+	KviMaskEntry * e = chan_kvs_find_matching_mask(ch, 'I', szMask);
+	if(e)
+		c->returnValue()->setString(e->szMask);
+	else
 		c->returnValue()->setNothing();
-		return true;
-	}
-
-	for(auto e : l)
-	{
-		if(KviQString::matchString(e->szMask, szMask))
-		{
-			c->returnValue()->setString(e->szMask);
-			return true;
-		}
-	}
-
-	c->returnValue()->setNothing();
 	return true;
 }
 
@@ -1739,6 +1756,11 @@ static bool chan_kvs_fnc_matchqban(KviKvsModuleFunctionCall * c)
 		If the window designated by [window_id] is not a channel a warning is printed and an empty string is returned.[br]
 		Please note that some IRC servers use channel list modes not only to store masks, but also for other data such
 		as nicknames. This function should be able to match them as long as they are strings.[br]
+		For the ban (b), ban exception (e) and invite exception (I) lists, when <complete_mask> is a complete
+		nick!user@host mask, the nickname, username and hostname of each hostmask in the list are matched against
+		the corresponding parts of <complete_mask>, as the IRC servers do. The extended bans and the masks
+		of the other lists are matched as wildcard expressions against the whole <complete_mask>,
+		and they match if they match any part of it.[br]
 */
 
 static bool chan_kvs_fnc_matchmask(KviKvsModuleFunctionCall * c)
@@ -1760,23 +1782,11 @@ static bool chan_kvs_fnc_matchmask(KviKvsModuleFunctionCall * c)
 		return true;
 	}
 
-	const std::vector<KviMaskEntry *> & l = ch->modeMasks(cMode);
-	if(l.empty())
-	{
+	KviMaskEntry * e = chan_kvs_find_matching_mask(ch, cMode, szMask);
+	if(e)
+		c->returnValue()->setString(e->szMask);
+	else
 		c->returnValue()->setNothing();
-		return true;
-	}
-
-	for(auto e : l)
-	{
-		if(KviQString::matchString(e->szMask, szMask))
-		{
-			c->returnValue()->setString(e->szMask);
-			return true;
-		}
-	}
-
-	c->returnValue()->setNothing();
 	return true;
 }
 
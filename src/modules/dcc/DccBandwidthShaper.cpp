@@ -0,0 +1,327 @@
+//=============================================================================
+//
+//   File : DccBandwidthShaper.cpp
+//   Creation date : Sun 18 Oct 2026 15:12:40 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "DccBandwidthShaper.h"
+
+#include <chrono>
+
+// A bucket can hold up to this amount of time worth of tokens:
+// this is the maximum burst that an idle transfer can send out at once.
+#define DCC_BUCKET_MAX_BURST_MSECS 1000
+
+// Returned by msecsUntilAvailable() for a bucket that will never be refilled (rate 0)
+#define DCC_BUCKET_STALLED_WAIT_MSECS 1000
+
+DccBandwidthShaper * DccBandwidthShaper::m_pInstance = nullptr;
+
+DccTokenBucket::DccTokenBucket(unsigned int uRate)
+    : m_uRate(uRate), m_iTokens(((qint64)uRate) * DCC_BUCKET_MAX_BURST_MSECS), m_iLastRefillTime(DccBandwidthShaper::now())
+{
+}
+
+DccTokenBucket::~DccTokenBucket()
+    = default;
+
+void DccTokenBucket::setRate(unsigned int uRate)
+{
+	m_uRate.store(uRate);
+
+	// don't let the tokens accumulated with the old rate exceed the new burst size
+	qint64 iMax = ((qint64)uRate) * DCC_BUCKET_MAX_BURST_MSECS;
+	qint64 iTokens = m_iTokens.load();
+	while(iTokens > iMax)
+	{
+		if(m_iTokens.compare_exchange_weak(iTokens, iMax))
+			break;
+	}
+}
+
+void DccTokenBucket::refill(qint64 iNow)
+{
+	qint64 iLast = m_iLastRefillTime.load();
+	if(iNow <= iLast)
+		return;
+	// only one thread gets to add the tokens for a given time slice
+	if(!m_iLastRefillTime.compare_exchange_strong(iLast, iNow))
+		return;
+
+	qint64 iElapsed = iNow - iLast;
+	if(iElapsed > DCC_BUCKET_MAX_BURST_MSECS)
+		iElapsed = DCC_BUCKET_MAX_BURST_MSECS;
+
+	qint64 iRate = m_uRate.load();
+	qint64 iMax = iRate * DCC_BUCKET_MAX_BURST_MSECS;
+	qint64 iTokens = m_iTokens.load();
+	qint64 iNewTokens;
+	do
+	{
+		if(iTokens >= iMax)
+			return; // already full
+		iNewTokens = iTokens + (iElapsed * iRate);
+		if(iNewTokens > iMax)
+			iNewTokens = iMax;
+	} while(!m_iTokens.compare_exchange_weak(iTokens, iNewTokens));
+}
+
+unsigned int DccTokenBucket::consume(unsigned int uWanted, qint64 iNow)
+{
+	if(!isLimited())
+		return uWanted;
+
+	refill(iNow);
+
+	qint64 iTokens = m_iTokens.load();
+	qint64 iGranted;
+	do
+	{
+		iGranted = iTokens / 1000;
+		if(iGranted <= 0)
+			return 0;
+		if(iGranted > uWanted)
+			iGranted = uWanted;
+	} while(!m_iTokens.compare_exchange_weak(iTokens, iTokens - (iGranted * 1000)));
+
+	return (unsigned int)iGranted;
+}
+
+void DccTokenBucket::refund(unsigned int uBytes)
+{
+	if(!isLimited())
+		return;
+
+	// the bucket may have been refilled (or its rate lowered) in the meantime:
+	// never let a refund push it over the burst size
+	qint64 iMax = ((qint64)m_uRate.load()) * DCC_BUCKET_MAX_BURST_MSECS;
+	qint64 iTokens = m_iTokens.load();
+	qint64 iNewTokens;
+	do
+	{
+		if(iTokens >= iMax)
+			return; // already full
+		iNewTokens = iTokens + (((qint64)uBytes) * 1000);
+		if(iNewTokens > iMax)
+			iNewTokens = iMax;
+	} while(!m_iTokens.compare_exchange_weak(iTokens, iNewTokens));
+}
+
+int DccTokenBucket::msecsUntilAvailable(qint64 iNow)
+{
+	if(!isLimited())
+		return 0;
+
+	refill(iNow);
+
+	qint64 iTokens = m_iTokens.load();
+	if(iTokens >= 1000)
+		return 0;
+
+	qint64 iRate = m_uRate.load();
+	if(iRate == 0)
+		return DCC_BUCKET_STALLED_WAIT_MSECS;
+
+	qint64 iMSecs = ((1000 - iTokens) / iRate) + 1;
+	if(iMSecs > DCC_BUCKET_MAX_BURST_MSECS)
+		iMSecs = DCC_BUCKET_MAX_BURST_MSECS;
+	return (int)iMSecs;
+}
+
+DccBandwidthLimiter::DccBandwidthLimiter(Direction eDirection, const QString & szNick, unsigned int uRate)
+    : m_szNick(szNick), m_transferBucket(uRate)
+{
+	DccBandwidthShaper * s = DccBandwidthShaper::instance();
+	DccBandwidthNickEntry * e = s->referenceNick(szNick);
+	m_pNickBucket = (eDirection == Upload) ? &(e->upload) : &(e->download);
+	m_pGlobalBucket = s->globalBucket(eDirection);
+}
+
+DccBandwidthLimiter::~DccBandwidthLimiter()
+{
+	if(DccBandwidthShaper::instance())
+		DccBandwidthShaper::instance()->releaseNick(m_szNick);
+}
+
+unsigned int DccBandwidthLimiter::acquire(unsigned int uWanted)
+{
+	qint64 iNow = DccBandwidthShaper::now();
+
+	// walk the levels from the most specific one: each level can only
+	// shrink the grant, the excess taken from the previous levels is given back
+	unsigned int uTransfer = m_transferBucket.consume(uWanted, iNow);
+	if(uTransfer == 0)
+		return 0;
+
+	unsigned int uNick = m_pNickBucket->consume(uTransfer, iNow);
+	if(uNick < uTransfer)
+		m_transferBucket.refund(uTransfer - uNick);
+	if(uNick == 0)
+		return 0;
+
+	unsigned int uGlobal = m_pGlobalBucket->consume(uNick, iNow);
+	if(uGlobal < uNick)
+	{
+		m_transferBucket.refund(uNick - uGlobal);
+		m_pNickBucket->refund(uNick - uGlobal);
+	}
+	return uGlobal;
+}
+
+void DccBandwidthLimiter::refund(unsigned int uBytes)
+{
+	if(uBytes == 0)
+		return;
+	m_transferBucket.refund(uBytes);
+	m_pNickBucket->refund(uBytes);
+	m_pGlobalBucket->refund(uBytes);
+}
+
+int DccBandwidthLimiter::msecsUntilAvailable()
+{
+	qint64 iNow = DccBandwidthShaper::now();
+
+	int iWait = m_transferBucket.msecsUntilAvailable(iNow);
+	int iOther = m_pNickBucket->msecsUntilAvailable(iNow);
+	if(iOther > iWait)
+		iWait = iOther;
+	iOther = m_pGlobalBucket->msecsUntilAvailable(iNow);
+	if(iOther > iWait)
+		iWait = iOther;
+	return iWait;
+}
+
+DccBandwidthShaper::DccBandwidthShaper()
+{
+	m_pNickEntries = new KviPointerHashTable<QString, DccBandwidthNickEntry>(17, false);
+	m_pNickEntries->setAutoDelete(true);
+}
+
+DccBandwidthShaper::~DccBandwidthShaper()
+{
+	delete m_pNickEntries;
+}
+
+void DccBandwidthShaper::init()
+{
+	if(m_pInstance)
+		return;
+	m_pInstance = new DccBandwidthShaper();
+}
+
+void DccBandwidthShaper::done()
+{
+	if(!m_pInstance)
+		return;
+	delete m_pInstance;
+	m_pInstance = nullptr;
+}
+
+qint64 DccBandwidthShaper::now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+DccTokenBucket * DccBandwidthShaper::globalBucket(DccBandwidthLimiter::Direction eDirection)
+{
+	return (eDirection == DccBandwidthLimiter::Upload) ? &m_globalUpload : &m_globalDownload;
+}
+
+DccBandwidthLimiter * DccBandwidthShaper::createLimiter(DccBandwidthLimiter::Direction eDirection, const QString & szNick, unsigned int uRate)
+{
+	return new DccBandwidthLimiter(eDirection, szNick, uRate);
+}
+
+unsigned int DccBandwidthShaper::globalLimit(DccBandwidthLimiter::Direction eDirection)
+{
+	return globalBucket(eDirection)->rate();
+}
+
+void DccBandwidthShaper::setGlobalLimit(DccBandwidthLimiter::Direction eDirection, unsigned int uRate)
+{
+	if(uRate > MAX_DCC_BANDWIDTH_LIMIT)
+		uRate = MAX_DCC_BANDWIDTH_LIMIT;
+	globalBucket(eDirection)->setRate(uRate);
+}
+
+unsigned int DccBandwidthShaper::nickLimit(DccBandwidthLimiter::Direction eDirection, const QString & szNick)
+{
+	DccBandwidthNickEntry * e = m_pNickEntries->find(szNick);
+	if(!e)
+		return MAX_DCC_BANDWIDTH_LIMIT;
+	return (eDirection == DccBandwidthLimiter::Upload) ? e->upload.rate() : e->download.rate();
+}
+
+void DccBandwidthShaper::setNickLimit(DccBandwidthLimiter::Direction eDirection, const QString & szNick, unsigned int uRate)
+{
+	if(uRate > MAX_DCC_BANDWIDTH_LIMIT)
+		uRate = MAX_DCC_BANDWIDTH_LIMIT;
+
+	DccBandwidthNickEntry * e = m_pNickEntries->find(szNick);
+	if(!e)
+	{
+		if(uRate >= MAX_DCC_BANDWIDTH_LIMIT)
+			return; // nothing to do
+		e = new DccBandwidthNickEntry();
+		e->uRefs = 0;
+		m_pNickEntries->insert(szNick, e);
+	}
+
+	if(eDirection == DccBandwidthLimiter::Upload)
+		e->upload.setRate(uRate);
+	else
+		e->download.setRate(uRate);
+
+	releaseNickIfUnused(szNick, e);
+}
+
+DccBandwidthNickEntry * DccBandwidthShaper::referenceNick(const QString & szNick)
+{
+	DccBandwidthNickEntry * e = m_pNickEntries->find(szNick);
+	if(!e)
+	{
+		e = new DccBandwidthNickEntry();
+		e->uRefs = 0;
+		m_pNickEntries->insert(szNick, e);
+	}
+	e->uRefs++;
+	return e;
+}
+
+void DccBandwidthShaper::releaseNick(const QString & szNick)
+{
+	DccBandwidthNickEntry * e = m_pNickEntries->find(szNick);
+	if(!e)
+		return;
+	if(e->uRefs > 0)
+		e->uRefs--;
+	releaseNickIfUnused(szNick, e);
+}
+
+void DccBandwidthShaper::releaseNickIfUnused(const QString & szNick, DccBandwidthNickEntry * e)
+{
+	// keep the entries that are in use or carry a user defined limit
+	if(e->uRefs > 0)
+		return;
+	if(e->upload.isLimited() || e->download.isLimited())
+		return;
+	m_pNickEntries->remove(szNick);
+}
@@ -0,0 +1,157 @@
+#ifndef _DCCBANDWIDTHSHAPER_H_
+#define _DCCBANDWIDTHSHAPER_H_
+//=============================================================================
+//
+//   File : DccBandwidthShaper.h
+//   Creation date : Sun 18 Oct 2026 15:12:40 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// Bandwidth shaping for the DCC file transfers.
+//
+// Every transfer draws its data budget from a chain of three token buckets:
+// its own one, the one of the remote nickname and the global one of its
+// direction (upload or download). A byte may be transferred only when all
+// three buckets have a token for it.
+//
+// The buckets are lock-free: the transfer threads consume and refund tokens
+// with atomic operations while the GUI thread may change the rates at any time.
+//
+// The bucket objects themselves are created and destroyed in the GUI thread only.
+//
+
+#include "KviPointerHashTable.h"
+
+#include <QString>
+
+#include <atomic>
+
+// This limit, when multiplied by INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS
+// must fit in 31 bits (0x7fffffff)! (because of data size limits)
+// A bucket with a rate equal or greater than this is not limited at all.
+#define MAX_DCC_BANDWIDTH_LIMIT 0x1fffffff
+
+class DccTokenBucket
+{
+public:
+	DccTokenBucket(unsigned int uRate = MAX_DCC_BANDWIDTH_LIMIT);
+	~DccTokenBucket();
+
+protected:
+	std::atomic<unsigned int> m_uRate;    // bytes per second
+	std::atomic<qint64> m_iTokens;        // in milli-bytes: 1000 per byte
+	std::atomic<qint64> m_iLastRefillTime; // in msecs
+public:
+	unsigned int rate() const { return m_uRate.load(); };
+	bool isLimited() const { return m_uRate.load() < MAX_DCC_BANDWIDTH_LIMIT; };
+	void setRate(unsigned int uRate);
+	// takes up to uWanted bytes out of the bucket, returns the number of bytes granted
+	unsigned int consume(unsigned int uWanted, qint64 iNow);
+	// gives back bytes that were consumed but not transferred
+	void refund(unsigned int uBytes);
+	// returns the number of msecs before at least one byte can be consumed
+	int msecsUntilAvailable(qint64 iNow);
+
+protected:
+	void refill(qint64 iNow);
+};
+
+class DccBandwidthNickEntry
+{
+public:
+	DccTokenBucket upload;
+	DccTokenBucket download;
+	unsigned int uRefs;
+};
+
+class DccBandwidthLimiter
+{
+	friend class DccBandwidthShaper;
+
+public:
+	enum Direction
+	{
+		Upload,
+		Download
+	};
+
+protected:
+	// GUI thread only
+	DccBandwidthLimiter(Direction eDirection, const QString & szNick, unsigned int uRate);
+
+public:
+	~DccBandwidthLimiter();
+
+protected:
+	QString m_szNick;
+	DccTokenBucket m_transferBucket;
+	DccTokenBucket * m_pNickBucket;
+	DccTokenBucket * m_pGlobalBucket;
+
+public:
+	// GUI thread side
+	unsigned int rate() const { return m_transferBucket.rate(); };
+	void setRate(unsigned int uRate) { m_transferBucket.setRate(uRate); };
+	// transfer thread side
+	// takes up to uWanted bytes from all the levels, returns the number of bytes granted
+	unsigned int acquire(unsigned int uWanted);
+	void refund(unsigned int uBytes);
+	// returns 0 if acquire() would grant at least one byte, the msecs to wait otherwise
+	int msecsUntilAvailable();
+};
+
+class DccBandwidthShaper
+{
+protected:
+	DccBandwidthShaper();
+	~DccBandwidthShaper();
+
+protected:
+	static DccBandwidthShaper * m_pInstance;
+	DccTokenBucket m_globalUpload;
+	DccTokenBucket m_globalDownload;
+	KviPointerHashTable<QString, DccBandwidthNickEntry> * m_pNickEntries;
+
+public:
+	static void init();
+	static void done();
+	static DccBandwidthShaper * instance() { return m_pInstance; };
+	static qint64 now();
+
+	// creates the limiter chain for a new transfer: it must be deleted
+	// (in the GUI thread) after the transfer thread has been terminated
+	DccBandwidthLimiter * createLimiter(DccBandwidthLimiter::Direction eDirection, const QString & szNick, unsigned int uRate);
+
+	unsigned int globalLimit(DccBandwidthLimiter::Direction eDirection);
+	void setGlobalLimit(DccBandwidthLimiter::Direction eDirection, unsigned int uRate);
+	unsigned int nickLimit(DccBandwidthLimiter::Direction eDirection, const QString & szNick);
+	void setNickLimit(DccBandwidthLimiter::Direction eDirection, const QString & szNick, unsigned int uRate);
+
+protected:
+	DccTokenBucket * globalBucket(DccBandwidthLimiter::Direction eDirection);
+	DccBandwidthNickEntry * referenceNick(const QString & szNick);
+	void releaseNick(const QString & szNick);
+	void releaseNickIfUnused(const QString & szNick, DccBandwidthNickEntry * e);
+
+	friend class DccBandwidthLimiter;
+};
+
+#endif //_DCCBANDWIDTHSHAPER_H_
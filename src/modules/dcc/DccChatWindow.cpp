@@ -68,6 +68,12 @@
 
 extern DccBroker * g_pDccBroker;
 
+// The amount of data we try to read from the socket at once
+#define KVI_DCC_CHAT_READ_SIZE 32768
+
+// The slave thread wakes up at least this often even when nothing happens
+#define KVI_DCC_CHAT_IDLE_WAIT_MSECS 1000
+
 //
 // WINDOW
 //
@@ -415,6 +421,97 @@ void DccChatWindow::ownAction(const QString & text)
 	}
 }
 
+void DccChatWindow::handleIncomingLine(const KviCString & encoded)
+{
+	KviCString d = KviCString(decodeText(encoded.ptr()));
+	if(d.firstCharIs(0x01))
+	{
+		d.cutLeft(1);
+		if(d.lastCharIs(0x01))
+			d.cutRight(1);
+		if(kvi_strEqualCIN("ACTION", d.ptr(), 6))
+			d.cutLeft(6);
+		d.stripLeftWhiteSpace();
+		output(KVI_OUT_ACTION, "%Q %s", &(m_pDescriptor->szNick), d.ptr());
+		if(!hasAttention(KviWindow::MainWindowIsVisible))
+		{
+			if(KVI_OPTION_BOOL(KviOption_boolFlashDccChatWindowOnNewMessages))
+			{
+				demandAttention();
+			}
+			if(KVI_OPTION_BOOL(KviOption_boolPopupNotifierOnNewDccChatMessages))
+			{
+				QString szMsg = "<b>";
+				szMsg += m_pDescriptor->szNick;
+				szMsg += "</b> ";
+				szMsg += KviQString::toHtmlEscaped(QString(d.ptr()));
+				//qDebug("KviIrcServerParser_ctcp.cpp:975 debug: %s",szMsg.data());
+				g_pApp->notifierMessage(this, KVI_OPTION_MSGTYPE(KVI_OUT_ACTION).pixId(), szMsg, KVI_OPTION_UINT(KviOption_uintNotifierAutoHideTime));
+			}
+		}
+	}
+	else
+	{
+
+#ifdef COMPILE_CRYPT_SUPPORT
+		if(KviCryptSessionInfo * cinf = cryptSessionInfo())
+		{
+			if(cinf->m_bDoDecrypt)
+			{
+				KviCString decryptedStuff;
+				switch(cinf->m_pEngine->decrypt(d.ptr(), decryptedStuff))
+				{
+					case KviCryptEngine::DecryptOkWasEncrypted:
+					case KviCryptEngine::DecryptOkWasEncoded:
+					case KviCryptEngine::DecryptOkWasPlainText:
+						if(!KVS_TRIGGER_EVENT_2_HALTED(KviEvent_OnDCCChatMessage, this, QString(decryptedStuff.ptr()), m_pDescriptor->idString()))
+						{
+							g_pMainWindow->firstConsole()->outputPrivmsg(this, KVI_OUT_DCCCHATMSG,
+							    m_pDescriptor->szNick.toUtf8().data(), m_pDescriptor->szUser.toUtf8().data(),
+							    m_pDescriptor->szHost.toUtf8().data(), decryptedStuff.ptr());
+						}
+						return;
+						break;
+
+					default: // also case KviCryptEngine::DecryptError
+					{
+						QString szErr = cinf->m_pEngine->lastError();
+						output(KVI_OUT_SYSTEMERROR,
+						    __tr2qs_ctx("The following message appears to be encrypted, but the encryption engine failed to decode it: %Q", "dcc"),
+						    &szErr);
+					}
+					break;
+				}
+			}
+		}
+		else
+		{
+#endif
+			// FIXME!
+			if(!KVS_TRIGGER_EVENT_2_HALTED(KviEvent_OnDCCChatMessage, this, QString(d.ptr()), m_pDescriptor->idString()))
+			{
+				g_pMainWindow->firstConsole()->outputPrivmsg(this, KVI_OUT_DCCCHATMSG,
+				    m_pDescriptor->szNick.toUtf8().data(), m_pDescriptor->szUser.toUtf8().data(),
+				    m_pDescriptor->szHost.toUtf8().data(), d.ptr());
+				if(!hasAttention(KviWindow::MainWindowIsVisible))
+				{
+					if(KVI_OPTION_BOOL(KviOption_boolFlashDccChatWindowOnNewMessages))
+					{
+						demandAttention();
+					}
+					if(KVI_OPTION_BOOL(KviOption_boolPopupNotifierOnNewDccChatMessages))
+					{
+						QString szMsg = KviQString::toHtmlEscaped(QString(d.ptr()));
+						g_pApp->notifierMessage(this, KviIconManager::DccChatMsg, szMsg, KVI_OPTION_UINT(KviOption_uintNotifierAutoHideTime));
+					}
+				}
+			}
+#ifdef COMPILE_CRYPT_SUPPORT
+		}
+#endif
+	}
+}
+
 bool DccChatWindow::event(QEvent * e)
 {
 	if(e->type() == KVI_THREAD_EVENT)
@@ -432,98 +529,14 @@ bool DccChatWindow::event(QEvent * e)
 				return true;
 			}
 			break;
-			case KVI_DCC_THREAD_EVENT_DATA:
+			case KVI_DCC_THREAD_EVENT_LINES:
 			{
-				KviCString * encoded = ((KviThreadDataEvent<KviCString> *)e)->getData();
-				KviCString d = KviCString(decodeText(encoded->ptr()));
-				if(d.firstCharIs(0x01))
-				{
-					d.cutLeft(1);
-					if(d.lastCharIs(0x01))
-						d.cutRight(1);
-					if(kvi_strEqualCIN("ACTION", d.ptr(), 6))
-						d.cutLeft(6);
-					d.stripLeftWhiteSpace();
-					output(KVI_OUT_ACTION, "%Q %s", &(m_pDescriptor->szNick), d.ptr());
-					if(!hasAttention(KviWindow::MainWindowIsVisible))
-					{
-						if(KVI_OPTION_BOOL(KviOption_boolFlashDccChatWindowOnNewMessages))
-						{
-							demandAttention();
-						}
-						if(KVI_OPTION_BOOL(KviOption_boolPopupNotifierOnNewDccChatMessages))
-						{
-							QString szMsg = "<b>";
-							szMsg += m_pDescriptor->szNick;
-							szMsg += "</b> ";
-							szMsg += KviQString::toHtmlEscaped(QString(d.ptr()));
-							//qDebug("KviIrcServerParser_ctcp.cpp:975 debug: %s",szMsg.data());
-							g_pApp->notifierMessage(this, KVI_OPTION_MSGTYPE(KVI_OUT_ACTION).pixId(), szMsg, KVI_OPTION_UINT(KviOption_uintNotifierAutoHideTime));
-						}
-					}
-				}
-				else
-				{
-
-#ifdef COMPILE_CRYPT_SUPPORT
-					if(KviCryptSessionInfo * cinf = cryptSessionInfo())
-					{
-						if(cinf->m_bDoDecrypt)
-						{
-							KviCString decryptedStuff;
-							switch(cinf->m_pEngine->decrypt(d.ptr(), decryptedStuff))
-							{
-								case KviCryptEngine::DecryptOkWasEncrypted:
-								case KviCryptEngine::DecryptOkWasEncoded:
-								case KviCryptEngine::DecryptOkWasPlainText:
-									if(!KVS_TRIGGER_EVENT_2_HALTED(KviEvent_OnDCCChatMessage, this, QString(decryptedStuff.ptr()), m_pDescriptor->idString()))
-									{
-										g_pMainWindow->firstConsole()->outputPrivmsg(this, KVI_OUT_DCCCHATMSG,
-										    m_pDescriptor->szNick.toUtf8().data(), m_pDescriptor->szUser.toUtf8().data(),
-										    m_pDescriptor->szHost.toUtf8().data(), decryptedStuff.ptr());
-									}
-									delete encoded;
-									return true;
-									break;
-
-								default: // also case KviCryptEngine::DecryptError
-								{
-									QString szErr = cinf->m_pEngine->lastError();
-									output(KVI_OUT_SYSTEMERROR,
-									    __tr2qs_ctx("The following message appears to be encrypted, but the encryption engine failed to decode it: %Q", "dcc"),
-									    &szErr);
-								}
-								break;
-							}
-						}
-					}
-					else
-					{
-#endif
-						// FIXME!
-						if(!KVS_TRIGGER_EVENT_2_HALTED(KviEvent_OnDCCChatMessage, this, QString(d.ptr()), m_pDescriptor->idString()))
-						{
-							g_pMainWindow->firstConsole()->outputPrivmsg(this, KVI_OUT_DCCCHATMSG,
-							    m_pDescriptor->szNick.toUtf8().data(), m_pDescriptor->szUser.toUtf8().data(),
-							    m_pDescriptor->szHost.toUtf8().data(), d.ptr());
-							if(!hasAttention(KviWindow::MainWindowIsVisible))
-							{
-								if(KVI_OPTION_BOOL(KviOption_boolFlashDccChatWindowOnNewMessages))
-								{
-									demandAttention();
-								}
-								if(KVI_OPTION_BOOL(KviOption_boolPopupNotifierOnNewDccChatMessages))
-								{
-									QString szMsg = KviQString::toHtmlEscaped(QString(d.ptr()));
-									g_pApp->notifierMessage(this, KviIconManager::DccChatMsg, szMsg, KVI_OPTION_UINT(KviOption_uintNotifierAutoHideTime));
-								}
-							}
-						}
-#ifdef COMPILE_CRYPT_SUPPORT
-					}
-#endif
-				}
-				delete encoded;
+				std::deque<std::unique_ptr<KviCString>> lines;
+				if(m_pSlaveThread)
+					m_pSlaveThread->takeIncomingLines(lines);
+				// the whole batch is shown in a single event loop pass
+				for(auto & l : lines)
+					handleIncomingLine(*l);
 				return true;
 			}
 			break;
@@ -601,6 +614,11 @@ void DccChatWindow::connected()
 DccChatThread::DccChatThread(KviWindow * wnd, kvi_socket_t fd)
     : DccThread(wnd, fd)
 {
+	m_bLinesEventPending = false;
+	m_bBacklogFull = false;
+	m_uMaxBacklogLines = KVI_OPTION_UINT(KviOption_uintDccChatMaxBacklogLines);
+	if(m_uMaxBacklogLines < 1)
+		m_uMaxBacklogLines = 1;
 }
 
 void DccChatThread::run()
@@ -608,6 +626,7 @@ void DccChatThread::run()
 	KviDccThreadIncomingData data;
 	data.iLen = 0;
 	data.buffer = nullptr;
+	int iBufferSize = 0;
 
 	for(;;)
 	{
@@ -626,106 +645,105 @@ void DccChatThread::run()
 			}
 		}
 
+		m_pMutex->lock();
+		bool bWantWrite = !m_pOutBuffers.empty();
+		// when the window is lagging behind we stop reading and let the
+		// TCP flow control slow down the remote end
+		bool bWantRead = !m_bBacklogFull;
+		m_pMutex->unlock();
+
 		bool bCanRead;
 		bool bCanWrite;
-		if(kvi_select(m_fd, &bCanRead, &bCanWrite))
+		if(!waitForSocket(bWantRead, bWantWrite, &bCanRead, &bCanWrite, KVI_DCC_CHAT_IDLE_WAIT_MSECS))
+			continue; // timeout, or events to process, or more data to send
+
+		if(bCanWrite)
+		{
+			if(!tryFlushOutBuffers())
+				goto out_of_the_loop;
+		}
+		if(bCanRead)
 		{
-			if(bCanWrite)
+			if((iBufferSize - data.iLen) < KVI_DCC_CHAT_READ_SIZE)
 			{
-				if(!tryFlushOutBuffers())
-					goto out_of_the_loop;
+				iBufferSize = data.iLen + KVI_DCC_CHAT_READ_SIZE;
+				data.buffer = (char *)KviMemory::reallocate(data.buffer, iBufferSize * sizeof(char));
 			}
-			if(bCanRead)
-			{
-				data.buffer = (char *)KviMemory::reallocate(data.buffer, (data.iLen + 512) * sizeof(char));
-				int readLen;
+			int readLen;
 #ifdef COMPILE_SSL_SUPPORT
-				if(m_pSSL)
-				{
-					readLen = m_pSSL->read(data.buffer + data.iLen, 512);
-				}
-				else
-				{
+			if(m_pSSL)
+			{
+				readLen = m_pSSL->read(data.buffer + data.iLen, KVI_DCC_CHAT_READ_SIZE);
+			}
+			else
+			{
 #endif
-					readLen = kvi_socket_recv(m_fd, data.buffer + data.iLen, 512);
+				readLen = kvi_socket_recv(m_fd, data.buffer + data.iLen, KVI_DCC_CHAT_READ_SIZE);
 #ifdef COMPILE_SSL_SUPPORT
-				}
+			}
 #endif
-				if(readLen > 0)
-				{
-					data.iLen += readLen;
-					data.buffer = (char *)KviMemory::reallocate(data.buffer, data.iLen * sizeof(char));
-					if(!handleIncomingData(&data, false))
-						break; // non critical...
-				}
-				else
-				{
+			if(readLen > 0)
+			{
+				data.iLen += readLen;
+				if(!handleIncomingData(&data, false))
+					break; // non critical...
+			}
+			else
+			{
 
 #ifdef COMPILE_SSL_SUPPORT
-					if(m_pSSL)
+				if(m_pSSL)
+				{
+					// ssl error....?
+					switch(m_pSSL->getProtocolError(readLen))
 					{
-						// ssl error....?
-						switch(m_pSSL->getProtocolError(readLen))
-						{
-							case KviSSL::ZeroReturn:
-								readLen = 0;
-								break;
-							case KviSSL::WantRead:
-							case KviSSL::WantWrite:
-								// hmmm...
-								break;
-							case KviSSL::SyscallError:
-							{
-								int iE = m_pSSL->getLastError(true);
-								if(iE != 0)
-								{
-									raiseSSLError();
-									postErrorEvent(KviError::SSLError);
-									goto out_of_the_loop;
-								}
-							}
+						case KviSSL::ZeroReturn:
+							readLen = 0;
 							break;
-							case KviSSL::SSLError:
+						case KviSSL::WantRead:
+						case KviSSL::WantWrite:
+							// hmmm...
+							break;
+						case KviSSL::SyscallError:
+						{
+							int iE = m_pSSL->getLastError(true);
+							if(iE != 0)
 							{
 								raiseSSLError();
 								postErrorEvent(KviError::SSLError);
 								goto out_of_the_loop;
 							}
-							break;
-							default:
-								// Raise unknown SSL ERROR
-								postErrorEvent(KviError::SSLError);
-								goto out_of_the_loop;
-								break;
 						}
+						break;
+						case KviSSL::SSLError:
+						{
+							raiseSSLError();
+							postErrorEvent(KviError::SSLError);
+							goto out_of_the_loop;
+						}
+						break;
+						default:
+							// Raise unknown SSL ERROR
+							postErrorEvent(KviError::SSLError);
+							goto out_of_the_loop;
+							break;
 					}
+				}
 #endif
-					if(data.iLen > 0)
-					{
-						data.buffer = (char *)KviMemory::reallocate(data.buffer, data.iLen * sizeof(char));
-					}
-					else
-					{
-						KviMemory::free(data.buffer);
-						data.buffer = nullptr;
-					}
-
-					if(!handleInvalidSocketRead(readLen))
-					{
-						if(data.iLen)
-							handleIncomingData(&data, true); // critical
-						KVI_ASSERT(!data.iLen);
-						break; // error
-					}
+				if(!handleInvalidSocketRead(readLen))
+				{
+					if(data.iLen)
+						handleIncomingData(&data, true); // critical
+					KVI_ASSERT(!data.iLen);
+					break; // error
 				}
 			}
-			msleep(100);
 		}
 	}
 
 out_of_the_loop:
 
-	if(data.iLen)
+	if(data.buffer)
 		KviMemory::free(data.buffer);
 
 #ifdef COMPILE_SSL_SUPPORT
@@ -745,75 +763,84 @@ bool DccChatThread::handleIncomingData(KviDccThreadIncomingData * data, bool bCr
 {
 	KVI_ASSERT(data->iLen);
 	KVI_ASSERT(data->buffer);
+
+	// split all the complete lines in one pass, then move the incomplete tail
+	// to the beginning of the buffer only once
+	std::deque<std::unique_ptr<KviCString>> lines;
+	char * begin = data->buffer;
 	char * aux = data->buffer;
 	char * end = data->buffer + data->iLen;
 	while(aux != end)
 	{
 		if((*aux == '\n') || (*aux == '\0'))
 		{
-			KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_DATA);
-			// The left part is len chars long
-			int len = aux - data->buffer;
-			//			qDebug("LEN = %d, iLen = %d",len,data->iLen);
-			//#warning "DO IT BETTER (the \r cutting)"
-			KviCString * s = new KviCString(data->buffer, len);
+			KviCString * s = new KviCString(begin, aux - begin);
 			if(s->lastCharIs('\r'))
 				s->cutRight(1);
-			e->setData(s);
+			lines.emplace_back(s);
 			// but we cut also \n (or \0)
-			++aux;
-			// so len += 1; --> new data->iLen -= len;
-			data->iLen -= (len + 1);
-			//			qDebug("iLen now = %d",data->iLen);
-			KVI_ASSERT(data->iLen >= 0);
-			if(data->iLen > 0)
-			{
-				// memmove the remaining part to the beginning
-				// aux points after \n or \0
-				KviMemory::move(data->buffer, aux, data->iLen);
-				data->buffer = (char *)KviMemory::reallocate(data->buffer, data->iLen);
-				end = data->buffer + data->iLen;
-				aux = data->buffer;
-			}
-			else
-			{
-				// no more data in the buffer
-				KVI_ASSERT(data->iLen == 0);
-				KviMemory::free(data->buffer);
-				data->buffer = end = aux = nullptr;
-			}
-			postEvent(parent(), e);
+			begin = aux + 1;
 		}
-		else
-			aux++;
-		//		qDebug("PASSING CHAR %c",*aux);
+		aux++;
 	}
 	// now aux == end
-	if(bCritical)
+	if(bCritical && (begin != end))
 	{
 		// need to flush everything...
-		if(data->iLen > 0)
-		{
-			// in the last part there are no NULL and \n chars
-			KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_DATA);
-			KviCString * s = new KviCString(data->buffer, data->iLen);
-			if(s->lastCharIs('\r'))
-				s->cutRight(1);
-			e->setData(s);
-			data->iLen = 0;
-			KviMemory::free(data->buffer);
-			data->buffer = nullptr;
-			postEvent(parent(), e);
-		}
+		// in the last part there are no NULL and \n chars
+		KviCString * s = new KviCString(begin, end - begin);
+		if(s->lastCharIs('\r'))
+			s->cutRight(1);
+		lines.emplace_back(s);
+		begin = end;
 	}
+
+	data->iLen = end - begin;
+	if((data->iLen > 0) && (begin != data->buffer))
+		KviMemory::move(data->buffer, begin, data->iLen);
+
+	if(!lines.empty())
+		queueIncomingLines(lines);
 	return true;
 }
 
+void DccChatThread::queueIncomingLines(std::deque<std::unique_ptr<KviCString>> & lines)
+{
+	m_pMutex->lock();
+	for(auto & l : lines)
+		m_IncomingLines.push_back(std::move(l));
+	if(m_IncomingLines.size() >= m_uMaxBacklogLines)
+		m_bBacklogFull = true;
+	// a single event for all the lines that arrive until the window takes them
+	bool bPostEvent = !m_bLinesEventPending;
+	m_bLinesEventPending = true;
+	m_pMutex->unlock();
+
+	if(bPostEvent)
+		postEvent(parent(), new KviThreadEvent(KVI_DCC_THREAD_EVENT_LINES));
+}
+
+void DccChatThread::takeIncomingLines(std::deque<std::unique_ptr<KviCString>> & lines)
+{
+	m_pMutex->lock();
+	lines.swap(m_IncomingLines);
+	m_bLinesEventPending = false;
+	bool bWakeUp = m_bBacklogFull;
+	m_bBacklogFull = false;
+	m_pMutex->unlock();
+
+	// the slave may be sleeping with the reads disabled
+	if(bWakeUp)
+		eventEnqueued();
+}
+
 void DccChatThread::sendRawData(const void * buffer, int len)
 {
 	m_pMutex->lock();
 	m_pOutBuffers.emplace_back(new KviDataBuffer((unsigned int)len, (const unsigned char *)buffer));
 	m_pMutex->unlock();
+	// make the slave wait for the socket writability
+	eventEnqueued();
 }
 
 bool DccChatThread::tryFlushOutBuffers()
@@ -51,10 +51,16 @@ public:
 
 protected:
 	std::deque<std::unique_ptr<KviDataBuffer>> m_pOutBuffers;
+	// the received lines not yet taken by the window: protected by m_pMutex
+	std::deque<std::unique_ptr<KviCString>> m_IncomingLines;
+	bool m_bLinesEventPending; // a KVI_DCC_THREAD_EVENT_LINES is on its way
+	bool m_bBacklogFull;       // we stopped reading until the window takes the lines
+	unsigned int m_uMaxBacklogLines;
 
 protected:
 	virtual void run();
 	bool tryFlushOutBuffers();
+	void queueIncomingLines(std::deque<std::unique_ptr<KviCString>> & lines);
 	// This should handle the incoming data buffer
 	// must "eat" some data from data.buffer, memmove the remaining part
 	// to the beginning, kvi_realloc data.buffer and update data.iLen
@@ -66,6 +72,8 @@ protected:
 
 public:
 	virtual void sendRawData(const void * buffer, int len); // mutex (m_pOutBuffers usage)
+	// moves all the queued lines to the lines list, called by the window
+	void takeIncomingLines(std::deque<std::unique_ptr<KviCString>> & lines); // mutex (m_IncomingLines usage)
 };
 
 class DccChatWindow : public DccWindow
@@ -92,6 +100,7 @@ protected:
 	virtual QSize sizeHint() const;
 	virtual const QString & localNick();
 	virtual bool event(QEvent * e);
+	void handleIncomingLine(const KviCString & encoded);
 	virtual void ownMessage(const QString & text, bool bUserFeedback = true);
 	virtual void ownAction(const QString & text);
 	virtual void triggerCreationEvents();
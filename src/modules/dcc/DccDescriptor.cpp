@@ -87,6 +87,10 @@ DccDescriptor::DccDescriptor(KviConsoleWindow * pConsole)
 	bNoAcks = false;
 	bIsIncomingAvatar = false;
 
+	uSegmentStart = 0;
+	uSegmentEnd = 0;
+	uSegmentParentId = 0;
+
 	iSampleRate = 0;
 
 	m_bCreationEventTriggered = false;
@@ -187,6 +191,9 @@ void DccDescriptor::copyFrom(const DccDescriptor & src)
 	bShowMinimized = src.bShowMinimized;
 	bAutoAccept = src.bAutoAccept;
 	bIsIncomingAvatar = src.bIsIncomingAvatar;
+	uSegmentStart = src.uSegmentStart;
+	uSegmentEnd = src.uSegmentEnd;
+	uSegmentParentId = src.uSegmentParentId;
 	szLocalFileName = src.szLocalFileName;
 	szLocalFileSize = src.szLocalFileSize;
 #ifdef COMPILE_SSL_SUPPORT
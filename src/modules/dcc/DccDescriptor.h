@@ -129,6 +129,11 @@ public:
 
 	bool bIsIncomingAvatar; // It is an Incoming Avatar DCC SEND ?
 
+	// DCC SEGMENT (KVIrc parallel streams extension)
+	quint64 uSegmentStart;          // first byte of the range carried by this stream
+	quint64 uSegmentEnd;            // end of the range (excluded), 0 if this is not a segment
+	unsigned int uSegmentParentId;  // id of the descriptor of the main transfer
+
 	// DCC VOICE
 	KviCString szCodec; // codec name
 	int iSampleRate;    // Sample rate
@@ -153,6 +158,7 @@ public:
 	bool isFileDownload();
 	bool isDccChat();
 	bool isFileTransfer() { return (isFileUpload() || isFileDownload()); };
+	bool isSegment() const { return uSegmentEnd > 0; };
 #ifdef COMPILE_SSL_SUPPORT
 	bool isSSL() const
 	{
@@ -0,0 +1,90 @@
+//=============================================================================
+//
+//   File : DccExtensions.cpp
+//   Creation date : Sun 18 Oct 2026 19:42:16 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "DccExtensions.h"
+
+// KviCString::toULongLong() skips the blanks and silently wraps around on overflow:
+// the numbers received from the remote peer must be plain digits that fit.
+static bool dcc_parse_decimal(const KviCString & szNumber, quint64 uMax, quint64 & uValue)
+{
+	if(szNumber.isEmpty())
+		return false;
+
+	const char * p = szNumber.ptr();
+	uValue = 0;
+	while(*p)
+	{
+		if((*p < '0') || (*p > '9'))
+			return false;
+		quint64 uDigit = (quint64)(*p - '0');
+		if(uValue > ((uMax - uDigit) / 10))
+			return false; // overflow
+		uValue = (uValue * 10) + uDigit;
+		p++;
+	}
+	return true;
+}
+
+DccDigestMessage::Type dcc_parse_digest(const KviCString & szAlgorithm, const KviCString & szDigest)
+{
+	if(szAlgorithm.isEmpty())
+		return szDigest.isEmpty() ? DccDigestMessage::Request : DccDigestMessage::Malformed;
+
+	if(szDigest.isEmpty())
+		return DccDigestMessage::Malformed;
+
+	if(!szAlgorithm.equalsCI("SHA-256"))
+		return DccDigestMessage::UnsupportedAlgorithm;
+
+	if(szDigest.len() != KVI_DCC_SHA256_HEX_DIGEST_LENGTH)
+		return DccDigestMessage::Malformed;
+
+	for(const char * p = szDigest.ptr(); *p; p++)
+	{
+		if(!(((*p >= '0') && (*p <= '9')) || ((*p >= 'a') && (*p <= 'f')) || ((*p >= 'A') && (*p <= 'F'))))
+			return DccDigestMessage::Malformed;
+	}
+	return DccDigestMessage::Reply;
+}
+
+bool dcc_parse_segments_count(const KviCString & szCount, unsigned int & uCount)
+{
+	quint64 uValue;
+	if(!dcc_parse_decimal(szCount, 0xffffffffu, uValue))
+		return false;
+	if(uValue < 2)
+		return false;
+	uCount = (unsigned int)uValue;
+	return true;
+}
+
+bool dcc_parse_segment_range(const KviCString & szStart, const KviCString & szEnd, quint64 & uStart, quint64 & uEnd)
+{
+	quint64 uMax = ~((quint64)0);
+	if(!dcc_parse_decimal(szStart, uMax, uStart))
+		return false;
+	if(!dcc_parse_decimal(szEnd, uMax, uEnd))
+		return false;
+	return uStart < uEnd;
+}
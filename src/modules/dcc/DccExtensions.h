@@ -0,0 +1,63 @@
+#ifndef _DCCEXTENSIONS_H_
+#define _DCCEXTENSIONS_H_
+//=============================================================================
+//
+//   File : DccExtensions.h
+//   Creation date : Sun 18 Oct 2026 19:42:16 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// The arguments of the KVIrc extensions to the DCC protocol:
+//
+//      DCC DIGEST <filename> [<algorithm> <hexdigest>]
+//      DCC SEGMENTS <filename> <port> <count>
+//      DCC SEGMENT <filename> <ipaddr> <port> <start> <end>
+//
+// They come from the remote peer, so they are checked strictly here, before
+// anything is looked up. This depends only on kvilib (see src/tests).
+//
+
+#include "KviCString.h"
+
+// The length of a SHA-256 digest in hex digits
+#define KVI_DCC_SHA256_HEX_DIGEST_LENGTH 64
+
+namespace DccDigestMessage
+{
+	enum Type
+	{
+		Request,              // no algorithm and no digest: the receiver asks for it
+		Reply,                // SHA-256 and 64 hex digits
+		UnsupportedAlgorithm, // a well formed digest of another kind
+		Malformed
+	};
+}
+
+// Classifies the arguments of a DCC DIGEST message
+DccDigestMessage::Type dcc_parse_digest(const KviCString & szAlgorithm, const KviCString & szDigest);
+
+// Parses the stream count of a DCC SEGMENTS message: a decimal number of at least 2
+bool dcc_parse_segments_count(const KviCString & szCount, unsigned int & uCount);
+
+// Parses the range of a DCC SEGMENT message: two decimal numbers with start < end
+bool dcc_parse_segment_range(const KviCString & szStart, const KviCString & szEnd, quint64 & uStart, quint64 & uEnd);
+
+#endif //_DCCEXTENSIONS_H_
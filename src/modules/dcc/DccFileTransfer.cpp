@@ -50,6 +50,7 @@
 #include "KviIrcConnectionUserInfo.h"
 #include "KviIrcServerParser.h"
 #include "KviKvsScript.h"
+#include "KviSharedFilesManager.h"
 
 #ifdef COMPILE_ON_WINDOWS
 // Ugly Windoze compiler...
@@ -66,14 +67,22 @@
 #include <QEvent>
 #include <QCloseEvent>
 #include <QTimer>
-#include <QtEndian>
 
-#define INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS 3000
-#define INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS 3
-
-// This limit, when multiplied by INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS
-// must fit in 31 bits (0x7fffffff)! (because of data size limits)
-#define MAX_DCC_BANDWIDTH_LIMIT 0x1fffffff
+extern KVIRC_API KviSharedFilesManager * g_pSharedFilesManager;
+
+// Parallel streams (DCC SEGMENTS/SEGMENT, a KVIrc extension):
+// the receiver asks the sender to split the file with
+//      DCC SEGMENTS <filename> <port> <count>
+// and the sender shrinks the range of the running stream and offers
+// each of the remaining parts on a new listening socket with
+//      DCC SEGMENT <filename> <ipaddr> <port> <start> <end>
+#define KVI_DCC_MAX_PARALLEL_STREAMS 8
+// the files smaller than this are not worth splitting
+#define KVI_DCC_SEGMENTED_MIN_FILE_SIZE 67108864
+#define KVI_DCC_SEGMENT_MIN_SIZE 16777216
+// room left to the data that the running stream is sending while we split the file
+#define KVI_DCC_SEGMENT_SAFETY_MARGIN 4194304
+#define KVI_DCC_SEGMENT_ALIGNMENT 1048576
 
 // FIXME: The events OnDCCConnect etc are in wrong places here...!
 
@@ -84,1107 +93,6 @@ extern KVIRC_API KviMediaManager * g_pMediaManager; // KviApplication.cpp
 static KviPointerList<DccFileTransfer> * g_pDccFileTransfers = nullptr;
 static QPixmap * g_pDccFileTransferIcon = nullptr;
 
-//#warning "The events that have a KviCString data pointer should become real classes, that take care of deleting the data pointer!"
-//#warning "Otherwise, when left undispatched we will be leaking memory (event class destroyed but not the data ptr)"
-
-DccRecvThread::DccRecvThread(QObject * par, kvi_socket_t fd, KviDccRecvThreadOptions * opt)
-    : DccThread(par, fd)
-{
-	m_pOpt = opt;
-	m_uAverageSpeed = 0;
-	m_uInstantSpeed = 0;
-	m_uFilePosition = 0;
-
-	m_uTotalReceivedBytes = 0;
-	m_uInstantReceivedBytes = 0;
-	m_pFile = nullptr;
-	m_pTimeInterval = new KviMSecTimeInterval();
-	m_uStartTime = 0;
-	m_uInstantSpeedInterval = 0;
-}
-
-DccRecvThread::~DccRecvThread()
-{
-	if(m_pOpt)
-		delete m_pOpt;
-	if(m_pFile)
-		delete m_pFile;
-	delete m_pTimeInterval;
-}
-
-bool DccRecvThread::sendAck(qint64 filePos, bool bUse64BitAck)
-{
-	quint32 ack32 = htonl(filePos & 0xffffffff);
-	quint64 ack64 = qToBigEndian(filePos);
-
-	char * ack = (char *)&ack32;
-	int ackSize = 4;
-
-	if(bUse64BitAck)
-	{
-		ackSize = 8;
-		ack = (char *)&ack64;
-	}
-
-	int iRet = 0;
-#ifdef COMPILE_SSL_SUPPORT
-	if(m_pSSL)
-		iRet = m_pSSL->write(ack, ackSize);
-	else
-#endif //COMPILE_SSL_SUPPORT
-		iRet = kvi_socket_send(m_fd, (void *)(ack), ackSize);
-
-	if(iRet == ackSize)
-		return true; // everything sent
-
-	// When downloading from a fast server using send-ahead via an asymmetric link (such as the
-	// common ADSL lines) it may happen that the network output queue gets saturated with ACKs.
-	// In this case the network stack will refuse to send our packet and we get here.
-	//
-	// We should either retry to send the ACK in a while or avoid sending it at all (as with
-	// send-ahead acks aren't usually checked per-packet).
-
-	if(iRet == 0)
-	{
-		// We can live with this: no data has been sent at all
-		// Not sending the ack and hoping that the server will not stall is better than
-		// killing the connection from our side anyway.
-		return true;
-	}
-
-	if(iRet < 0)
-	{
-// Reported error. If it's EAGAIN or EINTR then no data has been sent.
-#ifdef COMPILE_SSL_SUPPORT
-		if(m_pSSL)
-		{
-			// dropping ack when no serious ssl error occurred
-			switch(m_pSSL->getProtocolError(iRet))
-			{
-				case KviSSL::ZeroReturn:
-				//return false; check eagain
-				case KviSSL::Success:
-				case KviSSL::WantRead:
-				case KviSSL::WantWrite:
-					return true;
-					break;
-				default:
-					// Raise unknown SSL ERROR
-					postErrorEvent(KviError::SSLError);
-					return false;
-					break;
-			}
-
-			return false;
-		}
-#endif //COMPILE_SSL_SUPPORT
-
-		int err = kvi_socket_error();
-#if defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW)
-		if((err != EAGAIN) && (err != EINTR) && (err != WSAEWOULDBLOCK))
-#else  //!(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
-		if((err != EAGAIN) && (err != EINTR))
-#endif //!(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
-		{
-			// some other kind of error
-			postErrorEvent(KviError::AcknowledgeError);
-			return false;
-		}
-
-		return true; // no data sent: same as iRet == 0 above.
-	}
-
-	// Sent something but not everything.
-	// How likely is it to get in here ?!
-	// Sleep for a short while and try to send the missing part.
-	// This will probably throttle the bandwidth usage a bit too.
-	msleep(10);
-
-	int iMissingPart = ackSize - iRet;
-
-#ifdef COMPILE_SSL_SUPPORT
-	if(m_pSSL)
-		iRet = m_pSSL->write(ack + iRet, iMissingPart);
-	else
-#endif //COMPILE_SSL_SUPPORT
-		iRet = kvi_socket_send(m_fd, (void *)(ack + iRet), iMissingPart);
-
-	if(iRet != iMissingPart)
-	{
-		// Crap.. couldn't send the missing part of the ack :/
-		postErrorEvent(KviError::AcknowledgeError);
-		return false;
-	}
-	return true;
-}
-
-void DccRecvThread::updateStats()
-{
-	m_uInstantSpeedInterval += m_pTimeInterval->mark();
-	unsigned long uCurTime = m_pTimeInterval->secondsCounter();
-
-	m_pMutex->lock();
-	unsigned long uElapsedTime = uCurTime - m_uStartTime;
-	if(uElapsedTime < 1)
-		uElapsedTime = 1;
-
-	m_uFilePosition = m_pFile->pos();
-	m_uAverageSpeed = m_uTotalReceivedBytes / uElapsedTime;
-
-	if(m_uInstantSpeedInterval > INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
-	{
-		unsigned int uMSecsOfTheNextInterval = 0;
-		if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS + (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS / 2)))
-			uMSecsOfTheNextInterval = m_uInstantSpeedInterval - INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
-		m_uInstantSpeed = (m_uInstantReceivedBytes * 1000) / m_uInstantSpeedInterval;
-		m_uInstantReceivedBytes = 0;
-		m_uInstantSpeedInterval = uMSecsOfTheNextInterval;
-	}
-	else
-	{
-		if(uElapsedTime <= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS)
-			m_uInstantSpeed = m_uAverageSpeed;
-	}
-	m_pMutex->unlock();
-}
-
-void DccRecvThread::postMessageEvent(const char * m)
-{
-	KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_MESSAGE);
-	e->setData(new KviCString(m));
-	postEvent(parent(), e);
-}
-
-// FIXME: This stuff should be somewhat related to the 1448 bytes TCP basic packet size
-//#define KVI_DCC_RECV_BLOCK_SIZE 8192
-//#define KVI_DCC_RECV_75PERCENTOF_BLOCK_SIZE 6150
-#define KVI_DCC_RECV_BLOCK_SIZE 16384
-#define KVI_DCC_RECV_75PERCENTOF_BLOCK_SIZE 12280
-
-void DccRecvThread::run()
-{
-	// take care of sleeping a bit if we can't read stuff
-	// so we don't hog the CPU too much...
-	int iFailedSelects = 0;
-	// take care of sleeping a bit if we get a lot of short reads
-	// so we don't hog the CPU too much...
-	int iShortReadQuantifier = 0;
-	// the algorithm is as follows:
-	//    attempt to read KVI_DCC_RECV_BLOCK_SIZE bytes
-	//    iShortReadQuantifier += ((KVI_DCC_RECV_75PERCENT_OF_BLOCK_SIZE - realReadedBytes) / 42);
-	// thus we gain points if we read less than 75% of the requested size
-	// and we loose points otherwise
-	// there are nearly 24 points per KB
-	//    if(iShortReadQuantifier > 10)
-	//       msleep(iShortReadQuantifier);
-	// also never sleep more than 500 msecs since it will
-	// rise our exit latency too much
-
-	m_pTimeInterval->mark();
-	m_pMutex->lock();
-	m_uStartTime = m_pTimeInterval->secondsCounter();
-	m_pMutex->unlock();
-
-	int iProbableTerminationTime = 0;
-
-	m_pFile = new QFile(QString::fromUtf8(m_pOpt->szFileName.ptr()));
-
-	bool bSend64BitAck = m_pOpt->bSend64BitAck && (m_pOpt->uTotalFileSize >> 32);
-
-	if(m_pOpt->bResume)
-	{
-		if(!m_pFile->open(QIODevice::WriteOnly | QIODevice::Append))
-		{
-			postErrorEvent(KviError::CantOpenFileForAppending);
-			goto exit_dcc;
-		} // else pFile is already at end
-	}
-	else
-	{
-		if(!m_pFile->open(QIODevice::WriteOnly))
-		{
-			postErrorEvent(KviError::CantOpenFileForWriting);
-			goto exit_dcc;
-		}
-	}
-
-	if(m_pOpt->bSendZeroAck && (!m_pOpt->bNoAcks))
-	{
-		if(!sendAck(m_pFile->pos(), bSend64BitAck))
-			goto exit_dcc;
-	}
-
-	for(;;)
-	{
-		// Dequeue events
-		while(KviThreadEvent * e = dequeueEvent())
-		{
-			if(e->id() == KVI_THREAD_EVENT_TERMINATE)
-			{
-				delete e;
-				goto exit_dcc;
-			}
-			else
-			{
-				// Other events are senseless to us
-				delete e;
-			}
-		}
-
-		bool bCanRead;
-		bool bDummy;
-
-		if(kvi_select(m_fd, &bCanRead, &bDummy, 15000))
-		{
-			// reset sleep time
-
-			if(bCanRead)
-			{
-				iFailedSelects = 0;
-
-				// Read a data block
-				char buffer[KVI_DCC_RECV_BLOCK_SIZE];
-
-				m_pMutex->lock(); // FIXME: how to remove this lock ?
-				unsigned int uMaxPossible = (m_pOpt->uMaxBandwidth < MAX_DCC_BANDWIDTH_LIMIT) ? m_pOpt->uMaxBandwidth * INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS : MAX_DCC_BANDWIDTH_LIMIT * INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS;
-				m_pMutex->unlock();
-				unsigned int uToRead = uMaxPossible > m_uInstantReceivedBytes ? uMaxPossible - m_uInstantReceivedBytes : 0;
-				if(uToRead > KVI_DCC_RECV_BLOCK_SIZE)
-					uToRead = KVI_DCC_RECV_BLOCK_SIZE;
-
-				if(uToRead > 0)
-				{
-					int readLen;
-#ifdef COMPILE_SSL_SUPPORT
-					if(m_pSSL)
-					{
-						readLen = m_pSSL->read(buffer, uToRead);
-					}
-					else
-					{
-#endif
-						readLen = kvi_socket_recv(m_fd, buffer, uToRead);
-#ifdef COMPILE_SSL_SUPPORT
-					}
-#endif
-
-					if(readLen > 0)
-					{
-						// Readed something useful...write back
-						if(((uint)(readLen + m_pFile->pos())) > m_pOpt->uTotalFileSize)
-						{
-							postMessageEvent(__tr_no_lookup_ctx("WARNING: the peer is sending garbage data past the end of the file", "dcc"));
-							postMessageEvent(__tr_no_lookup_ctx("WARNING: ignoring data past the declared end of file and closing the connection", "dcc"));
-
-							readLen = m_pOpt->uTotalFileSize - m_pFile->pos();
-							if(readLen > 0)
-							{
-								if(m_pFile->write(buffer, readLen) != readLen)
-									postErrorEvent(KviError::FileIOError);
-							}
-							break;
-						}
-						else
-						{
-							if(m_pFile->write(buffer, readLen) != readLen)
-							{
-								postErrorEvent(KviError::FileIOError);
-								break;
-							}
-						}
-
-						// Update stats
-						m_uTotalReceivedBytes += readLen;
-						m_uInstantReceivedBytes += readLen;
-
-						updateStats();
-						// Now send the ack
-						if(m_pOpt->bNoAcks)
-						{
-							// No acks...
-							// Interrupt if the whole file has been received
-							if(m_pOpt->uTotalFileSize > 0)
-							{
-								if((quint64)m_pFile->pos() == m_pOpt->uTotalFileSize)
-								{
-									// Received the whole file...die
-									KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-									postEvent(parent(), e);
-									break;
-								}
-							}
-						}
-						else
-						{
-							// Must send the ack... the peer must close the connection
-
-							if(!sendAck(m_pFile->pos(), bSend64BitAck))
-								break;
-						}
-
-						// now take care of short reads
-						iShortReadQuantifier += ((KVI_DCC_RECV_75PERCENTOF_BLOCK_SIZE - readLen) / 42);
-						if(iShortReadQuantifier > 10)
-						{
-							// we're having short reads.. sleep a while
-							// but don't allow it to go too high: 0.45 sec is really a lot
-							if(iShortReadQuantifier > 500)
-								iShortReadQuantifier = 500;
-							msleep(iShortReadQuantifier);
-						}
-						else
-						{
-							// don't allow it to go too low
-							if(iShortReadQuantifier < -500)
-								iShortReadQuantifier = -500;
-						}
-					}
-					else
-					{
-						updateStats();
-// Read problem...
-
-#ifdef COMPILE_SSL_SUPPORT
-						if(m_pSSL)
-						{
-							// ssl error....?
-							switch(m_pSSL->getProtocolError(readLen))
-							{
-								case KviSSL::ZeroReturn:
-									//check again not necessary a connection closure!
-									//if (!handleInvalidSocketRead(readLen)
-									// break;
-									readLen = 0;
-									break;
-								case KviSSL::Success:
-								case KviSSL::WantRead:
-								case KviSSL::WantWrite:
-									// hmmm... DO NOT CALL handleInvalidSocketRead
-									break;
-								case KviSSL::SyscallError:
-								{
-									int iE = m_pSSL->getLastError(true);
-									if(iE != 0)
-									{
-										raiseSSLError();
-										postErrorEvent(KviError::SSLError);
-										goto exit_dcc;
-									}
-								}
-								break;
-								case KviSSL::SSLError:
-								{
-									raiseSSLError();
-									postErrorEvent(KviError::SSLError);
-									goto exit_dcc;
-								}
-								break;
-								default:
-									// Raise unknown SSL ERROR
-									postErrorEvent(KviError::SSLError);
-									goto exit_dcc;
-									break;
-							}
-						}
-#endif
-
-						if(readLen == 0)
-						{
-							// read EOF..
-							if(((quint64)m_pFile->pos() == m_pOpt->uTotalFileSize) || (m_pOpt->uTotalFileSize == 0))
-							{
-								// success if we got the whole file or if we don't know the file size (we trust the peer)
-								KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-								postEvent(parent(), e);
-								break;
-							}
-						}
-#ifdef COMPILE_SSL_SUPPORT
-						if(!m_pSSL && !handleInvalidSocketRead(readLen))
-							break;
-#else
-						if(!handleInvalidSocketRead(readLen))
-							break;
-#endif
-					}
-				}
-				else
-				{
-					updateStats();
-
-					// reached the bandwidth limit: slow down a bit
-					if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS - 100))
-						msleep(100);
-					else if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS - 20))
-						msleep(20);
-				}
-			}
-			else
-			{
-				// Can't read stuff (can just write)
-				updateStats();
-
-				// sleep up to 300 msecs (if data arrives...we want low exit latency here)
-				if(iFailedSelects < 100)
-					iFailedSelects++;
-				updateStats();
-				if(iFailedSelects > 3)
-					msleep(3 * iFailedSelects);
-
-				if((quint64)m_pFile->pos() == m_pOpt->uTotalFileSize)
-				{
-					// Wait for the peer to close the connection
-					if(iProbableTerminationTime == 0)
-					{
-						iProbableTerminationTime = (int)kvi_unixTime();
-						m_pFile->flush();
-						postMessageEvent(__tr_no_lookup_ctx("Data transfer terminated, waiting 30 seconds for the peer to close the connection...", "dcc"));
-						// FIXME: Close the file ?
-					}
-					else
-					{
-						int iDiff = (((int)kvi_unixTime()) - iProbableTerminationTime);
-						if(iDiff > 30)
-						{
-							// success if we got the whole file or if we don't know the file size (we trust the peer)
-							postMessageEvent(__tr_no_lookup_ctx("Data transfer was terminated 30 seconds ago, closing the connection", "dcc"));
-							KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-							postEvent(parent(), e);
-							break;
-						}
-					}
-				}
-			}
-			// include the artificial delay if needed
-			if(m_pOpt->iIdleStepLengthInMSec > 0)
-				msleep(m_pOpt->iIdleStepLengthInMSec);
-		}
-		else
-		{
-			// sleep up to 200 msecs (if data arrives...we want low exit latency here)
-			if(iFailedSelects < 100)
-				iFailedSelects++;
-			updateStats();
-			if(iFailedSelects > 3)
-				msleep(2 * iFailedSelects);
-		}
-	}
-
-exit_dcc:
-	if(m_pFile)
-	{
-		m_pFile->close();
-		delete m_pFile;
-		m_pFile = nullptr;
-	}
-
-#ifdef COMPILE_SSL_SUPPORT
-	if(m_pSSL)
-	{
-		KviSSLMaster::freeSSL(m_pSSL);
-		m_pSSL = nullptr;
-	}
-#endif
-
-	kvi_socket_close(m_fd);
-	m_fd = KVI_INVALID_SOCKET;
-}
-
-void DccRecvThread::initGetInfo()
-{
-	m_pMutex->lock();
-}
-
-void DccRecvThread::doneGetInfo()
-{
-	m_pMutex->unlock();
-}
-
-DccSendThread::DccSendThread(QObject * par, kvi_socket_t fd, KviDccSendThreadOptions * opt)
-    : DccThread(par, fd)
-{
-	m_pOpt = opt;
-	// stats
-	m_uAverageSpeed = 0;
-	m_uInstantSpeed = 0;
-	m_uFilePosition = 0;
-	m_uTotalSentBytes = 0;
-	m_pTimeInterval = new KviMSecTimeInterval();
-	m_uStartTime = 0;
-	m_uInstantSpeedInterval = 0;
-}
-
-DccSendThread::~DccSendThread()
-{
-	if(m_pOpt)
-		delete m_pOpt;
-	delete m_pTimeInterval;
-}
-
-void DccSendThread::updateStats()
-{
-	m_uInstantSpeedInterval += m_pTimeInterval->mark();
-
-	m_pMutex->lock();
-	unsigned long uElapsedTime = m_pTimeInterval->secondsCounter() - m_uStartTime;
-	if(uElapsedTime < 1)
-		uElapsedTime = 1;
-
-	if(m_pOpt->bNoAcks)
-	{
-		// There are no acks : the avg bandwidth is based on the sent bytes
-		m_uAverageSpeed = m_uTotalSentBytes / uElapsedTime;
-	}
-	else
-	{
-		// acknowledges : we compute the avg bandwidth based on the acks we receive
-		m_uAverageSpeed = (m_uAckedBytes - m_pOpt->uStartPosition) / uElapsedTime;
-	}
-
-	if(m_uInstantSpeedInterval >= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
-	{
-		// we often overcount the time interval of 10-20 msecs
-		// and thus our bandwidth is used less than requested.
-		// for this reason we try to account the time in excess
-		// to the next period in order to balance the bandwidth usage.
-		unsigned long uMSecsOfNextPeriodUsed = 0;
-		if(m_uInstantSpeedInterval > INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
-		{
-			if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS + (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS / 2)))
-			{
-				uMSecsOfNextPeriodUsed = m_uInstantSpeedInterval - INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
-				m_uInstantSpeedInterval = INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
-			}
-			// else we have been delayed for a time comparable to a period
-			// and thus we can't recover the bandwidth... let it go as it does...
-		}
-		m_uInstantSpeed = (m_uInstantSentBytes * 1000) / m_uInstantSpeedInterval;
-		m_uInstantSpeedInterval = uMSecsOfNextPeriodUsed;
-		m_uInstantSentBytes = 0;
-	}
-	else
-	{
-		if(uElapsedTime <= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS)
-			m_uInstantSpeed = m_uAverageSpeed;
-	}
-	m_pMutex->unlock();
-}
-
-union _ack_buffer {
-	char cAckBuffer[4];
-	quint32 i32AckBuffer;
-};
-
-void DccSendThread::run()
-{
-	m_pTimeInterval->mark();
-	m_pMutex->lock();
-	m_uStartTime = m_pTimeInterval->secondsCounter();
-	m_pMutex->unlock();
-
-	m_uTotalSentBytes = 0;
-	m_uInstantSentBytes = 0;
-	int iFailedSelects = 0;
-	_ack_buffer ackbuffer;
-	int iBytesInAckBuffer = 0;
-	quint32 uLastAck = 0;
-	quint64 uTotLastAck = 0;
-	bool bAckHack = false;
-	quint64 iAckHackRounds = 0;
-
-	if(m_pOpt->iPacketSize < 32)
-		m_pOpt->iPacketSize = 32;
-	char * buffer = (char *)KviMemory::allocate(m_pOpt->iPacketSize * sizeof(char));
-
-	QFile * pFile = new QFile(QString::fromUtf8(m_pOpt->szFileName.ptr()));
-
-	if(!pFile->open(QIODevice::ReadOnly))
-	{
-		postErrorEvent(KviError::CantOpenFileForReading);
-		goto exit_dcc;
-	}
-
-	if(pFile->size() < 1)
-	{
-		postErrorEvent(KviError::CantSendAZeroSizeFile);
-		goto exit_dcc;
-	}
-
-	if(pFile->size() >= 0xffffffff)
-	{
-		//dcc acks support only files up to 4GiB
-		bAckHack = true;
-	}
-
-	if(m_pOpt->uStartPosition > 0)
-	{
-		// seek
-		if(!(pFile->seek(m_pOpt->uStartPosition)))
-		{
-			postErrorEvent(KviError::FileIOError);
-			goto exit_dcc;
-		}
-	}
-
-	uLastAck = m_pOpt->uStartPosition;
-
-	for(;;)
-	{
-		// Dequeue events
-		while(KviThreadEvent * e = dequeueEvent())
-		{
-			if(e->id() == KVI_THREAD_EVENT_TERMINATE)
-			{
-				delete e;
-				goto exit_dcc;
-			}
-			else
-			{
-				// Other events are senseless to us
-				delete e;
-			}
-		}
-
-		bool bCanRead;
-		bool bCanWrite;
-
-		if(kvi_select(m_fd, &bCanRead, &bCanWrite, 15000))
-		{
-			// reset the sleep time
-			iFailedSelects = 0;
-			if(bCanRead)
-			{
-				if(!m_pOpt->bNoAcks)
-				{
-					int iAckBytesToRead = 4 - iBytesInAckBuffer;
-
-					int readLen;
-#ifdef COMPILE_SSL_SUPPORT
-					if(m_pSSL)
-					{
-						readLen = m_pSSL->read((ackbuffer.cAckBuffer + iBytesInAckBuffer), iAckBytesToRead);
-					}
-					else
-					{
-#endif
-						readLen = kvi_socket_recv(m_fd, (ackbuffer.cAckBuffer + iBytesInAckBuffer), iAckBytesToRead);
-#ifdef COMPILE_SSL_SUPPORT
-					}
-#endif
-
-					if(readLen > 0)
-					{
-						iBytesInAckBuffer += readLen;
-						if(iBytesInAckBuffer == 4)
-						{
-							quint32 iNewAck = ntohl(ackbuffer.i32AckBuffer);
-							if(iNewAck > pFile->pos())
-							{
-								// the peer is drunk or is trying to fool us
-								postErrorEvent(KviError::AcknowledgeError);
-								break;
-							}
-							if(iNewAck < uLastAck)
-							{
-								if(bAckHack)
-								{
-									//we reached the 4gb ack limit
-									iAckHackRounds++;
-								}
-								else
-								{
-									// the peer is drunk or is trying to fool us
-									postErrorEvent(KviError::AcknowledgeError);
-									break;
-								}
-							}
-							uLastAck = iNewAck;
-							if(bAckHack)
-							{
-								uTotLastAck = (iAckHackRounds << 32) + iNewAck;
-							}
-							else
-							{
-
-								uTotLastAck = iNewAck;
-							}
-							iBytesInAckBuffer = 0;
-						}
-					}
-					else
-					{
-#ifdef COMPILE_SSL_SUPPORT
-						if(m_pSSL)
-						{
-							// ssl error....?
-							switch(m_pSSL->getProtocolError(readLen))
-							{
-
-								case KviSSL::ZeroReturn:
-									//if (!handleInvalidSocketRead(readLen)
-									// break;
-									readLen = 0;
-									break;
-								case KviSSL::Success:
-								case KviSSL::WantRead:
-								case KviSSL::WantWrite:
-									// hmmm...
-									break;
-								case KviSSL::SyscallError:
-								{
-									int iE = m_pSSL->getLastError(true);
-									if(iE != 0)
-									{
-										raiseSSLError();
-										postErrorEvent(KviError::SSLError);
-										goto exit_dcc;
-									}
-								}
-								break;
-								case KviSSL::SSLError:
-								{
-									raiseSSLError();
-									postErrorEvent(KviError::SSLError);
-									goto exit_dcc;
-								}
-								break;
-								default:
-									// Raise unknown SSL ERROR
-									postErrorEvent(KviError::SSLError);
-									goto exit_dcc;
-									break;
-							}
-						}
-
-						if(!m_pSSL && !handleInvalidSocketRead(readLen))
-							break;
-#else
-						if(!handleInvalidSocketRead(readLen))
-							break;
-#endif
-					}
-
-					// update stats
-					m_pMutex->lock(); // is this really necessary ?
-					m_uAckedBytes = uTotLastAck;
-					m_pMutex->unlock();
-
-					if(uLastAck >= (quint64)pFile->size())
-					{
-						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-						postEvent(parent(), e);
-						break;
-					}
-				}
-				else
-				{
-					// No acknowledges
-					if(m_pOpt->bIsTdcc)
-					{
-						// We expect the remote end to close the connection when the whole file has been sent
-						if(pFile->atEnd())
-						{
-							int iAck;
-							int readLen;
-#ifdef COMPILE_SSL_SUPPORT
-							if(m_pSSL)
-							{
-								readLen = m_pSSL->read((char *)&iAck, 4);
-							}
-							else
-							{
-#endif
-								readLen = kvi_socket_recv(m_fd, (char *)&iAck, 4);
-#ifdef COMPILE_SSL_SUPPORT
-							}
-#endif
-							if(readLen == 0)
-							{
-								// done...success
-								updateStats();
-								KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-								postEvent(parent(), e);
-								break;
-							}
-							else
-							{
-								if(readLen < 0)
-								{
-#ifdef COMPILE_SSL_SUPPORT
-									if(m_pSSL)
-									{
-										// ssl error....?
-										switch(m_pSSL->getProtocolError(readLen))
-										{
-
-											case KviSSL::ZeroReturn:
-												readLen = 0;
-												break;
-											case KviSSL::Success:
-											case KviSSL::WantRead:
-											case KviSSL::WantWrite:
-												// hmmm...
-												break;
-											case KviSSL::SyscallError:
-											{
-												int iE = m_pSSL->getLastError(true);
-												if(iE != 0)
-												{
-													raiseSSLError();
-													postErrorEvent(KviError::SSLError);
-													goto exit_dcc;
-												}
-											}
-											break;
-											case KviSSL::SSLError:
-											{
-												raiseSSLError();
-												postErrorEvent(KviError::SSLError);
-												goto exit_dcc;
-											}
-											break;
-											default:
-												// Raise unknown SSL ERROR
-												postErrorEvent(KviError::SSLError);
-												goto exit_dcc;
-												break;
-										}
-									}
-
-									if(!m_pSSL && !handleInvalidSocketRead(readLen))
-										break;
-#else
-									if(!handleInvalidSocketRead(readLen))
-										break;
-#endif
-								}
-								else
-								{
-									KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_MESSAGE);
-									e->setData(new KviCString(__tr2qs_ctx("WARNING: received data in a DCC TSEND, there should be no acknowledges", "dcc")));
-									postEvent(parent(), e);
-								}
-							}
-						}
-					}
-				}
-			}
-			if(bCanWrite)
-			{
-				if(!pFile->atEnd())
-				{
-					if(m_pOpt->bFastSend || m_pOpt->bNoAcks || (uLastAck == (quint64)pFile->pos()))
-					{
-						// maximum readable size
-						qint64 toRead = pFile->size() - pFile->pos();
-						// the max number of bytes we can send in this interval (bandwidth limit)
-						m_pMutex->lock(); // FIXME: how to remove this lock ?
-						uint uMaxPossible = m_pOpt->uMaxBandwidth < MAX_DCC_BANDWIDTH_LIMIT ? m_pOpt->uMaxBandwidth * INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS : MAX_DCC_BANDWIDTH_LIMIT * INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS;
-						m_pMutex->unlock();
-						if(uMaxPossible < m_uInstantSentBytes)
-							toRead = 0; // already sent too much!
-						else
-						{
-							uMaxPossible -= m_uInstantSentBytes;
-							if(toRead > uMaxPossible)
-								toRead = uMaxPossible;
-						}
-						// limit to packet size
-						if(toRead > m_pOpt->iPacketSize)
-							toRead = m_pOpt->iPacketSize;
-
-						int written = 0;
-						if(toRead > 0)
-						{
-							// read data
-							int readed = pFile->read(buffer, toRead);
-							if(readed < toRead)
-							{
-								postErrorEvent(KviError::FileIOError);
-								break;
-							}
-// send it out
-
-#ifdef COMPILE_SSL_SUPPORT
-							if(m_pSSL)
-							{
-								written = m_pSSL->write(buffer, toRead);
-							}
-							else
-							{
-#endif
-								written = kvi_socket_send(m_fd, buffer, toRead);
-#ifdef COMPILE_SSL_SUPPORT
-							}
-#endif
-
-							if(written < toRead)
-							{
-								if(written < 0)
-								{
-#ifdef COMPILE_SSL_SUPPORT
-									if(m_pSSL)
-									{
-										// ops...might be an SSL error
-										switch(m_pSSL->getProtocolError(written))
-										{
-											case KviSSL::Success:
-											case KviSSL::WantWrite:
-											case KviSSL::WantRead:
-												// Async continue...
-												goto handle_system_error;
-												break;
-											case KviSSL::SyscallError:
-												if(written == 0)
-												{
-													raiseSSLError();
-													postErrorEvent(KviError::RemoteEndClosedConnection);
-													goto exit_dcc;
-												}
-												else
-												{
-													int iSSLErr = m_pSSL->getLastError(true);
-													if(iSSLErr != 0)
-													{
-														raiseSSLError();
-														postErrorEvent(KviError::SSLError);
-														goto exit_dcc;
-													}
-													else
-													{
-														goto handle_system_error;
-													}
-												}
-												break;
-											case KviSSL::SSLError:
-												raiseSSLError();
-												postErrorEvent(KviError::SSLError);
-												goto exit_dcc;
-												break;
-											default:
-												postErrorEvent(KviError::SSLError);
-												goto exit_dcc;
-												break;
-										}
-									}
-
-									if(!m_pSSL && !handleInvalidSocketRead(written))
-										break;
-
-#else
-									if(!handleInvalidSocketRead(written))
-										break;
-#endif
-
-								handle_system_error:
-									int err = kvi_socket_error();
-#if defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW)
-									if((err != EAGAIN) && (err != EINTR) && (err != WSAEWOULDBLOCK))
-#else
-									if((err != EAGAIN) && (err != EINTR))
-#endif
-									{
-										postErrorEvent(KviError::translateSystemError(err));
-										goto exit_dcc;
-									}
-								}
-								else
-								{
-									// seek back to the right position
-									pFile->seek(pFile->pos() - (toRead - written));
-								}
-							}
-						}
-						else
-						{
-							// just nothing to send out in this interval
-							// sleep a while
-							if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS - 100))
-							{
-								msleep(100);
-							}
-							else if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS - 20))
-							{
-								msleep(20);
-							}
-						}
-
-						m_uTotalSentBytes += written;
-						m_uInstantSentBytes += written;
-						m_uFilePosition = pFile->pos();
-						updateStats();
-					}
-				}
-				else
-				{
-					if(m_pOpt->bNoAcks && !m_pOpt->bIsTdcc)
-					{
-						// at end of the file in a blind dcc send...
-						// not in a tdcc: we can close the file...
-						updateStats();
-						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
-						postEvent(parent(), e);
-						break;
-					}
-					else
-					{
-						// upload finished but we're waiting for the last ack
-						// sleep a bit: don't lag the kernie too much while waiting
-						msleep(100);
-					}
-				}
-			}
-		}
-		else
-		{
-			// after 2 failed selects start to sleep
-			if(iFailedSelects > 3)
-			{
-				// sleep up to 200 msecs
-				if(iFailedSelects < 100)
-					iFailedSelects++;
-				msleep(3 * iFailedSelects);
-			}
-			else
-			{
-				iFailedSelects++;
-			}
-		}
-
-		// include the artificial delay if needed
-		if(m_pOpt->iIdleStepLengthInMSec > 0)
-		{
-			msleep(m_pOpt->iIdleStepLengthInMSec);
-		}
-	}
-
-exit_dcc:
-	KviMemory::free(buffer);
-	pFile->close();
-	delete pFile;
-	pFile = nullptr;
-
-#ifdef COMPILE_SSL_SUPPORT
-	if(m_pSSL)
-	{
-		KviSSLMaster::freeSSL(m_pSSL);
-		m_pSSL = nullptr;
-	}
-#endif
-	kvi_socket_close(m_fd);
-	m_fd = KVI_INVALID_SOCKET;
-}
-
-void DccSendThread::initGetInfo()
-{
-	m_pMutex->lock();
-}
-
-void DccSendThread::doneGetInfo()
-{
-	m_pMutex->unlock();
-}
-
 DccFileTransfer::DccFileTransfer(DccDescriptor * dcc)
     : KviFileTransfer()
 {
@@ -1193,6 +101,14 @@ DccFileTransfer::DccFileTransfer(DccDescriptor * dcc)
 
 	m_pResumeTimer = nullptr;
 	m_pBandwidthDialog = nullptr;
+	m_bDigestRequested = false;
+	m_bSegmentsRequested = false;
+	m_bSegmented = false;
+	m_bRangeCompleted = false;
+	m_bSegmentReported = false;
+	m_uSegmentedBytes = 0;
+	m_uPendingSegments = 0;
+	m_uFailedSegments = 0;
 
 	m_szTransferIdString = QString(__tr2qs_ctx("TRANSFER %1", "dcc")).arg(id());
 
@@ -1229,11 +145,17 @@ DccFileTransfer::DccFileTransfer(DccDescriptor * dcc)
 	m_uTotalFileSize = dcc->bRecvFile ? dcc->szFileSize.toULongLong(&bOk) : dcc->szLocalFileSize.toULongLong(&bOk);
 	if(!bOk)
 		m_uTotalFileSize = 0;
+	m_uRangeEnd = m_uTotalFileSize;
+
+	if(m_pDescriptor->isSegment())
+		m_szTransferIdString = QString(__tr2qs_ctx("TRANSFER %1 (bytes %2 to %3)", "dcc")).arg(id()).arg(m_pDescriptor->uSegmentStart).arg(m_pDescriptor->uSegmentEnd);
 
 	if(m_pDescriptor->bRecvFile)
-		m_uMaxBandwidth = KVI_OPTION_BOOL(KviOption_boolLimitDccRecvSpeed) ? KVI_OPTION_UINT(KviOption_uintMaxDccRecvSpeed) : MAX_DCC_BANDWIDTH_LIMIT;
+		m_pBandwidthLimiter = DccBandwidthShaper::instance()->createLimiter(DccBandwidthLimiter::Download, m_pDescriptor->szNick,
+		    KVI_OPTION_BOOL(KviOption_boolLimitDccRecvSpeed) ? KVI_OPTION_UINT(KviOption_uintMaxDccRecvSpeed) : MAX_DCC_BANDWIDTH_LIMIT);
 	else
-		m_uMaxBandwidth = KVI_OPTION_BOOL(KviOption_boolLimitDccSendSpeed) ? KVI_OPTION_UINT(KviOption_uintMaxDccSendSpeed) : MAX_DCC_BANDWIDTH_LIMIT;
+		m_pBandwidthLimiter = DccBandwidthShaper::instance()->createLimiter(DccBandwidthLimiter::Upload, m_pDescriptor->szNick,
+		    KVI_OPTION_BOOL(KviOption_boolLimitDccSendSpeed) ? KVI_OPTION_UINT(KviOption_uintMaxDccSendSpeed) : MAX_DCC_BANDWIDTH_LIMIT);
 
 	startConnection();
 }
@@ -1242,6 +164,8 @@ DccFileTransfer::~DccFileTransfer()
 {
 	g_pDccFileTransfers->removeRef(this);
 
+	reportSegmentTermination(false);
+
 	if(m_pResumeTimer)
 		delete m_pResumeTimer;
 	if(m_pBandwidthDialog)
@@ -1263,6 +187,9 @@ DccFileTransfer::~DccFileTransfer()
 
 	KviThreadManager::killPendingEvents(this);
 
+	// the slave threads are gone: nobody is using the limiter anymore
+	delete m_pBandwidthLimiter;
+
 	delete m_pDescriptor;
 	delete m_pMarshal;
 }
@@ -1402,7 +329,7 @@ void DccFileTransfer::abort()
 	if(m_pMarshal)
 		m_pMarshal->abort();
 
-	if(m_pDescriptor->bRecvFile)
+	if(m_pDescriptor->bRecvFile && !m_pDescriptor->isSegment())
 		g_pApp->fileDownloadTerminated(false, m_pDescriptor->szFileName.toUtf8().data(), m_pDescriptor->szLocalFileName.toUtf8().data(), m_pDescriptor->szNick.toUtf8().data(), __tr_ctx("Aborted", "dcc"));
 
 	QString tmp;
@@ -1423,6 +350,8 @@ void DccFileTransfer::abort()
 
 	outputAndLog(KVI_OUT_DCCERROR, m_szStatusString);
 	displayUpdate();
+
+	reportSegmentTermination(false);
 }
 
 void DccFileTransfer::fillContextPopup(QMenu * m)
@@ -1515,57 +444,18 @@ bool DccFileTransfer::active()
 
 int DccFileTransfer::bandwidthLimit()
 {
-	int iLimit = m_uMaxBandwidth; // we have the cached value anyway...
-	if(m_pDescriptor->bRecvFile)
-	{
-		if(m_pSlaveRecvThread)
-		{
-			m_pSlaveRecvThread->initGetInfo();
-			iLimit = (int)m_pSlaveRecvThread->bandwidthLimit();
-			m_pSlaveRecvThread->doneGetInfo();
-			if(iLimit < 0)
-				iLimit = MAX_DCC_BANDWIDTH_LIMIT;
-		}
-	}
-	else
-	{
-		if(m_pSlaveSendThread)
-		{
-			m_pSlaveSendThread->initGetInfo();
-			iLimit = (int)m_pSlaveSendThread->bandwidthLimit();
-			m_pSlaveSendThread->doneGetInfo();
-			if(iLimit < 0)
-				iLimit = MAX_DCC_BANDWIDTH_LIMIT;
-		}
-	}
-	return iLimit;
+	// the limiter is shared with the slave thread and the rate is atomic: no need to lock
+	return (int)m_pBandwidthLimiter->rate();
 }
 
 void DccFileTransfer::setBandwidthLimit(int iVal)
 {
 	if(iVal < 0)
-		iVal = MAX_DCC_BANDWIDTH_LIMIT;
-	if(iVal > MAX_DCC_BANDWIDTH_LIMIT)
-		iVal = MAX_DCC_BANDWIDTH_LIMIT;
-	m_uMaxBandwidth = iVal;
-	if(m_pDescriptor->bRecvFile)
-	{
-		if(m_pSlaveRecvThread)
-		{
-			m_pSlaveRecvThread->initGetInfo();
-			m_pSlaveRecvThread->setBandwidthLimit(iVal);
-			m_pSlaveRecvThread->doneGetInfo();
-		}
-	}
-	else
-	{
-		if(m_pSlaveSendThread)
-		{
-			m_pSlaveSendThread->initGetInfo();
-			m_pSlaveSendThread->setBandwidthLimit(iVal);
-			m_pSlaveSendThread->doneGetInfo();
-		}
-	}
+		iVal = MAX_DCC_BANDWIDTH_LIMIT;
+	if(iVal > MAX_DCC_BANDWIDTH_LIMIT)
+		iVal = MAX_DCC_BANDWIDTH_LIMIT;
+	// this applies immediately to the running slave thread
+	m_pBandwidthLimiter->setRate(iVal);
 }
 
 unsigned int DccFileTransfer::averageSpeed()
@@ -1909,6 +799,8 @@ void DccFileTransfer::init()
 	g_pDccFileTransfers = new KviPointerList<DccFileTransfer>;
 	g_pDccFileTransfers->setAutoDelete(false);
 
+	DccBandwidthShaper::init();
+
 	QPixmap * pix = g_pIconManager->getImage("kvi_dccfiletransfericons.png", false);
 	if(pix)
 		g_pDccFileTransferIcon = new QPixmap(*pix);
@@ -1924,6 +816,7 @@ void DccFileTransfer::done()
 		delete t;
 	delete g_pDccFileTransfers;
 	g_pDccFileTransfers = nullptr;
+	DccBandwidthShaper::done();
 	if(g_pDccFileTransferIcon)
 		delete g_pDccFileTransferIcon;
 	g_pDccFileTransferIcon = nullptr;
@@ -1997,6 +890,386 @@ bool DccFileTransfer::handleResumeRequest(const char * filename, const char * po
 	return false;
 }
 
+bool DccFileTransfer::handleDigestRequest(const QString & szNick, const QString & szFileName)
+{
+	if(!g_pDccFileTransfers)
+		return false;
+
+	for(DccFileTransfer * t = g_pDccFileTransfers->last(); t; t = g_pDccFileTransfers->prev())
+	{
+		if(t->m_pDescriptor->bRecvFile || (t->m_eGeneralStatus == Failure))
+			continue;
+		if(!(KviQString::equalCI(t->m_pDescriptor->szNick, szNick) && KviQString::equalCI(t->m_pDescriptor->szFileName, szFileName)))
+			continue;
+
+		// if the digest isn't cached it will be sent when the shared files manager is done hashing the file
+		t->m_bDigestRequested = true;
+		connect(g_pSharedFilesManager, SIGNAL(digestReady(const QString &, const QString &)), t, SLOT(sharedFileDigestReady(const QString &, const QString &)), Qt::UniqueConnection);
+		if(g_pSharedFilesManager->requestDigest(t->m_pDescriptor->szLocalFileName))
+		{
+			t->m_bDigestRequested = false;
+			t->sendDigest(g_pSharedFilesManager->cachedDigest(t->m_pDescriptor->szLocalFileName));
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool DccFileTransfer::handleDigest(const QString & szNick, const QString & szFileName, const QString & szAlgorithm, const QString & szDigest)
+{
+	if(!g_pDccFileTransfers)
+		return false;
+
+	for(DccFileTransfer * t = g_pDccFileTransfers->last(); t; t = g_pDccFileTransfers->prev())
+	{
+		if(!t->m_pDescriptor->bRecvFile || t->m_pDescriptor->isSegment())
+			continue;
+		if(!(KviQString::equalCI(t->m_pDescriptor->szNick, szNick) && KviQString::equalCI(t->m_pDescriptor->szFileName, szFileName)))
+			continue;
+
+		if(!KviQString::equalCI(szAlgorithm, "SHA-256"))
+		{
+			t->outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("The sender announced a checksum of unsupported type %1", "dcc").arg(szAlgorithm));
+			return true;
+		}
+
+		t->m_szRemoteDigest = szDigest;
+		t->verifyDigest();
+		return true;
+	}
+
+	return false;
+}
+
+void DccFileTransfer::requestRemoteDigest()
+{
+	if(!m_pDescriptor->console() || !m_pDescriptor->console()->connection())
+		return;
+
+	KviCString szBuffy;
+	KviIrcServerParser::encodeCtcpParameter(m_pDescriptor->szFileName.toUtf8().data(), szBuffy);
+
+	m_pDescriptor->console()->connection()->sendFmtData("PRIVMSG %s :%cDCC DIGEST %s%c",
+	    m_pDescriptor->console()->connection()->encodeText(m_pDescriptor->szNick).data(),
+	    0x01,
+	    m_pDescriptor->console()->connection()->encodeText(szBuffy.ptr()).data(),
+	    0x01);
+}
+
+void DccFileTransfer::sendDigest(const QString & szDigest)
+{
+	if(szDigest.isEmpty())
+	{
+		outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("Can't compute the checksum requested by the receiver", "dcc"));
+		return;
+	}
+
+	if(!m_pDescriptor->console() || !m_pDescriptor->console()->connection())
+		return;
+
+	KviCString szBuffy;
+	KviIrcServerParser::encodeCtcpParameter(m_pDescriptor->szFileName.toUtf8().data(), szBuffy);
+
+	m_pDescriptor->console()->connection()->sendFmtData("PRIVMSG %s :%cDCC DIGEST %s SHA-256 %s%c",
+	    m_pDescriptor->console()->connection()->encodeText(m_pDescriptor->szNick).data(),
+	    0x01,
+	    m_pDescriptor->console()->connection()->encodeText(szBuffy.ptr()).data(),
+	    szDigest.toUtf8().data(),
+	    0x01);
+
+	outputAndLog(__tr2qs_ctx("Sent the SHA-256 checksum of the file to the receiver", "dcc"));
+}
+
+void DccFileTransfer::sharedFileDigestReady(const QString & szAbsPath, const QString & szDigest)
+{
+	if(!m_bDigestRequested)
+		return;
+	if(szAbsPath != m_pDescriptor->szLocalFileName)
+		return;
+	m_bDigestRequested = false;
+
+	if(!m_pDescriptor->bRecvFile)
+	{
+		sendDigest(szDigest);
+		return;
+	}
+
+	// a file received on parallel streams
+	if(szDigest.isEmpty())
+	{
+		outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("Can't compute the checksum of the received file", "dcc"));
+		return;
+	}
+	m_szLocalDigest = szDigest;
+	verifyDigest();
+}
+
+void DccFileTransfer::verifyDigest()
+{
+	if(m_szLocalDigest.isEmpty() || m_szRemoteDigest.isEmpty())
+		return; // wait for the other one
+
+	if(KviQString::equalCI(m_szLocalDigest, m_szRemoteDigest))
+		outputAndLog(__tr2qs_ctx("The SHA-256 checksum of the file matches the one computed by the sender", "dcc"));
+	else
+		outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("WARNING: the SHA-256 checksum of the file doesn't match the one computed by the sender: the file is probably corrupted", "dcc"));
+}
+
+bool DccFileTransfer::handleSegmentsRequest(const QString & szNick, const QString & szFileName, const QString & szPort, unsigned int uCount)
+{
+	if(!g_pDccFileTransfers)
+		return false;
+
+	for(DccFileTransfer * t = g_pDccFileTransfers->last(); t; t = g_pDccFileTransfers->prev())
+	{
+		if(t->m_pDescriptor->bRecvFile || t->m_pDescriptor->isSegment() || (!t->m_pSlaveSendThread))
+			continue;
+		if(!(KviQString::equalCI(t->m_pDescriptor->szNick, szNick) && KviQString::equalCI(t->m_pDescriptor->szFileName, szFileName)))
+			continue;
+		if(!KviQString::equalCI(szPort, t->m_pMarshal->dccPort()))
+			continue;
+
+		if(t->m_bSegmented || t->m_pDescriptor->bIsTdcc || t->m_pDescriptor->bNoAcks)
+			return true; // just ignore it
+
+		if(!KVI_OPTION_BOOL(KviOption_boolAcceptDccParallelStreamRequests))
+		{
+			if(_OUTPUT_VERBOSE)
+				t->outputAndLog(__tr2qs_ctx("Ignoring the request for parallel streams: disabled by the user", "dcc"));
+			return true;
+		}
+
+		if(uCount > KVI_DCC_MAX_PARALLEL_STREAMS)
+			uCount = KVI_DCC_MAX_PARALLEL_STREAMS;
+		if(!t->splitIntoSegments(uCount))
+		{
+			if(_OUTPUT_VERBOSE)
+				t->outputAndLog(__tr2qs_ctx("Ignoring the request for parallel streams: the rest of the file is too small", "dcc"));
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool DccFileTransfer::handleSegmentOffer(const QString & szNick, const QString & szFileName, const QString & szIp, const QString & szPort, quint64 uStart, quint64 uEnd)
+{
+	if(!g_pDccFileTransfers)
+		return false;
+
+	for(DccFileTransfer * t = g_pDccFileTransfers->last(); t; t = g_pDccFileTransfers->prev())
+	{
+		if(!(t->m_pDescriptor->bRecvFile && t->m_bSegmentsRequested && t->m_pSlaveRecvThread))
+			continue;
+		if(!(KviQString::equalCI(t->m_pDescriptor->szNick, szNick) && KviQString::equalCI(t->m_pDescriptor->szFileName, szFileName)))
+			continue;
+
+		t->m_pSlaveRecvThread->initGetInfo();
+		quint64 uPosition = t->m_pSlaveRecvThread->filePosition();
+		t->m_pSlaveRecvThread->doneGetInfo();
+
+		if((uStart >= uEnd) || (uEnd > t->m_uTotalFileSize) || (uStart < uPosition) || (t->m_bRangeCompleted && (uStart < t->m_uRangeEnd)))
+		{
+			t->outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("Ignoring an invalid offer for the bytes %1 to %2 of the file", "dcc").arg(uStart).arg(uEnd));
+			return true;
+		}
+		if(t->segmentOverlaps(uStart, uEnd))
+		{
+			// a repeated or overlapping offer: its bytes would be counted twice
+			t->outputAndLog(KVI_OUT_DCCERROR, __tr2qs_ctx("Ignoring an invalid offer for the bytes %1 to %2 of the file", "dcc").arg(uStart).arg(uEnd));
+			return true;
+		}
+		if(t->m_uPendingSegments + t->m_uFailedSegments >= KVI_DCC_MAX_PARALLEL_STREAMS)
+			return true;
+
+		t->acceptSegment(szIp, szPort, uStart, uEnd);
+		return true;
+	}
+
+	return false;
+}
+
+void DccFileTransfer::requestSegments()
+{
+	if(!m_pDescriptor->console() || !m_pDescriptor->console()->connection())
+		return;
+
+	KviCString szBuffy;
+	KviIrcServerParser::encodeCtcpParameter(m_pDescriptor->szFileName.toUtf8().data(), szBuffy);
+
+	m_bSegmentsRequested = true;
+
+	m_pDescriptor->console()->connection()->sendFmtData("PRIVMSG %s :%cDCC SEGMENTS %s %s %u%c",
+	    m_pDescriptor->console()->connection()->encodeText(m_pDescriptor->szNick).data(),
+	    0x01,
+	    m_pDescriptor->console()->connection()->encodeText(szBuffy.ptr()).data(),
+	    m_pDescriptor->szPort.toUtf8().data(),
+	    KVI_OPTION_UINT(KviOption_uintDccRecvParallelStreams),
+	    0x01);
+
+	if(_OUTPUT_VERBOSE)
+		outputAndLog(__tr2qs_ctx("Asked the sender to split the file on %1 parallel streams", "dcc").arg(KVI_OPTION_UINT(KviOption_uintDccRecvParallelStreams)));
+}
+
+bool DccFileTransfer::splitIntoSegments(unsigned int uCount)
+{
+	// leave to the running stream what it is sending right now
+	m_pSlaveSendThread->initGetInfo();
+	quint64 uStart = m_pSlaveSendThread->filePosition() + KVI_DCC_SEGMENT_SAFETY_MARGIN;
+	m_pSlaveSendThread->doneGetInfo();
+	uStart = (uStart + KVI_DCC_SEGMENT_ALIGNMENT - 1) & ~((quint64)(KVI_DCC_SEGMENT_ALIGNMENT - 1));
+	if(uStart >= m_uTotalFileSize)
+		return false;
+
+	quint64 uRest = m_uTotalFileSize - uStart;
+	while((uCount > 1) && ((uRest / uCount) < KVI_DCC_SEGMENT_MIN_SIZE))
+		uCount--;
+	if(uCount < 2)
+		return false;
+
+	// the running stream keeps the first part
+	quint64 uLen = uRest / uCount;
+	uLen = (uLen + KVI_DCC_SEGMENT_ALIGNMENT - 1) & ~((quint64)(KVI_DCC_SEGMENT_ALIGNMENT - 1));
+	quint64 uMainEnd = uStart + uLen;
+	if(!m_pSlaveSendThread->setEndPosition(uMainEnd))
+		return false;
+
+	m_bSegmented = true;
+	m_uRangeEnd = uMainEnd;
+
+	outputAndLog(__tr2qs_ctx("Splitting the rest of the file on %1 parallel streams", "dcc").arg(uCount));
+
+	for(quint64 u = uMainEnd; u < m_uTotalFileSize; u += uLen)
+		startSegment(u, qMin(u + uLen, m_uTotalFileSize));
+
+	return true;
+}
+
+void DccFileTransfer::startSegment(quint64 uStart, quint64 uEnd)
+{
+	DccDescriptor * d = new DccDescriptor(*m_pDescriptor);
+	d->bActive = false;
+	d->bSendRequest = true;
+	d->bResume = false;
+	d->szListenPort = "0";
+	d->szFakePort = "";
+	d->setZeroPortRequestTag(KviCString());
+	d->szFileSize = QString::number(uStart); // the start position of a send transfer
+	d->uSegmentStart = uStart;
+	d->uSegmentEnd = uEnd;
+	d->uSegmentParentId = m_pDescriptor->id();
+	d->triggerCreationEvent();
+	new DccFileTransfer(d);
+}
+
+bool DccFileTransfer::segmentOverlaps(quint64 uStart, quint64 uEnd) const
+{
+	for(const auto & r : m_lSegmentRanges)
+	{
+		if((uStart < r.second) && (r.first < uEnd))
+			return true;
+	}
+	return false;
+}
+
+void DccFileTransfer::acceptSegment(const QString & szIp, const QString & szPort, quint64 uStart, quint64 uEnd)
+{
+	// our part ends where the first segment starts
+	m_pSlaveRecvThread->shrinkEndPosition(uStart);
+	if(uStart < m_uRangeEnd)
+		m_uRangeEnd = uStart;
+
+	m_bSegmented = true;
+	m_uPendingSegments++;
+	m_uSegmentedBytes += uEnd - uStart;
+	m_lSegmentRanges.append(qMakePair(uStart, uEnd));
+
+	DccDescriptor * d = new DccDescriptor(*m_pDescriptor);
+	d->bActive = true;
+	d->szIp = szIp;
+	d->szPort = szPort;
+	d->szHost = szIp;
+	d->bResume = false;
+	d->bAutoAccept = true;
+	d->uSegmentStart = uStart;
+	d->uSegmentEnd = uEnd;
+	d->uSegmentParentId = m_pDescriptor->id();
+	d->triggerCreationEvent();
+	new DccFileTransfer(d);
+
+	outputAndLog(__tr2qs_ctx("Receiving the bytes %1 to %2 of the file on a parallel stream", "dcc").arg(uStart).arg(uEnd));
+}
+
+void DccFileTransfer::reportSegmentTermination(bool bSuccess)
+{
+	if(!(m_pDescriptor->isSegment() && m_pDescriptor->bRecvFile))
+		return;
+	if(m_bSegmentReported)
+		return;
+	m_bSegmentReported = true;
+
+	DccDescriptor * d = DccDescriptor::find(m_pDescriptor->uSegmentParentId);
+	if(!d || !d->transfer())
+		return; // the main transfer is gone
+	d->transfer()->segmentTerminated(bSuccess);
+}
+
+void DccFileTransfer::segmentTerminated(bool bSuccess)
+{
+	if(m_uPendingSegments > 0)
+		m_uPendingSegments--;
+	if(!bSuccess)
+		m_uFailedSegments++;
+	if(m_bRangeCompleted)
+		downloadCompleted();
+}
+
+void DccFileTransfer::downloadCompleted()
+{
+	if(m_eGeneralStatus != Transferring)
+		return;
+
+	if((m_uPendingSegments > 0) || (m_bSegmented && (m_uRangeEnd + m_uSegmentedBytes < m_uTotalFileSize)))
+	{
+		m_szStatusString = __tr2qs_ctx("Waiting for the parallel streams", "dcc");
+		displayUpdate();
+		return;
+	}
+
+	if(m_uFailedSegments > 0)
+	{
+		QString szErr = __tr2qs_ctx("Some parts of the file could not be received: the file is incomplete", "dcc");
+		m_eGeneralStatus = Failure;
+		m_tTransferEndTime = kvi_unixTime();
+		m_szStatusString = __tr2qs_ctx("Transfer failed: ", "dcc");
+		m_szStatusString += szErr;
+		outputAndLog(KVI_OUT_DCCERROR, m_szStatusString);
+		g_pApp->fileDownloadTerminated(false, m_pDescriptor->szFileName.toUtf8().data(), m_pDescriptor->szLocalFileName.toUtf8().data(), m_pDescriptor->szNick.toUtf8().data(), szErr.toUtf8().data());
+		KVS_TRIGGER_EVENT_3(KviEvent_OnDCCFileTransferFailed, eventWindow(), szErr, (kvs_int_t)m_pSlaveRecvThread->receivedBytes(), m_pDescriptor->idString());
+		displayUpdate();
+		return;
+	}
+
+	if(m_bSegmented)
+		outputAndLog(__tr2qs_ctx("All the parallel streams have completed", "dcc"));
+
+	if(KVI_OPTION_BOOL(KviOption_boolVerifyDccRecvDigests))
+	{
+		// the parts were written out of order: hash the whole file now
+		m_bDigestRequested = true;
+		connect(g_pSharedFilesManager, SIGNAL(digestReady(const QString &, const QString &)), this, SLOT(sharedFileDigestReady(const QString &, const QString &)), Qt::UniqueConnection);
+		if(g_pSharedFilesManager->requestDigest(m_pDescriptor->szLocalFileName))
+		{
+			m_bDigestRequested = false;
+			m_szLocalDigest = g_pSharedFilesManager->cachedDigest(m_pDescriptor->szLocalFileName);
+		}
+		requestRemoteDigest();
+	}
+
+	transferSucceeded();
+}
+
 void DccFileTransfer::outputAndLog(const QString & s)
 {
 	KviWindow * out = transferWindow();
@@ -2103,7 +1376,21 @@ void DccFileTransfer::connectionInProgress()
 		// Zero port requests want DCC SEND as back-request
 		KviCString szReq;
 
-		if(m_pDescriptor->isZeroPortRequest())
+		if(m_pDescriptor->isSegment())
+		{
+			// a part of a file that is already being sent: offered to the receiver only
+			szReq = "SEGMENT";
+			QString szStart = QString::number(m_pDescriptor->uSegmentStart);
+			QString szEnd = QString::number(m_pDescriptor->uSegmentEnd);
+			m_pDescriptor->console()->connection()->sendFmtData("PRIVMSG %s :%cDCC %s %s %s %s %Q %Q%c",
+			    m_pDescriptor->console()->connection()->encodeText(m_pDescriptor->szNick).data(),
+			    0x01,
+			    szReq.ptr(),
+			    m_pDescriptor->console()->connection()->encodeText(fName).data(),
+			    ip.toUtf8().data(), port.ptr(),
+			    &szStart, &szEnd, 0x01);
+		}
+		else if(m_pDescriptor->isZeroPortRequest())
 		{
 			szReq = "SEND";
 			if(m_pDescriptor->bIsTdcc)
@@ -2169,7 +1456,7 @@ bool DccFileTransfer::event(QEvent * e)
 				KviError::Code * pError = ((KviThreadDataEvent<KviError::Code> *)e)->getData();
 				QString szErrorString = KviError::getDescription(*pError);
 				delete pError;
-				if(m_pDescriptor->bRecvFile)
+				if(m_pDescriptor->bRecvFile && !m_pDescriptor->isSegment())
 					g_pApp->fileDownloadTerminated(false, m_pDescriptor->szFileName.toUtf8().data(), m_pDescriptor->szLocalFileName.toUtf8().data(), m_pDescriptor->szNick.toUtf8().data(), szErrorString.toUtf8().data());
 
 				m_szStatusString = __tr2qs_ctx("Transfer failed: ", "dcc");
@@ -2185,45 +1472,35 @@ bool DccFileTransfer::event(QEvent * e)
 
 				outputAndLog(KVI_OUT_DCCERROR, m_szStatusString);
 				displayUpdate();
+
+				reportSegmentTermination(false);
 				return true;
 			}
 			break;
 			case KVI_DCC_THREAD_EVENT_SUCCESS:
 			{
-				// FIXME: for >= 3.2.0 change this text to
-				// File Upload/Download terminated, or something like this
-				if(KVI_OPTION_BOOL(KviOption_boolNotifyDccSendSuccessInConsole))
+				if(m_pDescriptor->isSegment())
 				{
-					KviConsoleWindow * c;
-					if(!g_pApp->windowExists(m_pDescriptor->console()))
-						c = g_pApp->activeConsole();
-					else
-						c = m_pDescriptor->console();
-					c->output(KVI_OUT_DCCMSG, __tr2qs_ctx("DCC %s transfer with %Q@%Q:%Q completed: \r![!dbl]%Q\r%Q\r", "dcc"),
-					    m_pDescriptor->bIsTdcc ? (m_pDescriptor->bRecvFile ? "TRECV" : "TSEND") : (m_pDescriptor->bRecvFile ? "RECV" : "SEND"),
-					    &(m_pDescriptor->szNick), &(m_pDescriptor->szIp), &(m_pDescriptor->szPort),
-					    &(KVI_OPTION_STRING(KviOption_stringUrlFileCommand)),
-					    &(m_pDescriptor->szLocalFileName));
+					// just a part of the file: the main transfer reports the whole thing
+					m_szStatusString = __tr2qs_ctx("Transfer of the file part completed", "dcc");
+					outputAndLog(m_szStatusString);
+					m_eGeneralStatus = Success;
+					m_tTransferEndTime = kvi_unixTime();
+					displayUpdate();
+					reportSegmentTermination(true);
+					if(KVI_OPTION_BOOL(KviOption_boolAutoCloseDccSendOnSuccess))
+						die();
+					return true;
 				}
 
-				if(m_pDescriptor->bRecvFile)
-					g_pApp->fileDownloadTerminated(true, m_pDescriptor->szFileName.toUtf8().data(), m_pDescriptor->szLocalFileName.toUtf8().data(), m_pDescriptor->szNick.toUtf8().data());
-				m_szStatusString = __tr2qs_ctx("Transfer completed", "dcc");
-				outputAndLog(m_szStatusString);
-				m_eGeneralStatus = Success;
-				m_tTransferEndTime = kvi_unixTime();
-				if(m_pResumeTimer)
-					delete m_pResumeTimer;
-
-				KVS_TRIGGER_EVENT_2(KviEvent_OnDCCFileTransferSuccess,
-				    eventWindow(),
-				    (kvs_int_t)(m_pSlaveRecvThread ? m_pSlaveRecvThread->receivedBytes() : m_pSlaveSendThread->sentBytes()),
-				    m_pDescriptor->idString());
-
-				displayUpdate();
+				if(m_bSegmentsRequested)
+				{
+					m_bRangeCompleted = true;
+					downloadCompleted();
+					return true;
+				}
 
-				if(KVI_OPTION_BOOL(KviOption_boolAutoCloseDccSendOnSuccess))
-					die();
+				transferSucceeded();
 				return true;
 			}
 			break;
@@ -2235,6 +1512,15 @@ bool DccFileTransfer::event(QEvent * e)
 				return true;
 			}
 			break;
+			case KVI_DCC_THREAD_EVENT_DIGEST:
+			{
+				KviCString * str = ((KviThreadDataEvent<KviCString> *)e)->getData();
+				m_szLocalDigest = str->ptr();
+				delete str;
+				verifyDigest();
+				return true;
+			}
+			break;
 			default:
 				qDebug("Invalid event type %d received", ((KviThreadEvent *)e)->id());
 				break;
@@ -2243,6 +1529,47 @@ bool DccFileTransfer::event(QEvent * e)
 	return KviFileTransfer::event(e);
 }
 
+void DccFileTransfer::transferSucceeded()
+{
+	// FIXME: for >= 3.2.0 change this text to
+	// File Upload/Download terminated, or something like this
+	if(KVI_OPTION_BOOL(KviOption_boolNotifyDccSendSuccessInConsole))
+	{
+		KviConsoleWindow * c;
+		if(!g_pApp->windowExists(m_pDescriptor->console()))
+			c = g_pApp->activeConsole();
+		else
+			c = m_pDescriptor->console();
+		c->output(KVI_OUT_DCCMSG, __tr2qs_ctx("DCC %s transfer with %Q@%Q:%Q completed: \r![!dbl]%Q\r%Q\r", "dcc"),
+		    m_pDescriptor->bIsTdcc ? (m_pDescriptor->bRecvFile ? "TRECV" : "TSEND") : (m_pDescriptor->bRecvFile ? "RECV" : "SEND"),
+		    &(m_pDescriptor->szNick), &(m_pDescriptor->szIp), &(m_pDescriptor->szPort),
+		    &(KVI_OPTION_STRING(KviOption_stringUrlFileCommand)),
+		    &(m_pDescriptor->szLocalFileName));
+	}
+
+	if(m_pDescriptor->bRecvFile)
+		g_pApp->fileDownloadTerminated(true, m_pDescriptor->szFileName.toUtf8().data(), m_pDescriptor->szLocalFileName.toUtf8().data(), m_pDescriptor->szNick.toUtf8().data());
+	m_szStatusString = __tr2qs_ctx("Transfer completed", "dcc");
+	outputAndLog(m_szStatusString);
+	m_eGeneralStatus = Success;
+	m_tTransferEndTime = kvi_unixTime();
+	if(m_pResumeTimer)
+	{
+		delete m_pResumeTimer;
+		m_pResumeTimer = nullptr;
+	}
+
+	KVS_TRIGGER_EVENT_2(KviEvent_OnDCCFileTransferSuccess,
+	    eventWindow(),
+	    (kvs_int_t)(m_pSlaveRecvThread ? m_pSlaveRecvThread->receivedBytes() : m_pSlaveSendThread->sentBytes()),
+	    m_pDescriptor->idString());
+
+	displayUpdate();
+
+	if(KVI_OPTION_BOOL(KviOption_boolAutoCloseDccSendOnSuccess))
+		die();
+}
+
 void DccFileTransfer::handleMarshalError(KviError::Code eError)
 {
 	QString szErr = KviError::getDescription(eError);
@@ -2252,6 +1579,8 @@ void DccFileTransfer::handleMarshalError(KviError::Code eError)
 	outputAndLog(m_szStatusString);
 	KVS_TRIGGER_EVENT_3(KviEvent_OnDCCFileTransferFailed, eventWindow(), szErr, (kvs_int_t)0, m_pDescriptor->idString());
 	displayUpdate();
+
+	reportSegmentTermination(false);
 }
 
 void DccFileTransfer::connected()
@@ -2277,12 +1606,23 @@ void DccFileTransfer::connected()
 		if(!bOk)
 			o->uTotalFileSize = 0;
 		o->bResume = m_pDescriptor->bResume;
+		o->uStartPosition = m_pDescriptor->uSegmentStart;
+		o->uEndPosition = m_pDescriptor->uSegmentEnd;
 		o->iIdleStepLengthInMSec = KVI_OPTION_BOOL(KviOption_boolDccSendForceIdleStep) ? KVI_OPTION_UINT(KviOption_uintDccSendIdleStepInMSec) : 0;
 		o->bIsTdcc = m_pDescriptor->bIsTdcc;
 		o->bSendZeroAck = KVI_OPTION_BOOL(KviOption_boolSendZeroAckInDccRecv);
 		o->bSend64BitAck = KVI_OPTION_BOOL(KviOption_boolSend64BitAckInDccRecv);
 		o->bNoAcks = m_pDescriptor->bNoAcks;
-		o->uMaxBandwidth = m_uMaxBandwidth;
+		// ask a KVIrc sender to split the large files on parallel streams: the streams
+		// of a KVIrc sender run in fast send mode with acks, the file size must be known
+		bool bSplit = (KVI_OPTION_UINT(KviOption_uintDccRecvParallelStreams) > 1) && (!m_pDescriptor->isSegment())
+		    && m_pDescriptor->bActive && (!m_pDescriptor->bIsTdcc) && (!m_pDescriptor->bNoAcks)
+		    && (o->uTotalFileSize >= KVI_DCC_SEGMENTED_MIN_FILE_SIZE);
+		o->bPreallocate = KVI_OPTION_BOOL(KviOption_boolPreallocateDccRecvFiles) && !m_pDescriptor->isSegment();
+		// with parallel streams the data isn't written in order: the whole file is hashed at the end
+		o->bComputeDigest = KVI_OPTION_BOOL(KviOption_boolVerifyDccRecvDigests) && !m_pDescriptor->isSegment() && !bSplit;
+		o->bReportStatistics = _OUTPUT_VERBOSE;
+		o->pLimiter = m_pBandwidthLimiter;
 		m_pSlaveRecvThread = new DccRecvThread(this, m_pMarshal->releaseSocket(), o);
 
 #ifdef COMPILE_SSL_SUPPORT
@@ -2293,6 +1633,11 @@ void DccFileTransfer::connected()
 		}
 #endif
 		m_pSlaveRecvThread->start();
+
+		if(bSplit)
+			requestSegments();
+		else if(KVI_OPTION_BOOL(KviOption_boolVerifyDccRecvDigests) && !m_pDescriptor->isSegment())
+			requestRemoteDigest();
 	}
 	else
 	{
@@ -2305,11 +1650,13 @@ void DccFileTransfer::connected()
 		o->uStartPosition = m_pDescriptor->szFileSize.toULongLong(&bOk);
 		if(!bOk)
 			o->uStartPosition = 0;
+		o->uEndPosition = m_pDescriptor->uSegmentEnd;
 		o->iPacketSize = KVI_OPTION_UINT(KviOption_uintDccSendPacketSize);
 		if(o->iPacketSize < 32)
 			o->iPacketSize = 32;
-		o->uMaxBandwidth = m_uMaxBandwidth;
+		o->pLimiter = m_pBandwidthLimiter;
 		o->bNoAcks = m_pDescriptor->bNoAcks;
+		o->bReportStatistics = _OUTPUT_VERBOSE;
 		m_pSlaveSendThread = new DccSendThread(this, m_pMarshal->releaseSocket(), o);
 #ifdef COMPILE_SSL_SUPPORT
 		KviSSL * s = m_pMarshal->releaseSSL();
@@ -2459,61 +1806,81 @@ DccFileTransferBandwidthDialog::DccFileTransferBandwidthDialog(QWidget * pParent
 	QGridLayout * g = new QGridLayout(this);
 
 	m_pTransfer = t;
-	int iVal = m_pTransfer->bandwidthLimit();
+	DccBandwidthLimiter::Direction eDirection = t->isFileUpload() ? DccBandwidthLimiter::Upload : DccBandwidthLimiter::Download;
 
 	QString szText = __tr2qs_ctx("Configure Bandwidth for DCC Transfer %1", "dcc").arg(t->id());
 	setWindowTitle(szText);
 
 	szText = t->isFileUpload() ? __tr2qs_ctx("Limit upload bandwidth to:", "dcc") : __tr2qs_ctx("Limit download bandwidth to:", "dcc");
+	addLimitRow(g, 0, szText, m_pTransfer->bandwidthLimit(), &m_pEnableLimitCheck, &m_pLimitBox);
 
-	m_pEnableLimitCheck = new QCheckBox(szText, this);
-	g->addWidget(m_pEnableLimitCheck, 0, 0);
+	szText = t->isFileUpload() ? __tr2qs_ctx("Limit all uploads to %1 to:", "dcc") : __tr2qs_ctx("Limit all downloads from %1 to:", "dcc");
+	addLimitRow(g, 1, szText.arg(t->remoteNick()), DccBandwidthShaper::instance()->nickLimit(eDirection, t->remoteNick()), &m_pEnableNickLimitCheck, &m_pNickLimitBox);
 
-	m_pEnableLimitCheck->setChecked((iVal >= 0) && (iVal < MAX_DCC_BANDWIDTH_LIMIT));
-
-	m_pLimitBox = new QSpinBox(this);
-	m_pLimitBox->setMinimum(0);
-	m_pLimitBox->setMaximum(MAX_DCC_BANDWIDTH_LIMIT - 1);
-	m_pLimitBox->setSingleStep(1);
-
-	m_pLimitBox->setEnabled((iVal >= 0) && (iVal < MAX_DCC_BANDWIDTH_LIMIT));
-	connect(m_pEnableLimitCheck, SIGNAL(toggled(bool)), m_pLimitBox, SLOT(setEnabled(bool)));
-	g->addWidget(m_pLimitBox, 0, 1, 1, 2);
-
-	szText = " ";
-	szText += __tr2qs_ctx("bytes/sec", "dcc");
-	m_pLimitBox->setSuffix(szText);
-	m_pLimitBox->setValue(iVal < MAX_DCC_BANDWIDTH_LIMIT ? iVal : 0);
+	szText = t->isFileUpload() ? __tr2qs_ctx("Limit total upload bandwidth to:", "dcc") : __tr2qs_ctx("Limit total download bandwidth to:", "dcc");
+	addLimitRow(g, 2, szText, DccBandwidthShaper::instance()->globalLimit(eDirection), &m_pEnableGlobalLimitCheck, &m_pGlobalLimitBox);
 
 	QPushButton * pb = new QPushButton(__tr2qs_ctx("OK", "dcc"), this);
 	connect(pb, SIGNAL(clicked()), this, SLOT(okClicked()));
 	pb->setMinimumWidth(80);
-	g->addWidget(pb, 2, 2);
+	g->addWidget(pb, 4, 2);
 
 	pb = new QPushButton(__tr2qs_ctx("Cancel", "dcc"), this);
 	connect(pb, SIGNAL(clicked()), this, SLOT(cancelClicked()));
 	pb->setMinimumWidth(80);
-	g->addWidget(pb, 2, 1);
+	g->addWidget(pb, 4, 1);
 
 	g->setColumnStretch(0, 1);
-	g->setRowStretch(1, 1);
+	g->setRowStretch(3, 1);
 }
 
 DccFileTransferBandwidthDialog::~DccFileTransferBandwidthDialog()
     = default;
 
+void DccFileTransferBandwidthDialog::addLimitRow(QGridLayout * g, int iRow, const QString & szText, int iVal, QCheckBox ** ppCheck, QSpinBox ** ppBox)
+{
+	QCheckBox * pCheck = new QCheckBox(szText, this);
+	g->addWidget(pCheck, iRow, 0);
+
+	pCheck->setChecked((iVal >= 0) && (iVal < MAX_DCC_BANDWIDTH_LIMIT));
+
+	QSpinBox * pBox = new QSpinBox(this);
+	pBox->setMinimum(0);
+	pBox->setMaximum(MAX_DCC_BANDWIDTH_LIMIT - 1);
+	pBox->setSingleStep(1);
+
+	pBox->setEnabled((iVal >= 0) && (iVal < MAX_DCC_BANDWIDTH_LIMIT));
+	connect(pCheck, SIGNAL(toggled(bool)), pBox, SLOT(setEnabled(bool)));
+	g->addWidget(pBox, iRow, 1, 1, 2);
+
+	QString szSuffix = " ";
+	szSuffix += __tr2qs_ctx("bytes/sec", "dcc");
+	pBox->setSuffix(szSuffix);
+	pBox->setValue(iVal < MAX_DCC_BANDWIDTH_LIMIT ? iVal : 0);
+
+	*ppCheck = pCheck;
+	*ppBox = pBox;
+}
+
+int DccFileTransferBandwidthDialog::limitValue(QCheckBox * pCheck, QSpinBox * pBox)
+{
+	if(!pCheck->isChecked())
+		return MAX_DCC_BANDWIDTH_LIMIT;
+	int iVal = pBox->value();
+	if(iVal < 0)
+		iVal = MAX_DCC_BANDWIDTH_LIMIT;
+	if(iVal > MAX_DCC_BANDWIDTH_LIMIT)
+		iVal = MAX_DCC_BANDWIDTH_LIMIT;
+	return iVal;
+}
+
 void DccFileTransferBandwidthDialog::okClicked()
 {
-	int iVal = MAX_DCC_BANDWIDTH_LIMIT;
-	if(m_pEnableLimitCheck->isChecked())
-	{
-		iVal = m_pLimitBox->value();
-		if(iVal < 0)
-			iVal = MAX_DCC_BANDWIDTH_LIMIT;
-		if(iVal > MAX_DCC_BANDWIDTH_LIMIT)
-			iVal = MAX_DCC_BANDWIDTH_LIMIT;
-	}
-	m_pTransfer->setBandwidthLimit(iVal);
+	DccBandwidthLimiter::Direction eDirection = m_pTransfer->isFileUpload() ? DccBandwidthLimiter::Upload : DccBandwidthLimiter::Download;
+	// all these apply immediately to the running transfers
+	m_pTransfer->setBandwidthLimit(limitValue(m_pEnableLimitCheck, m_pLimitBox));
+	DccBandwidthShaper::instance()->setNickLimit(eDirection, m_pTransfer->remoteNick(), limitValue(m_pEnableNickLimitCheck, m_pNickLimitBox));
+	DccBandwidthShaper::instance()->setGlobalLimit(eDirection, limitValue(m_pEnableGlobalLimitCheck, m_pGlobalLimitBox));
 	delete this;
 }
 
@@ -26,7 +26,8 @@
 
 #include "DccDescriptor.h"
 #include "DccWindow.h"
-#include "DccThread.h"
+#include "DccFileTransferThread.h"
+#include "DccBandwidthShaper.h"
 
 #include "KviWindow.h"
 #include "KviCString.h"
@@ -43,115 +44,17 @@
 #include <QDialog>
 #include <QCheckBox>
 #include <QMenu>
+#include <QList>
+#include <QPair>
 
 class QSpinBox;
+class QGridLayout;
 class QTimer;
 class QPainter;
 class DccFileTransfer;
 class DccMarshal;
 class QMenu;
 
-typedef struct _KviDccSendThreadOptions
-{
-	KviCString szFileName;
-	quint64 uStartPosition;
-	int iPacketSize;
-	int iIdleStepLengthInMSec;
-	bool bFastSend;
-	bool bNoAcks;
-	bool bIsTdcc;
-	unsigned int uMaxBandwidth;
-} KviDccSendThreadOptions;
-
-class DccSendThread : public DccThread
-{
-public:
-	DccSendThread(QObject * par, kvi_socket_t fd, KviDccSendThreadOptions * opt);
-	~DccSendThread();
-
-private:
-	// stats: SHARED!!!
-	uint m_uAverageSpeed;
-	uint m_uInstantSpeed;
-	quint64 m_uFilePosition;
-	quint64 m_uAckedBytes;
-	quint64 m_uTotalSentBytes;
-	// internal
-	unsigned long m_uStartTime;
-	unsigned long m_uInstantSpeedInterval;
-	quint64 m_uInstantSentBytes;
-	KviDccSendThreadOptions * m_pOpt;
-	KviMSecTimeInterval * m_pTimeInterval; // used for computing the instant bandwidth but not only
-public:
-	void initGetInfo();
-	uint averageSpeed() { return m_uAverageSpeed; };
-	uint instantSpeed() { return m_uInstantSpeed; };
-	quint64 filePosition() { return m_uFilePosition; };
-	// sent ONLY in this session
-	quint64 sentBytes() { return m_uTotalSentBytes; };
-	quint64 ackedBytes() { return m_uAckedBytes; };
-	unsigned int bandwidthLimit() { return m_pOpt->uMaxBandwidth; };
-	void setBandwidthLimit(unsigned int uMaxBandwidth) { m_pOpt->uMaxBandwidth = uMaxBandwidth; };
-	void doneGetInfo();
-
-protected:
-	void updateStats();
-	virtual void run();
-};
-
-typedef struct _KviDccRecvThreadOptions
-{
-	bool bResume;
-	KviCString szFileName;
-	quint64 uTotalFileSize;
-	int iIdleStepLengthInMSec;
-	bool bSendZeroAck;
-	bool bSend64BitAck;
-	bool bNoAcks;
-	bool bIsTdcc;
-	unsigned int uMaxBandwidth;
-} KviDccRecvThreadOptions;
-
-class DccRecvThread : public DccThread
-{
-public:
-	DccRecvThread(QObject * par, kvi_socket_t fd, KviDccRecvThreadOptions * opt);
-	~DccRecvThread();
-
-protected:
-	KviDccRecvThreadOptions * m_pOpt;
-
-	// stats: SHARED!
-	uint m_uAverageSpeed;
-	uint m_uInstantSpeed;
-	quint64 m_uFilePosition;
-	quint64 m_uTotalReceivedBytes;
-
-	// internal
-	unsigned long m_uStartTime;
-	KviMSecTimeInterval * m_pTimeInterval; // used for computing the instant bandwidth
-	quint64 m_uInstantReceivedBytes;
-	quint64 m_uInstantSpeedInterval;
-	QFile * m_pFile;
-
-public:
-	void initGetInfo();
-	uint averageSpeed() { return m_uAverageSpeed; };
-	uint instantSpeed() { return m_uInstantSpeed; };
-	quint64 filePosition() { return m_uFilePosition; };
-	// received ONLY in this session
-	quint64 receivedBytes() { return m_uTotalReceivedBytes; };
-	unsigned int bandwidthLimit() { return m_pOpt->uMaxBandwidth; };
-	void setBandwidthLimit(unsigned int uMaxBandwidth) { m_pOpt->uMaxBandwidth = uMaxBandwidth; };
-	void doneGetInfo();
-
-protected:
-	void postMessageEvent(const char * msg);
-	void updateStats();
-	bool sendAck(qint64 filePos, bool bUse64BitAck = false);
-	virtual void run();
-};
-
 class DccFileTransferBandwidthDialog : public QDialog
 {
 	Q_OBJECT
@@ -163,8 +66,14 @@ protected:
 	DccFileTransfer * m_pTransfer;
 	QCheckBox * m_pEnableLimitCheck;
 	QSpinBox * m_pLimitBox;
+	QCheckBox * m_pEnableNickLimitCheck;
+	QSpinBox * m_pNickLimitBox;
+	QCheckBox * m_pEnableGlobalLimitCheck;
+	QSpinBox * m_pGlobalLimitBox;
 
 protected:
+	void addLimitRow(QGridLayout * g, int iRow, const QString & szText, int iVal, QCheckBox ** ppCheck, QSpinBox ** ppBox);
+	int limitValue(QCheckBox * pCheck, QSpinBox * pBox);
 	virtual void closeEvent(QCloseEvent * e);
 protected slots:
 	void okClicked();
@@ -205,7 +114,23 @@ private:
 	// cached stats
 	quint64 m_uTotalFileSize; // total file size to transfer
 
-	unsigned int m_uMaxBandwidth;
+	DccBandwidthLimiter * m_pBandwidthLimiter; // shared with the slave thread
+
+	// SHA-256 end to end checks (a KVIrc extension)
+	QString m_szLocalDigest;  // recv: computed by the slave thread while writing the file
+	QString m_szRemoteDigest; // recv: announced by the sender
+	bool m_bDigestRequested;  // send: the receiver has asked for the digest
+
+	// parallel streams (a KVIrc extension)
+	bool m_bSegmentsRequested;       // recv: we have asked the sender to split the file
+	bool m_bSegmented;               // the other parts of the file are carried by segment transfers
+	bool m_bRangeCompleted;          // recv: our part is done, waiting for the segments
+	bool m_bSegmentReported;         // segment: the main transfer knows that we have terminated
+	quint64 m_uRangeEnd;             // recv: where our part ends
+	quint64 m_uSegmentedBytes;       // recv: the size of the parts carried by the segments
+	unsigned int m_uPendingSegments; // recv: segments still running
+	unsigned int m_uFailedSegments;  // recv: segments that have failed
+	QList<QPair<quint64, quint64>> m_lSegmentRanges; // recv: the [start,end) ranges of the accepted segments
 	DccFileTransferBandwidthDialog * m_pBandwidthDialog;
 
 	QTimer * m_pResumeTimer; // used to signal resume timeout
@@ -220,6 +145,10 @@ public:
 	static unsigned int transferCount();
 	static bool handleResumeAccepted(const char * filename, const char * port, const char * szZeroPortTag);
 	static bool handleResumeRequest(const char * filename, const char * port, quint64 filePos);
+	static bool handleDigestRequest(const QString & szNick, const QString & szFileName);
+	static bool handleDigest(const QString & szNick, const QString & szFileName, const QString & szAlgorithm, const QString & szDigest);
+	static bool handleSegmentsRequest(const QString & szNick, const QString & szFileName, const QString & szPort, unsigned int uCount);
+	static bool handleSegmentOffer(const QString & szNick, const QString & szFileName, const QString & szIp, const QString & szPort, quint64 uStart, quint64 uEnd);
 
 	virtual bool event(QEvent * e);
 
@@ -242,6 +171,7 @@ public:
 
 	int bandwidthLimit();
 	void setBandwidthLimit(int iVal);
+	const QString & remoteNick() { return m_pDescriptor->szNick; };
 	virtual DccThread * getSlaveThread();
 
 protected:
@@ -251,6 +181,18 @@ protected:
 	void outputAndLog(const QString & s);
 	void outputAndLog(int msgtype, const QString & s);
 	KviWindow * eventWindow();
+	void requestRemoteDigest();
+	void sendDigest(const QString & szDigest);
+	void verifyDigest();
+	void requestSegments();
+	bool splitIntoSegments(unsigned int uCount);
+	void startSegment(quint64 uStart, quint64 uEnd);
+	void acceptSegment(const QString & szIp, const QString & szPort, quint64 uStart, quint64 uEnd);
+	bool segmentOverlaps(quint64 uStart, quint64 uEnd) const;
+	void segmentTerminated(bool bSuccess);
+	void reportSegmentTermination(bool bSuccess);
+	void downloadCompleted();
+	void transferSucceeded();
 protected slots:
 	void connectionInProgress();
 	void sslError(const char * msg);
@@ -260,6 +202,7 @@ protected slots:
 	void bandwidthDialogDestroyed();
 	void configureBandwidth();
 	void resumeTimedOut();
+	void sharedFileDigestReady(const QString & szAbsPath, const QString & szDigest);
 public slots:
 	void abort();
 	void retryDCC();
@@ -0,0 +1,1416 @@
+//=============================================================================
+//
+//   File : DccFileTransferThread.cpp
+//   Creation date : Tue Sep 20 09 2000 15:14:14 by Szymon Stefanek
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2000-2010 Szymon Stefanek (pragma at kvirc dot net)
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#define _KVI_DEBUG_CHECK_RANGE_
+
+#include "DccFileTransferThread.h"
+
+#include "kvi_debug.h"
+#include "KviLocale.h"
+#include "KviError.h"
+#include "KviNetUtils.h"
+#include "KviMemory.h"
+#include "KviThread.h"
+#include "kvi_socket.h"
+
+#include <QFile>
+#include <QtEndian>
+
+#ifdef HAVE_SENDFILE
+#include <sys/sendfile.h>
+#include <limits>
+#endif
+
+#ifdef HAVE_FALLOCATE
+#include <fcntl.h>
+#endif
+
+#define INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS 3000
+#define INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS 3
+
+// When sendfile() is used and we don't need to wait for the acks
+// we can push more than a packet at once, the kernel will split it
+#define ZERO_COPY_MAX_CHUNK_SIZE 262144
+
+// Returned by DccSendThread::sendFileChunk() when the file can't be sent that way
+#define ZERO_COPY_UNSUPPORTED -2
+
+// How long the transfer threads sleep in poll() when there is nothing to do.
+// They are woken up earlier by socket activity and by thread events anyway.
+#define DCC_IDLE_WAIT_MSECS 1000
+
+//#warning "The events that have a KviCString data pointer should become real classes, that take care of deleting the data pointer!"
+//#warning "Otherwise, when left undispatched we will be leaking memory (event class destroyed but not the data ptr)"
+
+DccRecvThread::DccRecvThread(QObject * par, kvi_socket_t fd, KviDccRecvThreadOptions * opt)
+    : DccThread(par, fd)
+{
+	m_pOpt = opt;
+	m_uAverageSpeed = 0;
+	m_uInstantSpeed = 0;
+	m_uFilePosition = 0;
+
+	m_uTotalReceivedBytes = 0;
+	m_uInstantReceivedBytes = 0;
+	m_pFile = nullptr;
+	m_pBuffer = nullptr;
+	m_uBufferSize = 0;
+	m_uBufferFill = 0;
+	m_pDigest = nullptr;
+	m_uEndPosition.store(opt->uEndPosition ? opt->uEndPosition : opt->uTotalFileSize);
+	m_pTimeInterval = new KviMSecTimeInterval();
+	m_uStartTime = 0;
+	m_uInstantSpeedInterval = 0;
+}
+
+DccRecvThread::~DccRecvThread()
+{
+	if(m_pOpt)
+		delete m_pOpt;
+	if(m_pFile)
+		delete m_pFile;
+	if(m_pBuffer)
+		KviMemory::free(m_pBuffer);
+	if(m_pDigest)
+		delete m_pDigest;
+	delete m_pTimeInterval;
+}
+
+bool DccRecvThread::sendAck(qint64 filePos, bool bUse64BitAck)
+{
+	quint32 ack32 = htonl(filePos & 0xffffffff);
+	quint64 ack64 = qToBigEndian(filePos);
+
+	char * ack = (char *)&ack32;
+	int ackSize = 4;
+
+	if(bUse64BitAck)
+	{
+		ackSize = 8;
+		ack = (char *)&ack64;
+	}
+
+	int iRet = 0;
+	m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+	if(m_pSSL)
+		iRet = m_pSSL->write(ack, ackSize);
+	else
+#endif //COMPILE_SSL_SUPPORT
+		iRet = kvi_socket_send(m_fd, (void *)(ack), ackSize);
+
+	if(iRet == ackSize)
+		return true; // everything sent
+
+	// When downloading from a fast server using send-ahead via an asymmetric link (such as the
+	// common ADSL lines) it may happen that the network output queue gets saturated with ACKs.
+	// In this case the network stack will refuse to send our packet and we get here.
+	//
+	// We should either retry to send the ACK in a while or avoid sending it at all (as with
+	// send-ahead acks aren't usually checked per-packet).
+
+	if(iRet == 0)
+	{
+		// We can live with this: no data has been sent at all
+		// Not sending the ack and hoping that the server will not stall is better than
+		// killing the connection from our side anyway.
+		return true;
+	}
+
+	if(iRet < 0)
+	{
+// Reported error. If it's EAGAIN or EINTR then no data has been sent.
+#ifdef COMPILE_SSL_SUPPORT
+		if(m_pSSL)
+		{
+			// dropping ack when no serious ssl error occurred
+			switch(m_pSSL->getProtocolError(iRet))
+			{
+				case KviSSL::ZeroReturn:
+				//return false; check eagain
+				case KviSSL::Success:
+				case KviSSL::WantRead:
+				case KviSSL::WantWrite:
+					return true;
+					break;
+				default:
+					// Raise unknown SSL ERROR
+					postErrorEvent(KviError::SSLError);
+					return false;
+					break;
+			}
+
+			return false;
+		}
+#endif //COMPILE_SSL_SUPPORT
+
+		int err = kvi_socket_error();
+#if defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW)
+		if((err != EAGAIN) && (err != EINTR) && (err != WSAEWOULDBLOCK))
+#else  //!(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+		if((err != EAGAIN) && (err != EINTR))
+#endif //!(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+		{
+			// some other kind of error
+			postErrorEvent(KviError::AcknowledgeError);
+			return false;
+		}
+
+		return true; // no data sent: same as iRet == 0 above.
+	}
+
+	// Sent something but not everything.
+	// How likely is it to get in here ?!
+	// Sleep for a short while and try to send the missing part.
+	// This will probably throttle the bandwidth usage a bit too.
+	msleep(10);
+
+	int iMissingPart = ackSize - iRet;
+
+	m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+	if(m_pSSL)
+		iRet = m_pSSL->write(ack + iRet, iMissingPart);
+	else
+#endif //COMPILE_SSL_SUPPORT
+		iRet = kvi_socket_send(m_fd, (void *)(ack + iRet), iMissingPart);
+
+	if(iRet != iMissingPart)
+	{
+		// Crap.. couldn't send the missing part of the ack :/
+		postErrorEvent(KviError::AcknowledgeError);
+		return false;
+	}
+	return true;
+}
+
+void DccRecvThread::updateStats()
+{
+	m_uInstantSpeedInterval += m_pTimeInterval->mark();
+	unsigned long uCurTime = m_pTimeInterval->secondsCounter();
+
+	m_pMutex->lock();
+	unsigned long uElapsedTime = uCurTime - m_uStartTime;
+	if(uElapsedTime < 1)
+		uElapsedTime = 1;
+
+	m_uFilePosition = receivedPosition();
+	m_uAverageSpeed = m_uTotalReceivedBytes / uElapsedTime;
+
+	if(m_uInstantSpeedInterval > INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
+	{
+		unsigned int uMSecsOfTheNextInterval = 0;
+		if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS + (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS / 2)))
+			uMSecsOfTheNextInterval = m_uInstantSpeedInterval - INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
+		m_uInstantSpeed = (m_uInstantReceivedBytes * 1000) / m_uInstantSpeedInterval;
+		m_uInstantReceivedBytes = 0;
+		m_uInstantSpeedInterval = uMSecsOfTheNextInterval;
+	}
+	else
+	{
+		if(uElapsedTime <= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS)
+			m_uInstantSpeed = m_uAverageSpeed;
+	}
+	m_pMutex->unlock();
+}
+
+void DccRecvThread::postMessageEvent(const char * m)
+{
+	KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_MESSAGE);
+	e->setData(new KviCString(m));
+	postEvent(parent(), e);
+}
+
+// The receive buffer starts small and doubles each time a single read fills it up
+// (the socket had more data than we could take): fast links end up with few big
+// reads and few big writes. It also collects the data to write in aligned batches.
+#define KVI_DCC_RECV_MIN_BUFFER_SIZE 16384
+#define KVI_DCC_RECV_MAX_BUFFER_SIZE 2097152
+#define KVI_DCC_RECV_WRITE_ALIGNMENT 4096
+
+bool DccRecvThread::flushBuffer(bool bAll)
+{
+	if(m_uBufferFill == 0)
+		return true;
+	if(!(m_pFile && m_pFile->isOpen()))
+		return false;
+
+	unsigned int uToWrite = m_uBufferFill;
+	if(!bAll)
+	{
+		// write up to an aligned file offset, keep the tail for the next batch
+		quint64 uEnd = (quint64)m_pFile->pos() + m_uBufferFill;
+		unsigned int uTail = (unsigned int)(uEnd % KVI_DCC_RECV_WRITE_ALIGNMENT);
+		if(uTail < uToWrite)
+			uToWrite -= uTail;
+	}
+
+	if(m_pFile->write(m_pBuffer, uToWrite) != (qint64)uToWrite)
+		return false;
+
+	// the data is hashed while it flows to the disk: no extra read pass
+	if(m_pDigest)
+		m_pDigest->addData(m_pBuffer, uToWrite);
+
+	m_uBufferFill -= uToWrite;
+	if(m_uBufferFill > 0)
+		KviMemory::move(m_pBuffer, m_pBuffer + uToWrite, m_uBufferFill);
+	return true;
+}
+
+bool DccRecvThread::hashExistingData()
+{
+	quint64 uLen = m_pFile->pos();
+	if(uLen == 0)
+		return true;
+
+	QFile f(QString::fromUtf8(m_pOpt->szFileName.ptr()));
+	if(!f.open(QIODevice::ReadOnly))
+		return false;
+
+	bool bOk = true;
+	char * pBuffer = (char *)KviMemory::allocate(KVI_DCC_RECV_MAX_BUFFER_SIZE);
+	while(uLen > 0)
+	{
+		qint64 iRead = f.read(pBuffer, uLen > KVI_DCC_RECV_MAX_BUFFER_SIZE ? KVI_DCC_RECV_MAX_BUFFER_SIZE : uLen);
+		if(iRead <= 0)
+		{
+			bOk = false;
+			break;
+		}
+		m_pDigest->addData(pBuffer, iRead);
+		uLen -= iRead;
+	}
+	KviMemory::free(pBuffer);
+	return bOk;
+}
+
+void DccRecvThread::postDigestEvent()
+{
+	if(!m_pDigest)
+		return;
+	KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_DIGEST);
+	e->setData(new KviCString(m_pDigest->result().toHex().data()));
+	postEvent(parent(), e);
+}
+
+void DccRecvThread::preallocateFile()
+{
+#if defined(HAVE_FALLOCATE) && defined(FALLOC_FL_KEEP_SIZE)
+	// reserve the disk space without changing the file size: an interrupted
+	// transfer must still be resumable from the real end of the data
+	quint64 uPos = m_pFile->pos();
+	if(m_pOpt->uTotalFileSize > uPos)
+	{
+		if(fallocate(m_pFile->handle(), FALLOC_FL_KEEP_SIZE, uPos, m_pOpt->uTotalFileSize - uPos) != 0)
+			postMessageEvent(__tr_no_lookup_ctx("Can't preallocate the disk space for the file, continuing anyway", "dcc"));
+	}
+#endif
+}
+
+void DccRecvThread::run()
+{
+	m_pTimeInterval->mark();
+	m_pMutex->lock();
+	m_uStartTime = m_pTimeInterval->secondsCounter();
+	m_pMutex->unlock();
+
+	startStatistics();
+
+	int iProbableTerminationTime = 0;
+
+	m_pFile = new QFile(QString::fromUtf8(m_pOpt->szFileName.ptr()));
+
+	bool bSend64BitAck = m_pOpt->bSend64BitAck && (m_pOpt->uTotalFileSize >> 32);
+
+	// we do our own write buffering
+	if(m_pOpt->uEndPosition > 0)
+	{
+		// a segment: the other streams are writing the rest of the file at the same time
+		if(!m_pFile->open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+		{
+			postErrorEvent(KviError::CantOpenFileForWriting);
+			goto exit_dcc;
+		}
+		if(!m_pFile->seek(m_pOpt->uStartPosition))
+		{
+			postErrorEvent(KviError::FileIOError);
+			goto exit_dcc;
+		}
+	}
+	else if(m_pOpt->bResume)
+	{
+		if(!m_pFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+		{
+			postErrorEvent(KviError::CantOpenFileForAppending);
+			goto exit_dcc;
+		} // else pFile is already at end
+	}
+	else
+	{
+		if(!m_pFile->open(QIODevice::WriteOnly | QIODevice::Unbuffered))
+		{
+			postErrorEvent(KviError::CantOpenFileForWriting);
+			goto exit_dcc;
+		}
+	}
+
+	if(m_pOpt->bPreallocate)
+		preallocateFile();
+
+	if(m_pOpt->bComputeDigest)
+	{
+		m_pDigest = new QCryptographicHash(QCryptographicHash::Sha256);
+		// when resuming the digest must cover the data we already have
+		if(!hashExistingData())
+		{
+			postMessageEvent(__tr_no_lookup_ctx("Can't read the existing part of the file: the checksum will not be verified", "dcc"));
+			delete m_pDigest;
+			m_pDigest = nullptr;
+		}
+	}
+
+	m_uBufferSize = KVI_DCC_RECV_MIN_BUFFER_SIZE;
+	m_uBufferFill = 0;
+	m_pBuffer = (char *)KviMemory::allocate(m_uBufferSize);
+
+	if(m_pOpt->bSendZeroAck && (!m_pOpt->bNoAcks))
+	{
+		if(!sendAck(receivedPosition(), bSend64BitAck))
+			goto exit_dcc;
+	}
+
+	for(;;)
+	{
+		// Dequeue events
+		while(KviThreadEvent * e = dequeueEvent())
+		{
+			if(e->id() == KVI_THREAD_EVENT_TERMINATE)
+			{
+				delete e;
+				goto exit_dcc;
+			}
+			else
+			{
+				// Other events are senseless to us
+				delete e;
+			}
+		}
+
+		// the main stream of a split file has a smaller range than the whole file
+		quint64 uEndPosition = m_uEndPosition.load();
+		bool bRanged = uEndPosition < m_pOpt->uTotalFileSize;
+
+		// if we have exhausted the bandwidth budget don't even look at the socket:
+		// just sleep until the buckets are refilled (or something happens to us)
+		int iBandwidthWait = m_pOpt->pLimiter->msecsUntilAvailable();
+
+		bool bCanRead;
+		bool bDummy;
+
+		if(waitForSocket(iBandwidthWait == 0, false, &bCanRead, &bDummy, iBandwidthWait > 0 ? iBandwidthWait : DCC_IDLE_WAIT_MSECS))
+		{
+			// the max number of bytes we can receive now (buffer space and bandwidth limit)
+			unsigned int uSpace = m_uBufferSize - m_uBufferFill;
+			unsigned int uToRead = m_pOpt->pLimiter->acquire(uSpace);
+			if(uToRead == 0)
+				continue; // another transfer was faster
+
+			int readLen;
+			m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+			if(m_pSSL)
+			{
+				readLen = m_pSSL->read(m_pBuffer + m_uBufferFill, uToRead);
+			}
+			else
+			{
+#endif
+				readLen = kvi_socket_recv(m_fd, m_pBuffer + m_uBufferFill, uToRead);
+#ifdef COMPILE_SSL_SUPPORT
+			}
+#endif
+
+			// give back the part of the budget we didn't use
+			if(readLen < (int)uToRead)
+				m_pOpt->pLimiter->refund(readLen > 0 ? uToRead - readLen : uToRead);
+
+			if(readLen > 0)
+			{
+				// Readed something useful...queue it for writing
+				if((receivedPosition() + readLen) > uEndPosition)
+				{
+					postMessageEvent(__tr_no_lookup_ctx("WARNING: the peer is sending garbage data past the end of the file", "dcc"));
+					postMessageEvent(__tr_no_lookup_ctx("WARNING: ignoring data past the declared end of file and closing the connection", "dcc"));
+
+					if(uEndPosition > receivedPosition())
+						m_uBufferFill += (unsigned int)(uEndPosition - receivedPosition());
+					if(!flushBuffer(true))
+						postErrorEvent(KviError::FileIOError);
+					break;
+				}
+
+				m_uBufferFill += readLen;
+
+				if(m_uBufferFill == m_uBufferSize)
+				{
+					if(!flushBuffer(false))
+					{
+						postErrorEvent(KviError::FileIOError);
+						break;
+					}
+
+					// the socket had at least as much data as we could take: read more at once
+					if((readLen == (int)uSpace) && (m_uBufferSize < KVI_DCC_RECV_MAX_BUFFER_SIZE))
+					{
+						m_uBufferSize *= 2;
+						m_pBuffer = (char *)KviMemory::reallocate(m_pBuffer, m_uBufferSize);
+					}
+				}
+
+				// Update stats
+				m_uTotalReceivedBytes += readLen;
+				m_uInstantReceivedBytes += readLen;
+
+				updateStats();
+				// Now send the ack
+				if(m_pOpt->bNoAcks)
+				{
+					// No acks...
+					// Interrupt if the whole file has been received
+					if(m_pOpt->uTotalFileSize > 0)
+					{
+						if(receivedPosition() == uEndPosition)
+						{
+							// Received the whole file...die
+							if(!flushBuffer(true))
+							{
+								postErrorEvent(KviError::FileIOError);
+								break;
+							}
+							postDigestEvent();
+							KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+							postEvent(parent(), e);
+							break;
+						}
+					}
+				}
+				else
+				{
+					// Must send the ack... the peer must close the connection.
+					// A single ack covers everything that this (possibly large) read has drained from the socket.
+					if(!sendAck(receivedPosition(), bSend64BitAck))
+						break;
+
+					if(bRanged && (receivedPosition() == uEndPosition))
+					{
+						// our part of the file is complete: the peer waits for us to close the connection
+						if(!flushBuffer(true))
+						{
+							postErrorEvent(KviError::FileIOError);
+							break;
+						}
+						postDigestEvent();
+						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+						postEvent(parent(), e);
+						break;
+					}
+				}
+
+			}
+			else
+			{
+				updateStats();
+// Read problem...
+
+#ifdef COMPILE_SSL_SUPPORT
+				if(m_pSSL)
+				{
+					// ssl error....?
+					switch(m_pSSL->getProtocolError(readLen))
+					{
+						case KviSSL::ZeroReturn:
+							//check again not necessary a connection closure!
+							//if (!handleInvalidSocketRead(readLen)
+							// break;
+							readLen = 0;
+							break;
+						case KviSSL::Success:
+						case KviSSL::WantRead:
+						case KviSSL::WantWrite:
+							// hmmm... DO NOT CALL handleInvalidSocketRead
+							break;
+						case KviSSL::SyscallError:
+						{
+							int iE = m_pSSL->getLastError(true);
+							if(iE != 0)
+							{
+								raiseSSLError();
+								postErrorEvent(KviError::SSLError);
+								goto exit_dcc;
+							}
+						}
+						break;
+						case KviSSL::SSLError:
+						{
+							raiseSSLError();
+							postErrorEvent(KviError::SSLError);
+							goto exit_dcc;
+						}
+						break;
+						default:
+							// Raise unknown SSL ERROR
+							postErrorEvent(KviError::SSLError);
+							goto exit_dcc;
+							break;
+					}
+				}
+#endif
+
+				if(readLen == 0)
+				{
+					// read EOF..
+					if((receivedPosition() == uEndPosition) || (m_pOpt->uTotalFileSize == 0))
+					{
+						// success if we got the whole file or if we don't know the file size (we trust the peer)
+						if(!flushBuffer(true))
+						{
+							postErrorEvent(KviError::FileIOError);
+							break;
+						}
+						postDigestEvent();
+						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+						postEvent(parent(), e);
+						break;
+					}
+				}
+#ifdef COMPILE_SSL_SUPPORT
+				if(!m_pSSL && !handleInvalidSocketRead(readLen))
+					break;
+#else
+				if(!handleInvalidSocketRead(readLen))
+					break;
+#endif
+			}
+
+			// include the artificial delay if needed
+			if(m_pOpt->iIdleStepLengthInMSec > 0)
+				msleep(m_pOpt->iIdleStepLengthInMSec);
+		}
+		else
+		{
+			// timeout, end of the bandwidth wait or a thread event:
+			// the link is idle, a good moment to write out what we have
+			if(!flushBuffer(true))
+			{
+				postErrorEvent(KviError::FileIOError);
+				break;
+			}
+
+			updateStats();
+
+			if(bRanged && (receivedPosition() == uEndPosition))
+			{
+				// the range has been shrunk after we have received all of it
+				postDigestEvent();
+				KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+				postEvent(parent(), e);
+				break;
+			}
+
+			if(receivedPosition() == uEndPosition)
+			{
+				// Wait for the peer to close the connection
+				if(iProbableTerminationTime == 0)
+				{
+					iProbableTerminationTime = (int)kvi_unixTime();
+					postMessageEvent(__tr_no_lookup_ctx("Data transfer terminated, waiting 30 seconds for the peer to close the connection...", "dcc"));
+					// FIXME: Close the file ?
+				}
+				else
+				{
+					int iDiff = (((int)kvi_unixTime()) - iProbableTerminationTime);
+					if(iDiff > 30)
+					{
+						// success if we got the whole file or if we don't know the file size (we trust the peer)
+						postMessageEvent(__tr_no_lookup_ctx("Data transfer was terminated 30 seconds ago, closing the connection", "dcc"));
+						postDigestEvent();
+						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+						postEvent(parent(), e);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+exit_dcc:
+	if(m_pFile)
+	{
+		// keep what we have received: the transfer may be resumed later
+		flushBuffer(true);
+		m_pFile->close();
+		delete m_pFile;
+		m_pFile = nullptr;
+	}
+
+	if(m_pOpt->bReportStatistics)
+		postStatisticsEvent(m_uTotalReceivedBytes);
+
+#ifdef COMPILE_SSL_SUPPORT
+	freeSSL();
+#endif
+
+	kvi_socket_close(m_fd);
+	m_fd = KVI_INVALID_SOCKET;
+}
+
+void DccRecvThread::shrinkEndPosition(quint64 uEnd)
+{
+	quint64 uOldEnd = m_uEndPosition.load();
+	while(uEnd < uOldEnd)
+	{
+		if(m_uEndPosition.compare_exchange_weak(uOldEnd, uEnd))
+			break;
+	}
+	// we might be already idle at the new end
+	eventEnqueued();
+}
+
+void DccRecvThread::initGetInfo()
+{
+	m_pMutex->lock();
+}
+
+void DccRecvThread::doneGetInfo()
+{
+	m_pMutex->unlock();
+}
+
+DccSendThread::DccSendThread(QObject * par, kvi_socket_t fd, KviDccSendThreadOptions * opt)
+    : DccThread(par, fd)
+{
+	m_pOpt = opt;
+	// stats
+	m_uAverageSpeed = 0;
+	m_uInstantSpeed = 0;
+	m_uFilePosition = 0;
+	m_uTotalSentBytes = 0;
+	m_pTimeInterval = new KviMSecTimeInterval();
+	m_uEndPosition.store(opt->uEndPosition);
+	m_uReservedPosition = opt->uStartPosition;
+	m_uStartTime = 0;
+	m_uInstantSpeedInterval = 0;
+}
+
+DccSendThread::~DccSendThread()
+{
+	if(m_pOpt)
+		delete m_pOpt;
+	delete m_pTimeInterval;
+}
+
+bool DccSendThread::setEndPosition(quint64 uEnd)
+{
+	// the slave reserves each chunk under the mutex before sending it:
+	// once we have stored the new end it can't go past it
+	m_pMutex->lock();
+	bool bOk = m_uReservedPosition <= uEnd;
+	if(bOk)
+		m_uEndPosition.store(uEnd);
+	m_pMutex->unlock();
+	return bOk;
+}
+
+quint64 DccSendThread::endPosition(quint64 uFileSize)
+{
+	quint64 uEnd = m_uEndPosition.load();
+	if((uEnd == 0) || (uEnd > uFileSize))
+		return uFileSize;
+	return uEnd;
+}
+
+void DccSendThread::updateStats()
+{
+	m_uInstantSpeedInterval += m_pTimeInterval->mark();
+
+	m_pMutex->lock();
+	unsigned long uElapsedTime = m_pTimeInterval->secondsCounter() - m_uStartTime;
+	if(uElapsedTime < 1)
+		uElapsedTime = 1;
+
+	if(m_pOpt->bNoAcks)
+	{
+		// There are no acks : the avg bandwidth is based on the sent bytes
+		m_uAverageSpeed = m_uTotalSentBytes / uElapsedTime;
+	}
+	else
+	{
+		// acknowledges : we compute the avg bandwidth based on the acks we receive
+		m_uAverageSpeed = (m_uAckedBytes - m_pOpt->uStartPosition) / uElapsedTime;
+	}
+
+	if(m_uInstantSpeedInterval >= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
+	{
+		// we often overcount the time interval of 10-20 msecs
+		// and thus our bandwidth is used less than requested.
+		// for this reason we try to account the time in excess
+		// to the next period in order to balance the bandwidth usage.
+		unsigned long uMSecsOfNextPeriodUsed = 0;
+		if(m_uInstantSpeedInterval > INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS)
+		{
+			if(m_uInstantSpeedInterval < (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS + (INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS / 2)))
+			{
+				uMSecsOfNextPeriodUsed = m_uInstantSpeedInterval - INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
+				m_uInstantSpeedInterval = INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_MSECS;
+			}
+			// else we have been delayed for a time comparable to a period
+			// and thus we can't recover the bandwidth... let it go as it does...
+		}
+		m_uInstantSpeed = (m_uInstantSentBytes * 1000) / m_uInstantSpeedInterval;
+		m_uInstantSpeedInterval = uMSecsOfNextPeriodUsed;
+		m_uInstantSentBytes = 0;
+	}
+	else
+	{
+		if(uElapsedTime <= INSTANT_BANDWIDTH_CHECK_INTERVAL_IN_SECS)
+			m_uInstantSpeed = m_uAverageSpeed;
+	}
+	m_pMutex->unlock();
+}
+
+union _ack_buffer {
+	char cAckBuffer[4];
+	quint32 i32AckBuffer;
+};
+
+#ifdef HAVE_SENDFILE
+// Sends iLen bytes from the current position of pFile straight from the page cache.
+// Returns the number of bytes sent (0 if the socket would block), -1 on a fatal
+// error (already posted) or ZERO_COPY_UNSUPPORTED if the file can't be sent this way
+int DccSendThread::sendFileChunk(QFile * pFile, int iLen)
+{
+#ifdef HAVE_SENDFILE64
+	off64_t offset = pFile->pos();
+	m_uSocketCalls++;
+	ssize_t written = ::sendfile64(m_fd, pFile->handle(), &offset, iLen);
+#else
+	// off_t is 32 bit wide when building without large file support:
+	// the rest of the file goes through read() + send()
+	if((quint64)pFile->pos() + iLen > (quint64)std::numeric_limits<off_t>::max())
+		return ZERO_COPY_UNSUPPORTED;
+	off_t offset = pFile->pos();
+	m_uSocketCalls++;
+	ssize_t written = ::sendfile(m_fd, pFile->handle(), &offset, iLen);
+#endif
+	if(written < 0)
+	{
+		int err = errno;
+		if((err == EINVAL) || (err == ENOSYS) || (err == EOPNOTSUPP))
+			return ZERO_COPY_UNSUPPORTED;
+		if((err == EAGAIN) || (err == EINTR))
+			return 0;
+		postErrorEvent(KviError::translateSystemError(err));
+		return -1;
+	}
+	if(written == 0)
+	{
+		// the file has been truncated while we were sending it
+		postErrorEvent(KviError::FileIOError);
+		return -1;
+	}
+	// sendfile() doesn't move the file pointer
+	if(!pFile->seek(offset))
+	{
+		postErrorEvent(KviError::FileIOError);
+		return -1;
+	}
+	return (int)written;
+}
+#endif
+
+void DccSendThread::run()
+{
+	m_pTimeInterval->mark();
+	m_pMutex->lock();
+	m_uStartTime = m_pTimeInterval->secondsCounter();
+	m_pMutex->unlock();
+
+	startStatistics();
+
+	m_uTotalSentBytes = 0;
+	m_uInstantSentBytes = 0;
+	_ack_buffer ackbuffer;
+	int iBytesInAckBuffer = 0;
+	quint32 uLastAck = 0;
+	quint64 uTotLastAck = 0;
+	bool bAckHack = false;
+	quint64 iAckHackRounds = 0;
+
+	if(m_pOpt->iPacketSize < 32)
+		m_pOpt->iPacketSize = 32;
+	char * buffer = (char *)KviMemory::allocate(m_pOpt->iPacketSize * sizeof(char));
+
+	// plain text transfers can skip the copy of the file data through our buffer
+	bool bZeroCopy = false;
+#ifdef HAVE_SENDFILE
+	bZeroCopy = true;
+#ifdef COMPILE_SSL_SUPPORT
+	if(m_pSSL)
+		bZeroCopy = false;
+#endif
+#endif
+
+	QFile * pFile = new QFile(QString::fromUtf8(m_pOpt->szFileName.ptr()));
+
+	// with sendfile() the QFile buffer would only get in the way of seek()
+	if(!pFile->open(bZeroCopy ? (QIODevice::ReadOnly | QIODevice::Unbuffered) : QIODevice::ReadOnly))
+	{
+		postErrorEvent(KviError::CantOpenFileForReading);
+		goto exit_dcc;
+	}
+
+	if(pFile->size() < 1)
+	{
+		postErrorEvent(KviError::CantSendAZeroSizeFile);
+		goto exit_dcc;
+	}
+
+	if(pFile->size() >= 0xffffffff)
+	{
+		//dcc acks support only files up to 4GiB
+		bAckHack = true;
+		// the acks will be relative to our starting 4GiB block
+		iAckHackRounds = m_pOpt->uStartPosition >> 32;
+	}
+
+	if(m_pOpt->uStartPosition > 0)
+	{
+		// seek
+		if(!(pFile->seek(m_pOpt->uStartPosition)))
+		{
+			postErrorEvent(KviError::FileIOError);
+			goto exit_dcc;
+		}
+	}
+
+	uLastAck = m_pOpt->uStartPosition;
+	uTotLastAck = m_pOpt->uStartPosition;
+
+	for(;;)
+	{
+		// Dequeue events
+		while(KviThreadEvent * e = dequeueEvent())
+		{
+			if(e->id() == KVI_THREAD_EVENT_TERMINATE)
+			{
+				delete e;
+				goto exit_dcc;
+			}
+			else
+			{
+				// Other events are senseless to us
+				delete e;
+			}
+		}
+
+		// figure out what we're waiting for: the acks (or the connection close
+		// in a TSEND) and the socket being writable when we have something
+		// to send out in the current bandwidth interval
+		// the main stream of a split file stops before the end of the file:
+		// the receiver closes the connection when it has got the whole range
+		quint64 uFileSize = pFile->size();
+		quint64 uEndPosition = endPosition(uFileSize);
+		bool bRanged = uEndPosition < uFileSize;
+		bool bAtEnd = ((quint64)pFile->pos()) >= uEndPosition;
+		bool bWantRead = (!m_pOpt->bNoAcks) || (m_pOpt->bIsTdcc && bAtEnd);
+		bool bWantWrite;
+		int iTimeout = DCC_IDLE_WAIT_MSECS;
+
+		if(bAtEnd)
+		{
+			// a blind dcc send which is not a tdcc can be closed as soon as possible
+			bWantWrite = m_pOpt->bNoAcks && !m_pOpt->bIsTdcc;
+		}
+		else if(m_pOpt->bFastSend || m_pOpt->bNoAcks || (uTotLastAck == (quint64)pFile->pos()))
+		{
+			int iBandwidthWait = m_pOpt->pLimiter->msecsUntilAvailable();
+			bWantWrite = (iBandwidthWait == 0);
+			if(!bWantWrite)
+				iTimeout = iBandwidthWait; // sleep until the buckets are refilled
+		}
+		else
+		{
+			// waiting for the ack of the last packet
+			bWantWrite = false;
+		}
+
+		bool bCanRead;
+		bool bCanWrite;
+
+		if(waitForSocket(bWantRead, bWantWrite, &bCanRead, &bCanWrite, iTimeout))
+		{
+			if(bCanRead)
+			{
+				if(!m_pOpt->bNoAcks)
+				{
+					int iAckBytesToRead = 4 - iBytesInAckBuffer;
+
+					int readLen;
+					m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+					if(m_pSSL)
+					{
+						readLen = m_pSSL->read((ackbuffer.cAckBuffer + iBytesInAckBuffer), iAckBytesToRead);
+					}
+					else
+					{
+#endif
+						readLen = kvi_socket_recv(m_fd, (ackbuffer.cAckBuffer + iBytesInAckBuffer), iAckBytesToRead);
+#ifdef COMPILE_SSL_SUPPORT
+					}
+#endif
+
+					if(readLen > 0)
+					{
+						iBytesInAckBuffer += readLen;
+						if(iBytesInAckBuffer == 4)
+						{
+							quint32 iNewAck = ntohl(ackbuffer.i32AckBuffer);
+							if(iNewAck > pFile->pos())
+							{
+								// the peer is drunk or is trying to fool us
+								postErrorEvent(KviError::AcknowledgeError);
+								break;
+							}
+							if(iNewAck < uLastAck)
+							{
+								if(bAckHack)
+								{
+									//we reached the 4gb ack limit
+									iAckHackRounds++;
+								}
+								else
+								{
+									// the peer is drunk or is trying to fool us
+									postErrorEvent(KviError::AcknowledgeError);
+									break;
+								}
+							}
+							uLastAck = iNewAck;
+							if(bAckHack)
+							{
+								uTotLastAck = (iAckHackRounds << 32) + iNewAck;
+							}
+							else
+							{
+
+								uTotLastAck = iNewAck;
+							}
+							iBytesInAckBuffer = 0;
+						}
+					}
+					else
+					{
+#ifdef COMPILE_SSL_SUPPORT
+						if(m_pSSL)
+						{
+							// ssl error....?
+							switch(m_pSSL->getProtocolError(readLen))
+							{
+
+								case KviSSL::ZeroReturn:
+									//if (!handleInvalidSocketRead(readLen)
+									// break;
+									readLen = 0;
+									break;
+								case KviSSL::Success:
+								case KviSSL::WantRead:
+								case KviSSL::WantWrite:
+									// hmmm...
+									break;
+								case KviSSL::SyscallError:
+								{
+									int iE = m_pSSL->getLastError(true);
+									if(iE != 0)
+									{
+										raiseSSLError();
+										postErrorEvent(KviError::SSLError);
+										goto exit_dcc;
+									}
+								}
+								break;
+								case KviSSL::SSLError:
+								{
+									raiseSSLError();
+									postErrorEvent(KviError::SSLError);
+									goto exit_dcc;
+								}
+								break;
+								default:
+									// Raise unknown SSL ERROR
+									postErrorEvent(KviError::SSLError);
+									goto exit_dcc;
+									break;
+							}
+						}
+
+						if((readLen == 0) && bRanged && (uTotLastAck >= uEndPosition))
+						{
+							// the receiver has got the whole range and closed the connection
+							updateStats();
+							KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+							postEvent(parent(), e);
+							break;
+						}
+
+						if(!m_pSSL && !handleInvalidSocketRead(readLen))
+							break;
+#else
+						if((readLen == 0) && bRanged && (uTotLastAck >= uEndPosition))
+						{
+							// the receiver has got the whole range and closed the connection
+							updateStats();
+							KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+							postEvent(parent(), e);
+							break;
+						}
+
+						if(!handleInvalidSocketRead(readLen))
+							break;
+#endif
+					}
+
+					// update stats
+					m_pMutex->lock(); // is this really necessary ?
+					m_uAckedBytes = uTotLastAck;
+					m_pMutex->unlock();
+
+					if((uTotLastAck >= uFileSize) && !bRanged)
+					{
+						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+						postEvent(parent(), e);
+						break;
+					}
+				}
+				else
+				{
+					// No acknowledges
+					if(m_pOpt->bIsTdcc)
+					{
+						// We expect the remote end to close the connection when the whole file has been sent
+						if(bAtEnd)
+						{
+							int iAck;
+							int readLen;
+							m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+							if(m_pSSL)
+							{
+								readLen = m_pSSL->read((char *)&iAck, 4);
+							}
+							else
+							{
+#endif
+								readLen = kvi_socket_recv(m_fd, (char *)&iAck, 4);
+#ifdef COMPILE_SSL_SUPPORT
+							}
+#endif
+							if(readLen == 0)
+							{
+								// done...success
+								updateStats();
+								KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+								postEvent(parent(), e);
+								break;
+							}
+							else
+							{
+								if(readLen < 0)
+								{
+#ifdef COMPILE_SSL_SUPPORT
+									if(m_pSSL)
+									{
+										// ssl error....?
+										switch(m_pSSL->getProtocolError(readLen))
+										{
+
+											case KviSSL::ZeroReturn:
+												readLen = 0;
+												break;
+											case KviSSL::Success:
+											case KviSSL::WantRead:
+											case KviSSL::WantWrite:
+												// hmmm...
+												break;
+											case KviSSL::SyscallError:
+											{
+												int iE = m_pSSL->getLastError(true);
+												if(iE != 0)
+												{
+													raiseSSLError();
+													postErrorEvent(KviError::SSLError);
+													goto exit_dcc;
+												}
+											}
+											break;
+											case KviSSL::SSLError:
+											{
+												raiseSSLError();
+												postErrorEvent(KviError::SSLError);
+												goto exit_dcc;
+											}
+											break;
+											default:
+												// Raise unknown SSL ERROR
+												postErrorEvent(KviError::SSLError);
+												goto exit_dcc;
+												break;
+										}
+									}
+
+									if(!m_pSSL && !handleInvalidSocketRead(readLen))
+										break;
+#else
+									if(!handleInvalidSocketRead(readLen))
+										break;
+#endif
+								}
+								else
+								{
+									KviThreadDataEvent<KviCString> * e = new KviThreadDataEvent<KviCString>(KVI_DCC_THREAD_EVENT_MESSAGE);
+									e->setData(new KviCString(__tr2qs_ctx("WARNING: received data in a DCC TSEND, there should be no acknowledges", "dcc")));
+									postEvent(parent(), e);
+								}
+							}
+						}
+					}
+				}
+			}
+			if(bCanWrite)
+			{
+				// the range might have been shrunk while we were waiting
+				uEndPosition = endPosition(uFileSize);
+				if(((quint64)pFile->pos()) < uEndPosition)
+				{
+					if(m_pOpt->bFastSend || m_pOpt->bNoAcks || (uTotLastAck == (quint64)pFile->pos()))
+					{
+						// maximum readable size: setEndPosition() may shrink the range
+						// at any time, so we reserve the chunk before sending it
+						m_pMutex->lock();
+						uEndPosition = endPosition(uFileSize);
+						qint64 toRead = (uEndPosition > (quint64)pFile->pos()) ? (qint64)(uEndPosition - pFile->pos()) : 0;
+						// limit to packet size
+						int iMaxChunk = m_pOpt->iPacketSize;
+						if(bZeroCopy && (m_pOpt->bFastSend || m_pOpt->bNoAcks) && (iMaxChunk < ZERO_COPY_MAX_CHUNK_SIZE))
+							iMaxChunk = ZERO_COPY_MAX_CHUNK_SIZE;
+						if(toRead > iMaxChunk)
+							toRead = iMaxChunk;
+						m_uReservedPosition = pFile->pos() + toRead;
+						m_pMutex->unlock();
+						// the max number of bytes we can send now (bandwidth limit)
+						toRead = m_pOpt->pLimiter->acquire((unsigned int)toRead);
+
+						int written = 0;
+						if(bZeroCopy && (toRead > 0))
+						{
+#ifdef HAVE_SENDFILE
+							written = sendFileChunk(pFile, toRead);
+							if(written == ZERO_COPY_UNSUPPORTED)
+							{
+								// fall back to read() + send() from the next round
+								bZeroCopy = false;
+								written = 0;
+							}
+							else if(written < 0)
+							{
+								goto exit_dcc;
+							}
+#endif
+						}
+						else if(toRead > 0)
+						{
+							// read data
+							int readed = pFile->read(buffer, toRead);
+							if(readed < toRead)
+							{
+								postErrorEvent(KviError::FileIOError);
+								break;
+							}
+// send it out
+
+							m_uSocketCalls++;
+#ifdef COMPILE_SSL_SUPPORT
+							if(m_pSSL)
+							{
+								written = m_pSSL->write(buffer, toRead);
+							}
+							else
+							{
+#endif
+								written = kvi_socket_send(m_fd, buffer, toRead);
+#ifdef COMPILE_SSL_SUPPORT
+							}
+#endif
+
+							if(written < toRead)
+							{
+								if(written < 0)
+								{
+#ifdef COMPILE_SSL_SUPPORT
+									if(m_pSSL)
+									{
+										// ops...might be an SSL error
+										switch(m_pSSL->getProtocolError(written))
+										{
+											case KviSSL::Success:
+											case KviSSL::WantWrite:
+											case KviSSL::WantRead:
+												// Async continue...
+												goto handle_system_error;
+												break;
+											case KviSSL::SyscallError:
+												if(written == 0)
+												{
+													raiseSSLError();
+													postErrorEvent(KviError::RemoteEndClosedConnection);
+													goto exit_dcc;
+												}
+												else
+												{
+													int iSSLErr = m_pSSL->getLastError(true);
+													if(iSSLErr != 0)
+													{
+														raiseSSLError();
+														postErrorEvent(KviError::SSLError);
+														goto exit_dcc;
+													}
+													else
+													{
+														goto handle_system_error;
+													}
+												}
+												break;
+											case KviSSL::SSLError:
+												raiseSSLError();
+												postErrorEvent(KviError::SSLError);
+												goto exit_dcc;
+												break;
+											default:
+												postErrorEvent(KviError::SSLError);
+												goto exit_dcc;
+												break;
+										}
+									}
+
+									if(!m_pSSL && !handleInvalidSocketRead(written))
+										break;
+
+#else
+									if(!handleInvalidSocketRead(written))
+										break;
+#endif
+
+								handle_system_error:
+									int err = kvi_socket_error();
+#if defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW)
+									if((err != EAGAIN) && (err != EINTR) && (err != WSAEWOULDBLOCK))
+#else
+									if((err != EAGAIN) && (err != EINTR))
+#endif
+									{
+										postErrorEvent(KviError::translateSystemError(err));
+										goto exit_dcc;
+									}
+								}
+								else
+								{
+									// seek back to the right position
+									pFile->seek(pFile->pos() - (toRead - written));
+								}
+							}
+						}
+
+						// give back the part of the budget we didn't use
+						if(written < toRead)
+							m_pOpt->pLimiter->refund(written > 0 ? toRead - written : toRead);
+
+						m_uTotalSentBytes += written;
+						m_uInstantSentBytes += written;
+						m_uFilePosition = pFile->pos();
+						updateStats();
+					}
+				}
+				else
+				{
+					if(m_pOpt->bNoAcks && !m_pOpt->bIsTdcc)
+					{
+						// at end of the file in a blind dcc send...
+						// not in a tdcc: we can close the file...
+						updateStats();
+						KviThreadEvent * e = new KviThreadEvent(KVI_DCC_THREAD_EVENT_SUCCESS);
+						postEvent(parent(), e);
+						break;
+					}
+				}
+			}
+		}
+		else
+		{
+			// timeout, end of the bandwidth wait or a thread event
+			updateStats();
+		}
+
+		// include the artificial delay if needed
+		if(m_pOpt->iIdleStepLengthInMSec > 0)
+		{
+			msleep(m_pOpt->iIdleStepLengthInMSec);
+		}
+	}
+
+exit_dcc:
+	KviMemory::free(buffer);
+	pFile->close();
+	delete pFile;
+	pFile = nullptr;
+
+	if(m_pOpt->bReportStatistics)
+		postStatisticsEvent(m_uTotalSentBytes);
+
+#ifdef COMPILE_SSL_SUPPORT
+	freeSSL();
+#endif
+	kvi_socket_close(m_fd);
+	m_fd = KVI_INVALID_SOCKET;
+}
+
+void DccSendThread::initGetInfo()
+{
+	m_pMutex->lock();
+}
+
+void DccSendThread::doneGetInfo()
+{
+	m_pMutex->unlock();
+}
@@ -0,0 +1,173 @@
+#ifndef _DCCFILETRANSFERTHREAD_H_
+#define _DCCFILETRANSFERTHREAD_H_
+//=============================================================================
+//
+//   File : DccFileTransferThread.h
+//   Creation date : Tue Sep 24 09 2000 15:06:12 by Szymon Stefanek
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2000-2010 Szymon Stefanek (pragma at kvirc dot net)
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+// The slave threads of the DCC file transfers and their options.
+// They depend only on kvilib, so src/tests can drive them without the GUI.
+
+#include "DccThread.h"
+#include "DccBandwidthShaper.h"
+
+#include "KviCString.h"
+#include "kvi_sockettype.h"
+#include "KviTimeUtils.h"
+
+#include <QFile>
+#include <QCryptographicHash>
+
+#include <atomic>
+
+typedef struct _KviDccSendThreadOptions
+{
+	KviCString szFileName;
+	quint64 uStartPosition;
+	quint64 uEndPosition; // 0: up to the end of the file
+	int iPacketSize;
+	int iIdleStepLengthInMSec;
+	bool bFastSend;
+	bool bNoAcks;
+	bool bIsTdcc;
+	bool bReportStatistics; // post the transfer loop statistics at the end
+	DccBandwidthLimiter * pLimiter; // NOT OWNED: the transfer deletes it after the thread
+} KviDccSendThreadOptions;
+
+class DccSendThread : public DccThread
+{
+public:
+	DccSendThread(QObject * par, kvi_socket_t fd, KviDccSendThreadOptions * opt);
+	~DccSendThread();
+
+private:
+	// stats: SHARED!!!
+	uint m_uAverageSpeed;
+	uint m_uInstantSpeed;
+	std::atomic<quint64> m_uFilePosition;
+	quint64 m_uAckedBytes;
+	quint64 m_uTotalSentBytes;
+	// internal
+	unsigned long m_uStartTime;
+	unsigned long m_uInstantSpeedInterval;
+	quint64 m_uInstantSentBytes;
+	KviDccSendThreadOptions * m_pOpt;
+	KviMSecTimeInterval * m_pTimeInterval; // used for computing the instant bandwidth but not only
+	std::atomic<quint64> m_uEndPosition;   // 0: up to the end of the file
+	quint64 m_uReservedPosition;          // protected by m_pMutex: end of the chunk being sent
+public:
+	void initGetInfo();
+	uint averageSpeed() { return m_uAverageSpeed; };
+	uint instantSpeed() { return m_uInstantSpeed; };
+	quint64 filePosition() { return m_uFilePosition.load(); };
+	// sent ONLY in this session
+	quint64 sentBytes() { return m_uTotalSentBytes; };
+	quint64 ackedBytes() { return m_uAckedBytes; };
+	void doneGetInfo();
+	// Makes the thread stop sending at uEnd: the remote end is going to close the connection then.
+	// Returns false if the data past uEnd has already been sent.
+	bool setEndPosition(quint64 uEnd);
+
+protected:
+	quint64 endPosition(quint64 uFileSize);
+	void updateStats();
+#ifdef HAVE_SENDFILE
+	int sendFileChunk(QFile * pFile, int iLen);
+#endif
+	virtual void run();
+};
+
+typedef struct _KviDccRecvThreadOptions
+{
+	bool bResume;
+	KviCString szFileName;
+	quint64 uTotalFileSize;
+	// a segment writes only the range [uStartPosition,uEndPosition) of the file
+	quint64 uStartPosition;
+	quint64 uEndPosition; // 0 if this is not a segment
+	int iIdleStepLengthInMSec;
+	bool bSendZeroAck;
+	bool bSend64BitAck;
+	bool bNoAcks;
+	bool bIsTdcc;
+	bool bPreallocate;
+	bool bComputeDigest;
+	bool bReportStatistics; // post the transfer loop statistics at the end
+	DccBandwidthLimiter * pLimiter; // NOT OWNED: the transfer deletes it after the thread
+} KviDccRecvThreadOptions;
+
+class DccRecvThread : public DccThread
+{
+public:
+	DccRecvThread(QObject * par, kvi_socket_t fd, KviDccRecvThreadOptions * opt);
+	~DccRecvThread();
+
+protected:
+	KviDccRecvThreadOptions * m_pOpt;
+
+	// stats: SHARED!
+	uint m_uAverageSpeed;
+	uint m_uInstantSpeed;
+	quint64 m_uFilePosition;
+	quint64 m_uTotalReceivedBytes;
+
+	// internal
+	unsigned long m_uStartTime;
+	KviMSecTimeInterval * m_pTimeInterval; // used for computing the instant bandwidth
+	quint64 m_uInstantReceivedBytes;
+	quint64 m_uInstantSpeedInterval;
+	QFile * m_pFile;
+	// received data not written to the file yet
+	char * m_pBuffer;
+	unsigned int m_uBufferSize;
+	unsigned int m_uBufferFill;
+	// digest of the data written to the file (if requested)
+	QCryptographicHash * m_pDigest;
+	// we stop receiving here: it is smaller than the file size when other streams carry the rest
+	std::atomic<quint64> m_uEndPosition;
+
+public:
+	void initGetInfo();
+	uint averageSpeed() { return m_uAverageSpeed; };
+	uint instantSpeed() { return m_uInstantSpeed; };
+	quint64 filePosition() { return m_uFilePosition; };
+	// received ONLY in this session
+	quint64 receivedBytes() { return m_uTotalReceivedBytes; };
+	void doneGetInfo();
+	// Shrinks the range received by this thread: the other parts come from other streams
+	void shrinkEndPosition(quint64 uEnd);
+
+protected:
+	void postMessageEvent(const char * msg);
+	void updateStats();
+	bool sendAck(qint64 filePos, bool bUse64BitAck = false);
+	// the file position including the buffered data
+	quint64 receivedPosition() { return (quint64)m_pFile->pos() + m_uBufferFill; };
+	// writes the buffered data up to an aligned file offset (or all of it)
+	bool flushBuffer(bool bAll);
+	void preallocateFile();
+	bool hashExistingData();
+	void postDigestEvent();
+	virtual void run();
+};
+
+#endif //_DCCFILETRANSFERTHREAD_H_
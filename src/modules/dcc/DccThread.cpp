@@ -25,37 +25,64 @@
 #include "DccThread.h"
 
 #include "kvi_debug.h"
-#include "KviWindow.h"
 #include "KviError.h"
 #include "KviMemory.h"
 #include "KviNetUtils.h"
 #include "kvi_socket.h"
 
-#ifdef COMPILE_SSL_SUPPORT
-#include "KviSSLMaster.h"
+#include <chrono>
+#include <time.h>
+
+#if !(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
+// without a wake up pipe we can't sleep longer than this or the exit latency would suffer
+#define DCC_THREAD_MAX_BLIND_WAIT_MSECS 100
+
 DccThread::DccThread(QObject * par, kvi_socket_t fd)
     : KviSensitiveThread()
 {
 	m_pParent = par;
 	m_fd = fd;
 	m_pMutex = new KviMutex();
+	m_uWakeUps = 0;
+	m_uSocketCalls = 0;
+	m_iStatisticsStartTime = 0;
 #ifdef COMPILE_SSL_SUPPORT
 	//	qDebug("CLEARING SSL IN DccThread constructor");
 	m_pSSL = nullptr;
 #endif
+#if !(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+	if(pipe(m_wakeUpPipe) == 0)
+	{
+		fcntl(m_wakeUpPipe[0], F_SETFL, O_NONBLOCK);
+		fcntl(m_wakeUpPipe[1], F_SETFL, O_NONBLOCK);
+	}
+	else
+	{
+		m_wakeUpPipe[0] = -1;
+		m_wakeUpPipe[1] = -1;
+	}
+#endif
 }
 
 DccThread::~DccThread()
 {
 #ifdef COMPILE_SSL_SUPPORT
-	if(m_pSSL)
-		KviSSLMaster::freeSSL(m_pSSL);
-	m_pSSL = nullptr;
+	freeSSL();
 #endif
 	if(m_fd != KVI_INVALID_SOCKET)
 		kvi_socket_close(m_fd);
+#if !(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+	if(m_wakeUpPipe[0] >= 0)
+	{
+		close(m_wakeUpPipe[0]);
+		close(m_wakeUpPipe[1]);
+	}
+#endif
 	KVI_ASSERT(!m_pMutex->locked());
 	delete m_pMutex;
 }
@@ -63,10 +90,17 @@ DccThread::~DccThread()
 #ifdef COMPILE_SSL_SUPPORT
 void DccThread::setSSL(KviSSL * s)
 {
-	if(m_pSSL)
-		KviSSLMaster::freeSSL(m_pSSL);
+	freeSSL();
 	m_pSSL = s;
 }
+
+void DccThread::freeSSL()
+{
+	// This is all that KviSSLMaster::freeSSL() does: calling it would make
+	// the threads depend on the kvirc core instead of kvilib alone
+	delete m_pSSL;
+	m_pSSL = nullptr;
+}
 #endif
 
 bool DccThread::handleInvalidSocketRead(int readLen)
@@ -91,6 +125,118 @@ bool DccThread::handleInvalidSocketRead(int readLen)
 	return true; // continue
 }
 
+void DccThread::eventEnqueued()
+{
+#if !(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+	if(m_wakeUpPipe[1] >= 0)
+	{
+		char c = 0;
+		// if the pipe is full the slave has already plenty of reasons to wake up
+		if(write(m_wakeUpPipe[1], &c, 1) < 0)
+			return;
+	}
+#endif
+}
+
+bool DccThread::waitForSocket(bool bWantRead, bool bWantWrite, bool * pbCanRead, bool * pbCanWrite, int iTimeoutMSecs)
+{
+	*pbCanRead = false;
+	*pbCanWrite = false;
+
+	if(iTimeoutMSecs < 0)
+		iTimeoutMSecs = 0;
+
+	m_uWakeUps++;
+
+#ifdef COMPILE_SSL_SUPPORT
+	// SSL_read() may have buffered a whole record while we asked for a part of it:
+	// the socket would not become readable again for that data
+	if(bWantRead && m_pSSL && (m_pSSL->pending() > 0))
+	{
+		*pbCanRead = true;
+		return true;
+	}
+#endif
+
+#if defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW)
+	if(iTimeoutMSecs > DCC_THREAD_MAX_BLIND_WAIT_MSECS)
+		iTimeoutMSecs = DCC_THREAD_MAX_BLIND_WAIT_MSECS;
+
+	if(!(bWantRead || bWantWrite))
+	{
+		msleep(iTimeoutMSecs);
+		return false;
+	}
+
+	fd_set rs;
+	fd_set ws;
+	FD_ZERO(&rs);
+	FD_ZERO(&ws);
+	if(bWantRead)
+		FD_SET(m_fd, &rs);
+	if(bWantWrite)
+		FD_SET(m_fd, &ws);
+
+	struct timeval tv;
+	tv.tv_sec = iTimeoutMSecs / 1000;
+	tv.tv_usec = (iTimeoutMSecs % 1000) * 1000;
+
+	if(select(m_fd + 1, bWantRead ? &rs : nullptr, bWantWrite ? &ws : nullptr, nullptr, &tv) < 1)
+		return false; // timeout or EINTR
+
+	*pbCanRead = bWantRead && FD_ISSET(m_fd, &rs);
+	*pbCanWrite = bWantWrite && FD_ISSET(m_fd, &ws);
+#else
+	struct pollfd fds[2];
+	int iFds = 0;
+
+	if(bWantRead || bWantWrite)
+	{
+		fds[iFds].fd = m_fd;
+		fds[iFds].events = (bWantRead ? POLLIN : 0) | (bWantWrite ? POLLOUT : 0);
+		fds[iFds].revents = 0;
+		iFds++;
+	}
+
+	int iWakeUpIdx = -1;
+	if(m_wakeUpPipe[0] >= 0)
+	{
+		iWakeUpIdx = iFds;
+		fds[iFds].fd = m_wakeUpPipe[0];
+		fds[iFds].events = POLLIN;
+		fds[iFds].revents = 0;
+		iFds++;
+	}
+	else if(iTimeoutMSecs > DCC_THREAD_MAX_BLIND_WAIT_MSECS)
+	{
+		iTimeoutMSecs = DCC_THREAD_MAX_BLIND_WAIT_MSECS;
+	}
+
+	if(poll(fds, iFds, iTimeoutMSecs) < 1)
+		return false; // timeout or EINTR
+
+	if((iWakeUpIdx >= 0) && (fds[iWakeUpIdx].revents & POLLIN))
+	{
+		// the caller will dequeue the events: just empty the pipe
+		char buffer[64];
+		while(read(m_wakeUpPipe[0], buffer, 64) > 0)
+		{
+		}
+	}
+
+	if(bWantRead || bWantWrite)
+	{
+		// errors and hangups are reported as readability (or writability)
+		// so the caller hits them in the next recv() (or send())
+		short iError = fds[0].revents & (POLLERR | POLLHUP | POLLNVAL);
+		*pbCanRead = bWantRead && ((fds[0].revents & POLLIN) || iError);
+		*pbCanWrite = bWantWrite && ((fds[0].revents & POLLOUT) || iError);
+	}
+#endif
+
+	return *pbCanRead || *pbCanWrite;
+}
+
 #ifdef COMPILE_SSL_SUPPORT
 void DccThread::raiseSSLError()
 {
@@ -103,6 +249,40 @@ void DccThread::raiseSSLError()
 }
 #endif
 
+static qint64 dcc_thread_msecs_now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void DccThread::startStatistics()
+{
+	m_uWakeUps = 0;
+	m_uSocketCalls = 0;
+	m_iStatisticsStartTime = dcc_thread_msecs_now();
+}
+
+void DccThread::postStatisticsEvent(quint64 uBytes)
+{
+	quint64 uMSecs = (quint64)(dcc_thread_msecs_now() - m_iStatisticsStartTime);
+
+	// KviCString::Format has no 64 bit specifiers: go through QString
+	QString szStats = QString("Transfer loop statistics: %1 bytes in %2 msecs (%3 KiB/s), %4 socket calls (%5 bytes per call), %6 wakeups")
+	                      .arg(uBytes)
+	                      .arg(uMSecs)
+	                      .arg(uMSecs ? (uBytes * 1000) / (uMSecs * 1024) : (quint64)0)
+	                      .arg(m_uSocketCalls)
+	                      .arg(m_uSocketCalls ? uBytes / m_uSocketCalls : (quint64)0)
+	                      .arg(m_uWakeUps);
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+	struct timespec ts;
+	if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+		szStats.append(QString(", %1 msecs of CPU time").arg((quint64)ts.tv_sec * 1000 + (quint64)(ts.tv_nsec / 1000000)));
+#endif
+
+	postMessageEvent(szStats.toUtf8().data());
+}
+
 void DccThread::postErrorEvent(int err)
 {
 	KviThreadDataEvent<int> * e = new KviThreadDataEvent<int>(KVI_DCC_THREAD_EVENT_ERROR);
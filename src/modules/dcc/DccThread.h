@@ -45,6 +45,10 @@
 #define KVI_DCC_THREAD_EVENT_MESSAGE (KVI_THREAD_USER_EVENT_BASE + 4)
 // KviThreadDataEvent<int>
 #define KVI_DCC_THREAD_EVENT_ACTION (KVI_THREAD_USER_EVENT_BASE + 5)
+// KviThreadDataEvent<KviCString>: the hex SHA-256 digest of a received file
+#define KVI_DCC_THREAD_EVENT_DIGEST (KVI_THREAD_USER_EVENT_BASE + 6)
+// KviThreadEvent: there are received lines waiting in the DccChatThread queue
+#define KVI_DCC_THREAD_EVENT_LINES (KVI_THREAD_USER_EVENT_BASE + 7)
 
 typedef struct _KviDccThreadIncomingData
 {
@@ -62,11 +66,33 @@ protected:
 	KviMutex * m_pMutex; // OWNED! PROTECTS m_pOutBuffers
 	kvi_socket_t m_fd;
 	QObject * m_pParent; // READ ONLY!
+#if !(defined(COMPILE_ON_WINDOWS) || defined(COMPILE_ON_MINGW))
+	int m_wakeUpPipe[2]; // written by eventEnqueued() to interrupt waitForSocket()
+#endif
 #ifdef COMPILE_SSL_SUPPORT
 	KviSSL * m_pSSL;
 #endif
+	// statistics of the transfer loop: owned by the slave thread
+	unsigned int m_uWakeUps;     // returns from waitForSocket()
+	unsigned int m_uSocketCalls; // send(), recv() and sendfile() calls (also through SSL)
+	qint64 m_iStatisticsStartTime; // msecs
 protected:
 	bool handleInvalidSocketRead(int readLen);
+	void eventEnqueued() override;
+	// Sleeps until the socket is ready for the requested operations, an event is
+	// enqueued for this thread or iTimeoutMSecs have passed.
+	// Returns true if the socket is ready for at least one of the requested operations.
+	// Data already decrypted by the SSL layer counts as readable and returns immediately.
+	bool waitForSocket(bool bWantRead, bool bWantWrite, bool * pbCanRead, bool * pbCanWrite, int iTimeoutMSecs);
+	// Starts counting the statistics of the transfer loop: call it from run()
+	void startStatistics();
+	// Posts a message with the statistics of the transfer loop: the throughput, the socket calls,
+	// the wakeups and the CPU time used by this thread (where the platform can tell it)
+	void postStatisticsEvent(quint64 uBytes);
+#ifdef COMPILE_SSL_SUPPORT
+	// Deletes the SSL object, if any
+	void freeSSL();
+#endif
 
 public:
 	QObject * parent() { return m_pParent; };
@@ -53,11 +53,7 @@
 #define _ADPCMCODEC_CPP_
 #include "DccVoiceAdpcmCodec.h"
 
-#include <stdio.h> /*DBG*/
-
-#ifndef __STDC__
-#define signed
-#endif
+#include <QtEndian>
 
 #define ADPCM_PACKED_FRAME_SIZE_IN_BYTES 512
 #define ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES 2048
@@ -81,175 +77,155 @@ static int stepsizeTable[89] = {
 	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
 };
 
-void ADPCM_compress(short indata[], char outdata[], int len, ADPCM_state * state)
-{
-	short * lpIn;         /* Input buffer pointer */
-	signed char * lpOut;  /* output buffer pointer */
-	int val;              /* Current input sample value */
-	int sign;             /* Current adpcm sign bit */
-	int delta;            /* Current adpcm output value */
-	int diff;             /* Difference between val and valprev */
-	int step;             /* Stepsize */
-	int valpred;          /* Predicted output value */
-	int vpdiff;           /* Current change to valpred */
-	int index;            /* Current step change index */
-	int outputbuffer = 0; /* place to keep previous 4-bit value */
-	int bufferstep;       /* toggle between outputbuffer/output */
-
-	lpOut = (signed char *)outdata;
-	lpIn = indata;
+// The sample dependent parts of the step computation, indexed by [index][magnitude]
+// and [index][delta]: they save the shifts and the clamping in the inner loops
+static int vpdiffTable[89][8];
+static unsigned char nextIndexTable[89][16];
 
-	valpred = state->valprev;
-	index = state->index;
-	step = stepsizeTable[index];
-
-	bufferstep = 1;
-
-	for(; len > 0; len--)
+static bool ADPCM_fill_tables()
+{
+	for(int i = 0; i < 89; i++)
 	{
-		val = *lpIn++;
-		// Step 1 - compute difference with previous value
-		diff = val - valpred;
-		sign = (diff < 0) ? 8 : 0;
-		if(sign)
-			diff = (-diff);
-		// Step 2 - Divide and clamp
-		// Note:
-		// This code *approximately* computes:
-		//    delta = diff*4/step;
-		//    vpdiff = (delta+0.5)*step/4;
-		// but in shift step bits are dropped. The net result of this is
-		// that even if you have fast mul/div hardware you cannot put it to
-		// good use since the fixup would be too expensive.
-		//
-		delta = 0;
-		vpdiff = (step >> 3);
-		if(diff >= step)
+		int step = stepsizeTable[i];
+		for(int d = 0; d < 8; d++)
 		{
-			delta = 4;
-			diff -= step;
-			vpdiff += step;
+			// (delta+0.5)*step/4 with the shifted step bits dropped, see ADPCM_encode_sample()
+			int vpdiff = step >> 3;
+			if(d & 4)
+				vpdiff += step;
+			if(d & 2)
+				vpdiff += step >> 1;
+			if(d & 1)
+				vpdiff += step >> 2;
+			vpdiffTable[i][d] = vpdiff;
 		}
-		step >>= 1;
-		if(diff >= step)
+		for(int d = 0; d < 16; d++)
 		{
-			delta |= 2;
-			diff -= step;
-			vpdiff += step;
+			int index = i + indexTable[d];
+			if(index < 0)
+				index = 0;
+			if(index > 88)
+				index = 88;
+			nextIndexTable[i][d] = (unsigned char)index;
 		}
-		step >>= 1;
-		if(diff >= step)
-		{
-			delta |= 1;
-			vpdiff += step;
-		}
-		// Step 3 - Update previous value
-		if(sign)
-			valpred -= vpdiff;
-		else
-			valpred += vpdiff;
-		// Step 4 - Clamp previous value to 16 bits
-		if(valpred > 32767)
-			valpred = 32767;
-		else if(valpred < -32768)
-			valpred = -32768;
-		// Step 5 - Assemble value, update index and step values
-		delta |= sign;
-		index += indexTable[delta];
-		if(index < 0)
-			index = 0;
-		if(index > 88)
-			index = 88;
-		step = stepsizeTable[index];
-		// Step 6 - Output value
-		if(bufferstep)
-			outputbuffer = (delta << 4) & 0xf0;
-		else
-			*lpOut++ = (delta & 0x0f) | outputbuffer;
-		bufferstep = !bufferstep;
 	}
-	// Output last step, if needed
-	if(!bufferstep)
-		*lpOut++ = outputbuffer;
-	state->valprev = valpred;
-	state->index = index;
+	return true;
 }
 
-void ADPCM_uncompress(char indata[], short outdata[], int len, ADPCM_state * state)
+static void ADPCM_init_tables()
 {
-	signed char * inp;   /* Input buffer pointer */
-	short * outp;        /* output buffer pointer */
-	int sign;            /* Current adpcm sign bit */
-	int delta;           /* Current adpcm output value */
-	int step;            /* Stepsize */
-	int valpred;         /* Predicted value */
-	int vpdiff;          /* Current change to valpred */
-	int index;           /* Current step change index */
-	int inputbuffer = 0; /* place to keep next 4-bit value */
-	int bufferstep;      /* toggle between inputbuffer/input */
-
-	outp = outdata;
-	inp = (signed char *)indata;
-
-	valpred = state->valprev;
-	index = state->index;
-	step = stepsizeTable[index];
-
-	bufferstep = 0;
+	// A function local static is initialized exactly once, even when
+	// two voice sessions create their codecs at the same time
+	static bool bTablesReady = ADPCM_fill_tables();
+	Q_UNUSED(bTablesReady);
+}
 
-	for(; len > 0; len--)
+static inline int ADPCM_encode_sample(int val, int & valpred, int & index)
+{
+	int step = stepsizeTable[index];
+	// Step 1 - compute difference with previous value
+	int diff = val - valpred;
+	int sign = 0;
+	if(diff < 0)
 	{
-		/* Step 1 - get the delta value */
-		if(bufferstep)
-			delta = inputbuffer & 0xf;
-		else
-		{
-			inputbuffer = *inp++;
-			delta = (inputbuffer >> 4) & 0xf;
-		}
-		bufferstep = !bufferstep;
-
-		/* Step 2 - Find new index value (for later) */
-		index += indexTable[delta];
-		if(index < 0)
-			index = 0;
-		if(index > 88)
-			index = 88;
+		sign = 8;
+		diff = -diff;
+	}
+	// Step 2 - Divide and clamp
+	// Note:
+	// This code *approximately* computes:
+	//    delta = diff*4/step;
+	//    vpdiff = (delta+0.5)*step/4;
+	// but in shift step bits are dropped. The net result of this is
+	// that even if you have fast mul/div hardware you cannot put it to
+	// good use since the fixup would be too expensive.
+	//
+	int delta = 0;
+	if(diff >= step)
+	{
+		delta = 4;
+		diff -= step;
+	}
+	step >>= 1;
+	if(diff >= step)
+	{
+		delta |= 2;
+		diff -= step;
+	}
+	step >>= 1;
+	if(diff >= step)
+		delta |= 1;
+	// Step 3 - Update previous value
+	int vpdiff = vpdiffTable[index][delta];
+	if(sign)
+		valpred -= vpdiff;
+	else
+		valpred += vpdiff;
+	// Step 4 - Clamp previous value to 16 bits
+	if(valpred > 32767)
+		valpred = 32767;
+	else if(valpred < -32768)
+		valpred = -32768;
+	// Step 5 - Assemble value, update index and step values
+	delta |= sign;
+	index = nextIndexTable[index][delta];
+	return delta;
+}
 
-		/* Step 3 - Separate sign and magnitude */
-		sign = delta & 8;
-		delta = delta & 7;
+static inline int ADPCM_decode_sample(int delta, int & valpred, int & index)
+{
+	// Compute difference and new predicted value
+	int vpdiff = vpdiffTable[index][delta & 7];
+	if(delta & 8)
+		valpred -= vpdiff;
+	else
+		valpred += vpdiff;
+	// clamp output value
+	if(valpred > 32767)
+		valpred = 32767;
+	else if(valpred < -32768)
+		valpred = -32768;
+	// Find new index value
+	index = nextIndexTable[index][delta];
+	return valpred;
+}
 
-		/* Step 4 - Compute difference and new predicted value */
-		/*
-		** Computes 'vpdiff = (delta+0.5)*step/4', but see comment
-		** in adpcm_coder.
-		*/
-		vpdiff = step >> 3;
-		if(delta & 4)
-			vpdiff += step;
-		if(delta & 2)
-			vpdiff += step >> 1;
-		if(delta & 1)
-			vpdiff += step >> 2;
+// The samples are 16 bit little endian (as recorded and played by the soundcard),
+// two of them are packed in each output byte: the first one in the high nibble.
+static void ADPCM_compress(const unsigned char * indata, unsigned char * outdata, int len, ADPCM_state * state)
+{
+	int valpred = state->valprev;
+	int index = state->index;
 
-		if(sign)
-			valpred -= vpdiff;
-		else
-			valpred += vpdiff;
+	for(; len > 1; len -= 2)
+	{
+		int hi = ADPCM_encode_sample(qFromLittleEndian<qint16>(indata), valpred, index);
+		int lo = ADPCM_encode_sample(qFromLittleEndian<qint16>(indata + 2), valpred, index);
+		*outdata++ = (unsigned char)((hi << 4) | lo);
+		indata += 4;
+	}
+	// Output last step, if needed
+	if(len > 0)
+		*outdata = (unsigned char)(ADPCM_encode_sample(qFromLittleEndian<qint16>(indata), valpred, index) << 4);
 
-		/* Step 5 - clamp output value */
-		if(valpred > 32767)
-			valpred = 32767;
-		else if(valpred < -32768)
-			valpred = -32768;
+	state->valprev = valpred;
+	state->index = index;
+}
 
-		/* Step 6 - Update step value */
-		step = stepsizeTable[index];
+static void ADPCM_uncompress(const unsigned char * indata, unsigned char * outdata, int len, ADPCM_state * state)
+{
+	int valpred = state->valprev;
+	int index = state->index;
 
-		/* Step 7 - Output value */
-		*outp++ = valpred;
+	for(; len > 1; len -= 2)
+	{
+		int in = *indata++;
+		qToLittleEndian<qint16>(ADPCM_decode_sample(in >> 4, valpred, index), outdata);
+		qToLittleEndian<qint16>(ADPCM_decode_sample(in & 0x0f, valpred, index), outdata + 2);
+		outdata += 4;
 	}
+	if(len > 0)
+		qToLittleEndian<qint16>(ADPCM_decode_sample(*indata >> 4, valpred, index), outdata);
 
 	state->valprev = valpred;
 	state->index = index;
@@ -258,6 +234,7 @@ void ADPCM_uncompress(char indata[], short outdata[], int len, ADPCM_state * sta
 DccVoiceAdpcmCodec::DccVoiceAdpcmCodec()
     : DccVoiceCodec()
 {
+	ADPCM_init_tables();
 	m_pEncodeState = new ADPCM_state;
 	m_pEncodeState->index = 0;
 	m_pEncodeState->valprev = 0;
@@ -273,51 +250,15 @@ DccVoiceAdpcmCodec::~DccVoiceAdpcmCodec()
 	delete m_pDecodeState;
 }
 
-void DccVoiceAdpcmCodec::encode(KviDataBuffer * signal, KviDataBuffer * stream)
+void DccVoiceAdpcmCodec::encodeFrames(const unsigned char * signal, unsigned char * stream, int iFrames)
 {
-	if(signal->size() < ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES)
-		return; // nothing to encode
-
-	char * ptr = (char *)signal->data();
-
-	int uFrames = signal->size() / ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES;
-	int uTotalDataCompressed = uFrames * ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES;
-	int uFrameOffset = stream->size();
-	char * endPtr = ptr + uTotalDataCompressed;
-
-	stream->addSize(ADPCM_PACKED_FRAME_SIZE_IN_BYTES * uFrames);
-
-	while(ptr != endPtr)
-	{
-		ADPCM_compress((short *)ptr, (char *)(stream->data() + uFrameOffset), ADPCM_UNPACKED_FRAME_SIZE_IN_SHORTS, m_pEncodeState);
-		ptr += ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES;
-		uFrameOffset += ADPCM_PACKED_FRAME_SIZE_IN_BYTES;
-	}
-	signal->remove(uTotalDataCompressed);
+	// the state carries over the frames: compress them in a single pass
+	ADPCM_compress(signal, stream, ADPCM_UNPACKED_FRAME_SIZE_IN_SHORTS * iFrames, m_pEncodeState);
 }
 
-void DccVoiceAdpcmCodec::decode(KviDataBuffer * stream, KviDataBuffer * signal)
+void DccVoiceAdpcmCodec::decodeFrames(const unsigned char * stream, unsigned char * signal, int iFrames)
 {
-	if(stream->size() < ADPCM_PACKED_FRAME_SIZE_IN_BYTES)
-		return; // nothing to decode
-
-	char * ptr = (char *)stream->data();
-
-	// Adpcm codec
-	int uFrames = stream->size() / ADPCM_PACKED_FRAME_SIZE_IN_BYTES;
-	int uTotalDataDecompressed = uFrames * ADPCM_PACKED_FRAME_SIZE_IN_BYTES;
-	int uSignalOffset = signal->size();
-	char * endPtr = ptr + (uTotalDataDecompressed);
-
-	signal->addSize(ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES * uFrames);
-
-	while(ptr != endPtr)
-	{
-		ADPCM_uncompress((char *)ptr, (short *)(signal->data() + uSignalOffset), ADPCM_UNPACKED_FRAME_SIZE_IN_SHORTS, m_pDecodeState);
-		ptr += ADPCM_PACKED_FRAME_SIZE_IN_BYTES;
-		uSignalOffset += ADPCM_UNPACKED_FRAME_SIZE_IN_BYTES;
-	}
-	stream->remove(uTotalDataDecompressed);
+	ADPCM_uncompress(stream, signal, ADPCM_UNPACKED_FRAME_SIZE_IN_SHORTS * iFrames, m_pDecodeState);
 }
 
 int DccVoiceAdpcmCodec::encodedFrameSize()
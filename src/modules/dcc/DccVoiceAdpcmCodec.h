@@ -64,8 +64,8 @@ private:
 	ADPCM_state * m_pDecodeState;
 
 public:
-	virtual void encode(KviDataBuffer * signal, KviDataBuffer * stream);
-	virtual void decode(KviDataBuffer * stream, KviDataBuffer * signal);
+	virtual void encodeFrames(const unsigned char * signal, unsigned char * stream, int iFrames);
+	virtual void decodeFrames(const unsigned char * stream, unsigned char * signal, int iFrames);
 	virtual int encodedFrameSize();
 	virtual int decodedFrameSize();
 };
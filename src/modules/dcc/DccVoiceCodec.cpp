@@ -23,11 +23,56 @@
 //=============================================================================
 
 #include "DccVoiceCodec.h"
+#include "KviMemory.h"
 
 #include <QImage>
 #include <QByteArray>
 #include <QBuffer>
 
+DccVoiceBuffer::DccVoiceBuffer(int iCapacity)
+{
+	m_iCapacity = iCapacity;
+	m_pBuffer = (unsigned char *)KviMemory::allocate(m_iCapacity);
+	m_iReadOffset = 0;
+	m_iWriteOffset = 0;
+}
+
+DccVoiceBuffer::~DccVoiceBuffer()
+{
+	KviMemory::free(m_pBuffer);
+}
+
+unsigned char * DccVoiceBuffer::reserve(int iSize)
+{
+	if(m_iWriteOffset + iSize <= m_iCapacity)
+		return m_pBuffer + m_iWriteOffset;
+
+	// out of room at the end: move the pending data back to the beginning
+	int iPending = size();
+	if(m_iReadOffset > 0)
+	{
+		KviMemory::move(m_pBuffer, m_pBuffer + m_iReadOffset, iPending);
+		m_iReadOffset = 0;
+		m_iWriteOffset = iPending;
+	}
+
+	if(iPending + iSize > m_iCapacity)
+	{
+		while(iPending + iSize > m_iCapacity)
+			m_iCapacity *= 2;
+		m_pBuffer = (unsigned char *)KviMemory::reallocate(m_pBuffer, m_iCapacity);
+	}
+
+	return m_pBuffer + m_iWriteOffset;
+}
+
+void DccVoiceBuffer::consume(int iSize)
+{
+	m_iReadOffset += iSize;
+	if(m_iReadOffset >= m_iWriteOffset)
+		clear(); // empty: start again from the beginning for free
+}
+
 DccVoiceCodec::DccVoiceCodec()
 {
 }
@@ -35,11 +80,39 @@ DccVoiceCodec::DccVoiceCodec()
 DccVoiceCodec::~DccVoiceCodec()
     = default;
 
-void DccVoiceCodec::encode(KviDataBuffer *, KviDataBuffer *)
+void DccVoiceCodec::encode(DccVoiceBuffer * signal, DccVoiceBuffer * stream)
 {
+	int iFrameSize = decodedFrameSize();
+	if((iFrameSize < 1) || (signal->size() < iFrameSize))
+		return; // nothing to encode
+
+	int iFrames = signal->size() / iFrameSize;
+	int iEncodedSize = encodedFrameSize() * iFrames;
+
+	encodeFrames(signal->data(), stream->reserve(iEncodedSize), iFrames);
+	stream->commit(iEncodedSize);
+	signal->consume(iFrameSize * iFrames);
 }
 
-void DccVoiceCodec::decode(KviDataBuffer *, KviDataBuffer *)
+void DccVoiceCodec::decode(DccVoiceBuffer * stream, DccVoiceBuffer * signal)
+{
+	int iFrameSize = encodedFrameSize();
+	if((iFrameSize < 1) || (stream->size() < iFrameSize))
+		return; // nothing to decode
+
+	int iFrames = stream->size() / iFrameSize;
+	int iDecodedSize = decodedFrameSize() * iFrames;
+
+	decodeFrames(stream->data(), signal->reserve(iDecodedSize), iFrames);
+	signal->commit(iDecodedSize);
+	stream->consume(iFrameSize * iFrames);
+}
+
+void DccVoiceCodec::encodeFrames(const unsigned char *, unsigned char *, int)
+{
+}
+
+void DccVoiceCodec::decodeFrames(const unsigned char *, unsigned char *, int)
 {
 }
 
@@ -67,21 +140,22 @@ DccVoiceNullCodec::DccVoiceNullCodec()
 DccVoiceNullCodec::~DccVoiceNullCodec()
     = default;
 
-void DccVoiceNullCodec::encode(KviDataBuffer * signal, KviDataBuffer * stream)
+void DccVoiceNullCodec::encode(DccVoiceBuffer * signal, DccVoiceBuffer * stream)
 {
 	if(signal->size() < 1)
 		return;
-	stream->append(signal->data(), signal->size());
-	signal->resize(0);
+	KviMemory::copy(stream->reserve(signal->size()), signal->data(), signal->size());
+	stream->commit(signal->size());
+	signal->clear();
 }
 
-void DccVoiceNullCodec::decode(KviDataBuffer * stream, KviDataBuffer * signal)
+void DccVoiceNullCodec::decode(DccVoiceBuffer * stream, DccVoiceBuffer * signal)
 {
 	if(stream->size() < 1)
 		return;
-	signal->append(stream->data(), stream->size());
-
-	stream->resize(0);
+	KviMemory::copy(signal->reserve(stream->size()), stream->data(), stream->size());
+	signal->commit(stream->size());
+	stream->clear();
 }
 
 int DccVoiceNullCodec::encodedFrameSize()
@@ -32,6 +32,34 @@
 #include "KviOggTheoraEncoder.h"
 #endif
 
+//
+// A preallocated FIFO for the voice data: the data is consumed by moving
+// the read offset and it is moved back to the beginning only when the
+// buffer runs out of room at the end. Unlike a real ring buffer the
+// pending data is always contiguous, as the codecs and the soundcard want it.
+//
+class DccVoiceBuffer
+{
+public:
+	DccVoiceBuffer(int iCapacity = 32768);
+	~DccVoiceBuffer();
+
+protected:
+	unsigned char * m_pBuffer;
+	int m_iCapacity;
+	int m_iReadOffset;
+	int m_iWriteOffset;
+
+public:
+	unsigned char * data() const { return m_pBuffer + m_iReadOffset; };
+	int size() const { return m_iWriteOffset - m_iReadOffset; };
+	// returns the room for iSize more bytes: fill it and then commit() what was actually written
+	unsigned char * reserve(int iSize);
+	void commit(int iSize) { m_iWriteOffset += iSize; };
+	void consume(int iSize);
+	void clear() { m_iReadOffset = m_iWriteOffset = 0; };
+};
+
 class DccVoiceCodec
 {
 public:
@@ -43,8 +71,12 @@ protected:
 
 public:
 	const char * name();
-	virtual void encode(KviDataBuffer * signal, KviDataBuffer * stream);
-	virtual void decode(KviDataBuffer * stream, KviDataBuffer * signal);
+	// converts all the whole frames available in the source buffer
+	virtual void encode(DccVoiceBuffer * signal, DccVoiceBuffer * stream);
+	virtual void decode(DccVoiceBuffer * stream, DccVoiceBuffer * signal);
+	// the batched interface of the frame based codecs: the destination has room for iFrames frames
+	virtual void encodeFrames(const unsigned char * signal, unsigned char * stream, int iFrames);
+	virtual void decodeFrames(const unsigned char * stream, unsigned char * signal, int iFrames);
 	virtual int encodedFrameSize();
 	virtual int decodedFrameSize();
 };
@@ -56,8 +88,8 @@ public:
 	virtual ~DccVoiceNullCodec();
 
 public:
-	virtual void encode(KviDataBuffer * signal, KviDataBuffer * stream);
-	virtual void decode(KviDataBuffer * stream, KviDataBuffer * signal);
+	virtual void encode(DccVoiceBuffer * signal, DccVoiceBuffer * stream);
+	virtual void decode(DccVoiceBuffer * stream, DccVoiceBuffer * signal);
 	virtual int encodedFrameSize();
 	virtual int decodedFrameSize();
 };
@@ -27,6 +27,8 @@
 #include "DccVoiceGsmCodec.h"
 
 #ifdef COMPILE_USE_GSM
+#include <QtEndian>
+
 #include <dlfcn.h>
 
 #define GSM_PACKED_FRAME_SIZE_IN_BYTES 33
@@ -86,56 +88,43 @@ DccVoiceGsmCodec::~DccVoiceGsmCodec()
 	gsm_session_destroy(m_pDecodeState);
 }
 
-void DccVoiceGsmCodec::encode(KviDataBuffer * signal, KviDataBuffer * stream)
+void DccVoiceGsmCodec::encodeFrames(const unsigned char * signal, unsigned char * stream, int iFrames)
 {
-	if(signal->size() < GSM_UNPACKED_FRAME_SIZE_IN_BYTES)
-		return; // nothing to encode
-
-	unsigned char * ptr = signal->data();
-
-	int uFrames = signal->size() / GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
-	int uTotalDataCompressed = uFrames * GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
-	int uFrameOffset = stream->size();
-	unsigned char * endPtr = ptr + uTotalDataCompressed;
-
-	stream->addSize(GSM_PACKED_FRAME_SIZE_IN_BYTES * uFrames);
-
-	while(ptr != endPtr)
+	// libgsm wants native shorts while the soundcard works in little endian
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+	short frame[GSM_UNPACKED_FRAME_SIZE_IN_SHORTS];
+#endif
+	for(int i = 0; i < iFrames; i++)
 	{
-		gsm_session_encode(m_pEncodeState, (short *)ptr, stream->data() + uFrameOffset);
-		ptr += GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
-		uFrameOffset += GSM_PACKED_FRAME_SIZE_IN_BYTES;
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+		for(int j = 0; j < GSM_UNPACKED_FRAME_SIZE_IN_SHORTS; j++)
+			frame[j] = qFromLittleEndian<qint16>(signal + (j * 2));
+		gsm_session_encode(m_pEncodeState, frame, stream);
+#else
+		gsm_session_encode(m_pEncodeState, (short *)signal, stream);
+#endif
+		signal += GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
+		stream += GSM_PACKED_FRAME_SIZE_IN_BYTES;
 	}
-	signal->remove(uTotalDataCompressed);
 }
 
-void DccVoiceGsmCodec::decode(KviDataBuffer * stream, KviDataBuffer * signal)
+void DccVoiceGsmCodec::decodeFrames(const unsigned char * stream, unsigned char * signal, int iFrames)
 {
-	if(stream->size() < GSM_PACKED_FRAME_SIZE_IN_BYTES)
-		return; // nothing to decode
-
-	unsigned char * ptr = stream->data();
-
-	// Gsm codec
-	int uFrames = stream->size() / GSM_PACKED_FRAME_SIZE_IN_BYTES;
-	int uTotalDataDecompressed = uFrames * GSM_PACKED_FRAME_SIZE_IN_BYTES;
-	int uSignalOffset = signal->size();
-	unsigned char * endPtr = ptr + (uTotalDataDecompressed);
-
-	signal->addSize(GSM_UNPACKED_FRAME_SIZE_IN_BYTES * uFrames);
-
-	while(ptr != endPtr)
+	for(int i = 0; i < iFrames; i++)
 	{
 		// We don't check the return value here
 		// Well..it is either an unrecoverable internal error
 		// or a broken frame...
 		// but if we receive broken frames over DCC...well....better
 		// check the hardware...or the remote codec as well...
-		gsm_session_decode(m_pDecodeState, ptr, (short *)(signal->data() + uSignalOffset));
-		ptr += GSM_PACKED_FRAME_SIZE_IN_BYTES;
-		uSignalOffset += GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
+		gsm_session_decode(m_pDecodeState, (unsigned char *)stream, (short *)signal);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+		for(int j = 0; j < GSM_UNPACKED_FRAME_SIZE_IN_SHORTS; j++)
+			qToLittleEndian<qint16>(((short *)signal)[j], signal + (j * 2));
+#endif
+		stream += GSM_PACKED_FRAME_SIZE_IN_BYTES;
+		signal += GSM_UNPACKED_FRAME_SIZE_IN_BYTES;
 	}
-	stream->remove(uTotalDataDecompressed);
 }
 
 int DccVoiceGsmCodec::encodedFrameSize()
@@ -46,8 +46,8 @@ private:
 	void * m_pDecodeState;
 
 public:
-	virtual void encode(KviDataBuffer * signal, KviDataBuffer * stream);
-	virtual void decode(KviDataBuffer * stream, KviDataBuffer * signal);
+	virtual void encodeFrames(const unsigned char * signal, unsigned char * stream, int iFrames);
+	virtual void decodeFrames(const unsigned char * stream, unsigned char * signal, int iFrames);
 	virtual int encodedFrameSize();
 	virtual int decodedFrameSize();
 };
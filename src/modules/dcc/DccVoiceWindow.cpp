@@ -86,6 +86,9 @@ extern DccBroker * g_pDccBroker;
 #define KVI_FORMAT AFMT_S16_LE
 #define KVI_NUM_CHANNELS 1
 
+// Size of the socket reads: the frames are decoded in batches
+#define KVI_VOICE_READ_SIZE 4096
+
 bool kvi_dcc_voice_is_valid_codec(const char * codecName)
 {
 #ifdef COMPILE_USE_GSM
@@ -320,13 +323,10 @@ bool DccVoiceThread::readWriteStep()
 	{
 		if(bCanRead)
 		{
-			unsigned int actualSize = m_inFrameBuffer.size();
-			m_inFrameBuffer.resize(actualSize + 1024);
-			int readLen = kvi_socket_recv(m_fd, (void *)(m_inFrameBuffer.data() + actualSize), 1024);
+			int readLen = kvi_socket_recv(m_fd, (void *)m_inFrameBuffer.reserve(KVI_VOICE_READ_SIZE), KVI_VOICE_READ_SIZE);
 			if(readLen > 0)
 			{
-				if(readLen < 1024)
-					m_inFrameBuffer.resize(actualSize + readLen);
+				m_inFrameBuffer.commit(readLen);
 				m_pOpt->pCodec->decode(&m_inFrameBuffer, &m_inSignalBuffer);
 				//#warning "A maximum length for the signal buffer is actually needed!!!"
 			}
@@ -334,7 +334,6 @@ bool DccVoiceThread::readWriteStep()
 			{
 				if(!handleInvalidSocketRead(readLen))
 					return false;
-				m_inFrameBuffer.resize(actualSize);
 			}
 		} // else {
 		//	m_uSleepTime += 100;
@@ -348,7 +347,7 @@ bool DccVoiceThread::readWriteStep()
 				int written = kvi_socket_send(m_fd, m_outFrameBuffer.data(), m_outFrameBuffer.size());
 				if(written > 0)
 				{
-					m_outFrameBuffer.remove(written);
+					m_outFrameBuffer.consume(written);
 				}
 				else
 				{
@@ -403,7 +402,7 @@ bool DccVoiceThread::soundStep()
 					toWrite = m_inSignalBuffer.size();
 				int written = write(m_soundFd, m_inSignalBuffer.data(), toWrite);
 				if(written > 0)
-					m_inSignalBuffer.remove(written);
+					m_inSignalBuffer.consume(written);
 				else
 				{
 					//#warning "Do something for -1 here ?"
@@ -508,29 +507,14 @@ bool DccVoiceThread::soundStep()
 
 			if(info.fragments > 0)
 			{
-				int oldSize = m_outSignalBuffer.size();
 				int available = info.fragments * info.fragsize;
-				m_outSignalBuffer.addSize(available);
-				int readed = read(m_soundFd, m_outSignalBuffer.data() + oldSize, available);
+				int readed = read(m_soundFd, m_outSignalBuffer.reserve(available), available);
 
-				if(readed < available)
-				{
-					// huh ? ...error ?
-					if(readed >= 0)
-						m_outSignalBuffer.resize(oldSize + readed);
-					else
-					{
-						if((errno == EINTR) || (errno == EAGAIN))
-						{
-							m_outSignalBuffer.resize(oldSize);
-						}
-						else
-						{
-							//#warning "Critical error...do something reasonable!"
-							m_outSignalBuffer.resize(oldSize);
-						}
-					}
-				}
+				// huh ? ...error ?
+				// EINTR and EAGAIN are harmless here
+				//#warning "Critical error...do something reasonable!"
+				if(readed > 0)
+					m_outSignalBuffer.commit(readed);
 				/*
 				qDebug("Signal buffer:");
 				for(int i=0;i<200;i+=2)
@@ -73,10 +73,10 @@ protected:
 	KviDccVoiceThreadOptions * m_pOpt;
 	int m_soundFd;
 	int m_soundFdMode;
-	KviDataBuffer m_outFrameBuffer;
-	KviDataBuffer m_inFrameBuffer;
-	KviDataBuffer m_inSignalBuffer;
-	KviDataBuffer m_outSignalBuffer;
+	DccVoiceBuffer m_outFrameBuffer;
+	DccVoiceBuffer m_inFrameBuffer;
+	DccVoiceBuffer m_inSignalBuffer;
+	DccVoiceBuffer m_outSignalBuffer;
 	bool m_bPlaying;
 	bool m_bRecording;
 	bool m_bRecordingRequestPending;
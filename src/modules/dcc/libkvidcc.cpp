@@ -1679,9 +1679,10 @@ static bool dcc_kvs_cmd_abort(KviKvsModuleCommandCall * c)
 	@short:
 		Set the bandwidthlimit of a dcc.send session.
 	@syntax:
-		dcc.setBandwidthLimit [-q] [dcc_id:uint]
+		dcc.setBandwidthLimit [-q] <limit_value:uint> [dcc_id:uint]
 	@description:
-		Terminates the DCC specified by <dcc_id>.[br]
+		Sets the bandwidth limit of the DCC specified by <dcc_id> to <limit_value> bytes per second.[br]
+		The new limit applies immediately, also to a running transfer.[br]
 		If <dcc_id> is omitted then the DCC Session associated
 		with the current window is assumed.[br]
 		If <dcc_id> is not a valid DCC session identifier (or it is omitted
@@ -1690,6 +1691,8 @@ static bool dcc_kvs_cmd_abort(KviKvsModuleCommandCall * c)
 		If <dcc_id> does not refers to a file transfer a warning will be printing unless the -q switch is used.[br]
 		See the [module:dcc]dcc module[/module] documentation for more information.[br]
 	@examples:
+	@seealso:
+		[cmd]dcc.setGlobalBandwidthLimit[/cmd], [cmd]dcc.setNickBandwidthLimit[/cmd]
 */
 static bool dcc_kvs_cmd_setBandwidthLimit(KviKvsModuleCommandCall * c)
 {
@@ -1710,6 +1713,119 @@ static bool dcc_kvs_cmd_setBandwidthLimit(KviKvsModuleCommandCall * c)
 	return true;
 }
 
+static void dcc_kvs_get_bandwidth_directions(KviKvsModuleCommandCall * c, bool & bUpload, bool & bDownload)
+{
+	bUpload = c->switches()->find('u', "upload");
+	bDownload = c->switches()->find('d', "download");
+	if(!(bUpload || bDownload))
+	{
+		bUpload = true;
+		bDownload = true;
+	}
+}
+
+/*
+	@doc: dcc.setGlobalBandwidthLimit
+	@type:
+		command
+	@title:
+		dcc.setGlobalBandwidthLimit
+	@short:
+		Sets the total bandwidth limit of the DCC file transfers
+	@syntax:
+		dcc.setGlobalBandwidthLimit [-u] [-d] <limit_value:uint>
+	@switches:
+		!sw: -u | --upload
+		Set the limit for the uploads
+		!sw: -d | --download
+		Set the limit for the downloads
+	@description:
+		Limits the sum of the bandwidth used by all the DCC file transfers to
+		<limit_value> bytes per second.[br]
+		This limit is shared by all the transfers, on top of their own limits
+		(see [cmd]dcc.setBandwidthLimit[/cmd]) and the limits of the remote nicknames
+		(see [cmd]dcc.setNickBandwidthLimit[/cmd]).[br]
+		If neither -u nor -d is specified then both the limits are set.[br]
+		A <limit_value> of 0 removes the limit.[br]
+		The new limit applies immediately, also to the running transfers.[br]
+	@examples:
+		[example]
+			[comment]# Don't use more than 64 KiB/s of our uplink for DCC[/comment]
+			dcc.setGlobalBandwidthLimit -u 65536
+		[/example]
+	@seealso:
+		[cmd]dcc.setBandwidthLimit[/cmd], [cmd]dcc.setNickBandwidthLimit[/cmd]
+*/
+static bool dcc_kvs_cmd_setGlobalBandwidthLimit(KviKvsModuleCommandCall * c)
+{
+	kvs_uint_t uVal;
+	KVSM_PARAMETERS_BEGIN(c)
+	KVSM_PARAMETER("limit_value", KVS_PT_UINT, 0, uVal)
+	KVSM_PARAMETERS_END(c)
+
+	if((uVal == 0) || (uVal > MAX_DCC_BANDWIDTH_LIMIT))
+		uVal = MAX_DCC_BANDWIDTH_LIMIT;
+
+	bool bUpload, bDownload;
+	dcc_kvs_get_bandwidth_directions(c, bUpload, bDownload);
+
+	if(bUpload)
+		DccBandwidthShaper::instance()->setGlobalLimit(DccBandwidthLimiter::Upload, uVal);
+	if(bDownload)
+		DccBandwidthShaper::instance()->setGlobalLimit(DccBandwidthLimiter::Download, uVal);
+	return true;
+}
+
+/*
+	@doc: dcc.setNickBandwidthLimit
+	@type:
+		command
+	@title:
+		dcc.setNickBandwidthLimit
+	@short:
+		Sets the bandwidth limit of the DCC file transfers with a nickname
+	@syntax:
+		dcc.setNickBandwidthLimit [-u] [-d] <nickname:string> <limit_value:uint>
+	@switches:
+		!sw: -u | --upload
+		Set the limit for the uploads to <nickname>
+		!sw: -d | --download
+		Set the limit for the downloads from <nickname>
+	@description:
+		Limits the sum of the bandwidth used by all the DCC file transfers with
+		<nickname> to <limit_value> bytes per second.[br]
+		If neither -u nor -d is specified then both the limits are set.[br]
+		A <limit_value> of 0 removes the limit.[br]
+		The new limit applies immediately, also to the running transfers.[br]
+	@examples:
+		[example]
+			dcc.setNickBandwidthLimit -u Pragma 10240
+		[/example]
+	@seealso:
+		[cmd]dcc.setBandwidthLimit[/cmd], [cmd]dcc.setGlobalBandwidthLimit[/cmd]
+*/
+static bool dcc_kvs_cmd_setNickBandwidthLimit(KviKvsModuleCommandCall * c)
+{
+	QString szNick;
+	kvs_uint_t uVal;
+	KVSM_PARAMETERS_BEGIN(c)
+	KVSM_PARAMETER("nickname", KVS_PT_NONEMPTYSTRING, 0, szNick)
+	KVSM_PARAMETER("limit_value", KVS_PT_UINT, 0, uVal)
+	KVSM_PARAMETERS_END(c)
+
+	if((uVal == 0) || (uVal > MAX_DCC_BANDWIDTH_LIMIT))
+		uVal = MAX_DCC_BANDWIDTH_LIMIT;
+
+	bool bUpload, bDownload;
+	dcc_kvs_get_bandwidth_directions(c, bUpload, bDownload);
+
+	if(bUpload)
+		DccBandwidthShaper::instance()->setNickLimit(DccBandwidthLimiter::Upload, szNick, uVal);
+	if(bDownload)
+		DccBandwidthShaper::instance()->setNickLimit(DccBandwidthLimiter::Download, szNick, uVal);
+	return true;
+}
+
 /*
 	@doc: dcc.protocol
 	@type:
@@ -2953,6 +3069,8 @@ static bool dcc_module_init(KviModule * m)
 	KVSM_REGISTER_SIMPLE_COMMAND(m, "get", dcc_kvs_cmd_get);
 	KVSM_REGISTER_SIMPLE_COMMAND(m, "abort", dcc_kvs_cmd_abort);
 	KVSM_REGISTER_SIMPLE_COMMAND(m, "setBandwidthLimit", dcc_kvs_cmd_setBandwidthLimit);
+	KVSM_REGISTER_SIMPLE_COMMAND(m, "setGlobalBandwidthLimit", dcc_kvs_cmd_setGlobalBandwidthLimit);
+	KVSM_REGISTER_SIMPLE_COMMAND(m, "setNickBandwidthLimit", dcc_kvs_cmd_setNickBandwidthLimit);
 
 	// FIXME: file upload / download state ?
 
@@ -34,6 +34,7 @@
 #include "DccVoiceWindow.h"
 #include "DccUtils.h"
 #include "DccFileTransfer.h"
+#include "DccExtensions.h"
 
 #include "kvi_debug.h"
 #include "kvi_settings.h"
@@ -1175,6 +1176,110 @@ static void dccModuleParseDccList(KviDccRequest *)
 	// FIXME!
 }
 
+static void dccModuleParseDccDigest(KviDccRequest * dcc)
+{
+	// This is a KVIrc extension used to verify the integrity of the file transfers
+	// The receiver asks for the digest of the file being sent with
+	//      DCC DIGEST <filename>
+	// and the sender eventually replies with
+	//      DCC DIGEST <filename> <algorithm> <hexdigest>
+	QString szFileName = dcc->pConsole->decodeText(dcc->szParam1);
+	QString szNick = dcc->ctcpMsg->pSource->nick();
+
+	if(dcc->szParam2.isEmpty())
+	{
+		if(!DccFileTransfer::handleDigestRequest(szNick, szFileName))
+		{
+			if(!dcc->ctcpMsg->msg->haltOutput())
+			{
+				QString szError = QString(__tr2qs_ctx("Can't compute the checksum of file %1: no such transfer in progress", "dcc")).arg(szFileName);
+				dcc_module_request_error(dcc, szError);
+			}
+		}
+		return;
+	}
+
+	if(dcc_parse_digest(dcc->szParam2, dcc->szParam3) == DccDigestMessage::Malformed)
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Invalid checksum argument '%1 %2'", "dcc")).arg(dcc->szParam2.ptr(), dcc->szParam3.ptr());
+			dcc_module_request_error(dcc, szError);
+		}
+		return;
+	}
+
+	if(!DccFileTransfer::handleDigest(szNick, szFileName, QString(dcc->szParam2.ptr()), QString(dcc->szParam3.ptr())))
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Received the checksum of file %1 but no such transfer is in progress", "dcc")).arg(szFileName);
+			dcc_module_request_error(dcc, szError);
+		}
+	}
+}
+
+static void dccModuleParseDccSegments(KviDccRequest * dcc)
+{
+	// This is a KVIrc extension used to receive large files on parallel streams
+	// The receiver asks the sender to split the file being sent with
+	//      DCC SEGMENTS <filename> <port> <count>
+	// and the sender offers each part on a new connection with
+	//      DCC SEGMENT <filename> <ipaddr> <port> <start> <end>
+	QString szFileName = dcc->pConsole->decodeText(dcc->szParam1);
+	QString szNick = dcc->ctcpMsg->pSource->nick();
+
+	unsigned int uCount;
+	if(!dcc_parse_segments_count(dcc->szParam3, uCount))
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Invalid stream count argument '%1'", "dcc")).arg(dcc->szParam3.ptr());
+			dcc_module_request_error(dcc, szError);
+		}
+		return;
+	}
+
+	if(!DccFileTransfer::handleSegmentsRequest(szNick, szFileName, QString(dcc->szParam2.ptr()), uCount))
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Can't split file %1: no such transfer in progress on port %2", "dcc")).arg(szFileName, dcc->szParam2.ptr());
+			dcc_module_request_error(dcc, szError);
+		}
+	}
+}
+
+static void dccModuleParseDccSegment(KviDccRequest * dcc)
+{
+	// DCC SEGMENT <filename> <ipaddr> <port> <start> <end>
+	if(!dcc_module_normalize_target_data(dcc, dcc->szParam2, dcc->szParam3))
+		return;
+
+	quint64 uStart, uEnd;
+	if(!dcc_parse_segment_range(dcc->szParam4, dcc->szParam5, uStart, uEnd))
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Invalid file range argument '%1 %2'", "dcc")).arg(dcc->szParam4.ptr(), dcc->szParam5.ptr());
+			dcc_module_request_error(dcc, szError);
+		}
+		return;
+	}
+
+	QString szFileName = dcc->pConsole->decodeText(dcc->szParam1);
+	QString szNick = dcc->ctcpMsg->pSource->nick();
+
+	if(!DccFileTransfer::handleSegmentOffer(szNick, szFileName, QString(dcc->szParam2.ptr()), QString(dcc->szParam3.ptr()), uStart, uEnd))
+	{
+		if(!dcc->ctcpMsg->msg->haltOutput())
+		{
+			QString szError = QString(__tr2qs_ctx("Received a part of file %1 but no such transfer is in progress", "dcc")).arg(szFileName);
+			dcc_module_request_error(dcc, szError);
+		}
+	}
+}
+
 typedef void (*dccParseProc)(KviDccRequest *);
 typedef struct _dccParseProcEntry
 {
@@ -1182,7 +1287,7 @@ typedef struct _dccParseProcEntry
 	dccParseProc proc;
 } dccParseProcEntry;
 
-#define KVI_NUM_KNOWN_DCC_TYPES 28
+#define KVI_NUM_KNOWN_DCC_TYPES 31
 
 static dccParseProcEntry dccParseProcTable[KVI_NUM_KNOWN_DCC_TYPES] = {
 	// clang-format off
@@ -1201,6 +1306,9 @@ static dccParseProcEntry dccParseProcTable[KVI_NUM_KNOWN_DCC_TYPES] = {
 	{ "LIST"   , dccModuleParseDccList   },
 	{ "ACCEPT" , dccModuleParseDccAccept },
 	{ "RESUME" , dccModuleParseDccResume },
+	{ "DIGEST" , dccModuleParseDccDigest },
+	{ "SEGMENTS", dccModuleParseDccSegments },
+	{ "SEGMENT", dccModuleParseDccSegment },
 	{ "RECV"   , dccModuleParseDccRecv   },
 	{ "SRECV"  , dccModuleParseDccRecv   },
 	{ "TRECV"  , dccModuleParseDccRecv   },
@@ -158,8 +158,10 @@ void EventEditor::oneTimeSetup()
 			{
 				if(s->type() == KviKvsEventHandler::Script)
 				{
-					new EventEditorHandlerTreeWidgetItem(it, ((KviKvsScriptEventHandler *)s)->name(),
+					EventEditorHandlerTreeWidgetItem * ch = new EventEditorHandlerTreeWidgetItem(it, ((KviKvsScriptEventHandler *)s)->name(),
 					    ((KviKvsScriptEventHandler *)s)->code(), ((KviKvsScriptEventHandler *)s)->isEnabled());
+					if(((KviKvsScriptEventHandler *)s)->filter())
+						ch->m_filter = *(((KviKvsScriptEventHandler *)s)->filter());
 				}
 			}
 		}
@@ -379,6 +381,7 @@ void EventEditor::commit()
 				    szContext,
 				    ((EventEditorHandlerTreeWidgetItem *)ch)->m_szBuffer,
 				    ((EventEditorHandlerTreeWidgetItem *)ch)->m_bEnabled);
+				s->setFilter(new KviKvsEventHandlerFilter(((EventEditorHandlerTreeWidgetItem *)ch)->m_filter));
 
 				KviKvsEventManager::instance()->addAppHandler(((EventEditorEventTreeWidgetItem *)it)->m_uEventIdx, s);
 			}
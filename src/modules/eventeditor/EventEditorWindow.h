@@ -26,6 +26,7 @@
 
 #include "KviWindow.h"
 #include "KviCString.h"
+#include "KviKvsEventHandler.h"
 
 #include <QWidget>
 #include <QLineEdit>
@@ -58,6 +59,7 @@ public:
 	QString m_szBuffer;
 	bool m_bEnabled;
 	int m_cPos;
+	KviKvsEventHandlerFilter m_filter; // not editable here, but preserved on commit
 
 public:
 	EventEditorHandlerTreeWidgetItem(QTreeWidgetItem * par, const QString & name, const QString & buffer, bool bEnabled);
@@ -0,0 +1,263 @@
+//=============================================================================
+//
+//   File : ProfilerWindow.cpp
+//   Creation date : Sun 18 Oct 2026 15:02:44 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "ProfilerWindow.h"
+
+#include "KviFileDialog.h"
+#include "KviIconManager.h"
+#include "KviKvsProfiler.h"
+#include "KviLocale.h"
+#include "KviModule.h"
+#include "KviTalHBox.h"
+#include "KviTalSplitter.h"
+#include "KviTalVBox.h"
+#include "KviThemedTreeWidget.h"
+
+#include <QCheckBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+
+extern ProfilerWindow * g_pProfilerWindow;
+extern KviModule * g_pKvsModule;
+
+// the time columns are shown in milliseconds
+static QString profiler_format_time(qint64 iNanoSeconds)
+{
+	return QString::number((double)iNanoSeconds / 1000000.0, 'f', 3);
+}
+
+ProfilerTreeWidgetItem::ProfilerTreeWidgetItem(QTreeWidget * pParent, KviKvsProfilerEntry * e)
+    : QTreeWidgetItem(pParent)
+{
+	m_iValues[0] = 0;
+	m_iValues[1] = e->m_uCalls;
+	m_iValues[2] = e->m_iTotalTime;
+	m_iValues[3] = e->m_iSelfTime;
+	m_iValues[4] = e->m_iMaxTime;
+	m_iValues[5] = e->m_uCalls ? e->m_iTotalTime / e->m_uCalls : 0;
+
+	setText(0, e->m_szName);
+	setText(1, QString::number(e->m_uCalls));
+	for(int i = 2; i < 6; i++)
+	{
+		setText(i, profiler_format_time(m_iValues[i]));
+		setTextAlignment(i, Qt::AlignRight | Qt::AlignVCenter);
+	}
+	setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+}
+
+bool ProfilerTreeWidgetItem::operator<(const QTreeWidgetItem & other) const
+{
+	int iColumn = treeWidget() ? treeWidget()->sortColumn() : 0;
+	if((iColumn < 1) || (iColumn > 5))
+		return QTreeWidgetItem::operator<(other);
+	return m_iValues[iColumn] < ((const ProfilerTreeWidgetItem &)other).m_iValues[iColumn];
+}
+
+ProfilerWindow::ProfilerWindow()
+    : KviWindow(KviWindow::Tool, "kvs profiler window", nullptr)
+{
+	g_pProfilerWindow = this;
+
+	m_pSplitter = new KviTalSplitter(Qt::Horizontal, this);
+	m_pSplitter->setObjectName("kvsprofiler_splitter");
+
+	KviTalVBox * vbox = new KviTalVBox(m_pSplitter);
+
+	KviTalHBox * b = new KviTalHBox(vbox);
+	m_pStatusLabel = new QLabel(b);
+	b->setStretchFactor(m_pStatusLabel, 1);
+	m_pInstructionTimingCheck = new QCheckBox(__tr2qs_ctx("Time &instructions", "kvs"), b);
+	m_pInstructionTimingCheck->setToolTip(__tr2qs_ctx("Time also the single instructions of the scripts.<br>This is considerably slower.", "kvs"));
+	m_pInstructionTimingCheck->setChecked(KviKvsProfiler::nodeTimingEnabled());
+	connect(m_pInstructionTimingCheck, SIGNAL(toggled(bool)), this, SLOT(instructionTimingToggled(bool)));
+	m_pStartStopButton = new QPushButton(b);
+	connect(m_pStartStopButton, SIGNAL(clicked()), this, SLOT(startStopClicked()));
+	QPushButton * pButton = new QPushButton(__tr2qs_ctx("&Refresh", "kvs"), b);
+	connect(pButton, SIGNAL(clicked()), this, SLOT(refresh()));
+	pButton = new QPushButton(__tr2qs_ctx("&Clear", "kvs"), b);
+	connect(pButton, SIGNAL(clicked()), this, SLOT(clearClicked()));
+	pButton = new QPushButton(__tr2qs_ctx("&Export Flame Graph Stacks...", "kvs"), b);
+	connect(pButton, SIGNAL(clicked()), this, SLOT(exportClicked()));
+
+	QStringList columnLabels;
+	columnLabels.append(__tr2qs_ctx("Script", "kvs"));
+	columnLabels.append(__tr2qs_ctx("Calls", "kvs"));
+	columnLabels.append(__tr2qs_ctx("Total (ms)", "kvs"));
+	columnLabels.append(__tr2qs_ctx("Self (ms)", "kvs"));
+	columnLabels.append(__tr2qs_ctx("Max (ms)", "kvs"));
+	columnLabels.append(__tr2qs_ctx("Average (ms)", "kvs"));
+
+	KviTalSplitter * pVertical = new KviTalSplitter(Qt::Vertical, vbox);
+	vbox->setStretchFactor(pVertical, 1);
+
+	m_pScriptTreeWidget = new KviThemedTreeWidget(pVertical, this, "kvsprofiler_scripts_treewidget");
+	m_pScriptTreeWidget->setAllColumnsShowFocus(true);
+	m_pScriptTreeWidget->setRootIsDecorated(false);
+	m_pScriptTreeWidget->setHeaderLabels(columnLabels);
+	m_pScriptTreeWidget->setColumnWidth(0, 300);
+	m_pScriptTreeWidget->setSortingEnabled(true);
+	m_pScriptTreeWidget->sortByColumn(3, Qt::DescendingOrder);
+
+	columnLabels[0] = __tr2qs_ctx("Instruction", "kvs");
+	m_pNodeTreeWidget = new KviThemedTreeWidget(pVertical, this, "kvsprofiler_nodes_treewidget");
+	m_pNodeTreeWidget->setAllColumnsShowFocus(true);
+	m_pNodeTreeWidget->setRootIsDecorated(false);
+	m_pNodeTreeWidget->setHeaderLabels(columnLabels);
+	m_pNodeTreeWidget->setColumnWidth(0, 300);
+	m_pNodeTreeWidget->setSortingEnabled(true);
+	m_pNodeTreeWidget->sortByColumn(2, Qt::DescendingOrder);
+
+	refresh();
+}
+
+ProfilerWindow::~ProfilerWindow()
+{
+	g_pProfilerWindow = nullptr;
+}
+
+void ProfilerWindow::refresh()
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return;
+
+	m_pStartStopButton->setText(KviKvsProfiler::isEnabled() ? __tr2qs_ctx("&Stop", "kvs") : __tr2qs_ctx("&Start", "kvs"));
+	// the profiler might have been started by /kvs.profile: show how it runs
+	if(KviKvsProfiler::isEnabled())
+	{
+		m_pInstructionTimingCheck->blockSignals(true);
+		m_pInstructionTimingCheck->setChecked(KviKvsProfiler::nodeTimingEnabled());
+		m_pInstructionTimingCheck->blockSignals(false);
+	}
+	m_pStatusLabel->setText(
+	    QString(__tr2qs_ctx("Profiler %1, %2 ms profiled", "kvs"))
+	        .arg(KviKvsProfiler::isEnabled() ? __tr2qs_ctx("running", "kvs") : __tr2qs_ctx("stopped", "kvs"))
+	        .arg(p->profiledTime() / 1000000));
+
+	m_pScriptTreeWidget->setUpdatesEnabled(false);
+	m_pScriptTreeWidget->clear();
+	KviPointerHashTableIterator<QString, KviKvsProfilerEntry> it(*(p->scriptEntries()));
+	while(KviKvsProfilerEntry * e = it.current())
+	{
+		new ProfilerTreeWidgetItem(m_pScriptTreeWidget, e);
+		++it;
+	}
+	m_pScriptTreeWidget->setUpdatesEnabled(true);
+
+	m_pNodeTreeWidget->setUpdatesEnabled(false);
+	m_pNodeTreeWidget->clear();
+	KviPointerHashTableIterator<QString, KviKvsProfilerEntry> it2(*(p->nodeEntries()));
+	while(KviKvsProfilerEntry * e = it2.current())
+	{
+		new ProfilerTreeWidgetItem(m_pNodeTreeWidget, e);
+		++it2;
+	}
+	m_pNodeTreeWidget->setUpdatesEnabled(true);
+	m_pNodeTreeWidget->setVisible(m_pNodeTreeWidget->topLevelItemCount() > 0);
+}
+
+void ProfilerWindow::startStopClicked()
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return;
+	if(KviKvsProfiler::isEnabled())
+		p->stop();
+	else
+		p->start(m_pInstructionTimingCheck->isChecked());
+	refresh();
+}
+
+void ProfilerWindow::instructionTimingToggled(bool bChecked)
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return;
+	// a running profiler switches right away, a stopped one at the next start
+	if(KviKvsProfiler::isEnabled())
+		p->start(bChecked);
+}
+
+void ProfilerWindow::clearClicked()
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return;
+	p->clear();
+	refresh();
+}
+
+void ProfilerWindow::exportClicked()
+{
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return;
+
+	QString szFile;
+	g_pKvsModule->lock();
+	bool bOk = KviFileDialog::askForSaveFileName(
+	    szFile,
+	    __tr2qs_ctx("Choose a Filename - KVIrc", "kvs"),
+	    "kvs-profile.folded",
+	    QString(),
+	    false,
+	    true,
+	    true,
+	    this);
+	g_pKvsModule->unlock();
+
+	if(!bOk)
+		return;
+
+	if(!p->exportCollapsedStacks(szFile))
+		QMessageBox::warning(this, __tr2qs_ctx("Export Failed - KVIrc", "kvs"), __tr2qs_ctx("Failed to write the file %1", "kvs").arg(szFile));
+}
+
+QPixmap * ProfilerWindow::myIconPtr()
+{
+	return g_pIconManager->getSmallIcon(KviIconManager::Stats);
+}
+
+void ProfilerWindow::resizeEvent(QResizeEvent *)
+{
+	m_pSplitter->setGeometry(0, 0, width(), height());
+}
+
+QSize ProfilerWindow::sizeHint() const
+{
+	return m_pSplitter->sizeHint();
+}
+
+void ProfilerWindow::fillCaptionBuffers()
+{
+	m_szPlainTextCaption = __tr2qs_ctx("KVS Profiler", "kvs");
+}
+
+void ProfilerWindow::getBaseLogFileName(QString & szBuffer)
+{
+	szBuffer = "KVSPROFILER";
+}
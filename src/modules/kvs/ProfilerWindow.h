@@ -0,0 +1,82 @@
+#ifndef _PROFILERWINDOW_H_
+#define _PROFILERWINDOW_H_
+//=============================================================================
+//
+//   File : ProfilerWindow.h
+//   Creation date : Sun 18 Oct 2026 15:02:44 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviWindow.h"
+
+#include <QTreeWidget>
+
+class KviKvsProfilerEntry;
+class KviThemedTreeWidget;
+class QCheckBox;
+class QLabel;
+class QPushButton;
+
+class ProfilerTreeWidgetItem : public QTreeWidgetItem
+{
+public:
+	ProfilerTreeWidgetItem(QTreeWidget * pParent, KviKvsProfilerEntry * e);
+	~ProfilerTreeWidgetItem(){};
+
+protected:
+	// the raw values, used for sorting
+	qint64 m_iValues[6];
+
+public:
+	bool operator<(const QTreeWidgetItem & other) const override;
+};
+
+class ProfilerWindow : public KviWindow
+{
+	Q_OBJECT
+public:
+	ProfilerWindow();
+	~ProfilerWindow();
+
+protected:
+	QLabel * m_pStatusLabel;
+	KviThemedTreeWidget * m_pScriptTreeWidget;
+	KviThemedTreeWidget * m_pNodeTreeWidget;
+	QCheckBox * m_pInstructionTimingCheck;
+	QPushButton * m_pStartStopButton;
+
+protected:
+	QPixmap * myIconPtr() override;
+	void fillCaptionBuffers() override;
+	void resizeEvent(QResizeEvent * e) override;
+	void getBaseLogFileName(QString & szBuffer) override;
+
+public:
+	QSize sizeHint() const override;
+public slots:
+	void refresh();
+protected slots:
+	void startStopClicked();
+	void instructionTimingToggled(bool bChecked);
+	void clearClicked();
+	void exportClicked();
+};
+
+#endif //_PROFILERWINDOW_H_
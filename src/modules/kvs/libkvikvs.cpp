@@ -0,0 +1,280 @@
+//=============================================================================
+//
+//   File : libkvikvs.cpp
+//   Creation date : Sun 18 Oct 2026 11:02:17 GMT by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+#include "KviModule.h"
+#include "KviLocale.h"
+#include "KviDebugWindow.h"
+#include "KviKvsParseCache.h"
+#include "KviKvsProfiler.h"
+#include "KviMainWindow.h"
+#include "KviFileUtils.h"
+#include "ProfilerWindow.h"
+#include "kvi_out.h"
+
+#include <algorithm>
+#include <vector>
+
+KviModule * g_pKvsModule = nullptr;
+ProfilerWindow * g_pProfilerWindow = nullptr;
+
+/*
+	@doc: kvs.parsecache
+	@type:
+		command
+	@title:
+		kvs.parsecache
+	@short:
+		Shows the statistics of the KVS parse cache
+	@syntax:
+		kvs.parsecache [-c] [-r]
+	@switches:
+		!sw: -c | --clear
+		Drops all the cached syntax trees, including the ones saved
+		in the previous sessions
+		!sw: -r | --reset
+		Resets the hit and miss counters
+	@description:
+		KVIrc keeps the syntax trees of the scripts that are built on the fly
+		(the code passed to [cmd]eval[/cmd], the files executed by [cmd]parse[/cmd]
+		and the scripts started internally by KVIrc and its modules) so that
+		an unchanged script is parsed only once.[br]
+		The cache is limited to about one million characters of source code,
+		the oldest scripts are dropped first.[br]
+		The syntax trees of all the scripts parsed without errors and warnings
+		(aliases, events, popups, actions and the other scripts loaded at startup
+		included) are also saved on exit to a file in the local KVIrc directory.
+		The file is memory mapped at the next startup and an unchanged script
+		is rebuilt from there without being parsed again. The trees are keyed
+		by the source code and by the KVIrc build: a new version simply
+		starts with an empty file.[br]
+		This command prints the number and the total size of the cached scripts,
+		the number of saved syntax trees and the hit rates of both to the debug window.
+	@seealso:
+		[cmd]eval[/cmd], [cmd]parse[/cmd]
+*/
+
+static bool kvs_kvs_cmd_parsecache(KviKvsModuleCommandCall * c)
+{
+	KviKvsParseCache * pCache = KviKvsParseCache::instance();
+	if(!pCache)
+		return true;
+
+	KviWindow * pWnd = KviDebugWindow::getInstance();
+
+	unsigned int uHits = pCache->hits();
+	unsigned int uMisses = pCache->misses();
+	unsigned int uTotal = uHits + uMisses;
+	unsigned int uCount = pCache->count();
+	unsigned int uSize = pCache->size();
+	QString szRate = QString("%1%").arg(uTotal ? (uHits * 100) / uTotal : 0);
+
+	pWnd->output(KVI_OUT_SYSTEMMESSAGE, __tr2qs_ctx("KVS parse cache: %u scripts cached (%u characters), %u hits, %u misses (%Q hit rate)", "kvs"), uCount, uSize, uHits, uMisses, &szRate);
+
+	uHits = pCache->treeHits();
+	uMisses = pCache->treeMisses();
+	uTotal = uHits + uMisses;
+	uCount = pCache->treeCount();
+	szRate = QString("%1%").arg(uTotal ? (uHits * 100) / uTotal : 0);
+
+	pWnd->output(KVI_OUT_SYSTEMMESSAGE, __tr2qs_ctx("KVS saved syntax trees: %u trees, %u hits, %u misses (%Q hit rate)", "kvs"), uCount, uHits, uMisses, &szRate);
+
+	if(c->switches()->find('c', "clear"))
+	{
+		pCache->clear();
+		pWnd->output(KVI_OUT_SYSTEMMESSAGE, __tr2qs_ctx("KVS parse cache cleared", "kvs"));
+	}
+
+	if(c->switches()->find('r', "reset"))
+		pCache->resetStats();
+
+	return true;
+}
+
+/*
+	@doc: kvs.profile
+	@type:
+		command
+	@title:
+		kvs.profile
+	@short:
+		Controls the KVS profiler
+	@syntax:
+		kvs.profile [-i] [-n=<count>] <action:string> [<filename:string>]
+	@switches:
+		!sw: -i | --instructions
+		With the [i]start[/i] action: time also the single instructions
+		of the scripts. This is considerably slower. The self time of an
+		instruction doesn't include the instructions nested in it, like the
+		body of an [cmd]if[/cmd] or of a loop.
+		!sw: -n=<count> | --count=<count>
+		With the [i]report[/i] action: print at most <count> entries (default: 20)
+	@description:
+		The KVS profiler measures the time spent in every script that KVIrc
+		runs: aliases, event handlers, timers, object methods, popups and so on.
+		The scripts are identified by their context name, the same one that
+		is shown in the error messages (e.g. [i]OnChannelMessage::myhandler[/i]).[br]
+		When the profiler is stopped it costs nothing.[br]
+		<action> can be one of:[br]
+		[i]start[/i]: starts (or resumes) the profiling[br]
+		[i]stop[/i]: stops the profiling, the collected data is kept[br]
+		[i]clear[/i]: drops the collected data[br]
+		[i]report[/i]: prints the scripts that took the most self time to the debug window[br]
+		[i]export[/i]: writes the self time of each call stack to <filename>,
+		in the "collapsed stack" format used by the common flame graph tools[br]
+		[i]show[/i]: opens the profiler window, where the data can be sorted
+		by any column[br]
+		The total time of a script includes the scripts it called, the self
+		time does not. The times are wall clock times, so a script that
+		opens a modal dialog will be accounted for the time the dialog was open.
+	@examples:
+		[example]
+			kvs.profile start
+			[comment]# ...let it run for a while...[/comment]
+			kvs.profile stop
+			kvs.profile -n=10 report
+			kvs.profile export /tmp/kvirc.folded
+		[/example]
+	@seealso:
+		[cmd]kvs.parsecache[/cmd]
+*/
+
+static bool kvs_kvs_cmd_profile(KviKvsModuleCommandCall * c)
+{
+	QString szAction, szFileName;
+	KVSM_PARAMETERS_BEGIN(c)
+	KVSM_PARAMETER("action", KVS_PT_NONEMPTYSTRING, 0, szAction)
+	KVSM_PARAMETER("filename", KVS_PT_STRING, KVS_PF_OPTIONAL, szFileName)
+	KVSM_PARAMETERS_END(c)
+
+	KviKvsProfiler * p = KviKvsProfiler::instance();
+	if(!p)
+		return true;
+
+	if(KviQString::equalCI(szAction, "start"))
+	{
+		p->start(c->switches()->find('i', "instructions"));
+	}
+	else if(KviQString::equalCI(szAction, "stop"))
+	{
+		p->stop();
+	}
+	else if(KviQString::equalCI(szAction, "clear"))
+	{
+		p->clear();
+	}
+	else if(KviQString::equalCI(szAction, "report"))
+	{
+		kvs_int_t iCount = 20;
+		KviKvsVariant * v = c->switches()->find('n', "count");
+		if(v && !v->asInteger(iCount))
+		{
+			c->warning(__tr2qs_ctx("Invalid count specified, using the default", "kvs"));
+			iCount = 20;
+		}
+
+		std::vector<KviKvsProfilerEntry *> entries;
+		KviPointerHashTableIterator<QString, KviKvsProfilerEntry> it(*(p->scriptEntries()));
+		while(KviKvsProfilerEntry * e = it.current())
+		{
+			entries.push_back(e);
+			++it;
+		}
+		std::sort(entries.begin(), entries.end(), [](KviKvsProfilerEntry * a, KviKvsProfilerEntry * b) { return a->m_iSelfTime > b->m_iSelfTime; });
+
+		KviWindow * pWnd = KviDebugWindow::getInstance();
+		QString szTime = QString::number((double)p->profiledTime() / 1000000.0, 'f', 3);
+		pWnd->output(KVI_OUT_SYSTEMMESSAGE, __tr2qs_ctx("KVS profiler report: %u scripts, %Q ms profiled", "kvs"), (unsigned int)entries.size(), &szTime);
+
+		for(size_t u = 0; (u < entries.size()) && ((kvs_int_t)u < iCount); u++)
+		{
+			KviKvsProfilerEntry * e = entries[u];
+			QString szSelf = QString::number((double)e->m_iSelfTime / 1000000.0, 'f', 3);
+			QString szTotal = QString::number((double)e->m_iTotalTime / 1000000.0, 'f', 3);
+			QString szMax = QString::number((double)e->m_iMaxTime / 1000000.0, 'f', 3);
+			pWnd->output(KVI_OUT_SYSTEMMESSAGE, __tr2qs_ctx("%Q: %u calls, self %Q ms, total %Q ms, max %Q ms", "kvs"), &(e->m_szName), e->m_uCalls, &szSelf, &szTotal, &szMax);
+		}
+	}
+	else if(KviQString::equalCI(szAction, "export"))
+	{
+		if(szFileName.isEmpty())
+		{
+			c->error(__tr2qs_ctx("The export action requires a file name", "kvs"));
+			return false;
+		}
+		KviFileUtils::adjustFilePath(szFileName);
+		if(!p->exportCollapsedStacks(szFileName))
+			c->warning(__tr2qs_ctx("Failed to write the file %Q", "kvs"), &szFileName);
+	}
+	else if(KviQString::equalCI(szAction, "show"))
+	{
+		if(!g_pProfilerWindow)
+		{
+			g_pProfilerWindow = new ProfilerWindow();
+			g_pMainWindow->addWindow(g_pProfilerWindow);
+			return true;
+		}
+		g_pProfilerWindow->delayedAutoRaise();
+	}
+	else
+	{
+		c->warning(__tr2qs_ctx("Unknown action '%Q'", "kvs"), &szAction);
+		return true;
+	}
+
+	if(g_pProfilerWindow)
+		g_pProfilerWindow->refresh();
+	return true;
+}
+
+static bool kvs_module_init(KviModule * m)
+{
+	g_pKvsModule = m;
+	KVSM_REGISTER_SIMPLE_COMMAND(m, "parsecache", kvs_kvs_cmd_parsecache);
+	KVSM_REGISTER_SIMPLE_COMMAND(m, "profile", kvs_kvs_cmd_profile);
+	return true;
+}
+
+static bool kvs_module_cleanup(KviModule *)
+{
+	if(g_pProfilerWindow && g_pMainWindow)
+		g_pMainWindow->closeWindow(g_pProfilerWindow);
+	g_pProfilerWindow = nullptr;
+	return true;
+}
+
+static bool kvs_module_can_unload(KviModule *)
+{
+	return (!g_pProfilerWindow);
+}
+
+KVIRC_MODULE(
+    "Kvs",                                           // module name
+    "4.0.0",                                         // module version
+    "Copyright (C) 2026 the KVIrc development team", // author & (C)
+    "KVS interpreter introspection",
+    kvs_module_init,
+    kvs_module_can_unload,
+    0,
+    kvs_module_cleanup,
+    0)
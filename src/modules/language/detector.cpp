@@ -28,6 +28,9 @@
 #include <string.h>
 #include <ctype.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "detector.h"
 
 //
@@ -18560,97 +18563,222 @@ static char valid_char_jump_table[256] = {
 #undef k
 #undef f
 
-static double score_for_ngram(DetectorDescriptor * d, const unsigned char * ngram)
+#define NUM_DESCRIPTORS 40
+
+static DetectorDescriptor * all_descriptors[NUM_DESCRIPTORS] = {
+	&l0_d, &l1_d, &l2_d, &l3_d, &l4_d, &l5_d, &l6_d, &l7_d, &l8_d, &l9_d,
+	&l10_d, &l11_d, &l12_d, &l13_d, &l14_d, &l15_d, &l16_d, &l17_d, &l18_d, &l19_d,
+	&l20_d, &l21_d, &l22_d, &l23_d, &l24_d, &l25_d, &l26_d, &l27_d, &l28_d, &l29_d,
+	&l30_d, &l31_d, &l32_d, &l33_d, &l34_d, &l35_d, &l36_d, &l37_d, &l38_d, &l39_d
+};
+
+//
+// MERGED TABLES
+//
+// All the descriptors are scored in a single pass over the data.
+// The single char scores of all the descriptors are stored side by side
+// and the ngrams of all the descriptors are merged in a single hash keyed by
+// the ngram bytes packed in an integer (an ngram is 2 to 4 non zero bytes
+// so the packed key is unique). The tables are built at the first detection.
+//
+
+typedef struct _MergedNGram
+{
+	unsigned int uKey;   // the packed ngram, 0 for an empty slot
+	unsigned int uFirst; // the first score in merged_ngram_scores
+	unsigned int uCount; // the number of descriptors that score this ngram
+} MergedNGram;
+
+typedef struct _MergedNGramScore
 {
-	const unsigned char * p = ngram;
-	int xhash = *p * 31;
-	p++;
-	xhash += *p * 17;
-	p++;
-	if(*p)
+	unsigned int uKey;
+	unsigned int uDescriptor;
+	double dScore;
+} MergedNGramScore;
+
+static double merged_single_char_data[256][NUM_DESCRIPTORS];
+static std::vector<MergedNGram> merged_ngram_hash; // open addressing, the size is a power of two
+static std::vector<MergedNGramScore> merged_ngram_scores;
+static bool merged_tables_built = false;
+
+// the hash used by the generated descriptor tables
+static unsigned int descriptor_ngram_hash(const unsigned char * ngram)
+{
+	const unsigned char * ptr = ngram;
+	int xhash = *ptr * 31;
+	ptr++;
+	xhash += *ptr * 17;
+	ptr++;
+	if(*ptr)
 	{
-		xhash += *p * 11;
-		p++;
-		if(*p)
+		xhash += *ptr * 11;
+		ptr++;
+		if(*ptr)
 		{
-			xhash += *p * 3;
+			xhash += *ptr * 3;
 		}
 	}
-	DetectorNGram * g = d->ngram_hash[xhash % 256];
-	while(g->szNGram)
+	return xhash % 256;
+}
+
+static inline unsigned int merged_ngram_slot(unsigned int uKey)
+{
+	unsigned int uHash = uKey * 2654435761U;
+	return uHash ^ (uHash >> 15);
+}
+
+static void build_merged_tables()
+{
+	int iDesc, iChar;
+	for(iChar = 0; iChar < 256; iChar++)
+	{
+		for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
+			merged_single_char_data[iChar][iDesc] = valid_char_jump_table[iChar] ? all_descriptors[iDesc]->single_char_data[iChar] : 0.0;
+	}
+
+	for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
 	{
-		if(strcmp((const char *)ngram, (const char *)g->szNGram) == 0)
+		for(int iBucket = 0; iBucket < 256; iBucket++)
 		{
-			return g->dScore;
+			for(DetectorNGram * pNGram = all_descriptors[iDesc]->ngram_hash[iBucket]; pNGram->szNGram; pNGram++)
+			{
+				// the lookup compares whole words cut to 2, 3 or 4 chars in the bucket given by the hash:
+				// the ngrams that can't be found that way never contributed to the score
+				size_t uLen = strlen((const char *)pNGram->szNGram);
+				if((uLen < 2) || (uLen > 4) || (descriptor_ngram_hash(pNGram->szNGram) != (unsigned int)iBucket))
+					continue;
+				MergedNGramScore score;
+				score.uKey = 0;
+				for(size_t uIdx = 0; uIdx < uLen; uIdx++)
+					score.uKey |= ((unsigned int)pNGram->szNGram[uIdx]) << (8 * uIdx);
+				score.uDescriptor = iDesc;
+				score.dScore = pNGram->dScore;
+				merged_ngram_scores.push_back(score);
+			}
 		}
-		g++;
 	}
-	return 0.0;
+
+	// group the scores by ngram: the stable sort keeps the bucket order and the lookup stops at the first match
+	std::stable_sort(merged_ngram_scores.begin(), merged_ngram_scores.end(),
+	    [](const MergedNGramScore & left, const MergedNGramScore & right) {
+		    if(left.uKey != right.uKey)
+			    return left.uKey < right.uKey;
+		    return left.uDescriptor < right.uDescriptor;
+	    });
+	merged_ngram_scores.erase(std::unique(merged_ngram_scores.begin(), merged_ngram_scores.end(),
+	                              [](const MergedNGramScore & left, const MergedNGramScore & right) {
+		                              return (left.uKey == right.uKey) && (left.uDescriptor == right.uDescriptor);
+	                              }),
+	    merged_ngram_scores.end());
+
+	unsigned int uSize = 1024;
+	while(uSize < merged_ngram_scores.size())
+		uSize *= 2;
+	merged_ngram_hash.assign(uSize, MergedNGram{ 0, 0, 0 });
+	unsigned int uMask = uSize - 1;
+
+	unsigned int uIdx = 0;
+	while(uIdx < merged_ngram_scores.size())
+	{
+		unsigned int uKey = merged_ngram_scores[uIdx].uKey;
+		unsigned int uSlot = merged_ngram_slot(uKey) & uMask;
+		while(merged_ngram_hash[uSlot].uKey)
+			uSlot = (uSlot + 1) & uMask;
+		merged_ngram_hash[uSlot].uKey = uKey;
+		merged_ngram_hash[uSlot].uFirst = uIdx;
+		while((uIdx < merged_ngram_scores.size()) && (merged_ngram_scores[uIdx].uKey == uKey))
+			uIdx++;
+		merged_ngram_hash[uSlot].uCount = uIdx - merged_ngram_hash[uSlot].uFirst;
+	}
+
+	merged_tables_built = true;
 }
 
-static double compute_descriptor_score(const unsigned char * data, DetectorDescriptor * d)
+static inline const MergedNGram * find_merged_ngram(unsigned int uKey)
 {
-	double dRet = 0.0;
-
-	const unsigned char * p = data;
-	while(*p)
+	unsigned int uMask = merged_ngram_hash.size() - 1;
+	unsigned int uSlot = merged_ngram_slot(uKey) & uMask;
+	while(merged_ngram_hash[uSlot].uKey)
 	{
-		unsigned char z = (unsigned char)tolower((char)*p);
-		if(valid_char_jump_table[z])
-			dRet += d->single_char_data[z];
-		p++;
+		if(merged_ngram_hash[uSlot].uKey == uKey)
+			return &(merged_ngram_hash[uSlot]);
+		uSlot = (uSlot + 1) & uMask;
 	}
+	return nullptr;
+}
 
-	// now by hash...this is hard
-	p = data;
+static inline void add_single_char_scores(double * pScores, unsigned char uChar)
+{
+	// this one is vectorized by the compiler
+	const double * pCharScores = merged_single_char_data[uChar];
+	for(int iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
+		pScores[iDesc] += pCharScores[iDesc];
+}
+
+static inline void find_ngram(std::vector<const MergedNGram *> & found, unsigned int uKey)
+{
+	const MergedNGram * pNGram = find_merged_ngram(uKey);
+	if(pNGram)
+		found.push_back(pNGram);
+}
+
+static void compute_descriptor_scores(const unsigned char * data, double * pScores)
+{
+	if(!merged_tables_built)
+		build_merged_tables();
+
+	int iDesc;
+	for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)
+		pScores[iDesc] = 0.0;
+
+	// The ngrams found are scored after all the single chars: the sums
+	// are then done in the same order as when the descriptors were scored
+	// one by one and the results are exactly the same.
+	std::vector<const MergedNGram *> found;
+	const unsigned char * ptr = data;
 	unsigned char buffer[1024]; // we handle words up to 1024 chars
 	buffer[0] = ' ';            // we always start with a space
-	while(*p)
+	while(*ptr)
 	{
-		while(*p && !valid_char_jump_table[*p])
-			p++;
+		while(*ptr && !valid_char_jump_table[*ptr])
+		{
+			unsigned char uChar = (unsigned char)tolower((char)*ptr);
+			if(valid_char_jump_table[uChar])
+				add_single_char_scores(pScores, uChar);
+			ptr++;
+		}
 		int idx = 1;
-		while(valid_char_jump_table[*p] && (idx < 1022))
+		while(valid_char_jump_table[*ptr] && (idx < 1022))
 		{
-			buffer[idx] = (unsigned char)tolower((char)*p);
-			p++;
+			unsigned char uChar = (unsigned char)tolower((char)*ptr);
+			if(valid_char_jump_table[uChar])
+				add_single_char_scores(pScores, uChar);
+			buffer[idx] = uChar;
+			ptr++;
 			idx++;
 		}
 		buffer[idx] = ' '; // and we always end with a space
 		idx++;
-		buffer[idx] = 0; // and we null terminate
-		// now run through the buffer checking the ngrams
-		unsigned char * r = buffer + 2;
-		while(*r)
+		// now run through the buffer looking for the 4, 3 and 2 letters ngrams ending before each char
+		for(int iEnd = 2; iEnd < idx; iEnd++)
 		{
-			unsigned char save = *r;
-			*r = 0;
-			// 4 letters ngram
-			unsigned char * begin = r - 4;
-			if(begin >= buffer)
-				dRet += score_for_ngram(d, begin);
-			// 3 letters ngram
-			begin++;
-			if(begin >= buffer)
-				dRet += score_for_ngram(d, begin);
-			// 2 letters ngram
-			begin++;
-			dRet += score_for_ngram(d, begin);
-			*r = save;
-			r++;
+			unsigned int uKey = buffer[iEnd - 2] | (buffer[iEnd - 1] << 8);
+			if(iEnd >= 4)
+				find_ngram(found, buffer[iEnd - 4] | (buffer[iEnd - 3] << 8) | (uKey << 16));
+			if(iEnd >= 3)
+				find_ngram(found, buffer[iEnd - 3] | (uKey << 8));
+			find_ngram(found, uKey);
 		}
 	}
-	return dRet;
-}
-
-#define NUM_DESCRIPTORS 40
 
-static DetectorDescriptor * all_descriptors[NUM_DESCRIPTORS] = {
-	&l0_d, &l1_d, &l2_d, &l3_d, &l4_d, &l5_d, &l6_d, &l7_d, &l8_d, &l9_d,
-	&l10_d, &l11_d, &l12_d, &l13_d, &l14_d, &l15_d, &l16_d, &l17_d, &l18_d, &l19_d,
-	&l20_d, &l21_d, &l22_d, &l23_d, &l24_d, &l25_d, &l26_d, &l27_d, &l28_d, &l29_d,
-	&l30_d, &l31_d, &l32_d, &l33_d, &l34_d, &l35_d, &l36_d, &l37_d, &l38_d, &l39_d
-};
+	for(auto pNGram : found)
+	{
+		const MergedNGramScore * pScore = &(merged_ngram_scores[pNGram->uFirst]);
+		const MergedNGramScore * pEnd = pScore + pNGram->uCount;
+		for(; pScore < pEnd; pScore++)
+			pScores[pScore->uDescriptor] += pScore->dScore;
+	}
+}
 
 #define NEED_ONE_CHAR             \
 	p++;                          \
@@ -18727,13 +18855,15 @@ void detect_language_and_encoding(const char * data, LanguageAndEncodingResult *
 	retBuffer->dAccuracy = 0.0;
 
 	int utf8 = utf8score((const unsigned char *)data);
+	double scores[NUM_DESCRIPTORS];
+	compute_descriptor_scores((const unsigned char *)data, scores);
 	i = 0;
 	while(i < NUM_DESCRIPTORS)
 	{
 		bool bIsUtf8 = ((strcmp(all_descriptors[i]->szEncoding, "utf8") == 0) || (strcmp(all_descriptors[i]->szEncoding, "utf-8") == 0));
 		if((!bIsUtf8) || (!(iFlags & DLE_STRICT_UTF8_CHECKING)))
 		{
-			double dThis = compute_descriptor_score((const unsigned char *)data, all_descriptors[i]);
+			double dThis = scores[i];
 			if(bIsUtf8)
 			{
 				dThis *= 1.0 + (((double)utf8) * 0.01);
@@ -100,6 +100,9 @@ print OUTPUT "#include <stdio.h>\n";
 print OUTPUT "#include <string.h>\n";
 print OUTPUT "#include <ctype.h>\n";
 print OUTPUT "\n";
+print OUTPUT "#include <algorithm>\n";
+print OUTPUT "#include <vector>\n";
+print OUTPUT "\n";
 print OUTPUT "#include \"detector.h\"\n";
 print OUTPUT "\n";
 print OUTPUT "///////////////////////////////////////////////////////////////////////////////\n";
@@ -601,132 +604,229 @@ print OUTPUT "#undef k\n";
 print OUTPUT "#undef f\n";
 
 print OUTPUT "\n";
-print OUTPUT "static double score_for_ngram(DetectorDescriptor * d,const unsigned char * ngram)\n";
+print OUTPUT "#define NUM_DESCRIPTORS ".$descriptorCnt."\n";
+
+print OUTPUT "\n";
+print OUTPUT "static DetectorDescriptor * all_descriptors[NUM_DESCRIPTORS]=\n";
+print OUTPUT "{\n";
+for($i=0;$i<$descriptorCnt;$i++)
+{
+	if(($i % 10) == 0){ print OUTPUT "	"; }
+	print OUTPUT "&".$descriptors[$i];
+	if($i < ($descriptorCnt - 1)){ print OUTPUT ","; }
+	if(($i % 10) == 9){ print OUTPUT "\n"; }
+}
+print OUTPUT "};\n";
+print OUTPUT "\n";
+
+
+print OUTPUT "//\n";
+print OUTPUT "// MERGED TABLES\n";
+print OUTPUT "//\n";
+print OUTPUT "// All the descriptors are scored in a single pass over the data.\n";
+print OUTPUT "// The single char scores of all the descriptors are stored side by side\n";
+print OUTPUT "// and the ngrams of all the descriptors are merged in a single hash keyed by\n";
+print OUTPUT "// the ngram bytes packed in an integer (an ngram is 2 to 4 non zero bytes\n";
+print OUTPUT "// so the packed key is unique). The tables are built at the first detection.\n";
+print OUTPUT "//\n";
+print OUTPUT "\n";
+print OUTPUT "typedef struct _MergedNGram\n";
+print OUTPUT "{\n";
+print OUTPUT "	unsigned int uKey;   // the packed ngram, 0 for an empty slot\n";
+print OUTPUT "	unsigned int uFirst; // the first score in merged_ngram_scores\n";
+print OUTPUT "	unsigned int uCount; // the number of descriptors that score this ngram\n";
+print OUTPUT "} MergedNGram;\n";
+print OUTPUT "\n";
+print OUTPUT "typedef struct _MergedNGramScore\n";
+print OUTPUT "{\n";
+print OUTPUT "	unsigned int uKey;\n";
+print OUTPUT "	unsigned int uDescriptor;\n";
+print OUTPUT "	double dScore;\n";
+print OUTPUT "} MergedNGramScore;\n";
+print OUTPUT "\n";
+print OUTPUT "static double merged_single_char_data[256][NUM_DESCRIPTORS];\n";
+print OUTPUT "static std::vector<MergedNGram> merged_ngram_hash; // open addressing, the size is a power of two\n";
+print OUTPUT "static std::vector<MergedNGramScore> merged_ngram_scores;\n";
+print OUTPUT "static bool merged_tables_built = false;\n";
+print OUTPUT "\n";
+print OUTPUT "// the hash used by the generated descriptor tables\n";
+print OUTPUT "static unsigned int descriptor_ngram_hash(const unsigned char * ngram)\n";
 print OUTPUT "{\n";
-print OUTPUT "		const unsigned char * p = ngram;\n";
-print OUTPUT "		int xhash = *p * 31;\n";
-print OUTPUT "		p++;\n";
-print OUTPUT "		xhash += *p * 17;\n";
-print OUTPUT "		p++;\n";
-print OUTPUT "		if(*p)\n";
+print OUTPUT "	const unsigned char * ptr = ngram;\n";
+print OUTPUT "	int xhash = *ptr * 31;\n";
+print OUTPUT "	ptr++;\n";
+print OUTPUT "	xhash += *ptr * 17;\n";
+print OUTPUT "	ptr++;\n";
+print OUTPUT "	if(*ptr)\n";
+print OUTPUT "	{\n";
+print OUTPUT "		xhash += *ptr * 11;\n";
+print OUTPUT "		ptr++;\n";
+print OUTPUT "		if(*ptr)\n";
 print OUTPUT "		{\n";
-print OUTPUT "			xhash += *p * 11;\n";
-print OUTPUT "			p++;\n";
-print OUTPUT "			if(*p)\n";
-print OUTPUT "			{\n";
-print OUTPUT "				xhash += *p * 3;\n";
-print OUTPUT "			}\n";
+print OUTPUT "			xhash += *ptr * 3;\n";
 print OUTPUT "		}\n";
-print OUTPUT "		DetectorNGram * g = d->ngram_hash[xhash % 256];\n";
-print OUTPUT "		while(g->szNGram)\n";
+print OUTPUT "	}\n";
+print OUTPUT "	return xhash % 256;\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static inline unsigned int merged_ngram_slot(unsigned int uKey)\n";
+print OUTPUT "{\n";
+print OUTPUT "	unsigned int uHash = uKey * 2654435761U;\n";
+print OUTPUT "	return uHash ^ (uHash >> 15);\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static void build_merged_tables()\n";
+print OUTPUT "{\n";
+print OUTPUT "	int iDesc, iChar;\n";
+print OUTPUT "	for(iChar = 0; iChar < 256; iChar++)\n";
+print OUTPUT "	{\n";
+print OUTPUT "		for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)\n";
+print OUTPUT "			merged_single_char_data[iChar][iDesc] = valid_char_jump_table[iChar] ? all_descriptors[iDesc]->single_char_data[iChar] : 0.0;\n";
+print OUTPUT "	}\n";
+print OUTPUT "\n";
+print OUTPUT "	for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)\n";
+print OUTPUT "	{\n";
+print OUTPUT "		for(int iBucket = 0; iBucket < 256; iBucket++)\n";
 print OUTPUT "		{\n";
-print OUTPUT "			if(strcmp((const char *)ngram,(const char *)g->szNGram) == 0){ /*printf(\"GOT NGRAM %s SCORE %f\\n\",ngram,g->dScore);*/ return g->dScore; }\n";
-print OUTPUT "			g++;\n";
+print OUTPUT "			for(DetectorNGram * pNGram = all_descriptors[iDesc]->ngram_hash[iBucket]; pNGram->szNGram; pNGram++)\n";
+print OUTPUT "			{\n";
+print OUTPUT "				// the lookup compares whole words cut to 2, 3 or 4 chars in the bucket given by the hash:\n";
+print OUTPUT "				// the ngrams that can't be found that way never contributed to the score\n";
+print OUTPUT "				size_t uLen = strlen((const char *)pNGram->szNGram);\n";
+print OUTPUT "				if((uLen < 2) || (uLen > 4) || (descriptor_ngram_hash(pNGram->szNGram) != (unsigned int)iBucket))\n";
+print OUTPUT "					continue;\n";
+print OUTPUT "				MergedNGramScore score;\n";
+print OUTPUT "				score.uKey = 0;\n";
+print OUTPUT "				for(size_t uIdx = 0; uIdx < uLen; uIdx++)\n";
+print OUTPUT "					score.uKey |= ((unsigned int)pNGram->szNGram[uIdx]) << (8 * uIdx);\n";
+print OUTPUT "				score.uDescriptor = iDesc;\n";
+print OUTPUT "				score.dScore = pNGram->dScore;\n";
+print OUTPUT "				merged_ngram_scores.push_back(score);\n";
+print OUTPUT "			}\n";
 print OUTPUT "		}\n";
-print OUTPUT "		return 0.0;\n";
-print OUTPUT "}\n";
+print OUTPUT "	}\n";
 print OUTPUT "\n";
-
+print OUTPUT "	// group the scores by ngram: the stable sort keeps the bucket order and the lookup stops at the first match\n";
+print OUTPUT "	std::stable_sort(merged_ngram_scores.begin(), merged_ngram_scores.end(),\n";
+print OUTPUT "	    [](const MergedNGramScore & left, const MergedNGramScore & right) {\n";
+print OUTPUT "		    if(left.uKey != right.uKey)\n";
+print OUTPUT "			    return left.uKey < right.uKey;\n";
+print OUTPUT "		    return left.uDescriptor < right.uDescriptor;\n";
+print OUTPUT "	    });\n";
+print OUTPUT "	merged_ngram_scores.erase(std::unique(merged_ngram_scores.begin(), merged_ngram_scores.end(),\n";
+print OUTPUT "	                              [](const MergedNGramScore & left, const MergedNGramScore & right) {\n";
+print OUTPUT "		                              return (left.uKey == right.uKey) && (left.uDescriptor == right.uDescriptor);\n";
+print OUTPUT "	                              }),\n";
+print OUTPUT "	    merged_ngram_scores.end());\n";
+print OUTPUT "\n";
+print OUTPUT "	unsigned int uSize = 1024;\n";
+print OUTPUT "	while(uSize < merged_ngram_scores.size())\n";
+print OUTPUT "		uSize *= 2;\n";
+print OUTPUT "	merged_ngram_hash.assign(uSize, MergedNGram{ 0, 0, 0 });\n";
+print OUTPUT "	unsigned int uMask = uSize - 1;\n";
+print OUTPUT "\n";
+print OUTPUT "	unsigned int uIdx = 0;\n";
+print OUTPUT "	while(uIdx < merged_ngram_scores.size())\n";
+print OUTPUT "	{\n";
+print OUTPUT "		unsigned int uKey = merged_ngram_scores[uIdx].uKey;\n";
+print OUTPUT "		unsigned int uSlot = merged_ngram_slot(uKey) & uMask;\n";
+print OUTPUT "		while(merged_ngram_hash[uSlot].uKey)\n";
+print OUTPUT "			uSlot = (uSlot + 1) & uMask;\n";
+print OUTPUT "		merged_ngram_hash[uSlot].uKey = uKey;\n";
+print OUTPUT "		merged_ngram_hash[uSlot].uFirst = uIdx;\n";
+print OUTPUT "		while((uIdx < merged_ngram_scores.size()) && (merged_ngram_scores[uIdx].uKey == uKey))\n";
+print OUTPUT "			uIdx++;\n";
+print OUTPUT "		merged_ngram_hash[uSlot].uCount = uIdx - merged_ngram_hash[uSlot].uFirst;\n";
+print OUTPUT "	}\n";
 print OUTPUT "\n";
-print OUTPUT "static double compute_descriptor_score(const unsigned char * data,DetectorDescriptor * d)\n";
+print OUTPUT "	merged_tables_built = true;\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static inline const MergedNGram * find_merged_ngram(unsigned int uKey)\n";
 print OUTPUT "{\n";
-print OUTPUT "	double dRet = 0.0;\n";
-print OUTPUT "	//unsigned char x[256];\n";
-print OUTPUT "	//memset(x,0,256)\n";
-print OUTPUT "	const unsigned char * p = data;\n";
-print OUTPUT "	while(*p)\n";
+print OUTPUT "	unsigned int uMask = merged_ngram_hash.size() - 1;\n";
+print OUTPUT "	unsigned int uSlot = merged_ngram_slot(uKey) & uMask;\n";
+print OUTPUT "	while(merged_ngram_hash[uSlot].uKey)\n";
 print OUTPUT "	{\n";
-print OUTPUT "		unsigned char z = (unsigned char)tolower((char)*p);\n";
-print OUTPUT "		if(valid_char_jump_table[z])\n";
-print OUTPUT "			dRet += d->single_char_data[z];\n";
-print OUTPUT "		p++;\n";
+print OUTPUT "		if(merged_ngram_hash[uSlot].uKey == uKey)\n";
+print OUTPUT "			return &(merged_ngram_hash[uSlot]);\n";
+print OUTPUT "		uSlot = (uSlot + 1) & uMask;\n";
 print OUTPUT "	}\n";
-
-print OUTPUT "	//unsigned int x[256];\n";
-print OUTPUT "	//int i;\n";
-print OUTPUT "	//for(i=0;i<256;i++)x[i] = 0;\n";
-print OUTPUT "	//unsigned int total = 0;\n";
-print OUTPUT "	//while(*p)\n";
-print OUTPUT "	//{\n";
-print OUTPUT "	//	unsigned char z = (unsigned char)tolower((char)*p);\n";
-print OUTPUT "	//	if(valid_char_jump_table[z])\n";
-print OUTPUT "	//	{\n";
-print OUTPUT "	//		x[z]++;\n";
-print OUTPUT "	//		total++;\n";
-print OUTPUT "	//	}\n";
-print OUTPUT "	//	p++;\n";
-print OUTPUT "	//}\n";
-print OUTPUT "	//for(i=0;i<256;i++)\n";
-print OUTPUT "	//{\n";
-print OUTPUT "	//	if(valid_char_jump_table[i])\n";
-print OUTPUT "	//	{\n";
-print OUTPUT "	//		double dPercent = ((double)x[i]) / ((double)total);\n";
-print OUTPUT "	//		double dDiff = dPercent - d->single_char_data[i];\n";
-print OUTPUT "	//		if(dDiff < 0.0)dDiff = -dDiff;\n";
-print OUTPUT "	//		if(dPercent > d->single_char_data[i])dDiff *= d->single_char_data[i] == 0.0 ? 3.0 : 1.5;\n";
-print OUTPUT "	//		if(i > 127)dDiff *= 1.5;\n";
-print OUTPUT "	//		if(i > 192)dDiff *= 1.5;\n";
-print OUTPUT "	//		dRet -= ((double)total) * dDiff;\n";
-print OUTPUT "	//		//printf(\"CHAR %d FILE %f REF %f DIFF %f SCORE %f\\n\",i,dPercent,d->single_char_data[i],dDiff,((double)total) * dDiff);\n";
-print OUTPUT "	//	}\n";
-print OUTPUT "	//}\n";
-
-print OUTPUT "	// now by hash...this is hard\n";
-print OUTPUT "	p = data;\n";
+print OUTPUT "	return nullptr;\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static inline void add_single_char_scores(double * pScores, unsigned char uChar)\n";
+print OUTPUT "{\n";
+print OUTPUT "	// this one is vectorized by the compiler\n";
+print OUTPUT "	const double * pCharScores = merged_single_char_data[uChar];\n";
+print OUTPUT "	for(int iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)\n";
+print OUTPUT "		pScores[iDesc] += pCharScores[iDesc];\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static inline void find_ngram(std::vector<const MergedNGram *> & found, unsigned int uKey)\n";
+print OUTPUT "{\n";
+print OUTPUT "	const MergedNGram * pNGram = find_merged_ngram(uKey);\n";
+print OUTPUT "	if(pNGram)\n";
+print OUTPUT "		found.push_back(pNGram);\n";
+print OUTPUT "}\n";
+print OUTPUT "\n";
+print OUTPUT "static void compute_descriptor_scores(const unsigned char * data, double * pScores)\n";
+print OUTPUT "{\n";
+print OUTPUT "	if(!merged_tables_built)\n";
+print OUTPUT "		build_merged_tables();\n";
+print OUTPUT "\n";
+print OUTPUT "	int iDesc;\n";
+print OUTPUT "	for(iDesc = 0; iDesc < NUM_DESCRIPTORS; iDesc++)\n";
+print OUTPUT "		pScores[iDesc] = 0.0;\n";
+print OUTPUT "\n";
+print OUTPUT "	// The ngrams found are scored after all the single chars: the sums\n";
+print OUTPUT "	// are then done in the same order as when the descriptors were scored\n";
+print OUTPUT "	// one by one and the results are exactly the same.\n";
+print OUTPUT "	std::vector<const MergedNGram *> found;\n";
+print OUTPUT "	const unsigned char * ptr = data;\n";
 print OUTPUT "	unsigned char buffer[1024]; // we handle words up to 1024 chars\n";
-print OUTPUT "	buffer[0] = ' '; // we always start with a space\n";
-print OUTPUT "	while(*p)\n";
+print OUTPUT "	buffer[0] = ' ';            // we always start with a space\n";
+print OUTPUT "	while(*ptr)\n";
 print OUTPUT "	{\n";
-print OUTPUT "		while(*p && !valid_char_jump_table[*p])p++;\n";
+print OUTPUT "		while(*ptr && !valid_char_jump_table[*ptr])\n";
+print OUTPUT "		{\n";
+print OUTPUT "			unsigned char uChar = (unsigned char)tolower((char)*ptr);\n";
+print OUTPUT "			if(valid_char_jump_table[uChar])\n";
+print OUTPUT "				add_single_char_scores(pScores, uChar);\n";
+print OUTPUT "			ptr++;\n";
+print OUTPUT "		}\n";
 print OUTPUT "		int idx = 1;\n";
-print OUTPUT "		while(valid_char_jump_table[*p] && (idx < 1022))\n";
+print OUTPUT "		while(valid_char_jump_table[*ptr] && (idx < 1022))\n";
 print OUTPUT "		{\n";
-print OUTPUT "			buffer[idx] = (unsigned char)tolower((char)*p);\n";
-print OUTPUT "			p++;\n";
+print OUTPUT "			unsigned char uChar = (unsigned char)tolower((char)*ptr);\n";
+print OUTPUT "			if(valid_char_jump_table[uChar])\n";
+print OUTPUT "				add_single_char_scores(pScores, uChar);\n";
+print OUTPUT "			buffer[idx] = uChar;\n";
+print OUTPUT "			ptr++;\n";
 print OUTPUT "			idx++;\n";
 print OUTPUT "		}\n";
 print OUTPUT "		buffer[idx] = ' '; // and we always end with a space\n";
 print OUTPUT "		idx++;\n";
-print OUTPUT "		buffer[idx] = 0; // and we null terminate\n";
-print OUTPUT "		// now run through the buffer checking the ngrams\n";
-print OUTPUT "		unsigned char * r = buffer + 2;\n";
-print OUTPUT "		while(*r)\n";
+print OUTPUT "		// now run through the buffer looking for the 4, 3 and 2 letters ngrams ending before each char\n";
+print OUTPUT "		for(int iEnd = 2; iEnd < idx; iEnd++)\n";
 print OUTPUT "		{\n";
-print OUTPUT "			unsigned char save = *r;\n";
-print OUTPUT "			*r = 0;\n";
-print OUTPUT "			// 4 letters ngram\n";
-print OUTPUT "			unsigned char * begin = r-4;\n";
-print OUTPUT "			if(begin >= buffer)\n";
-print OUTPUT "				dRet += score_for_ngram(d,begin);\n";
-print OUTPUT "			// 3 letters ngram\n";
-print OUTPUT "			begin++;\n";
-print OUTPUT "			if(begin >= buffer)\n";
-print OUTPUT "				dRet += score_for_ngram(d,begin);\n";
-print OUTPUT "			// 2 letters ngram\n";
-print OUTPUT "			begin++;\n";
-print OUTPUT "			dRet += score_for_ngram(d,begin);\n";
-print OUTPUT "			*r = save;\n";
-print OUTPUT "			r++;\n";
+print OUTPUT "			unsigned int uKey = buffer[iEnd - 2] | (buffer[iEnd - 1] << 8);\n";
+print OUTPUT "			if(iEnd >= 4)\n";
+print OUTPUT "				find_ngram(found, buffer[iEnd - 4] | (buffer[iEnd - 3] << 8) | (uKey << 16));\n";
+print OUTPUT "			if(iEnd >= 3)\n";
+print OUTPUT "				find_ngram(found, buffer[iEnd - 3] | (uKey << 8));\n";
+print OUTPUT "			find_ngram(found, uKey);\n";
 print OUTPUT "		}\n";
 print OUTPUT "	}\n";
-print OUTPUT "	return dRet;\n";
-print OUTPUT "}\n";
 print OUTPUT "\n";
-
-
-print OUTPUT "#define NUM_DESCRIPTORS ".$descriptorCnt."\n";
-
-print OUTPUT "\n";
-print OUTPUT "static DetectorDescriptor * all_descriptors[NUM_DESCRIPTORS]=\n";
-print OUTPUT "{\n";
-for($i=0;$i<$descriptorCnt;$i++)
-{
-	if(($i % 10) == 0){ print OUTPUT "	"; }
-	print OUTPUT "&".$descriptors[$i];
-	if($i < ($descriptorCnt - 1)){ print OUTPUT ","; }
-	if(($i % 10) == 9){ print OUTPUT "\n"; }
-}
-print OUTPUT "};\n";
+print OUTPUT "	for(auto pNGram : found)\n";
+print OUTPUT "	{\n";
+print OUTPUT "		const MergedNGramScore * pScore = &(merged_ngram_scores[pNGram->uFirst]);\n";
+print OUTPUT "		const MergedNGramScore * pEnd = pScore + pNGram->uCount;\n";
+print OUTPUT "		for(; pScore < pEnd; pScore++)\n";
+print OUTPUT "			pScores[pScore->uDescriptor] += pScore->dScore;\n";
+print OUTPUT "	}\n";
+print OUTPUT "}\n";
 print OUTPUT "\n";
 
 
@@ -801,6 +901,8 @@ print OUTPUT "	}\n";
 print OUTPUT "	retBuffer->dAccuracy = 0.0;\n";
 print OUTPUT "	\n";
 print OUTPUT "	int utf8 = utf8score((const unsigned char *)data);\n";
+print OUTPUT "	double scores[NUM_DESCRIPTORS];\n";
+print OUTPUT "	compute_descriptor_scores((const unsigned char *)data,scores);\n";
 if($debug > 0)
 {
 	print OUTPUT "	printf(\"UTF8 score: %d\\n\",utf8);\n";
@@ -811,7 +913,7 @@ print OUTPUT "	{\n";
 print OUTPUT "		bool bIsUtf8 = ((strcmp(all_descriptors[i]->szEncoding,\"utf8\") == 0) || (strcmp(all_descriptors[i]->szEncoding,\"utf-8\") == 0));\n";
 print OUTPUT "		if((!bIsUtf8) || (!(iFlags & DLE_STRICT_UTF8_CHECKING)))\n";
 print OUTPUT "		{\n";
-print OUTPUT "			double dThis = compute_descriptor_score((const unsigned char *)data,all_descriptors[i]);\n";
+print OUTPUT "			double dThis = scores[i];\n";
 if($debug > 0)
 {
 	print OUTPUT "			double dSave = dThis;\n";
@@ -51,68 +51,384 @@
 #include <QByteArray>
 #include <QMessageBox>
 
+#include <algorithm>
+#include <iterator>
+
 extern KviPointerList<ListWindow> * g_pListWindowList;
 
-ChannelTreeWidgetItemData::ChannelTreeWidgetItemData(const QString & szChan, const QString & szUsers, const QString & szTopic)
+ChannelListEntry::ChannelListEntry(const QString & szChan, const QString & szUsers, const QString & szTopic)
 {
 	m_szChan = szChan;
 	m_szUsers = szUsers;
 	m_szTopic = szTopic;
+	m_szStrippedTopic = KviControlCodes::stripControlBytes(szTopic);
+	m_szChanKey = szChan.toUpper();
+	m_szTopicKey = m_szStrippedTopic.toUpper();
+	m_iUsers = szUsers.toInt();
 }
 
-ChannelTreeWidgetItemData::~ChannelTreeWidgetItemData()
+ChannelListEntry::~ChannelListEntry()
     = default;
 
-ChannelTreeWidgetItem::ChannelTreeWidgetItem(ChannelTreeWidgetItemData * pData)
-    : QTreeWidgetItem(), m_pData(pData)
+// the search is case insensitive: the trigrams are lowercase
+static inline quint64 trigram_shift(quint64 uKey, QChar c)
 {
-	setToolTip(0, KviQString::toHtmlEscaped(m_pData->m_szChan));
-	setToolTip(1, KviQString::toHtmlEscaped(m_pData->m_szUsers));
-	setToolTip(2, KviHtmlGenerator::convertToHtml(KviQString::toHtmlEscaped(m_pData->m_szTopic)));
+	return ((uKey << 16) | c.toLower().unicode()) & 0xffffffffffffULL;
 }
 
-ChannelTreeWidgetItem::~ChannelTreeWidgetItem()
-    = default;
+void ChannelListIndex::clear()
+{
+	m_Postings.clear();
+}
+
+void ChannelListIndex::add(int iEntry, const QString & szText)
+{
+	const QChar * p = szText.unicode();
+	int iLen = szText.length();
+	quint64 uKey = 0;
+	for(int i = 0; i < iLen; i++)
+	{
+		uKey = trigram_shift(uKey, p[i]);
+		if(i < 2)
+			continue;
+		// the entries are added in order: a repeated trigram can only be at the back
+		std::vector<int> & l = m_Postings[uKey];
+		if(l.empty() || (l.back() != iEntry))
+			l.push_back(iEntry);
+	}
+}
+
+bool ChannelListIndex::candidates(const QString & szPattern, std::vector<int> & lCandidates) const
+{
+	lCandidates.clear();
+
+	std::vector<const std::vector<int> *> lLists;
+	const QChar * p = szPattern.unicode();
+	int iLen = szPattern.length();
+	quint64 uKey = 0;
+	int iRun = 0;
+	for(int i = 0; i < iLen; i++)
+	{
+		ushort c = p[i].unicode();
+		if(c == '[')
+			break; // a character set: the literals found so far are enough
+		if((c == '*') || (c == '?') || (c == '\\'))
+		{
+			iRun = 0;
+			continue;
+		}
+		uKey = trigram_shift(uKey, p[i]);
+		if(++iRun < 3)
+			continue;
+		auto it = m_Postings.find(uKey);
+		if(it == m_Postings.end())
+			return true; // nothing can match
+		lLists.push_back(&(it->second));
+	}
+
+	if(lLists.empty())
+		return false;
+
+	// start from the shortest list
+	std::sort(lLists.begin(), lLists.end(), [](const std::vector<int> * l1, const std::vector<int> * l2) { return l1->size() < l2->size(); });
+	lCandidates = *(lLists[0]);
+	std::vector<int> lTmp;
+	for(size_t i = 1; (i < lLists.size()) && !lCandidates.empty(); i++)
+	{
+		lTmp.clear();
+		std::set_intersection(lCandidates.begin(), lCandidates.end(), lLists[i]->begin(), lLists[i]->end(), std::back_inserter(lTmp));
+		lCandidates.swap(lTmp);
+	}
+	return true;
+}
+
+ChannelListModel::ChannelListModel(QObject * pParent)
+    : QAbstractTableModel(pParent), m_iSortColumn(0), m_eSortOrder(Qt::AscendingOrder)
+{
+}
+
+ChannelListModel::~ChannelListModel()
+{
+	for(auto e : m_Entries)
+		delete e;
+}
+
+int ChannelListModel::rowCount(const QModelIndex & parent) const
+{
+	return parent.isValid() ? 0 : (int)m_Rows.size();
+}
+
+int ChannelListModel::columnCount(const QModelIndex & parent) const
+{
+	return parent.isValid() ? 0 : 3;
+}
+
+QModelIndex ChannelListModel::index(int iRow, int iColumn, const QModelIndex & parent) const
+{
+	if(parent.isValid() || (iRow < 0) || (iRow >= (int)m_Rows.size()) || (iColumn < 0) || (iColumn >= 3))
+		return QModelIndex();
+	return createIndex(iRow, iColumn, m_Entries[m_Rows[iRow]]);
+}
+
+ChannelListEntry * ChannelListModel::entry(const QModelIndex & index) const
+{
+	if(!index.isValid())
+		return nullptr;
+	return static_cast<ChannelListEntry *>(index.internalPointer());
+}
+
+QVariant ChannelListModel::data(const QModelIndex & index, int iRole) const
+{
+	ChannelListEntry * e = entry(index);
+	if(!e)
+		return QVariant();
+
+	switch(iRole)
+	{
+		case Qt::DisplayRole:
+			switch(index.column())
+			{
+				case 0:
+					return e->m_szChan;
+				case 1:
+					return e->m_szUsers;
+				default:
+					return e->m_szStrippedTopic;
+			}
+			break;
+		case Qt::ToolTipRole:
+			// built on demand: most of the entries are never hovered
+			switch(index.column())
+			{
+				case 0:
+					return KviQString::toHtmlEscaped(e->m_szChan);
+				case 1:
+					return KviQString::toHtmlEscaped(e->m_szUsers);
+				default:
+					return KviHtmlGenerator::convertToHtml(KviQString::toHtmlEscaped(e->m_szTopic));
+			}
+			break;
+	}
+	return QVariant();
+}
+
+QVariant ChannelListModel::headerData(int iSection, Qt::Orientation eOrientation, int iRole) const
+{
+	if((eOrientation != Qt::Horizontal) || (iRole != Qt::DisplayRole))
+		return QVariant();
+
+	switch(iSection)
+	{
+		case 0:
+			return __tr2qs("Channel");
+		case 1:
+			return __tr2qs("Users");
+		case 2:
+			return __tr2qs("Topic");
+	}
+	return QVariant();
+}
 
-bool ChannelTreeWidgetItem::operator<(const QTreeWidgetItem & other) const
+bool ChannelListModel::lessThan(int iEntry1, int iEntry2) const
 {
-	switch(treeWidget()->sortColumn())
+	const ChannelListEntry * e1 = m_Entries[iEntry1];
+	const ChannelListEntry * e2 = m_Entries[iEntry2];
+
+	int iCmp;
+	switch(m_iSortColumn)
 	{
 		case 0:
 			//channel
-			return m_pData->m_szChan.toUpper() < ((ChannelTreeWidgetItem *)&other)->itemData()->m_szChan.toUpper();
+			iCmp = e1->m_szChanKey.compare(e2->m_szChanKey);
 			break;
 		case 1:
 			//users
-			return m_pData->m_szUsers.toInt() < ((ChannelTreeWidgetItem *)&other)->itemData()->m_szUsers.toInt();
+			iCmp = (e1->m_iUsers < e2->m_iUsers) ? -1 : ((e1->m_iUsers > e2->m_iUsers) ? 1 : 0);
 			break;
 		case 2:
 		default:
 			//topic
-			return KviControlCodes::stripControlBytes(m_pData->m_szTopic.toUpper()) < KviControlCodes::stripControlBytes(((ChannelTreeWidgetItem *)&other)->itemData()->m_szTopic.toUpper());
+			iCmp = e1->m_szTopicKey.compare(e2->m_szTopicKey);
 			break;
 	}
+
+	// a total order: the rows of the entries can be found by a binary search
+	if(iCmp == 0)
+		iCmp = iEntry1 - iEntry2;
+
+	return (m_eSortOrder == Qt::AscendingOrder) ? (iCmp < 0) : (iCmp > 0);
+}
+
+bool ChannelListModel::matches(const ChannelListEntry * e) const
+{
+	return e->m_szChan.contains(m_SearchRegExp) || e->m_szTopic.contains(m_SearchRegExp);
+}
+
+void ChannelListModel::reorder(const std::function<void()> & reorderRows)
+{
+	emit layoutAboutToBeChanged();
+
+	// remember the entries of the selection and of the current item
+	QModelIndexList lOld = persistentIndexList();
+	std::vector<int> lOldEntries;
+	lOldEntries.reserve(lOld.count());
+	for(auto & i : lOld)
+		lOldEntries.push_back(m_Rows[i.row()]);
+
+	reorderRows();
+
+	auto cmp = [this](int iEntry1, int iEntry2) { return lessThan(iEntry1, iEntry2); };
+	QModelIndexList lNew;
+	for(int i = 0; i < lOld.count(); i++)
+	{
+		int iRow = std::lower_bound(m_Rows.begin(), m_Rows.end(), lOldEntries[i], cmp) - m_Rows.begin();
+		lNew.append(index(iRow, lOld[i].column()));
+	}
+	changePersistentIndexList(lOld, lNew);
+
+	emit layoutChanged();
+}
+
+void ChannelListModel::sort(int iColumn, Qt::SortOrder eOrder)
+{
+	if((iColumn == m_iSortColumn) && (eOrder == m_eSortOrder))
+		return;
+
+	reorder([this, iColumn, eOrder]() {
+		m_iSortColumn = iColumn;
+		m_eSortOrder = eOrder;
+		auto cmp = [this](int iEntry1, int iEntry2) { return lessThan(iEntry1, iEntry2); };
+		std::sort(m_Sorted.begin(), m_Sorted.end(), cmp);
+		if(m_szSearch.isEmpty())
+			m_Rows = m_Sorted;
+		else
+			std::sort(m_Rows.begin(), m_Rows.end(), cmp);
+	});
+}
+
+void ChannelListModel::append(std::vector<ChannelListEntry *> & lEntries)
+{
+	if(lEntries.empty())
+		return;
+
+	std::vector<int> lNew;
+	lNew.reserve(lEntries.size());
+	for(auto e : lEntries)
+	{
+		int iEntry = (int)m_Entries.size();
+		m_Entries.push_back(e);
+		m_Index.add(iEntry, e->m_szChan);
+		m_Index.add(iEntry, e->m_szTopic);
+		lNew.push_back(iEntry);
+	}
+	lEntries.clear();
+
+	// sort the batch and merge it with the entries already sorted
+	auto cmp = [this](int iEntry1, int iEntry2) { return lessThan(iEntry1, iEntry2); };
+	std::sort(lNew.begin(), lNew.end(), cmp);
+	size_t uSorted = m_Sorted.size();
+	m_Sorted.insert(m_Sorted.end(), lNew.begin(), lNew.end());
+	std::inplace_merge(m_Sorted.begin(), m_Sorted.begin() + uSorted, m_Sorted.end(), cmp);
+
+	if(!m_szSearch.isEmpty())
+	{
+		std::vector<int> lMatching;
+		for(auto iEntry : lNew)
+		{
+			if(matches(m_Entries[iEntry]))
+				lMatching.push_back(iEntry);
+		}
+		lNew.swap(lMatching);
+		if(lNew.empty())
+			return;
+	}
+
+	// the new rows are appended and then moved to their place
+	int iRows = (int)m_Rows.size();
+	beginInsertRows(QModelIndex(), iRows, iRows + (int)lNew.size() - 1);
+	m_Rows.insert(m_Rows.end(), lNew.begin(), lNew.end());
+	endInsertRows();
+
+	if(iRows == 0)
+		return;
+
+	reorder([this, iRows, cmp]() {
+		std::inplace_merge(m_Rows.begin(), m_Rows.begin() + iRows, m_Rows.end(), cmp);
+	});
+}
+
+void ChannelListModel::clear()
+{
+	beginResetModel();
+	for(auto e : m_Entries)
+		delete e;
+	m_Entries.clear();
+	m_Sorted.clear();
+	m_Rows.clear();
+	m_Index.clear();
+	endResetModel();
+}
+
+void ChannelListModel::setSearch(const QString & szSearch)
+{
+	if(szSearch == m_szSearch)
+		return;
+
+	beginResetModel();
+
+	m_szSearch = szSearch;
+	m_SearchRegExp = QRegExp(szSearch, Qt::CaseInsensitive, QRegExp::Wildcard);
+
+	if(m_szSearch.isEmpty())
+	{
+		m_Rows = m_Sorted;
+	}
+	else
+	{
+		// test only the entries that contain the trigrams of the pattern
+		std::vector<char> lMatching(m_Entries.size(), 0);
+		std::vector<int> lCandidates;
+		if(m_Index.candidates(m_szSearch, lCandidates))
+		{
+			for(auto iEntry : lCandidates)
+				lMatching[iEntry] = matches(m_Entries[iEntry]);
+		}
+		else
+		{
+			for(size_t i = 0; i < m_Entries.size(); i++)
+				lMatching[i] = matches(m_Entries[i]);
+		}
+
+		m_Rows.clear();
+		for(auto iEntry : m_Sorted)
+		{
+			if(lMatching[iEntry])
+				m_Rows.push_back(iEntry);
+		}
+	}
+
+	endResetModel();
 }
 
-ChannelTreeWidgetItemDelegate::ChannelTreeWidgetItemDelegate(QTreeWidget * pWidget)
+ChannelListItemDelegate::ChannelListItemDelegate(QTreeView * pWidget)
     : QItemDelegate(pWidget)
 {
 }
 
-ChannelTreeWidgetItemDelegate::~ChannelTreeWidgetItemDelegate()
+ChannelListItemDelegate::~ChannelListItemDelegate()
     = default;
 
 #define BORDER 2
 
-QSize ChannelTreeWidgetItemDelegate::sizeHint(const QStyleOptionViewItem & sovItem, const QModelIndex & index) const
+QSize ChannelListItemDelegate::sizeHint(const QStyleOptionViewItem & sovItem, const QModelIndex & index) const
 {
-	ChannelTreeWidget * treeWidget = (ChannelTreeWidget *)parent();
+	QTreeView * treeView = (QTreeView *)parent();
 
-	int iHeight = treeWidget->fontMetrics().lineSpacing() + BORDER + BORDER;
+	int iHeight = treeView->fontMetrics().lineSpacing() + BORDER + BORDER;
 
-	ChannelTreeWidgetItem * item = dynamic_cast<ChannelTreeWidgetItem *>(treeWidget->itemFromIndex(index));
+	ChannelListEntry * e = static_cast<ChannelListEntry *>(index.internalPointer());
 
-	if(!item)
+	if(!e)
 		return QSize(100, iHeight);
 
 	QFontMetrics fm(sovItem.font);
@@ -120,27 +436,25 @@ QSize ChannelTreeWidgetItemDelegate::sizeHint(const QStyleOptionViewItem & sovIt
 	{
 		case 0:
 			//channel
-			return QSize(fm.width(item->itemData()->m_szChan), iHeight);
+			return QSize(fm.width(e->m_szChan), iHeight);
 			break;
 		case 1:
 			//users
-			return QSize(fm.width(item->itemData()->m_szUsers.toInt()), iHeight);
+			return QSize(fm.width(e->m_szUsers), iHeight);
 			break;
 		case 2:
 		default:
 			//topic
-			if(item->itemData()->m_szStrippedTopic.isEmpty())
-				item->itemData()->m_szStrippedTopic = KviControlCodes::stripControlBytes(item->itemData()->m_szTopic);
-			return QSize(fm.width(item->itemData()->m_szStrippedTopic), iHeight);
+			return QSize(fm.width(e->m_szStrippedTopic), iHeight);
 			break;
 	}
 	//make gcc happy
 	return QSize();
 }
 
-void ChannelTreeWidgetItemDelegate::paint(QPainter * p, const QStyleOptionViewItem & option, const QModelIndex & index) const
+void ChannelListItemDelegate::paint(QPainter * p, const QStyleOptionViewItem & option, const QModelIndex & index) const
 {
-	ChannelTreeWidgetItem * obj = static_cast<ChannelTreeWidgetItem *>(index.internalPointer());
+	ChannelListEntry * e = static_cast<ChannelListEntry *>(index.internalPointer());
 
 	if(option.state & QStyle::State_Selected)
 		p->fillRect(option.rect, option.palette.brush(QPalette::Highlight));
@@ -152,16 +466,16 @@ void ChannelTreeWidgetItemDelegate::paint(QPainter * p, const QStyleOptionViewIt
 	{
 		case 0:
 			//channel
-			p->drawText(option.rect, obj->itemData()->m_szChan);
+			p->drawText(option.rect, e->m_szChan);
 			break;
 		case 1:
 			//users
-			p->drawText(option.rect, Qt::AlignHCenter, obj->itemData()->m_szUsers);
+			p->drawText(option.rect, Qt::AlignHCenter, e->m_szUsers);
 			break;
 		case 2:
 		default:
 			//topic
-			KviTopicWidget::paintColoredText(p, obj->itemData()->m_szTopic, option.palette, option.rect);
+			KviTopicWidget::paintColoredText(p, e->m_szTopic, option.palette, option.rect);
 			break;
 	}
 }
@@ -173,9 +487,6 @@ ListWindow::ListWindow(KviConsoleWindow * lpConsole)
 
 	m_pFlushTimer = nullptr;
 
-	m_pItemList = new KviPointerList<ChannelTreeWidgetItemData>;
-	m_pItemList->setAutoDelete(false);
-
 	m_pSplitter = new KviTalSplitter(Qt::Horizontal, this);
 	m_pSplitter->setObjectName("splitter");
 	m_pSplitter->setChildrenCollapsible(false);
@@ -229,30 +540,26 @@ ListWindow::ListWindow(KviConsoleWindow * lpConsole)
 
 	m_pInfoLabel = new KviThemedLabel(m_pTopSplitter, this, "info_label");
 
-	m_pTreeWidget = new ChannelTreeWidget(m_pVertSplitter, this, "list_treewidget");
-	m_pTreeWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-	m_pTreeWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-	m_pTreeWidget->setItemDelegate(new ChannelTreeWidgetItemDelegate(m_pTreeWidget));
-	QStringList columnLabels;
-	columnLabels.append(__tr2qs("Channel"));
-	columnLabels.append(__tr2qs("Users"));
-	columnLabels.append(__tr2qs("Topic"));
-	m_pTreeWidget->setColumnCount(3);
-	m_pTreeWidget->setHeaderLabels(columnLabels);
-	m_pTreeWidget->setAllColumnsShowFocus(true);
-	m_pTreeWidget->setSortingEnabled(true);
-	m_pTreeWidget->sortItems(0, Qt::AscendingOrder);
-	m_pTreeWidget->setUniformRowHeights(true);
-
-	m_pTreeWidget->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-	m_pTreeWidget->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-	m_pTreeWidget->header()->setStretchLastSection(false);
-	m_pTreeWidget->header()->resizeSection(0, 150);
-	m_pTreeWidget->header()->resizeSection(1, 80);
-	m_pTreeWidget->header()->resizeSection(2, 450);
-	//m_pTreeWidget->header()->setResizeMode(QHeaderView::ResizeToContents); <-- this is too heavy for single-core machines...
-
-	connect(m_pTreeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem *, int)), this, SLOT(itemDoubleClicked(QTreeWidgetItem *, int)));
+	m_pTreeView = new KviThemedTreeView(m_pVertSplitter, this, "list_treewidget");
+	m_pModel = new ChannelListModel(m_pTreeView);
+	m_pTreeView->setModel(m_pModel);
+	m_pTreeView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	m_pTreeView->setSelectionMode(QAbstractItemView::SingleSelection);
+	m_pTreeView->setItemDelegate(new ChannelListItemDelegate(m_pTreeView));
+	m_pTreeView->setAllColumnsShowFocus(true);
+	m_pTreeView->setSortingEnabled(true);
+	m_pTreeView->sortByColumn(0, Qt::AscendingOrder);
+	m_pTreeView->setUniformRowHeights(true);
+
+	m_pTreeView->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+	m_pTreeView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+	m_pTreeView->header()->setStretchLastSection(false);
+	m_pTreeView->header()->resizeSection(0, 150);
+	m_pTreeView->header()->resizeSection(1, 80);
+	m_pTreeView->header()->resizeSection(2, 450);
+	//m_pTreeView->header()->setResizeMode(QHeaderView::ResizeToContents); <-- this is too heavy for single-core machines...
+
+	connect(m_pTreeView, SIGNAL(doubleClicked(const QModelIndex &)), this, SLOT(itemDoubleClicked(const QModelIndex &)));
 
 	m_pIrcView = new KviIrcView(m_pVertSplitter, this);
 
@@ -269,8 +576,8 @@ ListWindow::~ListWindow()
 
 	if(m_pFlushTimer)
 		delete m_pFlushTimer;
-	m_pItemList->setAutoDelete(true);
-	delete m_pItemList;
+	for(auto e : m_PendingEntries)
+		delete e;
 }
 
 void ListWindow::getBaseLogFileName(QString & szBuffer)
@@ -288,6 +595,7 @@ void ListWindow::requestList()
 		else
 		{
 			m_pParamsEdit->setText("");
+			m_pModel->setSearch(QString());
 			m_pConsole->connection()->sendFmtData("list %s", m_pConsole->connection()->encodeText(parms.ptr()).data());
 		}
 
@@ -359,7 +667,7 @@ void ListWindow::die()
 
 void ListWindow::exportList()
 {
-	if(!m_pTreeWidget->topLevelItemCount())
+	if(!m_pModel->entryCount())
 	{
 		QMessageBox::warning(nullptr, __tr2qs("Warning While Exporting - KVIrc"), __tr2qs("You can't export an empty list!"));
 		return;
@@ -400,14 +708,13 @@ void ListWindow::exportList()
 		KviConfigurationFile cfg(szFile, KviConfigurationFile::Write);
 		cfg.clear();
 
-		ChannelTreeWidgetItem * it;
-		for(int i = 0; i < m_pTreeWidget->topLevelItemCount(); i++)
+		for(int i = 0; i < m_pModel->entryCount(); i++)
 		{
-			it = (ChannelTreeWidgetItem *)m_pTreeWidget->topLevelItem(i);
-			cfg.setGroup(it->itemData()->m_szChan);
+			ChannelListEntry * e = m_pModel->sortedEntry(i);
+			cfg.setGroup(e->m_szChan);
 			// Write properties
-			cfg.writeEntry("topic", it->itemData()->m_szTopic);
-			cfg.writeEntry("users", it->itemData()->m_szUsers);
+			cfg.writeEntry("topic", e->m_szTopic);
+			cfg.writeEntry("users", e->m_szUsers);
 		}
 	}
 }
@@ -418,20 +725,15 @@ void ListWindow::importList()
 
 	if(KviFileDialog::askForOpenFileName(szFile, __tr2qs("Select a File - KVIrc"), QString(), KVI_FILTER_CONFIG, false, false, this))
 	{
-
-		m_pItemList->setAutoDelete(true);
-		m_pItemList->clear();
-		m_pItemList->setAutoDelete(false);
-
-		m_pTreeWidget->clear();
+		clearEntries();
 
 		KviConfigurationFile cfg(szFile, KviConfigurationFile::Read);
 		KviConfigurationFileIterator it(*cfg.dict());
 		while(it.current())
 		{
 			cfg.setGroup(it.currentKey());
-			m_pItemList->append(
-			    new ChannelTreeWidgetItemData(
+			m_PendingEntries.push_back(
+			    new ChannelListEntry(
 			        it.currentKey(),
 			        cfg.readEntry("users", "0"),
 			        cfg.readEntry("topic", "")));
@@ -476,32 +778,22 @@ void ListWindow::endOfList()
 
 void ListWindow::startOfList()
 {
-	m_pItemList->setAutoDelete(true);
-	m_pItemList->clear();
-	m_pItemList->setAutoDelete(false);
-
-	m_pTreeWidget->clear();
+	clearEntries();
 
 	m_pRequestButton->setEnabled(false);
 }
 
-void ListWindow::liveSearch(const QString & szText)
+void ListWindow::clearEntries()
 {
-	QRegExp res(szText, Qt::CaseInsensitive, QRegExp::Wildcard);
+	for(auto e : m_PendingEntries)
+		delete e;
+	m_PendingEntries.clear();
+	m_pModel->clear();
+}
 
-	ChannelTreeWidgetItem * pItem = nullptr;
-	for(int i = 0; i < m_pTreeWidget->topLevelItemCount(); i++)
-	{
-		pItem = (ChannelTreeWidgetItem *)m_pTreeWidget->topLevelItem(i);
-		if(pItem->itemData()->m_szChan.contains(res) || pItem->itemData()->m_szTopic.contains(res))
-		{
-			pItem->setHidden(false);
-		}
-		else
-		{
-			pItem->setHidden(true);
-		}
-	}
+void ListWindow::liveSearch(const QString & szText)
+{
+	m_pModel->setSearch(szText);
 }
 
 void ListWindow::processData(KviIrcMessage * pMsg)
@@ -514,29 +806,25 @@ void ListWindow::processData(KviIrcMessage * pMsg)
 		m_pRequestButton->setEnabled(false);
 	}
 
-	if(m_pParamsEdit->text().isEmpty())
-	{
-		m_pItemList->append(
-		    new ChannelTreeWidgetItemData(
-		        pMsg->connection()->decodeText(pMsg->safeParam(1)),
-		        pMsg->connection()->decodeText(pMsg->safeParam(2)),
-		        pMsg->connection()->decodeText(pMsg->safeTrailing())));
-	}
-	else
+	QString szChan = pMsg->connection()->decodeText(pMsg->safeParam(1));
+	QString szTopic = pMsg->connection()->decodeText(pMsg->safeTrailing());
+
+	bool bAccept = true;
+	QString szFilter = m_pParamsEdit->text();
+	if(!szFilter.isEmpty())
 	{
 		//rfc2812 permits wildcards here (section 3.2.6)
-		QRegExp res(m_pParamsEdit->text(), Qt::CaseInsensitive, QRegExp::Wildcard);
-		if(
-		    res.exactMatch(pMsg->connection()->decodeText(pMsg->safeParam(1))) || res.exactMatch(pMsg->connection()->decodeText(pMsg->safeTrailing())))
+		if(szFilter != m_szFilter)
 		{
-			m_pItemList->append(
-			    new ChannelTreeWidgetItemData(
-			        pMsg->connection()->decodeText(pMsg->safeParam(1)),
-			        pMsg->connection()->decodeText(pMsg->safeParam(2)),
-			        pMsg->connection()->decodeText(pMsg->safeTrailing())));
+			m_szFilter = szFilter;
+			m_FilterRegExp = QRegExp(szFilter, Qt::CaseInsensitive, QRegExp::Wildcard);
 		}
+		bAccept = m_FilterRegExp.exactMatch(szChan) || m_FilterRegExp.exactMatch(szTopic);
 	}
 
+	if(bAccept)
+		m_PendingEntries.push_back(new ChannelListEntry(szChan, pMsg->connection()->decodeText(pMsg->safeParam(2)), szTopic));
+
 	if(_OUTPUT_VERBOSE)
 	{
 		QString szTmp = pMsg->connection()->decodeText(pMsg->allParams());
@@ -546,27 +834,20 @@ void ListWindow::processData(KviIrcMessage * pMsg)
 
 void ListWindow::flush()
 {
-	m_pTreeWidget->setUpdatesEnabled(false); /* for v_scroolbar */
-	while(ChannelTreeWidgetItemData * d = m_pItemList->first())
-	{
-		// Model-View-Delegate-Crappiness...
-		//
-		// Don't use the constructor that takes QTreeWidget as parent
-		// as it will insert the item and call the delegate's sizeHint()
-		// function when the item is not yet fully constructed.
-
-		m_pTreeWidget->addTopLevelItem(new ChannelTreeWidgetItem(d));
-
-		m_pItemList->removeFirst();
-	}
-	m_pTreeWidget->setUpdatesEnabled(true);
-	m_pTreeWidget->resizeColumnToContents(2);
-	m_pTreeWidget->viewport()->update();
+	if(m_PendingEntries.empty())
+		return;
+	// a single insertion for the whole batch
+	m_pModel->append(m_PendingEntries);
+	m_pTreeView->resizeColumnToContents(2);
 }
 
-void ListWindow::itemDoubleClicked(QTreeWidgetItem * it, int)
+void ListWindow::itemDoubleClicked(const QModelIndex & index)
 {
-	QString szText = ((ChannelTreeWidgetItem *)it)->itemData()->m_szChan;
+	ChannelListEntry * e = m_pModel->entry(index);
+	if(!e)
+		return;
+
+	QString szText = e->m_szChan;
 
 	if(szText.isEmpty())
 		return;
@@ -582,7 +863,7 @@ void ListWindow::itemDoubleClicked(QTreeWidgetItem * it, int)
 
 void ListWindow::applyOptions()
 {
-	m_pTreeWidget->applyOptions();
+	m_pTreeView->applyOptions();
 	m_pIrcView->applyOptions();
 	m_pParamsEdit->applyOptions();
 	m_pInfoLabel->applyOptions();
@@ -31,67 +31,105 @@
 #include "KviIrcServerParser.h"
 #include "KviConsoleWindow.h"
 #include "KviIrcContext.h"
-#include "KviThemedTreeWidget.h"
+#include "KviThemedTreeView.h"
 
+#include <QAbstractTableModel>
 #include <QToolButton>
 #include <QLineEdit>
 #include <QItemDelegate>
 #include <QMenu>
+#include <QRegExp>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
 
 class KviThemedLabel;
 class KviThemedLineEdit;
 
-class ChannelTreeWidgetItemDelegate : public QItemDelegate
+class ChannelListItemDelegate : public QItemDelegate
 {
 public:
-	ChannelTreeWidgetItemDelegate(QTreeWidget * pWidget = 0);
-	~ChannelTreeWidgetItemDelegate();
+	ChannelListItemDelegate(QTreeView * pWidget = 0);
+	~ChannelListItemDelegate();
 	void paint(QPainter * pPainter, const QStyleOptionViewItem & option, const QModelIndex & index) const;
 	QSize sizeHint(const QStyleOptionViewItem & option, const QModelIndex & index) const;
 };
 
-class ChannelTreeWidgetItemData
+class ChannelListEntry
 {
-	friend class ChannelTreeWidgetItem;
+	friend class ChannelListModel;
 	friend class ListWindow;
-	friend class ChannelTreeWidgetItemDelegate;
+	friend class ChannelListItemDelegate;
 
 public:
-	ChannelTreeWidgetItemData(const QString & szChan, const QString & szUsers, const QString & szTopic);
-	~ChannelTreeWidgetItemData();
+	ChannelListEntry(const QString & szChan, const QString & szUsers, const QString & szTopic);
+	~ChannelListEntry();
 
 protected:
 	QString m_szChan;
 	QString m_szUsers;
 	QString m_szTopic;
 	QString m_szStrippedTopic;
+	// the sort keys, computed once
+	QString m_szChanKey;
+	QString m_szTopicKey;
+	int m_iUsers;
 };
 
-class ChannelTreeWidgetItem : public QTreeWidgetItem
+// The trigrams of the channel names and topics: the entries that match a
+// wildcard search contain all the trigrams of the literal parts of the pattern.
+class ChannelListIndex
 {
-	friend class ListWindow;
-
-public:
-	ChannelTreeWidgetItem(ChannelTreeWidgetItemData * pData);
-	~ChannelTreeWidgetItem();
-
-private:
-	ChannelTreeWidgetItemData * m_pData;
+protected:
+	std::unordered_map<quint64, std::vector<int>> m_Postings; // sorted entry numbers
 
 public:
-	bool operator<(const QTreeWidgetItem & other) const;
-	inline ChannelTreeWidgetItemData * itemData() { return m_pData; };
+	void clear();
+	void add(int iEntry, const QString & szText);
+	// returns false if the pattern has no literal part long enough to be looked up
+	bool candidates(const QString & szPattern, std::vector<int> & lCandidates) const;
 };
 
-class ChannelTreeWidget : public KviThemedTreeWidget
+class ChannelListModel : public QAbstractTableModel
 {
-	friend class ChannelTreeWidgetItem;
-	friend class ChannelTreeWidgetItemData;
 	Q_OBJECT
 public:
-	ChannelTreeWidget(QWidget * par, KviWindow * pWindow, const char * name) : KviThemedTreeWidget(par, pWindow, name){};
-	~ChannelTreeWidget(){};
-	ChannelTreeWidgetItem * itemFromIndex(const QModelIndex & index) const { return (ChannelTreeWidgetItem *)KviThemedTreeWidget::itemFromIndex(index); };
+	ChannelListModel(QObject * pParent);
+	~ChannelListModel();
+
+protected:
+	std::vector<ChannelListEntry *> m_Entries; // in arrival order
+	std::vector<int> m_Sorted;                 // all the entries, in sort order
+	std::vector<int> m_Rows;                   // the entries that match the search, in sort order
+	ChannelListIndex m_Index;
+	int m_iSortColumn;
+	Qt::SortOrder m_eSortOrder;
+	QString m_szSearch;
+	QRegExp m_SearchRegExp;
+
+public:
+	int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+	QModelIndex index(int iRow, int iColumn, const QModelIndex & parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex & index, int iRole) const override;
+	QVariant headerData(int iSection, Qt::Orientation eOrientation, int iRole) const override;
+	void sort(int iColumn, Qt::SortOrder eOrder) override;
+
+	ChannelListEntry * entry(const QModelIndex & index) const;
+	// all the entries, the ones hidden by the search included, in sort order
+	int entryCount() const { return (int)m_Sorted.size(); };
+	ChannelListEntry * sortedEntry(int iIdx) const { return m_Entries[m_Sorted[iIdx]]; };
+
+	// takes the ownership of the entries and empties lEntries
+	void append(std::vector<ChannelListEntry *> & lEntries);
+	void clear();
+	void setSearch(const QString & szSearch);
+
+protected:
+	bool lessThan(int iEntry1, int iEntry2) const;
+	bool matches(const ChannelListEntry * e) const;
+	void reorder(const std::function<void()> & reorderRows);
 };
 
 class ListWindow : public KviWindow, public KviExternalServerDataParser
@@ -104,7 +142,8 @@ public:
 protected:
 	QSplitter * m_pVertSplitter;
 	QSplitter * m_pTopSplitter;
-	ChannelTreeWidget * m_pTreeWidget;
+	KviThemedTreeView * m_pTreeView;
+	ChannelListModel * m_pModel;
 	KviThemedLineEdit * m_pParamsEdit;
 	QToolButton * m_pRequestButton;
 	QToolButton * m_pStopListDownloadButton;
@@ -112,7 +151,9 @@ protected:
 	QToolButton * m_pSaveButton;
 	KviThemedLabel * m_pInfoLabel;
 	QTimer * m_pFlushTimer;
-	KviPointerList<ChannelTreeWidgetItemData> * m_pItemList;
+	std::vector<ChannelListEntry *> m_PendingEntries;
+	QString m_szFilter;
+	QRegExp m_FilterRegExp;
 
 public: // Methods
 	virtual void control(int iMsg);
@@ -128,7 +169,7 @@ protected:
 	virtual void getBaseLogFileName(QString & szBuffer);
 protected slots:
 	void flush();
-	void itemDoubleClicked(QTreeWidgetItem * it, int);
+	void itemDoubleClicked(const QModelIndex & index);
 	void requestList();
 	void stoplistdownload();
 	void connectionStateChange();
@@ -140,6 +181,7 @@ private:
 	void reset();
 	void endOfList();
 	void startOfList();
+	void clearEntries();
 };
 
-#endif //_KVI_LISTWINDOW_H_
+#endif //_LISTWINDOW_H_
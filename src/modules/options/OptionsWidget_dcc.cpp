@@ -295,6 +295,27 @@ OptionsWidget_dccSendAdvanced::OptionsWidget_dccSendAdvanced(QWidget * parent)
 	                        "cause more disk activity.<br>"
 	                        "Reasonable values are from 512 to 4096 bytes.", "options"));
 
+	b = addBoolSelector(g, __tr2qs_ctx("Preallocate disk space for received files", "options"), KviOption_boolPreallocateDccRecvFiles);
+	mergeTip(b, __tr2qs_ctx("This option causes KVIrc to reserve the disk space for the whole file "
+	                        "when a DCC RECV starts. This reduces the file fragmentation and "
+	                        "makes the writes faster on most filesystems.<br>"
+	                        "It works only on systems that support it.", "options"));
+
+	b = addBoolSelector(g, __tr2qs_ctx("Verify the checksum of received files", "options"), KviOption_boolVerifyDccRecvDigests);
+	mergeTip(b, __tr2qs_ctx("This option causes KVIrc to compute the SHA-256 checksum of the received files "
+	                        "and to compare it with the one computed by the sender.<br>"
+	                        "This works only if the sender is also using KVIrc.", "options"));
+
+	u = addUIntSelector(g, __tr2qs_ctx("Parallel streams for large downloads:", "options"), KviOption_uintDccRecvParallelStreams, 1, 8, 1);
+	mergeTip(u, __tr2qs_ctx("When this is greater than 1, KVIrc asks the sender of a large file "
+	                        "to split it into parts that are downloaded at the same time on separate connections.<br>"
+	                        "This can speed up the transfers on links with a high latency.<br>"
+	                        "This works only if the sender is also using KVIrc.", "options"));
+
+	b = addBoolSelector(g, __tr2qs_ctx("Accept requests for parallel streams", "options"), KviOption_boolAcceptDccParallelStreamRequests);
+	mergeTip(b, __tr2qs_ctx("This option allows the KVIrc receivers of your files "
+	                        "to download them on multiple connections at the same time.", "options"));
+
 	addRowSpacer(0, 3, 0, 4);
 }
 
@@ -309,6 +330,7 @@ OptionsWidget_dccChat::OptionsWidget_dccChat(QWidget * parent)
 
 	KviBoolSelector * b1;
 	KviBoolSelector * b2;
+	KviUIntSelector * u;
 	KviTalGroupBox * g;
 
 	g = addGroupBox(0, 0, 0, 0, Qt::Horizontal, __tr2qs_ctx("On Chat Request", "options"));
@@ -339,7 +361,13 @@ OptionsWidget_dccChat::OptionsWidget_dccChat(QWidget * parent)
 	                         "in the low right corner of the screen when a new message is received "
 	                         "and the KVIrc window is not active.", "options"));
 
-	addRowSpacer(0, 4, 0, 4);
+	u = addUIntSelector(0, 4, 0, 4, __tr2qs_ctx("Maximum number of lines waiting to be shown:", "options"), KviOption_uintDccChatMaxBacklogLines, 16, 100000, 2000);
+	mergeTip(u, __tr2qs_ctx("This is the maximum number of received lines that can wait "
+	                        "to be shown in a DCC chat window.<br>"
+	                        "When the remote end sends text faster than it can be shown, "
+	                        "KVIrc stops reading from the connection until the window catches up.", "options"));
+
+	addRowSpacer(0, 5, 0, 5);
 }
 
 OptionsWidget_dccChat::~OptionsWidget_dccChat()
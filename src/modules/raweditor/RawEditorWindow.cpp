@@ -127,8 +127,10 @@ void RawEditorWidget::oneTimeSetup()
 			{
 				if(s->type() == KviKvsEventHandler::Script)
 				{
-					new RawHandlerTreeWidgetItem(it, ((KviKvsScriptEventHandler *)s)->name(),
+					RawHandlerTreeWidgetItem * ch = new RawHandlerTreeWidgetItem(it, ((KviKvsScriptEventHandler *)s)->name(),
 					    ((KviKvsScriptEventHandler *)s)->code(), ((KviKvsScriptEventHandler *)s)->isEnabled());
+					if(((KviKvsScriptEventHandler *)s)->filter())
+						ch->m_filter = *(((KviKvsScriptEventHandler *)s)->filter());
 				}
 			}
 			it->setExpanded(true);
@@ -309,6 +311,7 @@ void RawEditorWidget::commit()
 				    szContext,
 				    ((RawHandlerTreeWidgetItem *)ch)->m_szBuffer,
 				    ((RawHandlerTreeWidgetItem *)ch)->m_bEnabled);
+				s->setFilter(new KviKvsEventHandlerFilter(((RawHandlerTreeWidgetItem *)ch)->m_filter));
 
 				if(!KviKvsEventManager::instance()->addRawHandler(((RawTreeWidgetItem *)it)->m_iIdx, s))
 					delete s;
@@ -28,6 +28,7 @@
 #include "KviQString.h"
 #include <QTreeWidget>
 #include "KviIconManager.h"
+#include "KviKvsEventHandler.h"
 
 #include <QWidget>
 #include <QLineEdit>
@@ -89,6 +90,7 @@ public:
 	};
 	QString m_szBuffer;
 	bool m_bEnabled;
+	KviKvsEventHandlerFilter m_filter; // not editable here, but preserved on commit
 	void setName(const QString & szName);
 };
 
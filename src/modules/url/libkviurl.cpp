@@ -38,6 +38,7 @@
 #include "KviWindow.h"
 #include "KviOptions.h"
 #include "KviQString.h"
+#include "KviMultiStringMatcher.h"
 #include "kvi_out.h"
 
 #include <QFileDialog>
@@ -49,6 +50,10 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QMenu>
+#include <QLabel>
+#include <QBrush>
+
+#include <algorithm>
 
 #ifdef COMPILE_PSEUDO_TRANSPARENCY
 extern KVIRC_API QPixmap * g_pShadedChildGlobalDesktopBackground;
@@ -62,42 +67,196 @@ typedef struct _UrlDlgList
 
 const char * g_pUrlListFilename = "/list.kviurl";
 const char * g_pBanListFilename = "/list.kviban";
+const char * g_pUrlArchiveFilename = "/archive.kviurl";
 
-std::unordered_set<KviUrl *> g_List;
+UrlListModel * g_pUrlModel = nullptr;                         // the caught URLs
+KviPointerHashTable<QString, KviUrl> * g_pUrlDict = nullptr; // URL -> entry of g_pUrlModel
+std::unordered_set<uint> g_ArchivedUrls;                      // qHash() of the URLs in the archive file
 std::vector<UrlDlgList *> g_UrlDlgList;
 std::unordered_set<QString *> g_BanList;
+KviMultiStringMatcher * g_pBanMatcher = nullptr; // the entries of g_BanList, compiled
+bool g_bBanAll = false;                          // g_BanList has an empty entry: it matches every URL
 ConfigDialog * g_pConfigDialog;
 
+unsigned int g_uMaxUrlCount = 0; // 0 means no limit
+quint64 g_uUrlSerial = 0;        // incremented each time an URL is seen
+
 QString szConfigPath;
 
 void saveUrlList();
 void loadUrlList();
 void saveBanList();
 void loadBanList();
+void compileBanList();
+void addUrlToList(KviUrl * u);
+void removeUrlFromList(KviUrl * u);
+void clearUrlList();
+void limitUrlList();
+void loadUrlArchiveIndex();
+KviUrl * restoreArchivedUrl(const QString & szUrl);
 UrlDlgList * findFrame();
 void url_module_help();
 
 #define KVI_URL_EXTENSION_NAME "URL module extension"
 
-UrlDialogTreeWidget::UrlDialogTreeWidget(QWidget * par)
-    : QTreeWidget(par)
+// --------------------------- CLASS URLLISTMODEL ----------------------begin //
+
+UrlListModel::UrlListModel(QObject * pParent)
+    : QAbstractTableModel(pParent)
+{
+}
+
+UrlListModel::~UrlListModel()
+{
+	for(auto u : m_Rows)
+		delete u;
+}
+
+int UrlListModel::rowCount(const QModelIndex & parent) const
+{
+	return parent.isValid() ? 0 : (int)m_Rows.size();
+}
+
+int UrlListModel::columnCount(const QModelIndex & parent) const
+{
+	return parent.isValid() ? 0 : 4;
+}
+
+QModelIndex UrlListModel::index(int iRow, int iColumn, const QModelIndex & parent) const
+{
+	if(parent.isValid() || (iRow < 0) || (iRow >= (int)m_Rows.size()) || (iColumn < 0) || (iColumn >= 4))
+		return QModelIndex();
+	return createIndex(iRow, iColumn, m_Rows[iRow]);
+}
+
+KviUrl * UrlListModel::entry(const QModelIndex & index) const
+{
+	if(!index.isValid())
+		return nullptr;
+	return static_cast<KviUrl *>(index.internalPointer());
+}
+
+QVariant UrlListModel::data(const QModelIndex & index, int iRole) const
 {
+	KviUrl * u = entry(index);
+	if(!u)
+		return QVariant();
+
+	switch(iRole)
+	{
+		case Qt::DisplayRole:
+			switch(index.column())
+			{
+				case 0:
+					return u->url;
+				case 1:
+					return u->window;
+				case 2:
+					return u->count;
+				default:
+					return u->timestamp;
+			}
+			break;
+		case Qt::ForegroundRole:
+			return QBrush(KVI_OPTION_MIRCCOLOR(KVI_OPTION_MSGTYPE(index.column() == 0 ? KVI_OUT_URL : KVI_OUT_NONE).fore()));
+	}
+	return QVariant();
+}
+
+QVariant UrlListModel::headerData(int iSection, Qt::Orientation eOrientation, int iRole) const
+{
+	if((eOrientation != Qt::Horizontal) || (iRole != Qt::DisplayRole))
+		return QVariant();
+
+	switch(iSection)
+	{
+		case 0:
+			return __tr2qs("URL");
+		case 1:
+			return __tr2qs("Window");
+		case 2:
+			return __tr2qs("Count");
+		case 3:
+			return __tr2qs("Timestamp");
+	}
+	return QVariant();
 }
 
-void UrlDialogTreeWidget::mousePressEvent(QMouseEvent * e)
+void UrlListModel::append(KviUrl * u)
+{
+	int iRow = (int)m_Rows.size();
+	beginInsertRows(QModelIndex(), iRow, iRow);
+	u->row = iRow;
+	m_Rows.push_back(u);
+	endInsertRows();
+}
+
+void UrlListModel::update(KviUrl * u)
+{
+	emit dataChanged(index(u->row, 1), index(u->row, 2));
+}
+
+void UrlListModel::remove(KviUrl * u)
+{
+	int iRow = u->row;
+	beginRemoveRows(QModelIndex(), iRow, iRow);
+	m_Rows.erase(m_Rows.begin() + iRow);
+	for(int i = iRow; i < (int)m_Rows.size(); i++)
+		m_Rows[i]->row = i;
+	endRemoveRows();
+	delete u;
+}
+
+void UrlListModel::removeEntries(const std::vector<KviUrl *> & lRemove)
+{
+	beginResetModel();
+	for(auto u : lRemove)
+	{
+		m_Rows[u->row] = nullptr;
+		delete u;
+	}
+	int iRow = 0;
+	for(auto u : m_Rows)
+	{
+		if(!u)
+			continue;
+		u->row = iRow;
+		m_Rows[iRow++] = u;
+	}
+	m_Rows.resize(iRow);
+	endResetModel();
+}
+
+void UrlListModel::clear()
+{
+	beginResetModel();
+	for(auto u : m_Rows)
+		delete u;
+	m_Rows.clear();
+	endResetModel();
+}
+
+// --------------------------- CLASS URLLISTMODEL ------------------------end //
+
+UrlDialogTreeView::UrlDialogTreeView(QWidget * par)
+    : QTreeView(par)
+{
+}
+
+void UrlDialogTreeView::mousePressEvent(QMouseEvent * e)
 {
 	if(e->button() == Qt::RightButton)
 	{
-		QTreeWidgetItem * i = itemAt(e->pos());
-		if(i)
-			emit rightButtonPressed(i, QCursor::pos());
+		QModelIndex index = indexAt(e->pos());
+		if(index.isValid())
+			emit rightButtonPressed(index, QCursor::pos());
 		else
 			emit contextMenuRequested(QCursor::pos());
 	}
-	QTreeWidget::mousePressEvent(e);
+	QTreeView::mousePressEvent(e);
 }
 
-void UrlDialogTreeWidget::paintEvent(QPaintEvent * event)
+void UrlDialogTreeView::paintEvent(QPaintEvent * event)
 {
 	QPainter * p = new QPainter(viewport());
 	QStyleOptionViewItem option = viewOptions();
@@ -130,31 +289,29 @@ void UrlDialogTreeWidget::paintEvent(QPaintEvent * event)
 	delete p;
 
 	//call paint on all children
-	QTreeWidget::paintEvent(event);
+	QTreeView::paintEvent(event);
 }
 
 // ---------------------------- CLASS URLDIALOG ------------------------begin //
 
-UrlDialog::UrlDialog(std::unordered_set<KviUrl *>)
+UrlDialog::UrlDialog()
     : KviWindow(KviWindow::Tool, "URL List")
 {
 	setAutoFillBackground(false);
 
-	m_pUrlList = new UrlDialogTreeWidget(this);
+	m_pUrlList = new UrlDialogTreeView(this);
+	m_pUrlList->setModel(g_pUrlModel);
+	m_pUrlList->setRootIsDecorated(false);
+	m_pUrlList->setUniformRowHeights(true);
 
 	m_pMenuBar = new KviTalMenuBar(this, "URL menu");
 
 	KviConfigurationFile cfg(szConfigPath, KviConfigurationFile::Read);
 
 	m_pUrlList->header()->setSortIndicatorShown(true);
-	m_pUrlList->setColumnCount(4);
-
-	QStringList labels;
-	labels << __tr2qs("URL") << __tr2qs("Window") << __tr2qs("Count") << __tr2qs("Timestamp");
-	m_pUrlList->setHeaderLabels(labels);
 
-	connect(m_pUrlList, SIGNAL(itemDoubleClicked(QTreeWidgetItem *, int)), SLOT(dblclk_url(QTreeWidgetItem *, int)));
-	connect(m_pUrlList, SIGNAL(rightButtonPressed(QTreeWidgetItem *, const QPoint &)), SLOT(popup(QTreeWidgetItem *, const QPoint &)));
+	connect(m_pUrlList, SIGNAL(doubleClicked(const QModelIndex &)), SLOT(dblclk_url(const QModelIndex &)));
+	connect(m_pUrlList, SIGNAL(rightButtonPressed(const QModelIndex &, QPoint)), SLOT(popup(const QModelIndex &, const QPoint &)));
 	connect(m_pUrlList, SIGNAL(contextMenuRequested(const QPoint &)), SLOT(contextMenu(const QPoint &)));
 	m_pUrlList->setFocusPolicy(Qt::StrongFocus);
 	m_pUrlList->setFocus();
@@ -178,16 +335,12 @@ void UrlDialog::saveList()
 void UrlDialog::loadList()
 {
 	loadUrlList();
+	resizeColumns();
 }
 
 void UrlDialog::clear()
 {
-	g_List.clear();
-	for(auto & tmpitem : g_UrlDlgList)
-	{
-		if(tmpitem->dlg)
-			tmpitem->dlg->m_pUrlList->clear();
-	}
+	clearUrlList();
 }
 
 void UrlDialog::close_slot()
@@ -197,39 +350,39 @@ void UrlDialog::close_slot()
 
 void UrlDialog::remove()
 {
-	if(!m_pUrlList->currentItem())
+	KviUrl * u = g_pUrlModel->entry(m_pUrlList->currentIndex());
+	if(!u)
 	{
 		QMessageBox::warning(nullptr, __tr2qs("Entry Selection - KVIrc"), __tr2qs("Must select a URL entry from the list to remove it."), QMessageBox::Ok, QMessageBox::NoButton, QMessageBox::NoButton);
 		return;
 	}
 
-	for(auto & tmp : g_List)
-	{
-		if(tmp->url == m_pUrlList->currentItem()->text(0))
-		{
-			g_List.erase(tmp);
-			delete m_pUrlList->currentItem();
-			return;
-		}
-	}
+	removeUrlFromList(u);
 }
 
 void UrlDialog::findtext()
 {
 }
 
-void UrlDialog::dblclk_url(QTreeWidgetItem * item, int)
+void UrlDialog::dblclk_url(const QModelIndex & index)
 {
+	KviUrl * u = g_pUrlModel->entry(index);
+	if(!u)
+		return;
 	QString cmd = "openurl ";
-	QString szUrl = item->text(0);
+	QString szUrl = u->url;
 	KviQString::escapeKvs(&szUrl);
 	cmd.append(szUrl);
 	KviKvsScript::run(cmd, this);
 }
 
-void UrlDialog::popup(QTreeWidgetItem * item, const QPoint & point)
+void UrlDialog::popup(const QModelIndex & index, const QPoint & point)
 {
-	m_szUrl = item->text(0);
+	KviUrl * u = g_pUrlModel->entry(index);
+	if(!u)
+		return;
+	m_szUrl = u->url;
+	m_pUrlList->setCurrentIndex(index); // the one that "Remove" acts on
 	QMenu p("menu", nullptr);
 	p.addAction(__tr2qs("&Remove"), this, SLOT(remove()));
 
@@ -279,24 +432,10 @@ QPixmap * UrlDialog::myIconPtr()
 	return g_pIconManager->getSmallIcon(KviIconManager::Url);
 }
 
-void UrlDialog::addUrl(QString url, QString window, QString count, QString timestamp)
+void UrlDialog::resizeColumns()
 {
-	QTreeWidgetItem * UrlItem = new QTreeWidgetItem(m_pUrlList);
-
-	UrlItem->setText(0, url);
-	UrlItem->setText(1, window);
-	UrlItem->setText(2, count);
-	UrlItem->setText(3, timestamp);
-
-	UrlItem->setForeground(0, KVI_OPTION_MIRCCOLOR(KVI_OPTION_MSGTYPE(KVI_OUT_URL).fore()));
-	UrlItem->setForeground(1, KVI_OPTION_MIRCCOLOR(KVI_OPTION_MSGTYPE(KVI_OUT_NONE).fore()));
-	UrlItem->setForeground(2, KVI_OPTION_MIRCCOLOR(KVI_OPTION_MSGTYPE(KVI_OUT_NONE).fore()));
-	UrlItem->setForeground(3, KVI_OPTION_MIRCCOLOR(KVI_OPTION_MSGTYPE(KVI_OUT_NONE).fore()));
-
-	m_pUrlList->resizeColumnToContents(0);
-	m_pUrlList->resizeColumnToContents(3);
-	m_pUrlList->resizeColumnToContents(2);
-	m_pUrlList->resizeColumnToContents(1);
+	for(int i = 0; i < 4; i++)
+		m_pUrlList->resizeColumnToContents(i);
 }
 
 void UrlDialog::resizeEvent(QResizeEvent *)
@@ -308,7 +447,6 @@ void UrlDialog::resizeEvent(QResizeEvent *)
 
 UrlDialog::~UrlDialog()
 {
-
 	delete m_pUrlList;
 	UrlDlgList * tmpitem = findFrame();
 	tmpitem->dlg = nullptr;
@@ -336,6 +474,15 @@ ConfigDialog::ConfigDialog()
 	cb[1]->setChecked(cfg->readBoolEntry("SaveColumnWidthOnClose", false));
 	g->addWidget(cb[1], 1, 0, 1, 2);
 
+	QLabel * l = new QLabel(__tr2qs("Maximum number of URLs to keep in the list:"), this);
+	g->addWidget(l, 2, 0);
+	m_pMaxUrlCount = new QSpinBox(this);
+	m_pMaxUrlCount->setRange(0, 1000000);
+	m_pMaxUrlCount->setSpecialValueText(__tr2qs("Unlimited"));
+	m_pMaxUrlCount->setValue(cfg->readUIntEntry("MaxUrlCount", 0));
+	m_pMaxUrlCount->setToolTip(__tr2qs("When the list is full the URLs that haven't been seen for the longest time are moved to an archive file."));
+	g->addWidget(m_pMaxUrlCount, 2, 1);
+
 	bool tmp = cfg->readBoolEntry("BanEnabled", false);
 	delete cfg;
 
@@ -374,8 +521,12 @@ void ConfigDialog::acceptbtn()
 
 	cfg->writeEntry("SaveUrlListOnUnload", cb[0]->isChecked());
 	cfg->writeEntry("SaveColumnWidthOnClose", cb[1]->isChecked());
+	g_uMaxUrlCount = m_pMaxUrlCount->value();
+	cfg->writeEntry("MaxUrlCount", g_uMaxUrlCount);
 	delete cfg;
 
+	limitUrlList();
+
 	delete this;
 }
 
@@ -448,6 +599,7 @@ void BanFrame::addBan()
 		QString * pText = new QString(std::move(text));
 		g_BanList.insert(pText);
 		m_pBanList->addItem(*pText);
+		compileBanList();
 	}
 }
 
@@ -467,7 +619,9 @@ void BanFrame::removeBan()
 		if(tmp->compare(item) == 0)
 		{
 			g_BanList.erase(tmp);
+			delete tmp;
 			delete m_pBanList->currentItem();
+			compileBanList();
 			return;
 		}
 	}
@@ -498,9 +652,9 @@ void saveUrlList()
 
 	QTextStream stream(&file);
 
-	stream << g_List.size() << endl;
+	stream << g_pUrlModel->entries().size() << endl;
 
-	for(auto tmp : g_List)
+	for(auto tmp : g_pUrlModel->entries())
 	{
 		stream << tmp->url << endl;
 		stream << tmp->window << endl;
@@ -523,13 +677,8 @@ void loadUrlList()
 
 	QTextStream stream(&file);
 
-	g_List.clear();
+	clearUrlList();
 
-	for(auto tmpitem : g_UrlDlgList)
-	{
-		if(tmpitem->dlg)
-			tmpitem->dlg->m_pUrlList->clear();
-	}
 	KviUrl * tmp;
 	int i = 0;
 	int num = stream.readLine().toInt();
@@ -541,20 +690,15 @@ void loadUrlList()
 		tmp->count = stream.readLine().toInt();
 		tmp->timestamp = stream.readLine();
 
-		g_List.insert(tmp);
-
-		for(auto tmpitem : g_UrlDlgList)
-		{
-			if(tmpitem->dlg)
-			{
-				QString tmpCount;
-				tmpCount.setNum(tmp->count);
-				tmpitem->dlg->addUrl(QString(tmp->url), QString(tmp->window), tmpCount, QString(tmp->timestamp));
-			}
-		}
+		if(g_pUrlDict->find(tmp->url))
+			delete tmp; // duplicate entry
+		else
+			addUrlToList(tmp);
 		i++;
 	}
 	file.close();
+
+	limitUrlList();
 }
 
 void saveBanList()
@@ -589,6 +733,8 @@ void loadBanList()
 
 	QTextStream stream(&file);
 
+	for(auto tmp : g_BanList)
+		delete tmp;
 	g_BanList.clear();
 
 	int i = 0;
@@ -600,6 +746,159 @@ void loadBanList()
 		i++;
 	}
 	file.close();
+
+	compileBanList();
+}
+
+void compileBanList()
+{
+	// The matcher skips the empty patterns, but an empty ban has always
+	// matched every URL (indexOf() finds an empty string anywhere)
+	g_bBanAll = false;
+	g_pBanMatcher->clear();
+	for(auto tmp : g_BanList)
+	{
+		if(tmp->isEmpty())
+			g_bBanAll = true;
+		else
+			g_pBanMatcher->addPattern(*tmp);
+	}
+	g_pBanMatcher->compile();
+}
+
+void addUrlToList(KviUrl * u)
+{
+	u->lastSeen = ++g_uUrlSerial;
+	g_pUrlDict->replace(u->url, u);
+	g_pUrlModel->append(u);
+}
+
+void removeUrlFromList(KviUrl * u)
+{
+	g_pUrlDict->remove(u->url);
+	g_pUrlModel->remove(u); // this one deletes the entry
+}
+
+void clearUrlList()
+{
+	g_pUrlDict->clear();
+	g_pUrlModel->clear();
+}
+
+// Keeps the list within g_uMaxUrlCount entries: the URLs that haven't been
+// seen for the longest time are appended to the archive file. A tenth of the
+// list goes away at once so the list isn't scanned again at the next URL.
+void limitUrlList()
+{
+	if((g_uMaxUrlCount == 0) || (g_pUrlModel->entries().size() <= g_uMaxUrlCount))
+		return;
+
+	std::vector<KviUrl *> lUrls(g_pUrlModel->entries());
+	size_t uKeep = g_uMaxUrlCount - g_uMaxUrlCount / 10;
+	size_t uEvict = lUrls.size() - uKeep;
+	std::nth_element(lUrls.begin(), lUrls.begin() + uEvict, lUrls.end(),
+	    [](KviUrl * a, KviUrl * b) { return a->lastSeen < b->lastSeen; });
+	std::sort(lUrls.begin(), lUrls.begin() + uEvict,
+	    [](KviUrl * a, KviUrl * b) { return a->lastSeen < b->lastSeen; });
+
+	QString archive;
+	g_pApp->getLocalKvircDirectory(archive, KviApplication::ConfigPlugins);
+	archive += g_pUrlArchiveFilename;
+	QFile file;
+	file.setFileName(archive);
+	if(file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		QTextStream stream(&file);
+		for(size_t i = 0; i < uEvict; i++)
+		{
+			stream << lUrls[i]->url << endl;
+			stream << lUrls[i]->window << endl;
+			stream << lUrls[i]->count << endl;
+			stream << lUrls[i]->timestamp << endl;
+		}
+		file.flush();
+		file.close();
+	}
+
+	lUrls.resize(uEvict);
+	for(auto u : lUrls)
+	{
+		g_ArchivedUrls.insert(qHash(u->url));
+		g_pUrlDict->remove(u->url);
+	}
+	g_pUrlModel->removeEntries(lUrls);
+}
+
+// The archive file is never loaded as a whole: only the hashes of its URLs
+// are kept in memory, so that an archived URL that shows up again can be
+// looked up there and put back into the list with its count.
+void loadUrlArchiveIndex()
+{
+	g_ArchivedUrls.clear();
+
+	QString archive;
+	g_pApp->getLocalKvircDirectory(archive, KviApplication::ConfigPlugins);
+	archive += g_pUrlArchiveFilename;
+	QFile file;
+	file.setFileName(archive);
+	if(!file.open(QIODevice::ReadOnly))
+		return;
+
+	QTextStream stream(&file);
+	while(!stream.atEnd())
+	{
+		g_ArchivedUrls.insert(qHash(stream.readLine()));
+		// skip the window, the count and the timestamp
+		stream.readLine();
+		stream.readLine();
+		stream.readLine();
+	}
+	file.close();
+}
+
+// Returns the archived entry of szUrl, back in the list, or nullptr if the URL
+// has never been archived. An URL can be archived more than once: the last
+// record is the most recent one.
+KviUrl * restoreArchivedUrl(const QString & szUrl)
+{
+	auto it = g_ArchivedUrls.find(qHash(szUrl));
+	if(it == g_ArchivedUrls.end())
+		return nullptr;
+
+	QString archive;
+	g_pApp->getLocalKvircDirectory(archive, KviApplication::ConfigPlugins);
+	archive += g_pUrlArchiveFilename;
+	QFile file;
+	file.setFileName(archive);
+	if(!file.open(QIODevice::ReadOnly))
+		return nullptr;
+
+	KviUrl * u = nullptr;
+	QTextStream stream(&file);
+	while(!stream.atEnd())
+	{
+		QString szRecordUrl = stream.readLine();
+		QString szWindow = stream.readLine();
+		QString szCount = stream.readLine();
+		QString szTimestamp = stream.readLine();
+		if(szRecordUrl != szUrl)
+			continue;
+		if(!u)
+			u = new KviUrl();
+		u->url = szRecordUrl;
+		u->window = szWindow;
+		u->count = szCount.toInt();
+		u->timestamp = szTimestamp;
+	}
+	file.close();
+
+	if(!u)
+		return nullptr; // another URL with the same hash
+
+	g_ArchivedUrls.erase(it);
+	addUrlToList(u);
+	limitUrlList(); // u is the most recently seen entry: it stays
+	return u;
 }
 
 /*
@@ -636,15 +935,9 @@ static bool url_kvs_cmd_list(KviKvsModuleCommandCall *)
 		return false;
 	}
 
-	tmpitem->dlg = new UrlDialog(g_List);
+	tmpitem->dlg = new UrlDialog();
 	g_pMainWindow->addWindow(tmpitem->dlg);
-
-	for(auto tmp : g_List)
-	{
-		QString tmpCount;
-		tmpCount.setNum(tmp->count);
-		tmpitem->dlg->addUrl(QString(tmp->url), QString(tmp->window), tmpCount, QString(tmp->timestamp));
-	}
+	tmpitem->dlg->resizeColumns();
 	return true;
 }
 
@@ -679,7 +972,11 @@ UrlDlgList * findFrame()
 		[big]Configure dialog options:[/big]
 		There is also a ban list widget, which allows to have a list of words that plugin must not catch.[br][br]
 		[i]e.g. if the word "ftp" is inserted in the ban list and if in a window there is an output like "ftp.kvirc.net",
-		the URL will not be caught.[/i]
+		the URL will not be caught.[/i][br]
+		An empty entry in the ban list (it can only come from a hand edited [i]list.kviban[/i]) bans every URL.[br][br]
+		The number of URLs kept in the list can be limited: when the limit is reached the URLs
+		that haven't been seen for the longest time are appended to [i]archive.kviurl[/i] in the plugins configuration directory.
+		When an archived URL is shown again it is looked up in the archive and put back into the list with its count.
 */
 
 static bool url_kvs_cmd_config(KviKvsModuleCommandCall *)
@@ -691,47 +988,23 @@ static bool url_kvs_cmd_config(KviKvsModuleCommandCall *)
 
 int check_url(KviWindow * w, const QString & szUrl) // return 0 if no occurrence of the URL were found
 {
-	int tmp = 0;
+	// banned urls count as already seen
+	if(g_bBanAll || (g_pBanMatcher->match(szUrl) >= 0))
+		return 1;
 
-	for(auto tmpi : g_BanList)
+	KviUrl * u = g_pUrlDict->find(szUrl);
+	if(!u)
 	{
-		if(szUrl.indexOf(*tmpi, Qt::CaseInsensitive) != -1)
-			tmp++;
+		u = restoreArchivedUrl(szUrl);
+		if(!u)
+			return 0;
 	}
-	if(tmp > 0)
-		return tmp;
 
-	for(auto u : g_List)
-	{
-		if(u->url == szUrl)
-		{
-			u->window = w->plainTextCaption();
-			u->count++;
-			tmp++;
-		}
-	}
-
-	for(auto tmpitem : g_UrlDlgList)
-	{
-		if(tmpitem->dlg)
-		{
-			int count = tmpitem->dlg->m_pUrlList->topLevelItemCount();
-			for(int i = 0; i < count; i++)
-			{
-				QTreeWidgetItem * it = tmpitem->dlg->m_pUrlList->topLevelItem(i);
-				if(it->text(0) == szUrl)
-				{
-					int tmpCount = it->text(2).toInt();
-					tmpCount++;
-					QString tmpStr;
-					tmpStr.setNum(tmpCount);
-					it->setText(2, tmpStr);
-					it->setText(1, w->plainTextCaption());
-				}
-			}
-		}
-	}
-	return tmp;
+	u->window = w->plainTextCaption();
+	u->count++;
+	u->lastSeen = ++g_uUrlSerial;
+	g_pUrlModel->update(u);
+	return 1;
 }
 
 bool urllist_module_event_onUrl(KviKvsModuleEventCall * c)
@@ -756,17 +1029,14 @@ bool urllist_module_event_onUrl(KviKvsModuleEventCall * c)
 		tmp->count = 1;
 		tmp->timestamp = tmpTimestamp;
 
-		g_List.insert(tmp);
+		addUrlToList(tmp);
 		for(auto tmpitem : g_UrlDlgList)
 		{
 			if(tmpitem->dlg)
-			{
-				QString tmpCount;
-				tmpCount.setNum(tmp->count);
-				tmpitem->dlg->addUrl(QString(tmp->url), QString(tmp->window), tmpCount, QString(tmp->timestamp));
 				tmpitem->dlg->windowListItem()->highlight(false);
-			}
 		}
+
+		limitUrlList();
 	}
 	return true;
 }
@@ -793,7 +1063,18 @@ static bool url_module_init(KviModule * m)
 
 	g_pApp->getLocalKvircDirectory(szConfigPath, KviApplication::ConfigPlugins, "url.conf");
 
+	g_pUrlModel = new UrlListModel(nullptr);
+	g_pUrlDict = new KviPointerHashTable<QString, KviUrl>(127, true);
+	g_pUrlDict->setAutoDelete(false);
+	g_pBanMatcher = new KviMultiStringMatcher();
+	g_pBanMatcher->setCaseSensitivity(Qt::CaseInsensitive);
+
+	KviConfigurationFile cfg(szConfigPath, KviConfigurationFile::Read);
+	cfg.setGroup("ConfigDialog");
+	g_uMaxUrlCount = cfg.readUIntEntry("MaxUrlCount", 0);
+
 	loadUrlList();
+	loadUrlArchiveIndex();
 	loadBanList();
 
 	UrlDlgList * udl = new UrlDlgList();
@@ -815,8 +1096,17 @@ static bool url_module_cleanup(KviModule *)
 			tmpitem->dlg->close();
 	}
 
-	g_List.clear();
+	clearUrlList();
+	delete g_pUrlDict;
+	g_pUrlDict = nullptr;
+	delete g_pUrlModel;
+	g_pUrlModel = nullptr;
+	g_ArchivedUrls.clear();
+	for(auto tmp : g_BanList)
+		delete tmp;
 	g_BanList.clear();
+	delete g_pBanMatcher;
+	g_pBanMatcher = nullptr;
 	g_UrlDlgList.clear();
 
 	return true;
@@ -31,7 +31,9 @@
 #include "KviTalMenuBar.h"
 #include "KviMexToolBar.h"
 #include "KviKvsAction.h"
-#include <QTreeWidget>
+#include "KviPointerHashTable.h"
+#include <QTreeView>
+#include <QAbstractTableModel>
 
 #include <QDialog>
 #include <QLayout>
@@ -44,6 +46,7 @@
 #include <QPixmap>
 #include <QCheckBox>
 #include <QListWidget>
+#include <QSpinBox>
 
 #include <unordered_set>
 #include <vector>
@@ -54,20 +57,55 @@ typedef struct _KviUrl
 	QString window;
 	int count;
 	QString timestamp;
+	quint64 lastSeen; // used to find the least recently seen URLs
+	int row;          // in the UrlListModel
 } KviUrl;
 
-class UrlDialogTreeWidget : public QTreeWidget
+// The caught URLs, in the order they were caught: owns the entries.
+// The entries know their row, so an update touches only that row.
+class UrlListModel : public QAbstractTableModel
 {
 	Q_OBJECT
 public:
-	UrlDialogTreeWidget(QWidget *);
-	~UrlDialogTreeWidget(){};
+	UrlListModel(QObject * pParent);
+	~UrlListModel();
+
+protected:
+	std::vector<KviUrl *> m_Rows;
+
+public:
+	int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+	QModelIndex index(int iRow, int iColumn, const QModelIndex & parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex & index, int iRole) const override;
+	QVariant headerData(int iSection, Qt::Orientation eOrientation, int iRole) const override;
+
+	KviUrl * entry(const QModelIndex & index) const;
+	const std::vector<KviUrl *> & entries() const { return m_Rows; };
+
+	// takes the ownership of the entry
+	void append(KviUrl * u);
+	// the window and the count of the entry have changed
+	void update(KviUrl * u);
+	// deletes the entry
+	void remove(KviUrl * u);
+	// deletes the entries of lRemove with a single reset of the views
+	void removeEntries(const std::vector<KviUrl *> & lRemove);
+	void clear();
+};
+
+class UrlDialogTreeView : public QTreeView
+{
+	Q_OBJECT
+public:
+	UrlDialogTreeView(QWidget *);
+	~UrlDialogTreeView(){};
 
 protected:
 	void mousePressEvent(QMouseEvent * e);
 	void paintEvent(QPaintEvent * event);
 signals:
-	void rightButtonPressed(QTreeWidgetItem *, QPoint);
+	void rightButtonPressed(const QModelIndex &, QPoint);
 	void contextMenuRequested(QPoint);
 };
 
@@ -75,7 +113,7 @@ class UrlDialog : public KviWindow
 {
 	Q_OBJECT
 public:
-	UrlDialog(std::unordered_set<KviUrl *> g_List);
+	UrlDialog();
 	~UrlDialog();
 
 private:
@@ -87,8 +125,8 @@ protected:
 	void resizeEvent(QResizeEvent *);
 
 public:
-	UrlDialogTreeWidget * m_pUrlList;
-	void addUrl(QString url, QString window, QString count, QString timestamp);
+	UrlDialogTreeView * m_pUrlList;
+	void resizeColumns();
 	//	void saveProperties();
 protected slots:
 	void config();
@@ -99,8 +137,8 @@ protected slots:
 	void close_slot();
 	void remove();
 	void findtext();
-	void dblclk_url(QTreeWidgetItem * item, int);
-	void popup(QTreeWidgetItem * item, const QPoint & p);
+	void dblclk_url(const QModelIndex & index);
+	void popup(const QModelIndex & index, const QPoint & p);
 	void contextMenu(const QPoint & p);
 	void sayToWin(QAction * act);
 };
@@ -135,6 +173,7 @@ public:
 
 private:
 	QCheckBox * cb[cbnum];
+	QSpinBox * m_pMaxUrlCount;
 	BanFrame * m_pBanFrame;
 	void closeEvent(QCloseEvent *);
 protected slots:
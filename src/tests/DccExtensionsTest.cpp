@@ -0,0 +1,159 @@
+//=============================================================================
+//
+//   File : DccExtensionsTest.cpp
+//   Creation date : Sun 18 Oct 2026 19:58:31 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// Feeds the argument parsers of DCC SEGMENTS, DCC SEGMENT and DCC DIGEST
+// with well formed and malformed arguments.
+// The program prints each failing case and fails if there is any.
+//
+
+#include "DccExtensions.h"
+
+#include <stdio.h>
+
+#define SHA256_LOWER "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08"
+#define SHA256_UPPER "9F86D081884C7D659A2FEAA0C55AD015A3BF4F1B2B0B822CD15D6C15B0F00A08"
+
+struct CountCase
+{
+	const char * szCount;
+	bool bValid;
+	unsigned int uCount;
+};
+
+static const CountCase g_countCases[] = {
+	{ "", false, 0 },
+	{ "abc", false, 0 },
+	{ "-1", false, 0 },
+	{ "+3", false, 0 },
+	{ " 3", false, 0 },
+	{ "3 ", false, 0 },
+	{ "3x", false, 0 },
+	{ "0", false, 0 },
+	{ "1", false, 0 },
+	{ "2", true, 2 },
+	{ "8", true, 8 },
+	{ "0008", true, 8 },
+	{ "4294967295", true, 4294967295u },
+	{ "4294967296", false, 0 },
+	{ "4294967298", false, 0 }, // would be truncated to 2 by toUInt()
+	{ "99999999999999999999999", false, 0 }
+};
+
+struct RangeCase
+{
+	const char * szStart;
+	const char * szEnd;
+	bool bValid;
+	quint64 uStart;
+	quint64 uEnd;
+};
+
+static const RangeCase g_rangeCases[] = {
+	{ "0", "1", true, 0, 1 },
+	{ "1048576", "2097152", true, 1048576, 2097152 },
+	{ "4294967296", "8589934592", true, 4294967296ull, 8589934592ull },
+	{ "0", "18446744073709551615", true, 0, 18446744073709551615ull },
+	{ "5", "5", false, 0, 0 },
+	{ "6", "5", false, 0, 0 },
+	{ "", "5", false, 0, 0 },
+	{ "0", "", false, 0, 0 },
+	{ "-1", "5", false, 0, 0 },
+	{ "0", "5k", false, 0, 0 },
+	{ "0x10", "0x20", false, 0, 0 },
+	{ "0", "18446744073709551616", false, 0, 0 }, // would wrap around to 0
+	{ "18446744073709551617", "2", false, 0, 0 }  // would wrap around to 1
+};
+
+struct DigestCase
+{
+	const char * szAlgorithm;
+	const char * szDigest;
+	DccDigestMessage::Type eType;
+};
+
+static const DigestCase g_digestCases[] = {
+	{ "", "", DccDigestMessage::Request },
+	{ "SHA-256", SHA256_LOWER, DccDigestMessage::Reply },
+	{ "sha-256", SHA256_UPPER, DccDigestMessage::Reply },
+	{ "SHA-256", "", DccDigestMessage::Malformed },
+	{ "", SHA256_LOWER, DccDigestMessage::Malformed },
+	{ "SHA-256", "9f86d081", DccDigestMessage::Malformed },
+	{ "SHA-256", SHA256_LOWER "00", DccDigestMessage::Malformed },
+	{ "SHA-256", "zf86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08", DccDigestMessage::Malformed },
+	{ "SHA-256", "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a0 ", DccDigestMessage::Malformed },
+	{ "MD5", "098f6bcd4621d373cade4e832627b4f6", DccDigestMessage::UnsupportedAlgorithm },
+	{ "SHA-1", SHA256_LOWER, DccDigestMessage::UnsupportedAlgorithm }
+};
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(a[0]))
+
+int main(int, char **)
+{
+	int iFailures = 0;
+	int iCases = 0;
+
+	for(unsigned int i = 0; i < ARRAY_SIZE(g_countCases); i++)
+	{
+		const CountCase & c = g_countCases[i];
+		unsigned int uCount = 0;
+		bool bValid = dcc_parse_segments_count(KviCString(c.szCount), uCount);
+		iCases++;
+		if((bValid != c.bValid) || (bValid && (uCount != c.uCount)))
+		{
+			printf("FAIL: SEGMENTS count '%s': got %s %u\n", c.szCount, bValid ? "valid" : "invalid", uCount);
+			iFailures++;
+		}
+	}
+
+	for(unsigned int i = 0; i < ARRAY_SIZE(g_rangeCases); i++)
+	{
+		const RangeCase & c = g_rangeCases[i];
+		quint64 uStart = 0;
+		quint64 uEnd = 0;
+		bool bValid = dcc_parse_segment_range(KviCString(c.szStart), KviCString(c.szEnd), uStart, uEnd);
+		iCases++;
+		if((bValid != c.bValid) || (bValid && ((uStart != c.uStart) || (uEnd != c.uEnd))))
+		{
+			printf("FAIL: SEGMENT range '%s' '%s': got %s %llu %llu\n", c.szStart, c.szEnd, bValid ? "valid" : "invalid",
+			    (unsigned long long)uStart, (unsigned long long)uEnd);
+			iFailures++;
+		}
+	}
+
+	for(unsigned int i = 0; i < ARRAY_SIZE(g_digestCases); i++)
+	{
+		const DigestCase & c = g_digestCases[i];
+		DccDigestMessage::Type eType = dcc_parse_digest(KviCString(c.szAlgorithm), KviCString(c.szDigest));
+		iCases++;
+		if(eType != c.eType)
+		{
+			printf("FAIL: DIGEST '%s' '%s': got type %d, expected %d\n", c.szAlgorithm, c.szDigest, (int)eType, (int)c.eType);
+			iFailures++;
+		}
+	}
+
+	printf("%d of %d cases passed\n", iCases - iFailures, iCases);
+	return iFailures ? 1 : 0;
+}
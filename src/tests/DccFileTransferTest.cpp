@@ -0,0 +1,475 @@
+//=============================================================================
+//
+//   File : DccFileTransferTest.cpp
+//   Creation date : Sun 18 Oct 2026 16:21:07 by the KVIrc development team
+//
+//   This file is part of the KVIrc IRC client distribution
+//   Copyright (C) 2026 the KVIrc development team
+//
+//   This program is FREE software. You can redistribute it and/or
+//   modify it under the terms of the GNU General Public License
+//   as published by the Free Software Foundation; either version 2
+//   of the License, or (at your option) any later version.
+//
+//   This program is distributed in the HOPE that it will be USEFUL,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//   See the GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program. If not, write to the Free Software Foundation,
+//   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+//=============================================================================
+
+//
+// Drives a DccSendThread and a DccRecvThread over a loopback TCP connection.
+//
+// Usage: dccfiletransfertest [file size in KiB] [bandwidth limit in KiB/s]
+//
+// The file is transferred without and with a bandwidth limit on the sender,
+// over plain TCP and (when compiled with SSL support) over SSL.
+// Each run prints the transfer loop statistics of both threads (throughput,
+// socket calls, wakeups and CPU time) and the throughput seen from outside.
+// The program fails if a thread reports an error, if a transfer doesn't complete
+// in time or if the received file differs from the sent one.
+//
+
+#include "DccFileTransferThread.h"
+#include "DccBandwidthShaper.h"
+
+#include "KviThread.h"
+#include "KviError.h"
+#include "KviCString.h"
+#include "kvi_socket.h"
+
+#ifdef COMPILE_SSL_SUPPORT
+#include "KviSSL.h"
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#endif
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+
+#define DCC_TEST_DEFAULT_FILE_SIZE_KIB 32768
+#define DCC_TEST_DEFAULT_LIMIT_KIB 8192
+// a transfer that doesn't complete in this time has failed
+#define DCC_TEST_TIMEOUT_MSECS 120000
+#define DCC_TEST_PACKET_SIZE 16384
+// DccThread::postStatisticsEvent() posts this as the last event of the thread
+#define DCC_TEST_STATISTICS_PREFIX "Transfer loop statistics"
+
+// The thread manager may be created only by KviApplication: we have none
+class DccTestThreadManager : public KviThreadManager
+{
+public:
+	static void init() { KviThreadManager::globalInit(); };
+	static void done() { KviThreadManager::globalDestroy(); };
+};
+
+// Receives the events of one of the threads
+class DccTestEndpoint : public QObject
+{
+public:
+	DccTestEndpoint(const char * szName)
+	    : QObject(), m_szName(szName), m_bSuccess(false), m_iError(KviError::Success), m_bFinished(false){};
+
+public:
+	const char * m_szName;
+	bool m_bSuccess;
+	int m_iError;
+	bool m_bFinished; // the statistics have arrived: the thread is exiting
+protected:
+	bool event(QEvent * e) override;
+};
+
+bool DccTestEndpoint::event(QEvent * e)
+{
+	if(e->type() != ((QEvent::Type)KVI_THREAD_EVENT))
+		return QObject::event(e);
+
+	switch(((KviThreadEvent *)e)->id())
+	{
+		case KVI_DCC_THREAD_EVENT_SUCCESS:
+			m_bSuccess = true;
+			break;
+		case KVI_DCC_THREAD_EVENT_ERROR:
+		{
+			int * pError = ((KviThreadDataEvent<int> *)e)->getData();
+			m_iError = *pError;
+			delete pError;
+			printf("    %s: ERROR: %s\n", m_szName, KviError::getUntranslatedDescription((KviError::Code)m_iError));
+		}
+		break;
+		case KVI_DCC_THREAD_EVENT_MESSAGE:
+		{
+			KviCString * pMsg = ((KviThreadDataEvent<KviCString> *)e)->getData();
+			printf("    %s: %s\n", m_szName, pMsg->ptr());
+			if(kvi_strEqualCSN(pMsg->ptr(), DCC_TEST_STATISTICS_PREFIX, (int)strlen(DCC_TEST_STATISTICS_PREFIX)))
+				m_bFinished = true;
+			delete pMsg;
+		}
+		break;
+		default:
+			break;
+	}
+	return true;
+}
+
+static bool dcc_test_connect(kvi_socket_t * pSendFd, kvi_socket_t * pRecvFd)
+{
+	kvi_socket_t listenFd = kvi_socket_create(KVI_SOCKET_PF_INET, KVI_SOCKET_TYPE_STREAM, 0);
+	if(listenFd == KVI_INVALID_SOCKET)
+		return false;
+
+	struct sockaddr_in sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	sa.sin_port = 0;
+	socklen_t len = sizeof(sa);
+
+	if(!kvi_socket_bind(listenFd, (struct sockaddr *)&sa, sizeof(sa)) || !kvi_socket_listen(listenFd, 1) || getsockname(listenFd, (struct sockaddr *)&sa, &len) != 0)
+	{
+		kvi_socket_close(listenFd);
+		return false;
+	}
+
+	// loopback: the connection completes in the backlog, before accept()
+	*pRecvFd = kvi_socket_create(KVI_SOCKET_PF_INET, KVI_SOCKET_TYPE_STREAM, 0);
+	if((*pRecvFd == KVI_INVALID_SOCKET) || (::connect(*pRecvFd, (struct sockaddr *)&sa, sizeof(sa)) != 0))
+	{
+		if(*pRecvFd != KVI_INVALID_SOCKET)
+			kvi_socket_close(*pRecvFd);
+		kvi_socket_close(listenFd);
+		return false;
+	}
+
+	*pSendFd = ::accept(listenFd, nullptr, nullptr);
+	kvi_socket_close(listenFd);
+	if(*pSendFd == KVI_INVALID_SOCKET)
+	{
+		kvi_socket_close(*pRecvFd);
+		return false;
+	}
+	return true;
+}
+
+#ifdef COMPILE_SSL_SUPPORT
+// TLS 1.3 has no anonymous ciphers: the server side needs a certificate
+static bool dcc_test_generate_certificate(const QString & szCertFile, const QString & szKeyFile)
+{
+	EVP_PKEY * pKey = nullptr;
+	EVP_PKEY_CTX * pCtx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+	if(!pCtx)
+		return false;
+	bool bOk = (EVP_PKEY_keygen_init(pCtx) > 0) && (EVP_PKEY_CTX_set_rsa_keygen_bits(pCtx, 2048) > 0) && (EVP_PKEY_keygen(pCtx, &pKey) > 0);
+	EVP_PKEY_CTX_free(pCtx);
+	if(!bOk)
+		return false;
+
+	X509 * pCert = X509_new();
+	ASN1_INTEGER_set(X509_get_serialNumber(pCert), 1);
+	X509_gmtime_adj(X509_get_notBefore(pCert), 0);
+	X509_gmtime_adj(X509_get_notAfter(pCert), 3600);
+	X509_set_pubkey(pCert, pKey);
+	X509_NAME * pName = X509_get_subject_name(pCert);
+	X509_NAME_add_entry_by_txt(pName, "CN", MBSTRING_ASC, (const unsigned char *)"localhost", -1, -1, 0);
+	X509_set_issuer_name(pCert, pName);
+	bOk = X509_sign(pCert, pKey, EVP_sha256()) > 0;
+
+	FILE * f = fopen(szCertFile.toUtf8().data(), "w");
+	bOk = bOk && f && PEM_write_X509(f, pCert);
+	if(f)
+		fclose(f);
+	f = fopen(szKeyFile.toUtf8().data(), "w");
+	bOk = bOk && f && PEM_write_PrivateKey(f, pKey, nullptr, nullptr, 0, nullptr, nullptr);
+	if(f)
+		fclose(f);
+
+	X509_free(pCert);
+	EVP_PKEY_free(pKey);
+	return bOk;
+}
+
+// Performs the handshake on a blocking socket
+static KviSSL * dcc_test_ssl_handshake(kvi_socket_t fd, KviSSL::Method m, const QString & szCertFile, const QString & szKeyFile)
+{
+	KviSSL * s = new KviSSL();
+	bool bOk = s->initContext(m);
+	if(bOk && (m == KviSSL::Server))
+		bOk = (s->useCertificateFile(szCertFile, QString()) == KviSSL::Success) && (s->usePrivateKeyFile(szKeyFile, QString()) == KviSSL::Success);
+	bOk = bOk && s->initSocket(fd);
+	bOk = bOk && (((m == KviSSL::Server) ? s->accept() : s->connect()) == KviSSL::Success);
+	if(!bOk)
+	{
+		KviCString szErr;
+		while(s->getLastErrorString(szErr))
+			printf("    SSL ERROR: %s\n", szErr.ptr());
+		delete s;
+		return nullptr;
+	}
+	return s;
+}
+#endif
+
+static bool dcc_test_create_file(const QString & szFileName, quint64 uSize)
+{
+	QFile f(szFileName);
+	if(!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	// a cheap pseudo random sequence: the contents just have to differ everywhere
+	QByteArray buffer(1048576, 0);
+	quint32 uSeed = 0x4b564972;
+	while(uSize > 0)
+	{
+		for(int i = 0; i < buffer.size(); i++)
+		{
+			uSeed = uSeed * 1103515245 + 12345;
+			buffer[i] = (char)(uSeed >> 24);
+		}
+		qint64 iLen = uSize > (quint64)buffer.size() ? buffer.size() : (qint64)uSize;
+		if(f.write(buffer.constData(), iLen) != iLen)
+			return false;
+		uSize -= iLen;
+	}
+	return true;
+}
+
+static bool dcc_test_compare_files(const QString & szFileName1, const QString & szFileName2)
+{
+	QFile f1(szFileName1);
+	QFile f2(szFileName2);
+	if(!f1.open(QIODevice::ReadOnly) || !f2.open(QIODevice::ReadOnly))
+		return false;
+	if(f1.size() != f2.size())
+		return false;
+	while(!f1.atEnd())
+	{
+		if(f1.read(1048576) != f2.read(1048576))
+			return false;
+	}
+	return true;
+}
+
+static bool dcc_test_run(const QString & szSource, const QString & szTarget, quint64 uSize, bool bSSL, unsigned int uLimit,
+    const QString & szCertFile, const QString & szKeyFile)
+{
+	printf("  %s, %s\n", bSSL ? "SSL" : "plain TCP", uLimit < MAX_DCC_BANDWIDTH_LIMIT ? QString("limited to %1 KiB/s").arg(uLimit / 1024).toUtf8().data() : "unlimited");
+
+	kvi_socket_t sendFd, recvFd;
+	if(!dcc_test_connect(&sendFd, &recvFd))
+	{
+		printf("    ERROR: can't set up the loopback connection\n");
+		return false;
+	}
+
+#ifdef COMPILE_SSL_SUPPORT
+	KviSSL * pSendSSL = nullptr;
+	KviSSL * pRecvSSL = nullptr;
+	if(bSSL)
+	{
+		// as in a DCC SEND the sender is the listening side
+		std::thread client([&]() { pRecvSSL = dcc_test_ssl_handshake(recvFd, KviSSL::Client, szCertFile, szKeyFile); });
+		pSendSSL = dcc_test_ssl_handshake(sendFd, KviSSL::Server, szCertFile, szKeyFile);
+		client.join();
+		if(!pSendSSL || !pRecvSSL)
+		{
+			printf("    ERROR: the SSL handshake failed\n");
+			delete pSendSSL;
+			delete pRecvSSL;
+			kvi_socket_close(sendFd);
+			kvi_socket_close(recvFd);
+			return false;
+		}
+	}
+#else
+	Q_UNUSED(szCertFile);
+	Q_UNUSED(szKeyFile);
+#endif
+
+	// the transfer threads work on non blocking sockets, as the ones coming from DccMarshal
+	kvi_socket_setNonBlocking(sendFd);
+	kvi_socket_setNonBlocking(recvFd);
+
+	QFile::remove(szTarget);
+
+	DccBandwidthLimiter * pSendLimiter = DccBandwidthShaper::instance()->createLimiter(DccBandwidthLimiter::Upload, "receiver", uLimit);
+	DccBandwidthLimiter * pRecvLimiter = DccBandwidthShaper::instance()->createLimiter(DccBandwidthLimiter::Download, "sender", MAX_DCC_BANDWIDTH_LIMIT);
+
+	KviDccSendThreadOptions * pSendOpt = new KviDccSendThreadOptions;
+	pSendOpt->szFileName = szSource.toUtf8().data();
+	pSendOpt->uStartPosition = 0;
+	pSendOpt->uEndPosition = 0;
+	pSendOpt->iPacketSize = DCC_TEST_PACKET_SIZE;
+	pSendOpt->iIdleStepLengthInMSec = 0;
+	pSendOpt->bFastSend = true;
+	pSendOpt->bNoAcks = false;
+	pSendOpt->bIsTdcc = false;
+	pSendOpt->bReportStatistics = true;
+	pSendOpt->pLimiter = pSendLimiter;
+
+	KviDccRecvThreadOptions * pRecvOpt = new KviDccRecvThreadOptions;
+	pRecvOpt->bResume = false;
+	pRecvOpt->szFileName = szTarget.toUtf8().data();
+	pRecvOpt->uTotalFileSize = uSize;
+	pRecvOpt->uStartPosition = 0;
+	pRecvOpt->uEndPosition = 0;
+	pRecvOpt->iIdleStepLengthInMSec = 0;
+	pRecvOpt->bSendZeroAck = false;
+	pRecvOpt->bSend64BitAck = true;
+	pRecvOpt->bNoAcks = false;
+	pRecvOpt->bIsTdcc = false;
+	pRecvOpt->bPreallocate = false;
+	pRecvOpt->bComputeDigest = false;
+	pRecvOpt->bReportStatistics = true;
+	pRecvOpt->pLimiter = pRecvLimiter;
+
+	DccTestEndpoint sender("send");
+	DccTestEndpoint receiver("recv");
+
+	DccSendThread * pSendThread = new DccSendThread(&sender, sendFd, pSendOpt);
+	DccRecvThread * pRecvThread = new DccRecvThread(&receiver, recvFd, pRecvOpt);
+#ifdef COMPILE_SSL_SUPPORT
+	if(bSSL)
+	{
+		pSendThread->setSSL(pSendSSL);
+		pRecvThread->setSSL(pRecvSSL);
+	}
+#endif
+
+	QElapsedTimer elapsed;
+	elapsed.start();
+
+	pRecvThread->start();
+	pSendThread->start();
+
+	QEventLoop loop;
+	QTimer poll;
+	QObject::connect(&poll, &QTimer::timeout, [&]() {
+		if((sender.m_bFinished && receiver.m_bFinished) || (elapsed.elapsed() > DCC_TEST_TIMEOUT_MSECS))
+			loop.quit();
+	});
+	poll.start(20);
+	loop.exec();
+	poll.stop();
+
+	qint64 iMSecs = elapsed.elapsed();
+	bool bTimedOut = !(sender.m_bFinished && receiver.m_bFinished);
+
+	// stops the threads that are still running (only on timeout) and waits for them
+	pSendThread->terminate();
+	pRecvThread->terminate();
+	delete pSendThread;
+	delete pRecvThread;
+	KviThreadManager::killPendingEvents(&sender);
+	KviThreadManager::killPendingEvents(&receiver);
+
+	delete pSendLimiter;
+	delete pRecvLimiter;
+
+	if(bTimedOut)
+	{
+		printf("    ERROR: the transfer didn't complete in %d msecs\n", DCC_TEST_TIMEOUT_MSECS);
+		return false;
+	}
+
+	if(!sender.m_bSuccess || !receiver.m_bSuccess)
+		return false;
+
+	if(!dcc_test_compare_files(szSource, szTarget))
+	{
+		printf("    ERROR: the received file differs from the sent one\n");
+		return false;
+	}
+
+	printf("    %llu bytes in %lld msecs: %.2f MB/s\n", (unsigned long long)uSize, (long long)iMSecs,
+	    iMSecs ? ((double)uSize / 1048576.0) / ((double)iMSecs / 1000.0) : 0.0);
+	return true;
+}
+
+int main(int argc, char ** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	quint64 uSize = (quint64)DCC_TEST_DEFAULT_FILE_SIZE_KIB * 1024;
+	unsigned int uLimit = DCC_TEST_DEFAULT_LIMIT_KIB * 1024;
+	if(argc > 1)
+		uSize = QString(argv[1]).toULongLong() * 1024;
+	if(argc > 2)
+		uLimit = QString(argv[2]).toUInt() * 1024;
+	if((uSize == 0) || (uLimit == 0))
+	{
+		printf("Usage: %s [file size in KiB] [bandwidth limit in KiB/s]\n", argv[0]);
+		return 2;
+	}
+
+	QTemporaryDir dir;
+	if(!dir.isValid())
+	{
+		printf("ERROR: can't create a temporary directory\n");
+		return 1;
+	}
+	QString szSource = dir.path() + "/source";
+	QString szTarget = dir.path() + "/target";
+	QString szCertFile = dir.path() + "/cert.pem";
+	QString szKeyFile = dir.path() + "/key.pem";
+
+	if(!dcc_test_create_file(szSource, uSize))
+	{
+		printf("ERROR: can't create the file to transfer\n");
+		return 1;
+	}
+
+	DccTestThreadManager::init();
+	DccBandwidthShaper::init();
+
+	int iFailures = 0;
+
+	printf("DCC file transfer of %llu bytes over loopback\n", (unsigned long long)uSize);
+
+	if(!dcc_test_run(szSource, szTarget, uSize, false, MAX_DCC_BANDWIDTH_LIMIT, szCertFile, szKeyFile))
+		iFailures++;
+	if(!dcc_test_run(szSource, szTarget, uSize, false, uLimit, szCertFile, szKeyFile))
+		iFailures++;
+
+#ifdef COMPILE_SSL_SUPPORT
+	KviSSL::globalInit();
+	if(dcc_test_generate_certificate(szCertFile, szKeyFile))
+	{
+		if(!dcc_test_run(szSource, szTarget, uSize, true, MAX_DCC_BANDWIDTH_LIMIT, szCertFile, szKeyFile))
+			iFailures++;
+		if(!dcc_test_run(szSource, szTarget, uSize, true, uLimit, szCertFile, szKeyFile))
+			iFailures++;
+	}
+	else
+	{
+		printf("ERROR: can't generate the SSL certificate\n");
+		iFailures++;
+	}
+	KviSSL::globalDestroy();
+#else
+	printf("  SSL: not compiled in\n");
+#endif
+
+	DccBandwidthShaper::done();
+	DccTestThreadManager::done();
+
+	printf("%s\n", iFailures ? "FAILED" : "OK");
+	return iFailures ? 1 : 0;
+}